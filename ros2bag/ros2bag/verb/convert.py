@@ -0,0 +1,63 @@
+# Copyright 2018 Open Source Robotics Foundation, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+
+from ros2bag.api import check_path_exists
+from ros2bag.api import print_error
+from ros2bag.verb import VerbExtension
+
+
+class ConvertVerb(VerbExtension):
+    """Convert a bag into another serialization format."""
+
+    def add_arguments(self, parser, cli_name):  # noqa: D102
+        parser.add_argument(
+            'bag_file', type=check_path_exists, help='bag file to convert')
+        parser.add_argument(
+            '-o', '--output', required=True,
+            help='destination of the converted bagfile')
+        parser.add_argument(
+            '-s', '--storage', default='sqlite3',
+            help="storage identifier of the input bag, defaults to 'sqlite3'")
+        parser.add_argument(
+            '--output-storage', default='sqlite3',
+            help="storage identifier of the output bag, defaults to 'sqlite3'")
+        parser.add_argument(
+            '-f', '--serialization-format', default='',
+            help='rmw serialization format to convert the messages to, defaults to the '
+                 'rmw currently in use')
+        parser.add_argument(
+            '--workers', type=int, default=0,
+            help='number of parallel conversion workers. The default of 0 uses one worker '
+                 'per hardware thread.')
+
+    def main(self, *, args):  # noqa: D102
+        if os.path.isdir(args.output):
+            return print_error("Output folder '{}' already exists.".format(args.output))
+
+        # NOTE(hidmic): in merged install workspaces on Windows, Python entrypoint lookups
+        #               combined with constrained environments (as imposed by colcon test)
+        #               may result in DLL loading failures when attempting to import a C
+        #               extension. Therefore, do not import rosbag2_transport at the module
+        #               level but on demand, right before first use.
+        from rosbag2_transport import rosbag2_transport_py
+
+        rosbag2_transport_py.convert(
+            in_uri=args.bag_file,
+            in_storage_id=args.storage,
+            out_uri=args.output,
+            out_storage_id=args.output_storage,
+            serialization_format=args.serialization_format,
+            workers=args.workers)
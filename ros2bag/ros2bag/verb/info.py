@@ -12,11 +12,78 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+from datetime import datetime
 import os
 
 from ros2bag.verb import VerbExtension
 
 
+def format_file_size(size_in_bytes):
+    """Format a byte count the way the C++ formatter does (e.g. '1.1 GiB')."""
+    size = float(size_in_bytes)
+    units = ['B', 'KiB', 'MiB', 'GiB', 'TiB']
+    index = 0
+    while size >= 1024.0 and index < len(units) - 1:
+        size /= 1024.0
+        index += 1
+    precision = 0 if index == 0 else 1
+    return f'{size:.{precision}f} {units[index]}'
+
+
+def format_duration_in_sec(nanoseconds):
+    milliseconds = nanoseconds // 10**6
+    return f'{milliseconds // 1000}.{milliseconds % 1000}'
+
+
+def format_time_point(nanoseconds):
+    time = datetime.fromtimestamp(nanoseconds // 10**9)
+    milliseconds = (nanoseconds // 10**6) % 1000
+    return (
+        time.strftime('%b %e %Y %H:%M:%S') + f'.{milliseconds}'
+        f' ({format_duration_in_sec(nanoseconds)})')
+
+
+def format_topic_statistics(statistics):
+    """Render per-topic rate and bandwidth in the layout of the C++ formatter."""
+    indent = ' ' * 19
+    lines = []
+    for s in statistics:
+        line = f'Topic: {s.topic_name} | '
+        span_ns = s.last_timestamp_ns - s.first_timestamp_ns
+        if s.message_count > 1 and span_ns > 0:
+            span_s = span_ns / 10**9
+            line += f'Rate: {(s.message_count - 1) / span_s:.1f} Hz | '
+            line += f'Bandwidth: {format_file_size(int(s.byte_count / span_s))}/s | '
+        line += f'Count: {s.message_count} | '
+        line += f'Total size: {format_file_size(s.byte_count)}'
+        lines.append(line)
+    topics = '\n'.join([indent + line for line in lines]).lstrip()
+    return f'Topic statistics:  {topics}\n'
+
+
+def format_bag_metadata(metadata):
+    """Render bag metadata in the layout used by the C++ info formatter."""
+    indent = ' ' * 19  # The longest info field (Topics with Type:) plus one space.
+    files = '\n'.join([indent + path for path in metadata.relative_file_paths]).lstrip()
+    topics = '\n'.join([
+        indent +
+        f'Topic: {t.topic_metadata.name} | Type: {t.topic_metadata.type} | '
+        f'Count: {t.message_count} | '
+        f'Serialization Format: {t.topic_metadata.serialization_format}'
+        for t in metadata.topics_with_message_count]).lstrip()
+    start_time = metadata.starting_time_nanoseconds
+    end_time = start_time + metadata.duration_nanoseconds
+    return (
+        f'\nFiles:             {files}\n'
+        f'Bag size:          {format_file_size(metadata.bag_size)}\n'
+        f'Storage id:        {metadata.storage_identifier}\n'
+        f'Duration:          {format_duration_in_sec(metadata.duration_nanoseconds)}s\n'
+        f'Start:             {format_time_point(start_time)}\n'
+        f'End:               {format_time_point(end_time)}\n'
+        f'Messages:          {metadata.message_count}\n'
+        f'Topic information: {topics}\n')
+
+
 class InfoVerb(VerbExtension):
     """Print information about a bag to the screen."""
 
@@ -27,6 +94,10 @@ class InfoVerb(VerbExtension):
             '-s', '--storage', default='sqlite3',
             help='storage identifier to be used to open storage, if no yaml file exists.'
                  ' Defaults to "sqlite3"')
+        parser.add_argument(
+            '-v', '--verbose', action='store_true',
+            help='additionally print per-topic average rate and bandwidth, computed by '
+                 'an aggregated query inside the storage instead of reading every message')
 
     def main(self, *, args):  # noqa: D102
         bag_file = args.bag_file
@@ -35,7 +106,19 @@ class InfoVerb(VerbExtension):
         # NOTE(hidmic): in merged install workspaces on Windows, Python entrypoint lookups
         #               combined with constrained environments (as imposed by colcon test)
         #               may result in DLL loading failures when attempting to import a C
-        #               extension. Therefore, do not import rosbag2_transport at the module
+        #               extension. Therefore, do not import rosbag2_py at the module
         #               level but on demand, right before first use.
-        from rosbag2_transport import rosbag2_transport_py
-        rosbag2_transport_py.info(uri=bag_file, storage_id=args.storage)
+        # A pure metadata read: no transport machinery is spun up to print info.
+        import rosbag2_py
+        info = rosbag2_py.Info()
+        try:
+            metadata = info.read_metadata(bag_file, args.storage)
+        except RuntimeError as e:
+            return '[ERROR] [ros2bag]: {}'.format(e)
+        print(format_bag_metadata(metadata))
+        if args.verbose:
+            try:
+                statistics = info.read_topic_statistics(bag_file, args.storage)
+            except RuntimeError as e:
+                return '[ERROR] [ros2bag]: {}'.format(e)
+            print(format_topic_statistics(statistics))
@@ -38,6 +38,12 @@ class PlayVerb(VerbExtension):
             help='size of message queue rosbag tries to hold in memory to help deterministic '
                  'playback. Larger size will result in larger memory needs but might prevent '
                  'delay of message playback.')
+        parser.add_argument(
+            '--read-ahead-byte-budget', type=int, default=0,
+            help='budget the read-ahead queue in bytes of serialized message data instead of '
+                 'in messages, so replay memory stays predictable regardless of message '
+                 'sizes. Overrides --read-ahead-queue-size when set. Default is 0 '
+                 '(queue bounded by message count).')
         parser.add_argument(
             '-r', '--rate', type=check_positive_float, default=1.0,
             help='rate at which to play back messages. Valid range > 0.0.')
@@ -52,6 +58,61 @@ class PlayVerb(VerbExtension):
             '-l', '--loop', action='store_true',
             help='enables loop playback when playing a bagfile: it starts back at the beginning '
                  'on reaching the end and plays indefinitely.')
+        parser.add_argument(
+            '--loop-cache-size', type=int, default=0,
+            help='with --loop, keep up to this many bytes of decoded messages in memory during '
+                 'the first pass and replay later loops from that cache without any disk I/O. '
+                 'Bags exceeding the budget rewind via a storage seek instead. Default is 0 '
+                 '(cache disabled).')
+        parser.add_argument(
+            '--as-fast-as-possible', action='store_true',
+            help='ignore the recorded timeline and publish messages as fast as the middleware '
+                 'accepts, without any pacing sleeps. Overrides --rate. A throughput report is '
+                 'printed when playback finishes.')
+        parser.add_argument(
+            '--decompress-to', type=str, default='', metavar='DIR',
+            help='decompress file-compressed splits into this directory instead of next to '
+                 'the bag, e.g. a tmpfs, so playback does not write scratch data to the disk '
+                 'it reads the compressed bag from. Each decompressed copy is deleted once '
+                 'playback moved past its split. By default splits are decompressed next to '
+                 'the bag and left behind.')
+        parser.add_argument(
+            '--reverse', action='store_true',
+            help='play the bag backwards: messages are published newest first, with the '
+                 'recorded spacing between them reversed. While paused, the '
+                 '/rosbag2_player/step service releases one message at a time. Not supported '
+                 'for sharded bags.')
+        parser.add_argument(
+            '--clock', type=check_positive_float, nargs='?', const=40.0, default=0.0,
+            help='publish /clock from the replay timeline at the given frequency in Hz, to '
+                 'drive downstream nodes running with use_sim_time. Defaults to 40 Hz when '
+                 'the flag is given without a value.')
+        parser.add_argument(
+            '-e', '--regex', type=str, default='',
+            help='regular expression of topics to replay, in addition to --topics.')
+        parser.add_argument(
+            '-x', '--exclude', type=str, default='',
+            help='regular expression of topics to exclude from replay. Exclusion wins over '
+                 '--topics and --regex. Excluded messages are skipped inside the storage '
+                 'and never read from disk.')
+        parser.add_argument(
+            '--start-time', type=float, default=-1.0,
+            help='start playback at this time, given in seconds since epoch. Messages recorded '
+                 'before this time are skipped inside the storage and never read from disk.')
+        parser.add_argument(
+            '--end-time', type=float, default=-1.0,
+            help='stop playback at this time, given in seconds since epoch. Messages recorded '
+                 'after this time are skipped inside the storage and never read from disk.')
+        parser.add_argument(
+            '--start-offset', type=float, default=0.0,
+            help='start playback this many seconds into the bag. Resolved against the bag '
+                 'metadata and pushed down into the storage, so skipped messages are never '
+                 'read from disk. When --start-time is also given, the later bound wins.')
+        parser.add_argument(
+            '--playback-duration', type=float, default=-1.0,
+            help='play at most this many seconds from the effective start of playback, then '
+                 'stop. Pushed down into the storage. When --end-time is also given, the '
+                 'earlier bound wins. Negative values play to the end of the bag.')
         parser.add_argument(
             '--remap', '-m', default='', nargs='+',
             help='list of topics to be remapped: in the form '
@@ -82,4 +143,17 @@ class PlayVerb(VerbExtension):
             topics=args.topics,
             qos_profile_overrides=qos_profile_overrides,
             loop=args.loop,
-            topic_remapping=args.remap)
+            topic_remapping=args.remap,
+            start_time=int(args.start_time * 1e9) if args.start_time >= 0.0 else -1,
+            end_time=int(args.end_time * 1e9) if args.end_time >= 0.0 else -1,
+            topics_regex=args.regex,
+            topics_regex_exclude=args.exclude,
+            loop_cache_size=args.loop_cache_size,
+            clock_publish_frequency=args.clock,
+            as_fast_as_possible=args.as_fast_as_possible,
+            reverse=args.reverse,
+            start_offset=int(args.start_offset * 1e9) if args.start_offset > 0.0 else 0,
+            playback_duration=(
+                int(args.playback_duration * 1e9) if args.playback_duration >= 0.0 else -1),
+            decompress_to=args.decompress_to,
+            read_ahead_byte_budget=args.read_ahead_byte_budget)
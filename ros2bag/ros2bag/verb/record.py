@@ -75,12 +75,54 @@ class RecordVerb(VerbExtension):
         )
         parser.add_argument(
             '--compression-mode', type=str, default='none',
-            choices=['none', 'file', 'message'],
-            help="Determine whether to compress by file or message. Default is 'none'."
+            choices=['none', 'file', 'message', 'chunk'],
+            help="Determine whether to compress by file, by message, or by chunks of roughly "
+                 "4 MiB of messages compressed together. Default is 'none'."
         )
         parser.add_argument(
-            '--compression-format', type=str, default='', choices=['zstd'],
-            help='Specify the compression format/algorithm. Default is none.'
+            '--compression-format', type=str, default='', choices=['zstd', 'zstd_fast'],
+            help="Specify the compression format/algorithm. 'zstd_fast' runs zstd at a "
+                 'negative (--fast) level for much higher throughput at a lower ratio, for '
+                 'recorders where CPU rather than disk is the bottleneck; the compression '
+                 'level selects the acceleration factor. Default is none.'
+        )
+        parser.add_argument(
+            '--compression-level', type=int, default=1,
+            help='Compression quality level, e.g. the zstd level. Higher levels trade speed '
+                 'for a better ratio: use 1 for live recording, higher levels for archival. '
+                 'Default is 1.'
+        )
+        parser.add_argument(
+            '--compression-threads', type=int, default=-1,
+            help='Number of threads the compressor may use per file. 0 compresses on the '
+                 'calling thread; -1 (default) picks a value based on the available cores.'
+        )
+        parser.add_argument(
+            '--storage-shards', type=int, default=1,
+            help='Number of storage files to write in parallel, with the topics partitioned '
+                 'across them. A single storage connection serializes all inserts; sharding '
+                 'lets high-bandwidth recordings scale across several storage writer threads. '
+                 'Playback merges the shards by timestamp. Default is 1 (no sharding).'
+        )
+        parser.add_argument(
+            '--split-writer-process', action='store_true',
+            help='Run the storage writer in a separate process, fed through a shared-memory '
+                 'ring buffer. A storage stall or writer crash then never blocks or takes '
+                 'down the subscriptions; a crashed writer is respawned and the recording '
+                 'continues in a new bag directory. Not available on Windows.'
+        )
+        parser.add_argument(
+            '-x', '--exclude', default='',
+            help='regular expression of topics not to record; matching topics are never '
+                 'subscribed, so their messages are never delivered to the recorder. '
+                 'Useful with -a to record everything except e.g. raw camera topics.'
+        )
+        parser.add_argument(
+            '--subscription-idle-timeout', type=int, default=0,
+            help='time in ms after which a subscription that received no message is torn '
+                 'down; the topic stays in the metadata and is resubscribed when a new '
+                 'publisher appears on it. Shrinks waitset and executor overhead on systems '
+                 'with many registered-but-silent topics. Default is 0 (never prune).'
         )
         parser.add_argument(
             '--include-hidden-topics', action='store_true',
@@ -90,6 +132,11 @@ class RecordVerb(VerbExtension):
             '--qos-profile-overrides-path', type=FileType('r'),
             help='Path to a yaml file defining overrides of the QoS profile for specific topics.'
         )
+        parser.add_argument(
+            '--storage-config-file', type=FileType('r'),
+            help='Path to a storage plugin specific configuration file, e.g. a list of sqlite '
+                 'PRAGMA statements applied when the bagfile is opened.'
+        )
         self._subparser = parser
 
     def main(self, *, args):  # noqa: D102
@@ -109,6 +156,21 @@ class RecordVerb(VerbExtension):
             return print_error('Invalid choice: Cannot specify compression format '
                                'without a compression mode.')
 
+        if args.storage_shards < 1:
+            return print_error('Invalid choice: --storage-shards must be at least 1.')
+
+        if args.storage_shards > 1 and args.compression_mode != 'none':
+            return print_error('Invalid choice: Storage sharding cannot be combined '
+                               'with compression.')
+
+        if args.split_writer_process and args.compression_mode != 'none':
+            return print_error('Invalid choice: The split writer process cannot be combined '
+                               'with compression.')
+
+        if args.split_writer_process and args.storage_shards > 1:
+            return print_error('Invalid choice: The split writer process cannot be combined '
+                               'with storage sharding.')
+
         args.compression_mode = args.compression_mode.upper()
 
         qos_profile_overrides = {}  # Specify a valid default
@@ -142,7 +204,14 @@ class RecordVerb(VerbExtension):
             max_cache_size=args.max_cache_size,
             topics=args.topics,
             include_hidden_topics=args.include_hidden_topics,
-            qos_profile_overrides=qos_profile_overrides)
+            qos_profile_overrides=qos_profile_overrides,
+            storage_config_file=args.storage_config_file.name if args.storage_config_file else '',
+            compression_level=args.compression_level,
+            compression_threads=args.compression_threads,
+            storage_shards=args.storage_shards,
+            split_writer_process=args.split_writer_process,
+            exclude_topics_regex=args.exclude,
+            subscription_idle_timeout=args.subscription_idle_timeout)
 
         if os.path.isdir(uri) and not os.listdir(uri):
             os.rmdir(uri)
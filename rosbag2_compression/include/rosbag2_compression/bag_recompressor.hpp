@@ -0,0 +1,68 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_COMPRESSION__BAG_RECOMPRESSOR_HPP_
+#define ROSBAG2_COMPRESSION__BAG_RECOMPRESSOR_HPP_
+
+#include <string>
+
+#include "rosbag2_compression/visibility_control.hpp"
+
+namespace rosbag2_compression
+{
+
+/**
+ * Offline file compression of an already recorded bag.
+ *
+ * Bags recorded uncompressed (for minimum recording latency) are compressed
+ * afterwards without going through a record pipeline: the splits of the bag
+ * are independent files, so workers compress them in parallel with one
+ * compressor each, the originals are removed and the metadata is rewritten
+ * with the new file paths and compression fields. The result is
+ * indistinguishable from a bag recorded with FILE compression.
+ */
+class ROSBAG2_COMPRESSION_PUBLIC BagRecompressor final
+{
+public:
+  struct Options
+  {
+    // Directory of the bag to compress, containing a metadata.yaml.
+    std::string bag_uri;
+    std::string compression_format = "zstd";
+    // Compressor-specific quality level; zero selects the compressor's
+    // internal default.
+    int compression_level = 0;
+    // Number of files compressed in parallel; 0 uses one worker per
+    // hardware thread. Each file is compressed by a single thread since
+    // the file-level parallelism already saturates the cores.
+    size_t worker_count = 0;
+  };
+
+  explicit BagRecompressor(const Options & options);
+
+  /**
+   * Run the compression to completion.
+   *
+   * \throws runtime_error when the bag is missing or already compressed, or
+   * when any file fails to compress.
+   */
+  void run();
+
+private:
+  Options options_;
+};
+
+}  // namespace rosbag2_compression
+
+#endif  // ROSBAG2_COMPRESSION__BAG_RECOMPRESSOR_HPP_
@@ -16,6 +16,7 @@
 #define ROSBAG2_COMPRESSION__BASE_COMPRESSOR_INTERFACE_HPP_
 
 #include <string>
+#include <vector>
 
 #include "rosbag2_storage/serialized_bag_message.hpp"
 
@@ -64,6 +65,39 @@ public:
   virtual void compress_serialized_bag_message(
     rosbag2_storage::SerializedBagMessage * bag_message) = 0;
 
+  /**
+   * Train a compression dictionary from sample payloads of a single topic.
+   *
+   * Dictionaries prime the compressor with shared structure, which greatly
+   * improves the ratio of small messages compressed one at a time.
+   *
+   * \param samples Serialized message payloads to train from.
+   * \return The serialized dictionary, or an empty vector if the algorithm
+   * does not support dictionaries or training failed.
+   */
+  virtual std::vector<uint8_t> train_dictionary(
+    const std::vector<std::vector<uint8_t>> & samples)
+  {
+    (void) samples;
+    return {};
+  }
+
+  /**
+   * Compress subsequent messages of the given topic with a trained dictionary.
+   *
+   * The default implementation ignores dictionaries.
+   *
+   * \param topic_name The topic whose messages the dictionary applies to.
+   * \param dictionary A dictionary returned by train_dictionary.
+   */
+  virtual void set_dictionary(
+    const std::string & topic_name,
+    const std::vector<uint8_t> & dictionary)
+  {
+    (void) topic_name;
+    (void) dictionary;
+  }
+
   /**
    * Get the identifier of the compression algorithm.
    * This is appended to the extension of the compressed file.
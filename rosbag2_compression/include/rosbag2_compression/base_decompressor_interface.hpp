@@ -16,7 +16,9 @@
 #define ROSBAG2_COMPRESSION__BASE_DECOMPRESSOR_INTERFACE_HPP_
 
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "rosbag2_storage/serialized_bag_message.hpp"
 
@@ -58,14 +60,55 @@ public:
    */
   virtual std::string decompress_uri(const std::string & uri) = 0;
 
+  /**
+   * Decompress a file on disk into the given directory, e.g. a tmpfs used
+   * as scratch space during playback.
+   *
+   * The default implementation only supports an empty destination directory,
+   * which means decompressing next to the input file, and throws otherwise;
+   * existing decompressors keep working unchanged.
+   *
+   * \param uri Input file to decompress with file extension.
+   * \param destination_directory Directory the decompressed file is written
+   *   to, or an empty string to decompress next to the input file.
+   * \return The path to the decompressed file without the compressed extension.
+   */
+  virtual std::string decompress_uri(
+    const std::string & uri, const std::string & destination_directory)
+  {
+    if (!destination_directory.empty()) {
+      throw std::runtime_error{
+              "This decompressor does not support a destination directory."};
+    }
+    return decompress_uri(uri);
+  }
+
   /**
    * Decompress the serialized_data of a serialized bag message in place.
    *
+   * Implementations should leave a payload untouched when it is not in their
+   * compressed format: writers may store individual topics uncompressed in a
+   * message-compressed bag, so a bag can mix compressed and plain messages.
+   *
    * \param[in,out] bag_message A serialized bag message.
    */
   virtual void decompress_serialized_bag_message(
     rosbag2_storage::SerializedBagMessage * bag_message) = 0;
 
+  /**
+   * Register a dictionary that messages of this bag may have been compressed
+   * with. Frames carry a reference to their dictionary, so no topic mapping
+   * is needed here.
+   *
+   * The default implementation ignores dictionaries.
+   *
+   * \param dictionary A dictionary written alongside the bag by the compressor.
+   */
+  virtual void add_dictionary(const std::vector<uint8_t> & dictionary)
+  {
+    (void) dictionary;
+  }
+
   /**
    * Get the identifier of the compression algorithm. This is appended to the extension of the
    * compressed file.
@@ -56,6 +56,19 @@ public:
   virtual std::unique_ptr<rosbag2_compression::BaseCompressorInterface>
   create_compressor(const std::string & compression_format);
 
+  /**
+   * Create a compressor configured from the given compression options.
+   *
+   * In addition to selecting the format, this honors tuning knobs such as
+   * the compression level and thread count.
+   *
+   * \param compression_options The compression options.
+   * \return A unique pointer to the newly created compressor.
+   * \throw invalid_argument If the compression format does not exist.
+   */
+  virtual std::unique_ptr<rosbag2_compression::BaseCompressorInterface>
+  create_compressor(const CompressionOptions & compression_options);
+
   /**
    * Create a decompressor based on the specified compression format.
    *
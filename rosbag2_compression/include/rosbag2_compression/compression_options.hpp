@@ -16,6 +16,7 @@
 #define ROSBAG2_COMPRESSION__COMPRESSION_OPTIONS_HPP_
 
 #include <string>
+#include <vector>
 
 #include "visibility_control.hpp"
 
@@ -23,7 +24,8 @@ namespace rosbag2_compression
 {
 
 /**
- * Modes are used to specify whether to compress by individual serialized bag messages or by file.
+ * Modes are used to specify whether to compress by individual serialized bag messages, by groups
+ * of messages packed into chunks, or by file.
  * rosbag2_cpp defaults to NONE.
  */
 enum class ROSBAG2_COMPRESSION_PUBLIC CompressionMode: uint32_t
@@ -31,14 +33,15 @@ enum class ROSBAG2_COMPRESSION_PUBLIC CompressionMode: uint32_t
   NONE = 0,
   FILE,
   MESSAGE,
-  LAST_MODE = MESSAGE
+  CHUNK,
+  LAST_MODE = CHUNK
 };
 
 /**
  * Converts a string into a rosbag2_compression::CompressionMode enum.
  *
- * \param compression_mode A case insensitive string that is either "FILE" or "MESSAGE".
- * \return CompressionMode NONE if compression_mode is invalid. FILE or MESSAGE otherwise.
+ * \param compression_mode A case insensitive string that is "FILE", "MESSAGE" or "CHUNK".
+ * \return CompressionMode NONE if compression_mode is invalid. FILE, MESSAGE or CHUNK otherwise.
  */
 ROSBAG2_COMPRESSION_PUBLIC CompressionMode compression_mode_from_string(
   const std::string & compression_mode);
@@ -58,6 +61,50 @@ struct CompressionOptions
 {
   std::string compression_format;
   CompressionMode compression_mode;
+
+  // Compressor-specific quality level. For zstd, higher levels trade speed
+  // for a better ratio; zero selects zstd's internal default. Level 1 is
+  // fast enough for live recording.
+  int compression_level = 1;
+
+  // Number of threads a compressor may use for a single file. Zero compresses
+  // on the calling thread; a negative value selects a default based on the
+  // hardware concurrency.
+  int compression_threads = -1;
+
+  // Enables zstd long-distance matching for file compression. It finds
+  // repetitions across a far larger window than the regular match finder,
+  // which pays off for splits with repetitive cross-message content such as
+  // map tiles or static scene imagery, at negligible speed cost.
+  bool zstd_long_distance_matching = false;
+
+  // log2 of the match window used with long-distance matching; zero keeps
+  // zstd's default for the configured level. Windows larger than the default
+  // seekable frame size also grow the frames accordingly, trading
+  // range-extraction granularity for matches spanning more content.
+  int zstd_window_log = 0;
+
+  // Whether zstd appends a content checksum to every frame. Off by default:
+  // computing and verifying checksums costs CPU, and recordings with their
+  // own integrity layer above the compressor do not need a second one.
+  bool zstd_frame_checksum = false;
+
+  // Topics that are stored uncompressed in MESSAGE mode, e.g. topics carrying
+  // already-compressed images or video where another compression pass only
+  // costs CPU. Has no effect in FILE or CHUNK mode.
+  std::vector<std::string> exclude_topics{};
+
+  // If non-empty, only these topics are compressed in MESSAGE mode and all
+  // other topics are stored uncompressed. Has no effect in FILE or CHUNK mode.
+  std::vector<std::string> include_topics{};
+
+  // Minimum uncompressed/compressed size ratio a topic must achieve in
+  // MESSAGE mode. The achieved ratio is sampled over a window of messages per
+  // topic; a topic below the threshold stops being compressed for the rest of
+  // the recording, so incompressible payloads do not keep burning CPU.
+  // Values of zero or below disable the adaptive check. Topics on the
+  // include list are always compressed.
+  double minimum_compression_ratio = 1.05;
 };
 
 }  // namespace rosbag2_compression
@@ -15,8 +15,14 @@
 #ifndef ROSBAG2_COMPRESSION__SEQUENTIAL_COMPRESSION_READER_HPP_
 #define ROSBAG2_COMPRESSION__SEQUENTIAL_COMPRESSION_READER_HPP_
 
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "rosbag2_compression/base_decompressor_interface.hpp"
@@ -66,8 +72,19 @@ public:
     const rosbag2_cpp::StorageOptions & storage_options,
     const rosbag2_cpp::ConverterOptions & converter_options) override;
 
+  bool has_next() override;
+
   std::shared_ptr<rosbag2_storage::SerializedBagMessage> read_next() override;
 
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+  read_next_batch(size_t max_batch_size) override;
+
+  void set_filter(const rosbag2_storage::StorageFilter & storage_filter) override;
+
+  void reset_filter() override;
+
+  void seek(rcutils_time_point_value_t timestamp) override;
+
 protected:
   /**
    * Increment the current file iterator to point to the next file in the list of relative file
@@ -78,6 +95,13 @@ protected:
    */
   void load_next_file() override;
 
+  /**
+   * In FILE mode the on-disk path of the next split is only known once its
+   * background decompression finished, so the base class must not open the
+   * still-compressed file ahead of time. Other modes preload as usual.
+   */
+  void preload_next_file() override;
+
   /**
    * Initializes the decompressor if a compression mode is specified in the metadata.
    *
@@ -85,8 +109,138 @@ protected:
    */
   virtual void setup_decompression();
 
+  /**
+   * Fill topics_metadata_ from the metadata, hiding the pseudo topic which
+   * carries chunk rows in CHUNK mode.
+   */
+  void fill_topics_metadata() override;
+
 private:
+  /**
+   * Load the compression dictionaries written alongside the bag, if any,
+   * and register them with the decompressor. Only used in MESSAGE mode.
+   *
+   * \param uri The bag folder.
+   */
+  void load_compression_dictionaries(const std::string & uri);
+
+  /**
+   * Start decompressing the next split on a background thread, so the
+   * transition at the file boundary does not stall playback. Only used in
+   * FILE mode; a no-op when the current split is the last one.
+   */
+  void prefetch_next_file();
+
+  /**
+   * Delete the decompressed copy of a split the read cursor moved past.
+   * A no-op without a scratch directory, where the legacy behavior of
+   * leaving the decompressed files behind is kept. A copy that cannot be
+   * removed is logged and left behind.
+   */
+  void remove_decompressed_split(const std::string & path);
+
+  /**
+   * Read the next row from storage and append the messages it yields to
+   * chunk_messages_, applying the active filter. A chunk row is decompressed
+   * and unpacked; any other row passes through individually.
+   */
+  void load_next_chunk();
+
+  /**
+   * Whether the message passes the active filter, including the time bounds.
+   */
+  bool message_passes_filter(const rosbag2_storage::SerializedBagMessage & message);
+
+  /**
+   * Whether the topic passes the topic part of the active filter, using the
+   * same matching rules as the storage plugins. Results are cached per topic
+   * so the regular expressions run only once per topic.
+   */
+  bool topic_passes_filter(const std::string & topic_name);
+
+  /**
+   * One in-flight MESSAGE-mode decompression. Jobs sit in decode_window_ in
+   * storage order; the workers mark them done in whatever order they finish
+   * and read_next() only ever takes the window's front, so the output order
+   * is restored without explicit sequence numbers.
+   */
+  struct DecodeJob
+  {
+    std::shared_ptr<rosbag2_storage::SerializedBagMessage> message;
+    bool done{false};
+    // A decode failure is rethrown on the reading thread when the job's
+    // message is consumed.
+    std::exception_ptr error;
+  };
+
+  // Starts the decode worker pool. Only used in MESSAGE compression mode.
+  void start_decode_workers();
+
+  // Stops the decode workers after draining the queue of claimed jobs.
+  void stop_decode_workers();
+
+  // Body of a decode worker thread.
+  void decode_worker_loop();
+
+  /**
+   * Read from storage until the decode window is full or the bag is
+   * exhausted, handing each message to the workers. Runs on the reading
+   * thread, so the storage cursor stays single threaded; only the zstd work
+   * fans out.
+   */
+  void fill_decode_window();
+
+  /**
+   * Discard all buffered and in-flight decode jobs; used when a seek or a
+   * filter change invalidates the messages read ahead of the consumer.
+   */
+  void drop_decode_window();
+
   std::unique_ptr<rosbag2_compression::BaseDecompressorInterface> decompressor_{};
+
+  // Messages unpacked from the most recent chunk row which were not yet
+  // returned by read_next(). Only used in CHUNK mode.
+  std::deque<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> chunk_messages_;
+
+  // In CHUNK mode the filter is applied after unpacking, since a storage-side
+  // filter would discard the chunk rows themselves.
+  rosbag2_storage::StorageFilter chunk_filter_{};
+
+  // Per-topic filter decisions, invalidated when the filter changes.
+  std::unordered_map<std::string, bool> chunk_filter_topic_cache_;
+
+  // Worker threads decompressing MESSAGE-mode payloads between the storage
+  // cursor and the consumer, so replay throughput scales with cores instead
+  // of being bounded by one thread's zstd speed.
+  std::vector<std::thread> decode_workers_;
+  std::mutex decode_mutex_;
+  // Wakes the workers when jobs arrive, and the reading thread when the
+  // window's front job finished.
+  std::condition_variable decode_pending_condition_;
+  std::condition_variable decode_done_condition_;
+  // All in-flight jobs in storage order; only the reading thread touches it.
+  std::deque<std::shared_ptr<DecodeJob>> decode_window_;
+  // The subset of the window not yet claimed by a worker.
+  std::deque<std::shared_ptr<DecodeJob>> decode_pending_;
+  bool stop_decode_workers_{false};
+
+  // Dictionary contents loaded alongside the bag, kept so every decode
+  // worker can register them with its own decompressor.
+  std::vector<std::vector<uint8_t>> compression_dictionaries_;
+
+  // Decompressed uri of the next split, produced in the background while the
+  // current split is being read.
+  std::future<std::string> next_file_future_;
+
+  // Directory the FILE-mode splits are decompressed into (e.g. a tmpfs),
+  // with delete-behind of the copies; empty keeps the legacy in-place
+  // decompression. Taken from the storage options on open().
+  std::string scratch_directory_;
+
+  // Decompressed copy of the split before the previous one, deleted on the
+  // next file transition. The removal lags one split so that the storage
+  // which read the copy was closed long before the file is unlinked.
+  std::string split_pending_removal_;
   rosbag2_compression::CompressionMode compression_mode_{
     rosbag2_compression::CompressionMode::NONE};
   std::unique_ptr<rosbag2_compression::CompressionFactory> compression_factory_{};
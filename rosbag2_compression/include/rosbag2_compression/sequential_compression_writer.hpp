@@ -15,9 +15,14 @@
 #ifndef ROSBAG2_COMPRESSION__SEQUENTIAL_COMPRESSION_WRITER_HPP_
 #define ROSBAG2_COMPRESSION__SEQUENTIAL_COMPRESSION_WRITER_HPP_
 
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "rosbag2_cpp/converter.hpp"
@@ -81,11 +86,42 @@ public:
    */
   void reset() override;
 
+  /**
+   * Write a message to the bagfile.
+   *
+   * In CHUNK compression mode the message is buffered and written once enough
+   * messages accumulated to fill a chunk; other modes write immediately.
+   *
+   * \param message The message to be written.
+   */
+  void write(std::shared_ptr<rosbag2_storage::SerializedBagMessage> message) override;
+
 protected:
   /**
-   * Compress the most recent file and update the metadata file path.
+   * A closed split file queued for background compression, together with the
+   * time range it covers for the sealed-file notification.
+   */
+  struct FileToCompress
+  {
+    std::string relative_path;
+    int64_t starting_time_ns;
+    int64_t ending_time_ns;
+  };
+
+  /**
+   * Compress a closed bagfile and update its entry in the metadata file paths.
+   *
+   * Runs on a compression worker thread; an empty or missing file is dropped
+   * from the metadata instead of being compressed. In FILE mode the sealed
+   * artifact is the compressed file, so the sealed-file notification fires
+   * from here once compression finished.
+   *
+   * \param compressor The compressor owned by the calling worker thread.
+   * \param file_to_compress The closed file, with its path as stored in the metadata.
    */
-  virtual void compress_last_file();
+  virtual void compress_file(
+    BaseCompressorInterface & compressor,
+    const FileToCompress & file_to_compress);
 
   /**
    * Checks if the compression by message option is specified and a compressor exists.
@@ -112,9 +148,98 @@ private:
 
   bool should_compress_last_file_{true};
 
+  // MESSAGE-mode dictionary training: serialized payloads collected per topic
+  // until enough samples are available to train a compression dictionary.
+  std::unordered_map<std::string, std::vector<std::vector<uint8_t>>> dictionary_samples_;
+
+  // Topics for which dictionary training already ran, successfully or not.
+  std::unordered_set<std::string> dictionary_trained_topics_;
+
+  // Number of dictionaries written so far, used to name the dictionary files.
+  uint64_t dictionary_count_{0};
+
+  // Collects a training sample from the message and trains a per-topic
+  // dictionary once enough samples were seen. Only used in MESSAGE mode.
+  void collect_dictionary_sample(const rosbag2_storage::SerializedBagMessage & message);
+
+  // Uncompressed and compressed byte counts of a topic's recent messages,
+  // accumulated until the adaptive bypass decision for the current sampling
+  // window is made.
+  struct TopicCompressionSample
+  {
+    uint64_t messages = 0;
+    uint64_t uncompressed_bytes = 0;
+    uint64_t compressed_bytes = 0;
+  };
+
+  // Per-topic ratio samples of the current window. Only used in MESSAGE mode.
+  std::unordered_map<std::string, TopicCompressionSample> compression_ratio_samples_;
+
+  // Topics the adaptive check decided not to compress anymore. Their messages
+  // are stored as-is; the decompressor passes uncompressed payloads through,
+  // so bags mixing compressed and bypassed messages stay readable.
+  std::unordered_set<std::string> compression_bypassed_topics_;
+
+  // Static include/exclude lists from the compression options, kept as sets
+  // for the per-message lookup.
+  std::unordered_set<std::string> compression_include_topics_;
+  std::unordered_set<std::string> compression_exclude_topics_;
+
+  // Whether messages of the topic should be compressed in MESSAGE mode, based
+  // on the static lists and earlier adaptive bypass decisions.
+  bool should_compress_topic(const std::string & topic_name) const;
+
+  // Accounts one compressed message towards the topic's sampling window and
+  // bypasses the topic once a full window stayed below the ratio threshold.
+  void sample_compression_ratio(
+    const std::string & topic_name, uint64_t uncompressed_bytes, uint64_t compressed_bytes);
+
+  // Messages buffered for the current chunk, in write order. Only used in
+  // CHUNK mode.
+  std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> chunk_buffer_;
+
+  // Serialized payload bytes accumulated in chunk_buffer_.
+  size_t chunk_buffer_size_{0};
+
+  // Whether the pseudo topic carrying chunk rows was registered yet.
+  bool chunk_topic_created_{false};
+
+  // Packs the buffered messages into one chunk row, compresses it as a single
+  // frame and writes it under the chunk pseudo topic.
+  void flush_chunk();
+
+  // Closed split files waiting to be compressed, oldest first.
+  std::deque<FileToCompress> compression_queue_;
+
+  // Worker threads compressing closed split files in the background, so that
+  // recording continues at full rate while a split is compressed.
+  std::vector<std::thread> compression_workers_;
+
+  // Guards compression_queue_ and mutations of metadata_.relative_file_paths.
+  std::mutex compression_queue_mutex_;
+  std::condition_variable compression_queue_condition_;
+  bool stop_compression_workers_{false};
+
+  // Starts the compression worker pool. Only used in FILE compression mode.
+  void start_compression_workers();
+
+  // Stops the compression workers after draining the queue of pending files.
+  void stop_compression_workers();
+
+  // Body of a compression worker thread.
+  void compression_worker_loop();
+
+  // Hands a closed file over to the compression workers.
+  void enqueue_file_for_compression(const FileToCompress & file_to_compress);
+
   // Closes the current backed storage and opens the next bagfile.
   void split_bagfile() override;
 
+  // The sequential rotation path seals the last file without routing it
+  // through the compression workers, which would leave it uncompressed in
+  // the sealed bag; rotation is rejected until it learns to do that.
+  void rotate_bag(const std::string & new_base_folder) override;
+
   // Prepares the metadata by setting initial values.
   void init_metadata() override;
 
@@ -22,6 +22,8 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "rosbag2_compression/base_compressor_interface.hpp"
 #include "rosbag2_compression/visibility_control.hpp"
@@ -37,7 +39,24 @@ namespace rosbag2_compression
 class ROSBAG2_COMPRESSION_PUBLIC ZstdCompressor : public BaseCompressorInterface
 {
 public:
-  ZstdCompressor() = default;
+  /**
+   * \param compression_level Zstd compression level; higher levels trade
+   * speed for a better ratio. Zero selects zstd's internal default.
+   * \param nb_workers Number of zstd worker threads used when compressing a
+   * whole file, so a single split can saturate multiple cores. Zero compresses
+   * on the calling thread; a negative value selects a default based on the
+   * hardware concurrency.
+   * \param long_distance_matching Enables zstd long-distance matching, which
+   * finds repetitions across a far larger window than the regular match
+   * finder — cross-message redundancy in large splits.
+   * \param window_log log2 of the long-distance match window; zero keeps
+   * zstd's default for the level. Windows larger than the default seekable
+   * frame size grow the frames accordingly.
+   * \param frame_checksum Whether every frame carries a content checksum.
+   */
+  explicit ZstdCompressor(
+    int compression_level = 1, int nb_workers = -1,
+    bool long_distance_matching = false, int window_log = 0, bool frame_checksum = false);
 
   ~ZstdCompressor() = default;
 
@@ -46,7 +65,30 @@ public:
   void compress_serialized_bag_message(
     rosbag2_storage::SerializedBagMessage * bag_message) override;
 
+  std::vector<uint8_t> train_dictionary(
+    const std::vector<std::vector<uint8_t>> & samples) override;
+
+  void set_dictionary(
+    const std::string & topic_name,
+    const std::vector<uint8_t> & dictionary) override;
+
   std::string get_compression_identifier() const override;
+
+private:
+  int compression_level_;
+  int nb_workers_;
+
+  // Uncompressed bytes per independent frame of a seekable archive; grows
+  // with the long-distance match window so larger windows are actually used.
+  size_t seekable_frame_content_size_;
+
+  // Digested per-topic dictionaries used when compressing individual messages.
+  std::unordered_map<std::string,
+    std::unique_ptr<ZSTD_CDict, decltype(&ZSTD_freeCDict)>> dictionaries_;
+
+  // Held for the lifetime of the compressor and reused for every call;
+  // zstd context setup is expensive relative to compressing small messages.
+  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context_;
 };
 
 }  // namespace rosbag2_compression
@@ -22,6 +22,8 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "rosbag2_compression/base_decompressor_interface.hpp"
 #include "rosbag2_compression/visibility_control.hpp"
@@ -37,16 +39,49 @@ namespace rosbag2_compression
 class ROSBAG2_COMPRESSION_PUBLIC ZstdDecompressor : public BaseDecompressorInterface
 {
 public:
-  ZstdDecompressor() = default;
+  ZstdDecompressor();
 
   ~ZstdDecompressor() = default;
 
   std::string decompress_uri(const std::string & uri) override;
 
+  std::string decompress_uri(
+    const std::string & uri, const std::string & destination_directory) override;
+
+  /**
+   * Extract a byte range of the original file from a seekable zstd archive
+   * as written by ZstdCompressor, decompressing only the frames covering the
+   * range instead of the whole file.
+   *
+   * \param uri is the path to the compressed archive.
+   * \param offset is the first byte of the range within the decompressed file.
+   * \param size is the number of bytes to extract; clamped at the end of the
+   * decompressed file.
+   * \param destination_directory is where the extracted file is written; an
+   * empty string writes it next to the archive.
+   * \return the path of the file holding the extracted range.
+   * \throws std::runtime_error if the archive carries no seek table.
+   */
+  std::string decompress_uri_range(
+    const std::string & uri, size_t offset, size_t size,
+    const std::string & destination_directory = "");
+
   void decompress_serialized_bag_message(
     rosbag2_storage::SerializedBagMessage * bag_message) override;
 
+  void add_dictionary(const std::vector<uint8_t> & dictionary) override;
+
   std::string get_decompression_identifier() const override;
+
+private:
+  // Digested dictionaries keyed by their zstd dictionary id; each compressed
+  // frame references the dictionary it was compressed with in its header.
+  std::unordered_map<unsigned int,
+    std::unique_ptr<ZSTD_DDict, decltype(&ZSTD_freeDDict)>> dictionaries_by_id_;
+
+  // Held for the lifetime of the decompressor and reused for every call;
+  // zstd context setup is expensive relative to decompressing small messages.
+  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context_;
 };
 
 }  // namespace rosbag2_compression
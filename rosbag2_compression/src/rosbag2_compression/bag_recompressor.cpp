@@ -0,0 +1,141 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_compression/bag_recompressor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+
+#include "rosbag2_compression/compression_factory.hpp"
+#include "rosbag2_compression/compression_options.hpp"
+
+#include "rosbag2_storage/metadata_io.hpp"
+
+#include "logging.hpp"
+
+namespace rosbag2_compression
+{
+
+BagRecompressor::BagRecompressor(const Options & options)
+: options_(options)
+{}
+
+void BagRecompressor::run()
+{
+  rosbag2_storage::MetadataIo metadata_io;
+  if (!metadata_io.metadata_file_exists(options_.bag_uri)) {
+    throw std::runtime_error(
+            "Bag '" + options_.bag_uri + "' has no metadata file. Only recorded bags "
+            "with a metadata.yaml can be compressed.");
+  }
+  auto metadata = metadata_io.read_metadata(options_.bag_uri);
+  if (!metadata.compression_format.empty()) {
+    throw std::runtime_error(
+            "Bag '" + options_.bag_uri + "' is already compressed with '" +
+            metadata.compression_format + "'.");
+  }
+  if (metadata.relative_file_paths.empty()) {
+    throw std::runtime_error("Bag '" + options_.bag_uri + "' lists no files to compress.");
+  }
+
+  CompressionOptions compression_options;
+  compression_options.compression_format = options_.compression_format;
+  compression_options.compression_mode = CompressionMode::FILE;
+  compression_options.compression_level = options_.compression_level;
+  // One thread per file; the parallelism comes from compressing the
+  // independent splits concurrently.
+  compression_options.compression_threads = 0;
+  // Fail early on an unknown format, before any worker starts.
+  if (!CompressionFactory().create_compressor(compression_options)) {
+    throw std::runtime_error(
+            "Could not create a compressor for format '" +
+            options_.compression_format + "'.");
+  }
+
+  auto worker_count = options_.worker_count > 0 ?
+    options_.worker_count : static_cast<size_t>(std::thread::hardware_concurrency());
+  worker_count = std::max<size_t>(1, std::min(worker_count, metadata.relative_file_paths.size()));
+
+  // The splits are independent files; workers pull indices from a shared
+  // counter and write the new path back to the slot they took, so the file
+  // order in the metadata is preserved.
+  std::atomic<size_t> next_file_index{0};
+  std::vector<std::string> new_relative_paths = metadata.relative_file_paths;
+  std::vector<std::string> errors(metadata.relative_file_paths.size());
+
+  auto worker = [this, &metadata, &next_file_index, &new_relative_paths, &errors,
+      &compression_options]() {
+      auto compressor = CompressionFactory().create_compressor(compression_options);
+      while (true) {
+        const auto index = next_file_index.fetch_add(1);
+        if (index >= metadata.relative_file_paths.size()) {
+          break;
+        }
+        const auto & relative_path = metadata.relative_file_paths[index];
+        const auto file_path = rcpputils::fs::path(options_.bag_uri) / relative_path;
+        try {
+          const auto compressed_uri = compressor->compress_uri(file_path.string());
+          // Keep the directory component of the metadata entry; only the
+          // suffix added by the compressor changes.
+          new_relative_paths[index] =
+            relative_path + compressed_uri.substr(file_path.string().size());
+          if (!rcpputils::fs::remove(file_path)) {
+            ROSBAG2_COMPRESSION_LOG_ERROR_STREAM(
+              "Failed to remove uncompressed bag file: \"" << file_path.string() << "\"");
+          }
+        } catch (const std::exception & e) {
+          errors[index] = e.what();
+        }
+      }
+    };
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back(worker);
+  }
+  for (auto & thread : workers) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < errors.size(); ++i) {
+    if (!errors[i].empty()) {
+      throw std::runtime_error(
+              "Could not compress bag file \"" + metadata.relative_file_paths[i] + "\": " +
+              errors[i]);
+    }
+  }
+
+  // The per-file time ranges keep their entries; only the paths change.
+  for (auto & file_information : metadata.files) {
+    for (size_t i = 0; i < metadata.relative_file_paths.size(); ++i) {
+      if (file_information.path == metadata.relative_file_paths[i]) {
+        file_information.path = new_relative_paths[i];
+        break;
+      }
+    }
+  }
+  metadata.relative_file_paths = new_relative_paths;
+  metadata.compression_format = options_.compression_format;
+  metadata.compression_mode = compression_mode_to_string(CompressionMode::FILE);
+  metadata_io.write_metadata(options_.bag_uri, metadata);
+}
+
+}  // namespace rosbag2_compression
@@ -0,0 +1,110 @@
+// Copyright 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "chunk_serialization.hpp"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rosbag2_storage/ros_helper.hpp"
+
+namespace rosbag2_compression
+{
+
+namespace
+{
+
+template<typename T>
+void append_value(std::vector<uint8_t> & buffer, const T & value)
+{
+  const auto * begin = reinterpret_cast<const uint8_t *>(&value);
+  buffer.insert(buffer.end(), begin, begin + sizeof(T));
+}
+
+template<typename T>
+T read_value(const rosbag2_storage::SerializedBagMessage & chunk, size_t & offset)
+{
+  if (chunk.serialized_data->buffer_length - offset < sizeof(T)) {
+    throw std::runtime_error{"Chunk read from the bag is truncated or malformed!"};
+  }
+  T value;
+  std::memcpy(&value, chunk.serialized_data->buffer + offset, sizeof(T));
+  offset += sizeof(T);
+  return value;
+}
+
+}  // namespace
+
+std::vector<uint8_t> serialize_chunk(
+  const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> & messages)
+{
+  size_t packed_size = sizeof(uint32_t);
+  for (const auto & message : messages) {
+    packed_size += sizeof(int64_t) + 2 * sizeof(uint32_t) +
+      message->topic_name.size() + message->serialized_data->buffer_length;
+  }
+
+  std::vector<uint8_t> buffer;
+  buffer.reserve(packed_size);
+  append_value(buffer, static_cast<uint32_t>(messages.size()));
+  for (const auto & message : messages) {
+    append_value(buffer, static_cast<int64_t>(message->time_stamp));
+    append_value(buffer, static_cast<uint32_t>(message->topic_name.size()));
+    buffer.insert(buffer.end(), message->topic_name.begin(), message->topic_name.end());
+    append_value(buffer, static_cast<uint32_t>(message->serialized_data->buffer_length));
+    buffer.insert(
+      buffer.end(),
+      message->serialized_data->buffer,
+      message->serialized_data->buffer + message->serialized_data->buffer_length);
+  }
+  return buffer;
+}
+
+std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> deserialize_chunk(
+  const rosbag2_storage::SerializedBagMessage & chunk)
+{
+  size_t offset = 0;
+  const auto message_count = read_value<uint32_t>(chunk, offset);
+
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages;
+  messages.reserve(message_count);
+  for (uint32_t i = 0; i < message_count; ++i) {
+    auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+    message->time_stamp = read_value<int64_t>(chunk, offset);
+
+    const auto topic_length = read_value<uint32_t>(chunk, offset);
+    if (chunk.serialized_data->buffer_length - offset < topic_length) {
+      throw std::runtime_error{"Chunk read from the bag is truncated or malformed!"};
+    }
+    message->topic_name = std::string{
+      reinterpret_cast<const char *>(chunk.serialized_data->buffer + offset), topic_length};
+    offset += topic_length;
+
+    const auto payload_length = read_value<uint32_t>(chunk, offset);
+    if (chunk.serialized_data->buffer_length - offset < payload_length) {
+      throw std::runtime_error{"Chunk read from the bag is truncated or malformed!"};
+    }
+    message->serialized_data = rosbag2_storage::make_serialized_message(
+      chunk.serialized_data->buffer + offset, payload_length);
+    offset += payload_length;
+
+    messages.push_back(message);
+  }
+  return messages;
+}
+
+}  // namespace rosbag2_compression
@@ -0,0 +1,59 @@
+// Copyright 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_COMPRESSION__CHUNK_SERIALIZATION_HPP_
+#define ROSBAG2_COMPRESSION__CHUNK_SERIALIZATION_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "rosbag2_storage/serialized_bag_message.hpp"
+
+namespace rosbag2_compression
+{
+
+// Pseudo topic under which CHUNK mode stores packed groups of messages.
+// The reader unpacks these rows and never exposes the topic to consumers.
+constexpr const char kChunkTopicName[] = "/_rosbag2_compression_chunks";
+
+// Marker type for the chunk pseudo topic. It is never resolved against a
+// message definition since the reader filters the topic out again.
+constexpr const char kChunkTopicType[] = "rosbag2_compression/CompressedChunk";
+
+/**
+ * Pack a group of serialized messages into a single buffer.
+ *
+ * The buffer starts with the message count, followed by one record per
+ * message carrying its timestamp, topic name and serialized payload. Like
+ * the payloads themselves, the framing is written in host byte order.
+ *
+ * \param messages The messages to pack, in write order.
+ * \return The packed buffer.
+ */
+std::vector<uint8_t> serialize_chunk(
+  const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> & messages);
+
+/**
+ * Unpack a chunk row into the messages it contains.
+ *
+ * \param chunk A decompressed message read from the chunk pseudo topic.
+ * \return The contained messages, in write order.
+ * \throws std::runtime_error if the buffer is truncated or malformed.
+ */
+std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> deserialize_chunk(
+  const rosbag2_storage::SerializedBagMessage & chunk);
+
+}  // namespace rosbag2_compression
+
+#endif  // ROSBAG2_COMPRESSION__CHUNK_SERIALIZATION_HPP_
@@ -30,7 +30,13 @@ CompressionFactory::~CompressionFactory() = default;
 std::unique_ptr<rosbag2_compression::BaseCompressorInterface>
 CompressionFactory::create_compressor(const std::string & compression_format)
 {
-  return impl_->create_compressor(compression_format);
+  return impl_->create_compressor(CompressionOptions{compression_format, CompressionMode::NONE});
+}
+
+std::unique_ptr<rosbag2_compression::BaseCompressorInterface>
+CompressionFactory::create_compressor(const CompressionOptions & compression_options)
+{
+  return impl_->create_compressor(compression_options);
 }
 
 std::unique_ptr<rosbag2_compression::BaseDecompressorInterface>
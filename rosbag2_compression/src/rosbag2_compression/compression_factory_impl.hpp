@@ -30,6 +30,10 @@ namespace
 
 constexpr const char kCompressionFormatZstd[] = "zstd";
 
+// Zstd running at a negative (--fast) compression level. The frames it
+// produces are regular zstd frames, so the zstd decompressor reads them.
+constexpr const char kCompressionFormatZstdFast[] = "zstd_fast";
+
 /// Verify whether two case-insensitive chars are equal
 bool compare_char(const char c1, const char c2)
 {
@@ -56,13 +60,29 @@ public:
 
   /// See CompressionFactory::create_compressor for documentation.
   std::unique_ptr<rosbag2_compression::BaseCompressorInterface>
-  create_compressor(const std::string & compression_format)
+  create_compressor(const CompressionOptions & compression_options)
   {
-    if (case_insensitive_compare(compression_format, kCompressionFormatZstd)) {
-      return std::make_unique<rosbag2_compression::ZstdCompressor>();
+    if (case_insensitive_compare(compression_options.compression_format, kCompressionFormatZstd)) {
+      return std::make_unique<rosbag2_compression::ZstdCompressor>(
+        compression_options.compression_level, compression_options.compression_threads,
+        compression_options.zstd_long_distance_matching, compression_options.zstd_window_log,
+        compression_options.zstd_frame_checksum);
+    } else if (case_insensitive_compare(
+        compression_options.compression_format, kCompressionFormatZstdFast))
+    {
+      // Negative zstd levels skip the entropy stage for a multiple of the
+      // regular throughput, at the cost of ratio; the configured level
+      // selects the acceleration factor (level N runs as --fast=N).
+      const int fast_level = compression_options.compression_level > 0 ?
+        -compression_options.compression_level : compression_options.compression_level;
+      return std::make_unique<rosbag2_compression::ZstdCompressor>(
+        fast_level, compression_options.compression_threads,
+        compression_options.zstd_long_distance_matching, compression_options.zstd_window_log,
+        compression_options.zstd_frame_checksum);
     } else {
       std::stringstream errmsg;
-      errmsg << "Compression format \"" << compression_format << "\" is not supported.";
+      errmsg << "Compression format \"" << compression_options.compression_format <<
+        "\" is not supported.";
       ROSBAG2_COMPRESSION_LOG_ERROR_STREAM(errmsg.str());
       throw std::invalid_argument{errmsg.str()};
     }
@@ -72,7 +92,9 @@ public:
   std::unique_ptr<rosbag2_compression::BaseDecompressorInterface>
   create_decompressor(const std::string & compression_format)
   {
-    if (case_insensitive_compare(compression_format, kCompressionFormatZstd)) {
+    if (case_insensitive_compare(compression_format, kCompressionFormatZstd) ||
+      case_insensitive_compare(compression_format, kCompressionFormatZstdFast))
+    {
       return std::make_unique<rosbag2_compression::ZstdDecompressor>();
     } else {
       std::stringstream errmsg;
@@ -17,14 +17,8 @@
 #include <string>
 #include <vector>
 
-namespace
+namespace rosbag2_compression
 {
-/**
- * Open a file using the OS-specific C API.
- * \param uri is the path to the file.
- * \param read_mode is the read mode accepted by OS-specific fopen.
- * \return the FILE pointer or nullptr if the file was not opened.
- */
 FILE * open_file(const std::string & uri, const std::string & read_mode)
 {
   FILE * fp{nullptr};
@@ -35,10 +29,19 @@ FILE * open_file(const std::string & uri, const std::string & read_mode)
 #endif
   return fp;
 }
-}  // namespace
 
-namespace rosbag2_compression
+FilePointer open_file_or_throw(const std::string & uri, const std::string & mode)
 {
+  FilePointer file{open_file(uri, mode), &fclose};
+  if (!file) {
+    std::stringstream errmsg;
+    errmsg << "Failed to open file: \"" << uri <<
+      "\" with mode \"" << mode << "\"! errno(" << errno << ")";
+
+    throw std::runtime_error{errmsg.str()};
+  }
+  return file;
+}
 std::vector<uint8_t> get_input_buffer(const std::string & uri)
 {
   // Read in buffer, handling accordingly
@@ -18,6 +18,7 @@
 #include <zstd.h>
 
 #include <chrono>
+#include <cstdio>
 #include <memory>
 #include <string>
 #include <vector>
@@ -48,6 +49,26 @@ using ZstdDecompressReturnType = decltype(ZSTD_decompress(
 // Used as a parameter type in a function that accepts the output of ZSTD_getFrameContentSize.
 using ZstdGetFrameContentSizeReturnType = decltype(ZSTD_getFrameContentSize(nullptr, 0));
 
+// Owning FILE pointer used by the streaming compression and decompression loops.
+using FilePointer = std::unique_ptr<FILE, decltype(&fclose)>;
+
+/**
+ * Open a file using the OS-specific C API.
+ * \param uri is the path to the file.
+ * \param read_mode is the read mode accepted by OS-specific fopen.
+ * \return the FILE pointer or nullptr if the file was not opened.
+ */
+FILE * open_file(const std::string & uri, const std::string & read_mode);
+
+/**
+ * Open a file using the OS-specific C API, throwing when it cannot be opened.
+ * \param uri is the path to the file.
+ * \param mode is the mode accepted by OS-specific fopen.
+ * \return an owning FILE pointer.
+ * \throws std::runtime_error if the file was not opened.
+ */
+FilePointer open_file_or_throw(const std::string & uri, const std::string & mode);
+
 /**
  * Read a file from the supplied uri into a vector.
  *
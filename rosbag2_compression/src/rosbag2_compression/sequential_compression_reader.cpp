@@ -14,7 +14,9 @@
 
 #include "rosbag2_compression/sequential_compression_reader.hpp"
 
+#include <algorithm>
 #include <memory>
+#include <regex>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -25,10 +27,29 @@
 #include "rosbag2_compression/compression_options.hpp"
 #include "rosbag2_compression/zstd_decompressor.hpp"
 
+#include "chunk_serialization.hpp"
+#include "compression_utils.hpp"
 #include "logging.hpp"
 
 namespace rosbag2_compression
 {
+
+namespace
+{
+// Number of MESSAGE-mode messages read ahead of the consumer and handed to
+// the decode workers; bounds the memory pinned by in-flight decompression.
+constexpr const size_t DECODE_WINDOW_SIZE = 64;
+
+// Number of worker threads decompressing MESSAGE-mode payloads. Capped so a
+// replay does not monopolize a large machine; zstd decode usually keeps up
+// well before the cap.
+size_t decode_worker_count()
+{
+  const auto hardware = std::thread::hardware_concurrency();
+  return hardware == 0 ? 2u : std::min<size_t>(hardware, 4u);
+}
+}  // namespace
+
 SequentialCompressionReader::SequentialCompressionReader(
   std::unique_ptr<rosbag2_compression::CompressionFactory> compression_factory,
   std::unique_ptr<rosbag2_storage::StorageFactoryInterface> storage_factory,
@@ -39,7 +60,25 @@ SequentialCompressionReader::SequentialCompressionReader(
 {}
 
 SequentialCompressionReader::~SequentialCompressionReader()
-{}
+{
+  stop_decode_workers();
+  // A pending prefetch uses members of this reader; let it finish first.
+  if (next_file_future_.valid()) {
+    try {
+      remove_decompressed_split(next_file_future_.get());
+    } catch (...) {
+      // A failed prefetch left nothing behind to clean up.
+    }
+  }
+  if (compression_mode_ == CompressionMode::FILE && !scratch_directory_.empty()) {
+    // Close the storage before unlinking its backing file.
+    storage_.reset();
+    remove_decompressed_split(split_pending_removal_);
+    if (!file_paths_.empty() && current_file_iterator_ != file_paths_.end()) {
+      remove_decompressed_split(*current_file_iterator_);
+    }
+  }
+}
 
 void SequentialCompressionReader::setup_decompression()
 {
@@ -50,7 +89,9 @@ void SequentialCompressionReader::setup_decompression()
     // per-message encryption.
     if (compression_mode_ == CompressionMode::FILE) {
       ROSBAG2_COMPRESSION_LOG_DEBUG_STREAM("Decompressing " << get_current_file().c_str());
-      *current_file_iterator_ = decompressor_->decompress_uri(get_current_file());
+      *current_file_iterator_ =
+        decompressor_->decompress_uri(get_current_file(), scratch_directory_);
+      prefetch_next_file();
     }
   } else {
     throw std::invalid_argument{
@@ -70,7 +111,12 @@ void SequentialCompressionReader::open(
     }
     file_paths_ = metadata_.relative_file_paths;
     current_file_iterator_ = file_paths_.begin();
+    scratch_directory_ = storage_options.decompression_scratch_directory;
     setup_decompression();
+    if (compression_mode_ == CompressionMode::MESSAGE) {
+      load_compression_dictionaries(storage_options.uri);
+      start_decode_workers();
+    }
 
     storage_ = storage_factory_->open_read_only(
       *current_file_iterator_, metadata_.storage_identifier);
@@ -87,6 +133,7 @@ void SequentialCompressionReader::open(
       "\". Legacy bag files are not supported if this is a ROS 1 bag file.";
     throw std::runtime_error{errmsg.str()};
   }
+  preload_next_file();
   const auto & topics = metadata_.topics_with_message_count;
   if (topics.empty()) {
     ROSBAG2_COMPRESSION_LOG_WARN("No topics were listed in metadata.");
@@ -101,18 +148,282 @@ void SequentialCompressionReader::open(
     topics[0].topic_metadata.serialization_format);
 }
 
+void SequentialCompressionReader::load_compression_dictionaries(const std::string & uri)
+{
+  // Dictionary files are numbered consecutively by the writer.
+  for (uint64_t i = 0; ; ++i) {
+    const auto dictionary_path =
+      rcpputils::fs::path{uri} / ("compression_dictionary_" + std::to_string(i) + ".dict");
+    if (!dictionary_path.exists()) {
+      break;
+    }
+    ROSBAG2_COMPRESSION_LOG_DEBUG_STREAM(
+      "Loading compression dictionary " << dictionary_path.string());
+    auto dictionary = get_input_buffer(dictionary_path.string());
+    decompressor_->add_dictionary(dictionary);
+    compression_dictionaries_.push_back(std::move(dictionary));
+  }
+}
+
+void SequentialCompressionReader::start_decode_workers()
+{
+  if (!decode_workers_.empty()) {
+    return;
+  }
+  stop_decode_workers_ = false;
+  for (size_t i = 0; i < decode_worker_count(); ++i) {
+    decode_workers_.emplace_back(&SequentialCompressionReader::decode_worker_loop, this);
+  }
+}
+
+void SequentialCompressionReader::stop_decode_workers()
+{
+  {
+    std::lock_guard<std::mutex> lock{decode_mutex_};
+    stop_decode_workers_ = true;
+  }
+  decode_pending_condition_.notify_all();
+  for (auto & worker : decode_workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  decode_workers_.clear();
+}
+
+void SequentialCompressionReader::decode_worker_loop()
+{
+  // Each worker owns its decompressor; decompressor instances are not
+  // thread safe.
+  std::unique_ptr<BaseDecompressorInterface> decompressor;
+  while (true) {
+    std::shared_ptr<DecodeJob> job;
+    {
+      std::unique_lock<std::mutex> lock{decode_mutex_};
+      decode_pending_condition_.wait(
+        lock,
+        [this] {return !decode_pending_.empty() || stop_decode_workers_;});
+      if (decode_pending_.empty()) {
+        break;  // Stop was requested and all claimed jobs are decoded.
+      }
+      job = decode_pending_.front();
+      decode_pending_.pop_front();
+    }
+
+    try {
+      if (!decompressor) {
+        decompressor = compression_factory_->create_decompressor(metadata_.compression_format);
+        if (!decompressor) {
+          throw std::runtime_error{"Could not create a decompressor for a decode worker!"};
+        }
+        for (const auto & dictionary : compression_dictionaries_) {
+          decompressor->add_dictionary(dictionary);
+        }
+      }
+      decompressor->decompress_serialized_bag_message(job->message.get());
+    } catch (...) {
+      // Surfaced on the reading thread when the job's message is consumed.
+      job->error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock{decode_mutex_};
+      job->done = true;
+    }
+    decode_done_condition_.notify_all();
+  }
+}
+
+void SequentialCompressionReader::fill_decode_window()
+{
+  // Only the reading thread mutates the window, so its size is read without
+  // the lock; the lock covers the queue shared with the workers.
+  while (decode_window_.size() < DECODE_WINDOW_SIZE && SequentialReader::has_next()) {
+    auto job = std::make_shared<DecodeJob>();
+    job->message = storage_->read_next();
+    decode_window_.push_back(job);
+    {
+      std::lock_guard<std::mutex> lock{decode_mutex_};
+      decode_pending_.push_back(job);
+    }
+    decode_pending_condition_.notify_one();
+  }
+}
+
+bool SequentialCompressionReader::has_next()
+{
+  if (compression_mode_ == rosbag2_compression::CompressionMode::MESSAGE) {
+    // Keep the decode window full so the workers always have input; every
+    // message in the window was already read from storage.
+    fill_decode_window();
+    return !decode_window_.empty();
+  }
+  if (compression_mode_ != rosbag2_compression::CompressionMode::CHUNK) {
+    return SequentialReader::has_next();
+  }
+  // Reading ahead is required since a filter may discard every message in
+  // the remaining chunks.
+  while (chunk_messages_.empty() && SequentialReader::has_next()) {
+    load_next_chunk();
+  }
+  return !chunk_messages_.empty();
+}
+
 std::shared_ptr<rosbag2_storage::SerializedBagMessage> SequentialCompressionReader::read_next()
 {
   if (storage_ && decompressor_) {
-    auto message = storage_->read_next();
+    if (compression_mode_ == rosbag2_compression::CompressionMode::CHUNK) {
+      while (chunk_messages_.empty()) {
+        if (!SequentialReader::has_next()) {
+          throw std::runtime_error{"No more messages left in the bag!"};
+        }
+        load_next_chunk();
+      }
+      auto message = chunk_messages_.front();
+      chunk_messages_.pop_front();
+      return converter_ ? converter_->convert(message) : message;
+    }
     if (compression_mode_ == rosbag2_compression::CompressionMode::MESSAGE) {
-      decompressor_->decompress_serialized_bag_message(message.get());
+      fill_decode_window();
+      if (decode_window_.empty()) {
+        throw std::runtime_error{"No more messages left in the bag!"};
+      }
+      auto job = decode_window_.front();
+      decode_window_.pop_front();
+      {
+        std::unique_lock<std::mutex> lock{decode_mutex_};
+        decode_done_condition_.wait(lock, [&job] {return job->done;});
+      }
+      if (job->error) {
+        std::rethrow_exception(job->error);
+      }
+      return converter_ ? converter_->convert(job->message) : job->message;
     }
+    auto message = storage_->read_next();
     return converter_ ? converter_->convert(message) : message;
   }
   throw std::runtime_error{"Bag is not open. Call open() before reading."};
 }
 
+std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+SequentialCompressionReader::read_next_batch(size_t max_batch_size)
+{
+  // Messages must pass through decompression and chunk unpacking, so the
+  // batch is assembled through read_next() rather than the storage batch
+  // interface.
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> batch;
+  batch.reserve(max_batch_size);
+  while (batch.size() < max_batch_size && has_next()) {
+    batch.push_back(read_next());
+  }
+  return batch;
+}
+
+void SequentialCompressionReader::load_next_chunk()
+{
+  auto chunk = storage_->read_next();
+  if (chunk->topic_name == kChunkTopicName) {
+    decompressor_->decompress_serialized_bag_message(chunk.get());
+    for (auto & message : deserialize_chunk(*chunk)) {
+      if (message_passes_filter(*message)) {
+        chunk_messages_.push_back(message);
+      }
+    }
+  } else if (message_passes_filter(*chunk)) {
+    // Rows not written by the chunking writer pass through individually.
+    chunk_messages_.push_back(chunk);
+  }
+}
+
+bool SequentialCompressionReader::message_passes_filter(
+  const rosbag2_storage::SerializedBagMessage & message)
+{
+  if (chunk_filter_.start_time >= 0 && message.time_stamp < chunk_filter_.start_time) {
+    return false;
+  }
+  if (chunk_filter_.end_time >= 0 && message.time_stamp > chunk_filter_.end_time) {
+    return false;
+  }
+  return topic_passes_filter(message.topic_name);
+}
+
+bool SequentialCompressionReader::topic_passes_filter(const std::string & topic_name)
+{
+  const auto cached = chunk_filter_topic_cache_.find(topic_name);
+  if (cached != chunk_filter_topic_cache_.end()) {
+    return cached->second;
+  }
+
+  // Same matching rules as the storage plugins: exclusion wins over the
+  // topic list and the include pattern; with neither a topic list nor an
+  // include pattern, everything not excluded is selected.
+  bool selected =
+    (chunk_filter_.topics.empty() && chunk_filter_.topics_regex.empty()) ||
+    std::find(
+    chunk_filter_.topics.begin(), chunk_filter_.topics.end(),
+    topic_name) != chunk_filter_.topics.end() ||
+    (!chunk_filter_.topics_regex.empty() &&
+    std::regex_search(topic_name, std::regex{chunk_filter_.topics_regex}));
+  if (selected && !chunk_filter_.topics_regex_to_exclude.empty() &&
+    std::regex_search(topic_name, std::regex{chunk_filter_.topics_regex_to_exclude}))
+  {
+    selected = false;
+  }
+  chunk_filter_topic_cache_.emplace(topic_name, selected);
+  return selected;
+}
+
+void SequentialCompressionReader::set_filter(
+  const rosbag2_storage::StorageFilter & storage_filter)
+{
+  if (compression_mode_ == rosbag2_compression::CompressionMode::CHUNK) {
+    chunk_filter_ = storage_filter;
+    chunk_filter_topic_cache_.clear();
+    return;
+  }
+  // Messages in the decode window were read with the previous filter.
+  drop_decode_window();
+  SequentialReader::set_filter(storage_filter);
+}
+
+void SequentialCompressionReader::reset_filter()
+{
+  chunk_filter_ = rosbag2_storage::StorageFilter{};
+  chunk_filter_topic_cache_.clear();
+  drop_decode_window();
+  SequentialReader::reset_filter();
+}
+
+void SequentialCompressionReader::seek(rcutils_time_point_value_t timestamp)
+{
+  // Buffered messages belong to the read position before the seek. A job
+  // already claimed by a worker finishes on its private reference; the
+  // result is simply never consumed.
+  drop_decode_window();
+  chunk_messages_.clear();
+  SequentialReader::seek(timestamp);
+}
+
+void SequentialCompressionReader::drop_decode_window()
+{
+  decode_window_.clear();
+  std::lock_guard<std::mutex> lock{decode_mutex_};
+  decode_pending_.clear();
+}
+
+void SequentialCompressionReader::fill_topics_metadata()
+{
+  SequentialReader::fill_topics_metadata();
+  // The pseudo topic carrying chunk rows is an implementation detail of the
+  // writer; consumers only ever see the unpacked messages.
+  topics_metadata_.erase(
+    std::remove_if(
+      topics_metadata_.begin(), topics_metadata_.end(),
+      [](const rosbag2_storage::TopicMetadata & topic) {
+        return topic.name == kChunkTopicName;
+      }),
+    topics_metadata_.end());
+}
+
 
 void SequentialCompressionReader::load_next_file()
 {
@@ -124,6 +435,7 @@ void SequentialCompressionReader::load_next_file()
     throw std::runtime_error{"Cannot use SequentialCompressionReader with NONE compression mode."};
   }
 
+  const auto finished_split = *current_file_iterator_;
   ++current_file_iterator_;
   if (compression_mode_ == rosbag2_compression::CompressionMode::FILE) {
     if (decompressor_ == nullptr) {
@@ -133,8 +445,65 @@ void SequentialCompressionReader::load_next_file()
       };
     }
 
-    ROSBAG2_COMPRESSION_LOG_DEBUG_STREAM("Decompressing " << get_current_file().c_str());
-    *current_file_iterator_ = decompressor_->decompress_uri(get_current_file());
+    if (next_file_future_.valid()) {
+      // The file was decompressed in the background while the previous split
+      // was played; get() also rethrows any error from the prefetch.
+      *current_file_iterator_ = next_file_future_.get();
+    } else {
+      ROSBAG2_COMPRESSION_LOG_DEBUG_STREAM("Decompressing " << get_current_file().c_str());
+      *current_file_iterator_ =
+        decompressor_->decompress_uri(get_current_file(), scratch_directory_);
+    }
+    prefetch_next_file();
+    // The split before the finished one is the oldest decompressed copy
+    // still on disk; its storage was closed when the cursor left it.
+    remove_decompressed_split(split_pending_removal_);
+    split_pending_removal_ = finished_split;
+  }
+}
+
+void SequentialCompressionReader::preload_next_file()
+{
+  if (compression_mode_ == rosbag2_compression::CompressionMode::FILE) {
+    // The decompressed path of the next split does not exist yet;
+    // prefetch_next_file() already hides the transition cost in FILE mode.
+    return;
+  }
+  SequentialReader::preload_next_file();
+}
+
+void SequentialCompressionReader::prefetch_next_file()
+{
+  if (compression_mode_ != rosbag2_compression::CompressionMode::FILE) {
+    return;
+  }
+  const auto next_file = current_file_iterator_ + 1;
+  if (next_file == file_paths_.end()) {
+    return;
+  }
+
+  // The prefetch uses its own decompressor so it never races the one used on
+  // the reading thread.
+  const auto uri = *next_file;
+  next_file_future_ = std::async(
+    std::launch::async,
+    [this, uri]() {
+      auto decompressor =
+        compression_factory_->create_decompressor(metadata_.compression_format);
+      ROSBAG2_COMPRESSION_LOG_DEBUG_STREAM("Decompressing " << uri << " in the background");
+      return decompressor->decompress_uri(uri, scratch_directory_);
+    });
+}
+
+void SequentialCompressionReader::remove_decompressed_split(const std::string & path)
+{
+  if (scratch_directory_.empty() || path.empty()) {
+    // Legacy behavior: decompressed copies next to the bag are left behind.
+    return;
+  }
+  if (!rcpputils::fs::remove(rcpputils::fs::path{path})) {
+    ROSBAG2_COMPRESSION_LOG_WARN_STREAM(
+      "Could not remove decompressed split \"" << path << "\"; leaving it behind.");
   }
 }
 }  // namespace rosbag2_compression
@@ -19,7 +19,9 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "rcpputils/filesystem_helper.hpp"
 
@@ -30,8 +32,11 @@
 #include "rosbag2_cpp/info.hpp"
 #include "rosbag2_cpp/storage_options.hpp"
 
+#include "rosbag2_storage/ros_helper.hpp"
 #include "rosbag2_storage/storage_interfaces/read_write_interface.hpp"
 
+#include "chunk_serialization.hpp"
+#include "compression_utils.hpp"
 #include "logging.hpp"
 
 namespace rosbag2_compression
@@ -39,6 +44,26 @@ namespace rosbag2_compression
 
 namespace
 {
+// Number of background threads compressing closed split files. One worker is
+// enough to keep up as long as a split compresses faster than the next file
+// fills; additional splits simply queue up behind it.
+constexpr const size_t COMPRESSION_WORKER_COUNT = 1;
+
+// Number of messages sampled per topic before a compression dictionary is
+// trained for it in MESSAGE mode. Messages written before that keep
+// compressing without a dictionary.
+constexpr const size_t DICTIONARY_SAMPLE_COUNT = 1000;
+
+// Number of messages per topic over which the achieved compression ratio is
+// averaged before the adaptive bypass check compares it to the configured
+// threshold in MESSAGE mode.
+constexpr const uint64_t COMPRESSION_RATIO_SAMPLE_COUNT = 100;
+
+// Serialized payload bytes buffered before the buffer is compressed as one
+// chunk in CHUNK mode. Large enough that the compressor sees plenty of
+// redundancy across messages, small enough to keep seeks reasonably cheap.
+constexpr const size_t CHUNK_SIZE_THRESHOLD = 4 * 1024 * 1024;
+
 std::string format_storage_uri(const std::string & base_folder, uint64_t storage_count)
 {
   // Right now `base_folder_` is always just the folder name for where to install the bagfile.
@@ -92,7 +117,58 @@ void SequentialCompressionWriter::setup_compression()
     throw std::invalid_argument{
             "SequentialCompressionWriter requires a CompressionMode that is not NONE!"};
   }
-  compressor_ = compression_factory_->create_compressor(compression_options_.compression_format);
+  compressor_ = compression_factory_->create_compressor(compression_options_);
+  compression_include_topics_ = std::unordered_set<std::string>{
+    compression_options_.include_topics.begin(), compression_options_.include_topics.end()};
+  compression_exclude_topics_ = std::unordered_set<std::string>{
+    compression_options_.exclude_topics.begin(), compression_options_.exclude_topics.end()};
+}
+
+bool SequentialCompressionWriter::should_compress_topic(const std::string & topic_name) const
+{
+  if (compression_exclude_topics_.count(topic_name) != 0u) {
+    return false;
+  }
+  if (!compression_include_topics_.empty() &&
+    compression_include_topics_.count(topic_name) == 0u)
+  {
+    return false;
+  }
+  return compression_bypassed_topics_.count(topic_name) == 0u;
+}
+
+void SequentialCompressionWriter::sample_compression_ratio(
+  const std::string & topic_name, uint64_t uncompressed_bytes, uint64_t compressed_bytes)
+{
+  if (compression_options_.minimum_compression_ratio <= 0.0 ||
+    compression_include_topics_.count(topic_name) != 0u)
+  {
+    return;
+  }
+
+  auto & sample = compression_ratio_samples_[topic_name];
+  ++sample.messages;
+  sample.uncompressed_bytes += uncompressed_bytes;
+  sample.compressed_bytes += compressed_bytes;
+  if (sample.messages < COMPRESSION_RATIO_SAMPLE_COUNT || sample.compressed_bytes == 0u) {
+    return;
+  }
+
+  const auto ratio =
+    static_cast<double>(sample.uncompressed_bytes) / static_cast<double>(sample.compressed_bytes);
+  // A window with a good ratio is dropped so the topic is re-evaluated
+  // periodically; the payload character of a topic can change mid-recording.
+  compression_ratio_samples_.erase(topic_name);
+
+  if (ratio < compression_options_.minimum_compression_ratio) {
+    compression_bypassed_topics_.insert(topic_name);
+    // Pending dictionary samples are useless for a topic that will not be
+    // compressed anymore.
+    dictionary_samples_.erase(topic_name);
+    ROSBAG2_COMPRESSION_LOG_INFO_STREAM(
+      "Topic \"" << topic_name << "\" only compresses " << ratio <<
+        ":1; storing its messages uncompressed from now on.");
+  }
 }
 
 void SequentialCompressionWriter::open(
@@ -101,69 +177,203 @@ void SequentialCompressionWriter::open(
 {
   SequentialWriter::open(storage_options, converter_options);
   setup_compression();
+
+  if (compression_options_.compression_mode == rosbag2_compression::CompressionMode::FILE) {
+    start_compression_workers();
+  }
 }
 
 
 void SequentialCompressionWriter::reset()
 {
   if (!base_folder_.empty() && compressor_) {
+    if (compression_options_.compression_mode == rosbag2_compression::CompressionMode::CHUNK &&
+      storage_)
+    {
+      try {
+        flush_chunk();
+      } catch (const std::exception & e) {
+        ROSBAG2_COMPRESSION_LOG_ERROR_STREAM(
+          "Could not write the last chunk of the bag.\n" << e.what());
+      }
+    }
+    // Cached messages must reach the storage before it is closed for
+    // compression.
+    stop_cache_writer();
     // Reset may be called before initializing the compressor (ex. bad options).
-    // We compress the last file only if it hasn't been compressed earlier (ex. in split_bagfile()).
+    // We compress the last file only if it hasn't been queued earlier (ex. in split_bagfile()).
     if (compression_options_.compression_mode == rosbag2_compression::CompressionMode::FILE &&
       should_compress_last_file_)
     {
-      try {
-        storage_.reset();  // Storage must be closed before it can be compressed.
-        compress_last_file();
-      } catch (const std::runtime_error & e) {
-        ROSBAG2_COMPRESSION_LOG_WARN_STREAM("Could not compress the last bag file.\n" << e.what());
+      storage_.reset();  // Storage must be closed before it can be compressed.
+      std::string last_file;
+      {
+        std::lock_guard<std::mutex> lock{compression_queue_mutex_};
+        last_file = metadata_.relative_file_paths.back();
       }
+      enqueue_file_for_compression({last_file, file_start_time_ns_, file_end_time_ns_});
+      restart_file_time_range();
+      should_compress_last_file_ = false;
+    } else if (storage_) {
+      // Closing the bag seals the last file.
+      notify_file_sealed(
+        storage_->get_relative_file_path(), storage_->get_bagfile_size(),
+        file_start_time_ns_, file_end_time_ns_);
+      restart_file_time_range();
     }
+    // All queued files must be compressed before the metadata is finalized.
+    stop_compression_workers();
     finalize_metadata();
     metadata_io_->write_metadata(base_folder_, metadata_);
   }
 
+  stop_compression_workers();
   storage_.reset();  // Necessary to ensure that the storage is destroyed before the factory
   storage_factory_.reset();
 }
 
-void SequentialCompressionWriter::compress_last_file()
+void SequentialCompressionWriter::start_compression_workers()
 {
-  if (!compressor_) {
-    throw std::runtime_error{"compress_last_file: Compressor was not opened!"};
+  if (!compression_workers_.empty()) {
+    return;
   }
+  stop_compression_workers_ = false;
+  for (size_t i = 0; i < COMPRESSION_WORKER_COUNT; ++i) {
+    compression_workers_.emplace_back(&SequentialCompressionWriter::compression_worker_loop, this);
+  }
+}
+
+void SequentialCompressionWriter::stop_compression_workers()
+{
+  {
+    std::lock_guard<std::mutex> lock{compression_queue_mutex_};
+    stop_compression_workers_ = true;
+  }
+  compression_queue_condition_.notify_all();
+  for (auto & worker : compression_workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  compression_workers_.clear();
+}
 
-  const auto to_compress = rcpputils::fs::path{metadata_.relative_file_paths.back()};
+void SequentialCompressionWriter::compression_worker_loop()
+{
+  // Each worker owns its compressor; compressor instances are not thread safe.
+  std::shared_ptr<BaseCompressorInterface> compressor;
+  while (true) {
+    FileToCompress file_to_compress;
+    {
+      std::unique_lock<std::mutex> lock{compression_queue_mutex_};
+      compression_queue_condition_.wait(
+        lock,
+        [this] {return !compression_queue_.empty() || stop_compression_workers_;});
+      if (compression_queue_.empty()) {
+        break;  // Stop was requested and all pending files are compressed.
+      }
+      file_to_compress = compression_queue_.front();
+      compression_queue_.pop_front();
+    }
+
+    try {
+      if (!compressor) {
+        compressor = compression_factory_->create_compressor(compression_options_);
+      }
+      if (!compressor) {
+        throw std::runtime_error{"Could not create a compressor for a compression worker!"};
+      }
+      compress_file(*compressor, file_to_compress);
+    } catch (const std::exception & e) {
+      ROSBAG2_COMPRESSION_LOG_ERROR_STREAM(
+        "Could not compress bag file \"" << file_to_compress.relative_path << "\".\n" << e.what());
+    }
+  }
+}
+
+void SequentialCompressionWriter::enqueue_file_for_compression(
+  const FileToCompress & file_to_compress)
+{
+  {
+    std::lock_guard<std::mutex> lock{compression_queue_mutex_};
+    compression_queue_.push_back(file_to_compress);
+  }
+  compression_queue_condition_.notify_one();
+}
+
+void SequentialCompressionWriter::compress_file(
+  BaseCompressorInterface & compressor,
+  const FileToCompress & file_to_compress)
+{
+  const auto to_compress = rcpputils::fs::path{file_to_compress.relative_path};
 
   if (to_compress.exists() && to_compress.file_size() > 0u) {
-    const auto compressed_uri = compressor_->compress_uri(to_compress.string());
+    const auto compressed_uri = compressor.compress_uri(to_compress.string());
 
-    metadata_.relative_file_paths.back() = compressed_uri;
+    {
+      std::lock_guard<std::mutex> lock{compression_queue_mutex_};
+      std::replace(
+        metadata_.relative_file_paths.begin(), metadata_.relative_file_paths.end(),
+        file_to_compress.relative_path, compressed_uri);
+    }
 
     if (!rcpputils::fs::remove(to_compress)) {
       ROSBAG2_COMPRESSION_LOG_ERROR_STREAM(
         "Failed to remove uncompressed bag: \"" << to_compress.string() << "\"");
     }
+
+    // The compressed file is the artifact which will not change anymore.
+    notify_file_sealed(
+      compressed_uri, rcpputils::fs::path{compressed_uri}.file_size(),
+      file_to_compress.starting_time_ns, file_to_compress.ending_time_ns);
   } else {
     ROSBAG2_COMPRESSION_LOG_DEBUG_STREAM(
-      "Removing last file: \"" << to_compress.string() <<
+      "Removing file: \"" << to_compress.string() <<
         "\" because it either is empty or does not exist.");
 
-    metadata_.relative_file_paths.pop_back();
+    std::lock_guard<std::mutex> lock{compression_queue_mutex_};
+    metadata_.relative_file_paths.erase(
+      std::remove(
+        metadata_.relative_file_paths.begin(), metadata_.relative_file_paths.end(),
+        file_relative_to_bag),
+      metadata_.relative_file_paths.end());
   }
 }
 
+void SequentialCompressionWriter::rotate_bag(const std::string & new_base_folder)
+{
+  (void) new_base_folder;
+  throw std::runtime_error("Bag rotation is not supported for compressed recordings.");
+}
+
 void SequentialCompressionWriter::split_bagfile()
 {
+  if (!storage_) {
+    throw std::runtime_error("Bag is not open. Call open() before splitting.");
+  }
+
   const auto storage_uri = format_storage_uri(
     base_folder_,
     metadata_.relative_file_paths.size());
 
+  std::string closed_file;
+  {
+    std::lock_guard<std::mutex> lock{compression_queue_mutex_};
+    closed_file = metadata_.relative_file_paths.back();
+  }
+  const auto closed_file_size = storage_->get_bagfile_size();
+
+  // Assigning the new storage closes the previous file, which may then be
+  // compressed in the background while recording continues.
   storage_ = storage_factory_->open_read_write(storage_uri, metadata_.storage_identifier);
 
   if (compression_options_.compression_mode == rosbag2_compression::CompressionMode::FILE) {
-    compress_last_file();
+    // The sealed-file notification fires once the compressed file exists.
+    enqueue_file_for_compression({closed_file, file_start_time_ns_, file_end_time_ns_});
+  } else {
+    notify_file_sealed(closed_file, closed_file_size, file_start_time_ns_, file_end_time_ns_);
   }
+  restart_file_time_range();
 
   if (!storage_) {
     // Add a check to make sure reset() does not compress the file again if we couldn't load the
@@ -175,7 +385,10 @@ void SequentialCompressionWriter::split_bagfile()
     throw std::runtime_error{errmsg.str()};
   }
 
-  metadata_.relative_file_paths.push_back(storage_->get_relative_file_path());
+  {
+    std::lock_guard<std::mutex> lock{compression_queue_mutex_};
+    metadata_.relative_file_paths.push_back(storage_->get_relative_file_path());
+  }
 
   // Re-register all topics since we rolled-over to a new bagfile.
   for (const auto & topic : topics_names_to_info_) {
@@ -190,15 +403,131 @@ void SequentialCompressionWriter::compress_message(
     throw std::runtime_error{"Cannot compress message; Writer is not open!"};
   }
 
+  collect_dictionary_sample(*message);
+  const auto uncompressed_bytes = message->serialized_data->buffer_length;
   compressor_->compress_serialized_bag_message(message.get());
+  sample_compression_ratio(
+    message->topic_name, uncompressed_bytes, message->serialized_data->buffer_length);
+}
+
+void SequentialCompressionWriter::collect_dictionary_sample(
+  const rosbag2_storage::SerializedBagMessage & message)
+{
+  const auto & topic_name = message.topic_name;
+  if (dictionary_trained_topics_.count(topic_name) != 0u) {
+    return;
+  }
+
+  auto & samples = dictionary_samples_[topic_name];
+  samples.emplace_back(
+    message.serialized_data->buffer,
+    message.serialized_data->buffer + message.serialized_data->buffer_length);
+  if (samples.size() < DICTIONARY_SAMPLE_COUNT) {
+    return;
+  }
+
+  // Train once per topic; whether it succeeds or not, the samples are dropped.
+  const auto dictionary = compressor_->train_dictionary(samples);
+  dictionary_trained_topics_.insert(topic_name);
+  dictionary_samples_.erase(topic_name);
+  if (dictionary.empty()) {
+    // Dictionaries are unsupported by the compressor or training failed;
+    // messages of this topic keep compressing without one.
+    return;
+  }
+
+  // The dictionary is stored alongside the bag so the reader can pick it up;
+  // compressed frames reference their dictionary in the frame header.
+  const auto dictionary_uri =
+    (rcpputils::fs::path{base_folder_} /
+    ("compression_dictionary_" + std::to_string(dictionary_count_++) + ".dict")).string();
+  write_output_buffer(dictionary, dictionary_uri);
+  compressor_->set_dictionary(topic_name, dictionary);
+  ROSBAG2_COMPRESSION_LOG_INFO_STREAM(
+    "Trained compression dictionary for topic \"" << topic_name << "\".");
+}
+
+void SequentialCompressionWriter::write(
+  std::shared_ptr<rosbag2_storage::SerializedBagMessage> message)
+{
+  if (compression_options_.compression_mode != rosbag2_compression::CompressionMode::CHUNK) {
+    SequentialWriter::write(message);
+    return;
+  }
+
+  if (!storage_) {
+    throw std::runtime_error("Bag is not open. Call open() before writing.");
+  }
+
+  if (topics_names_to_info_.find(message->topic_name) == topics_names_to_info_.end()) {
+    std::stringstream errmsg;
+    errmsg << "Failed to write on topic '" << message->topic_name <<
+      "'. Call create_topic() before first write.";
+    throw std::runtime_error(errmsg.str());
+  }
+
+  // Update the message count for the Topic. The chunk row carrying the
+  // message is counted separately, under the chunk pseudo topic.
+  auto & topic_info = topics_names_to_info_.at(message->topic_name);
+  ++topic_info.message_count;
+  record_message_size(topic_info, *message);
+
+  auto converted_msg = SequentialWriter::get_writeable_message(message);
+  chunk_buffer_.push_back(converted_msg);
+  chunk_buffer_size_ += converted_msg->serialized_data->buffer_length;
+  if (chunk_buffer_size_ >= CHUNK_SIZE_THRESHOLD) {
+    flush_chunk();
+  }
+}
+
+void SequentialCompressionWriter::flush_chunk()
+{
+  if (chunk_buffer_.empty()) {
+    return;
+  }
+
+  if (!chunk_topic_created_) {
+    // The pseudo topic reuses the serialization format of the recorded topics
+    // so that the format checks on the reading side pass; its rows are
+    // unpacked by the reader and never reach a subscription.
+    create_topic(
+      {kChunkTopicName, kChunkTopicType,
+        topics_names_to_info_.begin()->second.topic_metadata.serialization_format, ""});
+    chunk_topic_created_ = true;
+  }
+
+  const auto packed_chunk = serialize_chunk(chunk_buffer_);
+  auto chunk_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  chunk_message->topic_name = kChunkTopicName;
+  // The chunk row is stamped with its first message so that time-based seeks
+  // land on the chunk containing the requested timestamp.
+  chunk_message->time_stamp = chunk_buffer_.front()->time_stamp;
+  chunk_message->serialized_data =
+    rosbag2_storage::make_serialized_message(packed_chunk.data(), packed_chunk.size());
+  compressor_->compress_serialized_bag_message(chunk_message.get());
+
+  chunk_buffer_.clear();
+  chunk_buffer_size_ = 0;
+
+  // The base writer takes care of caching, splitting and metadata updates.
+  // Since individual messages never reach it in CHUNK mode, bagfile splits
+  // always happen at chunk boundaries.
+  SequentialWriter::write(chunk_message);
 }
 
 std::shared_ptr<rosbag2_storage::SerializedBagMessage>
 SequentialCompressionWriter::get_writeable_message(
   std::shared_ptr<rosbag2_storage::SerializedBagMessage> message)
 {
+  if (message->topic_name == kChunkTopicName) {
+    // Chunk rows were already packed and compressed by flush_chunk();
+    // converting or compressing them again would corrupt the frame.
+    return message;
+  }
   auto writeable_msg = SequentialWriter::get_writeable_message(message);
-  if (compression_options_.compression_mode == rosbag2_compression::CompressionMode::MESSAGE) {
+  if (compression_options_.compression_mode == rosbag2_compression::CompressionMode::MESSAGE &&
+    should_compress_topic(writeable_msg->topic_name))
+  {
     compress_message(writeable_msg);
   }
   return writeable_msg;
@@ -0,0 +1,190 @@
+// Copyright 2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rosbag2_compression/zstd_compressor.hpp"
+#include "rosbag2_compression/zstd_decompressor.hpp"
+#include "rosbag2_storage/ros_helper.hpp"
+#include "rosbag2_storage/serialized_bag_message.hpp"
+
+// Round-trip benchmark of ZstdCompressor/ZstdDecompressor across message and
+// file mode, payload sizes and compression levels, reporting MB/s and
+// per-message latency in both directions. Serves as the regression baseline
+// for context-reuse and streaming changes; all cases run single threaded so
+// numbers stay comparable across machines.
+
+namespace
+{
+
+constexpr const size_t kDefaultIterations = 2000;
+constexpr const size_t kFileSize = 64 * 1024 * 1024;
+constexpr const size_t kFileIterations = 3;
+
+// Pseudo-random bytes over a small alphabet with runs, roughly as
+// compressible as packed sensor payloads; pure noise or pure zeros would
+// make the numbers meaningless.
+std::vector<uint8_t> make_payload(size_t size)
+{
+  std::vector<uint8_t> payload(size);
+  uint32_t state = 0x12345678u;
+  for (size_t i = 0; i < size; ++i) {
+    state = state * 1664525u + 1013904223u;
+    payload[i] = static_cast<uint8_t>((state >> 24) & 0x0F) + static_cast<uint8_t>(i / 64);
+  }
+  return payload;
+}
+
+double megabytes_per_second(size_t bytes, std::chrono::nanoseconds elapsed)
+{
+  return static_cast<double>(bytes) / (1024.0 * 1024.0) /
+         (static_cast<double>(elapsed.count()) * 1e-9);
+}
+
+void run_message_mode(int compression_level, size_t payload_size, size_t iterations)
+{
+  rosbag2_compression::ZstdCompressor compressor{compression_level, 0};
+  rosbag2_compression::ZstdDecompressor decompressor;
+
+  const auto payload = make_payload(payload_size);
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = "benchmark_topic";
+  message->serialized_data =
+    rosbag2_storage::make_serialized_message(payload.data(), payload.size());
+
+  std::chrono::nanoseconds compress_time{0};
+  std::chrono::nanoseconds decompress_time{0};
+  size_t compressed_size = 0;
+
+  for (size_t i = 0; i < iterations; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    compressor.compress_serialized_bag_message(message.get());
+    compress_time += std::chrono::steady_clock::now() - start;
+    compressed_size = message->serialized_data->buffer_length;
+
+    start = std::chrono::steady_clock::now();
+    decompressor.decompress_serialized_bag_message(message.get());
+    decompress_time += std::chrono::steady_clock::now() - start;
+  }
+
+  const auto total_bytes = payload_size * iterations;
+  std::cout << std::right << std::fixed <<
+    std::setw(6) << compression_level <<
+    std::setw(12) << payload_size <<
+    std::setprecision(1) <<
+    std::setw(12) << megabytes_per_second(total_bytes, compress_time) <<
+    std::setw(14) << static_cast<double>(compress_time.count()) / iterations / 1000.0 <<
+    std::setw(12) << megabytes_per_second(total_bytes, decompress_time) <<
+    std::setw(14) << static_cast<double>(decompress_time.count()) / iterations / 1000.0 <<
+    std::setprecision(2) <<
+    std::setw(8) << static_cast<double>(payload_size) / compressed_size << std::endl;
+}
+
+void run_file_mode(int compression_level)
+{
+  const std::string uri = "zstd_benchmark_file.bin";
+  const auto payload = make_payload(kFileSize);
+
+  std::chrono::nanoseconds compress_time{0};
+  std::chrono::nanoseconds decompress_time{0};
+  size_t compressed_size = 0;
+
+  for (size_t i = 0; i < kFileIterations; ++i) {
+    {
+      std::ofstream file{uri, std::ios::binary};
+      file.write(reinterpret_cast<const char *>(payload.data()), payload.size());
+    }
+
+    rosbag2_compression::ZstdCompressor compressor{compression_level, 0};
+    auto start = std::chrono::steady_clock::now();
+    const auto compressed_uri = compressor.compress_uri(uri);
+    compress_time += std::chrono::steady_clock::now() - start;
+
+    {
+      std::ifstream file{compressed_uri, std::ios::binary | std::ios::ate};
+      compressed_size = static_cast<size_t>(file.tellg());
+    }
+
+    // The decompressor restores the original path, so clear it first.
+    std::remove(uri.c_str());
+    rosbag2_compression::ZstdDecompressor decompressor;
+    start = std::chrono::steady_clock::now();
+    decompressor.decompress_uri(compressed_uri);
+    decompress_time += std::chrono::steady_clock::now() - start;
+
+    std::remove(compressed_uri.c_str());
+    std::remove(uri.c_str());
+  }
+
+  const auto total_bytes = kFileSize * kFileIterations;
+  std::cout << std::right << std::fixed <<
+    std::setw(6) << compression_level <<
+    std::setprecision(1) <<
+    std::setw(12) << megabytes_per_second(total_bytes, compress_time) <<
+    std::setw(14) << megabytes_per_second(total_bytes, decompress_time) <<
+    std::setprecision(2) <<
+    std::setw(8) << static_cast<double>(kFileSize) / compressed_size << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t iterations = kDefaultIterations;
+  if (argc > 1) {
+    iterations = std::stoul(argv[1]);
+  }
+
+  const std::vector<int> levels = {1, 3, 9};
+  const std::vector<size_t> payload_sizes = {1024, 64 * 1024, 1024 * 1024};
+
+  std::cout << "zstd message mode, " << iterations <<
+    " round trips per case, single threaded" << std::endl;
+  std::cout << std::right <<
+    std::setw(6) << "level" <<
+    std::setw(12) << "payload_B" <<
+    std::setw(12) << "comp_MB/s" <<
+    std::setw(14) << "comp_us/msg" <<
+    std::setw(12) << "dec_MB/s" <<
+    std::setw(14) << "dec_us/msg" <<
+    std::setw(8) << "ratio" << std::endl;
+  for (const auto level : levels) {
+    for (const auto payload_size : payload_sizes) {
+      // Scale iterations down for the large payloads to keep runtime sane.
+      const auto scaled_iterations =
+        payload_size >= 1024 * 1024 ? (iterations + 9) / 10 : iterations;
+      run_message_mode(level, payload_size, scaled_iterations);
+    }
+  }
+
+  std::cout << std::endl << "zstd file mode, " << kFileSize / (1024 * 1024) <<
+    " MiB per file, " << kFileIterations << " round trips per level" << std::endl;
+  std::cout << std::right <<
+    std::setw(6) << "level" <<
+    std::setw(12) << "comp_MB/s" <<
+    std::setw(14) << "dec_MB/s" <<
+    std::setw(8) << "ratio" << std::endl;
+  for (const auto level : levels) {
+    run_file_mode(level);
+  }
+
+  return 0;
+}
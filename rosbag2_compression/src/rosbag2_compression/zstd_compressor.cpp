@@ -17,40 +17,200 @@
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include <zdict.h>
+
 #include "rcpputils/filesystem_helper.hpp"
 
 #include "compression_utils.hpp"
 #include "rosbag2_compression/zstd_compressor.hpp"
 
+namespace
+{
+// Capacity handed to ZDICT_trainFromBuffer; small-message dictionaries rarely
+// need more, and every decompressing process keeps each dictionary in memory.
+constexpr const size_t kZstdDictionaryCapacity = 16 * 1024;
+
+// Uncompressed bytes per independent frame of a seekable archive. Large
+// enough that the per-frame header overhead and the compression ratio loss
+// from restarting the entropy tables stay negligible, small enough that
+// extracting a byte range decompresses little beyond the range itself.
+constexpr const size_t kSeekableFrameContentSize = 4 * 1024 * 1024;
+
+// Magic numbers of the zstd seekable format. The seek table travels in a
+// skippable frame (first magic) which every standard zstd decoder ignores;
+// the seekable magic in its last four bytes marks the frame as a seek table.
+constexpr const uint32_t kZstdSkippableFrameMagic = 0x184D2A5E;
+constexpr const uint32_t kZstdSeekableMagic = 0x8F92EAB1;
+
+void append_le32(std::vector<uint8_t> & buffer, uint32_t value)
+{
+  buffer.push_back(static_cast<uint8_t>(value & 0xFFu));
+  buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFFu));
+  buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xFFu));
+  buffer.push_back(static_cast<uint8_t>((value >> 24) & 0xFFu));
+}
+
+int default_nb_workers()
+{
+  // Leave half of the cores to recording; hardware_concurrency may be 0 if
+  // it cannot be determined.
+  return static_cast<int>(std::max(1u, std::thread::hardware_concurrency() / 2));
+}
+}  // namespace
+
 namespace rosbag2_compression
 {
 
+ZstdCompressor::ZstdCompressor(
+  int compression_level, int nb_workers,
+  bool long_distance_matching, int window_log, bool frame_checksum)
+: compression_level_{compression_level},
+  nb_workers_{nb_workers < 0 ? default_nb_workers() : nb_workers},
+  seekable_frame_content_size_{kSeekableFrameContentSize},
+  context_{ZSTD_createCCtx(), &ZSTD_freeCCtx}
+{
+  if (!context_) {
+    throw std::runtime_error{"Unable to create Zstd compression context!"};
+  }
+  throw_on_zstd_error(
+    ZSTD_CCtx_setParameter(context_.get(), ZSTD_c_compressionLevel, compression_level));
+  throw_on_zstd_error(
+    ZSTD_CCtx_setParameter(context_.get(), ZSTD_c_checksumFlag, frame_checksum ? 1 : 0));
+  if (long_distance_matching) {
+    throw_on_zstd_error(
+      ZSTD_CCtx_setParameter(context_.get(), ZSTD_c_enableLongDistanceMatching, 1));
+    if (window_log > 0) {
+      throw_on_zstd_error(
+        ZSTD_CCtx_setParameter(context_.get(), ZSTD_c_windowLog, window_log));
+      // The frames of a seekable archive are compressed independently, so a
+      // match window larger than a frame would go unused; grow the frames to
+      // the window instead, trading range-extraction granularity for matches
+      // spanning more content.
+      seekable_frame_content_size_ =
+        std::max(seekable_frame_content_size_, static_cast<size_t>(1) << window_log);
+    }
+  }
+}
+
 std::string ZstdCompressor::compress_uri(const std::string & uri)
 {
   const auto start = std::chrono::high_resolution_clock::now();
   const auto compressed_uri = uri + "." + get_compression_identifier();
-  const auto decompressed_buffer = get_input_buffer(uri);
 
-  // Allocate based on compression bound and compress
-  const auto compressed_buffer_length = ZSTD_compressBound(decompressed_buffer.size());
-  std::vector<uint8_t> compressed_buffer(compressed_buffer_length);
+  // Reuse the long-lived context; resetting only the session keeps the
+  // compression parameters configured at construction.
+  throw_on_zstd_error(ZSTD_CCtx_reset(context_.get(), ZSTD_reset_session_only));
 
-  // Perform compression and check.
-  // compression_result is either the actual compressed size or an error code.
-  const auto compression_result = ZSTD_compress(
-    compressed_buffer.data(), compressed_buffer.size(),
-    decompressed_buffer.data(), decompressed_buffer.size(), kDefaultZstdCompressionLevel);
-  throw_on_zstd_error(compression_result);
+  // Multithreading requires a zstd built with ZSTD_MULTITHREAD; fall back to
+  // compressing on the calling thread when the parameter is rejected.
+  const auto nb_workers_result =
+    ZSTD_CCtx_setParameter(context_.get(), ZSTD_c_nbWorkers, nb_workers_);
+  if (ZSTD_isError(nb_workers_result)) {
+    ROSBAG2_COMPRESSION_LOG_WARN_STREAM(
+      "Zstd multithreading is unavailable; compressing \"" << uri << "\" on a single thread.");
+  }
 
-  // Compression_buffer_length might be larger than the actual compression size
-  // Resize compressed_buffer so its size is the actual compression size.
-  compressed_buffer.resize(compression_result);
-  write_output_buffer(compressed_buffer, compressed_uri);
+  const auto uri_path = rcpputils::fs::path{uri};
+  const auto uncompressed_size = uri_path.exists() ? uri_path.file_size() : 0u;
+
+  // The archive is written in the zstd seekable format: independent frames
+  // of seekable_frame_content_size_ uncompressed bytes each, with a seek table
+  // appended as a skippable frame. Standard zstd decoders still decompress
+  // the whole file (skippable frames are ignored), while a seekable-aware
+  // reader can map a byte range onto the frames covering it and decompress
+  // only those instead of the entire split.
+  auto input_file = open_file_or_throw(uri, "rb");
+  auto output_file = open_file_or_throw(compressed_uri, "wb");
+
+  std::vector<uint8_t> input_chunk(seekable_frame_content_size_);
+  std::vector<uint8_t> output_chunk(ZSTD_CStreamOutSize());
+  // Per-frame (compressed, decompressed) sizes in archive order.
+  std::vector<std::pair<uint32_t, uint32_t>> frame_sizes;
+  size_t compressed_size{0};
+
+  try {
+    bool last_chunk{false};
+    do {
+      const auto read_count = fread(input_chunk.data(), 1, input_chunk.size(), input_file.get());
+      if (ferror(input_file.get())) {
+        std::stringstream errmsg;
+        errmsg << "Unable to read binary data from file: \"" << uri << "\"!";
+
+        throw std::runtime_error{errmsg.str()};
+      }
+      last_chunk = read_count < input_chunk.size();
+      if (read_count == 0u && !frame_sizes.empty()) {
+        // The file ends exactly on a frame boundary.
+        break;
+      }
+
+      // Each chunk becomes one independent frame; resetting the session
+      // between frames keeps the configured compression parameters. The
+      // pledged size records the frame content size in the frame header.
+      throw_on_zstd_error(ZSTD_CCtx_reset(context_.get(), ZSTD_reset_session_only));
+      throw_on_zstd_error(ZSTD_CCtx_setPledgedSrcSize(context_.get(), read_count));
+
+      size_t frame_compressed_size{0};
+      ZSTD_inBuffer input{input_chunk.data(), read_count, 0};
+      size_t remaining{0};
+      do {
+        ZSTD_outBuffer output{output_chunk.data(), output_chunk.size(), 0};
+        remaining = ZSTD_compressStream2(context_.get(), &output, &input, ZSTD_e_end);
+        throw_on_zstd_error(remaining);
+
+        if (output.pos > 0u) {
+          const auto write_count = fwrite(output_chunk.data(), 1, output.pos, output_file.get());
+          if (write_count != output.pos) {
+            std::stringstream errmsg;
+            errmsg << "Unable to write data to file: \"" << compressed_uri << "\"!";
+
+            throw std::runtime_error{errmsg.str()};
+          }
+          frame_compressed_size += output.pos;
+        }
+      } while (remaining != 0u);
+
+      compressed_size += frame_compressed_size;
+      frame_sizes.emplace_back(
+        static_cast<uint32_t>(frame_compressed_size), static_cast<uint32_t>(read_count));
+    } while (!last_chunk);
+
+    // Seek table: skippable frame header, one size pair per frame, then the
+    // seekable-format footer (frame count, descriptor, seekable magic).
+    std::vector<uint8_t> seek_table;
+    seek_table.reserve(8u + frame_sizes.size() * 8u + 9u);
+    append_le32(seek_table, kZstdSkippableFrameMagic);
+    append_le32(seek_table, static_cast<uint32_t>(frame_sizes.size() * 8u + 9u));
+    for (const auto & sizes : frame_sizes) {
+      append_le32(seek_table, sizes.first);
+      append_le32(seek_table, sizes.second);
+    }
+    append_le32(seek_table, static_cast<uint32_t>(frame_sizes.size()));
+    seek_table.push_back(0u);  // Descriptor: no per-frame checksums.
+    append_le32(seek_table, kZstdSeekableMagic);
+
+    const auto write_count =
+      fwrite(seek_table.data(), 1, seek_table.size(), output_file.get());
+    if (write_count != seek_table.size()) {
+      std::stringstream errmsg;
+      errmsg << "Unable to write data to file: \"" << compressed_uri << "\"!";
+
+      throw std::runtime_error{errmsg.str()};
+    }
+    compressed_size += seek_table.size();
+  } catch (...) {
+    // Do not leave a partially written compressed file behind.
+    output_file.reset();
+    rcpputils::fs::remove(rcpputils::fs::path{compressed_uri});
+    throw;
+  }
 
   const auto end = std::chrono::high_resolution_clock::now();
-  print_compression_statistics(start, end, decompressed_buffer.size(), compression_result);
+  print_compression_statistics(start, end, uncompressed_size, compressed_size);
   return compressed_uri;
 }
 
@@ -63,12 +223,27 @@ void ZstdCompressor::compress_serialized_bag_message(
     ZSTD_compressBound(message->serialized_data->buffer_length);
   std::vector<uint8_t> compressed_buffer(uncompressed_buffer_length);
 
+  // Reuse the long-lived context; resetting only the session keeps the
+  // compression parameters configured at construction.
+  throw_on_zstd_error(ZSTD_CCtx_reset(context_.get(), ZSTD_reset_session_only));
+  // Worker threads only pay off for large inputs; individual messages are
+  // compressed on the calling thread.
+  throw_on_zstd_error(ZSTD_CCtx_setParameter(context_.get(), ZSTD_c_nbWorkers, 0));
+
   // Perform compression and check.
   // compression_result is either the actual compressed size or an error code.
-  const auto compression_result = ZSTD_compress(
+  // Messages of topics with a trained dictionary are compressed with it.
+  const auto dictionary = dictionaries_.find(message->topic_name);
+  const auto compression_result = dictionary != dictionaries_.end() ?
+    ZSTD_compress_usingCDict(
+    context_.get(),
     compressed_buffer.data(), compressed_buffer.size(),
     message->serialized_data->buffer, message->serialized_data->buffer_length,
-    kDefaultZstdCompressionLevel);
+    dictionary->second.get()) :
+    ZSTD_compress2(
+    context_.get(),
+    compressed_buffer.data(), compressed_buffer.size(),
+    message->serialized_data->buffer, message->serialized_data->buffer_length);
   throw_on_zstd_error(compression_result);
 
   // Compression_buffer_length might be larger than the actual compression size
@@ -88,6 +263,49 @@ void ZstdCompressor::compress_serialized_bag_message(
   print_compression_statistics(start, end, uncompressed_buffer_length, compression_result);
 }
 
+std::vector<uint8_t> ZstdCompressor::train_dictionary(
+  const std::vector<std::vector<uint8_t>> & samples)
+{
+  std::vector<uint8_t> samples_buffer;
+  std::vector<size_t> sample_sizes;
+  sample_sizes.reserve(samples.size());
+  for (const auto & sample : samples) {
+    samples_buffer.insert(samples_buffer.end(), sample.begin(), sample.end());
+    sample_sizes.push_back(sample.size());
+  }
+
+  std::vector<uint8_t> dictionary(kZstdDictionaryCapacity);
+  const auto training_result = ZDICT_trainFromBuffer(
+    dictionary.data(), dictionary.size(),
+    samples_buffer.data(), sample_sizes.data(), static_cast<unsigned>(sample_sizes.size()));
+
+  // Training fails for too few or too uniform samples; that is not an error,
+  // the affected topic just keeps compressing without a dictionary.
+  if (ZDICT_isError(training_result)) {
+    ROSBAG2_COMPRESSION_LOG_WARN_STREAM(
+      "Zstd dictionary training failed: " << ZDICT_getErrorName(training_result) <<
+        "; continuing without a dictionary.");
+    return {};
+  }
+
+  dictionary.resize(training_result);
+  return dictionary;
+}
+
+void ZstdCompressor::set_dictionary(
+  const std::string & topic_name,
+  const std::vector<uint8_t> & dictionary)
+{
+  std::unique_ptr<ZSTD_CDict, decltype(&ZSTD_freeCDict)> digested_dictionary{
+    ZSTD_createCDict(dictionary.data(), dictionary.size(), compression_level_),
+    &ZSTD_freeCDict};
+  if (!digested_dictionary) {
+    throw std::runtime_error{"Unable to create Zstd compression dictionary!"};
+  }
+  dictionaries_.erase(topic_name);
+  dictionaries_.emplace(topic_name, std::move(digested_dictionary));
+}
+
 std::string ZstdCompressor::get_compression_identifier() const
 {
   return kCompressionIdentifier;
@@ -15,10 +15,13 @@
 #include <algorithm>
 #include <chrono>
 #include <cstdio>
+#include <iterator>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include <zdict.h>
+
 #include "rcpputils/filesystem_helper.hpp"
 
 #include "compression_utils.hpp"
@@ -27,35 +30,293 @@
 namespace rosbag2_compression
 {
 
+namespace
+{
+// First four bytes of every zstd frame, in little-endian byte order.
+// Payloads that do not start with the magic number were stored uncompressed
+// by the writer's per-topic compression bypass and are passed through.
+constexpr const uint8_t ZSTD_FRAME_MAGIC[] = {0x28, 0xB5, 0x2F, 0xFD};
+
+bool is_zstd_frame(const rcutils_uint8_array_t & serialized_data)
+{
+  return serialized_data.buffer_length >= sizeof(ZSTD_FRAME_MAGIC) &&
+         std::equal(
+    std::begin(ZSTD_FRAME_MAGIC), std::end(ZSTD_FRAME_MAGIC), serialized_data.buffer);
+}
+
+// Magic numbers of the zstd seekable format, as written by ZstdCompressor:
+// the seek table is a skippable frame whose payload ends with the seekable
+// magic, appended after the independent data frames.
+constexpr const uint32_t kZstdSkippableFrameMagic = 0x184D2A5E;
+constexpr const uint32_t kZstdSeekableMagic = 0x8F92EAB1;
+
+uint32_t read_le32(const uint8_t * bytes)
+{
+  return static_cast<uint32_t>(bytes[0]) |
+         (static_cast<uint32_t>(bytes[1]) << 8) |
+         (static_cast<uint32_t>(bytes[2]) << 16) |
+         (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+void seek_or_throw(FILE * file, uint64_t position, const std::string & uri)
+{
+#ifdef _WIN32
+  const auto result = _fseeki64(file, static_cast<int64_t>(position), SEEK_SET);
+#else
+  const auto result = fseeko(file, static_cast<off_t>(position), SEEK_SET);
+#endif
+  if (result != 0) {
+    std::stringstream errmsg;
+    errmsg << "Unable to seek in file: \"" << uri << "\"!";
+
+    throw std::runtime_error{errmsg.str()};
+  }
+}
+}  // namespace
+
+ZstdDecompressor::ZstdDecompressor()
+: context_{ZSTD_createDCtx(), &ZSTD_freeDCtx}
+{
+  if (!context_) {
+    throw std::runtime_error{"Unable to create Zstd decompression context!"};
+  }
+  // The compressor may enable long-distance matching with a window above the
+  // decoder's conservative default limit; accept any window up to 1 GiB
+  // rather than rejecting such frames.
+  throw_on_zstd_error(ZSTD_DCtx_setParameter(context_.get(), ZSTD_d_windowLogMax, 30));
+}
+
 std::string ZstdDecompressor::decompress_uri(const std::string & uri)
+{
+  return decompress_uri(uri, "");
+}
+
+std::string ZstdDecompressor::decompress_uri(
+  const std::string & uri, const std::string & destination_directory)
 {
   const auto start = std::chrono::high_resolution_clock::now();
   const auto uri_path = rcpputils::fs::path{uri};
-  const auto decompressed_uri = rcpputils::fs::remove_extension(uri_path).string();
-  const auto compressed_buffer = get_input_buffer(uri);
-  const auto compressed_buffer_length = compressed_buffer.size();
+  const auto stripped_path = rcpputils::fs::remove_extension(uri_path);
+  const auto decompressed_uri = destination_directory.empty() ?
+    stripped_path.string() :
+    (rcpputils::fs::path{destination_directory} / stripped_path.filename().string()).string();
+  const auto compressed_size = uri_path.exists() ? uri_path.file_size() : 0u;
 
-  const auto decompressed_buffer_length =
-    ZSTD_getFrameContentSize(compressed_buffer.data(), compressed_buffer_length);
+  // Reuse the long-lived context across calls; only the session is reset.
+  throw_on_zstd_error(ZSTD_DCtx_reset(context_.get(), ZSTD_reset_session_only));
 
-  throw_on_invalid_frame_content(decompressed_buffer_length);
+  // Stream the file through fixed-size chunks instead of buffering both the
+  // compressed and the decompressed content, so opening a large compressed
+  // split needs constant memory regardless of its size.
+  auto input_file = open_file_or_throw(uri, "rb");
+  auto output_file = open_file_or_throw(decompressed_uri, "wb");
 
-  // Initializes decompressed_buffer with size = decompressed_buffer_length.
-  // Uniform initialization cannot be used here since it will choose
-  // the initializer list constructor instead.
-  std::vector<uint8_t> decompressed_buffer(decompressed_buffer_length);
+  std::vector<uint8_t> input_chunk(ZSTD_DStreamInSize());
+  std::vector<uint8_t> output_chunk(ZSTD_DStreamOutSize());
+  size_t compressed_read{0};
+  size_t decompressed_size{0};
+  size_t next_progress_percent{25};
+  size_t last_result{0};
 
-  const auto decompression_result = ZSTD_decompress(
-    decompressed_buffer.data(), decompressed_buffer_length,
-    compressed_buffer.data(), compressed_buffer_length);
+  try {
+    bool last_chunk{false};
+    do {
+      const auto read_count = fread(input_chunk.data(), 1, input_chunk.size(), input_file.get());
+      if (ferror(input_file.get())) {
+        std::stringstream errmsg;
+        errmsg << "Unable to read binary data from file: \"" << uri << "\"!";
 
-  throw_on_zstd_error(decompression_result);
-  decompressed_buffer.resize(decompression_result);
+        throw std::runtime_error{errmsg.str()};
+      }
+      last_chunk = read_count < input_chunk.size();
+
+      ZSTD_inBuffer input{input_chunk.data(), read_count, 0};
+      while (input.pos < input.size) {
+        ZSTD_outBuffer output{output_chunk.data(), output_chunk.size(), 0};
+        last_result = ZSTD_decompressStream(context_.get(), &output, &input);
+        throw_on_zstd_error(last_result);
+
+        if (output.pos > 0u) {
+          const auto write_count =
+            fwrite(output_chunk.data(), 1, output.pos, output_file.get());
+          if (write_count != output.pos) {
+            std::stringstream errmsg;
+            errmsg << "Unable to write data to file: \"" << decompressed_uri << "\"!";
 
-  write_output_buffer(decompressed_buffer, decompressed_uri);
+            throw std::runtime_error{errmsg.str()};
+          }
+          decompressed_size += output.pos;
+        }
+      }
+
+      compressed_read += read_count;
+      if (compressed_size > 0u) {
+        const auto progress_percent = 100u * compressed_read / compressed_size;
+        while (progress_percent >= next_progress_percent && next_progress_percent < 100u) {
+          ROSBAG2_COMPRESSION_LOG_DEBUG_STREAM(
+            "Decompressing \"" << uri << "\": " << next_progress_percent << "%");
+          next_progress_percent += 25u;
+        }
+      }
+    } while (!last_chunk);
+
+    if (last_result != 0u) {
+      std::stringstream errmsg;
+      errmsg << "Compressed file: \"" << uri << "\" is truncated!";
+
+      throw std::runtime_error{errmsg.str()};
+    }
+  } catch (...) {
+    // Do not leave a partially written decompressed file behind.
+    output_file.reset();
+    rcpputils::fs::remove(rcpputils::fs::path{decompressed_uri});
+    throw;
+  }
 
   const auto end = std::chrono::high_resolution_clock::now();
-  print_compression_statistics(start, end, decompression_result, compressed_buffer_length);
+  print_compression_statistics(start, end, decompressed_size, compressed_read);
+
+  return decompressed_uri;
+}
+
+std::string ZstdDecompressor::decompress_uri_range(
+  const std::string & uri, size_t offset, size_t size,
+  const std::string & destination_directory)
+{
+  const auto start = std::chrono::high_resolution_clock::now();
+  const auto uri_path = rcpputils::fs::path{uri};
+  const auto stripped_path = rcpputils::fs::remove_extension(uri_path);
+  // The range bounds go into the file name so extracted ranges neither clash
+  // with each other nor with a whole-file decompression of the same split.
+  std::stringstream range_suffix;
+  range_suffix << "." << offset << "_" << size;
+  const auto decompressed_uri = (destination_directory.empty() ?
+    stripped_path.string() :
+    (rcpputils::fs::path{destination_directory} / stripped_path.filename().string()).string()) +
+    range_suffix.str();
+  const auto archive_size = uri_path.exists() ? uri_path.file_size() : 0u;
+
+  auto input_file = open_file_or_throw(uri, "rb");
+
+  const auto throw_no_seek_table = [&uri]() {
+      std::stringstream errmsg;
+      errmsg << "Compressed file: \"" << uri <<
+        "\" carries no zstd seek table; it was not written in the seekable format!";
+
+      throw std::runtime_error{errmsg.str()};
+    };
+
+  // The seek table sits at the archive tail: a skippable frame holding one
+  // size pair per data frame, closed by a 9-byte footer with the frame
+  // count, a descriptor byte and the seekable magic.
+  uint8_t footer[9];
+  if (archive_size < sizeof(footer) + 8u) {
+    throw_no_seek_table();
+  }
+  seek_or_throw(input_file.get(), archive_size - sizeof(footer), uri);
+  if (fread(footer, 1, sizeof(footer), input_file.get()) != sizeof(footer)) {
+    std::stringstream errmsg;
+    errmsg << "Unable to read binary data from file: \"" << uri << "\"!";
+
+    throw std::runtime_error{errmsg.str()};
+  }
+  if (read_le32(footer + 5) != kZstdSeekableMagic) {
+    throw_no_seek_table();
+  }
+  const auto num_frames = read_le32(footer);
+  // Bit 7 of the descriptor adds a per-frame checksum to every table entry.
+  const size_t entry_size = (footer[4] & 0x80u) ? 12u : 8u;
+  const uint64_t table_size = 8u + num_frames * entry_size + sizeof(footer);
+  if (archive_size < table_size) {
+    throw_no_seek_table();
+  }
+
+  seek_or_throw(input_file.get(), archive_size - table_size, uri);
+  std::vector<uint8_t> table(static_cast<size_t>(table_size - sizeof(footer)));
+  if (fread(table.data(), 1, table.size(), input_file.get()) != table.size()) {
+    std::stringstream errmsg;
+    errmsg << "Unable to read binary data from file: \"" << uri << "\"!";
+
+    throw std::runtime_error{errmsg.str()};
+  }
+  if (read_le32(table.data()) != kZstdSkippableFrameMagic ||
+    read_le32(table.data() + 4) != num_frames * entry_size + 9u)
+  {
+    throw_no_seek_table();
+  }
+
+  auto output_file = open_file_or_throw(decompressed_uri, "wb");
+
+  std::vector<uint8_t> compressed_frame;
+  std::vector<uint8_t> decompressed_frame;
+  const uint64_t range_end = static_cast<uint64_t>(offset) + size;
+  uint64_t compressed_offset{0};
+  uint64_t decompressed_offset{0};
+  size_t compressed_read{0};
+  size_t extracted_size{0};
+
+  try {
+    for (uint32_t frame = 0; frame < num_frames; ++frame) {
+      const auto entry = table.data() + 8u + frame * entry_size;
+      const auto frame_compressed_size = read_le32(entry);
+      const auto frame_decompressed_size = read_le32(entry + 4);
+      const auto frame_start = decompressed_offset;
+      const auto frame_end = frame_start + frame_decompressed_size;
+
+      if (frame_start >= range_end) {
+        break;
+      }
+      if (frame_end > offset && frame_decompressed_size > 0u) {
+        seek_or_throw(input_file.get(), compressed_offset, uri);
+        compressed_frame.resize(frame_compressed_size);
+        if (fread(compressed_frame.data(), 1, compressed_frame.size(), input_file.get()) !=
+          compressed_frame.size())
+        {
+          std::stringstream errmsg;
+          errmsg << "Unable to read binary data from file: \"" << uri << "\"!";
+
+          throw std::runtime_error{errmsg.str()};
+        }
+
+        decompressed_frame.resize(frame_decompressed_size);
+        // Reuse the long-lived context across frames; only the session is reset.
+        throw_on_zstd_error(ZSTD_DCtx_reset(context_.get(), ZSTD_reset_session_only));
+        throw_on_zstd_error(
+          ZSTD_decompressDCtx(
+            context_.get(),
+            decompressed_frame.data(), decompressed_frame.size(),
+            compressed_frame.data(), compressed_frame.size()));
+        compressed_read += frame_compressed_size;
+
+        // Write only the slice of the frame overlapping the requested range.
+        const auto slice_begin =
+          static_cast<size_t>(std::max<uint64_t>(offset, frame_start) - frame_start);
+        const auto slice_end =
+          static_cast<size_t>(std::min<uint64_t>(range_end, frame_end) - frame_start);
+        const auto write_count = fwrite(
+          decompressed_frame.data() + slice_begin, 1, slice_end - slice_begin,
+          output_file.get());
+        if (write_count != slice_end - slice_begin) {
+          std::stringstream errmsg;
+          errmsg << "Unable to write data to file: \"" << decompressed_uri << "\"!";
+
+          throw std::runtime_error{errmsg.str()};
+        }
+        extracted_size += write_count;
+      }
+
+      compressed_offset += frame_compressed_size;
+      decompressed_offset = frame_end;
+    }
+  } catch (...) {
+    // Do not leave a partially written extracted file behind.
+    output_file.reset();
+    rcpputils::fs::remove(rcpputils::fs::path{decompressed_uri});
+    throw;
+  }
+
+  const auto end = std::chrono::high_resolution_clock::now();
+  print_compression_statistics(start, end, extracted_size, compressed_read);
 
   return decompressed_uri;
 }
@@ -63,6 +324,12 @@ std::string ZstdDecompressor::decompress_uri(const std::string & uri)
 void ZstdDecompressor::decompress_serialized_bag_message(
   rosbag2_storage::SerializedBagMessage * message)
 {
+  if (!is_zstd_frame(*message->serialized_data)) {
+    // The writer may skip compression per topic (static bypass lists or the
+    // adaptive incompressibility check); those messages are stored as-is.
+    return;
+  }
+
   const auto start = std::chrono::high_resolution_clock::now();
   const auto compressed_buffer_length = message->serialized_data->buffer_length;
 
@@ -76,9 +343,33 @@ void ZstdDecompressor::decompress_serialized_bag_message(
   // the initializer list constructor instead.
   std::vector<uint8_t> decompressed_buffer(decompressed_buffer_length);
 
-  const auto decompression_result = ZSTD_decompress(
-    decompressed_buffer.data(), decompressed_buffer_length,
+  // Reuse the long-lived context across calls; only the session is reset.
+  throw_on_zstd_error(ZSTD_DCtx_reset(context_.get(), ZSTD_reset_session_only));
+
+  // Frames compressed with a dictionary reference it by id in their header.
+  const auto dictionary_id = ZSTD_getDictID_fromFrame(
     message->serialized_data->buffer, compressed_buffer_length);
+  ZstdDecompressReturnType decompression_result;
+  if (dictionary_id != 0u) {
+    const auto dictionary = dictionaries_by_id_.find(dictionary_id);
+    if (dictionary == dictionaries_by_id_.end()) {
+      std::stringstream errmsg;
+      errmsg << "Message was compressed with dictionary " << dictionary_id <<
+        ", which was not loaded for this bag!";
+
+      throw std::runtime_error{errmsg.str()};
+    }
+    decompression_result = ZSTD_decompress_usingDDict(
+      context_.get(),
+      decompressed_buffer.data(), decompressed_buffer_length,
+      message->serialized_data->buffer, compressed_buffer_length,
+      dictionary->second.get());
+  } else {
+    decompression_result = ZSTD_decompressDCtx(
+      context_.get(),
+      decompressed_buffer.data(), decompressed_buffer_length,
+      message->serialized_data->buffer, compressed_buffer_length);
+  }
 
   throw_on_zstd_error(decompression_result);
 
@@ -95,6 +386,23 @@ void ZstdDecompressor::decompress_serialized_bag_message(
   print_compression_statistics(start, end, decompression_result, compressed_buffer_length);
 }
 
+void ZstdDecompressor::add_dictionary(const std::vector<uint8_t> & dictionary)
+{
+  const auto dictionary_id = ZDICT_getDictID(dictionary.data(), dictionary.size());
+  if (dictionary_id == 0u) {
+    throw std::runtime_error{"Invalid Zstd dictionary!"};
+  }
+
+  std::unique_ptr<ZSTD_DDict, decltype(&ZSTD_freeDDict)> digested_dictionary{
+    ZSTD_createDDict(dictionary.data(), dictionary.size()),
+    &ZSTD_freeDDict};
+  if (!digested_dictionary) {
+    throw std::runtime_error{"Unable to create Zstd decompression dictionary!"};
+  }
+  dictionaries_by_id_.erase(dictionary_id);
+  dictionaries_by_id_.emplace(dictionary_id, std::move(digested_dictionary));
+}
+
 std::string ZstdDecompressor::get_decompression_identifier() const
 {
   return kDecompressionIdentifier;
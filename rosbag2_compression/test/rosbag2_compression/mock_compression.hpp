@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rosbag2_compression/base_compressor_interface.hpp"
 #include "rosbag2_compression/base_decompressor_interface.hpp"
@@ -41,6 +42,18 @@ public:
     decompress_serialized_bag_message,
     void(rosbag2_storage::SerializedBagMessage * bag_message));
   MOCK_CONST_METHOD0(get_decompression_identifier, std::string());
+
+  // The reader always calls the two-argument overload; forward to the mocked
+  // one so existing expectations keep matching, and record the requested
+  // destination directories for inspection.
+  std::string decompress_uri(
+    const std::string & uri, const std::string & destination_directory) override
+  {
+    destination_directories.push_back(destination_directory);
+    return decompress_uri(uri);
+  }
+
+  std::vector<std::string> destination_directories;
 };
 
 #endif  // ROSBAG2_COMPRESSION__MOCK_COMPRESSION_HPP_
@@ -30,6 +30,11 @@ public:
     std::unique_ptr<rosbag2_compression::BaseCompressorInterface>(
       const std::string &));
 
+  MOCK_METHOD1(
+    create_compressor,
+    std::unique_ptr<rosbag2_compression::BaseCompressorInterface>(
+      const rosbag2_compression::CompressionOptions &));
+
   MOCK_METHOD1(
     create_decompressor,
     std::unique_ptr<rosbag2_compression::BaseDecompressorInterface>(
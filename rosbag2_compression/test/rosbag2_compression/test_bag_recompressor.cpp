@@ -0,0 +1,94 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+
+#include "rosbag2_compression/bag_recompressor.hpp"
+
+#include "rosbag2_storage/metadata_io.hpp"
+
+#include "rosbag2_test_common/temporary_directory_fixture.hpp"
+
+#include "gmock/gmock.h"
+
+using namespace ::testing;  // NOLINT
+using rosbag2_test_common::TemporaryDirectoryFixture;
+
+class BagRecompressorTest : public TemporaryDirectoryFixture
+{
+public:
+  void write_bag(const std::vector<std::string> & relative_file_paths)
+  {
+    for (const auto & relative_path : relative_file_paths) {
+      std::ofstream file{
+        (rcpputils::fs::path(temporary_dir_path_) / relative_path).string()};
+      // Repetitive content so zstd produces a smaller file.
+      for (int i = 0; i < 1024; ++i) {
+        file << "some bag file content ";
+      }
+    }
+    rosbag2_storage::BagMetadata metadata;
+    metadata.storage_identifier = "sqlite3";
+    metadata.relative_file_paths = relative_file_paths;
+    metadata.message_count = 1;
+    rosbag2_storage::MetadataIo().write_metadata(temporary_dir_path_, metadata);
+  }
+};
+
+TEST_F(BagRecompressorTest, compresses_all_files_and_rewrites_metadata) {
+  write_bag({"bag_0.db3", "bag_1.db3"});
+
+  rosbag2_compression::BagRecompressor::Options options;
+  options.bag_uri = temporary_dir_path_;
+  options.worker_count = 2;
+  rosbag2_compression::BagRecompressor(options).run();
+
+  const auto metadata = rosbag2_storage::MetadataIo().read_metadata(temporary_dir_path_);
+  EXPECT_THAT(metadata.compression_format, Eq("zstd"));
+  EXPECT_THAT(metadata.compression_mode, Eq("FILE"));
+  ASSERT_THAT(metadata.relative_file_paths, SizeIs(2u));
+  EXPECT_THAT(metadata.relative_file_paths[0], Eq("bag_0.db3.zstd"));
+  EXPECT_THAT(metadata.relative_file_paths[1], Eq("bag_1.db3.zstd"));
+
+  const auto bag_dir = rcpputils::fs::path(temporary_dir_path_);
+  EXPECT_TRUE((bag_dir / "bag_0.db3.zstd").exists());
+  EXPECT_TRUE((bag_dir / "bag_1.db3.zstd").exists());
+  EXPECT_FALSE((bag_dir / "bag_0.db3").exists());
+  EXPECT_FALSE((bag_dir / "bag_1.db3").exists());
+}
+
+TEST_F(BagRecompressorTest, already_compressed_bag_is_rejected) {
+  write_bag({"bag_0.db3"});
+  auto metadata = rosbag2_storage::MetadataIo().read_metadata(temporary_dir_path_);
+  metadata.compression_format = "zstd";
+  metadata.compression_mode = "FILE";
+  rosbag2_storage::MetadataIo().write_metadata(temporary_dir_path_, metadata);
+
+  rosbag2_compression::BagRecompressor::Options options;
+  options.bag_uri = temporary_dir_path_;
+  EXPECT_THROW(rosbag2_compression::BagRecompressor(options).run(), std::runtime_error);
+}
+
+TEST_F(BagRecompressorTest, unknown_compression_format_is_rejected) {
+  write_bag({"bag_0.db3"});
+
+  rosbag2_compression::BagRecompressor::Options options;
+  options.bag_uri = temporary_dir_path_;
+  options.compression_format = "not_a_format";
+  EXPECT_THROW(rosbag2_compression::BagRecompressor(options).run(), std::runtime_error);
+}
@@ -58,6 +58,19 @@ TEST_F(CompressionFactoryTest, creates_zstd_compressor_uppercase)
   ASSERT_EQ(lowercase_compression_format, zstd_compressor->get_compression_identifier());
 }
 
+TEST_F(CompressionFactoryTest, creates_zstd_fast_compressor) {
+  const auto compression_format = "zstd_fast";
+  auto zstd_fast_compressor = factory.create_compressor(compression_format);
+  // zstd_fast produces regular zstd frames, just at a negative level.
+  ASSERT_EQ("zstd", zstd_fast_compressor->get_compression_identifier());
+}
+
+TEST_F(CompressionFactoryTest, creates_zstd_decompressor_for_zstd_fast) {
+  const auto compression_format = "zstd_fast";
+  auto zstd_decompressor = factory.create_decompressor(compression_format);
+  ASSERT_EQ("zstd", zstd_decompressor->get_decompression_identifier());
+}
+
 TEST_F(CompressionFactoryTest, creates_zstd_decompressor) {
   const auto compression_format = "zstd";
   auto zstd_decompressor = factory.create_decompressor(compression_format);
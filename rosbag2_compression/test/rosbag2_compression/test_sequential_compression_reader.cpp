@@ -168,6 +168,93 @@ TEST_F(SequentialCompressionReaderTest, reader_calls_create_decompressor)
     rosbag2_cpp::StorageOptions(), {"", storage_serialization_format_});
 }
 
+TEST_F(SequentialCompressionReaderTest, scratch_directory_is_passed_to_the_decompressor)
+{
+  rosbag2_storage::BagMetadata metadata = construct_default_bag_metadata();
+  ON_CALL(*metadata_io_, read_metadata(_)).WillByDefault(Return(metadata));
+  ON_CALL(*metadata_io_, metadata_file_exists(_)).WillByDefault(Return(true));
+
+  auto decompressor = std::make_unique<NiceMock<MockDecompressor>>();
+  auto * decompressor_ptr = decompressor.get();
+  ON_CALL(*decompressor, decompress_uri(_)).WillByDefault(Return("some/path"));
+  EXPECT_CALL(*decompressor, decompress_uri(_)).Times(1);
+
+  auto compression_factory = std::make_unique<StrictMock<MockCompressionFactory>>();
+  ON_CALL(*compression_factory, create_decompressor(_))
+  .WillByDefault(Return(ByMove(std::move(decompressor))));
+  EXPECT_CALL(*compression_factory, create_decompressor(_)).Times(1);
+  EXPECT_CALL(*storage_factory_, open_read_only(_, _)).Times(1);
+
+  auto sequential_reader = std::make_unique<rosbag2_compression::SequentialCompressionReader>(
+    std::move(compression_factory),
+    std::move(storage_factory_),
+    converter_factory_,
+    std::move(metadata_io_));
+
+  rosbag2_cpp::StorageOptions storage_options;
+  storage_options.decompression_scratch_directory = "/some/scratch";
+
+  reader_ = std::make_unique<rosbag2_cpp::Reader>(std::move(sequential_reader));
+  reader_->open(storage_options, {"", storage_serialization_format_});
+
+  EXPECT_THAT(decompressor_ptr->destination_directories, ElementsAre("/some/scratch"));
+}
+
+TEST_F(SequentialCompressionReaderTest, message_mode_decodes_on_workers_in_order)
+{
+  rosbag2_storage::BagMetadata metadata = construct_default_bag_metadata();
+  metadata.compression_mode =
+    rosbag2_compression::compression_mode_to_string(
+    rosbag2_compression::CompressionMode::MESSAGE);
+  ON_CALL(*metadata_io_, read_metadata(_)).WillByDefault(Return(metadata));
+  ON_CALL(*metadata_io_, metadata_file_exists(_)).WillByDefault(Return(true));
+
+  // Every decompressor the reader asks for - one on open and one per decode
+  // worker that claims a job - is a fresh mock whose decode is a no-op.
+  auto compression_factory = std::make_unique<NiceMock<MockCompressionFactory>>();
+  ON_CALL(*compression_factory, create_decompressor(_))
+  .WillByDefault(
+    Invoke(
+      [](const std::string &) -> std::unique_ptr<rosbag2_compression::BaseDecompressorInterface>
+      {
+        return std::make_unique<NiceMock<MockDecompressor>>();
+      }));
+  EXPECT_CALL(*storage_factory_, open_read_only(_, _)).Times(1);
+
+  const size_t message_count = 5;
+  size_t messages_left = message_count;
+  ON_CALL(*storage_, has_next()).WillByDefault(
+    Invoke([&messages_left]() {return messages_left > 0;}));
+  ON_CALL(*storage_, read_next()).WillByDefault(
+    Invoke(
+      [&messages_left, message_count, this]() {
+        auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+        message->topic_name = topic_with_type_.name;
+        message->time_stamp = static_cast<rcutils_time_point_value_t>(
+          message_count - messages_left);
+        --messages_left;
+        return message;
+      }));
+
+  auto compression_reader = std::make_unique<rosbag2_compression::SequentialCompressionReader>(
+    std::move(compression_factory),
+    std::move(storage_factory_),
+    converter_factory_,
+    std::move(metadata_io_));
+  compression_reader->open(
+    rosbag2_cpp::StorageOptions(), {"", storage_serialization_format_});
+
+  // The messages fan out over the decode workers but come back in storage
+  // order, identified here by their consecutive timestamps.
+  for (size_t i = 0; i < message_count; ++i) {
+    ASSERT_TRUE(compression_reader->has_next());
+    EXPECT_EQ(
+      compression_reader->read_next()->time_stamp,
+      static_cast<rcutils_time_point_value_t>(i));
+  }
+  EXPECT_FALSE(compression_reader->has_next());
+}
+
 TEST_F(SequentialCompressionReaderTest, compression_called_when_splitting_bagfile)
 {
   const auto relative_path_1 = "/path/to/storage1";
@@ -183,16 +270,21 @@ TEST_F(SequentialCompressionReaderTest, compression_called_when_splitting_bagfil
   ON_CALL(*metadata_io_, metadata_file_exists(_)).WillByDefault(Return(true));
 
   auto decompressor = std::make_unique<NiceMock<MockDecompressor>>();
-  // We are mocking two splits, so only file decompression should occur twice
-  EXPECT_CALL(*decompressor, decompress_uri(_)).Times(2)
-  .WillOnce(Return(relative_path_1))
-  .WillOnce(Return(relative_path_2));
+  // Only the first split is decompressed on the reading thread.
+  EXPECT_CALL(*decompressor, decompress_uri(_)).Times(1)
+  .WillOnce(Return(relative_path_1));
   EXPECT_CALL(*decompressor, decompress_serialized_bag_message(_)).Times(0);
 
+  // The second split is decompressed by a separate decompressor on a
+  // background thread while the first one is being read.
+  auto prefetch_decompressor = std::make_unique<NiceMock<MockDecompressor>>();
+  EXPECT_CALL(*prefetch_decompressor, decompress_uri(_)).Times(1)
+  .WillOnce(Return(relative_path_2));
+
   auto compression_factory = std::make_unique<StrictMock<MockCompressionFactory>>();
-  ON_CALL(*compression_factory, create_decompressor(_))
-  .WillByDefault(Return(ByMove(std::move(decompressor))));
-  EXPECT_CALL(*compression_factory, create_decompressor(_)).Times(1);
+  EXPECT_CALL(*compression_factory, create_decompressor(_)).Times(2)
+  .WillOnce(Return(ByMove(std::move(decompressor))))
+  .WillOnce(Return(ByMove(std::move(prefetch_decompressor))));
   // open_read_only should be called twice when opening 2 split bags
   EXPECT_CALL(*storage_factory_, open_read_only(_, _)).Times(2);
   // storage::has_next() is called twice when reader::has_next() is called
@@ -24,12 +24,14 @@
 
 #include "rcpputils/filesystem_helper.hpp"
 #include "rosbag2_cpp/writer.hpp"
+#include "rosbag2_storage/ros_helper.hpp"
 
 #include "mock_converter_factory.hpp"
 #include "mock_metadata_io.hpp"
 #include "mock_storage.hpp"
 #include "mock_storage_factory.hpp"
 
+#include "mock_compression.hpp"
 #include "mock_compression_factory.hpp"
 
 using namespace testing;  // NOLINT
@@ -158,7 +160,9 @@ TEST_F(SequentialCompressionWriterTest, writer_calls_create_compressor)
   rosbag2_compression::CompressionOptions compression_options{
     "zstd", rosbag2_compression::CompressionMode::FILE};
   auto compression_factory = std::make_unique<StrictMock<MockCompressionFactory>>();
-  EXPECT_CALL(*compression_factory, create_compressor(_)).Times(1);
+  EXPECT_CALL(
+    *compression_factory,
+    create_compressor(An<const rosbag2_compression::CompressionOptions &>())).Times(1);
 
   auto sequential_writer = std::make_unique<rosbag2_compression::SequentialCompressionWriter>(
     compression_options,
@@ -172,3 +176,138 @@ TEST_F(SequentialCompressionWriterTest, writer_calls_create_compressor)
 
   EXPECT_TRUE(rcpputils::fs::remove(tmp_dir_));
 }
+
+TEST_F(SequentialCompressionWriterTest, message_mode_skips_statically_excluded_topics)
+{
+  rosbag2_compression::CompressionOptions compression_options{
+    "zstd", rosbag2_compression::CompressionMode::MESSAGE};
+  compression_options.exclude_topics = {"/camera/compressed"};
+
+  auto compressor = std::make_unique<NiceMock<MockCompressor>>();
+  // Only the topic that is not on the exclude list reaches the compressor.
+  EXPECT_CALL(
+    *compressor,
+    compress_serialized_bag_message(
+      Pointee(Field(&rosbag2_storage::SerializedBagMessage::topic_name, "/text")))).Times(3);
+
+  auto compression_factory = std::make_unique<StrictMock<MockCompressionFactory>>();
+  EXPECT_CALL(
+    *compression_factory,
+    create_compressor(An<const rosbag2_compression::CompressionOptions &>()))
+  .WillOnce(Return(ByMove(std::move(compressor))));
+
+  auto sequential_writer = std::make_unique<rosbag2_compression::SequentialCompressionWriter>(
+    compression_options,
+    std::move(compression_factory),
+    std::move(storage_factory_),
+    converter_factory_,
+    std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  writer_->open(tmp_dir_storage_options_, {serialization_format_, serialization_format_});
+  writer_->create_topic({"/text", "test_msgs/BasicTypes", serialization_format_, ""});
+  writer_->create_topic({"/camera/compressed", "test_msgs/BasicTypes", serialization_format_, ""});
+
+  const std::string message_data{"uncompressible"};
+  for (int64_t i = 0; i < 3; ++i) {
+    for (const auto & topic_name : {"/text", "/camera/compressed"}) {
+      auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+      message->topic_name = topic_name;
+      message->time_stamp = i;
+      message->serialized_data = rosbag2_storage::make_serialized_message(
+        message_data.c_str(), message_data.length());
+      writer_->write(message);
+    }
+  }
+  writer_.reset();
+
+  EXPECT_TRUE(rcpputils::fs::remove(tmp_dir_));
+}
+
+TEST_F(SequentialCompressionWriterTest, adaptive_check_stops_compressing_incompressible_topics)
+{
+  rosbag2_compression::CompressionOptions compression_options{
+    "zstd", rosbag2_compression::CompressionMode::MESSAGE};
+
+  auto compressor = std::make_unique<NiceMock<MockCompressor>>();
+  // The mocked compressor leaves the payload at its original size, so the
+  // achieved ratio of 1.0 stays below the default threshold and the topic is
+  // bypassed once the first sampling window of 100 messages is complete.
+  EXPECT_CALL(*compressor, compress_serialized_bag_message(_)).Times(100);
+
+  auto compression_factory = std::make_unique<StrictMock<MockCompressionFactory>>();
+  EXPECT_CALL(
+    *compression_factory,
+    create_compressor(An<const rosbag2_compression::CompressionOptions &>()))
+  .WillOnce(Return(ByMove(std::move(compressor))));
+
+  auto sequential_writer = std::make_unique<rosbag2_compression::SequentialCompressionWriter>(
+    compression_options,
+    std::move(compression_factory),
+    std::move(storage_factory_),
+    converter_factory_,
+    std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  writer_->open(tmp_dir_storage_options_, {serialization_format_, serialization_format_});
+  writer_->create_topic({"/camera/compressed", "test_msgs/BasicTypes", serialization_format_, ""});
+
+  const std::string message_data{"uncompressible"};
+  for (int64_t i = 0; i < 105; ++i) {
+    auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+    message->topic_name = "/camera/compressed";
+    message->time_stamp = i;
+    message->serialized_data = rosbag2_storage::make_serialized_message(
+      message_data.c_str(), message_data.length());
+    writer_->write(message);
+  }
+  writer_.reset();
+
+  EXPECT_TRUE(rcpputils::fs::remove(tmp_dir_));
+}
+
+TEST_F(SequentialCompressionWriterTest, chunk_mode_writes_buffered_messages_as_one_chunk)
+{
+  rosbag2_compression::CompressionOptions compression_options{
+    "zstd", rosbag2_compression::CompressionMode::CHUNK};
+
+  auto compressor = std::make_unique<NiceMock<MockCompressor>>();
+  // The packed chunk is compressed as a single frame.
+  EXPECT_CALL(*compressor, compress_serialized_bag_message(_)).Times(1);
+
+  auto compression_factory = std::make_unique<StrictMock<MockCompressionFactory>>();
+  EXPECT_CALL(
+    *compression_factory,
+    create_compressor(An<const rosbag2_compression::CompressionOptions &>()))
+  .WillOnce(Return(ByMove(std::move(compressor))));
+
+  // Individual messages are buffered; only the chunk row reaches the storage
+  // when the bag is closed.
+  EXPECT_CALL(
+    *storage_,
+    write(An<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>>())).Times(1);
+
+  auto sequential_writer = std::make_unique<rosbag2_compression::SequentialCompressionWriter>(
+    compression_options,
+    std::move(compression_factory),
+    std::move(storage_factory_),
+    converter_factory_,
+    std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  writer_->open(tmp_dir_storage_options_, {serialization_format_, serialization_format_});
+  writer_->create_topic({"test_topic", "test_msgs/BasicTypes", serialization_format_, ""});
+
+  const std::string message_data{"chunked message"};
+  for (int64_t i = 0; i < 5; ++i) {
+    auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+    message->topic_name = "test_topic";
+    message->time_stamp = i;
+    message->serialized_data = rosbag2_storage::make_serialized_message(
+      message_data.c_str(), message_data.length());
+    writer_->write(message);
+  }
+  writer_.reset();  // Closing the bag flushes the partial chunk.
+
+  EXPECT_TRUE(rcpputils::fs::remove(tmp_dir_));
+}
@@ -247,6 +247,82 @@ TEST_F(CompressionHelperFixture, zstd_decompress_file_contents)
   EXPECT_EQ(initial_data, decompressed_data);
 }
 
+TEST_F(CompressionHelperFixture, zstd_long_distance_matching_and_checksum_roundtrip)
+{
+  const auto uri = (rcpputils::fs::path(temporary_dir_path_) / "file_ldm.txt").string();
+  create_garbage_file(uri);
+
+  const auto initial_data = read_file(uri);
+
+  // Long-distance matching with an 8 MiB window and frame checksums enabled;
+  // the produced frames must stay readable by the regular decompressor.
+  auto compressor = rosbag2_compression::ZstdCompressor{1, 0, true, 23, true};
+  const auto compressed_uri = compressor.compress_uri(uri);
+
+  ASSERT_TRUE(rcpputils::fs::exists(compressed_uri)) <<
+    "Expected compressed file: \"" << compressed_uri << "\" to exist!";
+
+  ASSERT_EQ(0, std::remove(uri.c_str())) <<
+    "Removal of initial file: \"" << uri <<
+    "\" failed! The remaining tests require \"" << uri << "\" to be deleted.";
+
+  auto decompressor = rosbag2_compression::ZstdDecompressor{};
+  const auto decompressed_uri = decompressor.decompress_uri(compressed_uri);
+
+  ASSERT_TRUE(rcpputils::fs::exists(decompressed_uri)) <<
+    "Decompressed file: \"" << decompressed_uri << "\" must exist!";
+
+  const auto decompressed_data = read_file(decompressed_uri);
+  EXPECT_EQ(initial_data, decompressed_data);
+}
+
+TEST_F(CompressionHelperFixture, zstd_decompress_file_range)
+{
+  const auto uri = (rcpputils::fs::path(temporary_dir_path_) / "file4.txt").string();
+  create_garbage_file(uri);
+
+  const auto initial_data = read_file(uri);
+
+  auto compressor = rosbag2_compression::ZstdCompressor{};
+  const auto compressed_uri = compressor.compress_uri(uri);
+
+  ASSERT_TRUE(rcpputils::fs::exists(compressed_uri)) <<
+    "Expected compressed file: \"" << compressed_uri << "\" to exist!";
+
+  // A range crossing a frame boundary of the seekable archive, so the
+  // extraction has to stitch slices of two independent frames together.
+  const size_t range_offset = 3 * 1024 * 1024;
+  const size_t range_size = 2 * 1024 * 1024;
+  ASSERT_GT(initial_data.size(), range_offset + range_size);
+
+  auto decompressor = rosbag2_compression::ZstdDecompressor{};
+  const auto range_uri =
+    decompressor.decompress_uri_range(compressed_uri, range_offset, range_size);
+  const auto range_file_path = rcpputils::fs::path{range_uri};
+
+  ASSERT_TRUE(range_file_path.exists()) <<
+    "Extracted range file: \"" << range_file_path.string() << "\" must exist!";
+
+  const auto range_data = read_file(range_uri);
+  const auto expected_data = std::vector<char>(
+    initial_data.begin() + range_offset,
+    initial_data.begin() + range_offset + range_size);
+
+  ASSERT_EQ(expected_data.size(), range_data.size()) <<
+    "Extracted range size must match the requested range size!";
+  EXPECT_EQ(expected_data, range_data);
+}
+
+TEST_F(CompressionHelperFixture, zstd_decompress_range_fails_without_seek_table)
+{
+  const auto uri = (rcpputils::fs::path(temporary_dir_path_) / "file5.txt").string();
+  create_garbage_file(uri);
+
+  auto decompressor = rosbag2_compression::ZstdDecompressor{};
+  EXPECT_THROW(decompressor.decompress_uri_range(uri, 0, 1024), std::runtime_error) <<
+    "Expected decompress_uri_range(\"" << uri << "\") to fail!";
+}
+
 TEST_F(CompressionHelperFixture, zstd_decompress_fails_on_bad_file)
 {
   const auto uri = (rcpputils::fs::path(temporary_dir_path_) / "file3.txt").string();
@@ -297,3 +373,17 @@ TEST_F(CompressionHelperFixture, zstd_decompress_serialized_bag_message)
   std::string new_msg = deserialize_message(msg->serialized_data);
   EXPECT_EQ(new_msg, message_);
 }
+
+TEST_F(CompressionHelperFixture, zstd_decompress_passes_through_uncompressed_message)
+{
+  // Messages of topics bypassed by the writer's per-topic compression checks
+  // are stored without a zstd frame and must come back unchanged.
+  auto msg = std::make_unique<rosbag2_storage::SerializedBagMessage>();
+  msg->serialized_data = rosbag2_storage::make_serialized_message(
+    message_.data(), message_.length());
+
+  rosbag2_compression::ZstdDecompressor decompressor;
+  EXPECT_NO_THROW(decompressor.decompress_serialized_bag_message(msg.get()));
+  std::string new_msg = deserialize_message(msg->serialized_data);
+  EXPECT_EQ(new_msg, message_);
+}
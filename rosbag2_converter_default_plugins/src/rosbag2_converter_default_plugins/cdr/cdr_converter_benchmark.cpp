@@ -0,0 +1,141 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "rosbag2_cpp/typesupport_helpers.hpp"
+#include "rosbag2_cpp/types.hpp"
+
+#include "rosbag2_storage/ros_helper.hpp"
+#include "rosbag2_storage/serialized_bag_message.hpp"
+
+#include "sensor_msgs/msg/image.hpp"
+#include "sensor_msgs/msg/imu.hpp"
+#include "sensor_msgs/msg/point_cloud2.hpp"
+#include "tf2_msgs/msg/tf_message.hpp"
+
+#include "cdr_converter.hpp"
+
+// Round-trip benchmark of the cdr converter plugin: measures the full
+// deserialize + serialize cost per message across representative message
+// shapes (small fixed-size, large blob-carrying and array-of-structs
+// types), reporting messages/s and MB/s. Serves as the regression baseline
+// for serialization fast paths.
+
+namespace
+{
+
+constexpr const size_t DEFAULT_ITERATIONS = 5000;
+
+template<typename MessageT>
+void run_round_trip(
+  rosbag2_converter_default_plugins::CdrConverter & converter,
+  const std::string & type_name,
+  MessageT & message,
+  size_t iterations)
+{
+  const auto type_support =
+    rosbag2_cpp::get_typesupport_handle(type_name, "rosidl_typesupport_cpp");
+
+  auto ros_message = std::make_shared<rosbag2_cpp::rosbag2_introspection_message_t>();
+  ros_message->time_stamp = 0;
+  ros_message->message = nullptr;
+  ros_message->allocator = rcutils_get_default_allocator();
+  rosbag2_cpp::introspection_message_set_topic_name(ros_message.get(), "benchmark_topic");
+
+  // Produce the CDR input once; the timed loop below measures the round
+  // trip only.
+  ros_message->message = &message;
+  auto input = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  input->serialized_data = rosbag2_storage::make_empty_serialized_message(0);
+  input->topic_name = "benchmark_topic";
+  converter.serialize(ros_message, type_support, input);
+
+  MessageT scratch;
+  ros_message->message = &scratch;
+
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    converter.deserialize(input, type_support, ros_message);
+    auto output = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+    output->serialized_data = rosbag2_storage::make_empty_serialized_message(0);
+    converter.serialize(ros_message, type_support, output);
+  }
+  const auto elapsed =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  const auto payload_bytes = input->serialized_data->buffer_length;
+  const auto messages_per_second = static_cast<double>(iterations) / elapsed;
+  const auto megabytes_per_second =
+    static_cast<double>(iterations * payload_bytes) / elapsed / (1024.0 * 1024.0);
+
+  std::cout << std::left << std::setw(32) << type_name <<
+    std::right << std::fixed << std::setprecision(0) <<
+    std::setw(12) << payload_bytes << " B/msg" <<
+    std::setw(12) << messages_per_second << " msg/s" <<
+    std::setprecision(1) << std::setw(12) << megabytes_per_second << " MB/s" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  size_t iterations = DEFAULT_ITERATIONS;
+  if (argc > 1) {
+    iterations = std::stoul(argv[1]);
+  }
+
+  rosbag2_converter_default_plugins::CdrConverter converter;
+
+  sensor_msgs::msg::Imu imu;
+  imu.header.frame_id = "imu_link";
+  imu.orientation.w = 1.0;
+
+  sensor_msgs::msg::Image image;
+  image.header.frame_id = "camera_link";
+  image.width = 640;
+  image.height = 480;
+  image.step = image.width * 3;
+  image.encoding = "rgb8";
+  image.data.assign(static_cast<size_t>(image.step) * image.height, 42u);
+
+  sensor_msgs::msg::PointCloud2 point_cloud;
+  point_cloud.header.frame_id = "lidar_link";
+  point_cloud.width = 100000;
+  point_cloud.height = 1;
+  point_cloud.point_step = 16;
+  point_cloud.row_step = point_cloud.width * point_cloud.point_step;
+  point_cloud.data.assign(point_cloud.row_step, 42u);
+
+  tf2_msgs::msg::TFMessage tf_message;
+  tf_message.transforms.resize(100);
+  for (auto & transform : tf_message.transforms) {
+    transform.header.frame_id = "map";
+    transform.child_frame_id = "base_link";
+    transform.transform.rotation.w = 1.0;
+  }
+
+  std::cout << "cdr converter round trip, " << iterations <<
+    " iterations per type" << std::endl;
+  run_round_trip(converter, "sensor_msgs/msg/Imu", imu, iterations);
+  run_round_trip(converter, "sensor_msgs/msg/Image", image, iterations);
+  run_round_trip(converter, "sensor_msgs/msg/PointCloud2", point_cloud, iterations);
+  run_round_trip(converter, "tf2_msgs/msg/TFMessage", tf_message, iterations);
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_CPP__BAG_COMPACTOR_HPP_
+#define ROSBAG2_CPP__BAG_COMPACTOR_HPP_
+
+#include "rosbag2_cpp/storage_options.hpp"
+#include "rosbag2_cpp/visibility_control.hpp"
+
+namespace rosbag2_cpp
+{
+
+/**
+ * Offline rewrite of a bag with rows physically clustered by topic and
+ * timestamp.
+ *
+ * Bags are written in arrival order, so a filtered read of one topic
+ * touches pages interleaved with every other topic and is seek-bound even
+ * on an SSD. Compacting copies every split into a fresh file one topic at
+ * a time, in timestamp order, so the storage lays out each topic's
+ * messages contiguously and a per-topic scan of the compacted bag reads
+ * sequential pages at device bandwidth. The bag's content, split
+ * structure and metadata are preserved unchanged.
+ */
+class ROSBAG2_CPP_PUBLIC BagCompactor final
+{
+public:
+  struct Options
+  {
+    // Bag directory to compact; must carry a metadata file.
+    StorageOptions input_storage_options;
+    // Destination bag; the directory must not exist yet. An empty
+    // storage id keeps the input's storage plugin.
+    StorageOptions output_storage_options;
+  };
+
+  explicit BagCompactor(const Options & options);
+
+  /**
+   * Run the compaction to completion.
+   *
+   * \throws runtime_error when the input bag cannot be read or the output
+   * bag cannot be created.
+   */
+  void run();
+
+private:
+  Options options_;
+};
+
+}  // namespace rosbag2_cpp
+
+#endif  // ROSBAG2_CPP__BAG_COMPACTOR_HPP_
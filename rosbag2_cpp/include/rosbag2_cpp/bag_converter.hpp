@@ -0,0 +1,79 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_CPP__BAG_CONVERTER_HPP_
+#define ROSBAG2_CPP__BAG_CONVERTER_HPP_
+
+#include <memory>
+#include <string>
+
+#include "rosbag2_cpp/reader.hpp"
+#include "rosbag2_cpp/serialization_format_converter_factory.hpp"
+#include "rosbag2_cpp/serialization_format_converter_factory_interface.hpp"
+#include "rosbag2_cpp/storage_options.hpp"
+#include "rosbag2_cpp/visibility_control.hpp"
+#include "rosbag2_cpp/writer.hpp"
+
+namespace rosbag2_cpp
+{
+
+/**
+ * Offline conversion of a whole bag into another serialization format.
+ *
+ * The conversion runs as a pipeline: the calling thread reads messages and
+ * stamps them with a sequence number, several workers convert them in
+ * parallel (partitioned by topic, since the serialization format converters
+ * are stateless per message but the per-topic conversion state is not), and
+ * one writer thread restores the global timestamp order by draining the
+ * converted messages in sequence order. Throughput scales with cores instead
+ * of being limited by a single read-convert-write loop.
+ */
+class ROSBAG2_CPP_PUBLIC BagConverter final
+{
+public:
+  struct Options
+  {
+    StorageOptions input_storage_options;
+    StorageOptions output_storage_options;
+    // Serialization format the output bag is written in.
+    std::string output_serialization_format;
+    // Number of converter workers; 0 uses one per hardware thread.
+    size_t worker_count = 0;
+  };
+
+  explicit BagConverter(
+    const Options & options,
+    std::unique_ptr<Reader> reader = std::make_unique<Reader>(),
+    std::unique_ptr<Writer> writer = std::make_unique<Writer>(),
+    std::shared_ptr<SerializationFormatConverterFactoryInterface> converter_factory =
+    std::make_shared<SerializationFormatConverterFactory>());
+
+  /**
+   * Run the conversion to completion.
+   *
+   * \throws runtime_error when the input bag cannot be read, the output bag
+   * cannot be written or any message fails to convert.
+   */
+  void run();
+
+private:
+  Options options_;
+  std::unique_ptr<Reader> reader_;
+  std::unique_ptr<Writer> writer_;
+  std::shared_ptr<SerializationFormatConverterFactoryInterface> converter_factory_;
+};
+
+}  // namespace rosbag2_cpp
+
+#endif  // ROSBAG2_CPP__BAG_CONVERTER_HPP_
@@ -22,6 +22,7 @@
 
 #include "rosbag2_cpp/converter_options.hpp"
 #include "rosbag2_cpp/converter_interfaces/serialization_format_converter.hpp"
+#include "rosbag2_cpp/types/introspection_message.hpp"
 #include "rosbag2_cpp/serialization_format_converter_factory.hpp"
 #include "rosbag2_cpp/serialization_format_converter_factory_interface.hpp"
 #include "rosbag2_cpp/visibility_control.hpp"
@@ -42,13 +43,11 @@ namespace rosbag2_cpp
 {
 
 // Convenience struct to keep both type supports (rmw and introspection) together.
-// Only used internally.
+// Only used internally. The handles come from the process-wide typesupport
+// registry, which keeps their backing libraries loaded.
 struct ConverterTypeSupport
 {
-  std::shared_ptr<rcpputils::SharedLibrary> type_support_library;
   const rosidl_message_type_support_t * rmw_type_support;
-
-  std::shared_ptr<rcpputils::SharedLibrary> introspection_type_support_library;
   const rosidl_message_type_support_t * introspection_type_support;
 };
 
@@ -80,13 +79,48 @@ public:
   std::shared_ptr<rosbag2_storage::SerializedBagMessage>
   convert(std::shared_ptr<const rosbag2_storage::SerializedBagMessage> message);
 
+  /**
+   * Converts a whole batch of messages, pairing with the batched reader and
+   * writer APIs. The typesupport handles and the pooled conversion state are
+   * resolved once per run of consecutive messages of the same topic, so a
+   * batch read in storage order pays no per-message lookups.
+   *
+   * \param messages Messages to convert, in any order
+   * \returns Converted messages, in the same order
+   */
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+  convert_batch(
+    const std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> & messages);
+
   void add_topic(const std::string & topic, const std::string & type);
 
 private:
+  // Reusable conversion state of one topic. The introspection message is
+  // reset in place between uses instead of being torn down and rebuilt, and
+  // the buffer hint remembers how large serialized output got so buffers no
+  // longer grow from zero on every message.
+  struct PooledConversionState
+  {
+    std::shared_ptr<rosbag2_introspection_message_t> introspection_message;
+    size_t output_buffer_hint = 0;
+  };
+
+  // Per-message conversion core shared by convert() and convert_batch():
+  // deserializes into the pooled introspection message and serializes into
+  // a hint-sized output buffer. The callers resolve the topic state.
+  std::shared_ptr<rosbag2_storage::SerializedBagMessage> convert_with(
+    const std::shared_ptr<const rosbag2_storage::SerializedBagMessage> & message,
+    const ConverterTypeSupport & type_support,
+    PooledConversionState & pool_state);
+
   std::shared_ptr<SerializationFormatConverterFactoryInterface> converter_factory_;
   std::unique_ptr<converter_interfaces::SerializationFormatDeserializer> input_converter_;
   std::unique_ptr<converter_interfaces::SerializationFormatSerializer> output_converter_;
   std::unordered_map<std::string, ConverterTypeSupport> topics_and_types_;
+  std::unordered_map<std::string, PooledConversionState> conversion_pool_;
+  // Input and output formats share the wire encoding; convert() relabels
+  // the messages instead of round-tripping them through deserialization.
+  bool passthrough_ = false;
 };
 
 }  // namespace rosbag2_cpp
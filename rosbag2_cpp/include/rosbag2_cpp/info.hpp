@@ -16,10 +16,12 @@
 #define ROSBAG2_CPP__INFO_HPP_
 
 #include <string>
+#include <vector>
 
 #include "rosbag2_cpp/visibility_control.hpp"
 
 #include "rosbag2_storage/bag_metadata.hpp"
+#include "rosbag2_storage/topic_statistics.hpp"
 
 namespace rosbag2_cpp
 {
@@ -31,6 +33,15 @@ public:
 
   virtual rosbag2_storage::BagMetadata read_metadata(
     const std::string & uri, const std::string & storage_id);
+
+  /**
+   * Per-topic message count, byte sum and time span of the bag, aggregated
+   * inside the storage plugin (one query per file) instead of reading every
+   * message to the client. Multi-file bags are aggregated across their
+   * splits. Average frequency and bandwidth derive from the returned spans.
+   */
+  virtual std::vector<rosbag2_storage::TopicStatistics> read_topic_statistics(
+    const std::string & uri, const std::string & storage_id);
 };
 
 }  // namespace rosbag2_cpp
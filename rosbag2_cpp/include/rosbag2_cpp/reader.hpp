@@ -26,6 +26,7 @@
 #include "rosbag2_cpp/visibility_control.hpp"
 
 #include "rosbag2_storage/bag_metadata.hpp"
+#include "rosbag2_storage/read_order.hpp"
 #include "rosbag2_storage/serialized_bag_message.hpp"
 #include "rosbag2_storage/storage_filter.hpp"
 #include "rosbag2_storage/topic_metadata.hpp"
@@ -110,6 +111,32 @@ public:
    */
   std::shared_ptr<rosbag2_storage::SerializedBagMessage> read_next();
 
+  /**
+   * Read up to max_batch_size messages from storage in one call.
+   * Returns fewer messages (possibly none) when the bag runs out; this is
+   * cheaper than calling read_next() per message when iterating large bags.
+   *
+   * \param max_batch_size upper bound for the number of messages returned
+   * \return next messages in serialized form
+   * \throws runtime_error if the Reader is not open.
+   */
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+  read_next_batch(size_t max_batch_size);
+
+  /**
+   * Read up to max_batch_size messages from storage into the given vector,
+   * clearing it first. The vector keeps its capacity across calls, so a
+   * caller looping over a bag reuses one buffer instead of receiving a
+   * fresh allocation per batch.
+   *
+   * \param max_batch_size upper bound for the number of messages returned
+   * \param batch filled with the next messages in serialized form
+   * \throws runtime_error if the Reader is not open.
+   */
+  void read_next_batch(
+    size_t max_batch_size,
+    std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> & batch);
+
   /**
     * Ask bagfile for its full metadata.
     *
@@ -139,6 +166,28 @@ public:
    */
   void reset_filter();
 
+  /**
+   * Reposition reading so the next message returned is the first one with a
+   * receive timestamp greater than or equal to the given one. Seeking
+   * backwards is allowed.
+   *
+   * \param timestamp to jump to, in nanoseconds since epoch
+   * \throws runtime_error if the Reader is not open or does not support seeking.
+   */
+  void seek(rcutils_time_point_value_t timestamp);
+
+  /**
+   * Select the direction in which read_next() walks the bag. Reverse
+   * reading repositions to the end of the bag (or to the seek target) and
+   * hands out messages in descending timestamp order, so stepping backwards
+   * through a bag is as cheap as stepping forward.
+   *
+   * \param read_order direction for subsequent reads
+   * \throws runtime_error if the Reader is not open or does not support the
+   * requested order.
+   */
+  void set_read_order(rosbag2_storage::ReadOrder read_order);
+
   reader_interfaces::BaseReaderInterface & get_implementation_handle() const
   {
     return *reader_impl_;
@@ -16,13 +16,17 @@
 #define ROSBAG2_CPP__READER_INTERFACES__BASE_READER_INTERFACE_HPP_
 
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
+#include "rcutils/time.h"
+
 #include "rosbag2_cpp/converter_options.hpp"
 #include "rosbag2_cpp/storage_options.hpp"
 #include "rosbag2_cpp/visibility_control.hpp"
 
 #include "rosbag2_storage/bag_metadata.hpp"
+#include "rosbag2_storage/read_order.hpp"
 #include "rosbag2_storage/serialized_bag_message.hpp"
 #include "rosbag2_storage/storage_filter.hpp"
 #include "rosbag2_storage/topic_metadata.hpp"
@@ -46,6 +50,36 @@ public:
 
   virtual std::shared_ptr<rosbag2_storage::SerializedBagMessage> read_next() = 0;
 
+  /**
+   * Read up to max_batch_size messages in one call.
+   */
+  virtual std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+  read_next_batch(size_t max_batch_size)
+  {
+    std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> batch;
+    read_next_batch(max_batch_size, batch);
+    return batch;
+  }
+
+  /**
+   * Read up to max_batch_size messages into the given vector, clearing it
+   * first. The vector keeps its capacity across calls, so a caller looping
+   * over a bag reuses one buffer instead of receiving a fresh allocation
+   * per batch. The default loops over read_next(); readers backed by a
+   * storage with a vectorized read path should override this and delegate
+   * to it.
+   */
+  virtual void read_next_batch(
+    size_t max_batch_size,
+    std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> & batch)
+  {
+    batch.clear();
+    batch.reserve(max_batch_size);
+    while (batch.size() < max_batch_size && has_next()) {
+      batch.push_back(read_next());
+    }
+  }
+
   virtual const rosbag2_storage::BagMetadata & get_metadata() const = 0;
 
   virtual std::vector<rosbag2_storage::TopicMetadata> get_all_topics_and_types() const = 0;
@@ -53,6 +87,30 @@ public:
   virtual void set_filter(const rosbag2_storage::StorageFilter & storage_filter) = 0;
 
   virtual void reset_filter() = 0;
+
+  /**
+   * Reposition reading so the next message returned is the first one with a
+   * receive timestamp greater than or equal to the given one. The default
+   * reports seeking as unsupported; readers backed by an indexed storage
+   * should override this.
+   */
+  virtual void seek(rcutils_time_point_value_t timestamp)
+  {
+    (void) timestamp;
+    throw std::runtime_error("Seeking is not supported by this reader.");
+  }
+
+  /**
+   * Select the direction in which read_next() walks the bag. The default
+   * only supports forward reading; readers backed by a storage with a
+   * reversible cursor should override this.
+   */
+  virtual void set_read_order(rosbag2_storage::ReadOrder read_order)
+  {
+    if (read_order != rosbag2_storage::ReadOrder::FORWARD) {
+      throw std::runtime_error("Reverse reading is not supported by this reader.");
+    }
+  }
 };
 
 }  // namespace reader_interfaces
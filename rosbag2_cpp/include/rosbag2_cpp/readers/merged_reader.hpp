@@ -0,0 +1,128 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_CPP__READERS__MERGED_READER_HPP_
+#define ROSBAG2_CPP__READERS__MERGED_READER_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rosbag2_cpp/reader_interfaces/base_reader_interface.hpp"
+#include "rosbag2_cpp/visibility_control.hpp"
+
+#include "rosbag2_storage/storage_filter.hpp"
+
+// This is necessary because of using stl types here. It is completely safe, because
+// a) the member is not accessible from the outside
+// b) there are no inline functions.
+#ifdef _WIN32
+# pragma warning(push)
+# pragma warning(disable:4251)
+#endif
+
+namespace rosbag2_cpp
+{
+namespace readers
+{
+
+/**
+ * Reader merging several bags into one timeline.
+ *
+ * Each bag is opened through its own underlying reader and their messages
+ * are handed out in a k-way merge by receive timestamp, so bags recorded
+ * separately (e.g. per subsystem) replay in exact global order behind the
+ * standard Reader interface with a single pacing loop.
+ *
+ * The merge buffers at most one message per bag; memory use is independent
+ * of bag sizes.
+ */
+class ROSBAG2_CPP_PUBLIC MergedReader
+  : public ::rosbag2_cpp::reader_interfaces::BaseReaderInterface
+{
+public:
+  /**
+   * \param readers the readers to merge; when empty (the default), one
+   * SequentialReader per bag is created in open().
+   */
+  explicit MergedReader(
+    std::vector<std::unique_ptr<reader_interfaces::BaseReaderInterface>> readers = {});
+
+  virtual ~MergedReader();
+
+  /**
+   * Open one bag per entry and prepare the merge. All bags share the
+   * converter options; their serialization formats may differ as long as
+   * each bag is internally consistent.
+   *
+   * \throws runtime_error if no bags are given, a bag cannot be opened, or
+   * two bags record the same topic with different types.
+   */
+  void open(
+    const std::vector<StorageOptions> & storage_options,
+    const ConverterOptions & converter_options);
+
+  // The single-bag open of the base interface; a merge of one.
+  void open(
+    const StorageOptions & storage_options, const ConverterOptions & converter_options) override;
+
+  void reset() override;
+
+  bool has_next() override;
+
+  std::shared_ptr<rosbag2_storage::SerializedBagMessage> read_next() override;
+
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+  read_next_batch(size_t max_batch_size) override;
+
+  void read_next_batch(
+    size_t max_batch_size,
+    std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> & batch) override;
+
+  /**
+   * Metadata aggregated over all opened bags: summed message counts, the
+   * union of topics, and the time range spanning the earliest and latest
+   * bag.
+   */
+  const rosbag2_storage::BagMetadata & get_metadata() const override;
+
+  std::vector<rosbag2_storage::TopicMetadata> get_all_topics_and_types() const override;
+
+  void set_filter(const rosbag2_storage::StorageFilter & storage_filter) override;
+
+  void reset_filter() override;
+
+  void seek(rcutils_time_point_value_t timestamp) override;
+
+private:
+  // Combine the per-bag metadata into merged_metadata_; throws on
+  // conflicting topic definitions across bags.
+  void merge_metadata();
+
+  std::vector<std::unique_ptr<reader_interfaces::BaseReaderInterface>> readers_{};
+  // Head message of each bag, i.e. the candidates of the timestamp merge.
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> heads_{};
+  rosbag2_storage::BagMetadata merged_metadata_{};
+  std::vector<rosbag2_storage::TopicMetadata> merged_topics_{};
+  bool open_{false};
+};
+
+}  // namespace readers
+}  // namespace rosbag2_cpp
+
+#ifdef _WIN32
+# pragma warning(pop)
+#endif
+
+#endif  // ROSBAG2_CPP__READERS__MERGED_READER_HPP_
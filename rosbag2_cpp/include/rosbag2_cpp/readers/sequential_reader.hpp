@@ -15,8 +15,10 @@
 #ifndef ROSBAG2_CPP__READERS__SEQUENTIAL_READER_HPP_
 #define ROSBAG2_CPP__READERS__SEQUENTIAL_READER_HPP_
 
+#include <future>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "rosbag2_cpp/converter.hpp"
@@ -25,6 +27,7 @@
 #include "rosbag2_cpp/serialization_format_converter_factory_interface.hpp"
 #include "rosbag2_cpp/visibility_control.hpp"
 
+#include "rosbag2_storage/io_statistics.hpp"
 #include "rosbag2_storage/metadata_io.hpp"
 #include "rosbag2_storage/storage_factory.hpp"
 #include "rosbag2_storage/storage_factory_interface.hpp"
@@ -43,6 +46,16 @@ namespace rosbag2_cpp
 {
 namespace readers
 {
+namespace details
+{
+// Maps the relative file paths of a bag's metadata onto openable paths,
+// honoring the pre-version-4 layout where they are prefixed with the bag
+// folder name. Shared with tools which process the split files directly.
+ROSBAG2_CPP_PUBLIC
+std::vector<std::string> resolve_relative_paths(
+  const std::string & base_folder, std::vector<std::string> relative_files,
+  const int version = 4);
+}  // namespace details
 
 class ROSBAG2_CPP_PUBLIC SequentialReader
   : public ::rosbag2_cpp::reader_interfaces::BaseReaderInterface
@@ -67,6 +80,13 @@ public:
 
   std::shared_ptr<rosbag2_storage::SerializedBagMessage> read_next() override;
 
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+  read_next_batch(size_t max_batch_size) override;
+
+  void read_next_batch(
+    size_t max_batch_size,
+    std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> & batch) override;
+
   const rosbag2_storage::BagMetadata & get_metadata() const override;
 
   std::vector<rosbag2_storage::TopicMetadata> get_all_topics_and_types() const override;
@@ -75,6 +95,29 @@ public:
 
   void reset_filter() override;
 
+  void seek(rcutils_time_point_value_t timestamp) override;
+
+  /**
+   * Select the direction in which read_next() walks the bag. Switching to
+   * reverse repositions to the last file of the bag (or to the file of the
+   * current seek target) and hands out messages in descending timestamp
+   * order; file rollovers then walk towards the first file.
+   *
+   * \param read_order direction for subsequent reads
+   * \throws runtime_error if the Reader is not open, the bag is sharded, or
+   * the storage does not support reverse reading.
+   */
+  void set_read_order(rosbag2_storage::ReadOrder read_order) override;
+
+  /**
+   * Cumulative I/O counters of the storage backing the current file, so
+   * monitoring can watch player I/O health at runtime.
+   *
+   * \return the storage plugin's statistics, or the zero-initialized
+   * default when the reader is not open.
+   */
+  rosbag2_storage::IOStatistics get_io_statistics() const;
+
   /**
    * Ask whether there is another database file to read from the list of relative
    * file paths.
@@ -103,6 +146,22 @@ protected:
   */
   virtual void load_next_file();
 
+  /**
+   * Open the storage of the next file in the background while the current
+   * file is still being read, so rolling over at a file boundary does not
+   * block read_next(). A no-op when there is no further file or a preload
+   * is already in flight.
+   */
+  virtual void preload_next_file();
+
+  /**
+   * Checks whether the file at the given index can contain messages inside
+   * the active time window (storage filter bounds and seek time). Returns
+   * true when no per-file time ranges are recorded in the metadata, so
+   * older bags are never pruned.
+   */
+  bool file_overlaps_time_window(size_t file_index) const;
+
   /**
    * Checks if all topics in the bagfile have the same RMW serialization format.
    * Currently a bag file can only be played if all topics have the same serialization format.
@@ -132,6 +191,23 @@ protected:
     */
   virtual void fill_topics_metadata();
 
+  /**
+   * Build the table translating the storage's per-file topic ids into ids
+   * interned by name for the lifetime of this reader. Storage plugins
+   * assign their ids per file, so the table must be rebuilt for every
+   * opened storage; an empty table means the storage does not expose ids.
+   */
+  std::vector<uint32_t> build_topic_id_remap(
+    const std::shared_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> & storage);
+
+  /**
+   * Translate a message's per-file topic id into the reader-stable interned
+   * id, or clear it when the file's table has no entry for it.
+   */
+  void remap_topic_id(
+    rosbag2_storage::SerializedBagMessage & message,
+    const std::vector<uint32_t> & topic_id_remap) const;
+
   std::unique_ptr<rosbag2_storage::StorageFactoryInterface> storage_factory_{};
   std::shared_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> storage_{};
   std::unique_ptr<Converter> converter_{};
@@ -140,6 +216,32 @@ protected:
   std::vector<rosbag2_storage::TopicMetadata> topics_metadata_{};
   std::vector<std::string> file_paths_{};  // List of database files.
   std::vector<std::string>::iterator current_file_iterator_{};  // Index of file to read from
+  // For bags written with storage sharding, all files are opened at once and
+  // their messages merged by timestamp instead of reading file after file.
+  std::vector<std::shared_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface>>
+  shard_storages_{};
+  // Head message of each shard, i.e. the candidates of the timestamp merge.
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> shard_heads_{};
+  // Numeric topic ids interned by name, stable for the lifetime of this
+  // reader; ids start at 1. The remap tables translate the per-file ids
+  // stamped by the storages into these, so consumers can key per-topic
+  // state by id across split files.
+  std::unordered_map<std::string, uint32_t> topic_ids_by_name_{};
+  // Remap table of the active storage (sequential reading).
+  std::vector<uint32_t> topic_id_remap_{};
+  // Remap table per shard storage (sharded reading).
+  std::vector<std::vector<uint32_t>> shard_topic_id_remaps_{};
+  // Active filter, reapplied when the reader rolls over to the next file.
+  rosbag2_storage::StorageFilter storage_filter_{};
+  // Timestamp of the last seek(); negative when reading was never seeked.
+  rcutils_time_point_value_t seek_time_{-1};
+  // Direction of reading; in reverse order has_next() rolls over towards
+  // the first file and the storages walk their cursors descending.
+  rosbag2_storage::ReadOrder read_order_{rosbag2_storage::ReadOrder::FORWARD};
+  // Storage of the next file of a split bag, opened in the background while
+  // the current file drains, so file transitions do not interrupt playback.
+  std::future<std::shared_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface>>
+  next_storage_future_{};
 
 private:
   std::shared_ptr<SerializationFormatConverterFactoryInterface> converter_factory_{};
@@ -95,14 +95,16 @@ private:
 
   std::vector<rcpputils::fs::path> get_database_files(const rcpputils::fs::path & base_folder);
 
-  void open(
+  // Opens a single database file read-only and returns its storage handle.
+  std::shared_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> open_file(
     const rcpputils::fs::path & database_file,
     const StorageOptions & storage_options);
 
   // Prepares the metadata by setting initial values.
   void init_metadata(const std::vector<rcpputils::fs::path> & files);
 
-  // Attempts to harvest metadata from all bag files, and aggregates the result
+  // Attempts to harvest metadata from all bag files in parallel,
+  // and aggregates the result in file order
   void aggregate_metadata(
     const std::vector<rcpputils::fs::path> & files, const StorageOptions & storage_options);
 
@@ -34,6 +34,26 @@ public:
 
   virtual std::unique_ptr<converter_interfaces::SerializationFormatSerializer>
   load_serializer(const std::string & format) = 0;
+
+  /**
+   * Probe whether messages serialized in the input format can be stored as
+   * the output format without re-encoding. The format strings of all rmw
+   * CDR variants name the same OMG CDR wire encoding, so converting between
+   * them is the identity and the deserialize/serialize round-trip can be
+   * skipped entirely.
+   */
+  virtual bool formats_are_byte_compatible(
+    const std::string & input_format, const std::string & output_format)
+  {
+    if (input_format == output_format) {
+      return true;
+    }
+    const auto is_cdr_variant = [](const std::string & format) {
+        return format == "cdr" ||
+               (format.size() > 4 && format.compare(format.size() - 4, 4, "_cdr") == 0);
+      };
+    return is_cdr_variant(input_format) && is_cdr_variant(output_format);
+  }
 };
 
 }  // namespace rosbag2_cpp
@@ -20,6 +20,20 @@
 namespace rosbag2_cpp
 {
 
+// Behavior of the write cache when the storage cannot keep up and the cache
+// would grow beyond its bound.
+enum class CacheOverflowPolicy
+{
+  // Keep accepting messages and let the cache grow (legacy behavior).
+  UNBOUNDED = 0,
+  // Block the writing thread until the cache was drained.
+  BLOCK = 1,
+  // Evict the oldest cached message.
+  DROP_OLDEST = 2,
+  // Evict the oldest cached message of the topic occupying the most cache.
+  DROP_LARGEST_TOPIC = 3,
+};
+
 struct StorageOptions
 {
 public:
@@ -34,10 +48,95 @@ public:
   // A value of 0 indicates that bagfile splitting will not be used.
   uint64_t max_bagfile_duration = 0;
 
+  // The maximum number of messages a bagfile can hold before it is split.
+  // Message-count splits produce files with predictable row counts for
+  // downstream consumers which shard their processing by message, and the
+  // check is a plain counter compare instead of a file size query.
+  // A value of 0 indicates that bagfile splitting will not be used.
+  uint64_t max_bagfile_messages = 0;
+
   // The cache size indiciates how many messages can maximally be hold in cache
   // before these being written to disk.
   // A value of 0 disables caching and every write happens directly to disk.
   uint64_t max_cache_size = 0;
+
+  // What to do when the storage falls behind and the write cache reaches
+  // twice max_cache_size: keep growing (default), block the caller or drop
+  // messages. Dropped messages are accounted per topic in the metadata.
+  CacheOverflowPolicy cache_overflow_policy = CacheOverflowPolicy::UNBOUNDED;
+
+  // Hard upper bound, in bytes, on the memory held by the write cache across
+  // both of its double buffers. When the storage stalls and the buffered
+  // bytes approach the budget, the writer first flushes early and then drops
+  // cached messages of the topics occupying the most cache, so that an I/O
+  // hiccup never grows the process beyond a fixed memory envelope.
+  // A value of 0 disables the watchdog. Must be larger than max_cache_size.
+  uint64_t cache_memory_budget = 0;
+
+  // Upper bound, in milliseconds, on how long a cached message may sit in
+  // RAM before it is flushed to the storage. The size threshold alone lets
+  // low-rate recordings buffer data for minutes (lost on a crash) and
+  // fires mid-burst on bursty ones; an age trigger bounds the durability
+  // latency independently of the throughput tuning. Serviced by the cache
+  // writer thread, so it only takes effect in cached mode (non-zero
+  // max_cache_size). A value of 0 flushes on the size threshold only.
+  uint64_t max_cache_age = 0;
+
+  // Path to a storage plugin specific configuration file (e.g. a list of
+  // sqlite PRAGMA statements) which is handed to the plugin before the
+  // bagfile is opened. An empty string keeps the plugin defaults.
+  std::string storage_config_uri = "";
+
+  // Number of storage instances to write in parallel, with the topics
+  // partitioned across them. A single storage connection serializes all
+  // inserts; sharding lets high-bandwidth recordings scale beyond one
+  // storage writer thread. 1 (default) keeps the regular single-file
+  // behavior; values greater than 1 require the ShardedSequentialWriter.
+  uint64_t storage_shard_count = 1;
+
+  // Seconds between periodic checkpoints of the bag metadata while the
+  // recording is running. A checkpoint writes the current metadata into a
+  // scratch file and atomically renames it over metadata.yaml, so a crashed
+  // recording loses at most the last interval of metadata instead of
+  // requiring a full reindex. When enabled, a checkpoint is also taken on
+  // every bagfile split. A value of 0 disables checkpointing; the metadata
+  // is then only written when the bag is closed.
+  uint64_t metadata_checkpoint_period = 0;
+
+  // Directory into which FILE-mode compressed splits are decompressed when
+  // the bag is read. Pointing this at a tmpfs keeps the scratch writes off
+  // the device the compressed bag is read from, so playback does not double
+  // the disk traffic. When set, each decompressed copy is also deleted once
+  // the read cursor moved past its split, so the scratch space needed is
+  // bounded by two splits; seeking back to an already-passed split is then
+  // not possible. An empty string keeps the legacy behavior of decompressing
+  // next to the original file and leaving the copies behind.
+  std::string decompression_scratch_directory = "";
+
+  // Tiered recording: when set, the active split file is written into this
+  // directory (meant to be a RAM-backed filesystem like /dev/shm) and a
+  // background migrator moves every sealed file into the bag directory once
+  // recording rolled over to the next split. The writing thread then never
+  // sees device latency spikes (e.g. SSD garbage-collection pauses); only
+  // the migrator does. Requires bagfile splitting, since an unsplit
+  // recording would have to fit into the RAM disk entirely. An empty string
+  // writes the active file into the bag directory directly.
+  std::string active_split_directory = "";
+
+  // Resume recording into an existing bag directory instead of refusing to
+  // open it: the saved metadata is loaded, the split sequence continues with
+  // the next file number and the per-topic message counts carry on where the
+  // previous session stopped. A recorder restart then extends the same
+  // logical bag instead of fragmenting the session into directories that
+  // need an offline merge. Opening a non-existing directory with this flag
+  // set simply starts a fresh bag.
+  bool append_mode = false;
+
+  // Flight-recorder style operation: instead of continuously persisting
+  // messages, keep the most recent `max_cache_size` bytes in a circular
+  // in-memory buffer and only write them to disk when a snapshot is
+  // triggered. Requires a non-zero max_cache_size.
+  bool snapshot_mode = false;
 };
 
 }  // namespace rosbag2_cpp
@@ -53,6 +53,14 @@ ROSBAG2_CPP_PUBLIC
 void allocate_internal_types(
   void * msg, const rosidl_typesupport_introspection_cpp::MessageMembers * members);
 
+/// Return a message to a pristine state for reuse: the contained ROS message
+/// is finalized and re-initialized in place, without releasing the outer
+/// allocation. Cheaper than deallocating and allocating a fresh message.
+ROSBAG2_CPP_PUBLIC
+void introspection_message_reset(
+  rosbag2_introspection_message_t * msg,
+  const rosidl_message_type_support_t * introspection_ts);
+
 ROSBAG2_CPP_PUBLIC
 void deallocate_introspection_message(
   rosbag2_introspection_message_t * msg,
@@ -40,6 +40,18 @@ get_typesupport_handle(
   const std::string & typesupport_identifier,
   std::shared_ptr<rcpputils::SharedLibrary> library);
 
+/// Resolve a typesupport handle through the process-wide registry: each
+/// (type, typesupport identifier) pair is resolved exactly once per process
+/// and shared by every consumer, so converters, publishers and
+/// subscriptions of the same type neither repeat the symbol lookup nor keep
+/// duplicate handle state. The backing library stays loaded for the
+/// lifetime of the process. Thread-safe.
+ROSBAG2_CPP_PUBLIC
+const rosidl_message_type_support_t *
+get_typesupport_handle(
+  const std::string & type,
+  const std::string & typesupport_identifier);
+
 ROSBAG2_CPP_PUBLIC
 const std::tuple<std::string, std::string, std::string>
 extract_type_identifier(const std::string & full_type);
@@ -16,6 +16,7 @@
 #define ROSBAG2_CPP__WRITER_HPP_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -46,6 +47,12 @@ class BaseWriterInterface;
 /**
  * The Writer allows writing messages to a new bag. For every topic, information about its type
  * needs to be added before writing the first message.
+ *
+ * Messages may be written from multiple threads concurrently, e.g. by a
+ * recorder running on a multithreaded executor: writers with a
+ * multi-producer intake take concurrent write() calls directly, for all
+ * other writers (and for the structural calls like create_topic) the facade
+ * serializes internally.
  */
 class ROSBAG2_CPP_PUBLIC Writer final
 {
@@ -109,6 +116,46 @@ public:
    */
   void write(std::shared_ptr<rosbag2_storage::SerializedBagMessage> message);
 
+  /**
+   * Write a message to a bagfile, taking ownership of the message by move.
+   * Avoids the shared_ptr wrapping (and its refcount traffic) on the caller
+   * side of the recording hot path.
+   *
+   * \param message to be written to the bagfile
+   * \throws runtime_error if the Writer is not open.
+   */
+  void write(rosbag2_storage::SerializedBagMessage && message);
+
+  /**
+   * Trigger a snapshot when the underlying writer operates in snapshot mode.
+   *
+   * \return true if buffered messages were persisted to the bagfile.
+   */
+  bool take_snapshot();
+
+  /**
+   * Trigger a bagfile split on demand, closing the active file and
+   * continuing the recording in the next one. Writers without splitting
+   * support ignore the request.
+   *
+   * \throws runtime_error if the Writer is not open.
+   */
+  void split_bagfile();
+
+  /**
+   * Seal the current bag (metadata finalized and written) and continue the
+   * recording in a fresh bag session under the given base folder, keeping
+   * the topic registrations so no message is dropped across the transition.
+   * Meant for hot rotation to a new directory or target disk without
+   * stopping the recording.
+   *
+   * \param new_base_folder base folder of the new bag session; must not
+   * exist yet.
+   * \throws runtime_error if the Writer is not open, rotation fails, or the
+   * underlying writer does not support rotation.
+   */
+  void rotate_bag(const std::string & new_base_folder);
+
   writer_interfaces::BaseWriterInterface & get_implementation_handle() const
   {
     return *writer_impl_;
@@ -116,6 +163,13 @@ public:
 
 private:
   std::unique_ptr<rosbag2_cpp::writer_interfaces::BaseWriterInterface> writer_impl_;
+  // Serializes concurrent calls for everything the writer implementation
+  // does not handle itself; write() skips the lock when the implementation
+  // declared itself multi-producer safe.
+  std::mutex writer_mutex_;
+  // Queried once at open(); see
+  // BaseWriterInterface::is_write_concurrency_supported().
+  bool concurrent_writes_supported_ {false};
 };
 
 }  // namespace rosbag2_cpp
@@ -15,7 +15,12 @@
 #ifndef ROSBAG2_CPP__WRITER_INTERFACES__BASE_WRITER_INTERFACE_HPP_
 #define ROSBAG2_CPP__WRITER_INTERFACES__BASE_WRITER_INTERFACE_HPP_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 #include "rosbag2_cpp/converter_options.hpp"
 #include "rosbag2_cpp/storage_options.hpp"
@@ -26,6 +31,19 @@
 
 namespace rosbag2_cpp
 {
+
+// Details of a bagfile which was sealed, i.e. closed and guaranteed not to
+// change anymore, e.g. because recording rolled over to the next split or
+// because a closed split finished compressing.
+struct SealedBagfileInfo
+{
+  std::string file_path;
+  uint64_t file_size = 0;
+  // Time range of the messages in the file, in nanoseconds since epoch.
+  int64_t starting_time_ns = 0;
+  int64_t ending_time_ns = 0;
+};
+
 namespace writer_interfaces
 {
 
@@ -44,6 +62,69 @@ public:
   virtual void remove_topic(const rosbag2_storage::TopicMetadata & topic_with_type) = 0;
 
   virtual void write(std::shared_ptr<rosbag2_storage::SerializedBagMessage> message) = 0;
+
+  // Move-enabled overload: takes ownership of the message without requiring
+  // the caller to wrap it into a shared_ptr first.
+  virtual void write(rosbag2_storage::SerializedBagMessage && message)
+  {
+    write(std::make_shared<rosbag2_storage::SerializedBagMessage>(std::move(message)));
+  }
+
+  // Whether write() may be called concurrently from multiple threads.
+  // Writers with a multi-producer intake return true; the Writer facade
+  // then forwards write() without serializing it. All other calls still
+  // need external serialization.
+  virtual bool is_write_concurrency_supported() const {return false;}
+
+  // Interned numeric id the writer assigned to a topic on create_topic,
+  // or 0 when the topic is unknown or the writer does not intern ids.
+  // Producers can stamp the id into SerializedBagMessage::topic_id to spare
+  // the write hot path a by-name topic lookup per message.
+  virtual uint32_t get_topic_id(const std::string &) const {return 0u;}
+
+  // Persist the current snapshot buffer, if the writer operates in snapshot
+  // mode. Returns false if nothing was written.
+  virtual bool take_snapshot() {return false;}
+
+  // Number of bytes currently buffered by the writer and not yet persisted
+  // to storage. Intended for instrumentation; cheap enough to sample
+  // periodically while recording.
+  virtual uint64_t get_cache_size() {return 0u;}
+
+  // Trigger a bagfile split on demand, closing the active file and
+  // continuing the recording in the next one. Writers without splitting
+  // support ignore the request.
+  virtual void split_bagfile() {}
+
+  // Seal the current bag (metadata finalized and written) and continue the
+  // recording in a fresh bag session under the given base folder, keeping
+  // the topic registrations so no message is dropped across the transition.
+  // Unlike an ignored split, silently continuing into the old folder would
+  // defeat the point of rotating (e.g. to a fresh disk), so writers without
+  // rotation support throw.
+  virtual void rotate_bag(const std::string & new_base_folder)
+  {
+    (void) new_base_folder;
+    throw std::runtime_error("Bag rotation is not supported by this writer.");
+  }
+
+  // Record the number of messages the middleware reported lost on the
+  // recording subscription of a topic, for the final metadata. Expected to
+  // be called with the total count before the bag is closed; writers without
+  // metadata support ignore it.
+  virtual void set_topic_rmw_lost_count(const std::string & topic_name, uint64_t lost_count)
+  {
+    (void) topic_name;
+    (void) lost_count;
+  }
+
+  // Register a callback invoked whenever a bagfile is sealed, so e.g. an
+  // upload pipeline can pick up closed splits while recording continues.
+  // The callback may be invoked from internal writer threads.
+  virtual void set_sealed_file_callback(std::function<void(const SealedBagfileInfo &)> callback)
+  {
+    (void) callback;
+  }
 };
 
 }  // namespace writer_interfaces
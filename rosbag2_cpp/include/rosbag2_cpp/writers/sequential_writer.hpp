@@ -15,8 +15,16 @@
 #ifndef ROSBAG2_CPP__WRITERS__SEQUENTIAL_WRITER_HPP_
 #define ROSBAG2_CPP__WRITERS__SEQUENTIAL_WRITER_HPP_
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -26,6 +34,7 @@
 #include "rosbag2_cpp/writer_interfaces/base_writer_interface.hpp"
 #include "rosbag2_cpp/visibility_control.hpp"
 
+#include "rosbag2_storage/io_statistics.hpp"
 #include "rosbag2_storage/metadata_io.hpp"
 #include "rosbag2_storage/storage_factory.hpp"
 #include "rosbag2_storage/storage_factory_interface.hpp"
@@ -97,13 +106,91 @@ public:
   /**
    * Write a message to a bagfile. The topic needs to have been created before writing is possible.
    *
+   * write() may be called concurrently from multiple threads, e.g. the
+   * callback threads of a multithreaded executor. Messages are staged in
+   * per-topic intake lanes, so concurrent producers only contend when their
+   * topics share a lane; there is no global lock on the hot path. Without a
+   * write cache (max_cache_size of 0) concurrent writes serialize on the
+   * storage instead.
+   *
    * \param message to be written to the bagfile
    * \throws runtime_error if the Writer is not open.
    */
   void write(std::shared_ptr<rosbag2_storage::SerializedBagMessage> message) override;
 
+  /**
+   * write() is multi-producer safe, see write().
+   */
+  bool is_write_concurrency_supported() const override;
+
+  /**
+   * Interned numeric id assigned to a topic by create_topic. Producers can
+   * stamp the id into SerializedBagMessage::topic_id so the write hot path
+   * resolves the topic without hashing its name per message.
+   *
+   * \return the topic's id, or 0 if the topic was not created.
+   */
+  uint32_t get_topic_id(const std::string & topic_name) const override;
+
+  /**
+   * Flush the circular snapshot buffer through the storage batch-write path.
+   * Only valid when the writer was opened with snapshot_mode enabled.
+   *
+   * \return true if messages were persisted, false if the buffer was empty
+   * or snapshot mode is disabled.
+   */
+  bool take_snapshot() override;
+
+  /**
+   * Number of bytes currently held in the write (or snapshot) cache.
+   */
+  uint64_t get_cache_size() override;
+
+  /**
+   * Cumulative I/O counters of the underlying storage since it was opened,
+   * so monitoring can watch recorder I/O health at runtime.
+   *
+   * \return the storage plugin's statistics, or the zero-initialized
+   * default when the writer is not open.
+   */
+  rosbag2_storage::IOStatistics get_io_statistics();
+
+  /**
+   * Record the number of messages the middleware reported lost on the
+   * recording subscription of a topic; the count ends up in the topic's
+   * metadata entry. Call with the total count before the bag is closed.
+   * Counts for topics the writer does not know are dropped.
+   */
+  void set_topic_rmw_lost_count(const std::string & topic_name, uint64_t lost_count) override;
+
+  /**
+   * Register a callback invoked whenever a bagfile is sealed, i.e. on every
+   * split and when the bag is closed. Register it before messages are
+   * written; registration is not synchronized against concurrent splits.
+   */
+  void set_sealed_file_callback(
+    std::function<void(const SealedBagfileInfo &)> callback) override;
+
+  /**
+   * Seal the current bag - its metadata finalized and written - and
+   * continue the recording in a fresh bag session under the given base
+   * folder. The topic registrations carry over to the new session, so no
+   * producer has to resubscribe and no message is dropped across the
+   * transition; only the per-session counters restart. Meant for hot
+   * rotation to a new directory or target disk without stopping the
+   * recording.
+   *
+   * \param new_base_folder base folder of the new bag session; must not
+   * exist yet.
+   * \throws runtime_error if the Writer is not open, rotation fails, or the
+   * writer runs in snapshot mode.
+   */
+  void rotate_bag(const std::string & new_base_folder) override;
+
 protected:
   std::string base_folder_;
+  // Storage plugin configuration file, reused when opening split files.
+  std::string storage_config_uri_;
   std::unique_ptr<rosbag2_storage::StorageFactoryInterface> storage_factory_;
   std::shared_ptr<SerializationFormatConverterFactoryInterface> converter_factory_;
   std::shared_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface> storage_;
@@ -117,30 +204,293 @@ protected:
   // specifies the best-effort maximum duration of a bagfile in seconds.
   std::chrono::seconds max_bagfile_duration;
 
+  // Used in bagfile splitting; maximum number of messages per bagfile,
+  // 0 disables splitting by message count.
+  uint64_t max_bagfile_messages_ {0};
+
   // Intermediate cache to write multiple messages into the storage.
   // `max_cache_size` is the number of bytes of messages to hold in storage
   // before writing to disk.
+  // The cache is double-buffered and multi-producer: concurrent write()
+  // calls append to the intake lane owning their topic, each under its own
+  // lock, while a dedicated writer thread collects all lanes into
+  // `secondary_cache_` and drains it into the storage, so that a flush never
+  // stalls message intake and producers never share a global lock.
   uint64_t max_cache_size_;
+  // Bytes currently held in the snapshot buffer. Guarded by cache_mutex_.
   uint64_t current_cache_size_;
-  std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> cache_;
+
+  // One intake lane of the write cache. Messages are assigned to lanes by
+  // their interned topic id, which spreads concurrent producers across the
+  // lane locks while preserving per-topic ordering.
+  struct IntakeShard
+  {
+    std::mutex mutex;
+    // Signals producers blocked by CacheOverflowPolicy::BLOCK that the
+    // lanes were drained.
+    std::condition_variable drained_condition;
+    std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> buffer;
+    // Bytes currently held in this lane. Guarded by the lane's mutex.
+    uint64_t bytes {0};
+  };
+  std::vector<std::unique_ptr<IntakeShard>> intake_shards_;
+  // Bytes buffered across all intake lanes; the flush trigger.
+  std::atomic<uint64_t> intake_bytes_ {0};
+
+  std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> secondary_cache_;
+  // Flat array of raw pointers into secondary_cache_, refilled per flush and
+  // handed to the storage as a non-owning span; only the writer thread
+  // touches it, and its capacity is retained across flushes.
+  std::vector<const rosbag2_storage::SerializedBagMessage *> secondary_cache_view_;
+
+  // Memory watchdog: hard budget for the bytes held across both cache
+  // buffers, 0 when disabled. The watchdog escalates from early flushing to
+  // dropping cached messages of the largest topics, so a storage stall never
+  // grows the cache beyond the budget.
+  uint64_t cache_memory_budget_ {0};
+  // Bytes currently held in secondary_cache_ while the writer thread drains
+  // it. Atomic so producers can include it in their budget checks.
+  std::atomic<uint64_t> secondary_cache_size_ {0};
+  // Asks the cache writer thread to flush before max_cache_size_ is reached.
+  // Cleared when the lanes are collected.
+  std::atomic<bool> flush_requested_ {false};
+  // Age trigger of the cache: a flush is also due once the oldest staged
+  // message is older than this. Zero disables the trigger.
+  std::chrono::milliseconds max_cache_age_ {0};
+  // Steady-clock stamp, in nanoseconds, of the oldest message staged since
+  // the last collection; 0 while nothing was staged. Set by the first
+  // producer after a flush, reset by the cache writer thread.
+  std::atomic<int64_t> oldest_staged_ns_ {0};
+  // Number of times the buffered bytes crossed the early-flush level.
+  std::atomic<uint64_t> cache_pressure_events_ {0};
+  // Messages dropped by the watchdog because the budget was exhausted.
+  std::atomic<uint64_t> budget_dropped_messages_ {0};
+
+  // Flight-recorder operation: write() fills this bounded circular buffer
+  // (evicting oldest) and messages only reach the storage on take_snapshot().
+  bool snapshot_mode_ {false};
+  std::deque<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> snapshot_buffer_;
+
+  // Synchronization between the producers filling the intake lanes and the
+  // writer thread draining `secondary_cache_`. cache_mutex_ also guards the
+  // snapshot buffer.
+  std::thread cache_writer_thread_;
+  std::mutex cache_mutex_;
+  std::condition_variable cache_condition_;
+  std::atomic<bool> stop_cache_writer_ {false};
+
+  // Serializes direct (uncached) writes, which mutate the metadata and the
+  // storage inline; the multi-producer intake only exists in cached mode.
+  std::mutex direct_write_mutex_;
+
+  // The serialization format converters are stateful, so concurrent writes
+  // serialize their conversion. Recordings without format conversion never
+  // take this lock.
+  std::mutex converter_mutex_;
+
+  // Behavior when the cache reaches twice max_cache_size_ because the
+  // storage cannot keep up.
+  CacheOverflowPolicy cache_overflow_policy_ {CacheOverflowPolicy::UNBOUNDED};
+
+  // Serializes storage access between the writer thread and calls which
+  // exchange the storage (e.g. bagfile splitting).
+  std::mutex storage_mutex_;
+
+  // Storage for the next split file, pre-opened (including topic creation)
+  // on a background thread once the active file approaches its size limit,
+  // so the split itself is just a pointer swap.
+  std::future<std::shared_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface>>
+  next_storage_future_;
 
   // Used to track topic -> message count
   std::unordered_map<std::string, rosbag2_storage::TopicInformation> topics_names_to_info_;
 
+  // Id-indexed view into topics_names_to_info_ for messages carrying an
+  // interned topic id; slot 0 is unused ("not assigned") and removed topics
+  // leave a null slot. The map's pointers are stable across rehashing.
+  std::vector<rosbag2_storage::TopicInformation *> topics_by_id_;
+
   rosbag2_storage::BagMetadata metadata_;
 
+  // Protects metadata_, topics_names_to_info_ and topics_by_id_ against
+  // concurrent producers, the cache writer thread updating the counters and
+  // the metadata checkpoint thread reading them.
+  mutable std::mutex metadata_mutex_;
+
+  // Periodic metadata checkpointing: every metadata_checkpoint_period_ and
+  // on every split, the current metadata is written to a scratch file and
+  // atomically renamed over metadata.yaml, so a crashed recording needs at
+  // most the last interval reindexed. Zero period disables checkpointing.
+  std::chrono::seconds metadata_checkpoint_period_ {0};
+  std::thread metadata_checkpoint_thread_;
+  std::mutex metadata_checkpoint_control_mutex_;
+  // Serializes the checkpoint thread and split-triggered checkpoints, which
+  // share the scratch directory.
+  std::mutex metadata_checkpoint_write_mutex_;
+  std::condition_variable metadata_checkpoint_condition_;
+  bool stop_metadata_checkpointing_ {false};
+
+  // Invoked with the details of every sealed bagfile, if registered.
+  std::function<void(const SealedBagfileInfo &)> sealed_file_callback_;
+
+  // Tiered recording: when non-empty, the active split file lives in this
+  // (RAM-backed) directory and the file migrator thread moves every sealed
+  // file into base_folder_, so the writing threads never see device latency
+  // spikes; only the migrator does.
+  std::string active_split_directory_;
+
+  // One sealed file waiting to be moved into the bag directory.
+  struct FileMigration
+  {
+    std::string source_path;
+    // Captured when the file is sealed, so a rotation moving base_folder_
+    // on cannot redirect an already queued migration.
+    std::string destination_folder;
+    uint64_t file_size;
+    int64_t starting_time_ns;
+    int64_t ending_time_ns;
+  };
+  std::thread file_migrator_thread_;
+  std::mutex file_migrator_mutex_;
+  std::condition_variable file_migrator_condition_;
+  std::deque<FileMigration> pending_migrations_;
+  bool stop_file_migrator_ {false};
+
+  // Time range of the messages written to the active bagfile, maintained by
+  // write() and restarted on every split.
+  int64_t file_start_time_ns_ {INT64_MAX};
+  int64_t file_end_time_ns_ {INT64_MIN};
+
+  // Number of messages written to the active bagfile, reset on every split.
+  // Only touched by the thread doing the storage writes (the cache writer
+  // thread, or the direct path under direct_write_mutex_).
+  uint64_t file_message_count_ {0};
+
+  // Invokes the sealed-file callback, if one was registered.
+  void notify_file_sealed(
+    const std::string & file_path, uint64_t file_size,
+    int64_t starting_time_ns, int64_t ending_time_ns);
+
+  // Builds the uri of split file number storage_count, placing it into the
+  // active-split directory when tiered recording is enabled.
+  std::string format_active_storage_uri(uint64_t storage_count) const;
+
+  // Hands a sealed file to the migrator thread in tiered mode; otherwise
+  // invokes the sealed-file callback directly. The sealed-file notification
+  // is deferred until after the move, so callbacks see the final location.
+  void migrate_or_notify_sealed_file(
+    const std::string & file_path, const std::string & destination_folder,
+    uint64_t file_size, int64_t starting_time_ns, int64_t ending_time_ns);
+
+  // Starts and stops the thread migrating sealed files out of the
+  // active-split directory; stopping drains the pending migrations.
+  void start_file_migrator();
+  void stop_file_migrator();
+
+  // Body of the file migrator thread.
+  void file_migrator_loop();
+
+  // Moves one sealed file into the bag directory (rename when both live on
+  // the same filesystem, copy and remove across the RAM-disk boundary) and
+  // fires the sealed-file notification with the final path.
+  void migrate_file(const FileMigration & migration);
+
+  // Restarts the per-file message time range tracking for the next file.
+  void restart_file_time_range();
+
   // Closes the current backed storage and opens the next bagfile.
-  virtual void split_bagfile();
+  void split_bagfile() override;
+
+  // Starts the dedicated thread draining the write cache into the storage.
+  void start_cache_writer();
+
+  // Stops the cache writer thread after flushing all pending messages.
+  void stop_cache_writer();
+
+  // Whether the oldest staged message exceeded max_cache_age_, making a
+  // flush due regardless of the buffered bytes.
+  bool cache_age_exceeded() const;
+
+  // Body of the cache writer thread; collects the intake lanes into the
+  // secondary buffer, books the per-batch metadata and drains the batch
+  // through the storage batch-write path. Bagfile split decisions also live
+  // here, so a single thread serializes them with the flushes.
+  void cache_writer_loop();
+
+  // Evicts one message from the given overflowing intake lane according to
+  // the drop policy and updates the per-topic drop counters.
+  // Must be called with the lane's mutex held; takes metadata_mutex_.
+  void drop_from_cache(CacheOverflowPolicy policy, IntakeShard & shard);
+
+  // Memory watchdog: keeps the bytes buffered across the intake lanes and
+  // the secondary buffer within cache_memory_budget_, escalating from an
+  // early flush request to dropping cached messages of the largest topics.
+  // A producer can only shed messages of its own lane; the remaining lanes
+  // shed when their producers next write or the flush catches up.
+  // Must be called with the lane's mutex held.
+  void enforce_cache_memory_budget(IntakeShard & shard);
 
   // Checks if the current recording bagfile needs to be split and rolled over to a new file.
   bool should_split_bagfile() const;
 
+  // Checks if the next split file should be pre-opened on a background thread.
+  bool should_prepare_next_storage() const;
+
+  // Kicks off the background open of the next split file.
+  void prepare_next_storage();
+
   // Prepares the metadata by setting initial values.
   virtual void init_metadata();
 
+  // Append-mode counterpart of init_metadata(): extends the metadata loaded
+  // from the existing bag with the new active file and re-registers the
+  // saved topics, so the split sequence and the per-topic message counts
+  // continue where the previous session stopped.
+  void continue_metadata();
+
   // Record TopicInformation into metadata
   void finalize_metadata();
 
+  // Copies the active file's message time range into its metadata_.files
+  // entry. Must be called with metadata_mutex_ held while the bag is being
+  // written to.
+  void record_active_file_range();
+
+  // Rebuilds topics_with_message_count and message_count in metadata_ from
+  // the per-topic bookkeeping. Must be called with metadata_mutex_ held
+  // while the bag is being written to.
+  void aggregate_topic_counts();
+
+  // Accumulates one persisted message into the topic's log2 size histogram
+  // and maintains the exact maximum; messages without a payload are not
+  // counted. Must run under the same protection as the message count.
+  static void record_message_size(
+    rosbag2_storage::TopicInformation & info,
+    const rosbag2_storage::SerializedBagMessage & message);
+
+  // Derives the percentile summary persisted in the metadata from a topic's
+  // size histogram: each percentile reports the upper bound of the bucket
+  // holding it, clamped to the exact maximum.
+  static void summarize_message_sizes(rosbag2_storage::TopicInformation & info);
+
+  // Snapshots the current metadata and atomically replaces the bag's
+  // metadata files with it.
+  void checkpoint_metadata();
+
+  // Starts and stops the thread taking periodic metadata checkpoints.
+  void start_metadata_checkpointing();
+  void stop_metadata_checkpointing();
+
+  // Body of the metadata checkpoint thread.
+  void metadata_checkpoint_loop();
+
+  // Resolves the TopicInformation entry of a message, via the id-indexed
+  // view when the message carries an interned topic id and by name lookup
+  // otherwise. Throws if the topic was never created.
+  // Must be called with metadata_mutex_ held.
+  rosbag2_storage::TopicInformation & topic_info_for(
+    const rosbag2_storage::SerializedBagMessage & message);
+
   // Helper method used by write to get the message in a format that is ready to be written.
   // Common use cases include converting the message using the converter or
   // performing other operations like compression on it
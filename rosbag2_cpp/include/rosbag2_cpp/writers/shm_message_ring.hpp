@@ -0,0 +1,128 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_CPP__WRITERS__SHM_MESSAGE_RING_HPP_
+#define ROSBAG2_CPP__WRITERS__SHM_MESSAGE_RING_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rosbag2_cpp/visibility_control.hpp"
+
+namespace rosbag2_cpp
+{
+namespace writers
+{
+
+/// Record types carried through the ring between the recording process and
+/// the out-of-process writer. Records are applied by the writer process in
+/// the order they were pushed.
+enum class ShmRecordType : uint32_t
+{
+  /// Serialized storage options and serialization format; opens the bag.
+  OPEN = 1,
+  /// Serialized TopicMetadata; registers a topic with the writer.
+  CREATE_TOPIC,
+  /// Serialized TopicMetadata; removes a topic again.
+  REMOVE_TOPIC,
+  /// One serialized bag message.
+  MESSAGE,
+  /// Close the active bagfile and continue in the next one.
+  SPLIT_BAGFILE,
+  /// Close the bag and exit the writer process.
+  SHUTDOWN,
+};
+
+/// \name Record payload framing helpers
+/// Record payloads are flat byte vectors of length-prefixed strings and
+/// little-endian integers, built and consumed with these helpers by both
+/// sides of the ring.
+/// \{
+ROSBAG2_CPP_PUBLIC void append_uint64(std::vector<uint8_t> & payload, uint64_t value);
+ROSBAG2_CPP_PUBLIC void append_string(std::vector<uint8_t> & payload, const std::string & value);
+ROSBAG2_CPP_PUBLIC uint64_t read_uint64(const std::vector<uint8_t> & payload, size_t & offset);
+ROSBAG2_CPP_PUBLIC std::string read_string(const std::vector<uint8_t> & payload, size_t & offset);
+/// \}
+
+/**
+ * Single-producer single-consumer byte ring in POSIX shared memory, carrying
+ * variable-size records across process boundaries.
+ *
+ * The producer creates the ring (and unlinks it on destruction), the
+ * consumer attaches to it by name. Positions are monotonically increasing
+ * byte offsets kept as atomics in the shared control block; records may wrap
+ * around the buffer end. Waiting is done by sleeping briefly instead of via
+ * futexes, which keeps the implementation portable across rmw platforms and
+ * robust against a crashed peer holding a lock.
+ *
+ * Concurrent pushes (or concurrent pops) must be serialized by the caller;
+ * only one producer thread and one consumer thread may touch the ring at a
+ * time.
+ */
+class ROSBAG2_CPP_PUBLIC ShmMessageRing
+{
+public:
+  /// Create a new ring of the given payload capacity. Producer side.
+  static std::unique_ptr<ShmMessageRing> create(const std::string & name, size_t capacity);
+
+  /// Attach to a ring created by another process. Consumer side.
+  static std::unique_ptr<ShmMessageRing> attach(const std::string & name);
+
+  ~ShmMessageRing();
+
+  /**
+   * Copy one record into the ring.
+   *
+   * Blocks while the ring is full.
+   *
+   * \return false if the record did not fit within the timeout.
+   * \throws std::runtime_error if the record is larger than the ring.
+   */
+  bool push(
+    ShmRecordType type, const uint8_t * payload, size_t size,
+    std::chrono::milliseconds timeout);
+
+  /**
+   * Take the next record out of the ring.
+   *
+   * \return false if no record arrived within the timeout.
+   */
+  bool pop(ShmRecordType & type, std::vector<uint8_t> & payload, std::chrono::milliseconds timeout);
+
+  const std::string & name() const {return name_;}
+
+private:
+  ShmMessageRing(const std::string & name, void * mapping, size_t mapping_size, bool owner);
+
+  struct Control;
+  Control * control() const;
+  uint8_t * data() const;
+  // Modular copies handling records that wrap around the buffer end.
+  void copy_in(uint64_t position, const uint8_t * source, size_t size);
+  void copy_out(uint64_t position, uint8_t * destination, size_t size) const;
+
+  std::string name_;
+  void * mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+  // The creating side unlinks the shared memory object on destruction.
+  bool owner_ = false;
+};
+
+}  // namespace writers
+}  // namespace rosbag2_cpp
+
+#endif  // ROSBAG2_CPP__WRITERS__SHM_MESSAGE_RING_HPP_
@@ -0,0 +1,112 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_CPP__WRITERS__SHM_RELAY_WRITER_HPP_
+#define ROSBAG2_CPP__WRITERS__SHM_RELAY_WRITER_HPP_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rosbag2_cpp/converter_options.hpp"
+#include "rosbag2_cpp/storage_options.hpp"
+#include "rosbag2_cpp/visibility_control.hpp"
+#include "rosbag2_cpp/writer_interfaces/base_writer_interface.hpp"
+#include "rosbag2_cpp/writers/shm_message_ring.hpp"
+
+#include "rosbag2_storage/serialized_bag_message.hpp"
+#include "rosbag2_storage/topic_metadata.hpp"
+
+namespace rosbag2_cpp
+{
+namespace writers
+{
+
+/**
+ * Writer front-end which runs the actual storage writer in a separate
+ * process and relays every call to it through a shared-memory message ring.
+ *
+ * open() creates the ring and spawns the `rosbag2_writer_process` helper
+ * (installed with this package), which attaches to the ring and drains it
+ * into a SequentialWriter. A storage stall or writer crash therefore never
+ * blocks or takes down the recording process: ingestion keeps running
+ * against the ring, and a dead writer process is respawned transparently,
+ * continuing the recording in a fresh bag directory.
+ *
+ * Only supported on POSIX platforms; open() throws on Windows.
+ */
+class ROSBAG2_CPP_PUBLIC ShmRelayWriter
+  : public writer_interfaces::BaseWriterInterface
+{
+public:
+  explicit ShmRelayWriter(size_t ring_capacity = DEFAULT_RING_CAPACITY);
+
+  ~ShmRelayWriter() override;
+
+  void open(
+    const StorageOptions & storage_options, const ConverterOptions & converter_options) override;
+
+  void reset() override;
+
+  void create_topic(const rosbag2_storage::TopicMetadata & topic_with_type) override;
+
+  void remove_topic(const rosbag2_storage::TopicMetadata & topic_with_type) override;
+
+  void write(std::shared_ptr<rosbag2_storage::SerializedBagMessage> message) override;
+
+  void split_bagfile() override;
+
+  static constexpr size_t DEFAULT_RING_CAPACITY = 64 * 1024 * 1024;
+
+private:
+  // Serializes one call into a record and pushes it, respawning the writer
+  // process if the push times out because the consumer died.
+  void push_record(ShmRecordType type, const std::vector<uint8_t> & payload);
+
+  void spawn_writer_process();
+
+  // Re-pushes the OPEN record (with a fresh output uri) and all known
+  // topics after the writer process was respawned.
+  void reopen_after_respawn();
+
+  static std::vector<uint8_t> serialize_open_record(
+    const StorageOptions & storage_options, const ConverterOptions & converter_options);
+  static std::vector<uint8_t> serialize_topic(const rosbag2_storage::TopicMetadata & topic);
+
+  std::unique_ptr<ShmMessageRing> ring_;
+  size_t ring_capacity_;
+
+  // create_topic and write arrive from different recorder threads; the ring
+  // is single-producer, so pushes are serialized here.
+  std::mutex producer_mutex_;
+
+  StorageOptions storage_options_;
+  ConverterOptions converter_options_;
+  // Topics announced so far, replayed into a respawned writer process.
+  std::map<std::string, rosbag2_storage::TopicMetadata> known_topics_;
+
+  // Pid of the writer process, or -1 when none is running.
+  int64_t writer_pid_ = -1;
+  // Counts writer respawns; suffixed to the output uri of each restarted
+  // bag so a respawned writer never collides with the directory the dead
+  // one may have left half-written.
+  unsigned int respawn_count_ = 0;
+};
+
+}  // namespace writers
+}  // namespace rosbag2_cpp
+
+#endif  // ROSBAG2_CPP__WRITERS__SHM_RELAY_WRITER_HPP_
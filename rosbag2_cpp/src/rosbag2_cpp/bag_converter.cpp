@@ -0,0 +1,281 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_cpp/bag_converter.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rosbag2_cpp/converter.hpp"
+#include "rosbag2_cpp/converter_options.hpp"
+#include "rosbag2_cpp/logging.hpp"
+
+namespace rosbag2_cpp
+{
+
+namespace
+{
+// Per-worker queue bound; a reader that runs far ahead of a worker blocks
+// instead of buffering without limit.
+constexpr const size_t kWorkerQueueCapacity = 256;
+
+// Width of the sequence window of converted messages waiting for their turn
+// in the sequence-ordered write. Workers block while their message lies
+// beyond the window. Admission is gated by sequence, not by buffer size: the
+// message the writer needs next is always admissible, so a slow worker
+// holding it can never be locked out by faster workers filling the buffer
+// with later sequences.
+constexpr const uint64_t kMaxPendingWrites = 1024;
+
+// A message travelling through the pipeline together with its position in
+// the read order, which the writer thread restores.
+struct SequencedMessage
+{
+  uint64_t sequence;
+  std::shared_ptr<rosbag2_storage::SerializedBagMessage> message;
+};
+
+// One converter worker. Each worker owns its Converter because the per-topic
+// conversion state (pooled introspection messages) is not thread-safe;
+// partitioning by topic keeps every topic on one worker.
+struct ConverterWorker
+{
+  std::deque<SequencedMessage> queue;
+  std::mutex mutex;
+  std::condition_variable condition;
+  // Signals the reading thread that a full worker queue has room again.
+  std::condition_variable drained_condition;
+  std::thread thread;
+  bool done = false;
+  std::unique_ptr<Converter> converter;
+};
+}  // namespace
+
+BagConverter::BagConverter(
+  const Options & options,
+  std::unique_ptr<Reader> reader,
+  std::unique_ptr<Writer> writer,
+  std::shared_ptr<SerializationFormatConverterFactoryInterface> converter_factory)
+: options_(options),
+  reader_(std::move(reader)),
+  writer_(std::move(writer)),
+  converter_factory_(std::move(converter_factory))
+{}
+
+void BagConverter::run()
+{
+  Reader & reader = *reader_;
+  // An empty output format reads the raw serialized messages unconverted.
+  reader.open(options_.input_storage_options, ConverterOptions{"", ""});
+
+  auto topics = reader.get_all_topics_and_types();
+  if (topics.empty()) {
+    throw std::runtime_error("The input bag contains no topics to convert.");
+  }
+  const auto input_format = topics[0].serialization_format;
+
+  Writer & writer = *writer_;
+  // Input and output format of the writer match, so the writer itself does
+  // not convert; the workers hand it ready-to-store messages.
+  writer.open(
+    options_.output_storage_options,
+    ConverterOptions{
+      options_.output_serialization_format, options_.output_serialization_format});
+  for (auto topic : topics) {
+    topic.serialization_format = options_.output_serialization_format;
+    writer.create_topic(topic);
+  }
+
+  size_t worker_count = options_.worker_count;
+  if (worker_count == 0) {
+    worker_count = std::thread::hardware_concurrency();
+  }
+  if (worker_count == 0) {
+    worker_count = 4;
+  }
+
+  std::vector<std::unique_ptr<ConverterWorker>> workers;
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers.push_back(std::make_unique<ConverterWorker>());
+    workers.back()->converter = std::make_unique<Converter>(
+      input_format, options_.output_serialization_format, converter_factory_);
+    for (const auto & topic : topics) {
+      workers.back()->converter->add_topic(topic.name, topic.type);
+    }
+  }
+
+  // Reorder buffer between the workers and the writer thread.
+  std::mutex write_mutex;
+  std::condition_variable write_condition;
+  std::map<uint64_t, std::shared_ptr<rosbag2_storage::SerializedBagMessage>> pending_writes;
+  uint64_t next_write_sequence = 0;
+  bool conversion_done = false;
+  std::atomic<bool> failed{false};
+  std::exception_ptr pipeline_error;  // Guarded by write_mutex.
+
+  auto record_failure =
+    [&write_mutex, &write_condition, &pipeline_error, &failed, &workers]() {
+      {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        if (!pipeline_error) {
+          pipeline_error = std::current_exception();
+        }
+      }
+      failed = true;
+      // Wake every blocked pipeline stage so the shutdown can proceed.
+      write_condition.notify_all();
+      for (auto & worker : workers) {
+        worker->condition.notify_all();
+        worker->drained_condition.notify_all();
+      }
+    };
+
+  for (auto & worker : workers) {
+    worker->thread = std::thread(
+      [&write_mutex, &write_condition, &pending_writes, &next_write_sequence, &failed,
+        &record_failure, worker_ptr = worker.get()]() {
+        auto & worker = *worker_ptr;
+        while (true) {
+          SequencedMessage item;
+          {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.condition.wait(
+              lock, [&worker] {return worker.done || !worker.queue.empty();});
+            if (worker.queue.empty()) {
+              break;  // Done and fully drained.
+            }
+            item = std::move(worker.queue.front());
+            worker.queue.pop_front();
+          }
+          worker.drained_condition.notify_all();
+          try {
+            auto converted = worker.converter->convert(item.message);
+            std::unique_lock<std::mutex> lock(write_mutex);
+            write_condition.wait(
+              lock, [&item, &next_write_sequence, &failed] {
+                return item.sequence < next_write_sequence + kMaxPendingWrites || failed;
+              });
+            if (failed) {
+              break;
+            }
+            pending_writes.emplace(item.sequence, converted);
+            lock.unlock();
+            write_condition.notify_all();
+          } catch (...) {
+            record_failure();
+            break;
+          }
+        }
+      });
+  }
+
+  std::thread writer_thread(
+    [&writer, &write_mutex, &write_condition, &pending_writes, &next_write_sequence,
+      &conversion_done, &failed, &record_failure]() {
+      while (true) {
+        std::shared_ptr<rosbag2_storage::SerializedBagMessage> message;
+        {
+          std::unique_lock<std::mutex> lock(write_mutex);
+          write_condition.wait(
+            lock, [&pending_writes, &next_write_sequence, &conversion_done, &failed] {
+              return failed || conversion_done ||
+                     (!pending_writes.empty() &&
+                     pending_writes.begin()->first == next_write_sequence);
+            });
+          if (failed) {
+            break;
+          }
+          if (pending_writes.empty() || pending_writes.begin()->first != next_write_sequence) {
+            if (conversion_done) {
+              // A gap with all workers finished cannot happen without a
+              // recorded failure; an empty buffer means the bag is written.
+              break;
+            }
+            continue;
+          }
+          message = pending_writes.begin()->second;
+          pending_writes.erase(pending_writes.begin());
+          ++next_write_sequence;
+        }
+        write_condition.notify_all();
+        try {
+          writer.write(message);
+        } catch (...) {
+          record_failure();
+          break;
+        }
+      }
+    });
+
+  // The calling thread is the reader of the pipeline.
+  uint64_t sequence = 0;
+  try {
+    while (!failed && reader.has_next()) {
+      auto message = reader.read_next();
+      auto & worker = *workers[
+        std::hash<std::string>{}(message->topic_name) % workers.size()];
+      {
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        worker.drained_condition.wait(
+          lock, [&worker, &failed] {
+            return worker.queue.size() < kWorkerQueueCapacity || failed;
+          });
+        if (failed) {
+          break;
+        }
+        worker.queue.push_back({sequence++, std::move(message)});
+      }
+      worker.condition.notify_one();
+    }
+  } catch (...) {
+    record_failure();
+  }
+
+  for (auto & worker : workers) {
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      worker->done = true;
+    }
+    worker->condition.notify_all();
+    worker->drained_condition.notify_all();
+  }
+  for (auto & worker : workers) {
+    worker->thread.join();
+  }
+  {
+    std::lock_guard<std::mutex> lock(write_mutex);
+    conversion_done = true;
+  }
+  write_condition.notify_all();
+  writer_thread.join();
+
+  if (pipeline_error) {
+    std::rethrow_exception(pipeline_error);
+  }
+  ROSBAG2_CPP_LOG_INFO_STREAM(
+    "Converted " << sequence << " messages to " << options_.output_serialization_format << ".");
+}
+
+}  // namespace rosbag2_cpp
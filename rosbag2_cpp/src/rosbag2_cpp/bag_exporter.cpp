@@ -0,0 +1,261 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_cpp/bag_exporter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+
+#include "rosbag2_cpp/logging.hpp"
+#include "rosbag2_cpp/readers/sequential_reader.hpp"
+#include "rosbag2_storage/metadata_io.hpp"
+#include "rosbag2_storage/storage_factory.hpp"
+#include "rosbag2_storage/storage_filter.hpp"
+
+namespace rosbag2_cpp
+{
+
+namespace
+{
+// Messages moved per read-write round trip of a split copy. The batch only
+// has to amortize the virtual call and transaction overhead, so it can stay
+// small enough to keep the copy's memory footprint flat.
+constexpr const size_t kCopyBatchSize = 1000;
+
+std::string format_storage_uri(const std::string & base_folder, uint64_t storage_count)
+{
+  std::stringstream storage_file_name;
+  storage_file_name << rcpputils::fs::path(base_folder).filename().string() << "_" << storage_count;
+  return (rcpputils::fs::path(base_folder) / storage_file_name.str()).string();
+}
+
+// What one worker learned while copying one split, merged into the output
+// metadata after all workers joined. Owned by exactly one worker while the
+// pool runs, so no locking is needed.
+struct SplitResult
+{
+  rosbag2_storage::FileInformation file_info;
+  std::map<std::string, size_t> messages_per_topic;
+  uint64_t message_count = 0;
+};
+}  // namespace
+
+BagExporter::BagExporter(const Options & options)
+: options_(options)
+{}
+
+void BagExporter::run()
+{
+  const auto & input_uri = options_.input_storage_options.uri;
+  rosbag2_storage::MetadataIo metadata_io;
+  if (!metadata_io.metadata_file_exists(input_uri)) {
+    throw std::runtime_error(
+            "Could not find metadata in bag directory " + input_uri +
+            ". Exporting copies the bag split by split and needs the recorded file list.");
+  }
+  const auto input_metadata = metadata_io.read_metadata(input_uri);
+  const auto file_paths = readers::details::resolve_relative_paths(
+    input_uri, input_metadata.relative_file_paths, input_metadata.version);
+  if (file_paths.empty()) {
+    throw std::runtime_error("The input bag lists no storage files.");
+  }
+
+  // The output carries the requested subset of the input's topics; their
+  // counts are filled in from the per-split results below.
+  std::vector<rosbag2_storage::TopicInformation> output_topics;
+  for (const auto & topic : input_metadata.topics_with_message_count) {
+    if (options_.topics.empty() ||
+      std::find(options_.topics.begin(), options_.topics.end(), topic.topic_metadata.name) !=
+      options_.topics.end())
+    {
+      rosbag2_storage::TopicInformation exported_topic{};
+      exported_topic.topic_metadata = topic.topic_metadata;
+      output_topics.push_back(exported_topic);
+    }
+  }
+  if (output_topics.empty()) {
+    throw std::runtime_error("None of the requested topics exist in the input bag.");
+  }
+
+  const auto & output_uri = options_.output_storage_options.uri;
+  rcpputils::fs::path output_path(output_uri);
+  if (output_path.is_directory()) {
+    std::stringstream error;
+    error << "Database directory already exists (" << output_path.string() <<
+      "), can't overwrite existing database";
+    throw std::runtime_error{error.str()};
+  }
+  if (!rcpputils::fs::create_directories(output_path)) {
+    std::stringstream error;
+    error << "Failed to create database directory (" << output_path.string() << ").";
+    throw std::runtime_error{error.str()};
+  }
+
+  const auto output_storage_id = options_.output_storage_options.storage_id.empty() ?
+    input_metadata.storage_identifier : options_.output_storage_options.storage_id;
+
+  rosbag2_storage::StorageFilter filter;
+  filter.topics = options_.topics;
+
+  size_t worker_count = options_.worker_count;
+  if (worker_count == 0) {
+    worker_count = std::thread::hardware_concurrency();
+  }
+  if (worker_count == 0) {
+    worker_count = 4;
+  }
+  worker_count = std::min(worker_count, file_paths.size());
+
+  std::vector<SplitResult> results(file_paths.size());
+  std::atomic<size_t> next_split{0};
+  std::atomic<bool> failed{false};
+  std::mutex error_mutex;
+  std::exception_ptr pipeline_error;  // Guarded by error_mutex.
+
+  auto record_failure = [&error_mutex, &pipeline_error, &failed]() {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!pipeline_error) {
+        pipeline_error = std::current_exception();
+      }
+      failed = true;
+    };
+
+  // Copies the split at the given index through the storage level: the
+  // messages stay serialized and the filter is answered by the storage, so
+  // a worker is bound by I/O and the storage's own work only.
+  auto export_split =
+    [this, &input_metadata, &file_paths, &output_uri, &output_storage_id, &output_topics,
+      &filter, &results, &failed](size_t index) {
+      rosbag2_storage::StorageFactory factory;
+      auto input = factory.open_read_only(
+        file_paths[index], input_metadata.storage_identifier);
+      if (!filter.topics.empty()) {
+        input->set_filter(filter);
+      }
+      const auto output_file = format_storage_uri(output_uri, index);
+      auto output = factory.open_read_write(
+        output_file, output_storage_id, options_.output_storage_options.storage_config_uri);
+      for (const auto & topic : output_topics) {
+        output->create_topic(topic.topic_metadata);
+      }
+
+      auto & result = results[index];
+      result.file_info.path = rcpputils::fs::path(
+        output->get_relative_file_path()).filename().string();
+      int64_t first_timestamp = 0;
+      int64_t last_timestamp = 0;
+      while (!failed && input->has_next()) {
+        auto batch = input->read_next_batch(kCopyBatchSize);
+        if (batch.empty()) {
+          break;
+        }
+        for (const auto & message : batch) {
+          if (result.message_count == 0) {
+            first_timestamp = message->time_stamp;
+          }
+          last_timestamp = message->time_stamp;
+          ++result.messages_per_topic[message->topic_name];
+          ++result.message_count;
+        }
+        output->write(
+          std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>>(
+            batch.begin(), batch.end()));
+      }
+      if (result.message_count > 0) {
+        result.file_info.starting_time =
+          std::chrono::time_point<std::chrono::high_resolution_clock>(
+          std::chrono::nanoseconds(first_timestamp));
+        result.file_info.duration = std::chrono::nanoseconds(last_timestamp - first_timestamp);
+      }
+    };
+
+  // The workers pull split indices from a shared counter, so an uneven mix
+  // of file sizes still keeps every core busy until the tail.
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back(
+      [&next_split, &failed, &record_failure, &export_split, file_count = file_paths.size()]() {
+        while (!failed) {
+          const size_t index = next_split.fetch_add(1);
+          if (index >= file_count) {
+            break;
+          }
+          try {
+            export_split(index);
+          } catch (...) {
+            record_failure();
+            break;
+          }
+        }
+      });
+  }
+  for (auto & worker : workers) {
+    worker.join();
+  }
+  if (pipeline_error) {
+    std::rethrow_exception(pipeline_error);
+  }
+
+  // Merge the per-split results into one metadata file, preserving the
+  // input's split structure and order.
+  rosbag2_storage::BagMetadata output_metadata{};
+  output_metadata.storage_identifier = output_storage_id;
+  output_metadata.storage_shard_count = input_metadata.storage_shard_count;
+  output_metadata.starting_time = std::chrono::time_point<std::chrono::high_resolution_clock>(
+    std::chrono::nanoseconds::max());
+  auto end_time = std::chrono::time_point<std::chrono::high_resolution_clock>(
+    std::chrono::nanoseconds::min());
+  output_metadata.message_count = 0;
+  for (const auto & result : results) {
+    output_metadata.relative_file_paths.push_back(result.file_info.path);
+    output_metadata.files.push_back(result.file_info);
+    output_metadata.message_count += result.message_count;
+    if (result.message_count > 0) {
+      output_metadata.starting_time =
+        std::min(output_metadata.starting_time, result.file_info.starting_time);
+      end_time = std::max(end_time, result.file_info.starting_time + result.file_info.duration);
+    }
+    for (auto & topic : output_topics) {
+      const auto count = result.messages_per_topic.find(topic.topic_metadata.name);
+      if (count != result.messages_per_topic.end()) {
+        topic.message_count += count->second;
+      }
+    }
+  }
+  output_metadata.duration = output_metadata.message_count > 0 ?
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+    end_time - output_metadata.starting_time) :
+    std::chrono::nanoseconds(0);
+  output_metadata.topics_with_message_count = output_topics;
+  metadata_io.write_metadata(output_uri, output_metadata);
+
+  ROSBAG2_CPP_LOG_INFO_STREAM(
+    "Exported " << output_metadata.message_count << " messages across " <<
+      file_paths.size() << " split file(s).");
+}
+
+}  // namespace rosbag2_cpp
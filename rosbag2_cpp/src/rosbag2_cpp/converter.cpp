@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "rosbag2_cpp/info.hpp"
+#include "rosbag2_cpp/logging.hpp"
 #include "rosbag2_cpp/typesupport_helpers.hpp"
 #include "rosbag2_cpp/storage_options.hpp"
 
@@ -40,12 +41,25 @@ Converter::Converter(
 Converter::Converter(
   const ConverterOptions & converter_options,
   std::shared_ptr<SerializationFormatConverterFactoryInterface> converter_factory)
-: converter_factory_(converter_factory),
-  input_converter_(converter_factory_->load_deserializer(
-      converter_options.input_serialization_format)),
-  output_converter_(converter_factory_->load_serializer(
-      converter_options.output_serialization_format))
+: converter_factory_(converter_factory)
 {
+  if (converter_factory_->formats_are_byte_compatible(
+      converter_options.input_serialization_format,
+      converter_options.output_serialization_format))
+  {
+    // Identical wire encoding; convert() just relabels the messages and no
+    // converter plugins need to be loaded at all.
+    ROSBAG2_CPP_LOG_INFO_STREAM(
+      "Serialization formats '" << converter_options.input_serialization_format <<
+        "' and '" << converter_options.output_serialization_format <<
+        "' are byte-compatible; conversion is a passthrough.");
+    passthrough_ = true;
+    return;
+  }
+  input_converter_ = converter_factory_->load_deserializer(
+    converter_options.input_serialization_format);
+  output_converter_ = converter_factory_->load_serializer(
+    converter_options.output_serialization_format);
   if (!input_converter_) {
     throw std::runtime_error(
             "Could not find converter for format " + converter_options.input_serialization_format);
@@ -66,34 +80,100 @@ Converter::~Converter()
 std::shared_ptr<rosbag2_storage::SerializedBagMessage> Converter::convert(
   std::shared_ptr<const rosbag2_storage::SerializedBagMessage> message)
 {
-  auto ts = topics_and_types_.at(message->topic_name).rmw_type_support;
-  auto introspection_ts = topics_and_types_.at(message->topic_name).introspection_type_support;
-  auto allocator = rcutils_get_default_allocator();
-  std::shared_ptr<rosbag2_introspection_message_t> allocated_ros_message =
-    allocate_introspection_message(introspection_ts, &allocator);
+  if (passthrough_) {
+    // Byte-compatible formats: hand the serialized payload through as-is.
+    auto output_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+    output_message->serialized_data = message->serialized_data;
+    output_message->topic_name = message->topic_name;
+    output_message->time_stamp = message->time_stamp;
+    output_message->topic_id = message->topic_id;
+    return output_message;
+  }
+  const auto & type_support = topics_and_types_.at(message->topic_name);
+  return convert_with(message, type_support, conversion_pool_[message->topic_name]);
+}
+
+std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+Converter::convert_batch(
+  const std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> & messages)
+{
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> output;
+  output.reserve(messages.size());
+
+  if (passthrough_) {
+    for (const auto & message : messages) {
+      output.push_back(convert(message));
+    }
+    return output;
+  }
+
+  // Topic state is carried across consecutive messages of the same topic,
+  // so a batch in storage order resolves it once per run instead of twice
+  // per message.
+  const std::string * current_topic = nullptr;
+  const ConverterTypeSupport * type_support = nullptr;
+  PooledConversionState * pool_state = nullptr;
+  for (const auto & message : messages) {
+    if (current_topic == nullptr || message->topic_name != *current_topic) {
+      current_topic = &message->topic_name;
+      type_support = &topics_and_types_.at(message->topic_name);
+      pool_state = &conversion_pool_[message->topic_name];
+    }
+    output.push_back(convert_with(message, *type_support, *pool_state));
+  }
+  return output;
+}
+
+std::shared_ptr<rosbag2_storage::SerializedBagMessage> Converter::convert_with(
+  const std::shared_ptr<const rosbag2_storage::SerializedBagMessage> & message,
+  const ConverterTypeSupport & type_support,
+  PooledConversionState & pool_state)
+{
+  // Reuse the per-topic introspection message instead of rebuilding the
+  // whole introspection structure for every conversion.
+  if (!pool_state.introspection_message) {
+    auto allocator = rcutils_get_default_allocator();
+    pool_state.introspection_message =
+      allocate_introspection_message(type_support.introspection_type_support, &allocator);
+  } else {
+    introspection_message_reset(
+      pool_state.introspection_message.get(), type_support.introspection_type_support);
+  }
 
-  input_converter_->deserialize(message, ts, allocated_ros_message);
+  input_converter_->deserialize(
+    message, type_support.rmw_type_support, pool_state.introspection_message);
   auto output_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
-  output_message->serialized_data = rosbag2_storage::make_empty_serialized_message(0);
-  output_converter_->serialize(allocated_ros_message, ts, output_message);
+  // Size the output buffer by what this topic needed before, so the
+  // serializer does not have to grow it from zero every time.
+  output_message->serialized_data =
+    rosbag2_storage::make_empty_serialized_message(pool_state.output_buffer_hint);
+  output_converter_->serialize(
+    pool_state.introspection_message, type_support.rmw_type_support, output_message);
+  // Conversion changes the encoding, not the topic; keep the interned id.
+  output_message->topic_id = message->topic_id;
+  if (output_message->serialized_data->buffer_length > pool_state.output_buffer_hint) {
+    // Grow the hint geometrically to absorb per-message size jitter.
+    pool_state.output_buffer_hint =
+      output_message->serialized_data->buffer_length +
+      output_message->serialized_data->buffer_length / 2;
+  }
   return output_message;
 }
 
 void Converter::add_topic(const std::string & topic, const std::string & type)
 {
+  if (passthrough_) {
+    // No typesupport is needed to pass serialized messages through.
+    return;
+  }
   ConverterTypeSupport type_support;
 
-  type_support.type_support_library = get_typesupport_library(
-    type, "rosidl_typesupport_cpp");
+  // The process-wide registry resolves and pins each handle once, so
+  // converters share them with the transport's publishers and subscriptions.
   type_support.rmw_type_support = get_typesupport_handle(
-    type, "rosidl_typesupport_cpp",
-    type_support.type_support_library);
-
-  type_support.introspection_type_support_library = get_typesupport_library(
-    type, "rosidl_typesupport_introspection_cpp");
+    type, "rosidl_typesupport_cpp");
   type_support.introspection_type_support = get_typesupport_handle(
-    type, "rosidl_typesupport_introspection_cpp",
-    type_support.introspection_type_support_library);
+    type, "rosidl_typesupport_introspection_cpp");
 
   topics_and_types_.insert({topic, type_support});
 }
@@ -14,9 +14,14 @@
 
 #include "rosbag2_cpp/info.hpp"
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
 
 #include "rosbag2_storage/metadata_io.hpp"
 #include "rosbag2_storage/storage_interfaces/read_only_interface.hpp"
@@ -49,4 +54,60 @@ rosbag2_storage::BagMetadata Info::read_metadata(
           "storage id of the bagfile to query it directly");
 }
 
+std::vector<rosbag2_storage::TopicStatistics> Info::read_topic_statistics(
+  const std::string & uri, const std::string & storage_id)
+{
+  rosbag2_storage::MetadataIo metadata_io;
+  std::vector<std::string> file_paths;
+  std::string effective_storage_id = storage_id;
+  if (metadata_io.metadata_file_exists(uri)) {
+    const auto metadata = metadata_io.read_metadata(uri);
+    for (const auto & relative_path : metadata.relative_file_paths) {
+      file_paths.push_back((rcpputils::fs::path(uri) / relative_path).string());
+    }
+    if (effective_storage_id.empty()) {
+      effective_storage_id = metadata.storage_identifier;
+    }
+  } else {
+    file_paths.push_back(uri);
+  }
+  if (effective_storage_id.empty()) {
+    throw std::runtime_error(
+            "The metadata.yaml file does not exist. Please specify a the "
+            "storage id of the bagfile to query it directly");
+  }
+
+  rosbag2_storage::StorageFactory factory;
+  // Keyed map instead of a vector so the splits of a multi-file bag merge
+  // per topic; std::map keeps the output sorted by name.
+  std::map<std::string, rosbag2_storage::TopicStatistics> aggregated;
+  for (const auto & file_path : file_paths) {
+    auto storage = factory.open_read_only(file_path, effective_storage_id);
+    if (!storage) {
+      throw std::runtime_error(
+              "Could not open '" + file_path + "' to aggregate topic statistics.");
+    }
+    for (const auto & file_statistics : storage->get_topic_statistics()) {
+      auto & entry = aggregated[file_statistics.topic_name];
+      if (entry.message_count == 0) {
+        entry = file_statistics;
+        continue;
+      }
+      entry.message_count += file_statistics.message_count;
+      entry.byte_count += file_statistics.byte_count;
+      entry.first_timestamp_ns =
+        std::min(entry.first_timestamp_ns, file_statistics.first_timestamp_ns);
+      entry.last_timestamp_ns =
+        std::max(entry.last_timestamp_ns, file_statistics.last_timestamp_ns);
+    }
+  }
+
+  std::vector<rosbag2_storage::TopicStatistics> statistics;
+  statistics.reserve(aggregated.size());
+  for (const auto & entry : aggregated) {
+    statistics.push_back(entry.second);
+  }
+  return statistics;
+}
+
 }  // namespace rosbag2_cpp
@@ -62,6 +62,19 @@ std::shared_ptr<rosbag2_storage::SerializedBagMessage> Reader::read_next()
   return reader_impl_->read_next();
 }
 
+std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+Reader::read_next_batch(size_t max_batch_size)
+{
+  return reader_impl_->read_next_batch(max_batch_size);
+}
+
+void Reader::read_next_batch(
+  size_t max_batch_size,
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> & batch)
+{
+  reader_impl_->read_next_batch(max_batch_size, batch);
+}
+
 const rosbag2_storage::BagMetadata & Reader::get_metadata() const
 {
   return reader_impl_->get_metadata();
@@ -82,4 +95,14 @@ void Reader::reset_filter()
   reader_impl_->reset_filter();
 }
 
+void Reader::seek(rcutils_time_point_value_t timestamp)
+{
+  reader_impl_->seek(timestamp);
+}
+
+void Reader::set_read_order(rosbag2_storage::ReadOrder read_order)
+{
+  reader_impl_->set_read_order(read_order);
+}
+
 }  // namespace rosbag2_cpp
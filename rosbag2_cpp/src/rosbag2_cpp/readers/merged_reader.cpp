@@ -0,0 +1,226 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_cpp/readers/merged_reader.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rosbag2_cpp/readers/sequential_reader.hpp"
+
+namespace rosbag2_cpp
+{
+namespace readers
+{
+
+MergedReader::MergedReader(
+  std::vector<std::unique_ptr<reader_interfaces::BaseReaderInterface>> readers)
+: readers_(std::move(readers))
+{}
+
+MergedReader::~MergedReader()
+{
+  reset();
+}
+
+void MergedReader::open(
+  const std::vector<StorageOptions> & storage_options,
+  const ConverterOptions & converter_options)
+{
+  if (storage_options.empty()) {
+    throw std::runtime_error("No bags were given to open.");
+  }
+  if (readers_.empty()) {
+    for (size_t i = 0; i < storage_options.size(); ++i) {
+      readers_.push_back(std::make_unique<SequentialReader>());
+    }
+  } else if (readers_.size() != storage_options.size()) {
+    throw std::runtime_error(
+            "The number of bags to open does not match the number of readers.");
+  }
+
+  for (size_t i = 0; i < readers_.size(); ++i) {
+    readers_[i]->open(storage_options[i], converter_options);
+  }
+  heads_.clear();
+  heads_.resize(readers_.size());
+  merge_metadata();
+  open_ = true;
+}
+
+void MergedReader::open(
+  const StorageOptions & storage_options, const ConverterOptions & converter_options)
+{
+  open(std::vector<StorageOptions>{storage_options}, converter_options);
+}
+
+void MergedReader::reset()
+{
+  readers_.clear();
+  heads_.clear();
+  open_ = false;
+}
+
+bool MergedReader::has_next()
+{
+  if (!open_) {
+    throw std::runtime_error("Bag is not open. Call open() before reading.");
+  }
+  // Refill the merge heads from every bag which has messages left.
+  bool any_message = false;
+  for (size_t i = 0; i < readers_.size(); ++i) {
+    if (!heads_[i] && readers_[i]->has_next()) {
+      heads_[i] = readers_[i]->read_next();
+      // Each bag's reader interns its own topic ids, so ids of different
+      // bags would clash in the merged stream; clear them and let consumers
+      // fall back to the topic name.
+      heads_[i]->topic_id = 0u;
+    }
+    any_message = any_message || (heads_[i] != nullptr);
+  }
+  return any_message;
+}
+
+std::shared_ptr<rosbag2_storage::SerializedBagMessage> MergedReader::read_next()
+{
+  if (!has_next()) {
+    throw std::runtime_error("No more messages left in the bag!");
+  }
+  // Hand out the earliest of the bags' head messages.
+  size_t next_bag = heads_.size();
+  for (size_t i = 0; i < heads_.size(); ++i) {
+    if (heads_[i] &&
+      (next_bag == heads_.size() || heads_[i]->time_stamp < heads_[next_bag]->time_stamp))
+    {
+      next_bag = i;
+    }
+  }
+  auto message = std::move(heads_[next_bag]);
+  heads_[next_bag].reset();
+  return message;
+}
+
+std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+MergedReader::read_next_batch(size_t max_batch_size)
+{
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> batch;
+  read_next_batch(max_batch_size, batch);
+  return batch;
+}
+
+void MergedReader::read_next_batch(
+  size_t max_batch_size,
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> & batch)
+{
+  // Batches must preserve the timestamp merge across the bags, so they are
+  // assembled message by message.
+  batch.clear();
+  batch.reserve(max_batch_size);
+  while (batch.size() < max_batch_size && has_next()) {
+    batch.push_back(read_next());
+  }
+}
+
+const rosbag2_storage::BagMetadata & MergedReader::get_metadata() const
+{
+  return merged_metadata_;
+}
+
+std::vector<rosbag2_storage::TopicMetadata> MergedReader::get_all_topics_and_types() const
+{
+  return merged_topics_;
+}
+
+void MergedReader::set_filter(const rosbag2_storage::StorageFilter & storage_filter)
+{
+  for (auto & reader : readers_) {
+    reader->set_filter(storage_filter);
+  }
+  // Buffered heads were read before the filter took effect; drop them so
+  // the next refill honors it.
+  std::fill(heads_.begin(), heads_.end(), nullptr);
+}
+
+void MergedReader::reset_filter()
+{
+  for (auto & reader : readers_) {
+    reader->reset_filter();
+  }
+  std::fill(heads_.begin(), heads_.end(), nullptr);
+}
+
+void MergedReader::seek(rcutils_time_point_value_t timestamp)
+{
+  for (auto & reader : readers_) {
+    reader->seek(timestamp);
+  }
+  std::fill(heads_.begin(), heads_.end(), nullptr);
+}
+
+void MergedReader::merge_metadata()
+{
+  merged_metadata_ = rosbag2_storage::BagMetadata{};
+  merged_topics_.clear();
+  merged_metadata_.starting_time =
+    std::chrono::time_point<std::chrono::high_resolution_clock>(std::chrono::nanoseconds::max());
+  auto end_time =
+    std::chrono::time_point<std::chrono::high_resolution_clock>(std::chrono::nanoseconds::min());
+
+  std::unordered_map<std::string, size_t> topic_indices;
+  for (const auto & reader : readers_) {
+    const auto & metadata = reader->get_metadata();
+    if (merged_metadata_.storage_identifier.empty()) {
+      merged_metadata_.storage_identifier = metadata.storage_identifier;
+    }
+    merged_metadata_.bag_size += metadata.bag_size;
+    merged_metadata_.message_count += metadata.message_count;
+    merged_metadata_.relative_file_paths.insert(
+      merged_metadata_.relative_file_paths.end(),
+      metadata.relative_file_paths.begin(), metadata.relative_file_paths.end());
+    merged_metadata_.starting_time =
+      std::min(merged_metadata_.starting_time, metadata.starting_time);
+    end_time = std::max(end_time, metadata.starting_time + metadata.duration);
+
+    for (const auto & topic_information : metadata.topics_with_message_count) {
+      const auto & topic_metadata = topic_information.topic_metadata;
+      auto it = topic_indices.find(topic_metadata.name);
+      if (it == topic_indices.end()) {
+        topic_indices.emplace(
+          topic_metadata.name, merged_metadata_.topics_with_message_count.size());
+        merged_metadata_.topics_with_message_count.push_back(topic_information);
+        merged_topics_.push_back(topic_metadata);
+        continue;
+      }
+      auto & merged = merged_metadata_.topics_with_message_count[it->second];
+      if (merged.topic_metadata.type != topic_metadata.type) {
+        throw std::runtime_error(
+                "Topic '" + topic_metadata.name + "' is recorded with type '" +
+                merged.topic_metadata.type + "' in one bag and type '" +
+                topic_metadata.type + "' in another. These bags cannot be merged.");
+      }
+      merged.message_count += topic_information.message_count;
+      merged.dropped_message_count += topic_information.dropped_message_count;
+      merged.dropped_byte_count += topic_information.dropped_byte_count;
+      merged.rmw_lost_message_count += topic_information.rmw_lost_message_count;
+    }
+  }
+  merged_metadata_.duration = end_time - merged_metadata_.starting_time;
+}
+
+}  // namespace readers
+}  // namespace rosbag2_cpp
@@ -12,9 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -24,6 +29,14 @@
 #include "rosbag2_cpp/logging.hpp"
 #include "rosbag2_cpp/readers/sequential_reader.hpp"
 
+#ifdef WIN32
+// Import windows filesystem functionality
+#include <windows.h>
+#else
+// We're on a UNIX system. Import their filesystem stuff instead
+#include <dirent.h>
+#endif
+
 
 namespace rosbag2_cpp
 {
@@ -32,7 +45,7 @@ namespace readers
 namespace details
 {
 std::vector<std::string> resolve_relative_paths(
-  const std::string & base_folder, std::vector<std::string> relative_files, const int version = 4)
+  const std::string & base_folder, std::vector<std::string> relative_files, const int version)
 {
   auto base_path = rcpputils::fs::path(base_folder);
   if (version < 4) {
@@ -57,6 +70,182 @@ std::vector<std::string> resolve_relative_paths(
 }
 }  // namespace details
 
+namespace
+{
+// Numeric suffix of a split file name ("<bag>_<N>.db3"), used to order
+// recovered split files by split number instead of lexicographically
+// (file_10 would otherwise sort before file_9). Files without a numeric
+// suffix sort first, by name.
+int64_t split_file_number(const std::string & file_name)
+{
+  const auto underscore = file_name.find_last_of('_');
+  const auto dot = file_name.find_last_of('.');
+  if (underscore == std::string::npos || dot == std::string::npos || underscore + 1 >= dot) {
+    return -1;
+  }
+  const auto digits = file_name.substr(underscore + 1, dot - underscore - 1);
+  if (digits.find_first_not_of("0123456789") != std::string::npos) {
+    return -1;
+  }
+  return std::stoll(digits);
+}
+
+// The storage files inside a bag directory, ordered by split number. Only
+// sqlite3 files are recognized, same as the reindexer; recovering bags of
+// other storage formats still requires their metadata.yaml.
+std::vector<std::string> list_storage_files(const std::string & base_folder)
+{
+  std::vector<std::string> files;
+
+#ifdef WIN32
+  WIN32_FIND_DATA find_data;
+  const std::string search_pattern = base_folder + "\\*";
+  HANDLE find_handle = FindFirstFile(search_pattern.c_str(), &find_data);
+  if (find_handle == INVALID_HANDLE_VALUE) {
+    return files;
+  }
+  do {
+    if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+      continue;
+    }
+    const auto path = rcpputils::fs::path(base_folder) / rcpputils::fs::path(find_data.cFileName);
+    if (path.extension().string() != ".db3") {
+      continue;
+    }
+    files.push_back(path.string());
+  } while (FindNextFile(find_handle, &find_data) != 0);
+  FindClose(find_handle);
+#else
+  auto dirp = opendir(base_folder.c_str());
+  if (dirp == NULL) {
+    return files;
+  }
+  dirent * dp;
+  while ((dp = readdir(dirp)) != NULL) {
+    const auto path = rcpputils::fs::path(base_folder) / rcpputils::fs::path(dp->d_name);
+    if (path.extension().string() != ".db3") {
+      continue;
+    }
+    files.push_back(path.string());
+  }
+  closedir(dirp);
+#endif
+
+  std::sort(
+    files.begin(), files.end(),
+    [](const std::string & left, const std::string & right) {
+      const auto left_number = split_file_number(left);
+      const auto right_number = split_file_number(right);
+      if (left_number != right_number) {
+        return left_number < right_number;
+      }
+      return left < right;
+    });
+  return files;
+}
+
+// Rebuilds bag metadata from the per-split metadata of the given storage
+// files. Each split's query is independent and I/O bound, so the splits are
+// scanned by a pool of worker threads and merged in file order afterwards,
+// which keeps the merge deterministic.
+rosbag2_storage::BagMetadata recover_metadata(
+  rosbag2_storage::StorageFactoryInterface & storage_factory,
+  const std::vector<std::string> & files,
+  const std::string & storage_id)
+{
+  std::vector<rosbag2_storage::BagMetadata> per_file_metadata(files.size());
+  const size_t worker_count = std::min(
+    files.size(),
+    static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())));
+  std::atomic<size_t> next_file{0};
+  // Plugin loading inside the storage factory is not thread-safe; only the
+  // metadata extraction itself runs concurrently.
+  std::mutex factory_mutex;
+  std::mutex error_mutex;
+  std::exception_ptr extraction_error;
+
+  std::vector<std::thread> workers;
+  workers.reserve(worker_count);
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back(
+      [&]() {
+        while (true) {
+          const auto index = next_file.fetch_add(1);
+          if (index >= files.size()) {
+            return;
+          }
+          try {
+            std::shared_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> storage;
+            {
+              std::lock_guard<std::mutex> lock(factory_mutex);
+              storage = storage_factory.open_read_only(files[index], storage_id);
+            }
+            if (!storage) {
+              throw std::runtime_error{
+                      "Could not open '" + files[index] + "' to recover its metadata."};
+            }
+            per_file_metadata[index] = storage->get_metadata();
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!extraction_error) {
+              extraction_error = std::current_exception();
+            }
+          }
+        }
+      });
+  }
+  for (auto & worker : workers) {
+    worker.join();
+  }
+  if (extraction_error) {
+    std::rethrow_exception(extraction_error);
+  }
+
+  rosbag2_storage::BagMetadata metadata{};
+  metadata.storage_identifier = per_file_metadata.front().storage_identifier;
+  metadata.starting_time = std::chrono::time_point<std::chrono::high_resolution_clock>(
+    std::chrono::nanoseconds::max());
+  auto end_time = std::chrono::time_point<std::chrono::high_resolution_clock>(
+    std::chrono::nanoseconds::min());
+
+  for (size_t i = 0; i < files.size(); ++i) {
+    const auto & file_metadata = per_file_metadata[i];
+    const auto file_name = rcpputils::fs::path(files[i]).filename().string();
+    const auto file_path = rcpputils::fs::path(files[i]);
+
+    metadata.relative_file_paths.push_back(file_name);
+    rosbag2_storage::FileInformation file_information{};
+    file_information.path = file_name;
+    file_information.starting_time = file_metadata.starting_time;
+    file_information.duration = file_metadata.duration;
+    metadata.files.push_back(file_information);
+
+    metadata.message_count += file_metadata.message_count;
+    metadata.bag_size += file_path.exists() ? file_path.file_size() : 0u;
+    metadata.starting_time = std::min(metadata.starting_time, file_metadata.starting_time);
+    end_time = std::max(end_time, file_metadata.starting_time + file_metadata.duration);
+
+    for (const auto & topic : file_metadata.topics_with_message_count) {
+      auto found_topic = std::find_if(
+        metadata.topics_with_message_count.begin(),
+        metadata.topics_with_message_count.end(),
+        [&topic](const rosbag2_storage::TopicInformation & aggregated_topic)
+        {return topic.topic_metadata.name == aggregated_topic.topic_metadata.name;});
+      if (found_topic == metadata.topics_with_message_count.end()) {
+        metadata.topics_with_message_count.push_back(topic);
+      } else {
+        found_topic->message_count += topic.message_count;
+      }
+    }
+  }
+  if (end_time > metadata.starting_time) {
+    metadata.duration =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - metadata.starting_time);
+  }
+  return metadata;
+}
+}  // namespace
+
 SequentialReader::SequentialReader(
   std::unique_ptr<rosbag2_storage::StorageFactoryInterface> storage_factory,
   std::shared_ptr<SerializationFormatConverterFactoryInterface> converter_factory,
@@ -74,17 +263,24 @@ SequentialReader::~SequentialReader()
 
 void SequentialReader::reset()
 {
+  if (next_storage_future_.valid()) {
+    // Let an in-flight preload finish before the factory goes away; the
+    // opened storage is simply discarded.
+    next_storage_future_.get();
+  }
   if (storage_) {
     storage_.reset();
   }
+  shard_storages_.clear();
+  shard_heads_.clear();
+  shard_topic_id_remaps_.clear();
 }
 
 void SequentialReader::open(
   const StorageOptions & storage_options, const ConverterOptions & converter_options)
 {
   // If there is a metadata.yaml file present, load it.
-  // If not, let's ask the storage with the given URI for its metadata.
-  // This is necessary for non ROS2 bags (aka ROS1 legacy bags).
+  // If not, try to recover the metadata from the storage files themselves.
   if (metadata_io_->metadata_file_exists(storage_options.uri)) {
     metadata_ = metadata_io_->read_metadata(storage_options.uri);
     if (metadata_.relative_file_paths.empty()) {
@@ -102,19 +298,69 @@ void SequentialReader::open(
       throw std::runtime_error{"No storage could be initialized. Abort"};
     }
   } else {
-    storage_ = storage_factory_->open_read_only(
-      storage_options.uri, storage_options.storage_id);
-    if (!storage_) {
-      throw std::runtime_error{"No storage could be initialized. Abort"};
+    // A bag directory without metadata.yaml is typically a recording that
+    // crashed before closing. Discover the split files and rebuild the bag
+    // metadata from their per-file metadata, so the bag is playable right
+    // away without a full reindex. metadata.yaml on disk is not rewritten;
+    // reindexing remains the tool for that.
+    std::vector<std::string> recovered_files;
+    if (rcpputils::fs::path(storage_options.uri).is_directory()) {
+      recovered_files = list_storage_files(storage_options.uri);
     }
-    metadata_ = storage_->get_metadata();
-    if (metadata_.relative_file_paths.empty()) {
-      ROSBAG2_CPP_LOG_WARN("No file paths were found in metadata.");
-      return;
+    if (!recovered_files.empty()) {
+      metadata_ = recover_metadata(
+        *storage_factory_, recovered_files, storage_options.storage_id);
+      file_paths_ = recovered_files;
+      current_file_iterator_ = file_paths_.begin();
+
+      storage_ = storage_factory_->open_read_only(
+        get_current_file(), metadata_.storage_identifier);
+      if (!storage_) {
+        throw std::runtime_error{"No storage could be initialized. Abort"};
+      }
+    } else {
+      // Not a bag directory: ask the storage with the given URI for its
+      // metadata. This is the path taken by non ROS2 bags (aka ROS1 legacy
+      // bags).
+      storage_ = storage_factory_->open_read_only(
+        storage_options.uri, storage_options.storage_id);
+      if (!storage_) {
+        throw std::runtime_error{"No storage could be initialized. Abort"};
+      }
+      metadata_ = storage_->get_metadata();
+      if (metadata_.relative_file_paths.empty()) {
+        ROSBAG2_CPP_LOG_WARN("No file paths were found in metadata.");
+        return;
+      }
+      file_paths_ = metadata_.relative_file_paths;
+      current_file_iterator_ = file_paths_.begin();
     }
-    file_paths_ = metadata_.relative_file_paths;
-    current_file_iterator_ = file_paths_.begin();
   }
+  // A sharded bag carries concurrently written files whose time ranges
+  // overlap, so all of them are opened at once and merged by timestamp
+  // instead of being read file after file.
+  if (metadata_.storage_shard_count > 1) {
+    shard_storages_.push_back(storage_);
+    for (auto it = file_paths_.begin() + 1; it != file_paths_.end(); ++it) {
+      auto shard_storage = storage_factory_->open_read_only(
+        *it, metadata_.storage_identifier);
+      if (!shard_storage) {
+        throw std::runtime_error{"No storage could be initialized. Abort"};
+      }
+      shard_storages_.push_back(shard_storage);
+    }
+    shard_heads_.resize(shard_storages_.size());
+  }
+
+  if (shard_storages_.empty()) {
+    preload_next_file();
+    topic_id_remap_ = build_topic_id_remap(storage_);
+  } else {
+    for (const auto & shard_storage : shard_storages_) {
+      shard_topic_id_remaps_.push_back(build_topic_id_remap(shard_storage));
+    }
+  }
+
   auto topics = metadata_.topics_with_message_count;
   if (topics.empty()) {
     ROSBAG2_CPP_LOG_WARN("No topics were listed in metadata.");
@@ -131,13 +377,54 @@ void SequentialReader::open(
 
 bool SequentialReader::has_next()
 {
+  if (!shard_storages_.empty()) {
+    // Refill the merge heads from every shard which has messages left.
+    bool any_message = false;
+    for (size_t i = 0; i < shard_storages_.size(); ++i) {
+      if (!shard_heads_[i] && shard_storages_[i]->has_next()) {
+        shard_heads_[i] = shard_storages_[i]->read_next();
+        remap_topic_id(*shard_heads_[i], shard_topic_id_remaps_[i]);
+      }
+      any_message = any_message || (shard_heads_[i] != nullptr);
+    }
+    return any_message;
+  }
   if (storage_) {
     // If there's no new message, check if there's at least another file to read and update storage
     // to read from there. Otherwise, check if there's another message.
     if (!storage_->has_next() && has_next_file()) {
       load_next_file();
-      storage_ = storage_factory_->open_read_only(
-        get_current_file(), metadata_.storage_identifier);
+      // Skip split files whose recorded time range lies entirely outside
+      // the requested time window.
+      bool skipped_files = false;
+      while (has_next_file() &&
+        !file_overlaps_time_window(current_file_iterator_ - file_paths_.begin()))
+      {
+        load_next_file();
+        skipped_files = true;
+      }
+      if (skipped_files && next_storage_future_.valid()) {
+        // The pending preload belongs to a skipped file; discard it.
+        next_storage_future_.get();
+      }
+      if (next_storage_future_.valid()) {
+        // The storage was opened in the background while the previous file
+        // drained; get() also rethrows any error from the preload.
+        storage_ = next_storage_future_.get();
+      } else {
+        storage_ = storage_factory_->open_read_only(
+          get_current_file(), metadata_.storage_identifier);
+      }
+      if (!storage_) {
+        throw std::runtime_error{"No storage could be initialized. Abort"};
+      }
+      storage_->set_filter(storage_filter_);
+      storage_->set_read_order(read_order_);
+      if (seek_time_ >= 0) {
+        storage_->seek(seek_time_);
+      }
+      topic_id_remap_ = build_topic_id_remap(storage_);
+      preload_next_file();
     }
 
     return storage_->has_next();
@@ -147,13 +434,69 @@ bool SequentialReader::has_next()
 
 std::shared_ptr<rosbag2_storage::SerializedBagMessage> SequentialReader::read_next()
 {
+  if (!shard_storages_.empty()) {
+    if (!has_next()) {
+      throw std::runtime_error("No more messages left in the bag!");
+    }
+    // Hand out the earliest of the shards' head messages.
+    size_t next_shard = shard_heads_.size();
+    for (size_t i = 0; i < shard_heads_.size(); ++i) {
+      if (shard_heads_[i] &&
+        (next_shard == shard_heads_.size() ||
+        shard_heads_[i]->time_stamp < shard_heads_[next_shard]->time_stamp))
+      {
+        next_shard = i;
+      }
+    }
+    auto message = std::move(shard_heads_[next_shard]);
+    shard_heads_[next_shard].reset();
+    return converter_ ? converter_->convert(message) : message;
+  }
   if (storage_) {
     auto message = storage_->read_next();
+    remap_topic_id(*message, topic_id_remap_);
     return converter_ ? converter_->convert(message) : message;
   }
   throw std::runtime_error("Bag is not open. Call open() before reading.");
 }
 
+std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+SequentialReader::read_next_batch(size_t max_batch_size)
+{
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> batch;
+  read_next_batch(max_batch_size, batch);
+  return batch;
+}
+
+void SequentialReader::read_next_batch(
+  size_t max_batch_size,
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> & batch)
+{
+  batch.clear();
+  batch.reserve(max_batch_size);
+  if (!shard_storages_.empty()) {
+    // Batches must preserve the timestamp merge across the shards, so they
+    // are assembled message by message.
+    while (batch.size() < max_batch_size && has_next()) {
+      batch.push_back(read_next());
+    }
+    return;
+  }
+  if (storage_) {
+    // A batch never crosses a file boundary: has_next() rolls over to the
+    // next database file and a partially filled batch is a valid result.
+    while (batch.size() < max_batch_size && has_next()) {
+      auto messages = storage_->read_next_batch(max_batch_size - batch.size());
+      for (auto & message : messages) {
+        remap_topic_id(*message, topic_id_remap_);
+        batch.push_back(converter_ ? converter_->convert(message) : std::move(message));
+      }
+    }
+    return;
+  }
+  throw std::runtime_error("Bag is not open. Call open() before reading.");
+}
+
 const rosbag2_storage::BagMetadata & SequentialReader::get_metadata() const
 {
   rcpputils::check_true(storage_ != nullptr, "Bag is not open. Call open() before reading.");
@@ -166,11 +509,45 @@ std::vector<rosbag2_storage::TopicMetadata> SequentialReader::get_all_topics_and
   return topics_metadata_;
 }
 
+rosbag2_storage::IOStatistics SequentialReader::get_io_statistics() const
+{
+  // A sharded bag reads from all shard storages at once; their counters are
+  // summed into one view.
+  if (!shard_storages_.empty()) {
+    rosbag2_storage::IOStatistics statistics;
+    for (const auto & shard_storage : shard_storages_) {
+      const auto shard_statistics = shard_storage->get_io_statistics();
+      statistics.bytes_read += shard_statistics.bytes_read;
+      statistics.messages_read += shard_statistics.messages_read;
+      statistics.write_ahead_log_size += shard_statistics.write_ahead_log_size;
+      statistics.page_cache_hits += shard_statistics.page_cache_hits;
+      statistics.page_cache_misses += shard_statistics.page_cache_misses;
+    }
+    return statistics;
+  }
+  if (!storage_) {
+    return rosbag2_storage::IOStatistics{};
+  }
+  return storage_->get_io_statistics();
+}
+
 void SequentialReader::set_filter(
   const rosbag2_storage::StorageFilter & storage_filter)
 {
+  // Keep a copy so the filter survives rolling over to the next file of a
+  // split bag, where a fresh storage is opened.
+  storage_filter_ = storage_filter;
+  if (!shard_storages_.empty()) {
+    for (const auto & shard_storage : shard_storages_) {
+      shard_storage->set_filter(storage_filter_);
+    }
+    // Heads were read before the filter applied; drop them so no excluded
+    // message leaks through the merge.
+    std::fill(shard_heads_.begin(), shard_heads_.end(), nullptr);
+    return;
+  }
   if (storage_) {
-    storage_->set_filter(storage_filter);
+    storage_->set_filter(storage_filter_);
     return;
   }
   throw std::runtime_error(
@@ -179,6 +556,13 @@ void SequentialReader::set_filter(
 
 void SequentialReader::reset_filter()
 {
+  storage_filter_ = rosbag2_storage::StorageFilter();
+  if (!shard_storages_.empty()) {
+    for (const auto & shard_storage : shard_storages_) {
+      shard_storage->reset_filter();
+    }
+    return;
+  }
   if (storage_) {
     storage_->reset_filter();
     return;
@@ -187,15 +571,161 @@ void SequentialReader::reset_filter()
           "Bag is not open. Call open() before resetting filter.");
 }
 
+void SequentialReader::seek(rcutils_time_point_value_t timestamp)
+{
+  if (!shard_storages_.empty()) {
+    seek_time_ = timestamp;
+    for (const auto & shard_storage : shard_storages_) {
+      shard_storage->seek(seek_time_);
+    }
+    // The buffered heads belong to the position before the seek.
+    std::fill(shard_heads_.begin(), shard_heads_.end(), nullptr);
+    return;
+  }
+  if (storage_) {
+    seek_time_ = timestamp;
+    // Restart from the first file (in reading direction) which can contain
+    // the timestamp, so seeking works without opening out-of-range files;
+    // files without recorded time ranges yield no messages and has_next()
+    // rolls over.
+    const bool reverse = read_order_ == rosbag2_storage::ReadOrder::REVERSE;
+    auto target_file = reverse ? file_paths_.end() - 1 : file_paths_.begin();
+    while (
+      (reverse ? target_file != file_paths_.begin() : target_file + 1 != file_paths_.end()) &&
+      !file_overlaps_time_window(target_file - file_paths_.begin()))
+    {
+      target_file += reverse ? -1 : 1;
+    }
+    if (current_file_iterator_ != target_file) {
+      current_file_iterator_ = target_file;
+      if (next_storage_future_.valid()) {
+        // The pending preload belongs to the position before the seek.
+        next_storage_future_.get();
+      }
+      storage_ = storage_factory_->open_read_only(
+        get_current_file(), metadata_.storage_identifier);
+      storage_->set_filter(storage_filter_);
+      storage_->set_read_order(read_order_);
+      topic_id_remap_ = build_topic_id_remap(storage_);
+      preload_next_file();
+    }
+    storage_->seek(seek_time_);
+    return;
+  }
+  throw std::runtime_error("Bag is not open. Call open() before seeking.");
+}
+
+void SequentialReader::set_read_order(rosbag2_storage::ReadOrder read_order)
+{
+  if (!shard_storages_.empty()) {
+    if (read_order != rosbag2_storage::ReadOrder::FORWARD) {
+      throw std::runtime_error("Reverse reading is not supported for sharded bags.");
+    }
+    return;
+  }
+  if (!storage_) {
+    throw std::runtime_error("Bag is not open. Call open() before setting the read order.");
+  }
+  if (read_order == read_order_) {
+    return;
+  }
+  read_order_ = read_order;
+  if (next_storage_future_.valid()) {
+    // The pending preload was opened for the old direction.
+    next_storage_future_.get();
+  }
+  // Restart from the respective end of the file chain; the storage applies
+  // the flipped cursor from its current seek position. A subsequent seek()
+  // repositions within the new direction.
+  const auto target_file = read_order == rosbag2_storage::ReadOrder::REVERSE ?
+    file_paths_.end() - 1 : file_paths_.begin();
+  if (current_file_iterator_ != target_file) {
+    current_file_iterator_ = target_file;
+    storage_ = storage_factory_->open_read_only(
+      get_current_file(), metadata_.storage_identifier);
+    if (!storage_) {
+      throw std::runtime_error{"No storage could be initialized. Abort"};
+    }
+    storage_->set_filter(storage_filter_);
+    topic_id_remap_ = build_topic_id_remap(storage_);
+  }
+  storage_->set_read_order(read_order_);
+  if (seek_time_ >= 0) {
+    storage_->seek(seek_time_);
+  }
+  preload_next_file();
+}
+
 bool SequentialReader::has_next_file() const
 {
+  // In reverse order the file chain is walked from the last file towards
+  // the first.
+  if (read_order_ == rosbag2_storage::ReadOrder::REVERSE) {
+    return current_file_iterator_ != file_paths_.begin();
+  }
   return current_file_iterator_ + 1 != file_paths_.end();
 }
 
 void SequentialReader::load_next_file()
 {
   assert(current_file_iterator_ != file_paths_.end());
-  current_file_iterator_++;
+  if (read_order_ == rosbag2_storage::ReadOrder::REVERSE) {
+    current_file_iterator_--;
+  } else {
+    current_file_iterator_++;
+  }
+}
+
+void SequentialReader::preload_next_file()
+{
+  if (!has_next_file() || next_storage_future_.valid()) {
+    return;
+  }
+  // Capture the path by value; the iterator may move before the task runs.
+  const auto next_file = read_order_ == rosbag2_storage::ReadOrder::REVERSE ?
+    *(current_file_iterator_ - 1) : *(current_file_iterator_ + 1);
+  next_storage_future_ = std::async(
+    std::launch::async,
+    [this, next_file]() {
+      return storage_factory_->open_read_only(next_file, metadata_.storage_identifier);
+    });
+}
+
+bool SequentialReader::file_overlaps_time_window(size_t file_index) const
+{
+  // Bags written before per-file time ranges existed (or by writers which
+  // do not maintain them) must visit every file.
+  if (metadata_.files.size() != file_paths_.size() || file_index >= metadata_.files.size()) {
+    return true;
+  }
+  const auto & file_info = metadata_.files[file_index];
+  if (file_info.starting_time ==
+    std::chrono::time_point<std::chrono::high_resolution_clock>(std::chrono::nanoseconds::max()))
+  {
+    // The range was never recorded, e.g. for a file without messages.
+    return true;
+  }
+  const auto file_start = file_info.starting_time.time_since_epoch().count();
+  const auto file_end = file_start + file_info.duration.count();
+
+  // A seek target tightens the window bound the reading direction starts
+  // from: the lower one when reading forward, the upper one in reverse.
+  auto window_start = storage_filter_.start_time;
+  auto window_end = storage_filter_.end_time;
+  if (seek_time_ >= 0) {
+    if (read_order_ == rosbag2_storage::ReadOrder::REVERSE) {
+      window_end = window_end >= 0 ? std::min(window_end, seek_time_) : seek_time_;
+    } else {
+      window_start = std::max(window_start, seek_time_);
+    }
+  }
+  if (window_start >= 0 && file_end < window_start) {
+    return false;
+  }
+  if (window_end >= 0 && file_start > window_end) {
+    return false;
+  }
+  return true;
 }
 
 std::string SequentialReader::get_current_file() const
@@ -241,6 +771,33 @@ void SequentialReader::check_converter_serialization_format(
   }
 }
 
+std::vector<uint32_t> SequentialReader::build_topic_id_remap(
+  const std::shared_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> & storage)
+{
+  std::vector<uint32_t> topic_id_remap;
+  for (const auto & topic : storage->get_all_topics_and_types()) {
+    if (topic.topic_id == 0u) {
+      continue;
+    }
+    const auto interned_id = topic_ids_by_name_.insert(
+      {topic.name, static_cast<uint32_t>(topic_ids_by_name_.size() + 1)}).first->second;
+    if (topic_id_remap.size() <= topic.topic_id) {
+      topic_id_remap.resize(topic.topic_id + 1, 0u);
+    }
+    topic_id_remap[topic.topic_id] = interned_id;
+  }
+  return topic_id_remap;
+}
+
+void SequentialReader::remap_topic_id(
+  rosbag2_storage::SerializedBagMessage & message,
+  const std::vector<uint32_t> & topic_id_remap) const
+{
+  // Slot 0 of the table is never filled, so an unassigned id stays 0.
+  message.topic_id =
+    message.topic_id < topic_id_remap.size() ? topic_id_remap[message.topic_id] : 0u;
+}
+
 void SequentialReader::fill_topics_metadata()
 {
   rcpputils::check_true(storage_ != nullptr, "Bag is not open. Call open() before reading.");
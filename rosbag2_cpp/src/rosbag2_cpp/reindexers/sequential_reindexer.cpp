@@ -21,11 +21,18 @@
 // This notice must appear in all copies of this file and its derivatives.
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <regex>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -80,6 +87,159 @@ std::vector<rcpputils::fs::path> resolve_relative_paths(
 }
 }  // namespace details
 
+namespace
+{
+// Checkpoint file written next to the bag while reindexing. Each completed
+// file appends one self-contained record, so an interrupted reindex resumes
+// from the files already scanned instead of restarting from scratch. The
+// format is tab-separated with newlines and backslashes escaped, since QoS
+// profile strings may span lines. The file is removed on success.
+constexpr const char * kCheckpointFilename = "reindex.checkpoint";
+constexpr const char * kCheckpointHeader = "rosbag2 reindex checkpoint v1";
+
+std::string escape_checkpoint_field(const std::string & field)
+{
+  std::string escaped;
+  escaped.reserve(field.size());
+  for (const auto character : field) {
+    switch (character) {
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      case '\t':
+        escaped += "\\t";
+        break;
+      default:
+        escaped += character;
+    }
+  }
+  return escaped;
+}
+
+std::string unescape_checkpoint_field(const std::string & field)
+{
+  std::string unescaped;
+  unescaped.reserve(field.size());
+  for (size_t i = 0; i < field.size(); ++i) {
+    if (field[i] == '\\' && i + 1 < field.size()) {
+      ++i;
+      switch (field[i]) {
+        case 'n':
+          unescaped += '\n';
+          break;
+        case 't':
+          unescaped += '\t';
+          break;
+        default:
+          unescaped += field[i];
+      }
+    } else {
+      unescaped += field[i];
+    }
+  }
+  return unescaped;
+}
+
+std::vector<std::string> split_checkpoint_line(const std::string & line)
+{
+  std::vector<std::string> fields;
+  std::istringstream stream(line);
+  std::string field;
+  while (std::getline(stream, field, '\t')) {
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+void append_checkpoint_entry(
+  std::ofstream & out,
+  const std::string & file_name,
+  const rosbag2_storage::BagMetadata & metadata)
+{
+  out << "file\t" << escape_checkpoint_field(file_name) <<
+    "\t" << metadata.starting_time.time_since_epoch().count() <<
+    "\t" << metadata.duration.count() <<
+    "\t" << metadata.message_count <<
+    "\t" << metadata.topics_with_message_count.size() << "\n";
+  for (const auto & topic : metadata.topics_with_message_count) {
+    out << "topic\t" << escape_checkpoint_field(topic.topic_metadata.name) <<
+      "\t" << escape_checkpoint_field(topic.topic_metadata.type) <<
+      "\t" << escape_checkpoint_field(topic.topic_metadata.serialization_format) <<
+      "\t" << escape_checkpoint_field(topic.topic_metadata.offered_qos_profiles) <<
+      "\t" << topic.message_count <<
+      "\t" << topic.dropped_message_count <<
+      "\t" << topic.dropped_byte_count << "\n";
+  }
+  out.flush();
+}
+
+// Parses the checkpoint into per-file metadata keyed by file name. Only
+// complete records are kept; parsing stops at the first malformed record,
+// since an interrupted run typically leaves a partial trailing entry.
+// Returns false when the header does not match, in which case the whole
+// checkpoint is discarded.
+bool load_checkpoint(
+  const rcpputils::fs::path & checkpoint_path,
+  std::unordered_map<std::string, rosbag2_storage::BagMetadata> & completed_files)
+{
+  std::ifstream in(checkpoint_path.string());
+  if (!in) {
+    return false;
+  }
+  std::string line;
+  if (!std::getline(in, line) || line != kCheckpointHeader) {
+    return false;
+  }
+
+  try {
+    while (std::getline(in, line)) {
+      auto fields = split_checkpoint_line(line);
+      if (fields.size() != 6 || fields[0] != "file") {
+        break;
+      }
+      rosbag2_storage::BagMetadata file_metadata{};
+      file_metadata.starting_time =
+        std::chrono::time_point<std::chrono::high_resolution_clock>(
+        std::chrono::nanoseconds(std::stoll(fields[2])));
+      file_metadata.duration = std::chrono::nanoseconds(std::stoll(fields[3]));
+      file_metadata.message_count = std::stoull(fields[4]);
+      const auto topic_count = std::stoull(fields[5]);
+      bool record_complete = true;
+      for (uint64_t i = 0; i < topic_count; ++i) {
+        if (!std::getline(in, line)) {
+          record_complete = false;
+          break;
+        }
+        auto topic_fields = split_checkpoint_line(line);
+        if (topic_fields.size() != 8 || topic_fields[0] != "topic") {
+          record_complete = false;
+          break;
+        }
+        rosbag2_storage::TopicInformation topic{};
+        topic.topic_metadata.name = unescape_checkpoint_field(topic_fields[1]);
+        topic.topic_metadata.type = unescape_checkpoint_field(topic_fields[2]);
+        topic.topic_metadata.serialization_format = unescape_checkpoint_field(topic_fields[3]);
+        topic.topic_metadata.offered_qos_profiles = unescape_checkpoint_field(topic_fields[4]);
+        topic.message_count = std::stoull(topic_fields[5]);
+        topic.dropped_message_count = std::stoull(topic_fields[6]);
+        topic.dropped_byte_count = std::stoull(topic_fields[7]);
+        file_metadata.topics_with_message_count.push_back(topic);
+      }
+      if (!record_complete) {
+        break;
+      }
+      completed_files[unescape_checkpoint_field(fields[1])] = file_metadata;
+    }
+  } catch (const std::exception &) {
+    // Keep whatever parsed cleanly before the malformed content.
+  }
+  return true;
+}
+}  // namespace
+
 std::string strip_parent_path(const rcpputils::fs::path & relative_path)
 {
   return relative_path.filename().string();
@@ -205,17 +365,19 @@ std::vector<rcpputils::fs::path> SequentialReindexer::get_database_files(
   return output;
 }
 
-void SequentialReindexer::open(
+std::shared_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface>
+SequentialReindexer::open_file(
   const rcpputils::fs::path & database_file,
   const StorageOptions & storage_options)
 {
   // Since this is a reindexing operation, assume that there is no metadata.yaml file.
   // As such, ask the storage with the given URI for its metadata.
-  storage_ = storage_factory_->open_read_only(
+  auto storage = storage_factory_->open_read_only(
     database_file.string(), storage_options.storage_id);
-  if (!storage_) {
+  if (!storage) {
     throw std::runtime_error{"No storage could be initialized. Abort"};
   }
+  return storage;
 }
 
 void SequentialReindexer::fill_topics_metadata()
@@ -250,13 +412,109 @@ void SequentialReindexer::aggregate_metadata(
   // In order to most accurately reconstruct the metadata, we need to
   // visit each of the contained relative database files in the bag,
   // open them, slurp up the info, and stuff it into the master
-  // metadata object.
+  // metadata object. Each file's extraction is independent, so the files
+  // are scanned by a pool of worker threads and the per-file results are
+  // merged afterwards in file order, which keeps the merge deterministic.
   ROSBAG2_CPP_LOG_INFO("Extracting metadata from database(s)");
-  for (const auto & f_ : files) {
-    open(f_.string(), storage_options);  // Class storage_ is now full
+  std::vector<rosbag2_storage::BagMetadata> per_file_metadata(files.size());
+  std::vector<bool> file_done(files.size(), false);
+
+  // Resume from a previous interrupted run, if its checkpoint parses.
+  const auto checkpoint_path = base_folder_ / kCheckpointFilename;
+  std::unordered_map<std::string, rosbag2_storage::BagMetadata> checkpointed_files;
+  if (checkpoint_path.exists() && load_checkpoint(checkpoint_path, checkpointed_files)) {
+    for (size_t i = 0; i < files.size(); ++i) {
+      auto found = checkpointed_files.find(strip_parent_path(files[i]));
+      if (found != checkpointed_files.end()) {
+        per_file_metadata[i] = found->second;
+        file_done[i] = true;
+      }
+    }
+  }
+  const size_t already_done =
+    static_cast<size_t>(std::count(file_done.begin(), file_done.end(), true));
+  if (already_done > 0) {
+    ROSBAG2_CPP_LOG_INFO_STREAM(
+      "Resuming reindex from checkpoint: " << already_done << " of " << files.size() <<
+        " file(s) already extracted.");
+  }
+
+  // Rewrite the checkpoint from the still-valid entries so stale or
+  // malformed content does not accumulate across runs.
+  std::ofstream checkpoint_out(checkpoint_path.string(), std::ios::trunc);
+  checkpoint_out << kCheckpointHeader << "\n";
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (file_done[i]) {
+      append_checkpoint_entry(checkpoint_out, strip_parent_path(files[i]), per_file_metadata[i]);
+    }
+  }
 
-    auto temp_metadata = storage_->get_metadata();
+  {
+    const size_t worker_count = std::min(
+      files.size(),
+      static_cast<size_t>(std::max(1u, std::thread::hardware_concurrency())));
+    std::atomic<size_t> next_file{0};
+    std::atomic<size_t> files_completed{already_done};
+    // Plugin loading inside the storage factory is not thread-safe; only
+    // the metadata extraction itself runs concurrently.
+    std::mutex factory_mutex;
+    std::mutex checkpoint_mutex;
+    std::mutex error_mutex;
+    std::exception_ptr extraction_error;
+    const auto extraction_start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+      workers.emplace_back(
+        [&, this]() {
+          while (true) {
+            const auto index = next_file.fetch_add(1);
+            if (index >= files.size()) {
+              return;
+            }
+            if (file_done[index]) {
+              continue;
+            }
+            try {
+              std::shared_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> storage;
+              {
+                std::lock_guard<std::mutex> lock(factory_mutex);
+                storage = open_file(files[index].string(), storage_options);
+              }
+              per_file_metadata[index] = storage->get_metadata();
+
+              const auto done = files_completed.fetch_add(1) + 1;
+              std::lock_guard<std::mutex> lock(checkpoint_mutex);
+              append_checkpoint_entry(
+                checkpoint_out, strip_parent_path(files[index]), per_file_metadata[index]);
+              const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::steady_clock::now() - extraction_start).count();
+              const auto processed_this_run = done - already_done;
+              const auto eta = processed_this_run > 0 ?
+                elapsed * (files.size() - done) / processed_this_run : 0;
+              ROSBAG2_CPP_LOG_INFO_STREAM(
+                "Reindexed " << done << "/" << files.size() << " file(s), elapsed " <<
+                  elapsed << "s, estimated " << eta << "s remaining.");
+            } catch (...) {
+              std::lock_guard<std::mutex> lock(error_mutex);
+              if (!extraction_error) {
+                extraction_error = std::current_exception();
+              }
+            }
+          }
+        });
+    }
+    for (auto & worker : workers) {
+      worker.join();
+    }
+    if (extraction_error) {
+      std::rethrow_exception(extraction_error);
+    }
+  }
+  checkpoint_out.close();
 
+  for (const auto & temp_metadata : per_file_metadata) {
     // Last opened file will have our starting time
     metadata_.starting_time = temp_metadata.starting_time;
     metadata_.duration += temp_metadata.duration;
@@ -288,9 +546,6 @@ void SequentialReindexer::aggregate_metadata(
         }
       }
     }
-
-    ROSBAG2_CPP_LOG_INFO("Closing database");
-    storage_.reset();  // Class storage_ is now empty
   }
 }
 
@@ -317,6 +572,12 @@ void SequentialReindexer::reindex(const StorageOptions & storage_options)
   finalize_metadata();
 
   metadata_io_->write_metadata(base_folder_.string(), metadata_);
+
+  // The metadata is on disk; the per-file checkpoint is no longer needed.
+  auto checkpoint_path = base_folder_ / kCheckpointFilename;
+  if (checkpoint_path.exists()) {
+    rcpputils::fs::remove(checkpoint_path);
+  }
   ROSBAG2_CPP_LOG_INFO("Reindexing operation completed.");
 }
 
@@ -14,7 +14,10 @@
 
 #include "rosbag2_cpp/types/introspection_message.hpp"
 
+#include <cstddef>
+#include <cstring>
 #include <memory>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -30,17 +33,33 @@
 namespace rosbag2_cpp
 {
 
+namespace
+{
+// Offset of the message storage within the shared block, padded so the
+// storage is aligned for any message type.
+constexpr size_t aligned_header_size()
+{
+  return (sizeof(rosbag2_introspection_message_t) + alignof(std::max_align_t) - 1) &
+         ~(alignof(std::max_align_t) - 1);
+}
+}  // namespace
+
 std::shared_ptr<rosbag2_introspection_message_t>
 allocate_introspection_message(
   const rosidl_message_type_support_t * introspection_ts, const rcutils_allocator_t * allocator)
 {
   auto intro_ts_members = static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
     introspection_ts->data);
-  auto raw_ros2_message = new rosbag2_introspection_message_t();
+  // The bookkeeping struct and the message storage share a single block, so
+  // allocating and releasing a message costs one allocator call each instead
+  // of one per part.
+  auto block = static_cast<uint8_t *>(
+    allocator->zero_allocate(
+      1, aligned_header_size() + intro_ts_members->size_of_, allocator->state));
+  auto raw_ros2_message = new (block) rosbag2_introspection_message_t();
   raw_ros2_message->allocator = *allocator;
   raw_ros2_message->topic_name = nullptr;
-  raw_ros2_message->message = raw_ros2_message->allocator.zero_allocate(
-    1, intro_ts_members->size_of_, raw_ros2_message->allocator.state);
+  raw_ros2_message->message = block + aligned_header_size();
   intro_ts_members->init_function(
     raw_ros2_message->message, rosidl_runtime_cpp::MessageInitialization::ALL);
 
@@ -54,12 +73,28 @@ void introspection_message_set_topic_name(
   rosbag2_introspection_message_t * msg, const char * topic_name)
 {
   if (msg->topic_name) {
+    if (strcmp(msg->topic_name, topic_name) == 0) {
+      // Pooled messages keep their topic between uses; nothing to replace.
+      return;
+    }
     msg->allocator.deallocate(msg->topic_name, msg->allocator.state);
     msg->topic_name = nullptr;
   }
   msg->topic_name = rcutils_strdup(topic_name, msg->allocator);
 }
 
+void introspection_message_reset(
+  rosbag2_introspection_message_t * msg,
+  const rosidl_message_type_support_t * introspection_ts)
+{
+  auto intro_ts_members = static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
+    introspection_ts->data);
+  intro_ts_members->fini_function(msg->message);
+  intro_ts_members->init_function(
+    msg->message, rosidl_runtime_cpp::MessageInitialization::ALL);
+  msg->time_stamp = 0;
+}
+
 void deallocate_introspection_message(
   rosbag2_introspection_message_t * msg,
   const rosidl_message_type_support_t * introspection_ts)
@@ -67,9 +102,11 @@ void deallocate_introspection_message(
   auto intro_ts_members = static_cast<const rosidl_typesupport_introspection_cpp::MessageMembers *>(
     introspection_ts->data);
   intro_ts_members->fini_function(msg->message);
-  msg->allocator.deallocate(msg->message, msg->allocator.state);
   msg->allocator.deallocate(msg->topic_name, msg->allocator.state);
-  delete msg;
+  // The struct and the message storage share one block; freeing the struct
+  // releases both. Copy the allocator out first since it lives in the block.
+  auto allocator = msg->allocator;
+  allocator.deallocate(msg, allocator.state);
 }
 
 }  // namespace rosbag2_cpp
@@ -15,10 +15,12 @@
 #include "rosbag2_cpp/typesupport_helpers.hpp"
 
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 
 #include "ament_index_cpp/get_resources.hpp"
@@ -102,8 +104,24 @@ std::shared_ptr<rcpputils::SharedLibrary>
 get_typesupport_library(const std::string & type, const std::string & typesupport_identifier)
 {
   auto package_name = std::get<0>(extract_type_identifier(type));
+
+  // One typesupport library serves every message type of a package, so the
+  // handles are shared process-wide instead of re-opening the same library
+  // for each topic. Entries stay loaded for the lifetime of the process;
+  // returned handles may outlive any single caller anyway.
+  static std::mutex cache_mutex;
+  static std::unordered_map<std::string, std::shared_ptr<rcpputils::SharedLibrary>> cache;
+
+  const auto cache_key = package_name + "__" + typesupport_identifier;
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto entry = cache.find(cache_key);
+  if (entry != cache.end()) {
+    return entry->second;
+  }
   auto library_path = get_typesupport_library_path(package_name, typesupport_identifier);
-  return std::make_shared<rcpputils::SharedLibrary>(library_path);
+  auto library = std::make_shared<rcpputils::SharedLibrary>(library_path);
+  cache.emplace(cache_key, library);
+  return library;
 }
 
 const rosidl_message_type_support_t *
@@ -152,4 +170,33 @@ get_typesupport_handle(
   }
 }
 
+const rosidl_message_type_support_t *
+get_typesupport_handle(
+  const std::string & type,
+  const std::string & typesupport_identifier)
+{
+  // Process-wide registry of resolved handles, mirroring the library cache
+  // above: the converter, publishers and subscriptions all need the same
+  // handle per (type, typesupport identifier) pair, so the symbol lookup
+  // runs once per process. The backing libraries are pinned by the library
+  // cache, which keeps the returned handles valid forever.
+  static std::mutex registry_mutex;
+  static std::unordered_map<std::string, const rosidl_message_type_support_t *> registry;
+
+  const auto registry_key = type + "__" + typesupport_identifier;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto entry = registry.find(registry_key);
+    if (entry != registry.end()) {
+      return entry->second;
+    }
+  }
+  // Resolve outside the lock so distinct types resolve concurrently; a lost
+  // race just stores the same handle again.
+  auto library = get_typesupport_library(type, typesupport_identifier);
+  const auto * handle = get_typesupport_handle(type, typesupport_identifier, library);
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  return registry.emplace(registry_key, handle).first->second;
+}
+
 }  // namespace rosbag2_cpp
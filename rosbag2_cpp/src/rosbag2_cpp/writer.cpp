@@ -55,22 +55,59 @@ void Writer::open(const std::string & uri)
 void Writer::open(
   const StorageOptions & storage_options, const ConverterOptions & converter_options)
 {
+  std::lock_guard<std::mutex> lock(writer_mutex_);
   writer_impl_->open(storage_options, converter_options);
+  concurrent_writes_supported_ = writer_impl_->is_write_concurrency_supported();
 }
 
 void Writer::create_topic(const rosbag2_storage::TopicMetadata & topic_with_type)
 {
+  std::lock_guard<std::mutex> lock(writer_mutex_);
   writer_impl_->create_topic(topic_with_type);
 }
 
 void Writer::remove_topic(const rosbag2_storage::TopicMetadata & topic_with_type)
 {
+  std::lock_guard<std::mutex> lock(writer_mutex_);
   writer_impl_->remove_topic(topic_with_type);
 }
 
 void Writer::write(std::shared_ptr<rosbag2_storage::SerializedBagMessage> message)
 {
+  // Multi-producer writers take concurrent writes directly, so callback
+  // threads never funnel through a facade-wide lock on the hot path.
+  std::unique_lock<std::mutex> lock(writer_mutex_, std::defer_lock);
+  if (!concurrent_writes_supported_) {
+    lock.lock();
+  }
   writer_impl_->write(message);
 }
 
+void Writer::write(rosbag2_storage::SerializedBagMessage && message)
+{
+  std::unique_lock<std::mutex> lock(writer_mutex_, std::defer_lock);
+  if (!concurrent_writes_supported_) {
+    lock.lock();
+  }
+  writer_impl_->write(std::move(message));
+}
+
+bool Writer::take_snapshot()
+{
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  return writer_impl_->take_snapshot();
+}
+
+void Writer::split_bagfile()
+{
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  writer_impl_->split_bagfile();
+}
+
+void Writer::rotate_bag(const std::string & new_base_folder)
+{
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  writer_impl_->rotate_bag(new_base_folder);
+}
+
 }  // namespace rosbag2_cpp
@@ -0,0 +1,187 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Helper executable behind ShmRelayWriter: attaches to the shared-memory
+// ring named by argv[1] and drains it into a SequentialWriter until a
+// SHUTDOWN record arrives or the recording process goes away. Not meant to
+// be run by hand.
+
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "rcutils/types/uint8_array.h"
+
+#include "rosbag2_cpp/converter_options.hpp"
+#include "rosbag2_cpp/storage_options.hpp"
+#include "rosbag2_cpp/writers/sequential_writer.hpp"
+#include "rosbag2_cpp/writers/shm_message_ring.hpp"
+
+#include "rosbag2_storage/serialized_bag_message.hpp"
+#include "rosbag2_storage/topic_metadata.hpp"
+
+namespace
+{
+using rosbag2_cpp::writers::ShmRecordType;
+using rosbag2_cpp::writers::read_string;
+using rosbag2_cpp::writers::read_uint64;
+
+constexpr std::chrono::milliseconds POP_TIMEOUT{100};
+
+void apply_open(
+  rosbag2_cpp::writers::SequentialWriter & writer, const std::vector<uint8_t> & payload)
+{
+  size_t offset = 0;
+  rosbag2_cpp::StorageOptions storage_options;
+  storage_options.uri = read_string(payload, offset);
+  storage_options.storage_id = read_string(payload, offset);
+  storage_options.storage_config_uri = read_string(payload, offset);
+  storage_options.max_bagfile_size = read_uint64(payload, offset);
+  storage_options.max_bagfile_duration = read_uint64(payload, offset);
+  storage_options.max_bagfile_messages = read_uint64(payload, offset);
+  storage_options.max_cache_size = read_uint64(payload, offset);
+  storage_options.cache_overflow_policy =
+    static_cast<rosbag2_cpp::CacheOverflowPolicy>(read_uint64(payload, offset));
+  storage_options.cache_memory_budget = read_uint64(payload, offset);
+  storage_options.metadata_checkpoint_period = read_uint64(payload, offset);
+  rosbag2_cpp::ConverterOptions converter_options;
+  converter_options.input_serialization_format = read_string(payload, offset);
+  converter_options.output_serialization_format = read_string(payload, offset);
+  writer.open(storage_options, converter_options);
+}
+
+rosbag2_storage::TopicMetadata deserialize_topic(const std::vector<uint8_t> & payload)
+{
+  size_t offset = 0;
+  rosbag2_storage::TopicMetadata topic;
+  topic.name = read_string(payload, offset);
+  topic.type = read_string(payload, offset);
+  topic.serialization_format = read_string(payload, offset);
+  topic.offered_qos_profiles = read_string(payload, offset);
+  return topic;
+}
+
+std::shared_ptr<rosbag2_storage::SerializedBagMessage>
+deserialize_message(const std::vector<uint8_t> & payload)
+{
+  size_t offset = 0;
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->time_stamp = static_cast<rcutils_time_point_value_t>(read_uint64(payload, offset));
+  message->topic_name = read_string(payload, offset);
+  const auto data_size = read_uint64(payload, offset);
+  if (offset + data_size > payload.size()) {
+    throw std::runtime_error("Malformed shared-memory record: truncated message data.");
+  }
+
+  rcutils_uint8_array_t data = rcutils_get_zero_initialized_uint8_array();
+  auto allocator = rcutils_get_default_allocator();
+  auto ret = rcutils_uint8_array_init(&data, data_size, &allocator);
+  if (ret != RCUTILS_RET_OK) {
+    throw std::runtime_error("Failed to allocate the message data array.");
+  }
+  std::memcpy(data.buffer, payload.data() + offset, data_size);
+  data.buffer_length = data_size;
+  message->serialized_data = std::shared_ptr<rcutils_uint8_array_t>(
+    new rcutils_uint8_array_t(data),
+    [](rcutils_uint8_array_t * array) {
+      rcutils_uint8_array_fini(array);
+      delete array;
+    });
+  return message;
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  if (argc != 2) {
+    std::cerr << "usage: rosbag2_writer_process <shared memory ring name>" << std::endl;
+    return 1;
+  }
+
+  std::unique_ptr<rosbag2_cpp::writers::ShmMessageRing> ring;
+  try {
+    ring = rosbag2_cpp::writers::ShmMessageRing::attach(argv[1]);
+  } catch (const std::exception & e) {
+    std::cerr << "rosbag2_writer_process: " << e.what() << std::endl;
+    return 1;
+  }
+
+  rosbag2_cpp::writers::SequentialWriter writer;
+  bool open = false;
+  ShmRecordType type;
+  std::vector<uint8_t> payload;
+  while (true) {
+    if (!ring->pop(type, payload, POP_TIMEOUT)) {
+#ifndef _WIN32
+      // Re-parented to init: the recording process died without pushing a
+      // SHUTDOWN record. Close the bag cleanly and exit.
+      if (getppid() == 1) {
+        break;
+      }
+#endif
+      continue;
+    }
+
+    if (type == ShmRecordType::SHUTDOWN) {
+      break;
+    }
+    // A failing record (e.g. a full disk rejecting one insert) is logged
+    // and skipped; aborting the drain would abandon the whole recording
+    // over a single message.
+    try {
+      switch (type) {
+        case ShmRecordType::OPEN:
+          apply_open(writer, payload);
+          open = true;
+          break;
+        case ShmRecordType::CREATE_TOPIC:
+          writer.create_topic(deserialize_topic(payload));
+          break;
+        case ShmRecordType::REMOVE_TOPIC:
+          writer.remove_topic(deserialize_topic(payload));
+          break;
+        case ShmRecordType::MESSAGE:
+          writer.write(deserialize_message(payload));
+          break;
+        case ShmRecordType::SPLIT_BAGFILE:
+          writer.split_bagfile();
+          break;
+        default:
+          std::cerr << "rosbag2_writer_process: unknown record type " <<
+            static_cast<uint32_t>(type) << std::endl;
+          break;
+      }
+    } catch (const std::exception & e) {
+      std::cerr << "rosbag2_writer_process: failed to apply a record: " << e.what() << std::endl;
+    }
+  }
+
+  if (open) {
+    try {
+      writer.reset();
+    } catch (const std::exception & e) {
+      std::cerr << "rosbag2_writer_process: failed to close the bag: " << e.what() << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -16,6 +16,10 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <iterator>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -24,7 +28,9 @@
 #include "rcpputils/filesystem_helper.hpp"
 
 #include "rosbag2_cpp/info.hpp"
+#include "rosbag2_cpp/logging.hpp"
 #include "rosbag2_cpp/storage_options.hpp"
+#include "rosbag2_storage/tracepoints.hpp"
 
 namespace rosbag2_cpp
 {
@@ -33,6 +39,16 @@ namespace writers
 
 namespace
 {
+// Number of intake lanes of the write cache. Topics are pinned to lanes by
+// their interned id, so concurrent producers only contend when their topics
+// share a lane; a handful of lanes suffices for the callback threads of a
+// multithreaded executor while keeping the collection per flush cheap.
+constexpr const size_t WRITE_INTAKE_SHARD_COUNT = 8;
+
+// How often the cache writer wakes up to honor a duration based bagfile
+// split even when no flush is due.
+constexpr const std::chrono::seconds SPLIT_POLL_INTERVAL{1};
+
 std::string format_storage_uri(const std::string & base_folder, uint64_t storage_count)
 {
   // Right now `base_folder_` is always just the folder name for where to install the bagfile.
@@ -49,6 +65,17 @@ std::string strip_parent_path(const std::string & relative_path)
   return rcpputils::fs::path(relative_path).filename().string();
 }
 
+// Moves a freshly written file over its predecessor. The rename is atomic
+// on POSIX; Windows refuses to rename over an existing file, so there the
+// old file is removed first, accepting a tiny non-atomic window.
+void rename_over(const std::string & from, const std::string & to)
+{
+  if (std::rename(from.c_str(), to.c_str()) != 0) {
+    rcpputils::fs::remove(rcpputils::fs::path(to));
+    std::rename(from.c_str(), to.c_str());
+  }
+}
+
 }  // namespace
 
 SequentialWriter::SequentialWriter(
@@ -79,6 +106,9 @@ void SequentialWriter::init_metadata()
   metadata_.starting_time = std::chrono::time_point<std::chrono::high_resolution_clock>(
     std::chrono::nanoseconds::max());
   metadata_.relative_file_paths = {strip_parent_path(storage_->get_relative_file_path())};
+  rosbag2_storage::FileInformation file_info{};
+  file_info.path = metadata_.relative_file_paths.front();
+  metadata_.files = {file_info};
 }
 
 void SequentialWriter::open(
@@ -88,34 +118,108 @@ void SequentialWriter::open(
   base_folder_ = storage_options.uri;
   max_bagfile_size_ = storage_options.max_bagfile_size;
   max_bagfile_duration = std::chrono::seconds(storage_options.max_bagfile_duration);
+  max_bagfile_messages_ = storage_options.max_bagfile_messages;
+  file_message_count_ = 0u;
   max_cache_size_ = storage_options.max_cache_size;
-  cache_.reserve(max_cache_size_);
+  max_cache_age_ = std::chrono::milliseconds(storage_options.max_cache_age);
+  oldest_staged_ns_ = 0;
+  cache_overflow_policy_ = storage_options.cache_overflow_policy;
+  cache_memory_budget_ = storage_options.cache_memory_budget;
+  if (cache_memory_budget_ != 0u && cache_memory_budget_ <= max_cache_size_) {
+    throw std::runtime_error(
+            "The cache memory budget must be larger than max_cache_size "
+            "to leave room for flushing.");
+  }
+  snapshot_mode_ = storage_options.snapshot_mode;
+  if (snapshot_mode_ && max_cache_size_ == 0u) {
+    throw std::runtime_error(
+            "Snapshot mode requires a nonzero max_cache_size to bound the snapshot buffer.");
+  }
   current_cache_size_ = 0u;
+  intake_bytes_ = 0u;
+  intake_shards_.clear();
+  for (size_t i = 0; i < WRITE_INTAKE_SHARD_COUNT; ++i) {
+    intake_shards_.push_back(std::make_unique<IntakeShard>());
+  }
 
+  // Interned topic ids start at 1; slot 0 stays the "not assigned" marker.
+  topics_by_id_.assign(1, nullptr);
+
+  // The converter and the storage plugin are each loaded through pluginlib.
+  // Loading the converter concurrently with the directory and database setup
+  // below hides one of the two library loads from the time to first write,
+  // which matters when recording is started in reaction to an incident.
+  std::future<std::unique_ptr<Converter>> converter_future;
   if (converter_options.output_serialization_format !=
     converter_options.input_serialization_format)
   {
-    converter_ = std::make_unique<Converter>(converter_options, converter_factory_);
+    converter_future = std::async(
+      std::launch::async, [this, converter_options]() {
+        return std::make_unique<Converter>(converter_options, converter_factory_);
+      });
   }
 
-  rcpputils::fs::path db_path(base_folder_);
-  if (db_path.is_directory()) {
-    std::stringstream error;
-    error << "Database directory already exists (" << db_path.string() <<
-      "), can't overwrite existing database";
-    throw std::runtime_error{error.str()};
+  active_split_directory_ = storage_options.active_split_directory;
+  if (!active_split_directory_.empty()) {
+    if (max_bagfile_size_ == rosbag2_storage::storage_interfaces::MAX_BAGFILE_SIZE_NO_SPLIT &&
+      storage_options.max_bagfile_duration == 0u && max_bagfile_messages_ == 0u)
+    {
+      throw std::runtime_error(
+              "Tiered recording requires bagfile splitting; without splits the whole "
+              "recording would have to fit into the active-split directory.");
+    }
+    rcpputils::fs::create_directories(rcpputils::fs::path(active_split_directory_));
   }
 
-  bool dir_created = rcpputils::fs::create_directories(db_path);
-  if (!dir_created) {
-    std::stringstream error;
-    error << "Failed to create database directory (" << db_path.string() << ").";
-    throw std::runtime_error{error.str()};
+  rcpputils::fs::path db_path(base_folder_);
+  bool appending = false;
+  if (db_path.is_directory()) {
+    if (!storage_options.append_mode) {
+      std::stringstream error;
+      error << "Database directory already exists (" << db_path.string() <<
+        "), can't overwrite existing database";
+      throw std::runtime_error{error.str()};
+    }
+    if (!metadata_io_->metadata_file_exists(base_folder_)) {
+      std::stringstream error;
+      error << "Cannot append to bag (" << db_path.string() <<
+        "): no metadata file found. Was this directory written by rosbag2?";
+      throw std::runtime_error{error.str()};
+    }
+    // Resume the existing bag: its metadata carries the file sequence and
+    // the per-topic counts this session continues from.
+    metadata_ = metadata_io_->read_metadata(base_folder_);
+    if (!storage_options.storage_id.empty() &&
+      metadata_.storage_identifier != storage_options.storage_id)
+    {
+      std::stringstream error;
+      error << "Cannot append to bag (" << db_path.string() << "): it was written with storage '" <<
+        metadata_.storage_identifier << "', not '" << storage_options.storage_id << "'.";
+      throw std::runtime_error{error.str()};
+    }
+    appending = true;
+  } else {
+    bool dir_created = rcpputils::fs::create_directories(db_path);
+    if (!dir_created) {
+      std::stringstream error;
+      error << "Failed to create database directory (" << db_path.string() << ").";
+      throw std::runtime_error{error.str()};
+    }
   }
 
-  const auto storage_uri = format_storage_uri(base_folder_, 0);
+  // Appending continues the split sequence after the last file of the
+  // previous session; the existing files are never reopened for writing, so
+  // a resume is safe even after a hard crash.
+  const auto storage_uri = format_active_storage_uri(
+    appending ? metadata_.relative_file_paths.size() : 0);
 
-  storage_ = storage_factory_->open_read_write(storage_uri, storage_options.storage_id);
+  storage_config_uri_ = storage_options.storage_config_uri;
+  // When resuming, an unspecified storage id falls back to whatever wrote
+  // the bag, so a plain restart needs no storage configuration at all.
+  const auto storage_id = (appending && storage_options.storage_id.empty()) ?
+    metadata_.storage_identifier : storage_options.storage_id;
+  storage_ = storage_factory_->open_read_write(
+    storage_uri, storage_id, storage_config_uri_);
   if (!storage_) {
     throw std::runtime_error("No storage could be initialized. Abort");
   }
@@ -130,16 +234,100 @@ void SequentialWriter::open(
     throw std::runtime_error{error.str()};
   }
 
-  init_metadata();
+  if (max_bagfile_size_ != rosbag2_storage::storage_interfaces::MAX_BAGFILE_SIZE_NO_SPLIT) {
+    storage_->preallocate(max_bagfile_size_);
+  }
+
+  if (converter_future.valid()) {
+    // Rethrows a converter loading failure, as the inline load used to.
+    converter_ = converter_future.get();
+  }
+
+  if (appending) {
+    continue_metadata();
+  } else {
+    init_metadata();
+  }
+
+  // In snapshot mode the buffer is only drained on take_snapshot(), so no
+  // background writer thread is needed.
+  if (max_cache_size_ > 0u && !snapshot_mode_) {
+    start_cache_writer();
+  }
+
+  metadata_checkpoint_period_ = std::chrono::seconds(storage_options.metadata_checkpoint_period);
+  if (metadata_checkpoint_period_ > std::chrono::seconds(0)) {
+    start_metadata_checkpointing();
+  }
+
+  if (!active_split_directory_.empty()) {
+    start_file_migrator();
+  }
+}
+
+void SequentialWriter::continue_metadata()
+{
+  // metadata_ already holds the previous session's history; only the new
+  // active file is appended to it. The saved per-topic bookkeeping is
+  // re-interned so message counts carry on instead of restarting at zero;
+  // the size histograms start empty, so the summarized percentiles only
+  // describe this session's messages.
+  rosbag2_storage::FileInformation file_info{};
+  file_info.path = strip_parent_path(storage_->get_relative_file_path());
+  metadata_.relative_file_paths.push_back(file_info.path);
+  metadata_.files.push_back(file_info);
+
+  for (const auto & saved_topic : metadata_.topics_with_message_count) {
+    rosbag2_storage::TopicInformation info = saved_topic;
+    info.topic_metadata.topic_id = static_cast<uint32_t>(topics_by_id_.size());
+    auto insert_res = topics_names_to_info_.insert(
+      std::make_pair(info.topic_metadata.name, info));
+    if (!insert_res.second) {
+      continue;
+    }
+    topics_by_id_.push_back(&insert_res.first->second);
+    if (converter_) {
+      converter_->add_topic(info.topic_metadata.name, info.topic_metadata.type);
+    }
+    storage_->create_topic(insert_res.first->second.topic_metadata);
+  }
 }
 
 void SequentialWriter::reset()
 {
+  stop_metadata_checkpointing();
+  stop_cache_writer();
+
+  // If a pre-opened split file was never adopted, close and remove it again
+  // so no empty orphan database is left next to the recording.
+  if (next_storage_future_.valid()) {
+    auto unused_storage = next_storage_future_.get();
+    if (unused_storage) {
+      const auto unused_path = unused_storage->get_relative_file_path();
+      unused_storage.reset();
+      rcpputils::fs::remove(rcpputils::fs::path(unused_path));
+    }
+  }
+
   if (!base_folder_.empty()) {
     finalize_metadata();
     metadata_io_->write_metadata(base_folder_, metadata_);
   }
 
+  // Closing the bag seals the last file. In tiered mode the storage must be
+  // closed before the migrator may move the file out of the RAM disk.
+  if (storage_) {
+    const auto sealed_file_path = storage_->get_relative_file_path();
+    const auto sealed_file_size = storage_->get_bagfile_size();
+    if (!active_split_directory_.empty()) {
+      storage_.reset();
+    }
+    migrate_or_notify_sealed_file(
+      sealed_file_path, base_folder_, sealed_file_size, file_start_time_ns_, file_end_time_ns_);
+    restart_file_time_range();
+  }
+  stop_file_migrator();
+
   storage_.reset();  // Necessary to ensure that the storage is destroyed before the factory
   storage_factory_.reset();
 }
@@ -160,17 +348,30 @@ void SequentialWriter::create_topic(const rosbag2_storage::TopicMetadata & topic
     rosbag2_storage::TopicInformation info{};
     info.topic_metadata = topic_with_type;
 
-    const auto insert_res = topics_names_to_info_.insert(
-      std::make_pair(topic_with_type.name, info));
+    bool inserted = false;
+    {
+      std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+      // Intern a numeric id for the topic; messages carrying it skip the
+      // by-name lookup on the write hot path.
+      info.topic_metadata.topic_id = static_cast<uint32_t>(topics_by_id_.size());
+      auto insert_res = topics_names_to_info_.insert(
+        std::make_pair(topic_with_type.name, info));
+      inserted = insert_res.second;
+      if (inserted) {
+        topics_by_id_.push_back(&insert_res.first->second);
+      }
+    }
 
-    if (!insert_res.second) {
+    if (!inserted) {
       std::stringstream errmsg;
       errmsg << "Failed to insert topic \"" << topic_with_type.name << "\"!";
 
       throw std::runtime_error(errmsg.str());
     }
 
-    storage_->create_topic(topic_with_type);
+    // Hand the id-stamped metadata to the storage, so it can map the
+    // interned id onto its own topic key without name lookups per message.
+    storage_->create_topic(info.topic_metadata);
   }
 }
 
@@ -180,7 +381,18 @@ void SequentialWriter::remove_topic(const rosbag2_storage::TopicMetadata & topic
     throw std::runtime_error("Bag is not open. Call open() before removing.");
   }
 
-  if (topics_names_to_info_.erase(topic_with_type.name) > 0) {
+  size_t erased = 0;
+  {
+    std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+    auto topic_entry = topics_names_to_info_.find(topic_with_type.name);
+    if (topic_entry != topics_names_to_info_.end()) {
+      // Interned ids are never reused; the removed topic leaves a null slot.
+      topics_by_id_[topic_entry->second.topic_metadata.topic_id] = nullptr;
+      topics_names_to_info_.erase(topic_entry);
+      erased = 1;
+    }
+  }
+  if (erased > 0) {
     storage_->remove_topic(topic_with_type);
   } else {
     std::stringstream errmsg;
@@ -191,75 +403,847 @@ void SequentialWriter::remove_topic(const rosbag2_storage::TopicMetadata & topic
   }
 }
 
-void SequentialWriter::split_bagfile()
+void SequentialWriter::set_topic_rmw_lost_count(
+  const std::string & topic_name, uint64_t lost_count)
+{
+  // The metadata lock also covers the per-topic counters.
+  std::lock_guard<std::mutex> lock(metadata_mutex_);
+  auto info = topics_names_to_info_.find(topic_name);
+  if (info != topics_names_to_info_.end()) {
+    info->second.rmw_lost_message_count = lost_count;
+  }
+}
+
+void SequentialWriter::set_sealed_file_callback(
+  std::function<void(const SealedBagfileInfo &)> callback)
+{
+  sealed_file_callback_ = callback;
+}
+
+void SequentialWriter::notify_file_sealed(
+  const std::string & file_path, uint64_t file_size,
+  int64_t starting_time_ns, int64_t ending_time_ns)
+{
+  if (!sealed_file_callback_) {
+    return;
+  }
+  SealedBagfileInfo sealed_file{};
+  sealed_file.file_path = file_path;
+  sealed_file.file_size = file_size;
+  sealed_file.starting_time_ns = starting_time_ns;
+  sealed_file.ending_time_ns = ending_time_ns;
+  sealed_file_callback_(sealed_file);
+}
+
+void SequentialWriter::restart_file_time_range()
+{
+  file_start_time_ns_ = INT64_MAX;
+  file_end_time_ns_ = INT64_MIN;
+}
+
+std::string SequentialWriter::format_active_storage_uri(uint64_t storage_count) const
+{
+  if (active_split_directory_.empty()) {
+    return format_storage_uri(base_folder_, storage_count);
+  }
+  // Same file name as the untiered layout, but in the RAM-backed directory;
+  // the migrator moving the sealed file into base_folder_ then restores
+  // exactly the path metadata_.relative_file_paths already records.
+  std::stringstream storage_file_name;
+  storage_file_name << rcpputils::fs::path(base_folder_).filename().string() <<
+    "_" << storage_count;
+  return (rcpputils::fs::path(active_split_directory_) / storage_file_name.str()).string();
+}
+
+void SequentialWriter::migrate_or_notify_sealed_file(
+  const std::string & file_path, const std::string & destination_folder,
+  uint64_t file_size, int64_t starting_time_ns, int64_t ending_time_ns)
+{
+  if (active_split_directory_.empty()) {
+    notify_file_sealed(file_path, file_size, starting_time_ns, ending_time_ns);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(file_migrator_mutex_);
+    pending_migrations_.push_back(
+      {file_path, destination_folder, file_size, starting_time_ns, ending_time_ns});
+  }
+  file_migrator_condition_.notify_one();
+}
+
+void SequentialWriter::start_file_migrator()
 {
-  const auto storage_uri = format_storage_uri(
-    base_folder_,
-    metadata_.relative_file_paths.size());
-  storage_ = storage_factory_->open_read_write(storage_uri, metadata_.storage_identifier);
+  stop_file_migrator_ = false;
+  file_migrator_thread_ = std::thread(&SequentialWriter::file_migrator_loop, this);
+}
 
+void SequentialWriter::stop_file_migrator()
+{
+  if (!file_migrator_thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(file_migrator_mutex_);
+    stop_file_migrator_ = true;
+  }
+  file_migrator_condition_.notify_all();
+  file_migrator_thread_.join();
+}
+
+void SequentialWriter::file_migrator_loop()
+{
+  while (true) {
+    FileMigration migration;
+    {
+      std::unique_lock<std::mutex> lock(file_migrator_mutex_);
+      file_migrator_condition_.wait(
+        lock, [this]() {return !pending_migrations_.empty() || stop_file_migrator_;});
+      if (pending_migrations_.empty()) {
+        return;
+      }
+      migration = std::move(pending_migrations_.front());
+      pending_migrations_.pop_front();
+    }
+    migrate_file(migration);
+  }
+}
+
+void SequentialWriter::migrate_file(const FileMigration & migration)
+{
+  const auto destination =
+    (rcpputils::fs::path(migration.destination_folder) /
+    rcpputils::fs::path(migration.source_path).filename()).string();
+
+  // The RAM disk and the destination are almost always different
+  // filesystems, where rename fails with EXDEV; fall back to a streamed
+  // copy. Device latency spikes during the copy only stall this thread.
+  if (std::rename(migration.source_path.c_str(), destination.c_str()) != 0) {
+    std::ifstream source(migration.source_path, std::ios::in | std::ios::binary);
+    std::ofstream target(destination, std::ios::out | std::ios::binary);
+    target << source.rdbuf();
+    if (!source || !target) {
+      ROSBAG2_CPP_LOG_ERROR_STREAM(
+        "Failed to migrate sealed bagfile '" << migration.source_path <<
+          "' to '" << destination << "'; the file stays on the RAM disk.");
+      notify_file_sealed(
+        migration.source_path, migration.file_size,
+        migration.starting_time_ns, migration.ending_time_ns);
+      return;
+    }
+    source.close();
+    target.close();
+    rcpputils::fs::remove(rcpputils::fs::path(migration.source_path));
+  }
+
+  notify_file_sealed(
+    destination, migration.file_size,
+    migration.starting_time_ns, migration.ending_time_ns);
+}
+
+void SequentialWriter::split_bagfile()
+{
   if (!storage_) {
+    throw std::runtime_error("Bag is not open. Call open() before splitting.");
+  }
+
+  const auto storage_uri = format_active_storage_uri(metadata_.relative_file_paths.size());
+
+  const auto sealed_file_path = storage_->get_relative_file_path();
+  const auto sealed_file_size = storage_->get_bagfile_size();
+
+  // Adopt the storage pre-opened on the background thread if there is one;
+  // otherwise fall back to opening the next file synchronously.
+  std::shared_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface> next_storage;
+  if (next_storage_future_.valid()) {
+    next_storage = next_storage_future_.get();
+  }
+  if (!next_storage) {
+    next_storage = storage_factory_->open_read_write(
+      storage_uri, metadata_.storage_identifier, storage_config_uri_);
+    if (next_storage &&
+      max_bagfile_size_ != rosbag2_storage::storage_interfaces::MAX_BAGFILE_SIZE_NO_SPLIT)
+    {
+      next_storage->preallocate(max_bagfile_size_);
+    }
+  }
+
+  if (!next_storage) {
     std::stringstream errmsg;
     errmsg << "Failed to rollover bagfile to new file: \"" << storage_uri << "\"!";
 
     throw std::runtime_error(errmsg.str());
   }
 
-  metadata_.relative_file_paths.push_back(strip_parent_path(storage_->get_relative_file_path()));
+  std::lock_guard<std::mutex> storage_lock(storage_mutex_);
+  storage_ = next_storage;
 
-  // Re-register all topics since we rolled-over to a new bagfile.
-  for (const auto & topic : topics_names_to_info_) {
-    storage_->create_topic(topic.second.topic_metadata);
+  {
+    std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+    // Seal the time range of the finished file and start an entry for the
+    // new one, so readers can prune split files outside a time window.
+    record_active_file_range();
+    rosbag2_storage::FileInformation file_info{};
+    file_info.path = strip_parent_path(storage_->get_relative_file_path());
+    metadata_.relative_file_paths.push_back(file_info.path);
+    metadata_.files.push_back(file_info);
+  }
+
+  {
+    // Re-register all topics since we rolled-over to a new bagfile. For a
+    // pre-opened storage this only adds topics created after the pre-open.
+    std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+    for (const auto & topic : topics_names_to_info_) {
+      storage_->create_topic(topic.second.topic_metadata);
+    }
+  }
+
+  // The swap above dropped the last reference to the sealed storage, so the
+  // file is closed and safe to hand to the migrator.
+  migrate_or_notify_sealed_file(
+    sealed_file_path, base_folder_, sealed_file_size, file_start_time_ns_, file_end_time_ns_);
+  restart_file_time_range();
+  file_message_count_ = 0u;
+
+  // A split seals a file; checkpoint the metadata so the sealed portion of
+  // the bag is readable even if the recording dies later.
+  if (metadata_checkpoint_period_ > std::chrono::seconds(0)) {
+    checkpoint_metadata();
   }
 }
 
-void SequentialWriter::write(std::shared_ptr<rosbag2_storage::SerializedBagMessage> message)
+void SequentialWriter::rotate_bag(const std::string & new_base_folder)
 {
   if (!storage_) {
-    throw std::runtime_error("Bag is not open. Call open() before writing.");
+    throw std::runtime_error("Bag is not open. Call open() before rotating.");
+  }
+  if (snapshot_mode_) {
+    throw std::runtime_error("Cannot rotate a bag in snapshot mode.");
   }
 
-  // Update the message count for the Topic.
-  try {
-    ++topics_names_to_info_.at(message->topic_name).message_count;
-  } catch (const std::out_of_range & /* oor */) {
+  // Create the new session's directory first: when the target (e.g. a
+  // freshly mounted disk) is not writable, the rotation fails before the
+  // current recording is touched.
+  rcpputils::fs::path new_path(new_base_folder);
+  if (new_path.is_directory()) {
+    std::stringstream error;
+    error << "Rotation target directory already exists (" << new_path.string() <<
+      "), can't overwrite existing database";
+    throw std::runtime_error{error.str()};
+  }
+  if (!rcpputils::fs::create_directories(new_path)) {
+    std::stringstream error;
+    error << "Failed to create database directory (" << new_path.string() << ").";
+    throw std::runtime_error{error.str()};
+  }
+
+  // A split file pre-opened in the old folder will never be adopted; close
+  // and remove it so no empty orphan database is left behind.
+  if (next_storage_future_.valid()) {
+    auto unused_storage = next_storage_future_.get();
+    if (unused_storage) {
+      const auto unused_path = unused_storage->get_relative_file_path();
+      unused_storage.reset();
+      rcpputils::fs::remove(rcpputils::fs::path(unused_path));
+    }
+  }
+
+  // Open the first file of the new session before anything is sealed, so a
+  // failure here leaves the current recording fully intact.
+  std::string storage_uri;
+  if (active_split_directory_.empty()) {
+    storage_uri = format_storage_uri(new_base_folder, 0);
+  } else {
+    std::stringstream storage_file_name;
+    storage_file_name << rcpputils::fs::path(new_base_folder).filename().string() << "_0";
+    storage_uri =
+      (rcpputils::fs::path(active_split_directory_) / storage_file_name.str()).string();
+  }
+  auto next_storage = storage_factory_->open_read_write(
+    storage_uri, metadata_.storage_identifier, storage_config_uri_);
+  if (!next_storage) {
     std::stringstream errmsg;
-    errmsg << "Failed to write on topic '" << message->topic_name <<
-      "'. Call create_topic() before first write.";
+    errmsg << "Failed to rotate bag to new folder: \"" << new_base_folder << "\"!";
     throw std::runtime_error(errmsg.str());
   }
+  if (max_bagfile_size_ != rosbag2_storage::storage_interfaces::MAX_BAGFILE_SIZE_NO_SPLIT) {
+    next_storage->preallocate(max_bagfile_size_);
+  }
 
-  if (should_split_bagfile()) {
-    split_bagfile();
+  const auto sealed_file_path = storage_->get_relative_file_path();
+  const auto sealed_file_size = storage_->get_bagfile_size();
+  const auto previous_base_folder = base_folder_;
 
-    // Update bagfile starting time
-    metadata_.starting_time = std::chrono::high_resolution_clock::now();
+  // The checkpoint lock keeps a concurrent metadata checkpoint from writing
+  // the old session's snapshot into the new folder mid-rotation.
+  std::lock_guard<std::mutex> checkpoint_lock(metadata_checkpoint_write_mutex_);
+  rosbag2_storage::BagMetadata sealed_metadata;
+  int64_t sealed_start_time_ns;
+  int64_t sealed_end_time_ns;
+  {
+    std::lock_guard<std::mutex> storage_lock(storage_mutex_);
+    std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+
+    // Seal the old session: snapshot its finalized metadata...
+    finalize_metadata();
+    sealed_metadata = metadata_;
+    sealed_start_time_ns = file_start_time_ns_;
+    sealed_end_time_ns = file_end_time_ns_;
+
+    // ...and swap in the new session. Producers keep staging messages
+    // throughout; whichever side of the swap a message lands on, it is
+    // persisted - nothing is dropped across the transition.
+    storage_ = next_storage;
+    base_folder_ = new_base_folder;
+    restart_file_time_range();
+    file_message_count_ = 0u;
+    init_metadata();
+    for (auto & topic : topics_names_to_info_) {
+      // The topic registrations carry over to the new session; only the
+      // per-session counters and size histograms restart.
+      auto & info = topic.second;
+      info.message_count = 0;
+      info.dropped_message_count = 0;
+      info.dropped_byte_count = 0;
+      info.rmw_lost_message_count = 0;
+      info.message_size_max = 0;
+      info.message_size_p50 = 0;
+      info.message_size_p90 = 0;
+      info.message_size_p99 = 0;
+      info.message_size_histogram.fill(0);
+      storage_->create_topic(info.topic_metadata);
+    }
   }
 
-  const auto message_timestamp = std::chrono::time_point<std::chrono::high_resolution_clock>(
-    std::chrono::nanoseconds(message->time_stamp));
-  metadata_.starting_time = std::min(metadata_.starting_time, message_timestamp);
+  metadata_io_->write_metadata(previous_base_folder, sealed_metadata);
 
-  const auto duration = message_timestamp - metadata_.starting_time;
-  metadata_.duration = std::max(metadata_.duration, duration);
+  // The swap above dropped the last reference to the sealed storage, so the
+  // file is closed and safe to hand to the migrator. The captured
+  // destination keeps it bound to the previous folder.
+  migrate_or_notify_sealed_file(
+    sealed_file_path, previous_base_folder, sealed_file_size,
+    sealed_start_time_ns, sealed_end_time_ns);
+}
 
-  auto converted_msg = get_writeable_message(message);
-  // if cache size is set to zero, we directly call write
-  if (max_cache_size_ == 0u) {
-    storage_->write(converted_msg);
+void SequentialWriter::prepare_next_storage()
+{
+  std::string storage_uri;
+  std::vector<rosbag2_storage::TopicMetadata> topics;
+  {
+    // Snapshot the topics so the background open does not race topics
+    // created while the file is prepared; the split re-registers those.
+    std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+    storage_uri = format_active_storage_uri(metadata_.relative_file_paths.size());
+    topics.reserve(topics_names_to_info_.size());
+    for (const auto & topic : topics_names_to_info_) {
+      topics.push_back(topic.second.topic_metadata);
+    }
+  }
+
+  const auto storage_id = metadata_.storage_identifier;
+  next_storage_future_ = std::async(
+    std::launch::async,
+    [this, storage_uri, storage_id, topics]() {
+      auto storage = storage_factory_->open_read_write(
+        storage_uri, storage_id, storage_config_uri_);
+      if (storage) {
+        storage->preallocate(max_bagfile_size_);
+        for (const auto & topic : topics) {
+          storage->create_topic(topic);
+        }
+      }
+      return storage;
+    });
+}
+
+void SequentialWriter::write(std::shared_ptr<rosbag2_storage::SerializedBagMessage> message)
+{
+  if (!storage_) {
+    throw std::runtime_error("Bag is not open. Call open() before writing.");
+  }
+
+  if (message->topic_id == 0u) {
+    // Producers which stamp interned ids (see get_topic_id) skip this lock;
+    // everyone else resolves and validates their topic here, per message.
+    std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+    message->topic_id = topic_info_for(*message).topic_metadata.topic_id;
+  }
+
+  std::shared_ptr<rosbag2_storage::SerializedBagMessage> converted_msg;
+  if (converter_) {
+    std::lock_guard<std::mutex> converter_lock(converter_mutex_);
+    converted_msg = get_writeable_message(message);
   } else {
-    cache_.push_back(converted_msg);
+    converted_msg = get_writeable_message(message);
+  }
+
+  if (snapshot_mode_) {
+    // Append to the circular buffer, evicting the oldest messages to stay
+    // within the configured byte budget. The message count in the metadata
+    // is only updated for messages which actually get persisted.
+    std::lock_guard<std::mutex> cache_lock(cache_mutex_);
+    snapshot_buffer_.push_back(converted_msg);
     current_cache_size_ += converted_msg->serialized_data->buffer_length;
-    if (current_cache_size_ >= max_cache_size_) {
-      storage_->write(cache_);
-      // reset cache
-      cache_.clear();
-      cache_.reserve(max_cache_size_);
-      current_cache_size_ = 0u;
+    while (current_cache_size_ > max_cache_size_ && !snapshot_buffer_.empty()) {
+      current_cache_size_ -= snapshot_buffer_.front()->serialized_data->buffer_length;
+      snapshot_buffer_.pop_front();
+    }
+    return;
+  }
+
+  // Without a cache every write goes straight to the storage; concurrent
+  // producers then serialize here, bookkeeping and split checks included.
+  if (max_cache_size_ == 0u) {
+    std::lock_guard<std::mutex> direct_lock(direct_write_mutex_);
+
+    {
+      std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+      auto & info = topic_info_for(*converted_msg);
+      ++info.message_count;
+      record_message_size(info, *converted_msg);
+    }
+
+    if (should_split_bagfile()) {
+      split_bagfile();
+
+      // Update bagfile starting time
+      std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+      metadata_.starting_time = std::chrono::high_resolution_clock::now();
+    } else if (should_prepare_next_storage()) {
+      prepare_next_storage();
+    }
+
+    {
+      std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+      const auto message_timestamp = std::chrono::time_point<std::chrono::high_resolution_clock>(
+        std::chrono::nanoseconds(converted_msg->time_stamp));
+      metadata_.starting_time = std::min(metadata_.starting_time, message_timestamp);
+
+      const auto duration = message_timestamp - metadata_.starting_time;
+      metadata_.duration = std::max(metadata_.duration, duration);
+
+      file_start_time_ns_ = std::min(file_start_time_ns_, converted_msg->time_stamp);
+      file_end_time_ns_ = std::max(file_end_time_ns_, converted_msg->time_stamp);
+    }
+    ++file_message_count_;
+
+    ROSBAG2_TRACEPOINT1(writer_write_direct, converted_msg->serialized_data->buffer_length);
+    std::lock_guard<std::mutex> storage_lock(storage_mutex_);
+    storage_->write(converted_msg);
+    return;
+  }
+
+  // Cached mode: stage the message in the intake lane owning its topic. The
+  // per-batch bookkeeping and split checks happen on the cache writer
+  // thread, so this path takes no lock shared with other lanes.
+  auto & shard = *intake_shards_[converted_msg->topic_id % intake_shards_.size()];
+  bool cache_full = false;
+  {
+    std::unique_lock<std::mutex> shard_lock(shard.mutex);
+    if (cache_overflow_policy_ == CacheOverflowPolicy::BLOCK) {
+      shard.drained_condition.wait(
+        shard_lock,
+        [this] {return stop_cache_writer_.load() || intake_bytes_ < 2 * max_cache_size_;});
+    }
+    shard.buffer.push_back(converted_msg);
+    shard.bytes += converted_msg->serialized_data->buffer_length;
+    if (max_cache_age_.count() > 0) {
+      // Stamp the first message of a fresh batch; the cache writer thread
+      // flushes once this stamp ages past max_cache_age_, so durability
+      // latency is bounded even while the intake only trickles.
+      int64_t expected = 0;
+      oldest_staged_ns_.compare_exchange_strong(
+        expected,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count(),
+        std::memory_order_relaxed);
+    }
+    const auto buffered_bytes =
+      intake_bytes_.fetch_add(converted_msg->serialized_data->buffer_length) +
+      converted_msg->serialized_data->buffer_length;
+    ROSBAG2_TRACEPOINT2(
+      writer_cache_append, converted_msg->serialized_data->buffer_length, buffered_bytes);
+    if (cache_overflow_policy_ == CacheOverflowPolicy::DROP_OLDEST ||
+      cache_overflow_policy_ == CacheOverflowPolicy::DROP_LARGEST_TOPIC)
+    {
+      while (intake_bytes_ >= 2 * max_cache_size_ && shard.buffer.size() > 1) {
+        drop_from_cache(cache_overflow_policy_, shard);
+      }
     }
+    if (cache_memory_budget_ != 0u) {
+      enforce_cache_memory_budget(shard);
+    }
+    cache_full = intake_bytes_ >= max_cache_size_ || flush_requested_;
+  }
+  if (cache_full) {
+    cache_condition_.notify_one();
   }
 }
 
+bool SequentialWriter::is_write_concurrency_supported() const
+{
+  return true;
+}
+
+void SequentialWriter::start_cache_writer()
+{
+  stop_cache_writer_ = false;
+  cache_writer_thread_ = std::thread(&SequentialWriter::cache_writer_loop, this);
+}
+
+void SequentialWriter::stop_cache_writer()
+{
+  if (cache_writer_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> cache_lock(cache_mutex_);
+      stop_cache_writer_ = true;
+    }
+    cache_condition_.notify_one();
+    // Wake producers blocked by the BLOCK overflow policy; the lane lock
+    // pairs the notification with their predicate check.
+    for (auto & shard : intake_shards_) {
+      std::lock_guard<std::mutex> shard_lock(shard->mutex);
+      shard->drained_condition.notify_all();
+    }
+    cache_writer_thread_.join();
+  }
+}
+
+void SequentialWriter::drop_from_cache(CacheOverflowPolicy policy, IntakeShard & shard)
+{
+  auto victim = shard.buffer.begin();
+
+  if (policy == CacheOverflowPolicy::DROP_LARGEST_TOPIC) {
+    // Evict from the topic hogging the most bytes of this lane; its oldest
+    // buffered message goes first.
+    std::unordered_map<std::string, uint64_t> bytes_per_topic;
+    for (const auto & message : shard.buffer) {
+      bytes_per_topic[message->topic_name] += message->serialized_data->buffer_length;
+    }
+    const auto largest_topic = std::max_element(
+      bytes_per_topic.begin(), bytes_per_topic.end(),
+      [](const auto & lhs, const auto & rhs) {return lhs.second < rhs.second;});
+    victim = std::find_if(
+      shard.buffer.begin(), shard.buffer.end(),
+      [&largest_topic](const auto & message) {
+        return message->topic_name == largest_topic->first;
+      });
+  }
+
+  {
+    // Dropped messages never reach the cache writer thread, so they were
+    // not counted yet; only the drop counters need updating.
+    std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+    auto & info = topic_info_for(**victim);
+    ++info.dropped_message_count;
+    info.dropped_byte_count += (*victim)->serialized_data->buffer_length;
+  }
+
+  shard.bytes -= (*victim)->serialized_data->buffer_length;
+  intake_bytes_.fetch_sub((*victim)->serialized_data->buffer_length);
+  shard.buffer.erase(victim);
+}
+
+void SequentialWriter::enforce_cache_memory_budget(IntakeShard & shard)
+{
+  const auto buffered_bytes = intake_bytes_.load() + secondary_cache_size_.load();
+  if (buffered_bytes < cache_memory_budget_ / 2) {
+    return;
+  }
+
+  // First escalation level: flush early so the storage gets a chance to
+  // catch up before the budget is exhausted.
+  if (!flush_requested_.exchange(true)) {
+    const auto pressure_events = ++cache_pressure_events_;
+    if (pressure_events == 1 || pressure_events % 100 == 0) {
+      ROSBAG2_CPP_LOG_WARN_STREAM(
+        "Write cache memory pressure: " << buffered_bytes << " of " <<
+          cache_memory_budget_ << " budgeted bytes are in use (event " <<
+          pressure_events << ").");
+    }
+  }
+
+  // Second escalation level: the budget is exhausted, shed load by dropping
+  // buffered messages of the topics occupying the most of this lane.
+  const auto dropped_before = budget_dropped_messages_.load();
+  while (intake_bytes_.load() + secondary_cache_size_.load() >= cache_memory_budget_ &&
+    shard.buffer.size() > 1)
+  {
+    drop_from_cache(CacheOverflowPolicy::DROP_LARGEST_TOPIC, shard);
+    ++budget_dropped_messages_;
+  }
+  const auto dropped_now = budget_dropped_messages_.load();
+  if (dropped_now != dropped_before &&
+    (dropped_before == 0 || dropped_now / 1000 != dropped_before / 1000))
+  {
+    ROSBAG2_CPP_LOG_WARN_STREAM(
+      "Write cache memory budget exhausted; " << dropped_now <<
+        " messages were dropped so far to stay within " << cache_memory_budget_ << " bytes.");
+  }
+}
+
+bool SequentialWriter::cache_age_exceeded() const
+{
+  if (max_cache_age_.count() == 0 || intake_bytes_.load() == 0u) {
+    return false;
+  }
+  const int64_t oldest = oldest_staged_ns_.load(std::memory_order_relaxed);
+  if (oldest == 0) {
+    return false;
+  }
+  const auto now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+  return now_ns - oldest >=
+         std::chrono::duration_cast<std::chrono::nanoseconds>(max_cache_age_).count();
+}
+
+void SequentialWriter::cache_writer_loop()
+{
+  // Duration based splits must fire even while the intake only trickles, so
+  // the wait then wakes up periodically; otherwise this thread only wakes
+  // for a full cache, an early-flush request or shutdown.
+  const bool poll_for_duration_split =
+    max_bagfile_duration != std::chrono::seconds(
+    rosbag2_storage::storage_interfaces::MAX_BAGFILE_DURATION_NO_SPLIT);
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> cache_lock(cache_mutex_);
+      const auto flush_due = [this] {
+          return stop_cache_writer_.load() || flush_requested_.load() ||
+                 intake_bytes_.load() >= max_cache_size_ ||
+                 cache_age_exceeded();
+        };
+      if (poll_for_duration_split || max_cache_age_.count() > 0) {
+        // The age trigger fires on a wakeup, so the wait slice must not
+        // exceed the configured age.
+        auto wait_slice = std::chrono::milliseconds(SPLIT_POLL_INTERVAL);
+        if (max_cache_age_.count() > 0) {
+          wait_slice = std::min(wait_slice, max_cache_age_);
+        }
+        cache_condition_.wait_for(cache_lock, wait_slice, flush_due);
+      } else {
+        cache_condition_.wait(cache_lock, flush_due);
+      }
+    }
+
+    // Collect all intake lanes into the secondary buffer, preserving the
+    // per-topic order within each lane. clear() keeps the vector capacities,
+    // so the lane buffers and the secondary buffer settle on the size of a
+    // typical batch and are recycled across flushes without reallocation.
+    flush_requested_ = false;
+    uint64_t collected_bytes = 0u;
+    for (auto & shard : intake_shards_) {
+      std::lock_guard<std::mutex> shard_lock(shard->mutex);
+      secondary_cache_.insert(
+        secondary_cache_.end(),
+        std::make_move_iterator(shard->buffer.begin()),
+        std::make_move_iterator(shard->buffer.end()));
+      shard->buffer.clear();
+      collected_bytes += shard->bytes;
+      shard->bytes = 0u;
+    }
+    secondary_cache_size_ = collected_bytes;
+    intake_bytes_.fetch_sub(collected_bytes);
+    for (auto & shard : intake_shards_) {
+      shard->drained_condition.notify_all();
+    }
+    if (max_cache_age_.count() > 0) {
+      // Re-arm the age trigger. Messages staged while the lanes were being
+      // collected get an approximate stamp of "now", which at worst flushes
+      // them slightly early - the conservative direction for durability.
+      oldest_staged_ns_.store(
+        intake_bytes_.load() > 0u ?
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count() : 0,
+        std::memory_order_relaxed);
+    }
+
+    if (secondary_cache_.empty()) {
+      if (stop_cache_writer_) {
+        break;
+      }
+      continue;
+    }
+
+    {
+      // Per-batch bookkeeping, moved off the producer hot path: message
+      // counts, the bag's time range and the active file's time range.
+      std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+      for (const auto & message : secondary_cache_) {
+        auto & info = topic_info_for(*message);
+        ++info.message_count;
+        record_message_size(info, *message);
+
+        const auto message_timestamp = std::chrono::time_point<std::chrono::high_resolution_clock>(
+          std::chrono::nanoseconds(message->time_stamp));
+        metadata_.starting_time = std::min(metadata_.starting_time, message_timestamp);
+
+        const auto duration = message_timestamp - metadata_.starting_time;
+        metadata_.duration = std::max(metadata_.duration, duration);
+
+        file_start_time_ns_ = std::min(file_start_time_ns_, message->time_stamp);
+        file_end_time_ns_ = std::max(file_end_time_ns_, message->time_stamp);
+      }
+      file_message_count_ += secondary_cache_.size();
+    }
+
+    {
+      // The flat view hands the batch to the storage without per-message
+      // ownership transfer; the shared_ptrs in secondary_cache_ keep the
+      // messages alive across the call.
+      secondary_cache_view_.clear();
+      secondary_cache_view_.reserve(secondary_cache_.size());
+      for (const auto & message : secondary_cache_) {
+        secondary_cache_view_.push_back(message.get());
+      }
+      std::lock_guard<std::mutex> storage_lock(storage_mutex_);
+      ROSBAG2_TRACEPOINT2(
+        writer_cache_flush_begin, secondary_cache_.size(), collected_bytes);
+      storage_->write(
+        rosbag2_storage::SerializedBagMessageSpan{
+          secondary_cache_view_.data(), secondary_cache_view_.size()});
+      ROSBAG2_TRACEPOINT(writer_cache_flush_end);
+    }
+    secondary_cache_.clear();
+    secondary_cache_size_ = 0u;
+
+    // Split decisions ride on the flush: in cached mode the file only grows
+    // when a batch was written, and a single thread deciding splits keeps
+    // them serialized with the writes.
+    if (should_split_bagfile()) {
+      split_bagfile();
+
+      // Update bagfile starting time
+      std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+      metadata_.starting_time = std::chrono::high_resolution_clock::now();
+    } else if (should_prepare_next_storage()) {
+      prepare_next_storage();
+    }
+  }
+}
+
+uint64_t SequentialWriter::get_cache_size()
+{
+  if (snapshot_mode_) {
+    std::lock_guard<std::mutex> cache_lock(cache_mutex_);
+    return current_cache_size_;
+  }
+  return intake_bytes_;
+}
+
+rosbag2_storage::IOStatistics SequentialWriter::get_io_statistics()
+{
+  std::lock_guard<std::mutex> storage_lock(storage_mutex_);
+  if (!storage_) {
+    return rosbag2_storage::IOStatistics{};
+  }
+  return storage_->get_io_statistics();
+}
+
+bool SequentialWriter::take_snapshot()
+{
+  if (!snapshot_mode_) {
+    ROSBAG2_CPP_LOG_WARN("take_snapshot called when snapshot mode is not enabled");
+    return false;
+  }
+
+  std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> snapshot;
+  {
+    std::lock_guard<std::mutex> cache_lock(cache_mutex_);
+    snapshot.assign(snapshot_buffer_.begin(), snapshot_buffer_.end());
+    snapshot_buffer_.clear();
+    current_cache_size_ = 0u;
+  }
+
+  if (snapshot.empty()) {
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+    for (const auto & message : snapshot) {
+      auto & info = topic_info_for(*message);
+      ++info.message_count;
+      record_message_size(info, *message);
+    }
+  }
+
+  std::lock_guard<std::mutex> storage_lock(storage_mutex_);
+  storage_->write(snapshot);
+  return true;
+}
+
+void SequentialWriter::record_message_size(
+  rosbag2_storage::TopicInformation & info,
+  const rosbag2_storage::SerializedBagMessage & message)
+{
+  if (!message.serialized_data) {
+    return;
+  }
+  const uint64_t size = message.serialized_data->buffer_length;
+  size_t bucket = 0;
+  while ((size >> (bucket + 1)) != 0u && bucket + 1 < info.message_size_histogram.size()) {
+    ++bucket;
+  }
+  ++info.message_size_histogram[bucket];
+  info.message_size_max = std::max<size_t>(info.message_size_max, static_cast<size_t>(size));
+}
+
+void SequentialWriter::summarize_message_sizes(rosbag2_storage::TopicInformation & info)
+{
+  uint64_t total = 0;
+  for (const auto count : info.message_size_histogram) {
+    total += count;
+  }
+  if (total == 0u) {
+    return;
+  }
+
+  auto percentile = [&info, total](double fraction) -> size_t {
+      const auto rank = std::max<uint64_t>(
+        1u, static_cast<uint64_t>(fraction * static_cast<double>(total)));
+      uint64_t cumulative = 0;
+      for (size_t bucket = 0; bucket < info.message_size_histogram.size(); ++bucket) {
+        cumulative += info.message_size_histogram[bucket];
+        if (cumulative >= rank) {
+          const auto upper_bound = (size_t{1} << (bucket + 1)) - 1u;
+          return std::min(info.message_size_max, upper_bound);
+        }
+      }
+      return info.message_size_max;
+    };
+
+  info.message_size_p50 = percentile(0.50);
+  info.message_size_p90 = percentile(0.90);
+  info.message_size_p99 = percentile(0.99);
+}
+
+rosbag2_storage::TopicInformation & SequentialWriter::topic_info_for(
+  const rosbag2_storage::SerializedBagMessage & message)
+{
+  const auto topic_id = message.topic_id;
+  if (topic_id != 0u && topic_id < topics_by_id_.size() && topics_by_id_[topic_id] != nullptr) {
+    return *topics_by_id_[topic_id];
+  }
+
+  auto topic_entry = topics_names_to_info_.find(message.topic_name);
+  if (topic_entry == topics_names_to_info_.end()) {
+    std::stringstream errmsg;
+    errmsg << "Failed to write on topic '" << message.topic_name <<
+      "'. Call create_topic() before first write.";
+    throw std::runtime_error(errmsg.str());
+  }
+  return topic_entry->second;
+}
+
+uint32_t SequentialWriter::get_topic_id(const std::string & topic_name) const
+{
+  std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+  const auto topic_entry = topics_names_to_info_.find(topic_name);
+  return topic_entry != topics_names_to_info_.end() ?
+         topic_entry->second.topic_metadata.topic_id : 0u;
+}
+
 std::shared_ptr<rosbag2_storage::SerializedBagMessage>
 SequentialWriter::get_writeable_message(
   std::shared_ptr<rosbag2_storage::SerializedBagMessage> message)
@@ -267,6 +1251,18 @@ SequentialWriter::get_writeable_message(
   return converter_ ? converter_->convert(message) : message;
 }
 
+bool SequentialWriter::should_prepare_next_storage() const
+{
+  if (max_bagfile_size_ == rosbag2_storage::storage_interfaces::MAX_BAGFILE_SIZE_NO_SPLIT) {
+    return false;
+  }
+  if (next_storage_future_.valid()) {
+    return false;
+  }
+  // Start pre-opening once the active file passed 90% of its size limit.
+  return storage_->get_bagfile_size() > max_bagfile_size_ / 10 * 9;
+}
+
 bool SequentialWriter::should_split_bagfile() const
 {
   // Assume we aren't splitting
@@ -277,6 +1273,12 @@ bool SequentialWriter::should_split_bagfile() const
     should_split = should_split || (storage_->get_bagfile_size() > max_bagfile_size_);
   }
 
+  // Splitting by message count: a plain counter compare, with no file size
+  // query against the storage.
+  if (max_bagfile_messages_ != 0u) {
+    should_split = should_split || (file_message_count_ >= max_bagfile_messages_);
+  }
+
   // Splitting by time
   if (max_bagfile_duration != std::chrono::seconds(
       rosbag2_storage::storage_interfaces::MAX_BAGFILE_DURATION_NO_SPLIT))
@@ -302,15 +1304,103 @@ void SequentialWriter::finalize_metadata()
     }
   }
 
+  aggregate_topic_counts();
+  record_active_file_range();
+}
+
+void SequentialWriter::record_active_file_range()
+{
+  if (metadata_.files.empty()) {
+    return;
+  }
+  if (file_start_time_ns_ <= file_end_time_ns_) {
+    metadata_.files.back().starting_time =
+      std::chrono::time_point<std::chrono::high_resolution_clock>(
+      std::chrono::nanoseconds(file_start_time_ns_));
+    metadata_.files.back().duration =
+      std::chrono::nanoseconds(file_end_time_ns_ - file_start_time_ns_);
+  }
+}
+
+void SequentialWriter::aggregate_topic_counts()
+{
   metadata_.topics_with_message_count.clear();
   metadata_.topics_with_message_count.reserve(topics_names_to_info_.size());
   metadata_.message_count = 0;
 
   for (const auto & topic : topics_names_to_info_) {
     metadata_.topics_with_message_count.push_back(topic.second);
+    // The percentile summary is derived on the aggregated copy, so the
+    // histogram in the per-topic bookkeeping keeps accumulating.
+    summarize_message_sizes(metadata_.topics_with_message_count.back());
     metadata_.message_count += topic.second.message_count;
   }
 }
 
+void SequentialWriter::checkpoint_metadata()
+{
+  std::lock_guard<std::mutex> checkpoint_lock(metadata_checkpoint_write_mutex_);
+  rosbag2_storage::BagMetadata snapshot;
+  {
+    // The metadata lock also covers the drop counters; bag_size is not
+    // serialized, so no file sizes are needed.
+    std::lock_guard<std::mutex> metadata_lock(metadata_mutex_);
+    aggregate_topic_counts();
+    record_active_file_range();
+    snapshot = metadata_;
+  }
+
+  // Write into a scratch directory and rename the files over the bag's
+  // metadata, so a crash mid-checkpoint never leaves a half-written
+  // metadata.yaml behind. The sidecar moves first: should the process die
+  // between the renames, the stale sidecar fails its size check against the
+  // old YAML and is ignored.
+  const auto bag_path = rcpputils::fs::path(base_folder_);
+  const auto scratch_dir = bag_path / ".metadata_checkpoint";
+  rcpputils::fs::create_directories(scratch_dir);
+  metadata_io_->write_metadata(scratch_dir.string(), snapshot);
+  rename_over(
+    (scratch_dir / rosbag2_storage::MetadataIo::metadata_sidecar_filename).string(),
+    (bag_path / rosbag2_storage::MetadataIo::metadata_sidecar_filename).string());
+  rename_over(
+    (scratch_dir / rosbag2_storage::MetadataIo::metadata_filename).string(),
+    (bag_path / rosbag2_storage::MetadataIo::metadata_filename).string());
+  rcpputils::fs::remove(scratch_dir);
+}
+
+void SequentialWriter::start_metadata_checkpointing()
+{
+  stop_metadata_checkpointing_ = false;
+  metadata_checkpoint_thread_ = std::thread(&SequentialWriter::metadata_checkpoint_loop, this);
+}
+
+void SequentialWriter::stop_metadata_checkpointing()
+{
+  if (metadata_checkpoint_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(metadata_checkpoint_control_mutex_);
+      stop_metadata_checkpointing_ = true;
+    }
+    metadata_checkpoint_condition_.notify_one();
+    metadata_checkpoint_thread_.join();
+  }
+}
+
+void SequentialWriter::metadata_checkpoint_loop()
+{
+  std::unique_lock<std::mutex> lock(metadata_checkpoint_control_mutex_);
+  while (!stop_metadata_checkpointing_) {
+    metadata_checkpoint_condition_.wait_for(
+      lock, metadata_checkpoint_period_,
+      [this] {return stop_metadata_checkpointing_;});
+    if (stop_metadata_checkpointing_) {
+      break;
+    }
+    lock.unlock();
+    checkpoint_metadata();
+    lock.lock();
+  }
+}
+
 }  // namespace writers
 }  // namespace rosbag2_cpp
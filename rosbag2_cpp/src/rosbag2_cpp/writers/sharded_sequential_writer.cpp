@@ -0,0 +1,462 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_cpp/writers/sharded_sequential_writer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "rcpputils/filesystem_helper.hpp"
+
+#include "rosbag2_cpp/storage_options.hpp"
+
+namespace rosbag2_cpp
+{
+namespace writers
+{
+
+namespace
+{
+// Transaction size of a shard when no cache size was configured.
+constexpr const uint64_t DEFAULT_SHARD_TRANSACTION_SIZE = 1024 * 1024;
+
+// A shard flushes a partially filled buffer after this long, so low-rate
+// topics do not linger in memory indefinitely.
+constexpr const std::chrono::milliseconds SHARD_FLUSH_INTERVAL{100};
+
+std::string format_storage_uri(const std::string & base_folder, uint64_t storage_count)
+{
+  // Same naming scheme as the SequentialWriter: the shard files simply
+  // continue the per-folder file counter.
+  std::stringstream storage_file_name;
+  storage_file_name << rcpputils::fs::path(base_folder).filename().string() << "_" << storage_count;
+
+  return (rcpputils::fs::path(base_folder) / storage_file_name.str()).string();
+}
+
+std::string strip_parent_path(const std::string & relative_path)
+{
+  return rcpputils::fs::path(relative_path).filename().string();
+}
+
+}  // namespace
+
+ShardedSequentialWriter::ShardedSequentialWriter(
+  std::unique_ptr<rosbag2_storage::StorageFactoryInterface> storage_factory,
+  std::shared_ptr<SerializationFormatConverterFactoryInterface> converter_factory,
+  std::unique_ptr<rosbag2_storage::MetadataIo> metadata_io)
+: SequentialWriter(std::move(storage_factory), std::move(converter_factory), std::move(metadata_io))
+{}
+
+ShardedSequentialWriter::~ShardedSequentialWriter()
+{
+  reset();
+}
+
+void ShardedSequentialWriter::init_metadata()
+{
+  metadata_ = rosbag2_storage::BagMetadata{};
+  metadata_.storage_identifier = shards_.front()->storage->get_storage_identifier();
+  metadata_.starting_time = std::chrono::time_point<std::chrono::high_resolution_clock>(
+    std::chrono::nanoseconds::max());
+  metadata_.storage_shard_count = shards_.size();
+  for (const auto & shard : shards_) {
+    metadata_.relative_file_paths.push_back(
+      strip_parent_path(shard->storage->get_relative_file_path()));
+  }
+}
+
+void ShardedSequentialWriter::open(
+  const StorageOptions & storage_options,
+  const ConverterOptions & converter_options)
+{
+  if (storage_options.storage_shard_count < 2) {
+    throw std::runtime_error(
+            "Sharded writing requires a storage_shard_count of at least 2.");
+  }
+  if (storage_options.snapshot_mode) {
+    throw std::runtime_error("Snapshot mode is not supported by the sharded writer.");
+  }
+
+  base_folder_ = storage_options.uri;
+  max_bagfile_size_ = storage_options.max_bagfile_size;
+  max_bagfile_duration = std::chrono::seconds(storage_options.max_bagfile_duration);
+  max_cache_size_ = storage_options.max_cache_size;
+  shard_transaction_size_ = max_cache_size_ / storage_options.storage_shard_count;
+  if (shard_transaction_size_ == 0u) {
+    shard_transaction_size_ = DEFAULT_SHARD_TRANSACTION_SIZE;
+  }
+
+  if (converter_options.output_serialization_format !=
+    converter_options.input_serialization_format)
+  {
+    converter_ = std::make_unique<Converter>(converter_options, converter_factory_);
+  }
+
+  rcpputils::fs::path db_path(base_folder_);
+  if (db_path.is_directory()) {
+    // Append mode is only implemented for the single-storage writer; the
+    // sharded layout would have to resume every shard's split sequence.
+    std::stringstream error;
+    error << "Database directory already exists (" << db_path.string() <<
+      "), can't overwrite existing database";
+    throw std::runtime_error{error.str()};
+  }
+
+  bool dir_created = rcpputils::fs::create_directories(db_path);
+  if (!dir_created) {
+    std::stringstream error;
+    error << "Failed to create database directory (" << db_path.string() << ").";
+    throw std::runtime_error{error.str()};
+  }
+
+  storage_config_uri_ = storage_options.storage_config_uri;
+
+  // Interned topic ids start at 1; slot 0 stays the "not assigned" marker.
+  topics_by_id_.assign(1, nullptr);
+  shards_by_topic_id_.assign(1, nullptr);
+
+  for (uint64_t i = 0; i < storage_options.storage_shard_count; ++i) {
+    const auto storage_uri = format_storage_uri(base_folder_, i);
+    auto storage = storage_factory_->open_read_write(
+      storage_uri, storage_options.storage_id, storage_config_uri_);
+    if (!storage) {
+      throw std::runtime_error("No storage could be initialized. Abort");
+    }
+    auto shard = std::make_unique<Shard>();
+    shard->storage = storage;
+    shards_.push_back(std::move(shard));
+  }
+
+  if (max_bagfile_size_ != 0 &&
+    max_bagfile_size_ < shards_.front()->storage->get_minimum_split_file_size())
+  {
+    std::stringstream error;
+    error << "Invalid bag splitting size given. Please provide a value greater than " <<
+      shards_.front()->storage->get_minimum_split_file_size() << ". Specified value of " <<
+      storage_options.max_bagfile_size;
+    throw std::runtime_error{error.str()};
+  }
+
+  if (max_bagfile_size_ != rosbag2_storage::storage_interfaces::MAX_BAGFILE_SIZE_NO_SPLIT) {
+    for (const auto & shard : shards_) {
+      shard->storage->preallocate(max_bagfile_size_ / shards_.size());
+    }
+  }
+
+  init_metadata();
+
+  for (auto & shard : shards_) {
+    shard->writer_thread = std::thread(
+      &ShardedSequentialWriter::shard_writer_loop, this, std::ref(*shard));
+  }
+}
+
+void ShardedSequentialWriter::reset()
+{
+  stop_shard_writers();
+
+  // Closing the bag seals the last file of every shard.
+  for (const auto & shard : shards_) {
+    notify_file_sealed(
+      shard->storage->get_relative_file_path(), shard->storage->get_bagfile_size(),
+      file_start_time_ns_, file_end_time_ns_);
+  }
+  restart_file_time_range();
+  shards_.clear();
+
+  // The base reset finalizes and writes the metadata; all shard specific
+  // fields were maintained along the way.
+  SequentialWriter::reset();
+}
+
+void ShardedSequentialWriter::create_topic(const rosbag2_storage::TopicMetadata & topic_with_type)
+{
+  if (shards_.empty()) {
+    throw std::runtime_error("Bag is not open. Call open() before writing.");
+  }
+
+  if (converter_) {
+    converter_->add_topic(topic_with_type.name, topic_with_type.type);
+  }
+
+  if (topics_names_to_info_.find(topic_with_type.name) ==
+    topics_names_to_info_.end())
+  {
+    rosbag2_storage::TopicInformation info{};
+    info.topic_metadata = topic_with_type;
+    // Intern a numeric id; messages carrying it resolve their shard and
+    // bookkeeping entry by index instead of hashing the topic name.
+    info.topic_metadata.topic_id = static_cast<uint32_t>(topics_by_id_.size());
+
+    const auto insert_res = topics_names_to_info_.insert(
+      std::make_pair(topic_with_type.name, info));
+
+    if (!insert_res.second) {
+      std::stringstream errmsg;
+      errmsg << "Failed to insert topic \"" << topic_with_type.name << "\"!";
+
+      throw std::runtime_error(errmsg.str());
+    }
+
+    const size_t shard_index = next_shard_++ % shards_.size();
+    topics_to_shards_[topic_with_type.name] = shard_index;
+
+    auto & shard = *shards_[shard_index];
+    topics_by_id_.push_back(&insert_res.first->second);
+    shards_by_topic_id_.push_back(&shard);
+
+    std::lock_guard<std::mutex> storage_lock(shard.storage_mutex);
+    shard.storage->create_topic(insert_res.first->second.topic_metadata);
+  }
+}
+
+void ShardedSequentialWriter::remove_topic(const rosbag2_storage::TopicMetadata & topic_with_type)
+{
+  if (shards_.empty()) {
+    throw std::runtime_error("Bag is not open. Call open() before removing.");
+  }
+
+  const auto topic_entry = topics_names_to_info_.find(topic_with_type.name);
+  if (topic_entry != topics_names_to_info_.end()) {
+    // Interned ids are never reused; the removed topic leaves null slots.
+    const auto topic_id = topic_entry->second.topic_metadata.topic_id;
+    topics_by_id_[topic_id] = nullptr;
+    shards_by_topic_id_[topic_id] = nullptr;
+    topics_names_to_info_.erase(topic_entry);
+
+    const size_t shard_index = topics_to_shards_.at(topic_with_type.name);
+    topics_to_shards_.erase(topic_with_type.name);
+
+    auto & shard = *shards_[shard_index];
+    std::lock_guard<std::mutex> storage_lock(shard.storage_mutex);
+    shard.storage->remove_topic(topic_with_type);
+  } else {
+    std::stringstream errmsg;
+    errmsg << "Failed to remove the non-existing topic \"" <<
+      topic_with_type.name << "\"!";
+
+    throw std::runtime_error(errmsg.str());
+  }
+}
+
+void ShardedSequentialWriter::rotate_bag(const std::string & new_base_folder)
+{
+  (void) new_base_folder;
+  throw std::runtime_error("Bag rotation is not supported for sharded recordings.");
+}
+
+void ShardedSequentialWriter::split_bagfile()
+{
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    auto & shard = *shards_[i];
+    const auto storage_uri = format_storage_uri(
+      base_folder_,
+      metadata_.relative_file_paths.size());
+
+    auto next_storage = storage_factory_->open_read_write(
+      storage_uri, metadata_.storage_identifier, storage_config_uri_);
+    if (!next_storage) {
+      std::stringstream errmsg;
+      errmsg << "Failed to rollover bagfile to new file: \"" << storage_uri << "\"!";
+
+      throw std::runtime_error(errmsg.str());
+    }
+
+    const auto sealed_file_path = shard.storage->get_relative_file_path();
+    const auto sealed_file_size = shard.storage->get_bagfile_size();
+
+    if (max_bagfile_size_ != rosbag2_storage::storage_interfaces::MAX_BAGFILE_SIZE_NO_SPLIT) {
+      next_storage->preallocate(max_bagfile_size_ / shards_.size());
+    }
+
+    // Re-register the topics owned by this shard on the new bagfile.
+    for (const auto & topic_to_shard : topics_to_shards_) {
+      if (topic_to_shard.second == i) {
+        next_storage->create_topic(
+          topics_names_to_info_.at(topic_to_shard.first).topic_metadata);
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> storage_lock(shard.storage_mutex);
+      shard.storage = next_storage;
+    }
+
+    metadata_.relative_file_paths.push_back(
+      strip_parent_path(next_storage->get_relative_file_path()));
+
+    notify_file_sealed(
+      sealed_file_path, sealed_file_size, file_start_time_ns_, file_end_time_ns_);
+  }
+  restart_file_time_range();
+}
+
+void ShardedSequentialWriter::write(std::shared_ptr<rosbag2_storage::SerializedBagMessage> message)
+{
+  if (shards_.empty()) {
+    throw std::runtime_error("Bag is not open. Call open() before writing.");
+  }
+
+  // Messages carrying an interned id (see get_topic_id) resolve their shard
+  // and bookkeeping entry with two array indexes; only producers without an
+  // id pay the by-name lookup, which also validates the topic and stamps
+  // the id for the storage.
+  Shard * shard = nullptr;
+  rosbag2_storage::TopicInformation * topic_info = nullptr;
+  const auto topic_id = message->topic_id;
+  if (topic_id != 0u && topic_id < shards_by_topic_id_.size() &&
+    shards_by_topic_id_[topic_id] != nullptr)
+  {
+    shard = shards_by_topic_id_[topic_id];
+    topic_info = topics_by_id_[topic_id];
+  } else {
+    const auto topic_entry = topics_names_to_info_.find(message->topic_name);
+    if (topic_entry == topics_names_to_info_.end()) {
+      std::stringstream errmsg;
+      errmsg << "Failed to write on topic '" << message->topic_name <<
+        "'. Call create_topic() before first write.";
+      throw std::runtime_error(errmsg.str());
+    }
+    topic_info = &topic_entry->second;
+    message->topic_id = topic_info->topic_metadata.topic_id;
+    shard = shards_[topics_to_shards_.at(message->topic_name)].get();
+  }
+
+  // Update the message count for the Topic.
+  ++topic_info->message_count;
+  record_message_size(*topic_info, *message);
+
+  if (should_split_shards()) {
+    split_bagfile();
+
+    // Update bagfile starting time
+    metadata_.starting_time = std::chrono::high_resolution_clock::now();
+  }
+
+  const auto message_timestamp = std::chrono::time_point<std::chrono::high_resolution_clock>(
+    std::chrono::nanoseconds(message->time_stamp));
+  metadata_.starting_time = std::min(metadata_.starting_time, message_timestamp);
+
+  const auto duration = message_timestamp - metadata_.starting_time;
+  metadata_.duration = std::max(metadata_.duration, duration);
+
+  file_start_time_ns_ = std::min(file_start_time_ns_, message->time_stamp);
+  file_end_time_ns_ = std::max(file_end_time_ns_, message->time_stamp);
+
+  auto converted_msg = get_writeable_message(message);
+
+  bool transaction_full = false;
+  {
+    std::lock_guard<std::mutex> buffer_lock(shard->buffer_mutex);
+    shard->buffer.push_back(converted_msg);
+    shard->buffered_bytes += converted_msg->serialized_data->buffer_length;
+    transaction_full = shard->buffered_bytes >= shard_transaction_size_;
+  }
+  if (transaction_full) {
+    shard->buffer_condition.notify_one();
+  }
+}
+
+bool ShardedSequentialWriter::is_write_concurrency_supported() const
+{
+  return false;
+}
+
+uint64_t ShardedSequentialWriter::get_cache_size()
+{
+  uint64_t buffered_bytes = 0u;
+  for (const auto & shard : shards_) {
+    std::lock_guard<std::mutex> buffer_lock(shard->buffer_mutex);
+    buffered_bytes += shard->buffered_bytes;
+  }
+  return buffered_bytes;
+}
+
+void ShardedSequentialWriter::shard_writer_loop(Shard & shard)
+{
+  while (true) {
+    {
+      std::unique_lock<std::mutex> buffer_lock(shard.buffer_mutex);
+      shard.buffer_condition.wait_for(
+        buffer_lock, SHARD_FLUSH_INTERVAL,
+        [&shard, this] {
+          return shard.stop || shard.buffered_bytes >= shard_transaction_size_;
+        });
+
+      if (shard.stop && shard.buffer.empty()) {
+        break;
+      }
+
+      // Swap the buffers so write() can keep appending while this thread
+      // drains the filled buffer into the storage.
+      std::swap(shard.buffer, shard.write_buffer);
+      shard.buffered_bytes = 0u;
+    }
+
+    if (!shard.write_buffer.empty()) {
+      std::lock_guard<std::mutex> storage_lock(shard.storage_mutex);
+      shard.storage->write(shard.write_buffer);
+      shard.write_buffer.clear();
+    }
+  }
+}
+
+void ShardedSequentialWriter::stop_shard_writers()
+{
+  for (auto & shard : shards_) {
+    if (shard->writer_thread.joinable()) {
+      {
+        std::lock_guard<std::mutex> buffer_lock(shard->buffer_mutex);
+        shard->stop = true;
+      }
+      shard->buffer_condition.notify_one();
+      shard->writer_thread.join();
+    }
+  }
+}
+
+bool ShardedSequentialWriter::should_split_shards() const
+{
+  // Assume we aren't splitting
+  bool should_split = false;
+
+  // Splitting by size; the limit applies to the files of one split combined.
+  if (max_bagfile_size_ != rosbag2_storage::storage_interfaces::MAX_BAGFILE_SIZE_NO_SPLIT) {
+    uint64_t split_size = 0u;
+    for (const auto & shard : shards_) {
+      split_size += shard->storage->get_bagfile_size();
+    }
+    should_split = should_split || (split_size > max_bagfile_size_);
+  }
+
+  // Splitting by time
+  if (max_bagfile_duration != std::chrono::seconds(
+      rosbag2_storage::storage_interfaces::MAX_BAGFILE_DURATION_NO_SPLIT))
+  {
+    auto max_duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      max_bagfile_duration);
+    should_split = should_split ||
+      ((std::chrono::high_resolution_clock::now() - metadata_.starting_time) > max_duration_ns);
+  }
+
+  return should_split;
+}
+
+}  // namespace writers
+}  // namespace rosbag2_cpp
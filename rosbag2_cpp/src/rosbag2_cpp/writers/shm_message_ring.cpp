@@ -0,0 +1,303 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_cpp/writers/shm_message_ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rosbag2_cpp
+{
+namespace writers
+{
+
+namespace
+{
+constexpr uint64_t SHM_RING_MAGIC = 0x32676162736f72ull;  // "rosbag2"
+
+// Backoff while the ring is full (producer) or empty (consumer).
+constexpr std::chrono::microseconds POLL_INTERVAL{100};
+
+struct RecordHeader
+{
+  uint32_t type;
+  uint32_t size;
+};
+}  // namespace
+
+void append_uint64(std::vector<uint8_t> & payload, uint64_t value)
+{
+  for (int shift = 0; shift < 64; shift += 8) {
+    payload.push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void append_string(std::vector<uint8_t> & payload, const std::string & value)
+{
+  append_uint64(payload, value.size());
+  payload.insert(payload.end(), value.begin(), value.end());
+}
+
+uint64_t read_uint64(const std::vector<uint8_t> & payload, size_t & offset)
+{
+  if (offset + sizeof(uint64_t) > payload.size()) {
+    throw std::runtime_error("Malformed shared-memory record: truncated integer.");
+  }
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 8) {
+    value |= static_cast<uint64_t>(payload[offset++]) << shift;
+  }
+  return value;
+}
+
+std::string read_string(const std::vector<uint8_t> & payload, size_t & offset)
+{
+  const auto size = read_uint64(payload, offset);
+  if (offset + size > payload.size()) {
+    throw std::runtime_error("Malformed shared-memory record: truncated string.");
+  }
+  std::string value(payload.begin() + offset, payload.begin() + offset + size);
+  offset += size;
+  return value;
+}
+
+struct ShmMessageRing::Control
+{
+  uint64_t magic;
+  uint64_t capacity;
+  // Monotonically increasing byte offsets; the buffer index is the offset
+  // modulo capacity. write_pos is only advanced by the producer (release),
+  // read_pos only by the consumer (release); each side reads the other's
+  // position with acquire ordering.
+  std::atomic<uint64_t> write_pos;
+  std::atomic<uint64_t> read_pos;
+};
+
+#ifdef _WIN32
+
+std::unique_ptr<ShmMessageRing> ShmMessageRing::create(const std::string &, size_t)
+{
+  throw std::runtime_error("The shared-memory message ring is not supported on Windows.");
+}
+
+std::unique_ptr<ShmMessageRing> ShmMessageRing::attach(const std::string &)
+{
+  throw std::runtime_error("The shared-memory message ring is not supported on Windows.");
+}
+
+ShmMessageRing::ShmMessageRing(const std::string &, void *, size_t, bool) {}
+ShmMessageRing::~ShmMessageRing() {}
+ShmMessageRing::Control * ShmMessageRing::control() const {return nullptr;}
+uint8_t * ShmMessageRing::data() const {return nullptr;}
+void ShmMessageRing::copy_in(uint64_t, const uint8_t *, size_t) {}
+void ShmMessageRing::copy_out(uint64_t, uint8_t *, size_t) const {}
+
+bool ShmMessageRing::push(ShmRecordType, const uint8_t *, size_t, std::chrono::milliseconds)
+{
+  return false;
+}
+
+bool ShmMessageRing::pop(ShmRecordType &, std::vector<uint8_t> &, std::chrono::milliseconds)
+{
+  return false;
+}
+
+#else
+
+std::unique_ptr<ShmMessageRing> ShmMessageRing::create(const std::string & name, size_t capacity)
+{
+  const auto mapping_size = sizeof(Control) + capacity;
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    throw std::runtime_error(
+            "Failed to create shared-memory ring '" + name + "': " + std::strerror(errno));
+  }
+  if (ftruncate(fd, static_cast<off_t>(mapping_size)) != 0) {
+    close(fd);
+    shm_unlink(name.c_str());
+    throw std::runtime_error(
+            "Failed to size shared-memory ring '" + name + "': " + std::strerror(errno));
+  }
+  void * mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw std::runtime_error(
+            "Failed to map shared-memory ring '" + name + "': " + std::strerror(errno));
+  }
+
+  auto ring = std::unique_ptr<ShmMessageRing>(
+    new ShmMessageRing(name, mapping, mapping_size, true));
+  auto * control = ring->control();
+  control->capacity = capacity;
+  new (&control->write_pos) std::atomic<uint64_t>(0);
+  new (&control->read_pos) std::atomic<uint64_t>(0);
+  // The magic is written last so an attaching consumer never sees a
+  // partially initialized control block.
+  std::atomic_thread_fence(std::memory_order_release);
+  control->magic = SHM_RING_MAGIC;
+  return ring;
+}
+
+std::unique_ptr<ShmMessageRing> ShmMessageRing::attach(const std::string & name)
+{
+  const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0) {
+    throw std::runtime_error(
+            "Failed to open shared-memory ring '" + name + "': " + std::strerror(errno));
+  }
+  struct stat ring_stat;
+  if (fstat(fd, &ring_stat) != 0 || static_cast<size_t>(ring_stat.st_size) < sizeof(Control)) {
+    close(fd);
+    throw std::runtime_error("Shared-memory ring '" + name + "' has an invalid size.");
+  }
+  const auto mapping_size = static_cast<size_t>(ring_stat.st_size);
+  void * mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error(
+            "Failed to map shared-memory ring '" + name + "': " + std::strerror(errno));
+  }
+
+  auto ring = std::unique_ptr<ShmMessageRing>(
+    new ShmMessageRing(name, mapping, mapping_size, false));
+  const auto * control = ring->control();
+  if (control->magic != SHM_RING_MAGIC ||
+    control->capacity != mapping_size - sizeof(Control))
+  {
+    throw std::runtime_error(
+            "Shared-memory ring '" + name + "' was not initialized by a rosbag2 producer.");
+  }
+  return ring;
+}
+
+ShmMessageRing::ShmMessageRing(
+  const std::string & name, void * mapping, size_t mapping_size, bool owner)
+: name_(name), mapping_(mapping), mapping_size_(mapping_size), owner_(owner)
+{}
+
+ShmMessageRing::~ShmMessageRing()
+{
+  if (mapping_) {
+    munmap(mapping_, mapping_size_);
+  }
+  if (owner_) {
+    shm_unlink(name_.c_str());
+  }
+}
+
+ShmMessageRing::Control * ShmMessageRing::control() const
+{
+  return static_cast<Control *>(mapping_);
+}
+
+uint8_t * ShmMessageRing::data() const
+{
+  return static_cast<uint8_t *>(mapping_) + sizeof(Control);
+}
+
+void ShmMessageRing::copy_in(uint64_t position, const uint8_t * source, size_t size)
+{
+  const auto capacity = control()->capacity;
+  const auto index = position % capacity;
+  const auto first_part = std::min<size_t>(size, capacity - index);
+  std::memcpy(data() + index, source, first_part);
+  std::memcpy(data(), source + first_part, size - first_part);
+}
+
+void ShmMessageRing::copy_out(uint64_t position, uint8_t * destination, size_t size) const
+{
+  const auto capacity = control()->capacity;
+  const auto index = position % capacity;
+  const auto first_part = std::min<size_t>(size, capacity - index);
+  std::memcpy(destination, data() + index, first_part);
+  std::memcpy(destination + first_part, data(), size - first_part);
+}
+
+bool ShmMessageRing::push(
+  ShmRecordType type, const uint8_t * payload, size_t size,
+  std::chrono::milliseconds timeout)
+{
+  auto * control = this->control();
+  const auto record_size = sizeof(RecordHeader) + size;
+  if (record_size > control->capacity) {
+    throw std::runtime_error(
+            "Message of " + std::to_string(size) +
+            " bytes does not fit into the shared-memory ring of " +
+            std::to_string(control->capacity) + " bytes.");
+  }
+
+  const auto write_pos = control->write_pos.load(std::memory_order_relaxed);
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (control->capacity -
+    (write_pos - control->read_pos.load(std::memory_order_acquire)) < record_size)
+  {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(POLL_INTERVAL);
+  }
+
+  RecordHeader header{static_cast<uint32_t>(type), static_cast<uint32_t>(size)};
+  copy_in(write_pos, reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+  if (size > 0) {
+    copy_in(write_pos + sizeof(header), payload, size);
+  }
+  control->write_pos.store(write_pos + record_size, std::memory_order_release);
+  return true;
+}
+
+bool ShmMessageRing::pop(
+  ShmRecordType & type, std::vector<uint8_t> & payload, std::chrono::milliseconds timeout)
+{
+  auto * control = this->control();
+  const auto read_pos = control->read_pos.load(std::memory_order_relaxed);
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (control->write_pos.load(std::memory_order_acquire) - read_pos < sizeof(RecordHeader)) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(POLL_INTERVAL);
+  }
+
+  RecordHeader header;
+  copy_out(read_pos, reinterpret_cast<uint8_t *>(&header), sizeof(header));
+  type = static_cast<ShmRecordType>(header.type);
+  payload.resize(header.size);
+  if (header.size > 0) {
+    copy_out(read_pos + sizeof(header), payload.data(), header.size);
+  }
+  control->read_pos.store(
+    read_pos + sizeof(header) + header.size, std::memory_order_release);
+  return true;
+}
+
+#endif  // _WIN32
+
+}  // namespace writers
+}  // namespace rosbag2_cpp
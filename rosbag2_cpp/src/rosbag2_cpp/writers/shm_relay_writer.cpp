@@ -0,0 +1,266 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_cpp/writers/shm_relay_writer.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "ament_index_cpp/get_package_prefix.hpp"
+
+#include "rosbag2_cpp/logging.hpp"
+
+namespace rosbag2_cpp
+{
+namespace writers
+{
+
+namespace
+{
+// How long a push may block on a full ring before we check whether the
+// writer process is still alive. A healthy writer drains the ring orders of
+// magnitude faster; hitting this timeout means the consumer stalled or died.
+constexpr std::chrono::milliseconds PUSH_TIMEOUT{5000};
+}  // namespace
+
+ShmRelayWriter::ShmRelayWriter(size_t ring_capacity)
+: ring_capacity_(ring_capacity)
+{}
+
+ShmRelayWriter::~ShmRelayWriter()
+{
+  try {
+    reset();
+  } catch (const std::exception & e) {
+    ROSBAG2_CPP_LOG_ERROR_STREAM("Failed to shut down the writer process: " << e.what());
+  }
+}
+
+#ifdef _WIN32
+
+void ShmRelayWriter::open(const StorageOptions &, const ConverterOptions &)
+{
+  throw std::runtime_error("The out-of-process writer is not supported on Windows.");
+}
+
+void ShmRelayWriter::reset() {}
+void ShmRelayWriter::create_topic(const rosbag2_storage::TopicMetadata &) {}
+void ShmRelayWriter::remove_topic(const rosbag2_storage::TopicMetadata &) {}
+void ShmRelayWriter::write(std::shared_ptr<rosbag2_storage::SerializedBagMessage>) {}
+void ShmRelayWriter::split_bagfile() {}
+void ShmRelayWriter::push_record(ShmRecordType, const std::vector<uint8_t> &) {}
+void ShmRelayWriter::spawn_writer_process() {}
+void ShmRelayWriter::reopen_after_respawn() {}
+
+std::vector<uint8_t> ShmRelayWriter::serialize_open_record(
+  const StorageOptions &, const ConverterOptions &)
+{
+  return {};
+}
+
+std::vector<uint8_t> ShmRelayWriter::serialize_topic(const rosbag2_storage::TopicMetadata &)
+{
+  return {};
+}
+
+#else
+
+void ShmRelayWriter::open(
+  const StorageOptions & storage_options, const ConverterOptions & converter_options)
+{
+  std::lock_guard<std::mutex> lock(producer_mutex_);
+  storage_options_ = storage_options;
+  converter_options_ = converter_options;
+
+  const auto ring_name =
+    "/rosbag2_" + std::to_string(getpid()) + "_" +
+    std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+  ring_ = ShmMessageRing::create(ring_name, ring_capacity_);
+
+  spawn_writer_process();
+
+  const auto open_record = serialize_open_record(storage_options_, converter_options_);
+  if (!ring_->push(
+      ShmRecordType::OPEN, open_record.data(), open_record.size(), PUSH_TIMEOUT))
+  {
+    throw std::runtime_error("The writer process did not start draining the ring.");
+  }
+}
+
+void ShmRelayWriter::reset()
+{
+  std::lock_guard<std::mutex> lock(producer_mutex_);
+  if (!ring_) {
+    return;
+  }
+  ring_->push(ShmRecordType::SHUTDOWN, nullptr, 0, PUSH_TIMEOUT);
+  if (writer_pid_ > 0) {
+    int status = 0;
+    waitpid(static_cast<pid_t>(writer_pid_), &status, 0);
+    writer_pid_ = -1;
+  }
+  ring_.reset();
+  known_topics_.clear();
+}
+
+void ShmRelayWriter::create_topic(const rosbag2_storage::TopicMetadata & topic_with_type)
+{
+  std::lock_guard<std::mutex> lock(producer_mutex_);
+  known_topics_[topic_with_type.name] = topic_with_type;
+  push_record(ShmRecordType::CREATE_TOPIC, serialize_topic(topic_with_type));
+}
+
+void ShmRelayWriter::remove_topic(const rosbag2_storage::TopicMetadata & topic_with_type)
+{
+  std::lock_guard<std::mutex> lock(producer_mutex_);
+  known_topics_.erase(topic_with_type.name);
+  push_record(ShmRecordType::REMOVE_TOPIC, serialize_topic(topic_with_type));
+}
+
+void ShmRelayWriter::write(std::shared_ptr<rosbag2_storage::SerializedBagMessage> message)
+{
+  std::vector<uint8_t> payload;
+  payload.reserve(
+    2 * sizeof(uint64_t) + message->topic_name.size() + sizeof(uint64_t) +
+    message->serialized_data->buffer_length);
+  append_uint64(payload, static_cast<uint64_t>(message->time_stamp));
+  append_string(payload, message->topic_name);
+  append_uint64(payload, message->serialized_data->buffer_length);
+  payload.insert(
+    payload.end(),
+    message->serialized_data->buffer,
+    message->serialized_data->buffer + message->serialized_data->buffer_length);
+
+  std::lock_guard<std::mutex> lock(producer_mutex_);
+  push_record(ShmRecordType::MESSAGE, payload);
+}
+
+void ShmRelayWriter::split_bagfile()
+{
+  std::lock_guard<std::mutex> lock(producer_mutex_);
+  push_record(ShmRecordType::SPLIT_BAGFILE, {});
+}
+
+void ShmRelayWriter::push_record(ShmRecordType type, const std::vector<uint8_t> & payload)
+{
+  if (!ring_) {
+    throw std::runtime_error("Bag has not been opened, call open() before writing.");
+  }
+  while (!ring_->push(type, payload.data(), payload.size(), PUSH_TIMEOUT)) {
+    // The ring stayed full for the whole timeout, so the consumer stalled.
+    // If the writer process died, respawn it and replay the session context;
+    // if it is merely stuck on a storage stall, keep waiting.
+    int status = 0;
+    const auto waited = waitpid(static_cast<pid_t>(writer_pid_), &status, WNOHANG);
+    if (waited != static_cast<pid_t>(writer_pid_)) {
+      ROSBAG2_CPP_LOG_WARN(
+        "The writer process is not draining the shared-memory ring, waiting.");
+      continue;
+    }
+    ROSBAG2_CPP_LOG_ERROR_STREAM(
+      "The writer process died (status " << status << "), respawning it. "
+        "The recording continues in a new bag directory.");
+    ++respawn_count_;
+    // Start over with an empty ring: the records the dead writer had not
+    // consumed belong to the abandoned bag.
+    const auto ring_name = ring_->name();
+    ring_.reset();
+    ring_ = ShmMessageRing::create(ring_name + "r", ring_capacity_);
+    spawn_writer_process();
+    reopen_after_respawn();
+  }
+}
+
+void ShmRelayWriter::spawn_writer_process()
+{
+  const auto executable =
+    ament_index_cpp::get_package_prefix("rosbag2_cpp") + "/lib/rosbag2_cpp/rosbag2_writer_process";
+  const auto pid = fork();
+  if (pid < 0) {
+    throw std::runtime_error(
+            std::string("Failed to fork the writer process: ") + std::strerror(errno));
+  }
+  if (pid == 0) {
+    execl(executable.c_str(), executable.c_str(), ring_->name().c_str(), nullptr);
+    // Only reached when exec failed; _exit avoids running the parent's
+    // atexit handlers in the child.
+    _exit(127);
+  }
+  writer_pid_ = pid;
+}
+
+void ShmRelayWriter::reopen_after_respawn()
+{
+  auto restarted_options = storage_options_;
+  restarted_options.uri += "_restart" + std::to_string(respawn_count_);
+  const auto open_record = serialize_open_record(restarted_options, converter_options_);
+  if (!ring_->push(
+      ShmRecordType::OPEN, open_record.data(), open_record.size(), PUSH_TIMEOUT))
+  {
+    throw std::runtime_error("The respawned writer process did not start draining the ring.");
+  }
+  for (const auto & topic : known_topics_) {
+    const auto record = serialize_topic(topic.second);
+    if (!ring_->push(ShmRecordType::CREATE_TOPIC, record.data(), record.size(), PUSH_TIMEOUT)) {
+      throw std::runtime_error("The respawned writer process stopped draining the ring.");
+    }
+  }
+}
+
+std::vector<uint8_t> ShmRelayWriter::serialize_open_record(
+  const StorageOptions & storage_options, const ConverterOptions & converter_options)
+{
+  std::vector<uint8_t> payload;
+  append_string(payload, storage_options.uri);
+  append_string(payload, storage_options.storage_id);
+  append_string(payload, storage_options.storage_config_uri);
+  append_uint64(payload, storage_options.max_bagfile_size);
+  append_uint64(payload, storage_options.max_bagfile_duration);
+  append_uint64(payload, storage_options.max_bagfile_messages);
+  append_uint64(payload, storage_options.max_cache_size);
+  append_uint64(payload, static_cast<uint64_t>(storage_options.cache_overflow_policy));
+  append_uint64(payload, storage_options.cache_memory_budget);
+  append_uint64(payload, storage_options.metadata_checkpoint_period);
+  append_string(payload, converter_options.input_serialization_format);
+  append_string(payload, converter_options.output_serialization_format);
+  return payload;
+}
+
+std::vector<uint8_t> ShmRelayWriter::serialize_topic(const rosbag2_storage::TopicMetadata & topic)
+{
+  std::vector<uint8_t> payload;
+  append_string(payload, topic.name);
+  append_string(payload, topic.type);
+  append_string(payload, topic.serialization_format);
+  append_string(payload, topic.offered_qos_profiles);
+  return payload;
+}
+
+#endif  // _WIN32
+
+}  // namespace writers
+}  // namespace rosbag2_cpp
@@ -0,0 +1,297 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rosbag2_cpp/bag_converter.hpp"
+#include "rosbag2_cpp/converter_interfaces/serialization_format_converter.hpp"
+#include "rosbag2_cpp/reader.hpp"
+#include "rosbag2_cpp/types/introspection_message.hpp"
+#include "rosbag2_cpp/writer.hpp"
+
+#include "rosbag2_storage/ros_helper.hpp"
+#include "rosbag2_storage/serialized_bag_message.hpp"
+#include "rosbag2_storage/topic_metadata.hpp"
+
+using namespace testing;  // NOLINT
+
+namespace
+{
+
+// Payloads at or above this size are treated as "large" by the fake
+// converter below and pay a long conversion delay.
+constexpr const size_t kLargePayloadSize = 256 * 1024;
+
+// Conversion delay of a large payload. Long enough for the fast workers to
+// convert far more than the reorder window's worth of later messages in the
+// meantime, which is the situation that used to wedge the pipeline.
+constexpr const std::chrono::milliseconds kLargeMessageDelay{200};
+
+// A reader serving a scripted message sequence, standing in for a
+// SequentialReader over the input bag.
+class FakeReader : public rosbag2_cpp::reader_interfaces::BaseReaderInterface
+{
+public:
+  FakeReader(
+    std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages,
+    std::vector<rosbag2_storage::TopicMetadata> topics)
+  : messages_(std::move(messages)), topics_(std::move(topics))
+  {}
+
+  void open(
+    const rosbag2_cpp::StorageOptions &, const rosbag2_cpp::ConverterOptions &) override {}
+
+  void reset() override {}
+
+  bool has_next() override
+  {
+    return next_index_ < messages_.size();
+  }
+
+  std::shared_ptr<rosbag2_storage::SerializedBagMessage> read_next() override
+  {
+    return messages_.at(next_index_++);
+  }
+
+  const rosbag2_storage::BagMetadata & get_metadata() const override
+  {
+    return metadata_;
+  }
+
+  std::vector<rosbag2_storage::TopicMetadata> get_all_topics_and_types() const override
+  {
+    return topics_;
+  }
+
+  void set_filter(const rosbag2_storage::StorageFilter &) override {}
+
+  void reset_filter() override {}
+
+  void seek(rcutils_time_point_value_t) override {}
+
+private:
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages_;
+  std::vector<rosbag2_storage::TopicMetadata> topics_;
+  rosbag2_storage::BagMetadata metadata_;
+  size_t next_index_ = 0;
+};
+
+// A writer recording the order in which the pipeline hands it messages.
+class FakeWriter : public rosbag2_cpp::writer_interfaces::BaseWriterInterface
+{
+public:
+  void open(
+    const rosbag2_cpp::StorageOptions &, const rosbag2_cpp::ConverterOptions &) override {}
+
+  void reset() override {}
+
+  void create_topic(const rosbag2_storage::TopicMetadata & topic_with_type) override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    created_topics_.push_back(topic_with_type.name);
+  }
+
+  void remove_topic(const rosbag2_storage::TopicMetadata &) override {}
+
+  void write(std::shared_ptr<rosbag2_storage::SerializedBagMessage> message) override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    written_timestamps_.push_back(message->time_stamp);
+  }
+
+  std::vector<int64_t> written_timestamps()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_timestamps_;
+  }
+
+  std::vector<std::string> created_topics()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return created_topics_;
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<int64_t> written_timestamps_;
+  std::vector<std::string> created_topics_;
+};
+
+// A converter with a heavily skewed per-message cost: large payloads take
+// kLargeMessageDelay to "convert", small ones are immediate. Topic name and
+// timestamp travel through the introspection message as in a real plugin so
+// the test can check the restored write order.
+class SkewedLatencyConverter
+  : public rosbag2_cpp::converter_interfaces::SerializationFormatConverter
+{
+public:
+  explicit SkewedLatencyConverter(bool fail_on_large_payloads)
+  : fail_on_large_payloads_(fail_on_large_payloads)
+  {}
+
+  void deserialize(
+    std::shared_ptr<const rosbag2_storage::SerializedBagMessage> serialized_message,
+    const rosidl_message_type_support_t *,
+    std::shared_ptr<rosbag2_cpp::rosbag2_introspection_message_t> ros_message) override
+  {
+    if (serialized_message->serialized_data->buffer_length >= kLargePayloadSize) {
+      if (fail_on_large_payloads_) {
+        throw std::runtime_error("conversion failed");
+      }
+      std::this_thread::sleep_for(kLargeMessageDelay);
+    }
+    rosbag2_cpp::introspection_message_set_topic_name(
+      ros_message.get(), serialized_message->topic_name.c_str());
+    ros_message->time_stamp = serialized_message->time_stamp;
+  }
+
+  void serialize(
+    std::shared_ptr<const rosbag2_cpp::rosbag2_introspection_message_t> ros_message,
+    const rosidl_message_type_support_t *,
+    std::shared_ptr<rosbag2_storage::SerializedBagMessage> serialized_message) override
+  {
+    serialized_message->topic_name = ros_message->topic_name;
+    serialized_message->time_stamp = ros_message->time_stamp;
+  }
+
+private:
+  bool fail_on_large_payloads_;
+};
+
+class FakeConverterFactory : public rosbag2_cpp::SerializationFormatConverterFactoryInterface
+{
+public:
+  explicit FakeConverterFactory(bool fail_on_large_payloads = false)
+  : fail_on_large_payloads_(fail_on_large_payloads)
+  {}
+
+  std::unique_ptr<rosbag2_cpp::converter_interfaces::SerializationFormatSerializer>
+  load_serializer(const std::string &) override
+  {
+    return std::make_unique<SkewedLatencyConverter>(fail_on_large_payloads_);
+  }
+
+  std::unique_ptr<rosbag2_cpp::converter_interfaces::SerializationFormatDeserializer>
+  load_deserializer(const std::string &) override
+  {
+    return std::make_unique<SkewedLatencyConverter>(fail_on_large_payloads_);
+  }
+
+private:
+  bool fail_on_large_payloads_;
+};
+
+std::shared_ptr<rosbag2_storage::SerializedBagMessage> make_message(
+  const std::string & topic_name, int64_t time_stamp,
+  std::shared_ptr<rcutils_uint8_array_t> payload)
+{
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = topic_name;
+  message->time_stamp = time_stamp;
+  message->serialized_data = std::move(payload);
+  return message;
+}
+
+// A bag with one low-rate large-payload topic interleaved into high-rate
+// small ones: the large messages convert slowly on their topic's worker
+// while the other workers race far ahead of the write sequence. Every topic
+// is a real introspectable type so the workers can build conversion state.
+std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> make_skewed_messages()
+{
+  const std::vector<std::string> small_topics = {"/tick_a", "/tick_b", "/tick_c"};
+  const std::vector<uint8_t> large_buffer(kLargePayloadSize, 0);
+  const std::vector<uint8_t> small_buffer(16, 0);
+  // The pipeline never mutates payloads, so all messages of a size class
+  // can share one buffer.
+  auto large_payload =
+    rosbag2_storage::make_serialized_message(large_buffer.data(), large_buffer.size());
+  auto small_payload =
+    rosbag2_storage::make_serialized_message(small_buffer.data(), small_buffer.size());
+
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages;
+  for (int64_t i = 0; i < 3000; ++i) {
+    if (i % 1500 == 0) {
+      messages.push_back(make_message("/bulk", i, large_payload));
+    } else {
+      messages.push_back(make_message(small_topics[i % small_topics.size()], i, small_payload));
+    }
+  }
+  return messages;
+}
+
+std::vector<rosbag2_storage::TopicMetadata> make_skewed_topics()
+{
+  std::vector<rosbag2_storage::TopicMetadata> topics;
+  for (const auto & name : {"/bulk", "/tick_a", "/tick_b", "/tick_c"}) {
+    topics.push_back({name, "test_msgs/BasicTypes", "skewed_in", ""});
+  }
+  return topics;
+}
+
+rosbag2_cpp::BagConverter make_converter(
+  FakeWriter ** fake_writer_out, bool fail_on_large_payloads = false)
+{
+  auto fake_writer = std::make_unique<FakeWriter>();
+  *fake_writer_out = fake_writer.get();
+
+  rosbag2_cpp::BagConverter::Options options;
+  // Distinct input and output formats keep the conversion off the
+  // passthrough fast path, so every message runs through the fake converter.
+  options.output_serialization_format = "skewed_out";
+  options.worker_count = 4;
+  return rosbag2_cpp::BagConverter(
+    options,
+    std::make_unique<rosbag2_cpp::Reader>(
+      std::make_unique<FakeReader>(make_skewed_messages(), make_skewed_topics())),
+    std::make_unique<rosbag2_cpp::Writer>(std::move(fake_writer)),
+    std::make_shared<FakeConverterFactory>(fail_on_large_payloads));
+}
+
+}  // namespace
+
+TEST(BagConverter, skewed_message_sizes_do_not_stall_the_pipeline) {
+  // While a large message sits in conversion, the fast workers produce far
+  // more than kMaxPendingWrites later messages. Admission into the reorder
+  // buffer must stay possible for the message the writer needs next, or the
+  // whole pipeline deadlocks right here.
+  FakeWriter * fake_writer = nullptr;
+  auto converter = make_converter(&fake_writer);
+
+  converter.run();
+
+  EXPECT_THAT(
+    fake_writer->created_topics(),
+    UnorderedElementsAre("/bulk", "/tick_a", "/tick_b", "/tick_c"));
+  const auto timestamps = fake_writer->written_timestamps();
+  ASSERT_THAT(timestamps, SizeIs(3000u));
+  for (int64_t i = 0; i < 3000; ++i) {
+    ASSERT_THAT(timestamps[i], Eq(i)) << "write order broken at message " << i;
+  }
+}
+
+TEST(BagConverter, conversion_failure_propagates_without_hanging) {
+  FakeWriter * fake_writer = nullptr;
+  auto converter = make_converter(&fake_writer, true);
+
+  EXPECT_THROW(converter.run(), std::runtime_error);
+}
@@ -0,0 +1,209 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rosbag2_cpp/reader.hpp"
+#include "rosbag2_cpp/readers/merged_reader.hpp"
+
+#include "rosbag2_storage/bag_metadata.hpp"
+#include "rosbag2_storage/serialized_bag_message.hpp"
+
+using namespace testing;  // NOLINT
+
+namespace
+{
+
+// A reader serving a scripted message sequence, standing in for a
+// SequentialReader over one bag.
+class FakeReader : public rosbag2_cpp::reader_interfaces::BaseReaderInterface
+{
+public:
+  FakeReader(
+    std::vector<std::pair<std::string, int64_t>> messages,
+    rosbag2_storage::BagMetadata metadata)
+  : metadata_(std::move(metadata))
+  {
+    for (const auto & entry : messages) {
+      auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+      message->topic_name = entry.first;
+      message->time_stamp = entry.second;
+      messages_.push_back(message);
+    }
+  }
+
+  void open(
+    const rosbag2_cpp::StorageOptions &, const rosbag2_cpp::ConverterOptions &) override {}
+
+  void reset() override {}
+
+  bool has_next() override
+  {
+    return next_index_ < messages_.size();
+  }
+
+  std::shared_ptr<rosbag2_storage::SerializedBagMessage> read_next() override
+  {
+    return messages_.at(next_index_++);
+  }
+
+  const rosbag2_storage::BagMetadata & get_metadata() const override
+  {
+    return metadata_;
+  }
+
+  std::vector<rosbag2_storage::TopicMetadata> get_all_topics_and_types() const override
+  {
+    return {};
+  }
+
+  void set_filter(const rosbag2_storage::StorageFilter &) override {}
+
+  void reset_filter() override {}
+
+  void seek(rcutils_time_point_value_t timestamp) override
+  {
+    next_index_ = 0;
+    while (next_index_ < messages_.size() &&
+      messages_[next_index_]->time_stamp < timestamp)
+    {
+      ++next_index_;
+    }
+  }
+
+private:
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages_;
+  rosbag2_storage::BagMetadata metadata_;
+  size_t next_index_ = 0;
+};
+
+rosbag2_storage::BagMetadata make_metadata(
+  const std::string & topic_name, const std::string & type, size_t message_count,
+  int64_t starting_time_nanos, int64_t duration_nanos)
+{
+  rosbag2_storage::BagMetadata metadata;
+  metadata.storage_identifier = "sqlite3";
+  metadata.message_count = message_count;
+  metadata.starting_time = std::chrono::time_point<std::chrono::high_resolution_clock>(
+    std::chrono::nanoseconds(starting_time_nanos));
+  metadata.duration = std::chrono::nanoseconds(duration_nanos);
+  metadata.topics_with_message_count.push_back(
+    {{topic_name, type, "cdr", ""}, message_count, 0, 0});
+  return metadata;
+}
+
+std::unique_ptr<rosbag2_cpp::readers::MergedReader> make_merged_reader(
+  std::vector<std::unique_ptr<rosbag2_cpp::reader_interfaces::BaseReaderInterface>> readers)
+{
+  auto merged_reader = std::make_unique<rosbag2_cpp::readers::MergedReader>(std::move(readers));
+  rosbag2_cpp::StorageOptions options;
+  options.uri = "uri";
+  options.storage_id = "sqlite3";
+  std::vector<rosbag2_cpp::StorageOptions> storage_options(2, options);
+  merged_reader->open(storage_options, {"", ""});
+  return merged_reader;
+}
+
+}  // namespace
+
+TEST(MergedReader, interleaves_messages_from_all_bags_by_timestamp) {
+  std::vector<std::unique_ptr<rosbag2_cpp::reader_interfaces::BaseReaderInterface>> readers;
+  readers.push_back(
+    std::make_unique<FakeReader>(
+      std::vector<std::pair<std::string, int64_t>>{{"camera", 10}, {"camera", 30}},
+      make_metadata("camera", "image_type", 2, 10, 20)));
+  readers.push_back(
+    std::make_unique<FakeReader>(
+      std::vector<std::pair<std::string, int64_t>>{{"lidar", 5}, {"lidar", 20}, {"lidar", 40}},
+      make_metadata("lidar", "cloud_type", 3, 5, 35)));
+  auto merged_reader = make_merged_reader(std::move(readers));
+
+  std::vector<int64_t> timestamps;
+  while (merged_reader->has_next()) {
+    timestamps.push_back(merged_reader->read_next()->time_stamp);
+  }
+  EXPECT_THAT(timestamps, ElementsAre(5, 10, 20, 30, 40));
+}
+
+TEST(MergedReader, seek_repositions_all_bags) {
+  std::vector<std::unique_ptr<rosbag2_cpp::reader_interfaces::BaseReaderInterface>> readers;
+  readers.push_back(
+    std::make_unique<FakeReader>(
+      std::vector<std::pair<std::string, int64_t>>{{"camera", 10}, {"camera", 30}},
+      make_metadata("camera", "image_type", 2, 10, 20)));
+  readers.push_back(
+    std::make_unique<FakeReader>(
+      std::vector<std::pair<std::string, int64_t>>{{"lidar", 5}, {"lidar", 20}},
+      make_metadata("lidar", "cloud_type", 2, 5, 15)));
+  auto merged_reader = make_merged_reader(std::move(readers));
+
+  merged_reader->seek(15);
+
+  std::vector<int64_t> timestamps;
+  while (merged_reader->has_next()) {
+    timestamps.push_back(merged_reader->read_next()->time_stamp);
+  }
+  EXPECT_THAT(timestamps, ElementsAre(20, 30));
+}
+
+TEST(MergedReader, metadata_aggregates_counts_and_time_range) {
+  std::vector<std::unique_ptr<rosbag2_cpp::reader_interfaces::BaseReaderInterface>> readers;
+  readers.push_back(
+    std::make_unique<FakeReader>(
+      std::vector<std::pair<std::string, int64_t>>{},
+      make_metadata("camera", "image_type", 2, 10, 20)));
+  readers.push_back(
+    std::make_unique<FakeReader>(
+      std::vector<std::pair<std::string, int64_t>>{},
+      make_metadata("lidar", "cloud_type", 3, 5, 15)));
+  auto merged_reader = make_merged_reader(std::move(readers));
+
+  const auto & metadata = merged_reader->get_metadata();
+  EXPECT_THAT(metadata.message_count, Eq(5u));
+  EXPECT_THAT(metadata.topics_with_message_count, SizeIs(2u));
+  EXPECT_THAT(
+    metadata.starting_time.time_since_epoch(), Eq(std::chrono::nanoseconds(5)));
+  EXPECT_THAT(metadata.duration, Eq(std::chrono::nanoseconds(25)));
+}
+
+TEST(MergedReader, conflicting_topic_types_are_rejected) {
+  std::vector<std::unique_ptr<rosbag2_cpp::reader_interfaces::BaseReaderInterface>> readers;
+  readers.push_back(
+    std::make_unique<FakeReader>(
+      std::vector<std::pair<std::string, int64_t>>{},
+      make_metadata("camera", "image_type", 1, 10, 10)));
+  readers.push_back(
+    std::make_unique<FakeReader>(
+      std::vector<std::pair<std::string, int64_t>>{},
+      make_metadata("camera", "other_type", 1, 5, 10)));
+
+  auto merged_reader = std::make_unique<rosbag2_cpp::readers::MergedReader>(std::move(readers));
+  rosbag2_cpp::StorageOptions options;
+  options.uri = "uri";
+  options.storage_id = "sqlite3";
+  std::vector<rosbag2_cpp::StorageOptions> storage_options(2, options);
+  EXPECT_THROW(merged_reader->open(storage_options, {"", ""}), std::runtime_error);
+}
+
+TEST(MergedReader, opening_without_bags_is_rejected) {
+  rosbag2_cpp::readers::MergedReader merged_reader;
+  EXPECT_THROW(
+    merged_reader.open(std::vector<rosbag2_cpp::StorageOptions>{}, {"", ""}),
+    std::runtime_error);
+}
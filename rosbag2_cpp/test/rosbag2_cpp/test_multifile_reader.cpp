@@ -65,8 +65,10 @@ public:
     ON_CALL(*metadata_io, read_metadata(_)).WillByDefault(Return(metadata));
     EXPECT_CALL(*metadata_io, metadata_file_exists(_)).WillRepeatedly(Return(true));
 
+    // Queried once per opened file: the reader rebuilds its topic id remap
+    // table from every storage it opens.
     EXPECT_CALL(*storage_, get_all_topics_and_types())
-    .Times(AtMost(1)).WillRepeatedly(Return(topics_and_types));
+    .Times(AnyNumber()).WillRepeatedly(Return(topics_and_types));
     ON_CALL(*storage_, read_next()).WillByDefault(Return(message));
     EXPECT_CALL(*storage_factory, open_read_only(_, _)).WillRepeatedly(Return(storage_));
 
@@ -66,8 +66,10 @@ public:
     EXPECT_CALL(*metadata_io, read_metadata(_)).WillRepeatedly(Return(metadata));
     EXPECT_CALL(*metadata_io, metadata_file_exists(_)).WillRepeatedly(Return(true));
 
+    // Queried once per opened file: the reader rebuilds its topic id remap
+    // table from every storage it opens.
     EXPECT_CALL(*storage_, get_all_topics_and_types())
-    .Times(AtMost(1)).WillRepeatedly(Return(topics_and_types));
+    .Times(AnyNumber()).WillRepeatedly(Return(topics_and_types));
     EXPECT_CALL(*storage_, read_next()).WillRepeatedly(Return(message));
 
     EXPECT_CALL(*storage_factory, open_read_only(_, _));
@@ -131,6 +133,57 @@ TEST_F(
   reader_->read_next();
 }
 
+TEST_F(SequentialReaderTest, read_next_batch_stops_at_end_of_bag) {
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = "topic";
+  size_t remaining_messages = 3;
+  EXPECT_CALL(*storage_, has_next())
+  .WillRepeatedly([&remaining_messages]() {return remaining_messages > 0;});
+  EXPECT_CALL(*storage_, read_next())
+  .WillRepeatedly(
+    [&remaining_messages, message]() {
+      remaining_messages--;
+      return message;
+    });
+
+  reader_->open(default_storage_options_, {"", storage_serialization_format_});
+  auto batch = reader_->read_next_batch(10);
+  EXPECT_EQ(batch.size(), 3u);
+}
+
+TEST_F(SequentialReaderTest, read_next_batch_reuses_the_callers_buffer) {
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = "topic";
+  size_t remaining_messages = 5;
+  EXPECT_CALL(*storage_, has_next())
+  .WillRepeatedly([&remaining_messages]() {return remaining_messages > 0;});
+  EXPECT_CALL(*storage_, read_next())
+  .WillRepeatedly(
+    [&remaining_messages, message]() {
+      remaining_messages--;
+      return message;
+    });
+
+  reader_->open(default_storage_options_, {"", storage_serialization_format_});
+
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> batch;
+  reader_->read_next_batch(3, batch);
+  EXPECT_EQ(batch.size(), 3u);
+  const auto capacity_after_first_batch = batch.capacity();
+
+  // The second call clears the vector but keeps its capacity.
+  reader_->read_next_batch(3, batch);
+  EXPECT_EQ(batch.size(), 2u);
+  EXPECT_EQ(batch.capacity(), capacity_after_first_batch);
+}
+
+TEST_F(SequentialReaderTest, reverse_read_order_is_pushed_down_to_the_storage) {
+  EXPECT_CALL(*storage_, set_read_order(rosbag2_storage::ReadOrder::REVERSE)).Times(1);
+
+  reader_->open(default_storage_options_, {"", storage_serialization_format_});
+  reader_->set_read_order(rosbag2_storage::ReadOrder::REVERSE);
+}
+
 TEST_F(SequentialReaderTest, set_filter_calls_storage) {
   // Prior to opening the file, setting filter should throw exception
   rosbag2_storage::StorageFilter storage_filter;
@@ -14,8 +14,12 @@
 
 #include <gmock/gmock.h>
 
+#include <atomic>
+#include <chrono>
+#include <fstream>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -265,15 +269,535 @@ TEST_F(SequentialWriterTest, writer_splits_when_storage_bagfile_size_gt_max_bagf
   }
 }
 
+TEST_F(SequentialWriterTest, append_mode_resumes_existing_bag) {
+  // An existing bag directory with saved metadata stands in for the bag of
+  // a previous recording session.
+  rcpputils::fs::create_directories(rcpputils::fs::path(storage_options_.uri));
+
+  rosbag2_storage::BagMetadata previous{};
+  previous.relative_file_paths = {"uri_0"};
+  rosbag2_storage::FileInformation previous_file{};
+  previous_file.path = "uri_0";
+  previous.files = {previous_file};
+  rosbag2_storage::TopicInformation previous_topic{};
+  previous_topic.topic_metadata = {"test_topic", "test_msgs/BasicTypes", "", ""};
+  previous_topic.message_count = 3;
+  previous.topics_with_message_count = {previous_topic};
+  previous.message_count = 3;
+
+  ON_CALL(*metadata_io_, metadata_file_exists).WillByDefault(Return(true));
+  ON_CALL(*metadata_io_, read_metadata).WillByDefault(Return(previous));
+  EXPECT_CALL(*metadata_io_, write_metadata).Times(1);
+  ON_CALL(*metadata_io_, write_metadata).WillByDefault(
+    [this](const std::string &, const rosbag2_storage::BagMetadata & metadata) {
+      fake_metadata_ = metadata;
+    });
+  ON_CALL(*storage_, get_relative_file_path).WillByDefault(
+    [this]() {
+      return fake_storage_uri_;
+    });
+  // The saved topic is re-registered once while resuming; create_topic()
+  // afterwards must recognize it as already known.
+  EXPECT_CALL(*storage_, create_topic(_)).Times(1);
+
+  storage_options_.append_mode = true;
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_->create_topic({"test_topic", "test_msgs/BasicTypes", "", ""});
+
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = "test_topic";
+  writer_->write(message);
+  writer_->write(message);
+
+  writer_.reset();
+
+  // The resumed session continued the split sequence and the counts.
+  ASSERT_EQ(fake_metadata_.relative_file_paths.size(), 2u);
+  EXPECT_EQ(fake_metadata_.relative_file_paths.back(), "uri_1");
+  EXPECT_EQ(fake_metadata_.message_count, 5u);
+}
+
+TEST_F(SequentialWriterTest, append_mode_requires_existing_metadata) {
+  rcpputils::fs::create_directories(rcpputils::fs::path(storage_options_.uri));
+  ON_CALL(*metadata_io_, metadata_file_exists).WillByDefault(Return(false));
+
+  storage_options_.append_mode = true;
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+  EXPECT_THROW(writer_->open(storage_options_, {rmw_format, rmw_format}), std::runtime_error);
+}
+
+TEST_F(SequentialWriterTest, metadata_carries_message_size_percentiles) {
+  EXPECT_CALL(*metadata_io_, write_metadata).Times(1);
+  ON_CALL(*metadata_io_, write_metadata).WillByDefault(
+    [this](const std::string &, const rosbag2_storage::BagMetadata & metadata) {
+      fake_metadata_ = metadata;
+    });
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+  const std::string small_payload(100, 'x');
+  const std::string large_payload(5000, 'x');
+
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_->create_topic({"test_topic", "test_msgs/BasicTypes", "", ""});
+
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = "test_topic";
+  for (auto i = 0; i < 90; ++i) {
+    message->serialized_data = rosbag2_storage::make_serialized_message(
+      small_payload.c_str(), small_payload.length());
+    writer_->write(message);
+  }
+  for (auto i = 0; i < 10; ++i) {
+    message->serialized_data = rosbag2_storage::make_serialized_message(
+      large_payload.c_str(), large_payload.length());
+    writer_->write(message);
+  }
+
+  writer_.reset();
+
+  ASSERT_THAT(fake_metadata_.topics_with_message_count, SizeIs(1u));
+  const auto & topic = fake_metadata_.topics_with_message_count[0];
+  EXPECT_EQ(topic.message_count, 100u);
+  // The 100 byte messages land in the 64..127 bucket, whose upper bound the
+  // percentiles report; the maximum is exact.
+  EXPECT_EQ(topic.message_size_p50, 127u);
+  EXPECT_EQ(topic.message_size_p90, 127u);
+  EXPECT_EQ(topic.message_size_p99, 5000u);
+  EXPECT_EQ(topic.message_size_max, 5000u);
+}
+
+TEST_F(SequentialWriterTest, writer_splits_when_max_bagfile_messages_is_reached) {
+  const int message_count = 15;
+  const int max_bagfile_messages = 5;
+  const auto expected_splits = message_count / max_bagfile_messages;
+
+  ON_CALL(*storage_, get_relative_file_path).WillByDefault(
+    [this]() {
+      return fake_storage_uri_;
+    });
+
+  EXPECT_CALL(*metadata_io_, write_metadata).Times(1);
+
+  // intercept the metadata write so we can analyze it.
+  ON_CALL(*metadata_io_, write_metadata).WillByDefault(
+    [this](const std::string &, const rosbag2_storage::BagMetadata & metadata) {
+      fake_metadata_ = metadata;
+    });
+
+  // Splitting by message count never queries the bagfile size on the write
+  // path; the only queries are for the sealed-file size, one per split.
+  EXPECT_CALL(*storage_, get_bagfile_size).Times(expected_splits - 1);
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = "test_topic";
+
+  storage_options_.max_bagfile_messages = max_bagfile_messages;
+
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_->create_topic({"test_topic", "test_msgs/BasicTypes", "", ""});
+
+  for (auto i = 0; i < message_count; ++i) {
+    writer_->write(message);
+  }
+
+  writer_.reset();
+  // metadata should be written now that the Writer was released.
+
+  EXPECT_EQ(
+    fake_metadata_.relative_file_paths.size(),
+    static_cast<unsigned int>(expected_splits)) <<
+    "Storage should have split every " << max_bagfile_messages << " messages";
+}
+
+TEST_F(SequentialWriterTest, sealed_file_callback_fires_on_split_and_on_close) {
+  ON_CALL(*storage_, get_relative_file_path).WillByDefault(
+    [this]() {
+      return fake_storage_uri_;
+    });
+  ON_CALL(*storage_, get_bagfile_size).WillByDefault(Return(42));
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+
+  std::vector<rosbag2_cpp::SealedBagfileInfo> sealed_files;
+  sequential_writer->set_sealed_file_callback(
+    [&sealed_files](const rosbag2_cpp::SealedBagfileInfo & sealed_file) {
+      sealed_files.push_back(sealed_file);
+    });
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = "test_topic";
+
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_->create_topic({"test_topic", "test_msgs/BasicTypes", "", ""});
+
+  message->time_stamp = 100;
+  writer_->write(message);
+  message->time_stamp = 200;
+  writer_->write(message);
+  writer_->split_bagfile();
+  message->time_stamp = 300;
+  writer_->write(message);
+  writer_.reset();
+  // The first event covers the split, the second one the closing of the bag.
+
+  ASSERT_EQ(2u, sealed_files.size());
+  EXPECT_NE(sealed_files[0].file_path, sealed_files[1].file_path);
+  EXPECT_EQ(42u, sealed_files[0].file_size);
+  EXPECT_EQ(100, sealed_files[0].starting_time_ns);
+  EXPECT_EQ(200, sealed_files[0].ending_time_ns);
+  EXPECT_EQ(300, sealed_files[1].starting_time_ns);
+  EXPECT_EQ(300, sealed_files[1].ending_time_ns);
+}
+
+TEST_F(SequentialWriterTest, rotation_seals_old_bag_and_continues_in_new_folder) {
+  const std::string rotated_uri = "uri_rotated";
+  rcpputils::fs::remove_all(rcpputils::fs::path(rotated_uri));
+
+  ON_CALL(*storage_, get_relative_file_path).WillByDefault(
+    [this]() {
+      return fake_storage_uri_;
+    });
+
+  // One metadata file per session: the rotation writes the sealed bag's,
+  // closing the writer writes the new session's.
+  std::vector<std::pair<std::string, rosbag2_storage::BagMetadata>> written_metadata;
+  EXPECT_CALL(*metadata_io_, write_metadata).Times(2);
+  ON_CALL(*metadata_io_, write_metadata).WillByDefault(
+    [&written_metadata](const std::string & uri, const rosbag2_storage::BagMetadata & metadata) {
+      written_metadata.emplace_back(uri, metadata);
+    });
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = "test_topic";
+
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_->create_topic({"test_topic", "test_msgs/BasicTypes", "", ""});
+
+  for (auto i = 0; i < 3; ++i) {
+    writer_->write(message);
+  }
+  writer_->rotate_bag(rotated_uri);
+  for (auto i = 0; i < 2; ++i) {
+    writer_->write(message);
+  }
+  writer_.reset();
+
+  ASSERT_EQ(2u, written_metadata.size());
+  EXPECT_EQ(storage_options_.uri, written_metadata[0].first);
+  EXPECT_EQ(3u, written_metadata[0].second.message_count);
+  EXPECT_EQ(rotated_uri, written_metadata[1].first);
+  EXPECT_EQ(2u, written_metadata[1].second.message_count);
+  // The topic registration carried over; only its counters restarted.
+  ASSERT_EQ(1u, written_metadata[1].second.topics_with_message_count.size());
+  EXPECT_EQ(
+    "test_topic",
+    written_metadata[1].second.topics_with_message_count[0].topic_metadata.name);
+  // The new session's first file lives in the new folder.
+  ASSERT_EQ(1u, written_metadata[1].second.relative_file_paths.size());
+  EXPECT_EQ("uri_rotated_0", written_metadata[1].second.relative_file_paths[0]);
+
+  rcpputils::fs::remove_all(rcpputils::fs::path(rotated_uri));
+}
+
+TEST_F(SequentialWriterTest, rotation_into_an_existing_directory_is_rejected) {
+  const std::string rotated_uri = "uri_rotated";
+  rcpputils::fs::create_directories(rcpputils::fs::path(rotated_uri));
+
+  ON_CALL(*storage_, get_relative_file_path).WillByDefault(
+    [this]() {
+      return fake_storage_uri_;
+    });
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+
+  EXPECT_THROW(writer_->rotate_bag(rotated_uri), std::runtime_error);
+
+  rcpputils::fs::remove_all(rcpputils::fs::path(rotated_uri));
+}
+
+TEST_F(SequentialWriterTest, tiered_mode_migrates_sealed_files_into_the_bag_directory) {
+  storage_options_.active_split_directory = "uri_active";
+  // Splitting must be configured for tiered mode; keep the limit far above
+  // the mocked file size so no split happens on its own.
+  storage_options_.max_bagfile_size = 10000;
+  ON_CALL(*storage_, get_relative_file_path).WillByDefault(
+    [this]() {
+      return fake_storage_uri_;
+    });
+  ON_CALL(*storage_, get_bagfile_size).WillByDefault(Return(42));
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+
+  std::vector<rosbag2_cpp::SealedBagfileInfo> sealed_files;
+  sequential_writer->set_sealed_file_callback(
+    [&sealed_files](const rosbag2_cpp::SealedBagfileInfo & sealed_file) {
+      sealed_files.push_back(sealed_file);
+    });
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = "test_topic";
+
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_->create_topic({"test_topic", "test_msgs/BasicTypes", "", ""});
+
+  message->time_stamp = 100;
+  writer_->write(message);
+  // The mock storage writes nothing; stand in for the active split file.
+  std::ofstream(fake_storage_uri_) << "first split";
+  writer_->split_bagfile();
+  message->time_stamp = 200;
+  writer_->write(message);
+  std::ofstream(fake_storage_uri_) << "second split";
+  writer_.reset();
+  // Closing the bag drains the migrator, so both sealed files were moved
+  // from the active-split directory into the bag directory by now.
+
+  EXPECT_TRUE((rcpputils::fs::path("uri") / "uri_0").exists());
+  EXPECT_TRUE((rcpputils::fs::path("uri") / "uri_1").exists());
+  EXPECT_FALSE((rcpputils::fs::path("uri_active") / "uri_0").exists());
+  EXPECT_FALSE((rcpputils::fs::path("uri_active") / "uri_1").exists());
+
+  // The sealed-file notification is deferred until after the migration and
+  // reports the final location, not the RAM-disk one.
+  ASSERT_EQ(2u, sealed_files.size());
+  EXPECT_EQ((rcpputils::fs::path("uri") / "uri_0").string(), sealed_files[0].file_path);
+  EXPECT_EQ((rcpputils::fs::path("uri") / "uri_1").string(), sealed_files[1].file_path);
+
+  rcpputils::fs::remove_all(rcpputils::fs::path("uri_active"));
+}
+
+TEST_F(SequentialWriterTest, tiered_mode_requires_bagfile_splitting) {
+  storage_options_.active_split_directory = "uri_active";
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+  EXPECT_THROW(writer_->open(storage_options_, {rmw_format, rmw_format}), std::runtime_error);
+}
+
 TEST_F(SequentialWriterTest, only_write_after_cache_is_full) {
   const uint64_t counter = 1000;
   const uint64_t max_cache_size = 100;
   std::string msg_content = "Hello";
   const auto msg_length = msg_content.length();
+
+  // The cache is drained by a dedicated writer thread, so the number of
+  // batches is timing dependent. Count the messages which were delivered in
+  // batches instead and expect all of them once the writer is closed.
+  std::atomic<uint64_t> messages_written {0};
+  EXPECT_CALL(
+    *storage_,
+    write(An<const rosbag2_storage::SerializedBagMessageSpan &>())).
+  Times(AtLeast(1)).
+  WillRepeatedly(
+    [&messages_written](const rosbag2_storage::SerializedBagMessageSpan & messages)
+    {
+      messages_written += messages.size;
+    });
+  EXPECT_CALL(
+    *storage_,
+    write(An<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>>())).Times(0);
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = "test_topic";
+  message->serialized_data = rosbag2_storage::make_serialized_message(
+    msg_content.c_str(), msg_length);
+
+  storage_options_.max_bagfile_size = 0;
+  storage_options_.max_cache_size = max_cache_size;
+
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_->create_topic({"test_topic", "test_msgs/BasicTypes", "", ""});
+
+  for (auto i = 0u; i < counter; ++i) {
+    writer_->write(message);
+  }
+
+  writer_.reset();  // flushes the cache and joins the writer thread
+  EXPECT_EQ(messages_written, counter);
+}
+
+TEST_F(SequentialWriterTest, cache_age_triggers_flush_before_size_threshold) {
+  const uint64_t message_count = 5;
+  std::string msg_content = "Hello";
+  const auto msg_length = msg_content.length();
+
+  std::atomic<uint64_t> messages_written {0};
+  EXPECT_CALL(
+    *storage_,
+    write(An<const rosbag2_storage::SerializedBagMessageSpan &>())).
+  Times(AtLeast(1)).
+  WillRepeatedly(
+    [&messages_written](const rosbag2_storage::SerializedBagMessageSpan & messages)
+    {
+      messages_written += messages.size;
+    });
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = "test_topic";
+  message->serialized_data = rosbag2_storage::make_serialized_message(
+    msg_content.c_str(), msg_length);
+
+  // The size threshold is far above what the test stages, so only the age
+  // trigger can flush before the writer is closed.
+  storage_options_.max_bagfile_size = 0;
+  storage_options_.max_cache_size = 1024 * 1024;
+  storage_options_.max_cache_age = 50;
+
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_->create_topic({"test_topic", "test_msgs/BasicTypes", "", ""});
+
+  for (auto i = 0u; i < message_count; ++i) {
+    writer_->write(message);
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (messages_written < message_count && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(messages_written, message_count);
+
+  writer_.reset();
+}
+
+TEST_F(SequentialWriterTest, concurrent_writes_are_all_persisted_and_counted) {
+  const size_t writer_thread_count = 4;
+  const uint64_t messages_per_thread = 250;
+  std::string msg_content = "Hello";
+  const auto msg_length = msg_content.length();
+
+  // With a cache, batches reach the storage only from the cache writer
+  // thread; counting the batched messages therefore needs no extra locking.
+  std::atomic<uint64_t> messages_written {0};
+  EXPECT_CALL(
+    *storage_,
+    write(An<const rosbag2_storage::SerializedBagMessageSpan &>())).
+  Times(AtLeast(1)).
+  WillRepeatedly(
+    [&messages_written](const rosbag2_storage::SerializedBagMessageSpan & messages)
+    {
+      messages_written += messages.size;
+    });
+
+  ON_CALL(*metadata_io_, write_metadata).WillByDefault(
+    [this](const std::string &, const rosbag2_storage::BagMetadata & metadata) {
+      fake_metadata_ = metadata;
+    });
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+
+  storage_options_.max_bagfile_size = 0;
+  storage_options_.max_cache_size = 100;
+
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  for (size_t i = 0; i < writer_thread_count; ++i) {
+    writer_->create_topic(
+      {"topic_" + std::to_string(i), "test_msgs/BasicTypes", "", ""});
+  }
+
+  // Each thread hammers its own topic, as the callback threads of a
+  // multithreaded executor would.
+  std::vector<std::thread> writer_threads;
+  for (size_t i = 0; i < writer_thread_count; ++i) {
+    writer_threads.emplace_back(
+      [this, i, messages_per_thread, &msg_content, msg_length]() {
+        auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+        message->topic_name = "topic_" + std::to_string(i);
+        message->serialized_data = rosbag2_storage::make_serialized_message(
+          msg_content.c_str(), msg_length);
+        for (uint64_t count = 0; count < messages_per_thread; ++count) {
+          writer_->write(message);
+        }
+      });
+  }
+  for (auto & thread : writer_threads) {
+    thread.join();
+  }
+
+  writer_.reset();  // flushes the cache and joins the writer thread
+
+  EXPECT_EQ(messages_written, writer_thread_count * messages_per_thread);
+  ASSERT_EQ(fake_metadata_.topics_with_message_count.size(), writer_thread_count);
+  for (const auto & topic : fake_metadata_.topics_with_message_count) {
+    EXPECT_EQ(topic.message_count, messages_per_thread);
+  }
+}
+
+TEST_F(SequentialWriterTest, snapshot_mode_only_writes_on_trigger) {
+  const uint64_t counter = 1000;
+  const uint64_t max_cache_size = 100;
+  std::string msg_content = "Hello";
+  const auto msg_length = msg_content.length();
+
+  std::atomic<uint64_t> messages_written {0};
   EXPECT_CALL(
     *storage_,
     write(An<const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> &>())).
-  Times(static_cast<int>(counter * msg_length / max_cache_size));
+  Times(1).
+  WillOnce(
+    [&messages_written](
+      const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> & messages)
+    {
+      messages_written += messages.size();
+    });
   EXPECT_CALL(
     *storage_,
     write(An<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>>())).Times(0);
@@ -291,6 +815,7 @@ TEST_F(SequentialWriterTest, only_write_after_cache_is_full) {
 
   storage_options_.max_bagfile_size = 0;
   storage_options_.max_cache_size = max_cache_size;
+  storage_options_.snapshot_mode = true;
 
   writer_->open(storage_options_, {rmw_format, rmw_format});
   writer_->create_topic({"test_topic", "test_msgs/BasicTypes", "", ""});
@@ -298,6 +823,11 @@ TEST_F(SequentialWriterTest, only_write_after_cache_is_full) {
   for (auto i = 0u; i < counter; ++i) {
     writer_->write(message);
   }
+
+  EXPECT_TRUE(writer_->take_snapshot());
+
+  // Only the messages which still fit into the circular buffer are persisted.
+  EXPECT_EQ(messages_written, max_cache_size / msg_length);
 }
 
 TEST_F(SequentialWriterTest, do_not_use_cache_if_cache_size_is_zero) {
@@ -308,6 +838,9 @@ TEST_F(SequentialWriterTest, do_not_use_cache_if_cache_size_is_zero) {
     *storage_,
     write(An<const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> &>())).
   Times(0);
+  EXPECT_CALL(
+    *storage_,
+    write(An<const rosbag2_storage::SerializedBagMessageSpan &>())).Times(0);
   EXPECT_CALL(
     *storage_,
     write(An<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>>())).Times(counter);
@@ -336,3 +869,59 @@ TEST_F(SequentialWriterTest, do_not_use_cache_if_cache_size_is_zero) {
     writer_->write(message);
   }
 }
+
+TEST_F(SequentialWriterTest, messages_are_stamped_with_interned_topic_ids) {
+  std::vector<uint32_t> created_topic_ids;
+  ON_CALL(*storage_, create_topic(_)).WillByDefault(
+    [&created_topic_ids](const rosbag2_storage::TopicMetadata & topic) {
+      created_topic_ids.push_back(topic.topic_id);
+    });
+  std::vector<uint32_t> written_topic_ids;
+  ON_CALL(
+    *storage_,
+    write(An<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>>())).WillByDefault(
+    [&written_topic_ids](std::shared_ptr<const rosbag2_storage::SerializedBagMessage> message) {
+      written_topic_ids.push_back(message->topic_id);
+    });
+
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  std::string rmw_format = "rmw_format";
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_->create_topic({"topic_a", "test_msgs/BasicTypes", "", ""});
+  writer_->create_topic({"topic_b", "test_msgs/BasicTypes", "", ""});
+
+  EXPECT_THAT(created_topic_ids, ElementsAre(1u, 2u));
+  EXPECT_EQ(1u, writer_->get_implementation_handle().get_topic_id("topic_a"));
+  EXPECT_EQ(0u, writer_->get_implementation_handle().get_topic_id("unknown_topic"));
+
+  std::string msg_content = "Hello";
+  for (const auto & topic_name : {"topic_b", "topic_a", "topic_b"}) {
+    auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+    message->topic_name = topic_name;
+    message->serialized_data = rosbag2_storage::make_serialized_message(
+      msg_content.c_str(), msg_content.length());
+    writer_->write(message);
+  }
+
+  // The writer stamps the interned id on the message at the by-name lookup
+  // it has to do anyway, so the storage never hashes the name again.
+  EXPECT_THAT(written_topic_ids, ElementsAre(2u, 1u, 2u));
+}
+
+TEST_F(SequentialWriterTest, open_throws_error_on_invalid_cache_memory_budget) {
+  auto sequential_writer = std::make_unique<rosbag2_cpp::writers::SequentialWriter>(
+    std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+  writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sequential_writer));
+
+  // The budget bounds both cache buffers, so it must leave room beyond the
+  // flush threshold.
+  storage_options_.max_cache_size = 100;
+  storage_options_.cache_memory_budget = 100;
+
+  std::string rmw_format = "rmw_format";
+
+  EXPECT_THROW(writer_->open(storage_options_, {rmw_format, rmw_format}), std::runtime_error);
+}
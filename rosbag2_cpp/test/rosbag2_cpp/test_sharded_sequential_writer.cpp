@@ -0,0 +1,224 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+
+#include "rosbag2_cpp/writers/sharded_sequential_writer.hpp"
+#include "rosbag2_cpp/writer.hpp"
+
+#include "rosbag2_storage/bag_metadata.hpp"
+#include "rosbag2_storage/ros_helper.hpp"
+#include "rosbag2_storage/topic_metadata.hpp"
+
+#include "mock_converter_factory.hpp"
+#include "mock_metadata_io.hpp"
+#include "mock_storage.hpp"
+#include "mock_storage_factory.hpp"
+
+using namespace testing;  // NOLINT
+
+namespace
+{
+std::shared_ptr<rosbag2_storage::SerializedBagMessage> make_test_message(
+  const std::string & topic_name)
+{
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->topic_name = topic_name;
+  message->serialized_data = rosbag2_storage::make_serialized_message("msg", 3);
+  return message;
+}
+}  // namespace
+
+class ShardedSequentialWriterTest : public Test
+{
+public:
+  ShardedSequentialWriterTest()
+  {
+    storage_factory_ = std::make_unique<StrictMock<MockStorageFactory>>();
+    first_storage_ = std::make_shared<NiceMock<MockStorage>>();
+    second_storage_ = std::make_shared<NiceMock<MockStorage>>();
+    converter_factory_ = std::make_shared<StrictMock<MockConverterFactory>>();
+    metadata_io_ = std::make_unique<NiceMock<MockMetadataIo>>();
+    storage_options_ = rosbag2_cpp::StorageOptions{};
+    storage_options_.uri = "uri";
+    storage_options_.storage_shard_count = 2;
+
+    rcpputils::fs::path dir(storage_options_.uri);
+    rcpputils::fs::remove_all(dir);
+
+    ON_CALL(*first_storage_, get_relative_file_path()).WillByDefault(Return("uri_0"));
+    ON_CALL(*second_storage_, get_relative_file_path()).WillByDefault(Return("uri_1"));
+  }
+
+  ~ShardedSequentialWriterTest()
+  {
+    rcpputils::fs::path dir(storage_options_.uri);
+    rcpputils::fs::remove_all(dir);
+  }
+
+  void make_writer()
+  {
+    auto sharded_writer = std::make_unique<rosbag2_cpp::writers::ShardedSequentialWriter>(
+      std::move(storage_factory_), converter_factory_, std::move(metadata_io_));
+    writer_ = std::make_unique<rosbag2_cpp::Writer>(std::move(sharded_writer));
+  }
+
+  std::unique_ptr<StrictMock<MockStorageFactory>> storage_factory_;
+  std::shared_ptr<NiceMock<MockStorage>> first_storage_;
+  std::shared_ptr<NiceMock<MockStorage>> second_storage_;
+  std::shared_ptr<StrictMock<MockConverterFactory>> converter_factory_;
+  std::unique_ptr<NiceMock<MockMetadataIo>> metadata_io_;
+  std::unique_ptr<rosbag2_cpp::Writer> writer_;
+  rosbag2_cpp::StorageOptions storage_options_;
+};
+
+TEST_F(ShardedSequentialWriterTest, open_throws_error_if_shard_count_is_below_two) {
+  storage_options_.storage_shard_count = 1;
+  make_writer();
+
+  std::string rmw_format = "rmw_format";
+  EXPECT_THROW(writer_->open(storage_options_, {rmw_format, rmw_format}), std::runtime_error);
+}
+
+TEST_F(ShardedSequentialWriterTest, topics_are_partitioned_and_written_to_their_shard) {
+  EXPECT_CALL(*storage_factory_, open_read_write(_, _))
+  .WillOnce(Return(first_storage_))
+  .WillOnce(Return(second_storage_));
+
+  std::vector<std::string> first_shard_topics;
+  std::vector<std::string> second_shard_topics;
+  EXPECT_CALL(*first_storage_, create_topic(_)).WillRepeatedly(
+    Invoke(
+      [&first_shard_topics](const rosbag2_storage::TopicMetadata & topic) {
+        first_shard_topics.push_back(topic.name);
+      }));
+  EXPECT_CALL(*second_storage_, create_topic(_)).WillRepeatedly(
+    Invoke(
+      [&second_shard_topics](const rosbag2_storage::TopicMetadata & topic) {
+        second_shard_topics.push_back(topic.name);
+      }));
+
+  std::vector<std::string> first_shard_messages;
+  std::vector<std::string> second_shard_messages;
+  auto append_topic_names = [](std::vector<std::string> & target) {
+      return
+        [&target](
+        const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> &
+        messages) {
+          for (const auto & message : messages) {
+            target.push_back(message->topic_name);
+          }
+        };
+    };
+  EXPECT_CALL(
+    *first_storage_,
+    write(
+      An<const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> &>()))
+  .WillRepeatedly(Invoke(append_topic_names(first_shard_messages)));
+  EXPECT_CALL(
+    *second_storage_,
+    write(
+      An<const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> &>()))
+  .WillRepeatedly(Invoke(append_topic_names(second_shard_messages)));
+
+  make_writer();
+
+  std::string rmw_format = "rmw_format";
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_->create_topic({"topic_a", "test_msgs/BasicTypes", "", ""});
+  writer_->create_topic({"topic_b", "test_msgs/BasicTypes", "", ""});
+  writer_->create_topic({"topic_c", "test_msgs/BasicTypes", "", ""});
+
+  writer_->write(make_test_message("topic_a"));
+  writer_->write(make_test_message("topic_b"));
+  writer_->write(make_test_message("topic_c"));
+  writer_->write(make_test_message("topic_a"));
+
+  writer_.reset();  // Closing the bag flushes the shard buffers.
+
+  EXPECT_THAT(first_shard_topics, ElementsAre("topic_a", "topic_c"));
+  EXPECT_THAT(second_shard_topics, ElementsAre("topic_b"));
+  EXPECT_THAT(first_shard_messages, ElementsAre("topic_a", "topic_c", "topic_a"));
+  EXPECT_THAT(second_shard_messages, ElementsAre("topic_b"));
+}
+
+TEST_F(ShardedSequentialWriterTest, interned_topic_ids_resolve_the_shard_without_name_lookup) {
+  EXPECT_CALL(*storage_factory_, open_read_write(_, _))
+  .WillOnce(Return(first_storage_))
+  .WillOnce(Return(second_storage_));
+
+  std::vector<std::string> second_shard_messages;
+  EXPECT_CALL(
+    *second_storage_,
+    write(
+      An<const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> &>()))
+  .WillRepeatedly(
+    Invoke(
+      [&second_shard_messages](
+        const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> &
+        messages) {
+        for (const auto & message : messages) {
+          second_shard_messages.push_back(message->topic_name);
+        }
+      }));
+
+  make_writer();
+
+  std::string rmw_format = "rmw_format";
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_->create_topic({"topic_a", "test_msgs/BasicTypes", "", ""});
+  writer_->create_topic({"topic_b", "test_msgs/BasicTypes", "", ""});
+
+  // topic_b owns id 2 and lives on the second shard. A message carrying the
+  // id must land there even though its name would not resolve, proving that
+  // the id path routed it.
+  const auto topic_id = writer_->get_implementation_handle().get_topic_id("topic_b");
+  ASSERT_EQ(topic_id, 2u);
+  auto message = make_test_message("no_such_topic");
+  message->topic_id = topic_id;
+  writer_->write(message);
+
+  writer_.reset();  // Closing the bag flushes the shard buffers.
+
+  EXPECT_THAT(second_shard_messages, ElementsAre("no_such_topic"));
+}
+
+TEST_F(ShardedSequentialWriterTest, metadata_records_shard_count_and_all_shard_files) {
+  EXPECT_CALL(*storage_factory_, open_read_write(_, _))
+  .WillOnce(Return(first_storage_))
+  .WillOnce(Return(second_storage_));
+
+  rosbag2_storage::BagMetadata written_metadata;
+  EXPECT_CALL(*metadata_io_, write_metadata(_, _)).WillRepeatedly(
+    Invoke(
+      [&written_metadata](const std::string &, const rosbag2_storage::BagMetadata & metadata) {
+        written_metadata = metadata;
+      }));
+
+  make_writer();
+
+  std::string rmw_format = "rmw_format";
+  writer_->open(storage_options_, {rmw_format, rmw_format});
+  writer_.reset();
+
+  EXPECT_EQ(written_metadata.storage_shard_count, 2u);
+  EXPECT_THAT(written_metadata.relative_file_paths, ElementsAre("uri_0", "uri_1"));
+}
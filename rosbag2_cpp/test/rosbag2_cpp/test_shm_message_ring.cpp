@@ -0,0 +1,133 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rosbag2_cpp/writers/shm_message_ring.hpp"
+
+using rosbag2_cpp::writers::ShmMessageRing;
+using rosbag2_cpp::writers::ShmRecordType;
+
+namespace
+{
+constexpr std::chrono::milliseconds TIMEOUT{1000};
+
+std::string unique_ring_name()
+{
+  return "/rosbag2_test_ring_" +
+         std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+}  // namespace
+
+TEST(shm_record_framing, integers_and_strings_round_trip)
+{
+  std::vector<uint8_t> payload;
+  rosbag2_cpp::writers::append_uint64(payload, 0);
+  rosbag2_cpp::writers::append_string(payload, "some topic");
+  rosbag2_cpp::writers::append_uint64(payload, UINT64_MAX);
+  rosbag2_cpp::writers::append_string(payload, "");
+
+  size_t offset = 0;
+  EXPECT_EQ(rosbag2_cpp::writers::read_uint64(payload, offset), 0u);
+  EXPECT_EQ(rosbag2_cpp::writers::read_string(payload, offset), "some topic");
+  EXPECT_EQ(rosbag2_cpp::writers::read_uint64(payload, offset), UINT64_MAX);
+  EXPECT_EQ(rosbag2_cpp::writers::read_string(payload, offset), "");
+  EXPECT_EQ(offset, payload.size());
+}
+
+TEST(shm_record_framing, truncated_payload_throws)
+{
+  std::vector<uint8_t> payload;
+  rosbag2_cpp::writers::append_string(payload, "some topic");
+  payload.pop_back();
+
+  size_t offset = 0;
+  EXPECT_THROW(rosbag2_cpp::writers::read_string(payload, offset), std::runtime_error);
+}
+
+#ifndef _WIN32
+
+TEST(shm_message_ring, records_round_trip_in_order)
+{
+  auto producer = ShmMessageRing::create(unique_ring_name(), 4096);
+  auto consumer = ShmMessageRing::attach(producer->name());
+
+  const std::vector<uint8_t> first{1, 2, 3};
+  const std::vector<uint8_t> second{4, 5, 6, 7};
+  ASSERT_TRUE(producer->push(ShmRecordType::CREATE_TOPIC, first.data(), first.size(), TIMEOUT));
+  ASSERT_TRUE(producer->push(ShmRecordType::MESSAGE, second.data(), second.size(), TIMEOUT));
+
+  ShmRecordType type;
+  std::vector<uint8_t> payload;
+  ASSERT_TRUE(consumer->pop(type, payload, TIMEOUT));
+  EXPECT_EQ(type, ShmRecordType::CREATE_TOPIC);
+  EXPECT_EQ(payload, first);
+  ASSERT_TRUE(consumer->pop(type, payload, TIMEOUT));
+  EXPECT_EQ(type, ShmRecordType::MESSAGE);
+  EXPECT_EQ(payload, second);
+}
+
+TEST(shm_message_ring, pop_times_out_on_empty_ring)
+{
+  auto ring = ShmMessageRing::create(unique_ring_name(), 4096);
+
+  ShmRecordType type;
+  std::vector<uint8_t> payload;
+  EXPECT_FALSE(ring->pop(type, payload, std::chrono::milliseconds(10)));
+}
+
+TEST(shm_message_ring, push_times_out_on_full_ring_until_drained)
+{
+  // Capacity for barely more than one record, so the second push wraps and
+  // has to wait for the consumer.
+  auto producer = ShmMessageRing::create(unique_ring_name(), 96);
+  auto consumer = ShmMessageRing::attach(producer->name());
+
+  const std::vector<uint8_t> record(64, 42);
+  ASSERT_TRUE(producer->push(ShmRecordType::MESSAGE, record.data(), record.size(), TIMEOUT));
+  EXPECT_FALSE(
+    producer->push(ShmRecordType::MESSAGE, record.data(), record.size(),
+    std::chrono::milliseconds(10)));
+
+  std::thread drainer(
+    [&consumer]() {
+      ShmRecordType type;
+      std::vector<uint8_t> payload;
+      ASSERT_TRUE(consumer->pop(type, payload, TIMEOUT));
+    });
+  EXPECT_TRUE(producer->push(ShmRecordType::MESSAGE, record.data(), record.size(), TIMEOUT));
+  drainer.join();
+
+  ShmRecordType type;
+  std::vector<uint8_t> payload;
+  ASSERT_TRUE(consumer->pop(type, payload, TIMEOUT));
+  EXPECT_EQ(payload, record);
+}
+
+TEST(shm_message_ring, oversized_record_throws)
+{
+  auto ring = ShmMessageRing::create(unique_ring_name(), 64);
+
+  const std::vector<uint8_t> record(128, 42);
+  EXPECT_THROW(
+    ring->push(ShmRecordType::MESSAGE, record.data(), record.size(), TIMEOUT),
+    std::runtime_error);
+}
+
+#endif  // _WIN32
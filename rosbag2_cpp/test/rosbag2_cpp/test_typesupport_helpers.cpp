@@ -89,6 +89,20 @@ TEST(TypesupportHelpersTest, returns_c_type_info_for_valid_legacy_library) {
   }
 }
 
+TEST(TypesupportHelpersTest, registry_returns_the_same_handle_for_repeated_requests) {
+  try {
+    auto first_handle = rosbag2_cpp::get_typesupport_handle(
+      "test_msgs/msg/BasicTypes", "rosidl_typesupport_cpp");
+    auto second_handle = rosbag2_cpp::get_typesupport_handle(
+      "test_msgs/msg/BasicTypes", "rosidl_typesupport_cpp");
+
+    EXPECT_THAT(first_handle, NotNull());
+    EXPECT_EQ(first_handle, second_handle);
+  } catch (const std::runtime_error & e) {
+    FAIL() << e.what();
+  }
+}
+
 TEST(TypesupportHelpersTest, returns_c_type_info_for_valid_library) {
   try {
     auto library = rosbag2_cpp::get_typesupport_library(
@@ -0,0 +1,60 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_PERFORMANCE_PLAYBACK_BENCHMARKING__PLAYBACK_BENCHMARK_HPP_
+#define ROSBAG2_PERFORMANCE_PLAYBACK_BENCHMARKING__PLAYBACK_BENCHMARK_HPP_
+
+#include <memory>
+#include <string>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rosbag2_cpp/readers/sequential_reader.hpp"
+
+#include "rosbag2_performance_playback_benchmarking/latency_histogram.hpp"
+
+/// Generates a bag of configurable shape, then replays it with the same
+/// timeline-pacing loop the Player uses and measures how far each message's
+/// delivery deviates from the recorded timeline.
+class PlaybackBenchmark : public rclcpp::Node
+{
+public:
+  explicit PlaybackBenchmark(const std::string & name);
+  void start_benchmark();
+
+private:
+  void generate_bag();
+  void run_playback();
+  void write_results() const;
+
+  unsigned int frequency_;
+  unsigned int max_count_;
+  unsigned int message_size_;
+  unsigned int instances_;
+  std::string db_folder_;
+  std::string results_file_;
+
+  // Publish-time error is split into two histograms: lateness is the jitter
+  // a subscriber would observe, earliness is the slack left between the
+  // reader handing a message out and its publish deadline.
+  LatencyHistogram lateness_;
+  LatencyHistogram earliness_;
+  // Messages whose scheduled publish time had already passed when the
+  // reader handed them out - the reader starved the playback queue.
+  uint64_t starvation_events_{0};
+  uint64_t total_bytes_played_{0};
+  uint64_t total_messages_played_{0};
+  double playback_duration_seconds_{0.0};
+};
+
+#endif  // ROSBAG2_PERFORMANCE_PLAYBACK_BENCHMARKING__PLAYBACK_BENCHMARK_HPP_
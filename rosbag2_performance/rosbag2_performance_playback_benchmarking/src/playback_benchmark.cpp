@@ -0,0 +1,199 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rmw/rmw.h"
+#include "rosbag2_cpp/storage_options.hpp"
+#include "rosbag2_cpp/writers/sequential_writer.hpp"
+#include "rosbag2_storage/ros_helper.hpp"
+#include "rosbag2_storage/serialized_bag_message.hpp"
+
+#include "rosbag2_performance_playback_benchmarking/playback_benchmark.hpp"
+
+using namespace std::chrono_literals;
+
+PlaybackBenchmark::PlaybackBenchmark(const std::string & name)
+: rclcpp::Node(name)
+{
+  const std::string default_bag_folder("/tmp/rosbag2_playback_test");
+  this->declare_parameter("frequency", 100);
+  this->declare_parameter("max_count", 1000);
+  this->declare_parameter("size", 1000000);
+  this->declare_parameter("instances", 1);
+  this->declare_parameter("db_folder", default_bag_folder);
+  this->declare_parameter("results_file", default_bag_folder + "/results.csv");
+
+  this->get_parameter("frequency", frequency_);
+  if (frequency_ == 0) {
+    RCLCPP_ERROR(this->get_logger(), "Frequency can't be 0. Exiting.");
+    rclcpp::shutdown(nullptr, "frequency error");
+    return;
+  }
+
+  this->get_parameter("max_count", max_count_);
+  this->get_parameter("size", message_size_);
+  this->get_parameter("instances", instances_);
+  this->get_parameter("db_folder", db_folder_);
+  this->get_parameter("results_file", results_file_);
+}
+
+void PlaybackBenchmark::start_benchmark()
+{
+  generate_bag();
+  run_playback();
+  write_results();
+}
+
+void PlaybackBenchmark::generate_bag()
+{
+  RCLCPP_INFO_STREAM(
+    get_logger(), "\nPlaybackBenchmark: generating a bag with " << instances_ <<
+      " topics, " << max_count_ << " messages each of " << message_size_ <<
+      " bytes, recorded at " << frequency_ << " Hz");
+
+  rosbag2_cpp::writers::SequentialWriter writer;
+  rosbag2_cpp::StorageOptions storage_options{};
+  storage_options.uri = db_folder_;
+  storage_options.storage_id = "sqlite3";
+
+  std::string serialization_format = rmw_get_serialization_format();
+  writer.open(storage_options, {serialization_format, serialization_format});
+
+  std::vector<std::string> topic_names;
+  for (unsigned int i = 0; i < instances_; ++i) {
+    rosbag2_storage::TopicMetadata topic;
+    topic.name = "/playback_benchmark/topic " + std::to_string(i);
+    topic.type = "std_msgs::msgs::ByteMultiArray";
+    topic.serialization_format = serialization_format;
+    writer.create_topic(topic);
+    topic_names.push_back(topic.name);
+  }
+
+  const std::string payload(message_size_, '.');
+  const auto period_ns = static_cast<rcutils_time_point_value_t>(1000000000 / frequency_);
+  for (unsigned int count = 0; count < max_count_; ++count) {
+    for (const auto & topic_name : topic_names) {
+      auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+      message->serialized_data =
+        rosbag2_storage::make_serialized_message(payload.c_str(), payload.size());
+      message->topic_name = topic_name;
+      message->time_stamp = count * period_ns;
+      writer.write(message);
+    }
+  }
+  writer.reset();
+}
+
+void PlaybackBenchmark::run_playback()
+{
+  RCLCPP_INFO(get_logger(), "PlaybackBenchmark: replaying against the recorded timeline");
+
+  rosbag2_cpp::readers::SequentialReader reader;
+  rosbag2_cpp::StorageOptions storage_options{};
+  storage_options.uri = db_folder_;
+  storage_options.storage_id = "sqlite3";
+  std::string serialization_format = rmw_get_serialization_format();
+  reader.open(storage_options, {serialization_format, serialization_format});
+
+  // The same pacing the Player applies: each message is due at
+  // playback start plus its recorded offset from the first message.
+  bool first_message = true;
+  rcutils_time_point_value_t first_time_stamp = 0;
+  auto playback_start = std::chrono::steady_clock::now();
+  while (reader.has_next() && rclcpp::ok()) {
+    auto message = reader.read_next();
+    if (first_message) {
+      first_time_stamp = message->time_stamp;
+      playback_start = std::chrono::steady_clock::now();
+      first_message = false;
+    }
+    auto due = playback_start +
+      std::chrono::nanoseconds(message->time_stamp - first_time_stamp);
+    auto ready = std::chrono::steady_clock::now();
+    if (ready > due) {
+      // The reader handed the message out after its publish deadline -
+      // a real player would have starved here.
+      ++starvation_events_;
+      lateness_.record(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(ready - due));
+    } else {
+      earliness_.record(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(due - ready));
+      std::this_thread::sleep_until(due);
+    }
+    total_bytes_played_ += message->serialized_data->buffer_length;
+    ++total_messages_played_;
+  }
+  playback_duration_seconds_ = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - playback_start).count();
+}
+
+void PlaybackBenchmark::write_results() const
+{
+  double throughput_mbs = playback_duration_seconds_ > 0.0 ?
+    static_cast<double>(total_bytes_played_) / playback_duration_seconds_ / (1024.0 * 1024.0) :
+    0.0;
+
+  RCLCPP_INFO(get_logger(), "\nPlaybackBenchmark terminating");
+  RCLCPP_INFO_STREAM(get_logger(), "Messages played: " << total_messages_played_);
+  RCLCPP_INFO_STREAM(get_logger(), "Queue starvation events: " << starvation_events_);
+  RCLCPP_INFO_STREAM(
+    get_logger(), "Publish lateness percentiles in microseconds (p50/p95/p99/max): " <<
+      lateness_.percentile(0.50) / 1000 << "/" <<
+      lateness_.percentile(0.95) / 1000 << "/" <<
+      lateness_.percentile(0.99) / 1000 << "/" <<
+      lateness_.max() / 1000);
+  RCLCPP_INFO_STREAM(
+    get_logger(), "Median slack before deadline in microseconds: " <<
+      earliness_.percentile(0.50) / 1000);
+  RCLCPP_INFO_STREAM(get_logger(), "End-to-end throughput in MiB/s: " << throughput_mbs);
+
+  bool new_file = false;
+  { // test if file exists - we want to write a csv header after creation if not
+    std::ifstream test_existence(results_file_);
+    if (!test_existence) {
+      new_file = true;
+    }
+  }
+
+  // append, we want to accumulate results from multiple runs
+  std::ofstream output_file(results_file_, std::ios_base::app);
+  if (!output_file.is_open()) {
+    RCLCPP_ERROR_STREAM(get_logger(), "Could not open file " << results_file_);
+    return;
+  }
+
+  if (new_file) {
+    output_file << "instances frequency message_size messages_played starvation_events ";
+    output_file << "lateness_p50_ns lateness_p95_ns lateness_p99_ns lateness_max_ns ";
+    output_file << "throughput_mbs\n";
+  }
+
+  output_file << instances_ << " ";
+  output_file << frequency_ << " ";
+  output_file << message_size_ << " ";
+  output_file << total_messages_played_ << " ";
+  output_file << starvation_events_ << " ";
+  output_file << lateness_.percentile(0.50) << " ";
+  output_file << lateness_.percentile(0.95) << " ";
+  output_file << lateness_.percentile(0.99) << " ";
+  output_file << lateness_.max() << " ";
+  output_file << throughput_mbs << std::endl;
+}
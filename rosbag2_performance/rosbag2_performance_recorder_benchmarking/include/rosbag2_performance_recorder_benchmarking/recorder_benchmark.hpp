@@ -0,0 +1,61 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_PERFORMANCE_RECORDER_BENCHMARKING__RECORDER_BENCHMARK_HPP_
+#define ROSBAG2_PERFORMANCE_RECORDER_BENCHMARKING__RECORDER_BENCHMARK_HPP_
+
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "std_msgs/msg/byte_multi_array.hpp"
+
+/// Publishes a configurable offered load against a live recorder, then
+/// audits the produced bag against the sent sequence numbers. The drop rate
+/// vs. offered load gives the recorder's actual capacity curve, per storage
+/// configuration.
+///
+/// Every published message carries its sequence number in the first eight
+/// payload bytes, so the audit distinguishes real losses from duplicates
+/// instead of just comparing counts.
+class RecorderBenchmark : public rclcpp::Node
+{
+public:
+  explicit RecorderBenchmark(const std::string & name);
+  void start_benchmark();
+
+private:
+  std::string topic_name(unsigned int instance) const;
+  void run_recording();
+  void publish_load();
+  void audit_bag();
+  void write_results() const;
+
+  unsigned int frequency_;
+  unsigned int max_count_;
+  unsigned int message_size_;
+  unsigned int instances_;
+  unsigned int max_cache_size_;
+  std::string db_folder_;
+  std::string results_file_;
+
+  std::vector<rclcpp::Publisher<std_msgs::msg::ByteMultiArray>::SharedPtr> publishers_;
+  // Audit tallies: sequence numbers sent per topic, and what the bag holds.
+  std::vector<uint64_t> sent_counts_;
+  std::vector<uint64_t> recorded_counts_;
+  uint64_t duplicate_messages_{0};
+  double publish_duration_seconds_{0.0};
+};
+
+#endif  // ROSBAG2_PERFORMANCE_RECORDER_BENCHMARKING__RECORDER_BENCHMARK_HPP_
@@ -0,0 +1,254 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/serialization.hpp"
+#include "rmw/rmw.h"
+#include "rosbag2_cpp/readers/sequential_reader.hpp"
+#include "rosbag2_cpp/storage_options.hpp"
+#include "rosbag2_transport/record_options.hpp"
+#include "rosbag2_transport/rosbag2_transport.hpp"
+
+#include "rosbag2_performance_recorder_benchmarking/recorder_benchmark.hpp"
+
+using namespace std::chrono_literals;
+
+RecorderBenchmark::RecorderBenchmark(const std::string & name)
+: rclcpp::Node(name)
+{
+  const std::string default_bag_folder("/tmp/rosbag2_recorder_test");
+  this->declare_parameter("frequency", 100);
+  this->declare_parameter("max_count", 1000);
+  this->declare_parameter("size", 1000000);
+  this->declare_parameter("instances", 1);
+  this->declare_parameter("max_cache_size", 10000000);
+  this->declare_parameter("db_folder", default_bag_folder);
+  this->declare_parameter("results_file", default_bag_folder + "/results.csv");
+
+  this->get_parameter("frequency", frequency_);
+  if (frequency_ == 0) {
+    RCLCPP_ERROR(this->get_logger(), "Frequency can't be 0. Exiting.");
+    rclcpp::shutdown(nullptr, "frequency error");
+    return;
+  }
+
+  this->get_parameter("max_count", max_count_);
+  this->get_parameter("size", message_size_);
+  this->get_parameter("instances", instances_);
+  this->get_parameter("max_cache_size", max_cache_size_);
+  this->get_parameter("db_folder", db_folder_);
+  this->get_parameter("results_file", results_file_);
+}
+
+void RecorderBenchmark::start_benchmark()
+{
+  run_recording();
+  audit_bag();
+  write_results();
+}
+
+std::string RecorderBenchmark::topic_name(unsigned int instance) const
+{
+  return std::string("/recorder_benchmark/topic_") + std::to_string(instance);
+}
+
+void RecorderBenchmark::run_recording()
+{
+  sent_counts_.assign(instances_, 0);
+  recorded_counts_.assign(instances_, 0);
+
+  // The recorder subscribes to topics it discovers, so publishers must
+  // exist before record() is called.
+  for (unsigned int i = 0; i < instances_; ++i) {
+    publishers_.push_back(
+      create_publisher<std_msgs::msg::ByteMultiArray>(
+        topic_name(i), rclcpp::QoS(rclcpp::KeepLast(10)).reliable()));
+  }
+
+  std::thread recorder_thread(
+    [this]() {
+      rosbag2_transport::StorageOptions storage_options{};
+      storage_options.uri = db_folder_;
+      storage_options.storage_id = "sqlite3";
+      storage_options.max_cache_size = max_cache_size_;
+
+      rosbag2_transport::RecordOptions record_options{};
+      record_options.all = false;
+      record_options.is_discovery_disabled = false;
+      for (unsigned int i = 0; i < instances_; ++i) {
+        record_options.topics.push_back(topic_name(i));
+      }
+      record_options.rmw_serialization_format = rmw_get_serialization_format();
+      record_options.topic_polling_interval = 100ms;
+      record_options.node_prefix = "recorder_benchmark";
+
+      // Blocks until rclcpp::shutdown(); the bag is sealed when the
+      // transport (and its writer) go out of scope.
+      rosbag2_transport::Rosbag2Transport transport;
+      transport.record(storage_options, record_options);
+    });
+
+  // Wait until the recorder's subscriptions match, otherwise the first
+  // messages are lost to discovery rather than to the recorder.
+  auto discovery_deadline = std::chrono::steady_clock::now() + 10s;
+  for (const auto & publisher : publishers_) {
+    while (publisher->get_subscription_count() == 0 &&
+      std::chrono::steady_clock::now() < discovery_deadline)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+  }
+
+  publish_load();
+
+  // Leave the staging queue and write cache time to drain before tearing
+  // the recorder down, so the audit measures steady-state drops only.
+  std::this_thread::sleep_for(2s);
+  rclcpp::shutdown(nullptr, "recording finished");
+  recorder_thread.join();
+}
+
+void RecorderBenchmark::publish_load()
+{
+  auto start = std::chrono::steady_clock::now();
+
+  // One thread per topic, each pacing its own fixed-rate loop, mirroring
+  // independent sensor drivers offering load concurrently.
+  std::vector<std::thread> producers;
+  for (unsigned int i = 0; i < instances_; ++i) {
+    producers.emplace_back(
+      [this, i]() {
+        std_msgs::msg::ByteMultiArray message;
+        message.data.resize(message_size_);
+        rclcpp::WallRate rate(static_cast<double>(frequency_));
+        for (uint64_t sequence = 0; rclcpp::ok() && sequence < max_count_; ++sequence) {
+          std::memcpy(message.data.data(), &sequence, sizeof(sequence));
+          publishers_[i]->publish(message);
+          ++sent_counts_[i];
+          rate.sleep();
+        }
+      });
+  }
+  for (auto & producer : producers) {
+    producer.join();
+  }
+
+  publish_duration_seconds_ = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+void RecorderBenchmark::audit_bag()
+{
+  rosbag2_cpp::readers::SequentialReader reader;
+  rosbag2_cpp::StorageOptions storage_options{};
+  storage_options.uri = db_folder_;
+  storage_options.storage_id = "sqlite3";
+  reader.open(storage_options, {"", rmw_get_serialization_format()});
+
+  rclcpp::Serialization<std_msgs::msg::ByteMultiArray> serialization;
+  std::vector<std::set<uint64_t>> seen_sequences(instances_);
+
+  while (reader.has_next()) {
+    auto bag_message = reader.read_next();
+
+    const std::string prefix("/recorder_benchmark/topic_");
+    if (bag_message->topic_name.compare(0, prefix.size(), prefix) != 0) {
+      continue;
+    }
+    auto instance = static_cast<unsigned int>(
+      std::stoul(bag_message->topic_name.substr(prefix.size())));
+    if (instance >= instances_) {
+      continue;
+    }
+
+    std_msgs::msg::ByteMultiArray message;
+    rclcpp::SerializedMessage serialized_message(*bag_message->serialized_data);
+    serialization.deserialize_message(&serialized_message, &message);
+
+    uint64_t sequence = 0;
+    std::memcpy(&sequence, message.data.data(), sizeof(sequence));
+    if (!seen_sequences[instance].insert(sequence).second) {
+      ++duplicate_messages_;
+      continue;
+    }
+    ++recorded_counts_[instance];
+  }
+}
+
+void RecorderBenchmark::write_results() const
+{
+  uint64_t total_sent = 0;
+  uint64_t total_recorded = 0;
+  for (unsigned int i = 0; i < instances_; ++i) {
+    total_sent += sent_counts_[i];
+    total_recorded += recorded_counts_[i];
+  }
+
+  double drop_percent = total_sent > 0 ?
+    100.0 - static_cast<double>(total_recorded) / total_sent * 100.0 : 0.0;
+  double offered_mbs = publish_duration_seconds_ > 0.0 ?
+    static_cast<double>(total_sent) * message_size_ /
+    publish_duration_seconds_ / (1024.0 * 1024.0) : 0.0;
+
+  RCLCPP_INFO(get_logger(), "\nRecorderBenchmark terminating");
+  RCLCPP_INFO_STREAM(get_logger(), "Offered load in MiB/s: " << offered_mbs);
+  RCLCPP_INFO_STREAM(
+    get_logger(), "Messages sent: " << total_sent << ", recorded: " << total_recorded <<
+      ", duplicates: " << duplicate_messages_);
+  RCLCPP_INFO_STREAM(get_logger(), "Drop rate: " << drop_percent << "%");
+  for (unsigned int i = 0; i < instances_; ++i) {
+    RCLCPP_INFO_STREAM(
+      get_logger(), topic_name(i) << ": " << recorded_counts_[i] <<
+        "/" << sent_counts_[i] << " recorded");
+  }
+
+  bool new_file = false;
+  { // test if file exists - we want to write a csv header after creation if not
+    std::ifstream test_existence(results_file_);
+    if (!test_existence) {
+      new_file = true;
+    }
+  }
+
+  // append, we want to accumulate results from multiple runs
+  std::ofstream output_file(results_file_, std::ios_base::app);
+  if (!output_file.is_open()) {
+    RCLCPP_ERROR_STREAM(get_logger(), "Could not open file " << results_file_);
+    return;
+  }
+
+  if (new_file) {
+    output_file << "instances frequency message_size cache_size ";
+    output_file << "messages_sent messages_recorded duplicates ";
+    output_file << "drop_percent offered_mbs\n";
+  }
+
+  output_file << instances_ << " ";
+  output_file << frequency_ << " ";
+  output_file << message_size_ << " ";
+  output_file << max_cache_size_ << " ";
+  output_file << total_sent << " ";
+  output_file << total_recorded << " ";
+  output_file << duplicate_messages_ << " ";
+  output_file << drop_percent << " ";
+  output_file << offered_mbs << std::endl;
+}
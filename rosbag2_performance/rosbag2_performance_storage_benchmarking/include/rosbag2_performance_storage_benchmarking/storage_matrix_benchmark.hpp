@@ -0,0 +1,67 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_PERFORMANCE_STORAGE_BENCHMARKING__STORAGE_MATRIX_BENCHMARK_HPP_
+#define ROSBAG2_PERFORMANCE_STORAGE_BENCHMARKING__STORAGE_MATRIX_BENCHMARK_HPP_
+
+#include <string>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rosbag2_storage/storage_factory.hpp"
+
+/// Runs an identical workload suite (message sizes x recording rates x batch
+/// modes) against every installed storage plugin through the common storage
+/// interface and emits a comparative report, so storage selection per
+/// deployment is driven by measured numbers instead of defaults.
+class StorageMatrixBenchmark : public rclcpp::Node
+{
+public:
+  explicit StorageMatrixBenchmark(const std::string & name);
+  void start_benchmark();
+
+private:
+  // One cell of the workload matrix run against one plugin.
+  struct CaseResult
+  {
+    std::string storage_id;
+    uint64_t message_size{0};
+    uint64_t frequency{0};
+    uint64_t batch_size{0};
+    uint64_t messages_written{0};
+    double write_throughput_mbs{0.0};
+    double read_throughput_mbs{0.0};
+    uint64_t bytes_on_disk{0};
+    bool succeeded{false};
+  };
+
+  CaseResult run_case(
+    const std::string & storage_id, uint64_t message_size,
+    uint64_t frequency, uint64_t batch_size, const std::string & case_folder);
+  void print_report() const;
+  void write_results() const;
+
+  unsigned int max_count_;
+  std::vector<int64_t> message_sizes_;
+  std::vector<int64_t> frequencies_;
+  std::vector<int64_t> batch_sizes_;
+  std::vector<std::string> storage_ids_;
+  std::string db_folder_;
+  std::string results_file_;
+
+  rosbag2_storage::StorageFactory factory_;
+  std::vector<CaseResult> results_;
+};
+
+#endif  // ROSBAG2_PERFORMANCE_STORAGE_BENCHMARKING__STORAGE_MATRIX_BENCHMARK_HPP_
@@ -0,0 +1,258 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rmw/rmw.h"
+#include "rosbag2_storage/ros_helper.hpp"
+#include "rosbag2_storage/serialized_bag_message.hpp"
+#include "rosbag2_storage/topic_metadata.hpp"
+
+#include "rosbag2_performance_storage_benchmarking/storage_matrix_benchmark.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+double throughput_mbs(uint64_t bytes, double seconds)
+{
+  return seconds > 0.0 ? static_cast<double>(bytes) / seconds / (1024.0 * 1024.0) : 0.0;
+}
+}  // namespace
+
+StorageMatrixBenchmark::StorageMatrixBenchmark(const std::string & name)
+: rclcpp::Node(name)
+{
+  const std::string default_bag_folder("/tmp/rosbag2_storage_matrix_test");
+  this->declare_parameter("max_count", 1000);
+  this->declare_parameter("message_sizes", std::vector<int64_t>{1000, 100000, 1000000});
+  this->declare_parameter("frequencies", std::vector<int64_t>{0, 100});
+  this->declare_parameter("batch_sizes", std::vector<int64_t>{1, 100});
+  this->declare_parameter("storage_ids", std::vector<std::string>());
+  this->declare_parameter("db_folder", default_bag_folder);
+  this->declare_parameter("results_file", default_bag_folder + "/results.csv");
+
+  this->get_parameter("max_count", max_count_);
+  this->get_parameter("message_sizes", message_sizes_);
+  this->get_parameter("frequencies", frequencies_);
+  this->get_parameter("batch_sizes", batch_sizes_);
+  this->get_parameter("storage_ids", storage_ids_);
+  this->get_parameter("db_folder", db_folder_);
+  this->get_parameter("results_file", results_file_);
+}
+
+void StorageMatrixBenchmark::start_benchmark()
+{
+  if (storage_ids_.empty()) {
+    // Enumerate whatever plugins are installed so new storage backends show
+    // up in the comparison without touching the benchmark.
+    storage_ids_ = factory_.get_declared_read_write_storage_ids();
+    std::sort(storage_ids_.begin(), storage_ids_.end());
+  }
+  if (storage_ids_.empty()) {
+    RCLCPP_ERROR(get_logger(), "No writable storage plugins are installed. Exiting.");
+    return;
+  }
+
+  RCLCPP_INFO_STREAM(
+    get_logger(), "\nStorageMatrixBenchmark: running " <<
+      message_sizes_.size() * frequencies_.size() * batch_sizes_.size() <<
+      " workload cases against " << storage_ids_.size() << " storage plugins");
+
+  // Every plugin sees the exact same case order, so page-cache and device
+  // warm-up effects hit them alike.
+  size_t case_index = 0;
+  for (const auto message_size : message_sizes_) {
+    for (const auto frequency : frequencies_) {
+      for (const auto batch_size : batch_sizes_) {
+        for (const auto & storage_id : storage_ids_) {
+          if (!rclcpp::ok()) {
+            return;
+          }
+          const auto case_folder = db_folder_ + "/" + storage_id +
+            "/case_" + std::to_string(case_index);
+          results_.push_back(
+            run_case(
+              storage_id, static_cast<uint64_t>(message_size),
+              static_cast<uint64_t>(frequency), static_cast<uint64_t>(batch_size),
+              case_folder));
+        }
+        ++case_index;
+      }
+    }
+  }
+
+  print_report();
+  write_results();
+}
+
+StorageMatrixBenchmark::CaseResult StorageMatrixBenchmark::run_case(
+  const std::string & storage_id, uint64_t message_size,
+  uint64_t frequency, uint64_t batch_size, const std::string & case_folder)
+{
+  CaseResult result;
+  result.storage_id = storage_id;
+  result.message_size = message_size;
+  result.frequency = frequency;
+  result.batch_size = batch_size;
+
+  RCLCPP_INFO_STREAM(
+    get_logger(), "StorageMatrixBenchmark: " << storage_id << ", " << message_size <<
+      " byte messages at " << frequency << " Hz, batches of " << batch_size);
+
+  rcpputils::fs::create_directories(rcpputils::fs::path(case_folder));
+  const auto uri = case_folder + "/bag";
+
+  auto writer = factory_.open_read_write(uri, storage_id);
+  if (!writer) {
+    RCLCPP_WARN_STREAM(
+      get_logger(), "Skipping storage id '" << storage_id << "': could not open for writing.");
+    return result;
+  }
+
+  std::string serialization_format = rmw_get_serialization_format();
+  rosbag2_storage::TopicMetadata topic;
+  topic.name = "/storage_matrix/topic";
+  topic.type = "std_msgs::msg::ByteMultiArray";
+  topic.serialization_format = serialization_format;
+  writer->create_topic(topic);
+
+  // One shared payload for all messages: the storage only reads it, and
+  // reusing it keeps allocator cost out of the storage measurement.
+  const std::string payload(message_size, '.');
+  const auto serialized_data =
+    rosbag2_storage::make_serialized_message(payload.c_str(), payload.size());
+
+  const auto period_ns = frequency > 0 ?
+    std::chrono::nanoseconds(1000000000 / frequency) : std::chrono::nanoseconds(0);
+  const auto write_start = std::chrono::steady_clock::now();
+  uint64_t written = 0;
+  while (written < max_count_) {
+    const auto count = std::min<uint64_t>(batch_size, max_count_ - written);
+    std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> batch;
+    batch.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+      auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+      message->serialized_data = serialized_data;
+      message->topic_name = topic.name;
+      message->time_stamp =
+        static_cast<rcutils_time_point_value_t>((written + i) * period_ns.count());
+      batch.push_back(message);
+    }
+    // Batch mode 1 exercises the per-message write path, larger batches the
+    // vector overload, since plugins may implement them differently (e.g.
+    // one transaction per call).
+    if (batch_size == 1) {
+      writer->write(batch.front());
+    } else {
+      writer->write(batch);
+    }
+    written += count;
+    if (period_ns.count() > 0) {
+      std::this_thread::sleep_until(write_start + (written / batch_size) * batch_size * period_ns);
+    }
+  }
+  const auto file_path = writer->get_relative_file_path();
+  writer.reset();  // Closing flushes; the final commit belongs in the timing.
+  const auto write_seconds = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - write_start).count();
+
+  result.messages_written = written;
+  result.write_throughput_mbs = throughput_mbs(written * message_size, write_seconds);
+  const auto bag_path = rcpputils::fs::path(file_path);
+  result.bytes_on_disk = bag_path.exists() ? bag_path.file_size() : 0u;
+
+  const auto read_start = std::chrono::steady_clock::now();
+  auto reader = factory_.open_read_only(file_path, storage_id);
+  if (!reader) {
+    RCLCPP_WARN_STREAM(
+      get_logger(), "Skipping storage id '" << storage_id << "': could not open for reading.");
+    return result;
+  }
+  uint64_t bytes_read = 0;
+  while (reader->has_next()) {
+    const auto message = reader->read_next();
+    bytes_read += message->serialized_data->buffer_length;
+  }
+  reader.reset();
+  const auto read_seconds = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - read_start).count();
+
+  result.read_throughput_mbs = throughput_mbs(bytes_read, read_seconds);
+  result.succeeded = true;
+  return result;
+}
+
+void StorageMatrixBenchmark::print_report() const
+{
+  RCLCPP_INFO(get_logger(), "\nStorageMatrixBenchmark report");
+  RCLCPP_INFO(
+    get_logger(),
+    "storage_id | size | frequency | batch | write MiB/s | read MiB/s | bytes on disk");
+  for (const auto & result : results_) {
+    if (!result.succeeded) {
+      RCLCPP_INFO_STREAM(
+        get_logger(), result.storage_id << " | " << result.message_size << " | " <<
+          result.frequency << " | " << result.batch_size << " | failed");
+      continue;
+    }
+    RCLCPP_INFO_STREAM(
+      get_logger(), result.storage_id << " | " << result.message_size << " | " <<
+        result.frequency << " | " << result.batch_size << " | " <<
+        result.write_throughput_mbs << " | " << result.read_throughput_mbs << " | " <<
+        result.bytes_on_disk);
+  }
+}
+
+void StorageMatrixBenchmark::write_results() const
+{
+  bool new_file = false;
+  { // test if file exists - we want to write a csv header after creation if not
+    std::ifstream test_existence(results_file_);
+    if (!test_existence) {
+      new_file = true;
+    }
+  }
+
+  // append, we want to accumulate results from multiple runs
+  std::ofstream output_file(results_file_, std::ios_base::app);
+  if (!output_file.is_open()) {
+    RCLCPP_ERROR_STREAM(get_logger(), "Could not open file " << results_file_);
+    return;
+  }
+
+  if (new_file) {
+    output_file << "storage_id message_size frequency batch_size messages_written ";
+    output_file << "write_throughput_mbs read_throughput_mbs bytes_on_disk succeeded\n";
+  }
+
+  for (const auto & result : results_) {
+    output_file << result.storage_id << " ";
+    output_file << result.message_size << " ";
+    output_file << result.frequency << " ";
+    output_file << result.batch_size << " ";
+    output_file << result.messages_written << " ";
+    output_file << result.write_throughput_mbs << " ";
+    output_file << result.read_throughput_mbs << " ";
+    output_file << result.bytes_on_disk << " ";
+    output_file << result.succeeded << std::endl;
+  }
+}
@@ -0,0 +1,49 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__ALLOCATION_TRACKER_HPP_
+#define ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__ALLOCATION_TRACKER_HPP_
+
+#include <array>
+#include <cstdint>
+
+/// Process-wide heap allocation counters, fed by operator new/delete
+/// interposition in src/allocation_tracker.cpp. Counting is opt-in: until
+/// enable() is called every allocation pays only a relaxed atomic load, so
+/// untracked runs are unaffected. Counters are cumulative and thread safe;
+/// diff two snapshots to get per-phase numbers.
+namespace allocation_tracker
+{
+
+constexpr int kSizeClassCount = 8;
+
+struct Snapshot
+{
+  uint64_t allocations;
+  uint64_t bytes;
+  std::array<uint64_t, kSizeClassCount> size_classes;
+};
+
+void enable();
+
+bool enabled();
+
+Snapshot sample();
+
+/// Human-readable upper bound of a size class, e.g. "<=1KiB".
+const char * size_class_label(int index);
+
+}  // namespace allocation_tracker
+
+#endif  // ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__ALLOCATION_TRACKER_HPP_
@@ -16,8 +16,10 @@
 #define ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__BYTE_PRODUCER_HPP_
 
 #include <chrono>
+#include <map>
 #include <memory>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "rclcpp/utilities.hpp"
@@ -25,6 +27,7 @@
 #include "std_msgs/msg/byte_multi_array.hpp"
 
 #include "rosbag2_performance_writer_benchmarking/message_queue.hpp"
+#include "rosbag2_performance_writer_benchmarking/workload_profile.hpp"
 
 struct ProducerConfig
 {
@@ -56,8 +59,29 @@ public:
     message_(generate_random_message(configuration_))
   {}
 
+  /// Replays a recorded schedule instead of producing a uniform load.
+  /// Messages for every distinct size in the schedule are generated up
+  /// front so the replay loop stays allocation free.
+  ByteProducer(std::vector<TraceMessage> schedule, std::shared_ptr<ByteMessageQueue> queue)
+  : configuration_{0, 0, 0},
+    queue_(queue),
+    sleep_time_(0),
+    schedule_(std::move(schedule))
+  {
+    for (const auto & entry : schedule_) {
+      auto & message = messages_by_size_[entry.size];
+      if (!message) {
+        message = generate_random_message({0, 0, entry.size});
+      }
+    }
+  }
+
   void run()
   {
+    if (!schedule_.empty()) {
+      replay_schedule();
+      return;
+    }
     for (auto i = 0u; i < configuration_.max_count; ++i) {
       if (!rclcpp::ok()) {
         break;
@@ -69,11 +93,29 @@ public:
   }
 
 private:
+  void replay_schedule()
+  {
+    // Offsets are relative to a common start, so per-message sleep_until
+    // preserves the recorded bursts instead of averaging them out.
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto & entry : schedule_) {
+      if (!rclcpp::ok()) {
+        break;
+      }
+      std::this_thread::sleep_until(start + std::chrono::milliseconds(entry.offset_ms));
+      queue_->push(messages_by_size_[entry.size]);
+    }
+    queue_->set_complete();
+  }
+
   ProducerConfig configuration_;
   std::shared_ptr<ByteMessageQueue> queue_;
   unsigned int sleep_time_;  // in milliseconds
   // for simplification, this pointer will be reused
   std::shared_ptr<std_msgs::msg::ByteMultiArray> message_;
+  // Only used when replaying a workload profile.
+  std::vector<TraceMessage> schedule_;
+  std::map<unsigned int, std::shared_ptr<std_msgs::msg::ByteMultiArray>> messages_by_size_;
 };
 
 #endif  // ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__BYTE_PRODUCER_HPP_
@@ -0,0 +1,114 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__LATENCY_HISTOGRAM_HPP_
+#define ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__LATENCY_HISTOGRAM_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/// HDR-style latency histogram with logarithmic buckets split into linear
+/// sub-buckets, so any recorded value is resolved with bounded relative error
+/// (about 1.6% with 6 precision bits) while the whole range of 64-bit
+/// nanosecond latencies fits in a few kilobytes of counters.
+/// Recording is O(1) and allocation free; not thread safe.
+class LatencyHistogram
+{
+public:
+  LatencyHistogram()
+  : counts_((64 - kPrecisionBits + 1) << kPrecisionBits, 0)
+  {
+  }
+
+  void record(std::chrono::nanoseconds latency)
+  {
+    uint64_t value = latency.count() < 0 ? 0u : static_cast<uint64_t>(latency.count());
+    counts_[index_for(value)]++;
+    total_count_++;
+    if (value > max_) {
+      max_ = value;
+    }
+  }
+
+  uint64_t count() const
+  {
+    return total_count_;
+  }
+
+  /// Largest recorded latency in nanoseconds, without bucket rounding.
+  uint64_t max() const
+  {
+    return max_;
+  }
+
+  /// Latency in nanoseconds below which `fraction` (0.0 to 1.0) of the
+  /// recorded values fall. Returns 0 when nothing was recorded.
+  uint64_t percentile(double fraction) const
+  {
+    if (total_count_ == 0) {
+      return 0;
+    }
+    auto target = static_cast<uint64_t>(fraction * static_cast<double>(total_count_));
+    if (target >= total_count_) {
+      return max_;
+    }
+    uint64_t cumulative = 0;
+    for (size_t index = 0; index < counts_.size(); ++index) {
+      cumulative += counts_[index];
+      if (cumulative > target) {
+        uint64_t value = value_for(index);
+        return value < max_ ? value : max_;
+      }
+    }
+    return max_;
+  }
+
+private:
+  // Number of significant bits kept per value; 6 gives 64 linear
+  // sub-buckets per power of two.
+  static constexpr int kPrecisionBits = 6;
+
+  static size_t index_for(uint64_t value)
+  {
+    if (value < (1ull << kPrecisionBits)) {
+      return static_cast<size_t>(value);
+    }
+    int bit = 0;
+    for (uint64_t v = value; v >>= 1;) {
+      ++bit;
+    }
+    int shift = bit - kPrecisionBits;
+    return static_cast<size_t>(
+      ((shift + 1) << kPrecisionBits) +
+      ((value >> shift) - (1ull << kPrecisionBits)));
+  }
+
+  /// Upper bound of the bucket at `index`, the inverse of index_for().
+  static uint64_t value_for(size_t index)
+  {
+    if (index < (1ull << kPrecisionBits)) {
+      return index;
+    }
+    uint64_t shift = (index >> kPrecisionBits) - 1;
+    uint64_t sub_bucket = (index & ((1ull << kPrecisionBits) - 1)) + (1ull << kPrecisionBits);
+    return ((sub_bucket + 1) << shift) - 1;
+  }
+
+  std::vector<uint64_t> counts_;
+  uint64_t total_count_{0};
+  uint64_t max_{0};
+};
+
+#endif  // ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__LATENCY_HISTOGRAM_HPP_
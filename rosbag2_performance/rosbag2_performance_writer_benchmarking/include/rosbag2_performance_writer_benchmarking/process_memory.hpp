@@ -0,0 +1,88 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__PROCESS_MEMORY_HPP_
+#define ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__PROCESS_MEMORY_HPP_
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+/// One sample of the process memory state, read from /proc. This is what a
+/// cgroup memory limit is charged against, so recording changes must be
+/// evaluated against these numbers and not only against throughput.
+struct ProcessMemorySample
+{
+  uint64_t rss_kib = 0;
+  uint64_t dirty_kib = 0;
+  // Fault counters are cumulative for the process; diff two samples to get
+  // the faults taken during a phase.
+  uint64_t minor_faults = 0;
+  uint64_t major_faults = 0;
+};
+
+/// Samples /proc/self; returns all zeros on platforms without procfs.
+/// Fields whose source file is unavailable (e.g. smaps_rollup on kernels
+/// older than 4.14) stay zero.
+inline ProcessMemorySample sample_process_memory()
+{
+  ProcessMemorySample sample;
+#ifdef __linux__
+  {  // statm: total program size and resident set size, in pages
+    std::ifstream statm("/proc/self/statm");
+    uint64_t total_pages = 0;
+    uint64_t resident_pages = 0;
+    if (statm >> total_pages >> resident_pages) {
+      sample.rss_kib = resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) / 1024;
+    }
+  }
+
+  {  // stat: the command name can contain spaces and parentheses, so parse
+     // from the last closing parenthesis; minflt and majflt are the 8th and
+     // 10th fields after it
+    std::ifstream stat_file("/proc/self/stat");
+    std::string line;
+    if (std::getline(stat_file, line)) {
+      const auto after_comm = line.rfind(')');
+      if (after_comm != std::string::npos) {
+        std::istringstream fields(line.substr(after_comm + 1));
+        std::string state;
+        uint64_t ppid, pgrp, session, tty_nr, tpgid, flags, cminflt;
+        fields >> state >> ppid >> pgrp >> session >> tty_nr >> tpgid >> flags >>
+          sample.minor_faults >> cminflt >> sample.major_faults;
+      }
+    }
+  }
+
+  {  // smaps_rollup: dirty private pages not yet written back
+    std::ifstream smaps("/proc/self/smaps_rollup");
+    std::string line;
+    while (std::getline(smaps, line)) {
+      if (line.compare(0, 14, "Private_Dirty:") == 0) {
+        std::istringstream fields(line.substr(14));
+        fields >> sample.dirty_kib;
+        break;
+      }
+    }
+  }
+#endif
+  return sample;
+}
+
+#endif  // ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__PROCESS_MEMORY_HPP_
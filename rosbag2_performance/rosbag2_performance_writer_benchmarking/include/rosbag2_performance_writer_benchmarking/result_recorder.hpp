@@ -0,0 +1,206 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__RESULT_RECORDER_HPP_
+#define ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__RESULT_RECORDER_HPP_
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+/// Machine-readable benchmark results. Every record is one JSON object per
+/// line (JSON lines), carrying the run configuration, all metrics, and enough
+/// environment information (timestamp, git describe, hostname, OS, CPU count)
+/// to archive runs and diff performance release over release. The record
+/// layout matches the result recorder in rosbag2_storage_evaluation so runs
+/// from both harnesses can land in the same archive.
+class ResultRecorder
+{
+public:
+  explicit ResultRecorder(const std::string & benchmark_name)
+  : benchmark_name_(benchmark_name),
+    timestamp_(current_timestamp()),
+    git_describe_(run_command("git describe --tags --always --dirty 2>/dev/null")),
+    hostname_(current_hostname()),
+    os_(current_os()),
+    cpu_count_(std::thread::hardware_concurrency())
+  {
+  }
+
+  void add_config(const std::string & key, const std::string & value)
+  {
+    config_.emplace_back(key, value);
+  }
+
+  void add_metric(const std::string & key, const std::string & value)
+  {
+    metrics_.emplace_back(key, value);
+  }
+
+  void add_metric(const std::string & key, double value)
+  {
+    std::ostringstream formatted;
+    formatted << value;
+    metrics_.emplace_back(key, formatted.str());
+  }
+
+  std::string to_json() const
+  {
+    std::ostringstream json;
+    json << "{";
+    json << "\"benchmark\": \"" << json_escape(benchmark_name_) << "\", ";
+    json << "\"timestamp\": \"" << timestamp_ << "\", ";
+    json << "\"git_describe\": \"" << json_escape(git_describe_) << "\", ";
+    json << "\"hardware\": {";
+    json << "\"hostname\": \"" << json_escape(hostname_) << "\", ";
+    json << "\"os\": \"" << json_escape(os_) << "\", ";
+    json << "\"cpu_count\": " << cpu_count_ << "}, ";
+    json << "\"config\": ";
+    write_object(json, config_);
+    json << ", \"metrics\": ";
+    write_object(json, metrics_);
+    json << "}";
+    return json.str();
+  }
+
+  void append_json_line(const std::string & file_name) const
+  {
+    std::ofstream file(file_name, std::ofstream::out | std::ofstream::app);
+    file << to_json() << std::endl;
+  }
+
+private:
+  static std::string json_escape(const std::string & value)
+  {
+    std::ostringstream escaped;
+    for (const char c : value) {
+      switch (c) {
+        case '"':
+          escaped << "\\\"";
+          break;
+        case '\\':
+          escaped << "\\\\";
+          break;
+        case '\n':
+          escaped << "\\n";
+          break;
+        case '\t':
+          escaped << "\\t";
+          break;
+        default:
+          escaped << c;
+      }
+    }
+    return escaped.str();
+  }
+
+  static std::string current_timestamp()
+  {
+    auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    char buffer[sizeof "1970-01-01T00:00:00Z"];
+    tm utc_time;
+#ifdef _WIN32
+    gmtime_s(&utc_time, &now);
+#else
+    gmtime_r(&now, &utc_time);
+#endif
+    std::strftime(buffer, sizeof buffer, "%Y-%m-%dT%H:%M:%SZ", &utc_time);
+    return buffer;
+  }
+
+  static std::string run_command(const std::string & command)
+  {
+#ifdef _WIN32
+    (void)command;
+    return "";
+#else
+    FILE * pipe = popen(command.c_str(), "r");
+    if (!pipe) {
+      return "";
+    }
+    char buffer[256];
+    std::string output;
+    while (fgets(buffer, sizeof buffer, pipe)) {
+      output += buffer;
+    }
+    pclose(pipe);
+    while (!output.empty() && (output.back() == '\n' || output.back() == '\r')) {
+      output.pop_back();
+    }
+    return output;
+#endif
+  }
+
+  static std::string current_hostname()
+  {
+#ifdef _WIN32
+    return "";
+#else
+    char buffer[256] = {0};
+    gethostname(buffer, sizeof buffer - 1);
+    return buffer;
+#endif
+  }
+
+  static std::string current_os()
+  {
+#ifdef _WIN32
+    return "Windows";
+#else
+    utsname name;
+    if (uname(&name) != 0) {
+      return "";
+    }
+    return std::string(name.sysname) + " " + name.release;
+#endif
+  }
+
+  static void write_object(
+    std::ostringstream & json,
+    const std::vector<std::pair<std::string, std::string>> & entries)
+  {
+    json << "{";
+    bool first = true;
+    for (const auto & entry : entries) {
+      if (!first) {
+        json << ", ";
+      }
+      json << "\"" << json_escape(entry.first) << "\": \"" << json_escape(entry.second) << "\"";
+      first = false;
+    }
+    json << "}";
+  }
+
+  std::string benchmark_name_;
+  std::string timestamp_;
+  std::string git_describe_;
+  std::string hostname_;
+  std::string os_;
+  unsigned int cpu_count_;
+  std::vector<std::pair<std::string, std::string>> config_;
+  std::vector<std::pair<std::string, std::string>> metrics_;
+};
+
+#endif  // ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__RESULT_RECORDER_HPP_
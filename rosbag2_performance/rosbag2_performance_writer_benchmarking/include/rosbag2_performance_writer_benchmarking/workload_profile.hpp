@@ -0,0 +1,86 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__WORKLOAD_PROFILE_HPP_
+#define ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__WORKLOAD_PROFILE_HPP_
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// One message occurrence in a replayed workload trace.
+struct TraceMessage
+{
+  uint64_t offset_ms;  // time since the start of the trace
+  unsigned int size;  // serialized size in bytes
+};
+
+struct TopicTrace
+{
+  std::string topic_name;
+  std::vector<TraceMessage> messages;
+};
+
+/// Loads a workload profile from a trace file with one message per line in
+/// "offset_ms topic size_bytes" format; empty lines and lines starting with
+/// '#' are skipped. Traces can be extracted from an existing bag with
+/// scripts/extract_trace.py, so the benchmark replays production topic, size
+/// and timing patterns (lidar packet trains, camera frame groups, TF storms)
+/// which a uniform synthetic load smooths away.
+inline std::vector<TopicTrace> load_workload_profile(const std::string & path)
+{
+  std::ifstream input(path);
+  if (!input) {
+    throw std::runtime_error("Could not open workload profile " + path);
+  }
+
+  std::map<std::string, TopicTrace> traces;
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(input, line)) {
+    ++line_number;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    uint64_t offset_ms;
+    std::string topic;
+    unsigned int size;
+    if (!(fields >> offset_ms >> topic >> size)) {
+      throw std::runtime_error(
+              "Malformed line " + std::to_string(line_number) +
+              " in workload profile " + path);
+    }
+    auto & trace = traces[topic];
+    trace.topic_name = topic;
+    trace.messages.push_back({offset_ms, size});
+  }
+  if (traces.empty()) {
+    throw std::runtime_error("Workload profile " + path + " contains no messages");
+  }
+
+  std::vector<TopicTrace> result;
+  result.reserve(traces.size());
+  for (auto & entry : traces) {
+    result.push_back(std::move(entry.second));
+  }
+  return result;
+}
+
+#endif  // ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__WORKLOAD_PROFILE_HPP_
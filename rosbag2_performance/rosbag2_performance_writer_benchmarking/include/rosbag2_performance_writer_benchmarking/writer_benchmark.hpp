@@ -15,6 +15,7 @@
 #ifndef ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__WRITER_BENCHMARK_HPP_
 #define ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__WRITER_BENCHMARK_HPP_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <thread>
@@ -23,8 +24,11 @@
 #include "rclcpp/rclcpp.hpp"
 #include "rosbag2_cpp/writers/sequential_writer.hpp"
 
+#include "rosbag2_performance_writer_benchmarking/allocation_tracker.hpp"
 #include "rosbag2_performance_writer_benchmarking/message_queue.hpp"
 #include "rosbag2_performance_writer_benchmarking/byte_producer.hpp"
+#include "rosbag2_performance_writer_benchmarking/latency_histogram.hpp"
+#include "rosbag2_performance_writer_benchmarking/process_memory.hpp"
 
 class WriterBenchmark : public rclcpp::Node
 {
@@ -34,6 +38,7 @@ public:
 
 private:
   void create_producers(const ProducerConfig & config);
+  void create_producers_from_profile(const std::string & path);
   void create_writer();
   void start_producers();
   void write_results(const unsigned int & total_missed) const;
@@ -41,12 +46,44 @@ private:
   ProducerConfig config_;
   unsigned int max_cache_size_;
   unsigned int instances_;
+  // Soak mode: run for this many minutes of wall clock instead of a fixed
+  // message burst, sampling a time series along the way. Zero keeps the
+  // original burst behavior.
+  unsigned int soak_minutes_;
+  unsigned int stall_threshold_ms_;
+  uint64_t max_bagfile_size_;
+  // Total across all producers; with a workload profile each producer has
+  // its own schedule length, so the count cannot be derived from the config.
+  uint64_t total_messages_sent_;
+  std::string compression_format_;
+  // When set, replays the topic/size/timing schedule from this trace file
+  // instead of producing a uniform synthetic load.
+  std::string profile_file_;
   std::string db_folder_;
   std::string results_file_;
   std::shared_ptr<rosbag2_cpp::writers::SequentialWriter> writer_;
   std::vector<std::thread> producer_threads_;
   std::vector<std::unique_ptr<ByteProducer>> producers_;
   std::vector<std::shared_ptr<ByteMessageQueue>> queues_;
+  // Tail behavior of individual writer_->write() calls; a call that triggers
+  // a cache flush or a bagfile split shows up as a stall in the high
+  // percentiles rather than disappearing into the throughput average.
+  LatencyHistogram write_latency_;
+  // Writes slower than the stall threshold, kept separately so a soak run
+  // reports how often the writer stalls and for how long, not just the
+  // overall latency percentiles which long quiet stretches would dilute.
+  LatencyHistogram stall_duration_;
+  // Heap allocation counters around the write loop, only meaningful when
+  // tracking was enabled via ROSBAG2_PROFILE_ALLOCATIONS.
+  allocation_tracker::Snapshot allocations_before_ {};
+  allocation_tracker::Snapshot allocations_after_ {};
+  // Memory envelope of the run: peaks over the once-per-second samples plus
+  // the samples bracketing the write loop for fault deltas. What kills the
+  // recorder in production is the cgroup memory limit, not throughput.
+  uint64_t peak_rss_kib_ = 0;
+  uint64_t peak_dirty_kib_ = 0;
+  ProcessMemorySample memory_before_;
+  ProcessMemorySample memory_after_;
 };
 
 #endif  // ROSBAG2_PERFORMANCE_WRITER_BENCHMARKING__WRITER_BENCHMARK_HPP_
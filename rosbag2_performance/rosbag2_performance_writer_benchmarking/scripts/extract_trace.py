@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+# Copyright 2020, Robotec.ai sp. z o.o.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Extract a workload profile from a recorded sqlite3 bagfile.
+
+Writes one line per message in "offset_ms topic size_bytes" format to
+stdout, for replay with the writer_benchmark profile_file parameter, so
+the benchmark reproduces the topic, size and timing patterns of a real
+recording instead of a uniform synthetic load.
+
+Usage: extract_trace.py <bagfile.db3> > trace.txt
+"""
+
+import sqlite3
+import sys
+
+
+def main():
+    if len(sys.argv) != 2:
+        print('Usage: extract_trace.py <bagfile.db3>', file=sys.stderr)
+        return 1
+
+    connection = sqlite3.connect(sys.argv[1])
+    topics = dict(connection.execute('SELECT id, name FROM topics'))
+    messages = connection.execute(
+        'SELECT timestamp, topic_id, length(data) FROM messages ORDER BY timestamp')
+
+    print('# offset_ms topic size_bytes')
+    start = None
+    for timestamp, topic_id, size in messages:
+        if start is None:
+            start = timestamp
+        # bag timestamps are in nanoseconds
+        print('{} {} {}'.format((timestamp - start) // 1000000, topics[topic_id], size))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,149 @@
+// Copyright 2020, Robotec.ai sp. z o.o.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_performance_writer_benchmarking/allocation_tracker.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+std::atomic<bool> tracking_enabled{false};
+std::atomic<uint64_t> total_allocations{0};
+std::atomic<uint64_t> total_bytes{0};
+std::atomic<uint64_t> size_class_counts[allocation_tracker::kSizeClassCount];
+
+// Classes grow by a factor of 4: <=64B, <=256B, <=1KiB, ... <=256KiB plus
+// an overflow class, enough to tell small control-block churn apart from
+// message payload buffers.
+int size_class_for(std::size_t size)
+{
+  std::size_t bound = 64;
+  for (int size_class = 0; size_class < allocation_tracker::kSizeClassCount - 1; ++size_class) {
+    if (size <= bound) {
+      return size_class;
+    }
+    bound <<= 2;
+  }
+  return allocation_tracker::kSizeClassCount - 1;
+}
+
+void count_allocation(std::size_t size) noexcept
+{
+  if (!tracking_enabled.load(std::memory_order_relaxed)) {
+    return;
+  }
+  total_allocations.fetch_add(1, std::memory_order_relaxed);
+  total_bytes.fetch_add(size, std::memory_order_relaxed);
+  size_class_counts[size_class_for(size)].fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+namespace allocation_tracker
+{
+
+void enable()
+{
+  tracking_enabled.store(true);
+}
+
+bool enabled()
+{
+  return tracking_enabled.load();
+}
+
+Snapshot sample()
+{
+  Snapshot snapshot;
+  snapshot.allocations = total_allocations.load(std::memory_order_relaxed);
+  snapshot.bytes = total_bytes.load(std::memory_order_relaxed);
+  for (int size_class = 0; size_class < kSizeClassCount; ++size_class) {
+    snapshot.size_classes[size_class] =
+      size_class_counts[size_class].load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+const char * size_class_label(int index)
+{
+  static const char * const labels[kSizeClassCount] = {
+    "<=64B", "<=256B", "<=1KiB", "<=4KiB", "<=16KiB", "<=64KiB", "<=256KiB", ">256KiB"
+  };
+  return labels[index];
+}
+
+}  // namespace allocation_tracker
+
+// Interposed global allocation functions. Linking this translation unit
+// into the benchmark replaces the standard library definitions for the
+// whole binary.
+
+void * operator new(std::size_t size)
+{
+  count_allocation(size);
+  if (void * pointer = std::malloc(size ? size : 1)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void * operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  count_allocation(size);
+  return std::malloc(size ? size : 1);
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t & tag) noexcept
+{
+  return operator new(size, tag);
+}
+
+void operator delete(void * pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete[](void * pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void * pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete[](void * pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void * pointer, const std::nothrow_t &) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete[](void * pointer, const std::nothrow_t &) noexcept
+{
+  std::free(pointer);
+}
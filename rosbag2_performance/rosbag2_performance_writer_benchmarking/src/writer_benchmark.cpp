@@ -12,16 +12,23 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <memory>
+#include <sstream>
 #include <string>
 
 #include "rmw/rmw.h"
+#include "rosbag2_compression/compression_options.hpp"
+#include "rosbag2_compression/sequential_compression_writer.hpp"
 #include "rosbag2_cpp/storage_options.hpp"
 #include "rosbag2_storage/serialized_bag_message.hpp"
 #include "std_msgs/msg/byte_multi_array.hpp"
 
+#include "rosbag2_performance_writer_benchmarking/result_recorder.hpp"
+#include "rosbag2_performance_writer_benchmarking/workload_profile.hpp"
 #include "rosbag2_performance_writer_benchmarking/writer_benchmark.hpp"
 
 using namespace std::chrono_literals;
@@ -35,6 +42,11 @@ WriterBenchmark::WriterBenchmark(const std::string & name)
   this->declare_parameter("size", 1000000);
   this->declare_parameter("instances", 1);
   this->declare_parameter("max_cache_size", 1);
+  this->declare_parameter("soak_minutes", 0);
+  this->declare_parameter("stall_threshold_ms", 10);
+  this->declare_parameter("max_bagfile_size", 0);
+  this->declare_parameter("compression_format", "");
+  this->declare_parameter("profile_file", "");
   this->declare_parameter("db_folder", default_bag_folder);
   this->declare_parameter("results_file", default_bag_folder + "/results.csv");
 
@@ -46,19 +58,63 @@ WriterBenchmark::WriterBenchmark(const std::string & name)
   }
 
   this->get_parameter("max_cache_size", max_cache_size_);
+  this->get_parameter("soak_minutes", soak_minutes_);
+  this->get_parameter("stall_threshold_ms", stall_threshold_ms_);
+  this->get_parameter("max_bagfile_size", max_bagfile_size_);
+  this->get_parameter("compression_format", compression_format_);
+  this->get_parameter("profile_file", profile_file_);
   this->get_parameter("db_folder", db_folder_);
   this->get_parameter("results_file", results_file_);
   this->get_parameter("max_count", config_.max_count);
   this->get_parameter("size", config_.message_size);
   this->get_parameter("instances", instances_);
 
-  create_producers(config_);
+  if (soak_minutes_ > 0) {
+    // Soak mode runs for wall-clock time. Producers pace themselves with the
+    // configured frequency, so the duration translates into a message count.
+    config_.max_count = soak_minutes_ * 60 * config_.frequency;
+  }
+
+  if (!profile_file_.empty()) {
+    create_producers_from_profile(profile_file_);
+  } else {
+    create_producers(config_);
+  }
   create_writer();
 }
 
 void WriterBenchmark::start_benchmark()
 {
   RCLCPP_INFO(get_logger(), "Starting. A dot is a write, an X is a miss");
+  const auto stall_threshold = std::chrono::milliseconds(stall_threshold_ms_);
+
+  // Opt-in: counting every heap allocation is cheap but not free.
+  if (std::getenv("ROSBAG2_PROFILE_ALLOCATIONS")) {
+    allocation_tracker::enable();
+  }
+
+  // In soak mode, stream a once-per-second time series next to the results
+  // file. Each row is flushed immediately so a crash hours into the run
+  // still leaves the series up to the failure on disk.
+  std::ofstream series_file;
+  if (soak_minutes_ > 0) {
+    const auto series_path = results_file_ + ".series.csv";
+    series_file.open(series_path);
+    if (series_file.is_open()) {
+      series_file << "elapsed_s writes_per_s max_write_ns cache_size messages_missed " <<
+        "rss_kib dirty_kib minor_faults major_faults\n";
+    } else {
+      RCLCPP_ERROR_STREAM(get_logger(), "Could not open time series file " << series_path);
+    }
+  }
+  const auto benchmark_start = std::chrono::steady_clock::now();
+  auto last_sample_time = benchmark_start;
+  uint64_t interval_writes = 0;
+  uint64_t interval_max_write_ns = 0;
+
+  allocations_before_ = allocation_tracker::sample();
+  memory_before_ = sample_process_memory();
+
   start_producers();
   while (rclcpp::ok()) {
     int count = 0;
@@ -95,7 +151,18 @@ void WriterBenchmark::start_benchmark()
         message->topic_name = queue->topic_name();
 
         try {
+          auto write_start = std::chrono::steady_clock::now();
           writer_->write(message);
+          auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - write_start);
+          write_latency_.record(latency);
+          if (latency >= stall_threshold) {
+            stall_duration_.record(latency);
+          }
+          ++interval_writes;
+          if (static_cast<uint64_t>(latency.count()) > interval_max_write_ns) {
+            interval_max_write_ns = static_cast<uint64_t>(latency.count());
+          }
         } catch (const std::runtime_error & e) {
           RCLCPP_ERROR_STREAM(get_logger(), "Failed to record: " << e.what());
         }
@@ -103,6 +170,32 @@ void WriterBenchmark::start_benchmark()
         ++count;
       }
     }
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_sample_time >= 1s) {
+      const auto memory = sample_process_memory();
+      peak_rss_kib_ = std::max(peak_rss_kib_, memory.rss_kib);
+      peak_dirty_kib_ = std::max(peak_dirty_kib_, memory.dirty_kib);
+      if (series_file.is_open()) {
+        unsigned int missed_so_far = 0;
+        for (const auto & queue : queues_) {
+          missed_so_far += queue->get_missed_elements_count();
+        }
+        series_file <<
+          std::chrono::duration_cast<std::chrono::seconds>(now - benchmark_start).count() << " " <<
+          interval_writes << " " <<
+          interval_max_write_ns << " " <<
+          writer_->get_cache_size() << " " <<
+          missed_so_far << " " <<
+          memory.rss_kib << " " <<
+          memory.dirty_kib << " " <<
+          memory.minor_faults << " " <<
+          memory.major_faults << std::endl;
+      }
+      interval_writes = 0;
+      interval_max_write_ns = 0;
+      last_sample_time = now;
+    }
+
     if (complete_count == queues_.size()) {
       break;
     }
@@ -113,6 +206,10 @@ void WriterBenchmark::start_benchmark()
   for (auto & prod_thread : producer_threads_) {
     prod_thread.join();
   }
+  allocations_after_ = allocation_tracker::sample();
+  memory_after_ = sample_process_memory();
+  peak_rss_kib_ = std::max(peak_rss_kib_, memory_after_.rss_kib);
+  peak_dirty_kib_ = std::max(peak_dirty_kib_, memory_after_.dirty_kib);
 
   unsigned int total_missed_messages = 0;
   for (const auto & queue : queues_) {
@@ -123,7 +220,7 @@ void WriterBenchmark::start_benchmark()
 
 void WriterBenchmark::write_results(const unsigned int & total_missed) const
 {
-  auto total_messages_sent = config_.max_count * producers_.size();
+  const auto total_messages_sent = total_messages_sent_;
   float percentage_recorded = 100.0f - static_cast<float>(total_missed * 100.0f) /
     total_messages_sent;
 
@@ -132,6 +229,45 @@ void WriterBenchmark::write_results(const unsigned int & total_missed) const
   RCLCPP_INFO_STREAM(
     get_logger(), "Percentage of all message that was successfully recorded: " <<
       percentage_recorded);
+  RCLCPP_INFO_STREAM(
+    get_logger(), "Write latency percentiles in microseconds (p50/p95/p99/p999): " <<
+      write_latency_.percentile(0.50) / 1000 << "/" <<
+      write_latency_.percentile(0.95) / 1000 << "/" <<
+      write_latency_.percentile(0.99) / 1000 << "/" <<
+      write_latency_.percentile(0.999) / 1000);
+  RCLCPP_INFO_STREAM(
+    get_logger(), "Max write stall in microseconds: " << write_latency_.max() / 1000);
+  RCLCPP_INFO_STREAM(
+    get_logger(), "Writes stalled longer than " << stall_threshold_ms_ << " ms: " <<
+      stall_duration_.count() << ", stall duration p50/p99/max in microseconds: " <<
+      stall_duration_.percentile(0.50) / 1000 << "/" <<
+      stall_duration_.percentile(0.99) / 1000 << "/" <<
+      stall_duration_.max() / 1000);
+
+  const uint64_t minor_faults = memory_after_.minor_faults - memory_before_.minor_faults;
+  const uint64_t major_faults = memory_after_.major_faults - memory_before_.major_faults;
+  RCLCPP_INFO_STREAM(
+    get_logger(), "Peak RSS: " << peak_rss_kib_ << " KiB, peak dirty: " <<
+      peak_dirty_kib_ << " KiB, page faults during the run (minor/major): " <<
+      minor_faults << "/" << major_faults);
+
+  const uint64_t allocations = allocations_after_.allocations - allocations_before_.allocations;
+  const uint64_t allocated_bytes = allocations_after_.bytes - allocations_before_.bytes;
+  const double allocations_per_message = write_latency_.count() ?
+    static_cast<double>(allocations) / write_latency_.count() : 0.0;
+  if (allocation_tracker::enabled()) {
+    std::ostringstream size_classes;
+    for (int size_class = 0; size_class < allocation_tracker::kSizeClassCount; ++size_class) {
+      size_classes << allocation_tracker::size_class_label(size_class) << ": " <<
+        allocations_after_.size_classes[size_class] -
+        allocations_before_.size_classes[size_class] << " ";
+    }
+    RCLCPP_INFO_STREAM(
+      get_logger(), "Heap allocations during the write loop: " << allocations <<
+        " (" << allocated_bytes << " bytes), " <<
+        allocations_per_message << " per written message");
+    RCLCPP_INFO_STREAM(get_logger(), "Allocation size classes: " << size_classes.str());
+  }
 
   bool new_file = false;
   { // test if file exists - we want to write a csv header after creation if not
@@ -149,9 +285,15 @@ void WriterBenchmark::write_results(const unsigned int & total_missed) const
     return;
   }
 
+  const std::string compression = compression_format_.empty() ? "none" : compression_format_;
+
   if (new_file) {
-    output_file << "instances frequency message_size cache_size total_messages_sent ";
-    output_file << "total_messages_missed percentage_recorded\n";
+    output_file << "instances frequency message_size cache_size ";
+    output_file << "soak_minutes max_bagfile_size compression_format total_messages_sent ";
+    output_file << "total_messages_missed percentage_recorded ";
+    output_file << "write_p50_ns write_p95_ns write_p99_ns write_p999_ns write_max_ns ";
+    output_file << "stall_count stall_p50_ns stall_p99_ns stall_max_ns ";
+    output_file << "peak_rss_kib peak_dirty_kib minor_faults major_faults\n";
   }
 
   // configuration of the test. TODO(adamdbrw) wrap into a dict and define << operator.
@@ -159,11 +301,70 @@ void WriterBenchmark::write_results(const unsigned int & total_missed) const
   output_file << config_.frequency << " ";
   output_file << config_.message_size << " ";
   output_file << max_cache_size_ << " ";
+  output_file << soak_minutes_ << " ";
+  output_file << max_bagfile_size_ << " ";
+  output_file << compression << " ";
   output_file << total_messages_sent << " ";
 
   // results of the test. Use std::setprecision if preferred
   output_file << total_missed << " ";
-  output_file << percentage_recorded << std::endl;
+  output_file << percentage_recorded << " ";
+  output_file << write_latency_.percentile(0.50) << " ";
+  output_file << write_latency_.percentile(0.95) << " ";
+  output_file << write_latency_.percentile(0.99) << " ";
+  output_file << write_latency_.percentile(0.999) << " ";
+  output_file << write_latency_.max() << " ";
+  output_file << stall_duration_.count() << " ";
+  output_file << stall_duration_.percentile(0.50) << " ";
+  output_file << stall_duration_.percentile(0.99) << " ";
+  output_file << stall_duration_.max() << " ";
+  output_file << peak_rss_kib_ << " ";
+  output_file << peak_dirty_kib_ << " ";
+  output_file << minor_faults << " ";
+  output_file << major_faults << std::endl;
+
+  // Same results again as one machine-readable JSON line per run, with
+  // git describe and hardware info, for archiving and release-over-release
+  // comparisons.
+  ResultRecorder recorder("writer_benchmark");
+  recorder.add_config("instances", std::to_string(instances_));
+  recorder.add_config("frequency", std::to_string(config_.frequency));
+  recorder.add_config("message_size", std::to_string(config_.message_size));
+  recorder.add_config("cache_size", std::to_string(max_cache_size_));
+  recorder.add_config("soak_minutes", std::to_string(soak_minutes_));
+  recorder.add_config("max_bagfile_size", std::to_string(max_bagfile_size_));
+  recorder.add_config("compression_format", compression);
+  recorder.add_config("stall_threshold_ms", std::to_string(stall_threshold_ms_));
+  recorder.add_config("profile_file", profile_file_.empty() ? "none" : profile_file_);
+  recorder.add_metric("total_messages_sent", std::to_string(total_messages_sent));
+  recorder.add_metric("total_messages_missed", std::to_string(total_missed));
+  recorder.add_metric("percentage_recorded", percentage_recorded);
+  recorder.add_metric("write_p50_ns", std::to_string(write_latency_.percentile(0.50)));
+  recorder.add_metric("write_p95_ns", std::to_string(write_latency_.percentile(0.95)));
+  recorder.add_metric("write_p99_ns", std::to_string(write_latency_.percentile(0.99)));
+  recorder.add_metric("write_p999_ns", std::to_string(write_latency_.percentile(0.999)));
+  recorder.add_metric("write_max_ns", std::to_string(write_latency_.max()));
+  recorder.add_metric("stall_count", std::to_string(stall_duration_.count()));
+  recorder.add_metric("stall_p50_ns", std::to_string(stall_duration_.percentile(0.50)));
+  recorder.add_metric("stall_p99_ns", std::to_string(stall_duration_.percentile(0.99)));
+  recorder.add_metric("stall_max_ns", std::to_string(stall_duration_.max()));
+  recorder.add_metric("peak_rss_kib", std::to_string(peak_rss_kib_));
+  recorder.add_metric("peak_dirty_kib", std::to_string(peak_dirty_kib_));
+  recorder.add_metric("minor_faults", std::to_string(minor_faults));
+  recorder.add_metric("major_faults", std::to_string(major_faults));
+  if (allocation_tracker::enabled()) {
+    recorder.add_metric("allocations", std::to_string(allocations));
+    recorder.add_metric("allocated_bytes", std::to_string(allocated_bytes));
+    recorder.add_metric("allocations_per_message", allocations_per_message);
+    for (int size_class = 0; size_class < allocation_tracker::kSizeClassCount; ++size_class) {
+      recorder.add_metric(
+        std::string("allocations_") + allocation_tracker::size_class_label(size_class),
+        std::to_string(
+          allocations_after_.size_classes[size_class] -
+          allocations_before_.size_classes[size_class]));
+    }
+  }
+  recorder.append_json_line(results_file_ + ".jsonl");
 }
 
 void WriterBenchmark::create_producers(const ProducerConfig & config)
@@ -181,17 +382,42 @@ void WriterBenchmark::create_producers(const ProducerConfig & config)
     queues_.push_back(queue);
     producers_.push_back(std::make_unique<ByteProducer>(config, queue));
   }
+  total_messages_sent_ = static_cast<uint64_t>(config.max_count) * instances_;
+}
+
+void WriterBenchmark::create_producers_from_profile(const std::string & path)
+{
+  auto profile = load_workload_profile(path);
+  total_messages_sent_ = 0;
+  RCLCPP_INFO_STREAM(
+    get_logger(), "\nWriterBenchmark: replaying workload profile " << path <<
+      " with " << profile.size() << " topics. Cache is " << max_cache_size_);
+  const unsigned int queue_max_size = 10;
+  for (auto & topic_trace : profile) {
+    auto queue = std::make_shared<ByteMessageQueue>(queue_max_size, topic_trace.topic_name);
+    queues_.push_back(queue);
+    total_messages_sent_ += topic_trace.messages.size();
+    producers_.push_back(
+      std::make_unique<ByteProducer>(std::move(topic_trace.messages), queue));
+  }
 }
 
 // TODO(adamdbrw) extend to other writers - based on parametrization
-// Also, add an option to configure compression
 void WriterBenchmark::create_writer()
 {
-  writer_ = std::make_shared<rosbag2_cpp::writers::SequentialWriter>();
+  if (compression_format_.empty()) {
+    writer_ = std::make_shared<rosbag2_cpp::writers::SequentialWriter>();
+  } else {
+    rosbag2_compression::CompressionOptions compression_options{};
+    compression_options.compression_format = compression_format_;
+    compression_options.compression_mode = rosbag2_compression::CompressionMode::FILE;
+    writer_ = std::make_shared<rosbag2_compression::SequentialCompressionWriter>(
+      compression_options);
+  }
   rosbag2_cpp::StorageOptions storage_options{};
   storage_options.uri = db_folder_;
   storage_options.storage_id = "sqlite3";
-  storage_options.max_bagfile_size = 0;
+  storage_options.max_bagfile_size = max_bagfile_size_;
   storage_options.max_cache_size = max_cache_size_;
 
   // TODO(adamdbrw) generalize if converters are to be included in benchmarks
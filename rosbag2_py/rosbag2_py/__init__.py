@@ -18,25 +18,38 @@ from rpyutils import add_dll_directories_from_env
 # to the search path.
 # See https://docs.python.org/3/whatsnew/3.8.html#bpo-36085-whatsnew
 with add_dll_directories_from_env('PATH'):
+    from rosbag2_py._info import \
+        Info
     from rosbag2_py._reader import \
         SequentialCompressionReader, \
         SequentialReader
     from rosbag2_py._storage import \
+        BagMetadata, \
         ConverterOptions, \
+        FileInformation, \
         StorageFilter, \
         StorageOptions, \
+        TopicInformation, \
         TopicMetadata
     from rosbag2_py._writer import \
+        CompressionMode, \
+        CompressionOptions, \
         SequentialCompressionWriter, \
         SequentialWriter
 
 __all__ = [
+    'BagMetadata',
+    'CompressionMode',
+    'CompressionOptions',
     'ConverterOptions',
+    'FileInformation',
+    'Info',
     'SequentialCompressionReader',
     'SequentialCompressionWriter',
     'SequentialReader',
     'SequentialWriter',
     'StorageFilter',
     'StorageOptions',
+    'TopicInformation',
     'TopicMetadata',
 ]
@@ -0,0 +1,81 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rosbag2_cpp/info.hpp"
+#include "rosbag2_storage/bag_metadata.hpp"
+#include "rosbag2_storage/topic_statistics.hpp"
+
+#include "./pybind11.hpp"
+
+namespace rosbag2_py
+{
+
+class Info
+{
+public:
+  Info()
+  : info_(std::make_unique<rosbag2_cpp::Info>())
+  {
+  }
+
+  /// Read the metadata of the bag at `uri`. Reads metadata.yaml when it
+  /// exists, otherwise falls back to opening the storage identified by
+  /// `storage_id` and querying it directly.
+  rosbag2_storage::BagMetadata read_metadata(
+    const std::string & uri, const std::string & storage_id)
+  {
+    return info_->read_metadata(uri, storage_id);
+  }
+
+  /// Per-topic message count, byte sum and time span, aggregated inside
+  /// the storage plugin (and across the splits of a multi-file bag), so
+  /// average rate and bandwidth need no client-side scan of the messages.
+  std::vector<rosbag2_storage::TopicStatistics> read_topic_statistics(
+    const std::string & uri, const std::string & storage_id)
+  {
+    return info_->read_topic_statistics(uri, storage_id);
+  }
+
+protected:
+  std::unique_ptr<rosbag2_cpp::Info> info_;
+};
+
+}  // namespace rosbag2_py
+
+PYBIND11_MODULE(_info, m) {
+  m.doc() = "Python wrapper of the rosbag2_cpp info API";
+
+  pybind11::class_<rosbag2_storage::TopicStatistics>(m, "TopicStatistics")
+  .def(pybind11::init())
+  .def_readwrite("topic_name", &rosbag2_storage::TopicStatistics::topic_name)
+  .def_readwrite("message_count", &rosbag2_storage::TopicStatistics::message_count)
+  .def_readwrite("byte_count", &rosbag2_storage::TopicStatistics::byte_count)
+  .def_readwrite(
+    "first_timestamp_ns", &rosbag2_storage::TopicStatistics::first_timestamp_ns)
+  .def_readwrite(
+    "last_timestamp_ns", &rosbag2_storage::TopicStatistics::last_timestamp_ns);
+
+  pybind11::class_<rosbag2_py::Info>(m, "Info")
+  .def(pybind11::init())
+  .def(
+    "read_metadata", &rosbag2_py::Info::read_metadata,
+    pybind11::arg("uri"), pybind11::arg("storage_id"))
+  .def(
+    "read_topic_statistics", &rosbag2_py::Info::read_topic_statistics,
+    pybind11::arg("uri"), pybind11::arg("storage_id"));
+}
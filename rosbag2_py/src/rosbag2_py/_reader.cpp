@@ -12,10 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include <pybind11/numpy.h>
+
 #include "rosbag2_compression/sequential_compression_reader.hpp"
 #include "rosbag2_cpp/converter_options.hpp"
 #include "rosbag2_cpp/readers/sequential_reader.hpp"
@@ -38,6 +45,11 @@ public:
   {
   }
 
+  ~Reader()
+  {
+    stop_prefetch();
+  }
+
   void open(
     rosbag2_cpp::StorageOptions & storage_options,
     rosbag2_cpp::ConverterOptions & converter_options)
@@ -62,6 +74,121 @@ public:
       next->topic_name, pybind11::bytes(serialized_data), next->time_stamp);
   }
 
+  /// Read up to `count` messages in one call and return a list of
+  /// (topic name, payload, timestamp) tuples. The storage I/O runs with the
+  /// GIL released, and each payload is a buffer-protocol view into the C++
+  /// message buffer (kept alive by the payload object itself), so consumers
+  /// like NumPy or Arrow can use the bytes without copying them.
+  pybind11::list read_batch(size_t count)
+  {
+    std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages;
+    {
+      pybind11::gil_scoped_release release;
+      messages = reader_->read_next_batch(count);
+    }
+    return batch_to_python(messages);
+  }
+
+  /// Start the background thread which keeps up to `max_queued_batches`
+  /// batches of `batch_size` messages prefetched while Python processes the
+  /// previous one. While prefetching is active the reader must only be
+  /// consumed by iterating it; mixing in read_next()/read_batch() calls
+  /// races with the prefetch thread.
+  void start_prefetch(size_t batch_size, size_t max_queued_batches)
+  {
+    if (prefetch_thread_.joinable()) {
+      return;
+    }
+    stop_prefetch_requested_ = false;
+    prefetch_done_ = false;
+    prefetch_error_ = nullptr;
+    prefetch_thread_ = std::thread(
+      [this, batch_size, max_queued_batches]() {
+        while (true) {
+          {
+            std::unique_lock<std::mutex> lock(prefetch_mutex_);
+            prefetch_space_condition_.wait(
+              lock,
+              [this, max_queued_batches] {
+                return stop_prefetch_requested_ ||
+                       prefetched_batches_.size() < max_queued_batches;
+              });
+            if (stop_prefetch_requested_) {
+              return;
+            }
+          }
+          std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages;
+          try {
+            if (reader_->has_next()) {
+              messages = reader_->read_next_batch(batch_size);
+            }
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(prefetch_mutex_);
+            prefetch_error_ = std::current_exception();
+            prefetch_done_ = true;
+            prefetch_ready_condition_.notify_all();
+            return;
+          }
+          std::lock_guard<std::mutex> lock(prefetch_mutex_);
+          if (messages.empty()) {
+            prefetch_done_ = true;
+            prefetch_ready_condition_.notify_all();
+            return;
+          }
+          prefetched_batches_.push_back(std::move(messages));
+          prefetch_ready_condition_.notify_all();
+        }
+      });
+  }
+
+  /// Stop the prefetch thread and drop any batches it queued.
+  void stop_prefetch()
+  {
+    {
+      std::lock_guard<std::mutex> lock(prefetch_mutex_);
+      stop_prefetch_requested_ = true;
+    }
+    prefetch_space_condition_.notify_all();
+    if (prefetch_thread_.joinable()) {
+      prefetch_thread_.join();
+    }
+    prefetched_batches_.clear();
+    prefetch_done_ = false;
+    prefetch_error_ = nullptr;
+  }
+
+  /// Block until the prefetch thread queued a batch and return it; raises
+  /// StopIteration when the bag is exhausted. Starts prefetching with
+  /// default settings if start_prefetch() was not called.
+  pybind11::list next_batch()
+  {
+    if (!prefetch_thread_.joinable() && !prefetch_done_) {
+      start_prefetch(kDefaultPrefetchBatchSize, kDefaultPrefetchQueueDepth);
+    }
+    std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages;
+    std::exception_ptr error;
+    {
+      pybind11::gil_scoped_release release;
+      std::unique_lock<std::mutex> lock(prefetch_mutex_);
+      prefetch_ready_condition_.wait(
+        lock, [this] {return !prefetched_batches_.empty() || prefetch_done_;});
+      if (!prefetched_batches_.empty()) {
+        messages = std::move(prefetched_batches_.front());
+        prefetched_batches_.pop_front();
+        prefetch_space_condition_.notify_all();
+      } else {
+        error = prefetch_error_;
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    if (messages.empty()) {
+      throw pybind11::stop_iteration();
+    }
+    return batch_to_python(messages);
+  }
+
   /// Return a mapping from topic name to topic type.
   std::vector<rosbag2_storage::TopicMetadata> get_all_topics_and_types()
   {
@@ -79,7 +206,47 @@ public:
   }
 
 protected:
+  /// Convert a batch of serialized messages into a list of
+  /// (topic name, payload, timestamp) tuples. Each payload is a
+  /// buffer-protocol view into the C++ message buffer, kept alive by a
+  /// capsule holding a shared_ptr to the message.
+  pybind11::list batch_to_python(
+    const std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> & messages)
+  {
+    pybind11::list batch;
+    for (auto & message : messages) {
+      auto owner = pybind11::capsule(
+        new std::shared_ptr<rosbag2_storage::SerializedBagMessage>(message),
+        [](void * ptr) {
+          delete static_cast<std::shared_ptr<rosbag2_storage::SerializedBagMessage> *>(ptr);
+        });
+      pybind11::array_t<uint8_t> payload(
+        {message->serialized_data->buffer_length},
+        {sizeof(uint8_t)},
+        message->serialized_data->buffer,
+        owner);
+      batch.append(
+        pybind11::make_tuple(message->topic_name, std::move(payload), message->time_stamp));
+    }
+    return batch;
+  }
+
+  static constexpr size_t kDefaultPrefetchBatchSize = 64;
+  static constexpr size_t kDefaultPrefetchQueueDepth = 2;
+
   std::unique_ptr<rosbag2_cpp::Reader> reader_;
+
+  // Prefetch thread state. The thread only touches reader_ and the queue,
+  // never the Python interpreter, so it does not need the GIL.
+  std::thread prefetch_thread_;
+  std::mutex prefetch_mutex_;
+  std::condition_variable prefetch_ready_condition_;
+  std::condition_variable prefetch_space_condition_;
+  std::deque<std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>>
+  prefetched_batches_;
+  bool prefetch_done_{false};
+  bool stop_prefetch_requested_{false};
+  std::exception_ptr prefetch_error_{nullptr};
 };
 }  // namespace rosbag2_py
 
@@ -91,12 +258,22 @@ PYBIND11_MODULE(_reader, m) {
   .def(pybind11::init())
   .def("open", &rosbag2_py::Reader<rosbag2_cpp::readers::SequentialReader>::open)
   .def("read_next", &rosbag2_py::Reader<rosbag2_cpp::readers::SequentialReader>::read_next)
+  .def("read_batch", &rosbag2_py::Reader<rosbag2_cpp::readers::SequentialReader>::read_batch)
   .def("has_next", &rosbag2_py::Reader<rosbag2_cpp::readers::SequentialReader>::has_next)
   .def(
     "get_all_topics_and_types",
     &rosbag2_py::Reader<rosbag2_cpp::readers::SequentialReader>::get_all_topics_and_types)
   .def("set_filter", &rosbag2_py::Reader<rosbag2_cpp::readers::SequentialReader>::set_filter)
-  .def("reset_filter", &rosbag2_py::Reader<rosbag2_cpp::readers::SequentialReader>::reset_filter);
+  .def("reset_filter", &rosbag2_py::Reader<rosbag2_cpp::readers::SequentialReader>::reset_filter)
+  .def(
+    "start_prefetch",
+    &rosbag2_py::Reader<rosbag2_cpp::readers::SequentialReader>::start_prefetch,
+    pybind11::arg("batch_size") = 64, pybind11::arg("max_queued_batches") = 2)
+  .def(
+    "stop_prefetch",
+    &rosbag2_py::Reader<rosbag2_cpp::readers::SequentialReader>::stop_prefetch)
+  .def("__iter__", [](pybind11::object self) {return self;})
+  .def("__next__", &rosbag2_py::Reader<rosbag2_cpp::readers::SequentialReader>::next_batch);
 
   pybind11::class_<rosbag2_py::Reader<rosbag2_compression::SequentialCompressionReader>>(
     m, "SequentialCompressionReader")
@@ -104,6 +281,9 @@ PYBIND11_MODULE(_reader, m) {
   .def("open", &rosbag2_py::Reader<rosbag2_compression::SequentialCompressionReader>::open)
   .def(
     "read_next", &rosbag2_py::Reader<rosbag2_compression::SequentialCompressionReader>::read_next)
+  .def(
+    "read_batch",
+    &rosbag2_py::Reader<rosbag2_compression::SequentialCompressionReader>::read_batch)
   .def("has_next", &rosbag2_py::Reader<rosbag2_compression::SequentialCompressionReader>::has_next)
   .def(
     "get_all_topics_and_types",
@@ -115,5 +295,16 @@ PYBIND11_MODULE(_reader, m) {
     &rosbag2_py::Reader<rosbag2_compression::SequentialCompressionReader>::set_filter)
   .def(
     "reset_filter",
-    &rosbag2_py::Reader<rosbag2_compression::SequentialCompressionReader>::reset_filter);
+    &rosbag2_py::Reader<rosbag2_compression::SequentialCompressionReader>::reset_filter)
+  .def(
+    "start_prefetch",
+    &rosbag2_py::Reader<rosbag2_compression::SequentialCompressionReader>::start_prefetch,
+    pybind11::arg("batch_size") = 64, pybind11::arg("max_queued_batches") = 2)
+  .def(
+    "stop_prefetch",
+    &rosbag2_py::Reader<rosbag2_compression::SequentialCompressionReader>::stop_prefetch)
+  .def("__iter__", [](pybind11::object self) {return self;})
+  .def(
+    "__next__",
+    &rosbag2_py::Reader<rosbag2_compression::SequentialCompressionReader>::next_batch);
 }
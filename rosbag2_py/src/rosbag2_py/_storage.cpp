@@ -12,16 +12,31 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
 #include <string>
 #include <vector>
 
 #include "rosbag2_cpp/converter_options.hpp"
 #include "rosbag2_cpp/storage_options.hpp"
+#include "rosbag2_storage/bag_metadata.hpp"
 #include "rosbag2_storage/storage_filter.hpp"
 #include "rosbag2_storage/topic_metadata.hpp"
 
 #include "./pybind11.hpp"
 
+namespace
+{
+
+// chrono members are exposed to Python as plain integers in nanoseconds.
+int64_t to_nanoseconds(
+  const std::chrono::time_point<std::chrono::high_resolution_clock> & time_point)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    time_point.time_since_epoch()).count();
+}
+
+}  // namespace
+
 PYBIND11_MODULE(_storage, m) {
   m.doc() = "Python wrapper of the rosbag2 utilities API";
 
@@ -59,9 +74,21 @@ PYBIND11_MODULE(_storage, m) {
 
   pybind11::class_<rosbag2_storage::StorageFilter>(m, "StorageFilter")
   .def(
-    pybind11::init<std::vector<std::string>>(),
-    pybind11::arg("topics"))
-  .def_readwrite("topics", &rosbag2_storage::StorageFilter::topics);
+    pybind11::init<
+      std::vector<std::string>, std::string, std::string,
+      rcutils_time_point_value_t, rcutils_time_point_value_t>(),
+    pybind11::arg("topics") = std::vector<std::string>(),
+    pybind11::arg("topics_regex") = "",
+    pybind11::arg("topics_regex_to_exclude") = "",
+    pybind11::arg("start_time") = -1,
+    pybind11::arg("end_time") = -1)
+  .def_readwrite("topics", &rosbag2_storage::StorageFilter::topics)
+  .def_readwrite("topics_regex", &rosbag2_storage::StorageFilter::topics_regex)
+  .def_readwrite(
+    "topics_regex_to_exclude",
+    &rosbag2_storage::StorageFilter::topics_regex_to_exclude)
+  .def_readwrite("start_time", &rosbag2_storage::StorageFilter::start_time)
+  .def_readwrite("end_time", &rosbag2_storage::StorageFilter::end_time);
 
   pybind11::class_<rosbag2_storage::TopicMetadata>(m, "TopicMetadata")
   .def(
@@ -79,4 +106,58 @@ PYBIND11_MODULE(_storage, m) {
     "offered_qos_profiles",
     &rosbag2_storage::TopicMetadata::offered_qos_profiles)
   .def("equals", &rosbag2_storage::TopicMetadata::operator==);
+
+  pybind11::class_<rosbag2_storage::TopicInformation>(m, "TopicInformation")
+  .def(pybind11::init<>())
+  .def_readwrite(
+    "topic_metadata",
+    &rosbag2_storage::TopicInformation::topic_metadata)
+  .def_readwrite("message_count", &rosbag2_storage::TopicInformation::message_count)
+  .def_readwrite(
+    "dropped_message_count",
+    &rosbag2_storage::TopicInformation::dropped_message_count)
+  .def_readwrite(
+    "dropped_byte_count",
+    &rosbag2_storage::TopicInformation::dropped_byte_count);
+
+  pybind11::class_<rosbag2_storage::FileInformation>(m, "FileInformation")
+  .def(pybind11::init<>())
+  .def_readwrite("path", &rosbag2_storage::FileInformation::path)
+  .def_property_readonly(
+    "starting_time_nanoseconds",
+    [](const rosbag2_storage::FileInformation & file_information) {
+      return to_nanoseconds(file_information.starting_time);
+    })
+  .def_property_readonly(
+    "duration_nanoseconds",
+    [](const rosbag2_storage::FileInformation & file_information) {
+      return file_information.duration.count();
+    });
+
+  pybind11::class_<rosbag2_storage::BagMetadata>(m, "BagMetadata")
+  .def(pybind11::init<>())
+  .def_readwrite("version", &rosbag2_storage::BagMetadata::version)
+  .def_readwrite("bag_size", &rosbag2_storage::BagMetadata::bag_size)
+  .def_readwrite("storage_identifier", &rosbag2_storage::BagMetadata::storage_identifier)
+  .def_readwrite(
+    "relative_file_paths",
+    &rosbag2_storage::BagMetadata::relative_file_paths)
+  .def_property_readonly(
+    "duration_nanoseconds",
+    [](const rosbag2_storage::BagMetadata & metadata) {
+      return metadata.duration.count();
+    })
+  .def_property_readonly(
+    "starting_time_nanoseconds",
+    [](const rosbag2_storage::BagMetadata & metadata) {
+      return to_nanoseconds(metadata.starting_time);
+    })
+  .def_readwrite("message_count", &rosbag2_storage::BagMetadata::message_count)
+  .def_readwrite(
+    "topics_with_message_count",
+    &rosbag2_storage::BagMetadata::topics_with_message_count)
+  .def_readwrite("compression_format", &rosbag2_storage::BagMetadata::compression_format)
+  .def_readwrite("compression_mode", &rosbag2_storage::BagMetadata::compression_mode)
+  .def_readwrite("storage_shard_count", &rosbag2_storage::BagMetadata::storage_shard_count)
+  .def_readwrite("files", &rosbag2_storage::BagMetadata::files);
 }
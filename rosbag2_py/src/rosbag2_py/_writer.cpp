@@ -13,8 +13,12 @@
 // limitations under the License.
 
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "rosbag2_compression/compression_options.hpp"
 #include "rosbag2_compression/sequential_compression_writer.hpp"
 #include "rosbag2_cpp/converter_options.hpp"
 #include "rosbag2_cpp/storage_options.hpp"
@@ -29,12 +33,40 @@
 namespace rosbag2_py
 {
 
+namespace
+{
+// The write paths copy buffer.size * buffer.itemsize bytes straight from
+// buffer.ptr, which is only the payload for C-contiguous memory. A strided
+// view (e.g. a NumPy slice like arr[::2]) would be recorded silently with
+// the wrong bytes, so it is rejected instead.
+void throw_on_noncontiguous_buffer(const pybind11::buffer_info & buffer)
+{
+  if (buffer.size == 0) {
+    return;  // Nothing is copied, any strides are fine.
+  }
+  pybind11::ssize_t expected_stride = buffer.itemsize;
+  for (auto dim = buffer.ndim; dim-- > 0;) {
+    if (buffer.shape[dim] > 1 && buffer.strides[dim] != expected_stride) {
+      throw std::runtime_error(
+        "write requires a C-contiguous payload; copy strided arrays first, "
+        "e.g. with numpy.ascontiguousarray()");
+    }
+    expected_stride *= buffer.shape[dim];
+  }
+}
+}  // namespace
+
 template<typename T>
 class Writer
 {
 public:
-  Writer()
-  : writer_(std::make_unique<rosbag2_cpp::Writer>(std::make_unique<T>()))
+  // Constructor arguments are forwarded to the wrapped writer, so writer
+  // types with configuration (e.g. CompressionOptions) can be bound without
+  // specializing the wrapper.
+  template<typename ... WriterArgs>
+  explicit Writer(WriterArgs && ... writer_args)
+  : writer_(std::make_unique<rosbag2_cpp::Writer>(
+        std::make_unique<T>(std::forward<WriterArgs>(writer_args) ...)))
   {
   }
 
@@ -55,22 +87,65 @@ public:
     writer_->remove_topic(topic_with_type);
   }
 
-  /// Write a serialized message to a bag file
+  /// Write a serialized message to a bag file.
+  /// The payload may be any C-contiguous buffer-protocol object (bytes,
+  /// bytearray, memoryview, NumPy arrays; strided views are rejected).
+  /// Its bytes are copied exactly once, into the
+  /// pooled serialized-message buffer; binding a std::string here instead
+  /// would make pybind11 materialize an intermediate copy first. The writer
+  /// may hold the message beyond this call (cache, compression), so the
+  /// Python buffer cannot be referenced without a copy.
   void write(
-    const std::string & topic_name, const std::string & message,
+    const std::string & topic_name, const pybind11::buffer & message,
     const rcutils_time_point_value_t & time_stamp)
   {
+    const auto buffer = message.request();
+    throw_on_noncontiguous_buffer(buffer);
     auto bag_message =
       std::make_shared<rosbag2_storage::SerializedBagMessage>();
 
     bag_message->topic_name = topic_name;
-    bag_message->serialized_data =
-      rosbag2_storage::make_serialized_message(message.c_str(), message.length());
+    bag_message->serialized_data = rosbag2_storage::make_serialized_message(
+      buffer.ptr, static_cast<size_t>(buffer.size) * static_cast<size_t>(buffer.itemsize));
     bag_message->time_stamp = time_stamp;
 
+    // The payload was copied above; the storage write (and any message
+    // compression it entails) runs in C++ with the GIL released.
+    pybind11::gil_scoped_release release;
     writer_->write(bag_message);
   }
 
+  /// Write a batch of (topic name, payload, timestamp) tuples in one call.
+  /// Payloads may be any C-contiguous buffer-protocol object (bytes,
+  /// bytearray, NumPy arrays; strided views are rejected). The payload
+  /// bytes are copied into serialized messages under a
+  /// single GIL hold; the storage writes then run with the GIL released so
+  /// Python threads can keep producing while the batch is persisted.
+  void write_batch(const pybind11::sequence & batch)
+  {
+    std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages;
+    messages.reserve(pybind11::len(batch));
+    for (auto item : batch) {
+      auto entry = item.cast<pybind11::tuple>();
+      if (entry.size() != 3) {
+        throw std::runtime_error("write_batch expects (topic_name, data, timestamp) tuples");
+      }
+      auto buffer = pybind11::buffer(entry[1]).request();
+      throw_on_noncontiguous_buffer(buffer);
+      auto bag_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+      bag_message->topic_name = entry[0].cast<std::string>();
+      bag_message->serialized_data = rosbag2_storage::make_serialized_message(
+        buffer.ptr, static_cast<size_t>(buffer.size) * static_cast<size_t>(buffer.itemsize));
+      bag_message->time_stamp = entry[2].cast<rcutils_time_point_value_t>();
+      messages.push_back(std::move(bag_message));
+    }
+
+    pybind11::gil_scoped_release release;
+    for (auto & message : messages) {
+      writer_->write(message);
+    }
+  }
+
 protected:
   std::unique_ptr<rosbag2_cpp::Writer> writer_;
 };
@@ -80,19 +155,61 @@ protected:
 PYBIND11_MODULE(_writer, m) {
   m.doc() = "Python wrapper of the rosbag2_cpp writer API";
 
+  pybind11::enum_<rosbag2_compression::CompressionMode>(m, "CompressionMode")
+  .value("NONE", rosbag2_compression::CompressionMode::NONE)
+  .value("FILE", rosbag2_compression::CompressionMode::FILE)
+  .value("MESSAGE", rosbag2_compression::CompressionMode::MESSAGE)
+  .value("CHUNK", rosbag2_compression::CompressionMode::CHUNK);
+
+  pybind11::class_<rosbag2_compression::CompressionOptions>(m, "CompressionOptions")
+  .def(
+    pybind11::init<std::string, rosbag2_compression::CompressionMode, int, int>(),
+    pybind11::arg("compression_format"),
+    pybind11::arg("compression_mode"),
+    pybind11::arg("compression_level") = 1,
+    pybind11::arg("compression_threads") = -1)
+  .def_readwrite(
+    "compression_format",
+    &rosbag2_compression::CompressionOptions::compression_format)
+  .def_readwrite(
+    "compression_mode",
+    &rosbag2_compression::CompressionOptions::compression_mode)
+  .def_readwrite(
+    "compression_level",
+    &rosbag2_compression::CompressionOptions::compression_level)
+  .def_readwrite(
+    "compression_threads",
+    &rosbag2_compression::CompressionOptions::compression_threads)
+  .def_readwrite(
+    "exclude_topics",
+    &rosbag2_compression::CompressionOptions::exclude_topics)
+  .def_readwrite(
+    "include_topics",
+    &rosbag2_compression::CompressionOptions::include_topics)
+  .def_readwrite(
+    "minimum_compression_ratio",
+    &rosbag2_compression::CompressionOptions::minimum_compression_ratio);
+
   pybind11::class_<rosbag2_py::Writer<rosbag2_cpp::writers::SequentialWriter>>(
     m, "SequentialWriter")
   .def(pybind11::init())
   .def("open", &rosbag2_py::Writer<rosbag2_cpp::writers::SequentialWriter>::open)
   .def("write", &rosbag2_py::Writer<rosbag2_cpp::writers::SequentialWriter>::write)
+  .def("write_batch", &rosbag2_py::Writer<rosbag2_cpp::writers::SequentialWriter>::write_batch)
   .def("remove_topic", &rosbag2_py::Writer<rosbag2_cpp::writers::SequentialWriter>::remove_topic)
   .def("create_topic", &rosbag2_py::Writer<rosbag2_cpp::writers::SequentialWriter>::create_topic);
 
   pybind11::class_<rosbag2_py::Writer<rosbag2_compression::SequentialCompressionWriter>>(
     m, "SequentialCompressionWriter")
   .def(pybind11::init())
+  .def(
+    pybind11::init<rosbag2_compression::CompressionOptions>(),
+    pybind11::arg("compression_options"))
   .def("open", &rosbag2_py::Writer<rosbag2_compression::SequentialCompressionWriter>::open)
   .def("write", &rosbag2_py::Writer<rosbag2_compression::SequentialCompressionWriter>::write)
+  .def(
+    "write_batch",
+    &rosbag2_py::Writer<rosbag2_compression::SequentialCompressionWriter>::write_batch)
   .def(
     "remove_topic",
     &rosbag2_py::Writer<rosbag2_compression::SequentialCompressionWriter>::remove_topic)
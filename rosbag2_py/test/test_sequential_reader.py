@@ -63,6 +63,58 @@ def test_sequential_reader():
     # No filter
     reader.reset_filter()
 
+    # Time-range filtering is pushed down to the storage layer
+    reader = rosbag2_py.SequentialReader()
+    reader.open(storage_options, converter_options)
+    reader.set_filter(rosbag2_py.StorageFilter(topics_regex='/top.*', end_time=sys.maxsize))
+
+    while reader.has_next():
+        (topic, data, t) = reader.read_next()
+        assert topic == '/topic'
+        assert t <= sys.maxsize
+
+    # Batched reads return buffer-protocol payloads viewing the C++ memory
+    reader = rosbag2_py.SequentialReader()
+    reader.open(storage_options, converter_options)
+    reader.set_filter(storage_filter)
+
+    msg_counter = 0
+
+    while reader.has_next():
+        batch = reader.read_batch(5)
+        assert 0 < len(batch) <= 5
+        for (topic, data, t) in batch:
+            assert memoryview(data).nbytes == len(data)
+            msg_type = get_message(type_map[topic])
+            msg = deserialize_message(bytes(data), msg_type)
+
+            assert isinstance(msg, String)
+            assert msg.data == f'Hello, world! {msg_counter}'
+
+            msg_counter += 1
+
+    # Iterating the reader prefetches batches on a background thread
+    reader = rosbag2_py.SequentialReader()
+    reader.open(storage_options, converter_options)
+    reader.set_filter(storage_filter)
+    reader.start_prefetch(batch_size=5, max_queued_batches=2)
+
+    msg_counter = 0
+
+    for batch in reader:
+        assert 0 < len(batch) <= 5
+        for (topic, data, t) in batch:
+            msg_type = get_message(type_map[topic])
+            msg = deserialize_message(bytes(data), msg_type)
+
+            assert isinstance(msg, String)
+            assert msg.data == f'Hello, world! {msg_counter}'
+
+            msg_counter += 1
+
+    assert msg_counter > 0
+    reader.stop_prefetch()
+
     reader = rosbag2_py.SequentialReader()
     reader.open(storage_options, converter_options)
 
@@ -15,6 +15,8 @@
 import os
 import sys
 
+import pytest
+
 from rclpy.serialization import deserialize_message, serialize_message
 from rosidl_runtime_py.utilities import get_message
 from std_msgs.msg import String
@@ -64,12 +66,25 @@ def test_sequential_writer(tmp_path):
     topic_name = '/chatter'
     create_topic(writer, topic_name, 'std_msgs/msg/String')
 
-    for i in range(10):
+    for i in range(5):
         msg = String()
         msg.data = f'Hello, world! {str(i)}'
         time_stamp = i * 100
 
-        writer.write(topic_name, serialize_message(msg), time_stamp)
+        # Alternate payload types: write accepts any buffer-protocol object
+        if i % 2 == 0:
+            writer.write(topic_name, serialize_message(msg), time_stamp)
+        else:
+            writer.write(topic_name, memoryview(serialize_message(msg)), time_stamp)
+
+    # Batched writes accept any buffer-protocol payload
+    batch = []
+    for i in range(5, 10):
+        msg = String()
+        msg.data = f'Hello, world! {str(i)}'
+        batch.append((topic_name, serialize_message(msg), i * 100))
+
+    writer.write_batch(batch)
 
     # close bag and create new storage instance
     del writer
@@ -94,3 +109,80 @@ def test_sequential_writer(tmp_path):
         assert t == msg_counter * 100
 
         msg_counter += 1
+
+
+def test_write_rejects_non_contiguous_payloads(tmp_path):
+    """
+    Test that strided buffer views are rejected instead of silently mis-recorded.
+
+    :return:
+    """
+    bag_path = str(tmp_path / 'tmp_non_contiguous_test')
+
+    storage_options, converter_options = get_rosbag_options(bag_path)
+
+    writer = rosbag2_py.SequentialWriter()
+    writer.open(storage_options, converter_options)
+
+    topic_name = '/chatter'
+    create_topic(writer, topic_name, 'std_msgs/msg/String')
+
+    msg = String()
+    msg.data = 'Hello, world!'
+    strided_view = memoryview(serialize_message(msg))[::2]
+
+    with pytest.raises(RuntimeError):
+        writer.write(topic_name, strided_view, 0)
+
+    with pytest.raises(RuntimeError):
+        writer.write_batch([(topic_name, strided_view, 0)])
+
+
+def test_sequential_compression_writer(tmp_path):
+    """
+    Test writing a compressed bag and reading it back.
+
+    :return:
+    """
+    bag_path = str(tmp_path / 'tmp_compressed_write_test')
+
+    storage_options, converter_options = get_rosbag_options(bag_path)
+    compression_options = rosbag2_py.CompressionOptions(
+        compression_format='zstd',
+        compression_mode=rosbag2_py.CompressionMode.FILE,
+        compression_level=1,
+        compression_threads=1)
+
+    writer = rosbag2_py.SequentialCompressionWriter(compression_options)
+    writer.open(storage_options, converter_options)
+
+    topic_name = '/chatter'
+    create_topic(writer, topic_name, 'std_msgs/msg/String')
+
+    for i in range(10):
+        msg = String()
+        msg.data = f'Hello, world! {str(i)}'
+        writer.write(topic_name, serialize_message(msg), i * 100)
+
+    # close bag and read it back through the compression reader
+    del writer
+    storage_options, converter_options = get_rosbag_options(bag_path)
+
+    reader = rosbag2_py.SequentialCompressionReader()
+    reader.open(storage_options, converter_options)
+
+    type_map = {entry.name: entry.type for entry in reader.get_all_topics_and_types()}
+
+    msg_counter = 0
+    while reader.has_next():
+        topic, data, t = reader.read_next()
+        msg_type = get_message(type_map[topic])
+        msg_deserialized = deserialize_message(data, msg_type)
+
+        assert isinstance(msg_deserialized, String)
+        assert msg_deserialized.data == f'Hello, world! {msg_counter}'
+        assert t == msg_counter * 100
+
+        msg_counter += 1
+
+    assert msg_counter == 10
@@ -15,6 +15,7 @@
 #ifndef ROSBAG2_STORAGE__BAG_METADATA_HPP_
 #define ROSBAG2_STORAGE__BAG_METADATA_HPP_
 
+#include <array>
 #include <chrono>
 #include <string>
 #include <vector>
@@ -29,11 +30,43 @@ struct TopicInformation
 {
   TopicMetadata topic_metadata;
   size_t message_count;
+  // Messages evicted by the writer's bounded cache under overload.
+  // Serialized with metadata version 5 and newer.
+  size_t dropped_message_count;
+  size_t dropped_byte_count;
+  // Messages the middleware reported lost on the recording subscription,
+  // i.e. they never reached the recorder at all.
+  // Serialized with metadata version 8 and newer.
+  size_t rmw_lost_message_count;
+  // Size distribution summary of the persisted messages, derived from the
+  // histogram below: the percentiles report the upper bound of their
+  // histogram bucket, the maximum is exact. All zero for bags recorded
+  // before the histogram existed and for topics without messages.
+  // Serialized with metadata version 9 and newer.
+  size_t message_size_max;
+  size_t message_size_p50;
+  size_t message_size_p90;
+  size_t message_size_p99;
+  // Log2-bucketed histogram of the persisted message sizes: bucket i counts
+  // messages of up to 2^(i+1) - 1 bytes, with the last bucket catching
+  // everything larger. Maintained by the writer while recording.
+  // Will not be serialized.
+  std::array<size_t, 32> message_size_histogram {};
+};
+
+struct FileInformation
+{
+  std::string path;
+  // Receive timestamp of the earliest message in the file. Files written
+  // without any message keep the default-constructed maximum value.
+  std::chrono::time_point<std::chrono::high_resolution_clock> starting_time{
+    std::chrono::nanoseconds::max()};
+  std::chrono::nanoseconds duration{0};
 };
 
 struct BagMetadata
 {
-  int version = 4;  // upgrade this number when changing the content of the struct
+  int version = 9;  // upgrade this number when changing the content of the struct
   uint64_t bag_size = 0;  // Will not be serialized
   std::string storage_identifier;
   std::vector<std::string> relative_file_paths;
@@ -43,6 +76,14 @@ struct BagMetadata
   std::vector<TopicInformation> topics_with_message_count;
   std::string compression_format;
   std::string compression_mode;
+  // Number of storage files written in parallel per split, with the topics
+  // partitioned across them. 1 for regular bags.
+  // Serialized with metadata version 6 and newer.
+  uint64_t storage_shard_count = 1;
+  // Per-file message time ranges, in the same order as relative_file_paths,
+  // letting readers skip split files outside a requested time window.
+  // Serialized with metadata version 7 and newer.
+  std::vector<FileInformation> files;
 };
 
 }  // namespace rosbag2_storage
@@ -0,0 +1,45 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_STORAGE__CRC32C_HPP_
+#define ROSBAG2_STORAGE__CRC32C_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rosbag2_storage/visibility_control.hpp"
+
+namespace rosbag2_storage
+{
+
+/**
+ * Fold a block of data into a CRC32C (Castagnoli polynomial) checksum.
+ *
+ * Computed with the SSE4.2 CRC instructions where the CPU provides them
+ * (selected once at runtime) or the ARMv8 CRC extension (selected at compile
+ * time), falling back to a table-driven implementation elsewhere — cheap
+ * enough to leave enabled at recording line rate. Storage plugins use this
+ * to detect bit rot in long-lived archives below the file level.
+ *
+ * \param crc the running checksum; pass 0 for the first block
+ * \param data the block to fold into the checksum
+ * \param size the block size in bytes
+ * \return the updated checksum
+ */
+ROSBAG2_STORAGE_PUBLIC
+uint32_t update_crc32c(uint32_t crc, const void * data, size_t size);
+
+}  // namespace rosbag2_storage
+
+#endif  // ROSBAG2_STORAGE__CRC32C_HPP_
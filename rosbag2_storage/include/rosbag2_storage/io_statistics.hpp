@@ -0,0 +1,45 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_STORAGE__IO_STATISTICS_HPP_
+#define ROSBAG2_STORAGE__IO_STATISTICS_HPP_
+
+#include <cstdint>
+
+namespace rosbag2_storage
+{
+
+/**
+ * Cumulative I/O counters of a storage plugin since it was opened, for
+ * monitoring recorder and player health at runtime. All counts are payload
+ * bytes and message counts as seen by the plugin; fields a plugin does not
+ * track stay at their zero default.
+ */
+struct IOStatistics
+{
+  uint64_t bytes_written = 0;
+  uint64_t bytes_read = 0;
+  uint64_t messages_written = 0;
+  uint64_t messages_read = 0;
+  uint64_t transactions_committed = 0;
+  // Current size of the plugin's write-ahead log or journal file, in bytes.
+  uint64_t write_ahead_log_size = 0;
+  // Page cache effectiveness of the plugin's backing store.
+  uint64_t page_cache_hits = 0;
+  uint64_t page_cache_misses = 0;
+};
+
+}  // namespace rosbag2_storage
+
+#endif  // ROSBAG2_STORAGE__IO_STATISTICS_HPP_
@@ -27,6 +27,10 @@ class MetadataIo
 {
 public:
   static constexpr const char * const metadata_filename = "metadata.yaml";
+  // Compact binary twin of metadata.yaml, written alongside it so readers
+  // can skip YAML parsing. The YAML file stays the human-readable source of
+  // truth; the sidecar is ignored whenever it is missing, corrupt or stale.
+  static constexpr const char * const metadata_sidecar_filename = "metadata.bin";
 
   virtual ~MetadataIo() = default;
 
@@ -41,6 +45,9 @@ public:
 
 private:
   std::string get_metadata_file_name(const std::string & uri);
+  std::string get_sidecar_file_name(const std::string & uri);
+  void write_sidecar(const std::string & uri, const BagMetadata & metadata);
+  bool read_sidecar(const std::string & uri, BagMetadata & metadata);
 };
 
 }  // namespace rosbag2_storage
@@ -0,0 +1,33 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_STORAGE__READ_ORDER_HPP_
+#define ROSBAG2_STORAGE__READ_ORDER_HPP_
+
+namespace rosbag2_storage
+{
+
+// Direction in which a reader or storage hands out messages.
+enum class ReadOrder
+{
+  // Ascending receive timestamp (default).
+  FORWARD = 0,
+  // Descending receive timestamp, so stepping backwards through a bag is as
+  // cheap as stepping forward instead of re-reading from the beginning.
+  REVERSE = 1,
+};
+
+}  // namespace rosbag2_storage
+
+#endif  // ROSBAG2_STORAGE__READ_ORDER_HPP_
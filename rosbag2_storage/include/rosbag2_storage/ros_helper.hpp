@@ -17,6 +17,7 @@
 
 #include <memory>
 
+#include "rcutils/allocator.h"
 #include "rcutils/types/uint8_array.h"
 
 #include "rosbag2_storage/visibility_control.hpp"
@@ -32,6 +33,25 @@ ROSBAG2_STORAGE_PUBLIC
 std::shared_ptr<rcutils_uint8_array_t>
 make_empty_serialized_message(size_t size);
 
+/**
+ * Inject the allocator used for every payload buffer created through
+ * make_serialized_message() / make_empty_serialized_message(), and thereby
+ * for the storage plugin read paths, process-wide. Deployments can e.g.
+ * route multi-megabyte point cloud payloads through a huge-page-backed pool.
+ *
+ * Intended to be called once at startup, before any bag is opened. Buffers
+ * record the allocator they were created with, so buffers from before the
+ * change are still freed correctly; the internal buffer pool is flushed so
+ * every buffer served afterwards comes from the injected allocator.
+ *
+ * The default is rcutils_get_default_allocator().
+ */
+ROSBAG2_STORAGE_PUBLIC
+void set_serialized_message_allocator(const rcutils_allocator_t & allocator);
+
+ROSBAG2_STORAGE_PUBLIC
+rcutils_allocator_t get_serialized_message_allocator();
+
 }  // namespace rosbag2_storage
 
 #endif  // ROSBAG2_STORAGE__ROS_HELPER_HPP_
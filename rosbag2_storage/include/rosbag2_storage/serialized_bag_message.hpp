@@ -15,6 +15,8 @@
 #ifndef ROSBAG2_STORAGE__SERIALIZED_BAG_MESSAGE_HPP_
 #define ROSBAG2_STORAGE__SERIALIZED_BAG_MESSAGE_HPP_
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -29,6 +31,27 @@ struct SerializedBagMessage
   std::shared_ptr<rcutils_uint8_array_t> serialized_data;
   rcutils_time_point_value_t time_stamp;
   std::string topic_name;
+  // Interned numeric id of the topic, assigned by the component which
+  // created the topic (see TopicMetadata::topic_id). Ids only identify a
+  // topic within the session of the writer or reader which assigned them;
+  // 0 means "not assigned" and the topic name is the authoritative key.
+  uint32_t topic_id {0};
+};
+
+/**
+ * Non-owning view over a contiguous array of message pointers.
+ *
+ * Used for batch writes without per-message ownership transfer: the caller
+ * guarantees that the messages (and their serialized data) stay alive until
+ * the call taking the span returns.
+ */
+struct SerializedBagMessageSpan
+{
+  const SerializedBagMessage * const * data {nullptr};
+  size_t size {0};
+
+  const SerializedBagMessage * const * begin() const {return data;}
+  const SerializedBagMessage * const * end() const {return data + size;}
 };
 
 }  // namespace rosbag2_storage
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rosbag2_storage/storage_factory_interface.hpp"
 #include "rosbag2_storage/visibility_control.hpp"
@@ -54,6 +55,22 @@ public:
   std::shared_ptr<storage_interfaces::ReadWriteInterface>
   open_read_write(const std::string & uri, const std::string & storage_id) override;
 
+  std::shared_ptr<storage_interfaces::ReadOnlyInterface>
+  open_read_only(
+    const std::string & uri, const std::string & storage_id,
+    const std::string & storage_config_uri) override;
+
+  std::shared_ptr<storage_interfaces::ReadWriteInterface>
+  open_read_write(
+    const std::string & uri, const std::string & storage_id,
+    const std::string & storage_config_uri) override;
+
+  /// Storage ids of all installed plugins registered against the read-write
+  /// interface, i.e. every storage id open_read_write accepts. Tooling which
+  /// iterates over the available plugins (e.g. benchmark runners) uses this
+  /// instead of hard-coding storage ids.
+  std::vector<std::string> get_declared_read_write_storage_ids();
+
 private:
   std::unique_ptr<StorageFactoryImpl> impl_;
 };
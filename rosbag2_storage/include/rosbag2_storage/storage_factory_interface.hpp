@@ -35,6 +35,27 @@ public:
 
   virtual std::shared_ptr<storage_interfaces::ReadWriteInterface>
   open_read_write(const std::string & uri, const std::string & storage_id) = 0;
+
+  // Overloads which additionally hand a plugin specific configuration file
+  // to the storage before opening it. The default implementations ignore
+  // the configuration.
+  virtual std::shared_ptr<storage_interfaces::ReadOnlyInterface>
+  open_read_only(
+    const std::string & uri, const std::string & storage_id,
+    const std::string & storage_config_uri)
+  {
+    (void) storage_config_uri;
+    return open_read_only(uri, storage_id);
+  }
+
+  virtual std::shared_ptr<storage_interfaces::ReadWriteInterface>
+  open_read_write(
+    const std::string & uri, const std::string & storage_id,
+    const std::string & storage_config_uri)
+  {
+    (void) storage_config_uri;
+    return open_read_write(uri, storage_id);
+  }
 };
 
 }  // namespace rosbag2_storage
@@ -18,6 +18,8 @@
 #include <string>
 #include <vector>
 
+#include "rcutils/time.h"
+
 namespace rosbag2_storage
 {
 
@@ -27,6 +29,26 @@ struct StorageFilter
   // specified topics will be returned. If list is empty, the filter is ignored
   // and all messages are returned.
   std::vector<std::string> topics;
+
+  // Regular expression matched against topic names to whitelist when
+  // reading a bag, in addition to the explicit topics list. If empty and
+  // the topics list is also empty, all topics are selected.
+  std::string topics_regex = "";
+
+  // Regular expression matched against topic names to exclude when reading
+  // a bag. Exclusion wins over the topics list and topics_regex. If empty,
+  // no topics are excluded.
+  std::string topics_regex_to_exclude = "";
+
+  // Only messages with a receive timestamp (in nanoseconds since epoch)
+  // greater than or equal to this value will be returned. A negative value
+  // disables the lower bound.
+  rcutils_time_point_value_t start_time = -1;
+
+  // Only messages with a receive timestamp (in nanoseconds since epoch)
+  // less than or equal to this value will be returned. A negative value
+  // disables the upper bound.
+  rcutils_time_point_value_t end_time = -1;
 };
 
 }  // namespace rosbag2_storage
@@ -17,8 +17,10 @@
 #define ROSBAG2_STORAGE__STORAGE_INTERFACES__BASE_INFO_INTERFACE_HPP_
 
 #include <string>
+#include <vector>
 
 #include "rosbag2_storage/bag_metadata.hpp"
+#include "rosbag2_storage/topic_statistics.hpp"
 #include "rosbag2_storage/visibility_control.hpp"
 
 namespace rosbag2_storage
@@ -33,6 +35,17 @@ public:
 
   virtual BagMetadata get_metadata() = 0;
 
+  /**
+   * Per-topic message count, byte sum and time span, aggregated inside the
+   * storage so frequency and bandwidth statistics do not require a full
+   * client-side read of every message. The default implementation returns
+   * an empty vector for plugins without an efficient aggregation.
+   */
+  virtual std::vector<TopicStatistics> get_topic_statistics()
+  {
+    return {};
+  }
+
   /**
    * Retrieves the relative path to the backing of the storage plugin.
    *
@@ -17,6 +17,7 @@
 
 #include <string>
 
+#include "rosbag2_storage/io_statistics.hpp"
 #include "rosbag2_storage/visibility_control.hpp"
 
 namespace rosbag2_storage
@@ -54,6 +55,27 @@ public:
    * The storage plugin will append the uri in the case of creating a new bagfile backing.
    */
   virtual void open(const std::string & uri, IOFlag io_flag) = 0;
+
+  /**
+   * Passes a plugin specific configuration file to the storage plugin.
+   * Must be called before open() to take effect. Plugins which do not
+   * support external tuning simply ignore the call.
+   * \param storage_config_uri is the path to the plugin specific config file.
+   */
+  virtual void set_storage_config(const std::string & storage_config_uri)
+  {
+    (void) storage_config_uri;
+  }
+
+  /**
+   * Returns cumulative I/O counters since open(), so callers can monitor
+   * storage health at runtime. Plugins which do not track statistics return
+   * the zero-initialized default.
+   */
+  virtual IOStatistics get_io_statistics() const
+  {
+    return IOStatistics{};
+  }
 };
 
 }  // namespace storage_interfaces
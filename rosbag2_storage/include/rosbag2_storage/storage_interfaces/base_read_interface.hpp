@@ -16,9 +16,13 @@
 #define ROSBAG2_STORAGE__STORAGE_INTERFACES__BASE_READ_INTERFACE_HPP_
 
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "rcutils/time.h"
+
+#include "rosbag2_storage/read_order.hpp"
 #include "rosbag2_storage/serialized_bag_message.hpp"
 #include "rosbag2_storage/topic_metadata.hpp"
 #include "rosbag2_storage/visibility_control.hpp"
@@ -37,7 +41,57 @@ public:
 
   virtual std::shared_ptr<SerializedBagMessage> read_next() = 0;
 
+  /**
+   * Read up to max_batch_size messages in one call, amortizing the virtual
+   * dispatch and cursor overhead of read_next() over the whole batch.
+   * Storage plugins should override this with a vectorized implementation;
+   * the default simply loops over read_next().
+   *
+   * \param max_batch_size upper bound for the number of messages returned
+   * \return the read messages; fewer than max_batch_size (possibly empty)
+   * when the storage runs out of messages.
+   */
+  virtual std::vector<std::shared_ptr<SerializedBagMessage>> read_next_batch(size_t max_batch_size)
+  {
+    std::vector<std::shared_ptr<SerializedBagMessage>> batch;
+    batch.reserve(max_batch_size);
+    while (batch.size() < max_batch_size && has_next()) {
+      batch.push_back(read_next());
+    }
+    return batch;
+  }
+
   virtual std::vector<TopicMetadata> get_all_topics_and_types() = 0;
+
+  /**
+   * Reposition the read cursor so the next message returned is the first one
+   * with a receive timestamp greater than or equal to the given one.
+   * Storage plugins with an index over the timestamp should override this
+   * with a sublinear lookup; the default reports seeking as unsupported.
+   *
+   * \param timestamp to jump to, in nanoseconds since epoch
+   * \throws runtime_error if the storage plugin does not support seeking.
+   */
+  virtual void seek(rcutils_time_point_value_t timestamp)
+  {
+    (void) timestamp;
+    throw std::runtime_error("Seeking is not supported by this storage plugin.");
+  }
+
+  /**
+   * Select the direction in which read_next() walks the bag. Storage
+   * plugins with an index over the timestamp should override this with a
+   * reversible cursor; the default only supports forward reading.
+   *
+   * \param read_order direction for subsequent reads
+   * \throws runtime_error if the plugin does not support the given order.
+   */
+  virtual void set_read_order(ReadOrder read_order)
+  {
+    if (read_order != ReadOrder::FORWARD) {
+      throw std::runtime_error("Reverse reading is not supported by this storage plugin.");
+    }
+  }
 };
 
 }  // namespace storage_interfaces
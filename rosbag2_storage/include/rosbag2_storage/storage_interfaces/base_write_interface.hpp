@@ -38,9 +38,36 @@ public:
 
   virtual void write(const std::vector<std::shared_ptr<const SerializedBagMessage>> & msg) = 0;
 
+  /**
+   * Write a batch given as a non-owning view; the caller guarantees the
+   * messages outlive the call, so no per-message ownership needs to be
+   * taken. The default forwards to the single-message write through
+   * non-owning handles so existing plugins keep working; plugins with a
+   * batch path should override this next to the vector overload.
+   */
+  virtual void write(const SerializedBagMessageSpan & messages)
+  {
+    for (const auto * message : messages) {
+      write(
+        std::shared_ptr<const SerializedBagMessage>(
+          message, [](const SerializedBagMessage *) {}));
+    }
+  }
+
   virtual void create_topic(const TopicMetadata & topic) = 0;
 
   virtual void remove_topic(const TopicMetadata & topic) = 0;
+
+  /**
+   * Hints the expected final size of the bagfile so the plugin can
+   * preallocate contiguous disk space instead of growing the file page by
+   * page. Plugins without preallocation support ignore the call.
+   * \param expected_file_size expected bagfile size in bytes.
+   */
+  virtual void preallocate(uint64_t expected_file_size)
+  {
+    (void) expected_file_size;
+  }
 };
 
 }  // namespace storage_interfaces
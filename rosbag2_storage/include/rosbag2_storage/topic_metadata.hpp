@@ -15,6 +15,7 @@
 #ifndef ROSBAG2_STORAGE__TOPIC_METADATA_HPP_
 #define ROSBAG2_STORAGE__TOPIC_METADATA_HPP_
 
+#include <cstdint>
 #include <string>
 
 namespace rosbag2_storage
@@ -27,6 +28,12 @@ struct TopicMetadata
   std::string serialization_format;
   // Serialized std::vector<rclcpp::QoS> as a YAML string
   std::string offered_qos_profiles;
+  // Interned numeric id of the topic, assigned by the writer on
+  // create_topic or filled by the storage on the read path. The id is
+  // transient: it only identifies the topic within the assigning session,
+  // is not persisted to the bag metadata and does not take part in
+  // equality. 0 means "not assigned".
+  uint32_t topic_id {0};
 
   bool operator==(const rosbag2_storage::TopicMetadata & rhs) const
   {
@@ -0,0 +1,42 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_STORAGE__TOPIC_STATISTICS_HPP_
+#define ROSBAG2_STORAGE__TOPIC_STATISTICS_HPP_
+
+#include <cstdint>
+#include <string>
+
+namespace rosbag2_storage
+{
+
+// Per-topic aggregates a storage plugin can compute in one pass (or one
+// aggregated query) over its data, without handing every message to the
+// client. Average frequency and bandwidth derive from these as
+// message_count respectively byte_count over the recorded time span.
+struct TopicStatistics
+{
+  std::string topic_name;
+  uint64_t message_count {0};
+  // Sum of the serialized payload sizes, in bytes.
+  uint64_t byte_count {0};
+  // Recording timestamps of the first and last message of the topic, in
+  // nanoseconds. Both 0 when the topic holds no messages.
+  int64_t first_timestamp_ns {0};
+  int64_t last_timestamp_ns {0};
+};
+
+}  // namespace rosbag2_storage
+
+#endif  // ROSBAG2_STORAGE__TOPIC_STATISTICS_HPP_
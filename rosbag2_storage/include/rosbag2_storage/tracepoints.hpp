@@ -0,0 +1,47 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_STORAGE__TRACEPOINTS_HPP_
+#define ROSBAG2_STORAGE__TRACEPOINTS_HPP_
+
+/// \file
+/// Optional static tracepoints (USDT / SystemTap SDT) for the record and
+/// play hot paths.
+///
+/// All probes live under the "rosbag2" provider. When compiled in, an
+/// unattached probe costs a single nop; when the build flag is off the
+/// macros expand to nothing, so default builds are completely unaffected.
+/// Compile them in with the ROSBAG2_ENABLE_TRACEPOINTS cmake option of the
+/// instrumented packages, then attach with e.g.
+///
+///   perf probe -x librosbag2_cpp.so sdt_rosbag2:writer_cache_flush_begin
+///   bpftrace -l 'usdt:*:rosbag2:*'
+
+#if defined(ROSBAG2_WITH_TRACEPOINTS) && defined(__linux__)
+
+#include <sys/sdt.h>
+
+#define ROSBAG2_TRACEPOINT(probe) DTRACE_PROBE(rosbag2, probe)
+#define ROSBAG2_TRACEPOINT1(probe, arg1) DTRACE_PROBE1(rosbag2, probe, arg1)
+#define ROSBAG2_TRACEPOINT2(probe, arg1, arg2) DTRACE_PROBE2(rosbag2, probe, arg1, arg2)
+
+#else
+
+#define ROSBAG2_TRACEPOINT(probe) (void)0
+#define ROSBAG2_TRACEPOINT1(probe, arg1) (void)0
+#define ROSBAG2_TRACEPOINT2(probe, arg1, arg2) (void)0
+
+#endif
+
+#endif  // ROSBAG2_STORAGE__TRACEPOINTS_HPP_
@@ -0,0 +1,121 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_storage/crc32c.hpp"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ROSBAG2_STORAGE_CRC32C_X86 1
+#include <nmmintrin.h>
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+#define ROSBAG2_STORAGE_CRC32C_ARM 1
+#include <arm_acle.h>
+#endif
+
+namespace
+{
+
+// Reflected form of the Castagnoli polynomial, the one the SSE4.2 and ARMv8
+// CRC instructions implement.
+constexpr uint32_t CRC32C_POLYNOMIAL = 0x82f63b78u;
+
+const uint32_t * crc32c_table()
+{
+  static const uint32_t * const table = []() {
+      static uint32_t entries[256];
+      for (uint32_t i = 0; i < 256u; ++i) {
+        uint32_t value = i;
+        for (int bit = 0; bit < 8; ++bit) {
+          value = (value >> 1) ^ ((value & 1u) ? CRC32C_POLYNOMIAL : 0u);
+        }
+        entries[i] = value;
+      }
+      return entries;
+    }();
+  return table;
+}
+
+uint32_t crc32c_software(uint32_t crc, const uint8_t * bytes, size_t size)
+{
+  const auto * table = crc32c_table();
+  for (size_t i = 0; i < size; ++i) {
+    crc = (crc >> 8) ^ table[(crc ^ bytes[i]) & 0xffu];
+  }
+  return crc;
+}
+
+#if defined(ROSBAG2_STORAGE_CRC32C_X86)
+__attribute__((target("sse4.2")))
+uint32_t crc32c_hardware(uint32_t crc, const uint8_t * bytes, size_t size)
+{
+#if defined(__x86_64__)
+  while (size >= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    crc = static_cast<uint32_t>(_mm_crc32_u64(crc, word));
+    bytes += sizeof(word);
+    size -= sizeof(word);
+  }
+#endif
+  while (size > 0) {
+    crc = _mm_crc32_u8(crc, *bytes++);
+    --size;
+  }
+  return crc;
+}
+#elif defined(ROSBAG2_STORAGE_CRC32C_ARM)
+uint32_t crc32c_hardware(uint32_t crc, const uint8_t * bytes, size_t size)
+{
+  while (size >= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    crc = __crc32cd(crc, word);
+    bytes += sizeof(word);
+    size -= sizeof(word);
+  }
+  while (size > 0) {
+    crc = __crc32cb(crc, *bytes++);
+    --size;
+  }
+  return crc;
+}
+#endif
+
+}  // namespace
+
+namespace rosbag2_storage
+{
+
+uint32_t update_crc32c(uint32_t crc, const void * data, size_t size)
+{
+  const auto * bytes = static_cast<const uint8_t *>(data);
+  // The pre- and post-inversion make an all-zero prefix change the checksum
+  // and let the finalized value of one block seed the next, so incremental
+  // use chains like a single pass.
+  crc = ~crc;
+#if defined(ROSBAG2_STORAGE_CRC32C_X86)
+  static const bool has_crc_instructions = __builtin_cpu_supports("sse4.2");
+  if (has_crc_instructions) {
+    return ~crc32c_hardware(crc, bytes, size);
+  }
+#elif defined(ROSBAG2_STORAGE_CRC32C_ARM)
+  return ~crc32c_hardware(crc, bytes, size);
+#endif
+  return ~crc32c_software(crc, bytes, size);
+}
+
+}  // namespace rosbag2_storage
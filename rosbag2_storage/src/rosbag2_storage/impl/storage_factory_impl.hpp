@@ -18,7 +18,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "pluginlib/class_loader.hpp"
@@ -52,15 +54,10 @@ std::shared_ptr<InterfaceT>
 get_interface_instance(
   std::shared_ptr<pluginlib::ClassLoader<InterfaceT>> class_loader,
   const std::string & storage_id,
-  const std::string & uri)
+  const std::string & uri,
+  const std::string & storage_config_uri = "")
 {
-  const auto & registered_classes = class_loader->getDeclaredClasses();
-  auto class_exists = std::find(registered_classes.begin(), registered_classes.end(), storage_id);
-  if (class_exists == registered_classes.end()) {
-    ROSBAG2_STORAGE_LOG_DEBUG_STREAM("Requested storage id '" << storage_id << "' does not exist");
-    return nullptr;
-  }
-
+  // The caller has already established that the loader declares the class.
   std::shared_ptr<InterfaceT> instance = nullptr;
   try {
     auto unmanaged_instance = class_loader->createUnmanagedInstance(storage_id);
@@ -72,6 +69,9 @@ get_interface_instance(
   }
 
   try {
+    if (!storage_config_uri.empty()) {
+      instance->set_storage_config(storage_config_uri);
+    }
     instance->open(uri, flag);
     return instance;
   } catch (const std::runtime_error & ex) {
@@ -104,9 +104,14 @@ public:
   virtual ~StorageFactoryImpl() = default;
 
   std::shared_ptr<ReadWriteInterface> open_read_write(
-    const std::string & uri, const std::string & storage_id)
+    const std::string & uri, const std::string & storage_id,
+    const std::string & storage_config_uri = "")
   {
-    auto instance = get_interface_instance(read_write_class_loader_, storage_id, uri);
+    std::shared_ptr<ReadWriteInterface> instance = nullptr;
+    if (resolve_storage_id(storage_id).declared_read_write) {
+      instance =
+        get_interface_instance(read_write_class_loader_, storage_id, uri, storage_config_uri);
+    }
 
     if (instance == nullptr) {
       ROSBAG2_STORAGE_LOG_ERROR_STREAM(
@@ -117,14 +122,20 @@ public:
   }
 
   std::shared_ptr<ReadOnlyInterface> open_read_only(
-    const std::string & uri, const std::string & storage_id)
+    const std::string & uri, const std::string & storage_id,
+    const std::string & storage_config_uri = "")
   {
-    // try to load the instance as read_only interface
-    auto instance = get_interface_instance(read_only_class_loader_, storage_id, uri);
-    // try to load as read_write if not successful
-    if (instance == nullptr) {
+    const auto resolution = resolve_storage_id(storage_id);
+    std::shared_ptr<ReadOnlyInterface> instance = nullptr;
+    // Prefer the dedicated read_only registration, fall back to opening a
+    // read_write plugin read-only.
+    if (resolution.declared_read_only) {
+      instance =
+        get_interface_instance(read_only_class_loader_, storage_id, uri, storage_config_uri);
+    }
+    if (instance == nullptr && resolution.declared_read_write) {
       instance = get_interface_instance<ReadWriteInterface, storage_interfaces::IOFlag::READ_ONLY>(
-        read_write_class_loader_, storage_id, uri);
+        read_write_class_loader_, storage_id, uri, storage_config_uri);
     }
 
     if (instance == nullptr) {
@@ -135,9 +146,59 @@ public:
     return instance;
   }
 
+  std::vector<std::string> get_declared_read_write_storage_ids()
+  {
+    return read_write_class_loader_->getDeclaredClasses();
+  }
+
 private:
+  // Which of the two class loaders declare a storage id.
+  struct StorageIdResolution
+  {
+    bool declared_read_only {false};
+    bool declared_read_write {false};
+  };
+
+  /**
+   * Look up the storage id in pluginlib's declared classes, once: the scan
+   * walks every parsed plugin manifest and multifile playback opens the
+   * factory once per split file, so the resolution is cached per storage id.
+   * An id which is not declared at all is not cached, so a plugin installed
+   * while the factory is alive is still found later.
+   */
+  StorageIdResolution resolve_storage_id(const std::string & storage_id)
+  {
+    std::lock_guard<std::mutex> lock(resolution_cache_mutex_);
+    auto it = resolution_cache_.find(storage_id);
+    if (it != resolution_cache_.end()) {
+      return it->second;
+    }
+
+    StorageIdResolution resolution;
+    const auto read_only_classes = read_only_class_loader_->getDeclaredClasses();
+    resolution.declared_read_only =
+      std::find(read_only_classes.begin(), read_only_classes.end(), storage_id) !=
+      read_only_classes.end();
+    const auto read_write_classes = read_write_class_loader_->getDeclaredClasses();
+    resolution.declared_read_write =
+      std::find(read_write_classes.begin(), read_write_classes.end(), storage_id) !=
+      read_write_classes.end();
+
+    if (!resolution.declared_read_only && !resolution.declared_read_write) {
+      ROSBAG2_STORAGE_LOG_DEBUG_STREAM(
+        "Requested storage id '" << storage_id << "' does not exist");
+      return resolution;
+    }
+    resolution_cache_.emplace(storage_id, resolution);
+    return resolution;
+  }
+
   std::shared_ptr<pluginlib::ClassLoader<ReadWriteInterface>> read_write_class_loader_;
   std::shared_ptr<pluginlib::ClassLoader<ReadOnlyInterface>> read_only_class_loader_;
+  // Guards the cache; the reader preloads split files on a background
+  // thread while other opens may run concurrently.
+  std::mutex resolution_cache_mutex_;
+  std::unordered_map<std::string, StorageIdResolution> resolution_cache_;
 };
 
 }  // namespace rosbag2_storage
@@ -14,7 +14,11 @@
 
 #include "rosbag2_storage/metadata_io.hpp"
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -22,6 +26,7 @@
 
 #include "rcutils/filesystem.h"
 
+#include "rosbag2_storage/logging.hpp"
 #include "rosbag2_storage/topic_metadata.hpp"
 
 #ifdef _WIN32
@@ -96,6 +101,13 @@ struct convert<rosbag2_storage::TopicInformation>
     Node node;
     node["topic_metadata"] = metadata.topic_metadata;
     node["message_count"] = metadata.message_count;
+    node["dropped_message_count"] = metadata.dropped_message_count;
+    node["dropped_byte_count"] = metadata.dropped_byte_count;
+    node["rmw_lost_message_count"] = metadata.rmw_lost_message_count;
+    node["message_size_max"] = metadata.message_size_max;
+    node["message_size_p50"] = metadata.message_size_p50;
+    node["message_size_p90"] = metadata.message_size_p90;
+    node["message_size_p99"] = metadata.message_size_p99;
     return node;
   }
 
@@ -104,6 +116,29 @@ struct convert<rosbag2_storage::TopicInformation>
     metadata.topic_metadata = decode_for_version<rosbag2_storage::TopicMetadata>(
       node["topic_metadata"], version);
     metadata.message_count = node["message_count"].as<uint64_t>();
+    if (version >= 5) {
+      metadata.dropped_message_count = node["dropped_message_count"].as<uint64_t>();
+      metadata.dropped_byte_count = node["dropped_byte_count"].as<uint64_t>();
+    } else {
+      metadata.dropped_message_count = 0;
+      metadata.dropped_byte_count = 0;
+    }
+    if (version >= 8) {
+      metadata.rmw_lost_message_count = node["rmw_lost_message_count"].as<uint64_t>();
+    } else {
+      metadata.rmw_lost_message_count = 0;
+    }
+    if (version >= 9) {
+      metadata.message_size_max = node["message_size_max"].as<uint64_t>();
+      metadata.message_size_p50 = node["message_size_p50"].as<uint64_t>();
+      metadata.message_size_p90 = node["message_size_p90"].as<uint64_t>();
+      metadata.message_size_p99 = node["message_size_p99"].as<uint64_t>();
+    } else {
+      metadata.message_size_max = 0;
+      metadata.message_size_p50 = 0;
+      metadata.message_size_p90 = 0;
+      metadata.message_size_p99 = 0;
+    }
     return true;
   }
 };
@@ -135,6 +170,28 @@ struct convert<std::vector<rosbag2_storage::TopicInformation>>
   }
 };
 
+template<>
+struct convert<rosbag2_storage::FileInformation>
+{
+  static Node encode(const rosbag2_storage::FileInformation & file_information)
+  {
+    Node node;
+    node["path"] = file_information.path;
+    node["starting_time"] = file_information.starting_time;
+    node["duration"] = file_information.duration;
+    return node;
+  }
+
+  static bool decode(const Node & node, rosbag2_storage::FileInformation & file_information)
+  {
+    file_information.path = node["path"].as<std::string>();
+    file_information.starting_time = node["starting_time"]
+      .as<std::chrono::time_point<std::chrono::high_resolution_clock>>();
+    file_information.duration = node["duration"].as<std::chrono::nanoseconds>();
+    return true;
+  }
+};
+
 template<>
 struct convert<std::chrono::nanoseconds>
 {
@@ -189,6 +246,12 @@ struct convert<rosbag2_storage::BagMetadata>
       node["compression_format"] = metadata.compression_format;
       node["compression_mode"] = metadata.compression_mode;
     }
+    if (metadata.version >= 6) {  // field introduced by storage sharding
+      node["storage_shard_count"] = metadata.storage_shard_count;
+    }
+    if (metadata.version >= 7) {  // field introduced by per-file time ranges
+      node["files"] = metadata.files;
+    }
     return node;
   }
 
@@ -209,6 +272,16 @@ struct convert<rosbag2_storage::BagMetadata>
       metadata.compression_format = node["compression_format"].as<std::string>();
       metadata.compression_mode = node["compression_mode"].as<std::string>();
     }
+    if (metadata.version >= 6) {  // field introduced by storage sharding
+      metadata.storage_shard_count = node["storage_shard_count"].as<uint64_t>();
+    } else {
+      metadata.storage_shard_count = 1;
+    }
+    if (metadata.version >= 7) {  // field introduced by per-file time ranges
+      metadata.files = node["files"].as<std::vector<rosbag2_storage::FileInformation>>();
+    } else {
+      metadata.files.clear();
+    }
     return true;
   }
 };
@@ -218,24 +291,337 @@ struct convert<rosbag2_storage::BagMetadata>
 namespace rosbag2_storage
 {
 
+namespace
+{
+// Layout of the binary metadata sidecar: magic, sidecar format version,
+// size of the metadata.yaml it was written next to (used to detect stale
+// sidecars after hand-edits of the YAML), then the BagMetadata fields in
+// declaration order. Integers are fixed-width native-endian and strings are
+// length-prefixed; the sidecar is regenerated with the bag it describes and
+// never exchanged between machines on its own.
+constexpr char kSidecarMagic[4] = {'R', 'B', '2', 'M'};
+constexpr uint32_t kSidecarFormatVersion = 3;
+
+void append_u64(std::string & out, uint64_t value)
+{
+  out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void append_i64(std::string & out, int64_t value)
+{
+  out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void append_string(std::string & out, const std::string & value)
+{
+  append_u64(out, value.size());
+  out.append(value);
+}
+
+// Bounds-checked cursor over the mapped sidecar contents. Any truncation or
+// corruption throws, which the caller turns into a YAML fallback.
+class SidecarCursor
+{
+public:
+  SidecarCursor(const char * data, size_t size)
+  : data_(data), remaining_(size) {}
+
+  void read_raw(void * destination, size_t size)
+  {
+    if (size > remaining_) {
+      throw std::runtime_error("metadata sidecar is truncated");
+    }
+    memcpy(destination, data_, size);
+    data_ += size;
+    remaining_ -= size;
+  }
+
+  uint64_t read_u64()
+  {
+    uint64_t value = 0;
+    read_raw(&value, sizeof(value));
+    return value;
+  }
+
+  int64_t read_i64()
+  {
+    int64_t value = 0;
+    read_raw(&value, sizeof(value));
+    return value;
+  }
+
+  std::string read_string()
+  {
+    auto size = read_u64();
+    if (size > remaining_) {
+      throw std::runtime_error("metadata sidecar is truncated");
+    }
+    std::string value(data_, size);
+    data_ += size;
+    remaining_ -= size;
+    return value;
+  }
+
+  bool exhausted() const
+  {
+    return remaining_ == 0;
+  }
+
+private:
+  const char * data_;
+  size_t remaining_;
+};
+
+// Streaming counterparts of the YAML::convert<> encode functions above.
+// Emitting straight into the output stream keeps metadata writing at
+// constant memory instead of materializing a YAML::Node tree whose size
+// grows with the topic and split counts.
+void emit_topic_information(YAML::Emitter & out, const TopicInformation & topic)
+{
+  out << YAML::BeginMap;
+  out << YAML::Key << "topic_metadata" << YAML::Value << YAML::BeginMap;
+  out << YAML::Key << "name" << YAML::Value << topic.topic_metadata.name;
+  out << YAML::Key << "type" << YAML::Value << topic.topic_metadata.type;
+  out << YAML::Key << "serialization_format" << YAML::Value <<
+    topic.topic_metadata.serialization_format;
+  out << YAML::Key << "offered_qos_profiles" << YAML::Value <<
+    topic.topic_metadata.offered_qos_profiles;
+  out << YAML::EndMap;
+  out << YAML::Key << "message_count" << YAML::Value << topic.message_count;
+  out << YAML::Key << "dropped_message_count" << YAML::Value << topic.dropped_message_count;
+  out << YAML::Key << "dropped_byte_count" << YAML::Value << topic.dropped_byte_count;
+  out << YAML::Key << "rmw_lost_message_count" << YAML::Value << topic.rmw_lost_message_count;
+  out << YAML::Key << "message_size_max" << YAML::Value << topic.message_size_max;
+  out << YAML::Key << "message_size_p50" << YAML::Value << topic.message_size_p50;
+  out << YAML::Key << "message_size_p90" << YAML::Value << topic.message_size_p90;
+  out << YAML::Key << "message_size_p99" << YAML::Value << topic.message_size_p99;
+  out << YAML::EndMap;
+}
+
+void emit_bag_metadata(YAML::Emitter & out, const BagMetadata & metadata)
+{
+  out << YAML::BeginMap;
+  out << YAML::Key << "version" << YAML::Value << metadata.version;
+  out << YAML::Key << "storage_identifier" << YAML::Value << metadata.storage_identifier;
+  out << YAML::Key << "relative_file_paths" << YAML::Value << YAML::BeginSeq;
+  for (const auto & path : metadata.relative_file_paths) {
+    out << path;
+  }
+  out << YAML::EndSeq;
+  out << YAML::Key << "duration" << YAML::Value << YAML::BeginMap;
+  out << YAML::Key << "nanoseconds" << YAML::Value << metadata.duration.count();
+  out << YAML::EndMap;
+  out << YAML::Key << "starting_time" << YAML::Value << YAML::BeginMap;
+  out << YAML::Key << "nanoseconds_since_epoch" << YAML::Value <<
+    metadata.starting_time.time_since_epoch().count();
+  out << YAML::EndMap;
+  out << YAML::Key << "message_count" << YAML::Value << metadata.message_count;
+  out << YAML::Key << "topics_with_message_count" << YAML::Value << YAML::BeginSeq;
+  for (const auto & topic : metadata.topics_with_message_count) {
+    emit_topic_information(out, topic);
+  }
+  out << YAML::EndSeq;
+  if (metadata.version >= 3) {  // fields introduced by rosbag2_compression
+    out << YAML::Key << "compression_format" << YAML::Value << metadata.compression_format;
+    out << YAML::Key << "compression_mode" << YAML::Value << metadata.compression_mode;
+  }
+  if (metadata.version >= 6) {  // field introduced by storage sharding
+    out << YAML::Key << "storage_shard_count" << YAML::Value << metadata.storage_shard_count;
+  }
+  if (metadata.version >= 7) {  // field introduced by per-file time ranges
+    out << YAML::Key << "files" << YAML::Value << YAML::BeginSeq;
+    for (const auto & file : metadata.files) {
+      out << YAML::BeginMap;
+      out << YAML::Key << "path" << YAML::Value << file.path;
+      out << YAML::Key << "starting_time" << YAML::Value << YAML::BeginMap;
+      out << YAML::Key << "nanoseconds_since_epoch" << YAML::Value <<
+        file.starting_time.time_since_epoch().count();
+      out << YAML::EndMap;
+      out << YAML::Key << "duration" << YAML::Value << YAML::BeginMap;
+      out << YAML::Key << "nanoseconds" << YAML::Value << file.duration.count();
+      out << YAML::EndMap;
+      out << YAML::EndMap;
+    }
+    out << YAML::EndSeq;
+  }
+  out << YAML::EndMap;
+}
+}  // namespace
+
 void MetadataIo::write_metadata(const std::string & uri, const BagMetadata & metadata)
 {
-  YAML::Node metadata_node;
-  metadata_node["rosbag2_bagfile_information"] = metadata;
   std::ofstream fout(get_metadata_file_name(uri));
-  fout << metadata_node;
+  // Bind the emitter to the stream so the document is written out as it is
+  // produced, without building the whole node tree in memory first.
+  YAML::Emitter yaml_emitter(fout);
+  yaml_emitter << YAML::BeginMap;
+  yaml_emitter << YAML::Key << "rosbag2_bagfile_information" << YAML::Value;
+  emit_bag_metadata(yaml_emitter, metadata);
+  yaml_emitter << YAML::EndMap;
+  fout.close();
+  write_sidecar(uri, metadata);
 }
 
 BagMetadata MetadataIo::read_metadata(const std::string & uri)
 {
+  BagMetadata metadata{};
+  if (!read_sidecar(uri, metadata)) {
+    try {
+      YAML::Node yaml_file = YAML::LoadFile(get_metadata_file_name(uri));
+      metadata = yaml_file["rosbag2_bagfile_information"].as<rosbag2_storage::BagMetadata>();
+    } catch (const YAML::Exception & ex) {
+      throw std::runtime_error(std::string("Exception on parsing info file: ") + ex.what());
+    }
+  }
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  metadata.bag_size = rcutils_calculate_directory_size(uri.c_str(), allocator);
+  return metadata;
+}
+
+void MetadataIo::write_sidecar(const std::string & uri, const BagMetadata & metadata)
+{
+  std::string buffer;
+  buffer.append(kSidecarMagic, sizeof(kSidecarMagic));
+  auto format_version = kSidecarFormatVersion;
+  buffer.append(reinterpret_cast<const char *>(&format_version), sizeof(format_version));
+  append_u64(buffer, rcpputils::fs::path(get_metadata_file_name(uri)).file_size());
+
+  append_i64(buffer, metadata.version);
+  append_string(buffer, metadata.storage_identifier);
+  append_u64(buffer, metadata.relative_file_paths.size());
+  for (const auto & path : metadata.relative_file_paths) {
+    append_string(buffer, path);
+  }
+  append_i64(buffer, metadata.duration.count());
+  append_i64(buffer, metadata.starting_time.time_since_epoch().count());
+  append_u64(buffer, metadata.message_count);
+  append_u64(buffer, metadata.topics_with_message_count.size());
+  for (const auto & topic : metadata.topics_with_message_count) {
+    append_string(buffer, topic.topic_metadata.name);
+    append_string(buffer, topic.topic_metadata.type);
+    append_string(buffer, topic.topic_metadata.serialization_format);
+    append_string(buffer, topic.topic_metadata.offered_qos_profiles);
+    append_u64(buffer, topic.message_count);
+    append_u64(buffer, topic.dropped_message_count);
+    append_u64(buffer, topic.dropped_byte_count);
+    append_u64(buffer, topic.rmw_lost_message_count);
+    append_u64(buffer, topic.message_size_max);
+    append_u64(buffer, topic.message_size_p50);
+    append_u64(buffer, topic.message_size_p90);
+    append_u64(buffer, topic.message_size_p99);
+  }
+  append_string(buffer, metadata.compression_format);
+  append_string(buffer, metadata.compression_mode);
+  append_u64(buffer, metadata.storage_shard_count);
+  append_u64(buffer, metadata.files.size());
+  for (const auto & file : metadata.files) {
+    append_string(buffer, file.path);
+    append_i64(buffer, file.starting_time.time_since_epoch().count());
+    append_i64(buffer, file.duration.count());
+  }
+
+  std::ofstream fout(get_sidecar_file_name(uri), std::ios::binary | std::ios::trunc);
+  fout.write(buffer.data(), buffer.size());
+  if (!fout) {
+    // The sidecar is a pure accelerator; the YAML remains authoritative.
+    ROSBAG2_STORAGE_LOG_WARN_STREAM(
+      "Could not write metadata sidecar '" << get_sidecar_file_name(uri) << "'.");
+  }
+}
+
+bool MetadataIo::read_sidecar(const std::string & uri, BagMetadata & metadata)
+{
+  std::ifstream fin(get_sidecar_file_name(uri), std::ios::binary);
+  if (!fin) {
+    return false;
+  }
+  std::string buffer(
+    (std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
   try {
-    YAML::Node yaml_file = YAML::LoadFile(get_metadata_file_name(uri));
-    auto metadata = yaml_file["rosbag2_bagfile_information"].as<rosbag2_storage::BagMetadata>();
-    rcutils_allocator_t allocator = rcutils_get_default_allocator();
-    metadata.bag_size = rcutils_calculate_directory_size(uri.c_str(), allocator);
-    return metadata;
-  } catch (const YAML::Exception & ex) {
-    throw std::runtime_error(std::string("Exception on parsing info file: ") + ex.what());
+    SidecarCursor cursor(buffer.data(), buffer.size());
+    char magic[sizeof(kSidecarMagic)];
+    cursor.read_raw(magic, sizeof(magic));
+    uint32_t format_version = 0;
+    cursor.read_raw(&format_version, sizeof(format_version));
+    if (memcmp(magic, kSidecarMagic, sizeof(kSidecarMagic)) != 0 ||
+      format_version != kSidecarFormatVersion)
+    {
+      return false;
+    }
+    if (cursor.read_u64() != rcpputils::fs::path(get_metadata_file_name(uri)).file_size()) {
+      // The YAML was rewritten (likely by hand) since the sidecar was
+      // generated; trust the YAML instead.
+      return false;
+    }
+
+    metadata.version = static_cast<int>(cursor.read_i64());
+    metadata.storage_identifier = cursor.read_string();
+    metadata.relative_file_paths.resize(cursor.read_u64());
+    for (auto & path : metadata.relative_file_paths) {
+      path = cursor.read_string();
+    }
+    metadata.duration = std::chrono::nanoseconds(cursor.read_i64());
+    metadata.starting_time = std::chrono::time_point<std::chrono::high_resolution_clock>(
+      std::chrono::nanoseconds(cursor.read_i64()));
+    metadata.message_count = cursor.read_u64();
+    metadata.topics_with_message_count.resize(cursor.read_u64());
+    for (auto & topic : metadata.topics_with_message_count) {
+      topic.topic_metadata.name = cursor.read_string();
+      topic.topic_metadata.type = cursor.read_string();
+      topic.topic_metadata.serialization_format = cursor.read_string();
+      topic.topic_metadata.offered_qos_profiles = cursor.read_string();
+      topic.message_count = cursor.read_u64();
+      topic.dropped_message_count = cursor.read_u64();
+      topic.dropped_byte_count = cursor.read_u64();
+      topic.rmw_lost_message_count = cursor.read_u64();
+      topic.message_size_max = cursor.read_u64();
+      topic.message_size_p50 = cursor.read_u64();
+      topic.message_size_p90 = cursor.read_u64();
+      topic.message_size_p99 = cursor.read_u64();
+    }
+    metadata.compression_format = cursor.read_string();
+    metadata.compression_mode = cursor.read_string();
+    metadata.storage_shard_count = cursor.read_u64();
+    metadata.files.resize(cursor.read_u64());
+    for (auto & file : metadata.files) {
+      file.path = cursor.read_string();
+      file.starting_time = std::chrono::time_point<std::chrono::high_resolution_clock>(
+        std::chrono::nanoseconds(cursor.read_i64()));
+      file.duration = std::chrono::nanoseconds(cursor.read_i64());
+    }
+
+    // Apply the same version gating as the YAML decoder so both paths
+    // return identical metadata for bags recorded with older versions.
+    for (auto & topic : metadata.topics_with_message_count) {
+      if (metadata.version < 4) {
+        topic.topic_metadata.offered_qos_profiles = "";
+      }
+      if (metadata.version < 5) {
+        topic.dropped_message_count = 0;
+        topic.dropped_byte_count = 0;
+      }
+      if (metadata.version < 8) {
+        topic.rmw_lost_message_count = 0;
+      }
+      if (metadata.version < 9) {
+        topic.message_size_max = 0;
+        topic.message_size_p50 = 0;
+        topic.message_size_p90 = 0;
+        topic.message_size_p99 = 0;
+      }
+    }
+    if (metadata.version < 6) {
+      metadata.storage_shard_count = 1;
+    }
+    if (metadata.version < 7) {
+      metadata.files.clear();
+    }
+    return cursor.exhausted();
+  } catch (const std::exception &) {
+    // Truncated or corrupt sidecar (including absurd element counts that
+    // fail to allocate); fall back to the YAML.
+    return false;
   }
 }
 
@@ -246,6 +632,11 @@ std::string MetadataIo::get_metadata_file_name(const std::string & uri)
   return metadata_file;
 }
 
+std::string MetadataIo::get_sidecar_file_name(const std::string & uri)
+{
+  return (rcpputils::fs::path(uri) / metadata_sidecar_filename).string();
+}
+
 bool MetadataIo::metadata_file_exists(const std::string & uri)
 {
   return rcpputils::fs::path(get_metadata_file_name(uri)).exists();
@@ -15,7 +15,10 @@
 #include "rosbag2_storage/ros_helper.hpp"
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "rcutils/types.h"
 #include "rosbag2_storage/logging.hpp"
@@ -23,7 +26,118 @@
 namespace rosbag2_storage
 {
 
-static rcutils_allocator_t allocator = rcutils_get_default_allocator();
+namespace
+{
+
+// Allocator for freshly created payload buffers, injectable process-wide
+// through set_serialized_message_allocator(). Each buffer records the
+// allocator it was created with, so freeing stays matched even across a
+// change. The mutex only guards the rare pool-miss allocation and the
+// setter, not the pooled fast path.
+std::mutex allocator_mutex;
+rcutils_allocator_t payload_allocator = rcutils_get_default_allocator();
+
+// Buffers above this size are not retained in the pool; such payloads are
+// rare and retaining them would pin too much memory.
+constexpr size_t MAX_POOLED_BUFFER_SIZE = 4u * 1024u * 1024u;
+
+// Maximum number of free buffers retained per capacity bucket.
+constexpr size_t MAX_FREE_BUFFERS_PER_BUCKET = 64u;
+
+/**
+ * Recycles message payload buffers across make_empty_serialized_message()
+ * calls. Message sizes repeat heavily in recording workloads (fixed-size
+ * sensor messages), so free buffers are bucketed by their exact capacity;
+ * this keeps the buffer_capacity == requested size contract intact while
+ * avoiding a heap allocation per message in the hot path.
+ */
+class SerializedMessagePool
+{
+public:
+  ~SerializedMessagePool()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto & bucket : free_buffers_) {
+      for (auto msg : bucket.second) {
+        destroy(msg);
+      }
+    }
+  }
+
+  rcutils_uint8_array_t * acquire(size_t size)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto bucket = free_buffers_.find(size);
+      if (bucket != free_buffers_.end() && !bucket->second.empty()) {
+        auto msg = bucket->second.back();
+        bucket->second.pop_back();
+        msg->buffer_length = 0u;
+        return msg;
+      }
+    }
+
+    auto allocator = get_serialized_message_allocator();
+    auto msg = new rcutils_uint8_array_t;
+    *msg = rcutils_get_zero_initialized_uint8_array();
+    auto ret = rcutils_uint8_array_init(msg, size, &allocator);
+    if (ret != RCUTILS_RET_OK) {
+      delete msg;
+      throw std::runtime_error(
+              "Error allocating resources for serialized message: " +
+              std::string(rcutils_get_error_string().str));
+    }
+    return msg;
+  }
+
+  // Frees every retained buffer; used when the payload allocator changes so
+  // all buffers served afterwards come from the new allocator.
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto & bucket : free_buffers_) {
+      for (auto msg : bucket.second) {
+        destroy(msg);
+      }
+    }
+    free_buffers_.clear();
+  }
+
+  void release(rcutils_uint8_array_t * msg)
+  {
+    if (msg->buffer_capacity <= MAX_POOLED_BUFFER_SIZE) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto & bucket = free_buffers_[msg->buffer_capacity];
+      if (bucket.size() < MAX_FREE_BUFFERS_PER_BUCKET) {
+        bucket.push_back(msg);
+        return;
+      }
+    }
+    destroy(msg);
+  }
+
+private:
+  void destroy(rcutils_uint8_array_t * msg)
+  {
+    int error = rcutils_uint8_array_fini(msg);
+    delete msg;
+    if (error != RCUTILS_RET_OK) {
+      ROSBAG2_STORAGE_LOG_ERROR_STREAM(
+        "Leaking memory. Error: " << rcutils_get_error_string().str);
+    }
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<size_t, std::vector<rcutils_uint8_array_t *>> free_buffers_;
+};
+
+SerializedMessagePool & serialized_message_pool()
+{
+  static SerializedMessagePool pool;
+  return pool;
+}
+
+}  // namespace
 
 std::shared_ptr<rcutils_uint8_array_t>
 make_serialized_message(const void * data, size_t size)
@@ -38,27 +152,32 @@ make_serialized_message(const void * data, size_t size)
 std::shared_ptr<rcutils_uint8_array_t>
 make_empty_serialized_message(size_t size)
 {
-  auto msg = new rcutils_uint8_array_t;
-  *msg = rcutils_get_zero_initialized_uint8_array();
-  auto ret = rcutils_uint8_array_init(msg, size, &allocator);
-  if (ret != RCUTILS_RET_OK) {
-    throw std::runtime_error(
-            "Error allocating resources for serialized message: " +
-            std::string(rcutils_get_error_string().str));
-  }
+  auto msg = serialized_message_pool().acquire(size);
 
   auto serialized_message = std::shared_ptr<rcutils_uint8_array_t>(
     msg,
     [](rcutils_uint8_array_t * msg) {
-      int error = rcutils_uint8_array_fini(msg);
-      delete msg;
-      if (error != RCUTILS_RET_OK) {
-        ROSBAG2_STORAGE_LOG_ERROR_STREAM(
-          "Leaking memory. Error: " << rcutils_get_error_string().str);
-      }
+      serialized_message_pool().release(msg);
     });
 
   return serialized_message;
 }
 
+void set_serialized_message_allocator(const rcutils_allocator_t & allocator)
+{
+  {
+    std::lock_guard<std::mutex> lock(allocator_mutex);
+    payload_allocator = allocator;
+  }
+  // Retained buffers were created by the previous allocator; drop them so
+  // every buffer served from here on comes from the injected one.
+  serialized_message_pool().clear();
+}
+
+rcutils_allocator_t get_serialized_message_allocator()
+{
+  std::lock_guard<std::mutex> lock(allocator_mutex);
+  return payload_allocator;
+}
+
 }  // namespace rosbag2_storage
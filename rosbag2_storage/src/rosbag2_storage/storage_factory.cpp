@@ -17,6 +17,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rosbag2_storage/storage_interfaces/read_only_interface.hpp"
 #include "rosbag2_storage/storage_interfaces/read_write_interface.hpp"
@@ -47,4 +48,23 @@ std::shared_ptr<ReadWriteInterface> StorageFactory::open_read_write(
 {
   return impl_->open_read_write(uri, storage_id);
 }
+
+std::shared_ptr<ReadOnlyInterface> StorageFactory::open_read_only(
+  const std::string & uri, const std::string & storage_id,
+  const std::string & storage_config_uri)
+{
+  return impl_->open_read_only(uri, storage_id, storage_config_uri);
+}
+
+std::shared_ptr<ReadWriteInterface> StorageFactory::open_read_write(
+  const std::string & uri, const std::string & storage_id,
+  const std::string & storage_config_uri)
+{
+  return impl_->open_read_write(uri, storage_id, storage_config_uri);
+}
+
+std::vector<std::string> StorageFactory::get_declared_read_write_storage_ids()
+{
+  return impl_->get_declared_read_write_storage_ids();
+}
 }  // namespace rosbag2_storage
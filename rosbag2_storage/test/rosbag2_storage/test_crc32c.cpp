@@ -0,0 +1,50 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+
+#include <string>
+#include <vector>
+
+#include "rosbag2_storage/crc32c.hpp"
+
+using rosbag2_storage::update_crc32c;
+
+TEST(Crc32cTest, matches_the_reference_check_value) {
+  // The standard CRC32C check vector from RFC 3720.
+  const std::string data = "123456789";
+  EXPECT_EQ(0xe3069283u, update_crc32c(0, data.data(), data.size()));
+}
+
+TEST(Crc32cTest, all_zero_data_yields_a_nonzero_checksum) {
+  const std::vector<uint8_t> zeros(32, 0u);
+  EXPECT_NE(0u, update_crc32c(0, zeros.data(), zeros.size()));
+}
+
+TEST(Crc32cTest, incremental_updates_chain_like_a_single_pass) {
+  const std::string data = "The quick brown fox jumps over the lazy dog";
+  const auto whole = update_crc32c(0, data.data(), data.size());
+
+  for (size_t split = 0; split <= data.size(); ++split) {
+    auto crc = update_crc32c(0, data.data(), split);
+    crc = update_crc32c(crc, data.data() + split, data.size() - split);
+    EXPECT_EQ(whole, crc) << "split at " << split;
+  }
+}
+
+TEST(Crc32cTest, empty_block_leaves_the_checksum_unchanged) {
+  const std::string data = "payload";
+  const auto crc = update_crc32c(0, data.data(), data.size());
+  EXPECT_EQ(crc, update_crc32c(crc, data.data(), 0));
+}
@@ -94,6 +94,64 @@ TEST_F(MetadataFixture, test_writing_and_reading_yaml)
   EXPECT_THAT(actual_second_topic.message_count, Eq(expected_second_topic.message_count));
 }
 
+TEST_F(MetadataFixture, metadata_roundtrips_message_size_summary)
+{
+  BagMetadata metadata{};
+  metadata.storage_identifier = "sqlite3";
+  metadata.relative_file_paths.emplace_back("some_relative_path");
+  metadata.message_count = 100;
+  TopicInformation topic{};
+  topic.topic_metadata = {"topic", "type", "rmw", "qos"};
+  topic.message_count = 100;
+  topic.message_size_max = 4000;
+  topic.message_size_p50 = 127;
+  topic.message_size_p90 = 1023;
+  topic.message_size_p99 = 2047;
+  metadata.topics_with_message_count.push_back(topic);
+
+  metadata_io_->write_metadata(temporary_dir_path_, metadata);
+  auto read_metadata = metadata_io_->read_metadata(temporary_dir_path_);
+
+  ASSERT_THAT(read_metadata.topics_with_message_count, SizeIs(1u));
+  auto actual_topic = read_metadata.topics_with_message_count[0];
+  EXPECT_THAT(actual_topic.message_size_max, Eq(topic.message_size_max));
+  EXPECT_THAT(actual_topic.message_size_p50, Eq(topic.message_size_p50));
+  EXPECT_THAT(actual_topic.message_size_p90, Eq(topic.message_size_p90));
+  EXPECT_THAT(actual_topic.message_size_p99, Eq(topic.message_size_p99));
+}
+
+TEST_F(MetadataFixture, corrupt_sidecar_falls_back_to_yaml)
+{
+  BagMetadata metadata{};
+  metadata.version = 4;
+  metadata.storage_identifier = "sqlite3";
+  metadata.relative_file_paths.emplace_back("some_relative_path");
+  metadata.duration = std::chrono::nanoseconds(100);
+  metadata.starting_time =
+    std::chrono::time_point<std::chrono::high_resolution_clock>(std::chrono::nanoseconds(1000000));
+  metadata.message_count = 50;
+  metadata.topics_with_message_count.push_back({{"topic1", "type1", "rmw1", "qos1"}, 100});
+
+  metadata_io_->write_metadata(temporary_dir_path_, metadata);
+  // Truncate the binary sidecar; reading must fall back to the YAML.
+  std::ofstream corrupt(
+    temporary_dir_path_ + "/" + MetadataIo::metadata_sidecar_filename,
+    std::ios::binary | std::ios::trunc);
+  corrupt << "RB2M";
+  corrupt.close();
+
+  auto read_metadata = metadata_io_->read_metadata(temporary_dir_path_);
+  EXPECT_THAT(read_metadata.storage_identifier, Eq(metadata.storage_identifier));
+  EXPECT_THAT(read_metadata.relative_file_paths, Eq(metadata.relative_file_paths));
+  EXPECT_THAT(read_metadata.message_count, Eq(metadata.message_count));
+  ASSERT_THAT(
+    read_metadata.topics_with_message_count,
+    SizeIs(metadata.topics_with_message_count.size()));
+  EXPECT_THAT(
+    read_metadata.topics_with_message_count[0].topic_metadata.name,
+    Eq(metadata.topics_with_message_count[0].topic_metadata.name));
+}
+
 TEST_F(MetadataFixture, metadata_reads_v3_check_offered_qos_profiles_empty)
 {
   // Make sure that when reading a v3 metadata, the deserialization
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <gmock/gmock.h>
+#include <cstdlib>
 #include <memory>
 
 #include "rosbag2_storage/ros_helper.hpp"
@@ -41,3 +42,73 @@ TEST(ros_helper, make_empty_serialized_message_is_correctly_built) {
   ASSERT_THAT(empty_serialized_message->buffer_length, Eq(0u));
   ASSERT_THAT(empty_serialized_message->buffer_capacity, Eq(size));
 }
+
+namespace
+{
+
+struct AllocationCounter
+{
+  size_t allocations = 0;
+  size_t deallocations = 0;
+};
+
+void * counting_allocate(size_t size, void * state)
+{
+  static_cast<AllocationCounter *>(state)->allocations++;
+  return std::malloc(size);
+}
+
+void counting_deallocate(void * pointer, void * state)
+{
+  static_cast<AllocationCounter *>(state)->deallocations++;
+  std::free(pointer);
+}
+
+void * counting_reallocate(void * pointer, size_t size, void * state)
+{
+  static_cast<AllocationCounter *>(state)->allocations++;
+  return std::realloc(pointer, size);
+}
+
+void * counting_zero_allocate(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  static_cast<AllocationCounter *>(state)->allocations++;
+  return std::calloc(number_of_elements, size_of_element);
+}
+
+}  // namespace
+
+TEST(ros_helper, injected_allocator_is_used_for_new_buffers) {
+  const auto previous_allocator = rosbag2_storage::get_serialized_message_allocator();
+  AllocationCounter counter;
+  auto counting_allocator = rcutils_get_default_allocator();
+  counting_allocator.allocate = counting_allocate;
+  counting_allocator.deallocate = counting_deallocate;
+  counting_allocator.reallocate = counting_reallocate;
+  counting_allocator.zero_allocate = counting_zero_allocate;
+  counting_allocator.state = &counter;
+
+  rosbag2_storage::set_serialized_message_allocator(counting_allocator);
+  {
+    auto message = rosbag2_storage::make_empty_serialized_message(17u);
+    EXPECT_THAT(counter.allocations, Eq(1u));
+  }
+  // Restoring the allocator flushes the pool, which must free the buffer
+  // through the allocator it was created with.
+  rosbag2_storage::set_serialized_message_allocator(previous_allocator);
+  EXPECT_THAT(counter.deallocations, Eq(1u));
+}
+
+TEST(ros_helper, released_message_buffers_are_recycled) {
+  auto size = 1024u;
+
+  auto first_message = rosbag2_storage::make_empty_serialized_message(size);
+  auto buffer = first_message->buffer;
+  first_message.reset();
+
+  auto second_message = rosbag2_storage::make_empty_serialized_message(size);
+
+  ASSERT_THAT(second_message->buffer, Eq(buffer));
+  ASSERT_THAT(second_message->buffer_length, Eq(0u));
+  ASSERT_THAT(second_message->buffer_capacity, Eq(size));
+}
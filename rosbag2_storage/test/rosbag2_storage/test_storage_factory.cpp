@@ -91,6 +91,22 @@ TEST_F(StorageFactoryTest, loads_readonly_plugin_only_for_read_only_storage) {
   ASSERT_EQ(nullptr, storage_for_reading_and_writing);
 }
 
+TEST_F(StorageFactoryTest, repeated_opens_resolve_from_cache) {
+  // The first open pays the declared-class scan; later opens of the same
+  // storage id resolve from the cache and must behave identically.
+  for (int i = 0; i < 3; ++i) {
+    auto read_write_storage = factory.open_read_write(bag_file_path, test_plugin_id);
+    ASSERT_NE(nullptr, read_write_storage);
+    auto read_only_storage = factory.open_read_only(bag_file_path, test_plugin_id);
+    ASSERT_NE(nullptr, read_only_storage);
+  }
+
+  // A read-only registration keeps refusing read_write opens when cached.
+  ASSERT_NE(nullptr, factory.open_read_only(bag_file_path, test_read_only_plugin_id));
+  EXPECT_EQ(nullptr, factory.open_read_write(bag_file_path, test_read_only_plugin_id));
+  EXPECT_EQ(nullptr, factory.open_read_write(bag_file_path, test_read_only_plugin_id));
+}
+
 TEST_F(StorageFactoryTest, load_unavailable_plugin) {
   auto instance_rw = factory.open_read_write(
     bag_file_path, test_unavailable_plugin_id);
@@ -39,6 +39,20 @@
 namespace rosbag2_storage_plugins
 {
 
+/**
+ * Non-owning view of a BLOB column, lent out by the statement.
+ * The pointed-to memory belongs to sqlite and is only valid until the next
+ * step of the owning statement (i.e. until the result iterator is
+ * incremented) or its reset. Callers which keep the data must copy it, e.g.
+ * through rosbag2_storage::make_serialized_message(), which recycles
+ * destination buffers; iterating this way does no allocation per row.
+ */
+struct SqliteBorrowedBlob
+{
+  const void * data {nullptr};
+  size_t size {0u};
+};
+
 class ROSBAG2_STORAGE_DEFAULT_PLUGINS_PUBLIC SqliteStatementWrapper
   : public std::enable_shared_from_this<SqliteStatementWrapper>
 {
@@ -187,8 +201,25 @@ private:
   std::shared_ptr<SqliteStatementWrapper> bind(rcutils_time_point_value_t value);
   std::shared_ptr<SqliteStatementWrapper> bind(double value);
   std::shared_ptr<SqliteStatementWrapper> bind(const std::string & value);
+
+  /**
+   * Bind a message blob without copying it: the buffer is handed to sqlite
+   * with static lifetime (SQLITE_STATIC), so sqlite reads it in place when
+   * the statement is stepped instead of memcpy'ing every recorded byte at
+   * bind time. The statement keeps a reference to the array until reset()
+   * (which execute_and_reset() calls after stepping), which is the
+   * ownership contract making the static lifetime safe.
+   */
   std::shared_ptr<SqliteStatementWrapper> bind(std::shared_ptr<rcutils_uint8_array_t> value);
 
+  /**
+   * Bind a message blob with static lifetime without taking ownership:
+   * unlike the shared_ptr overload no reference is cached, so the caller
+   * must guarantee the array outlives the statement execution. Used on the
+   * span batch write path where the batch lifetime spans the whole call.
+   */
+  std::shared_ptr<SqliteStatementWrapper> bind(const rcutils_uint8_array_t * value);
+
   std::shared_ptr<SqliteStatementWrapper> reset();
 
 private:
@@ -200,6 +231,7 @@ private:
   void obtain_column_value(size_t index, double & value) const;
   void obtain_column_value(size_t index, std::string & value) const;
   void obtain_column_value(size_t index, std::shared_ptr<rcutils_uint8_array_t> & value) const;
+  void obtain_column_value(size_t index, SqliteBorrowedBlob & value) const;
 
   template<typename T>
   void check_and_report_bind_error(int return_code, T value);
@@ -207,6 +239,8 @@ private:
 
   sqlite3_stmt * statement_;
   int last_bound_parameter_index_;
+  // Keeps every blob bound with static lifetime alive until reset(); see
+  // bind(std::shared_ptr<rcutils_uint8_array_t>).
   std::vector<std::shared_ptr<rcutils_uint8_array_t>> written_blobs_cache_;
 };
 
@@ -16,8 +16,13 @@
 #define ROSBAG2_STORAGE_DEFAULT_PLUGINS__SQLITE__SQLITE_STORAGE_HPP_
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -63,14 +68,28 @@ public:
     const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> & messages)
   override;
 
+  void write(const rosbag2_storage::SerializedBagMessageSpan & messages) override;
+
   bool has_next() override;
 
   std::shared_ptr<rosbag2_storage::SerializedBagMessage> read_next() override;
 
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> read_next_batch(
+    size_t max_batch_size) override;
+
+  void seek(rcutils_time_point_value_t timestamp) override;
+
+  void set_read_order(rosbag2_storage::ReadOrder read_order) override;
+
   std::vector<rosbag2_storage::TopicMetadata> get_all_topics_and_types() override;
 
   rosbag2_storage::BagMetadata get_metadata() override;
 
+  // Per-topic count, byte sum and time span in one aggregated query over
+  // the messages table; LENGTH() only reads the record header, so no
+  // payload is materialized.
+  std::vector<rosbag2_storage::TopicStatistics> get_topic_statistics() override;
+
   std::string get_relative_file_path() const override;
 
   uint64_t get_bagfile_size() const override;
@@ -83,28 +102,218 @@ public:
 
   void reset_filter() override;
 
+  void set_storage_config(const std::string & storage_config_uri) override;
+
+  void preallocate(uint64_t expected_file_size) override;
+
+  rosbag2_storage::IOStatistics get_io_statistics() const override;
+
 private:
+  // Per-topic aggregates maintained on every write so metadata lookups do
+  // not scan the messages table.
+  struct TopicStats
+  {
+    uint64_t message_count;
+    rcutils_time_point_value_t min_timestamp;
+    rcutils_time_point_value_t max_timestamp;
+  };
+
   void initialize();
+  void finalize_indices();
+  void optimize_for_archival();
+  void track_written_message(const rosbag2_storage::SerializedBagMessage & message);
+  void persist_topic_stats();
+  bool read_topic_stats_from_summary();
+  void apply_storage_config();
+  void start_checkpoint_thread();
+  void stop_checkpoint_thread();
+  void checkpoint_thread_loop();
+  // One durability barrier under the async policy: records the newest
+  // visible timestamp in the durability_horizon table, checkpoints the WAL
+  // and fsyncs the database file. Runs on the checkpoint thread.
+  void run_durability_barrier(SqliteWrapper & barrier_db);
   void prepare_for_writing();
+  int get_topic_id(const std::string & topic_name) const;
+  // Resolves a message's database topic id through the interned-id table
+  // when the message carries one, falling back to the by-name lookup.
+  int resolve_topic_id(const rosbag2_storage::SerializedBagMessage & message) const;
   void prepare_for_reading();
+  // Resolves the topic filter against the topics table into the selected
+  // integer topic ids; returns false when no topic filter is set.
+  bool resolve_topic_filter(std::vector<int> & selected_topic_ids);
+  // WHERE conditions restricting the read to the current time window,
+  // tightened by the seek target and translated into rowid bounds through
+  // the sparse index where possible. Shared by the merged cursor and the
+  // per-topic cursors of a parallel filtered read.
+  std::vector<std::string> read_window_conditions();
+  // Per-topic read cursor of the parallel filtered read: a worker thread
+  // decodes rows over its own read-only connection into a bounded queue,
+  // and the reading thread merges the queue heads in timestamp order.
+  struct ParallelTopicReader;
+  // Spins up one cursor per selected topic when a filtered read can be
+  // served in parallel; returns false when the merged single cursor is the
+  // better (or only correct) choice.
+  bool try_start_parallel_reading(
+    const std::vector<int> & selected_topic_ids,
+    const std::vector<std::string> & window_conditions);
+  void stop_parallel_reading();
+  void parallel_reader_loop(ParallelTopicReader & reader);
+  // Next buffered row of the given cursor; blocks until the worker has
+  // produced one, returns nullptr once the cursor is exhausted.
+  std::shared_ptr<rosbag2_storage::SerializedBagMessage> take_from_reader(
+    ParallelTopicReader & reader);
+  // Next message across all parallel cursors in global timestamp order.
+  std::shared_ptr<rosbag2_storage::SerializedBagMessage> next_merged_message();
+  bool sparse_index_available();
+  // Translate a time bound into a rowid bound through the sparse timestamp
+  // index (see finalize_indices()), so the read cursor starts within one
+  // index stride of the seek target. Return 0 when no bound applies: the
+  // bag has no sparse index or no sample falls on that side of the bound.
+  uint64_t sparse_rowid_lower_bound(rcutils_time_point_value_t lower_time_bound);
+  uint64_t sparse_rowid_upper_bound(rcutils_time_point_value_t upper_time_bound);
+  // Advises the kernel that the database file is about to be streamed
+  // sequentially (POSIX_FADV_SEQUENTIAL + WILLNEED), so readahead ramps up
+  // immediately on cold caches. No-op on platforms without posix_fadvise.
+  void apply_read_hints();
+  // Releases page cache behind the read cursor (POSIX_FADV_DONTNEED) in
+  // fixed-size chunks, so replaying a bag larger than memory does not
+  // evict more useful pages. Only active when enabled via storage config.
+  void drop_behind_consumed_data();
+  void fill_topic_names_by_id();
   void fill_topics_and_types();
   void activate_transaction();
   void commit_transaction();
+  // Commits and reopens the transaction once it reached the adaptive size
+  // target; a no-op while adaptive sizing is disabled.
+  void maybe_split_transaction();
+  // Commits the open transaction and updates the adaptive size target from
+  // the measured commit latency.
+  void commit_measured_transaction();
+  // Commit-or-merge decision at the end of a batch write: without adaptive
+  // sizing every batch commits; with it, undersized batches leave the
+  // transaction open for the next batch.
+  void finish_batch_transaction();
 
+  // Rows carry only the integer topic_id; the name is resolved through
+  // topic_names_by_id_ so reading does not JOIN the topics table and does
+  // not materialize a fresh TEXT column per row. The blob column is lent
+  // out by the statement and copied into a pooled buffer when the message
+  // is materialized, so iterating does no per-row allocation.
   using ReadQueryResult = SqliteStatementWrapper::QueryResult<
-    std::shared_ptr<rcutils_uint8_array_t>, rcutils_time_point_value_t, std::string>;
+    SqliteBorrowedBlob, rcutils_time_point_value_t, int>;
 
   std::shared_ptr<SqliteWrapper> database_;
   SqliteStatement write_statement_ {};
+  // Multi-row VALUES statement used to insert full chunks of a batch write
+  // with a single step, amortizing the per-row statement overhead.
+  SqliteStatement batch_write_statement_ {};
   SqliteStatement read_statement_ {};
   ReadQueryResult message_result_ {nullptr};
   ReadQueryResult::Iterator current_message_row_ {
     nullptr, SqliteStatementWrapper::QueryResult<>::Iterator::POSITION_END};
+  // Cursors of a parallel filtered read; empty while the merged single
+  // cursor serves the read. See try_start_parallel_reading().
+  std::vector<std::unique_ptr<ParallelTopicReader>> parallel_readers_;
+  bool parallel_read_active_ {false};
   std::unordered_map<std::string, int> topics_;
+  // Database topic id indexed by the interned id the writer stamped into
+  // TopicMetadata::topic_id on create_topic; -1 for unknown slots. Lets the
+  // write path resolve a message's topic with an array index instead of
+  // hashing its name.
+  std::vector<int> db_topic_ids_by_interned_id_;
+  // Interned topic names for the read path, loaded once from the small
+  // topics table and shared by all messages of a topic.
+  std::unordered_map<int, std::string> topic_names_by_id_;
+  // Count/min/max per topic, updated incrementally while writing and
+  // persisted to the metadata_summary table at commit points, so
+  // get_metadata() never has to aggregate over the messages table.
+  std::unordered_map<int, TopicStats> topic_stats_;
   std::vector<rosbag2_storage::TopicMetadata> all_topics_and_types_;
   std::string relative_path_;
+  // Optional path to a file with PRAGMA statements applied on open.
+  std::string storage_config_uri_;
+  // Running estimate of the database size in bytes, maintained on every
+  // write so that get_bagfile_size() does not have to stat the file.
+  std::atomic<uint64_t> estimated_bagfile_size_ {0};
+  // Cumulative I/O counters reported by get_io_statistics(); atomics so
+  // monitoring can sample them from another thread without a lock.
+  std::atomic<uint64_t> bytes_written_ {0};
+  std::atomic<uint64_t> bytes_read_ {0};
+  std::atomic<uint64_t> messages_written_ {0};
+  std::atomic<uint64_t> messages_read_ {0};
+  std::atomic<uint64_t> transactions_committed_ {0};
   std::atomic_bool active_transaction_ {false};
+  // Adaptive transaction sizing, enabled via 'PRAGMA commit_latency_budget
+  // = <milliseconds>;' in the storage config file: commit latency is
+  // measured and incoming batches are split or merged so each commit stays
+  // within the budget as the message mix changes. 0 (the default) keeps the
+  // one-transaction-per-batch behavior.
+  std::chrono::milliseconds commit_latency_budget_ {0};
+  // Current transaction size target: budget divided by the smoothed
+  // per-byte commit cost. Starts at 4 MiB until the first latency sample.
+  uint64_t adaptive_transaction_bytes_ {4 * 1024 * 1024};
+  double smoothed_commit_ns_per_byte_ {0.0};
+  // Start state of the open transaction, recorded by activate_transaction().
+  uint64_t bytes_at_transaction_begin_ {0};
+  std::chrono::steady_clock::time_point transaction_begin_time_;
+  // True when the database was opened for writing; the composite topic
+  // index is finalized on close only in that case.
+  bool db_read_write_ {false};
+  // Opt-in via 'PRAGMA optimize_on_close' in the storage config file: run
+  // ANALYZE, PRAGMA optimize and a truncating WAL checkpoint when the bag
+  // is closed, for bags recorded once and replayed many times.
+  bool optimize_on_close_ {false};
+
+  // Kernel readahead hints for streaming reads, issued on the file when
+  // reading starts. On by default; opt out through the storage config file
+  // with 'PRAGMA read_hints = 0;'.
+  bool read_hints_enabled_ {true};
+  // Opt-in via 'PRAGMA read_drop_behind' in the storage config file:
+  // release page cache behind the read cursor while replaying.
+  bool read_drop_behind_enabled_ {false};
+  // File descriptor the advice is issued on; -1 until reading starts (or
+  // when the hints are disabled or unsupported).
+  int read_hints_fd_ {-1};
+  // File offset up to which consumed data was already dropped.
+  uint64_t drop_behind_offset_ {0};
+
+  // Checkpoints the WAL from its own connection whenever the WAL file
+  // crosses wal_checkpoint_threshold_, so sqlite never has to checkpoint
+  // inline on the writing thread and write latency stays flat.
+  std::thread checkpoint_thread_;
+  std::mutex checkpoint_mutex_;
+  std::condition_variable checkpoint_condition_;
+  bool stop_checkpoint_thread_ {false};
+  // Default of 64 MiB; can be overridden through the storage config file
+  // with 'PRAGMA wal_checkpoint_threshold = <bytes>;'.
+  uint64_t wal_checkpoint_threshold_ {64 * 1024 * 1024};
+  // Selected via 'PRAGMA durability = async;' in the storage config file:
+  // the writing connection runs with synchronous=OFF and the checkpoint
+  // thread periodically establishes a durable horizon instead. A crash can
+  // lose at most one barrier period of messages; everything up to the
+  // timestamp recorded in the durability_horizon table is guaranteed intact.
+  bool durability_async_ {false};
+  // Interval between durability barriers; 'PRAGMA
+  // durability_barrier_period = <seconds>;' overrides the 5 s default.
+  std::chrono::seconds durability_barrier_period_ {5};
+  // Opt-in via 'PRAGMA exclusive_locking;' in the storage config file: the
+  // writing connection holds the sqlite file lock for the whole recording,
+  // which removes the per-statement WAL locking and the shared-memory
+  // wal-index for the single-writer case. Rules out every concurrent
+  // connection to the bag, including the plugin's own checkpoint thread,
+  // the durability barrier, and external readers of a live recording.
+  bool exclusive_locking_ {false};
+  // Whether the sparse_timestamp_idx side table exists in this file;
+  // checked once on the first read so every seek does not have to query
+  // sqlite_master again.
+  bool sparse_index_checked_ {false};
+  bool sparse_index_available_ {false};
   rosbag2_storage::StorageFilter storage_filter_ {};
+  // Timestamp to resume reading from after a seek(); negative when unset.
+  rcutils_time_point_value_t seek_time_ {-1};
+  // Direction of the read cursor; reverse reads walk the timestamp index
+  // descending, so stepping backwards costs the same as stepping forward.
+  rosbag2_storage::ReadOrder read_order_ {rosbag2_storage::ReadOrder::FORWARD};
 };
 
 }  // namespace rosbag2_storage_plugins
@@ -17,8 +17,11 @@
 
 #include <sqlite3.h>
 
+#include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "rcutils/types.h"
@@ -35,18 +38,47 @@ using DBPtr = sqlite3 *;
 class ROSBAG2_STORAGE_DEFAULT_PLUGINS_PUBLIC SqliteWrapper
 {
 public:
-  SqliteWrapper(const std::string & uri, rosbag2_storage::storage_interfaces::IOFlag io_flag);
+  /**
+   * Open a database connection. With exclusive_locking (READ_WRITE only)
+   * the connection takes the file lock for its whole lifetime, which makes
+   * sqlite keep the wal-index in heap memory and turns the per-statement
+   * WAL locks into no-ops; no other connection can use the file meanwhile.
+   */
+  SqliteWrapper(
+    const std::string & uri, rosbag2_storage::storage_interfaces::IOFlag io_flag,
+    bool exclusive_locking = false);
   SqliteWrapper();
   ~SqliteWrapper();
 
+  /**
+   * Hand out a prepared statement for the given SQL text.
+   * Hot statements (transaction brackets, inserts) are compiled once per
+   * connection and served from an LRU cache afterwards; a cached statement
+   * is reset before it is handed out again. Statements still borrowed by
+   * another caller are never shared, so holding a statement across calls
+   * stays safe.
+   */
   SqliteStatement prepare_statement(const std::string & query);
 
   size_t get_last_insert_id();
 
+  // Current value of a sqlite3_db_status() counter (e.g.
+  // SQLITE_DBSTATUS_CACHE_HIT) for this connection; 0 when unavailable.
+  uint64_t get_db_status(int op) const;
+
+  // Passes SQLITE_FCNTL_SIZE_HINT to the VFS so the database file gets
+  // preallocated (fallocate and friends) instead of growing page by page.
+  void set_file_size_hint(uint64_t expected_file_size);
+
   operator bool();
 
 private:
   DBPtr db_ptr;
+  // Most recently used statements first; the index maps SQL text to the
+  // list entry. Entries are dropped before the database is closed so all
+  // statements are finalized in time.
+  std::list<std::pair<std::string, SqliteStatement>> statement_cache_;
+  std::unordered_map<std::string, decltype(statement_cache_)::iterator> statement_cache_index_;
 };
 
 
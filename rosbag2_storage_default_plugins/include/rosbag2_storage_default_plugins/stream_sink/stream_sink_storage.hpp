@@ -0,0 +1,204 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_STORAGE_DEFAULT_PLUGINS__STREAM_SINK__STREAM_SINK_STORAGE_HPP_
+#define ROSBAG2_STORAGE_DEFAULT_PLUGINS__STREAM_SINK__STREAM_SINK_STORAGE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "rcutils/types.h"
+#include "rosbag2_storage/bag_metadata.hpp"
+#include "rosbag2_storage/serialized_bag_message.hpp"
+#include "rosbag2_storage/storage_filter.hpp"
+#include "rosbag2_storage/storage_interfaces/read_write_interface.hpp"
+#include "rosbag2_storage/topic_metadata.hpp"
+#include "rosbag2_storage_default_plugins/visibility_control.hpp"
+
+namespace rosbag2_storage_plugins
+{
+
+/**
+ * Streaming network sink storage plugin.
+ *
+ * A write-only counterpart of the chunked plugin for robots without a
+ * persistent disk: messages are buffered into chunks with the same record
+ * layout as the chunked format, and every sealed chunk is handed to an
+ * uploader thread which PUTs it to an HTTP endpoint while recording
+ * continues, so upload bandwidth overlaps with ingestion instead of
+ * following it. A footer object with the topic table and chunk index is
+ * uploaded when the bag is closed.
+ *
+ * The uploader keeps a bounded number of sealed chunks in flight; when the
+ * network falls behind and the queue is full, or an upload keeps failing,
+ * the chunk is spilled to a local spool directory instead of blocking the
+ * writing thread, for an external uploader to pick up later.
+ *
+ * Configured through the pragma-styled storage config file shared with the
+ * other plugins:
+ *
+ *   PRAGMA sink_endpoint = http://host:port/base/path;   (required)
+ *   PRAGMA sink_chunk_size = <bytes>;                    (default 4 MiB)
+ *   PRAGMA sink_max_in_flight = <chunks>;                (default 4)
+ *   PRAGMA sink_spill_directory = <path>;      (default next to the uri)
+ *
+ * The plugin cannot read bags back; opening it READ_ONLY throws. Only
+ * supported on POSIX platforms.
+ */
+class ROSBAG2_STORAGE_DEFAULT_PLUGINS_PUBLIC StreamSinkStorage
+  : public rosbag2_storage::storage_interfaces::ReadWriteInterface
+{
+public:
+  StreamSinkStorage() = default;
+  ~StreamSinkStorage() override;
+
+  void open(
+    const std::string & uri,
+    rosbag2_storage::storage_interfaces::IOFlag io_flag =
+    rosbag2_storage::storage_interfaces::IOFlag::READ_WRITE) override;
+
+  void remove_topic(const rosbag2_storage::TopicMetadata & topic) override;
+
+  void create_topic(const rosbag2_storage::TopicMetadata & topic) override;
+
+  void write(std::shared_ptr<const rosbag2_storage::SerializedBagMessage> message) override;
+
+  void write(
+    const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> & messages)
+  override;
+
+  bool has_next() override;
+
+  std::shared_ptr<rosbag2_storage::SerializedBagMessage> read_next() override;
+
+  std::vector<rosbag2_storage::TopicMetadata> get_all_topics_and_types() override;
+
+  rosbag2_storage::BagMetadata get_metadata() override;
+
+  std::string get_relative_file_path() const override;
+
+  uint64_t get_bagfile_size() const override;
+
+  std::string get_storage_identifier() const override;
+
+  uint64_t get_minimum_split_file_size() const override;
+
+  void set_filter(const rosbag2_storage::StorageFilter & storage_filter) override;
+
+  void reset_filter() override;
+
+  void set_storage_config(const std::string & storage_config_uri) override;
+
+  rosbag2_storage::IOStatistics get_io_statistics() const override;
+
+private:
+  struct TopicEntry
+  {
+    uint32_t id;
+    rosbag2_storage::TopicMetadata metadata;
+    uint64_t message_count;
+    rcutils_time_point_value_t min_timestamp;
+    rcutils_time_point_value_t max_timestamp;
+  };
+
+  // One sealed object on its way to the sink: a chunk or the footer.
+  struct PendingObject
+  {
+    std::string name;
+    std::vector<uint8_t> data;
+  };
+
+  void apply_storage_config();
+  void write_message(const rosbag2_storage::SerializedBagMessage & message);
+  void seal_chunk();
+  std::vector<uint8_t> build_footer() const;
+  // Hands a sealed object to the uploader, spilling it instead when the
+  // bounded in-flight queue is full.
+  void enqueue_object(PendingObject && object);
+  void uploader_loop();
+  // PUTs one object to the endpoint; returns false on any network or
+  // non-2xx failure.
+  bool upload_object(const PendingObject & object);
+  void spill_object(const PendingObject & object);
+
+  std::string relative_path_;
+  std::string storage_config_uri_;
+
+  // Parsed sink endpoint and the per-bag object name prefix.
+  std::string endpoint_host_;
+  std::string endpoint_port_ {"80"};
+  std::string endpoint_base_path_;
+  std::string object_prefix_;
+
+  uint64_t chunk_size_threshold_ {4 * 1024 * 1024};
+  size_t max_in_flight_chunks_ {4};
+  std::string spill_directory_;
+  // spill_object() runs on the writing thread (full queue) as well as on
+  // the uploader thread (failed upload); the one-time directory creation
+  // needs to be serialized between them.
+  std::mutex spill_directory_mutex_;
+  bool spill_directory_created_ {false};  // Guarded by spill_directory_mutex_.
+
+  // Topic table; ids are assigned densely in creation order, matching the
+  // chunked record layout.
+  std::vector<TopicEntry> topics_;
+  std::unordered_map<std::string, uint32_t> topic_ids_by_name_;
+
+  // The chunk being filled by the writing thread.
+  std::vector<uint8_t> chunk_buffer_;
+  uint32_t chunk_message_count_ {0};
+  rcutils_time_point_value_t chunk_min_timestamp_ {0};
+  rcutils_time_point_value_t chunk_max_timestamp_ {0};
+  uint64_t sealed_chunks_ {0};
+
+  struct ChunkIndexEntry
+  {
+    uint64_t sequence;
+    uint64_t data_size;
+    uint32_t message_count;
+    rcutils_time_point_value_t min_timestamp;
+    rcutils_time_point_value_t max_timestamp;
+  };
+  std::vector<ChunkIndexEntry> chunk_index_;
+
+  // Bounded queue of sealed objects between the writing thread and the
+  // uploader thread.
+  std::mutex queue_mutex_;
+  std::condition_variable queue_condition_;
+  std::deque<PendingObject> upload_queue_;
+  bool stop_uploader_ {false};
+  std::thread uploader_thread_;
+
+  // Cumulative counters for get_io_statistics(); bytes_written counts the
+  // payload bytes accepted, uploaded/spilled are tracked separately. The
+  // upload and spill counters are atomic because they are incremented on
+  // the uploader thread (and the spill counter also on the writing thread)
+  // while get_io_statistics() reads them concurrently.
+  uint64_t bytes_written_ {0};
+  uint64_t messages_written_ {0};
+  std::atomic<uint64_t> bytes_uploaded_ {0};
+  std::atomic<uint64_t> objects_uploaded_ {0};
+  std::atomic<uint64_t> objects_spilled_ {0};
+};
+
+}  // namespace rosbag2_storage_plugins
+
+#endif  // ROSBAG2_STORAGE_DEFAULT_PLUGINS__STREAM_SINK__STREAM_SINK_STORAGE_HPP_
@@ -0,0 +1,190 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_storage_default_plugins/sqlite/sqlite_bag_slicer.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+
+#include "rosbag2_storage/metadata_io.hpp"
+#include "rosbag2_storage_default_plugins/sqlite/sqlite_storage.hpp"
+#include "rosbag2_storage_default_plugins/sqlite/sqlite_wrapper.hpp"
+
+#include "../logging.hpp"
+
+namespace rosbag2_storage_plugins
+{
+
+namespace
+{
+
+std::string placeholder_list(size_t count)
+{
+  std::string placeholders = "?";
+  for (size_t i = 1; i < count; ++i) {
+    placeholders += ", ?";
+  }
+  return placeholders;
+}
+
+}  // namespace
+
+SqliteBagSlicer::SqliteBagSlicer(const Options & options)
+: options_(options)
+{}
+
+void SqliteBagSlicer::run()
+{
+  // Resolve the source database files. A bag directory carries its file
+  // list in the metadata; a bare database file is sliced as is.
+  std::vector<std::string> source_files;
+  rosbag2_storage::MetadataIo metadata_io;
+  if (metadata_io.metadata_file_exists(options_.source_uri)) {
+    const auto metadata = metadata_io.read_metadata(options_.source_uri);
+    for (const auto & relative_path : metadata.relative_file_paths) {
+      source_files.push_back(
+        (rcpputils::fs::path(options_.source_uri) / relative_path).string());
+    }
+  } else {
+    source_files.push_back(options_.source_uri);
+  }
+  if (source_files.empty()) {
+    throw std::runtime_error(
+            "Source bag '" + options_.source_uri + "' lists no database files.");
+  }
+
+  const auto destination = rcpputils::fs::path(options_.destination_uri);
+  if (destination.exists()) {
+    throw std::runtime_error(
+            "Destination '" + options_.destination_uri + "' already exists.");
+  }
+  if (!rcpputils::fs::create_directories(destination)) {
+    throw std::runtime_error(
+            "Destination '" + options_.destination_uri + "' could not be created.");
+  }
+  const auto database_name = destination.filename().string() + "_0.db3";
+  const auto database_path = (destination / database_name).string();
+
+  {
+    auto database = std::make_unique<SqliteWrapper>(
+      database_path, rosbag2_storage::storage_interfaces::IOFlag::READ_WRITE);
+    // The destination is written in one shot and deleted on failure, so
+    // crash safety buys nothing; journaling off keeps the copy at disk
+    // bandwidth.
+    database->prepare_statement("PRAGMA journal_mode = OFF;")->execute_and_reset();
+    database->prepare_statement("PRAGMA synchronous = OFF;")->execute_and_reset();
+
+    // Same schema as SqliteStorage::initialize(), so the slice is a
+    // regular bag to every reader.
+    database->prepare_statement(
+      "CREATE TABLE topics("
+      "id INTEGER PRIMARY KEY,"
+      "name TEXT NOT NULL,"
+      "type TEXT NOT NULL,"
+      "serialization_format TEXT NOT NULL,"
+      "offered_qos_profiles TEXT NOT NULL);")->execute_and_reset();
+    database->prepare_statement(
+      "CREATE TABLE messages("
+      "id INTEGER PRIMARY KEY,"
+      "topic_id INTEGER NOT NULL,"
+      "timestamp INTEGER NOT NULL, "
+      "data BLOB NOT NULL);")->execute_and_reset();
+    database->prepare_statement(
+      "CREATE INDEX timestamp_idx ON messages (timestamp ASC);")->execute_and_reset();
+    database->prepare_statement(
+      "CREATE TABLE metadata_summary("
+      "topic_id INTEGER PRIMARY KEY,"
+      "message_count INTEGER NOT NULL,"
+      "min_timestamp INTEGER NOT NULL,"
+      "max_timestamp INTEGER NOT NULL);")->execute_and_reset();
+
+    for (const auto & source_file : source_files) {
+      copy_from(*database, source_file);
+    }
+
+    database->prepare_statement(
+      "INSERT INTO metadata_summary (topic_id, message_count, min_timestamp, max_timestamp) "
+      "SELECT topic_id, COUNT(*), MIN(timestamp), MAX(timestamp) "
+      "FROM messages GROUP BY topic_id;")->execute_and_reset();
+  }
+
+  // Fresh metadata for the slice, read back through the regular plugin so
+  // the counts and time range always agree with what a reader will see.
+  SqliteStorage storage;
+  storage.open(database_path, rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+  auto metadata = storage.get_metadata();
+  metadata.relative_file_paths = {database_name};
+  metadata_io.write_metadata(options_.destination_uri, metadata);
+}
+
+void SqliteBagSlicer::copy_from(SqliteWrapper & database, const std::string & source_file)
+{
+  ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_DEBUG_STREAM("slicing from: " << source_file);
+  auto attach = database.prepare_statement("ATTACH DATABASE ? AS source;");
+  attach->bind(source_file);
+  attach->execute_and_reset();
+
+  database.prepare_statement("BEGIN TRANSACTION;")->execute_and_reset();
+
+  // Topics not yet known from an earlier file of a split bag get fresh ids
+  // in the destination.
+  std::string topic_predicate;
+  if (!options_.topics.empty()) {
+    topic_predicate = " AND st.name IN (" + placeholder_list(options_.topics.size()) + ")";
+  }
+  auto copy_topics = database.prepare_statement(
+    "INSERT INTO topics (name, type, serialization_format, offered_qos_profiles) "
+    "SELECT st.name, st.type, st.serialization_format, st.offered_qos_profiles "
+    "FROM source.topics st "
+    "WHERE NOT EXISTS (SELECT 1 FROM main.topics mt WHERE mt.name = st.name)" +
+    topic_predicate + ";");
+  for (const auto & topic : options_.topics) {
+    copy_topics->bind(topic);
+  }
+  copy_topics->execute_and_reset();
+
+  // The message copy never surfaces the blobs into C++; sqlite moves them
+  // between the attached files directly. Topic ids are renumbered through
+  // the join since split files may disagree on them.
+  std::string message_predicates;
+  if (options_.start_time >= 0) {
+    message_predicates += " AND m.timestamp >= ?";
+  }
+  if (options_.end_time >= 0) {
+    message_predicates += " AND m.timestamp <= ?";
+  }
+  auto copy_messages = database.prepare_statement(
+    "INSERT INTO messages (topic_id, timestamp, data) "
+    "SELECT mt.id, m.timestamp, m.data "
+    "FROM source.messages m "
+    "JOIN source.topics st ON st.id = m.topic_id "
+    "JOIN main.topics mt ON mt.name = st.name "
+    "WHERE 1" + message_predicates + " ORDER BY m.timestamp;");
+  if (options_.start_time >= 0) {
+    copy_messages->bind(options_.start_time);
+  }
+  if (options_.end_time >= 0) {
+    copy_messages->bind(options_.end_time);
+  }
+  copy_messages->execute_and_reset();
+
+  database.prepare_statement("COMMIT;")->execute_and_reset();
+  database.prepare_statement("DETACH DATABASE source;")->execute_and_reset();
+}
+
+}  // namespace rosbag2_storage_plugins
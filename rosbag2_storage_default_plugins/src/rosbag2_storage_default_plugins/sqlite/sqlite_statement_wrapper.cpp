@@ -111,6 +111,16 @@ SqliteStatementWrapper::bind(std::shared_ptr<rcutils_uint8_array_t> value)
   return shared_from_this();
 }
 
+std::shared_ptr<SqliteStatementWrapper>
+SqliteStatementWrapper::bind(const rcutils_uint8_array_t * value)
+{
+  auto return_code = sqlite3_bind_blob(
+    statement_, ++last_bound_parameter_index_,
+    value->buffer, static_cast<int>(value->buffer_length), SQLITE_STATIC);
+  check_and_report_bind_error(return_code);
+  return shared_from_this();
+}
+
 std::shared_ptr<SqliteStatementWrapper> SqliteStatementWrapper::reset()
 {
   sqlite3_reset(statement_);
@@ -165,6 +175,12 @@ void SqliteStatementWrapper::obtain_column_value(
   value = rosbag2_storage::make_serialized_message(data, size);
 }
 
+void SqliteStatementWrapper::obtain_column_value(size_t index, SqliteBorrowedBlob & value) const
+{
+  value.data = sqlite3_column_blob(statement_, static_cast<int>(index));
+  value.size = static_cast<size_t>(sqlite3_column_bytes(statement_, static_cast<int>(index)));
+}
+
 void SqliteStatementWrapper::check_and_report_bind_error(int return_code)
 {
   if (return_code != SQLITE_OK) {
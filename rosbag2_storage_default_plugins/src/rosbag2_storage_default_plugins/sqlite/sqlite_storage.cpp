@@ -16,12 +16,19 @@
 
 #include <sys/stat.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstring>
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <regex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -29,7 +36,9 @@
 #include "rcpputils/filesystem_helper.hpp"
 
 #include "rosbag2_storage/metadata_io.hpp"
+#include "rosbag2_storage/ros_helper.hpp"
 #include "rosbag2_storage/serialized_bag_message.hpp"
+#include "rosbag2_storage/tracepoints.hpp"
 #include "rosbag2_storage_default_plugins/sqlite/sqlite_statement_wrapper.hpp"
 #include "rosbag2_storage_default_plugins/sqlite/sqlite_exception.hpp"
 
@@ -60,14 +69,206 @@ constexpr const auto FILE_EXTENSION = ".db3";
 
 // Minimum size of a sqlite3 database file in bytes (84 kiB).
 constexpr const uint64_t MIN_SPLIT_FILE_SIZE = 86016;
+
+// Estimated sqlite overhead per message row in bytes: record header, rowid,
+// the topic_id and timestamp columns and the timestamp index entry.
+constexpr const uint64_t ESTIMATED_ROW_OVERHEAD = 40;
+
+// Number of rows inserted per step of the multi-row batch insert statement.
+// Bounded by SQLITE_MAX_VARIABLE_NUMBER (999 by default) / 3 parameters.
+constexpr const size_t BATCH_INSERT_ROWS = 32;
+
+// Stride of the sparse in-file timestamp index built at close: one sampled
+// (timestamp, rowid) pair per this many messages. See finalize_indices().
+constexpr const uint64_t SPARSE_INDEX_STRIDE = 1000;
+
+// How often the checkpoint thread looks at the WAL file size.
+constexpr const std::chrono::seconds WAL_CHECKPOINT_POLL_INTERVAL {1};
+
+// Pseudo pragma intercepted from the storage config file to override the
+// WAL checkpoint threshold; sqlite ignores unknown pragmas, so reusing the
+// pragma syntax keeps the config file format uniform.
+constexpr const char WAL_CHECKPOINT_THRESHOLD_PRAGMA[] = "wal_checkpoint_threshold";
+
+// Pseudo pragma enabling the archival optimization pass when the bag is
+// closed; see optimize_for_archival().
+constexpr const char OPTIMIZE_ON_CLOSE_PRAGMA[] = "optimize_on_close";
+
+// Pseudo pragma disabling the kernel readahead hints issued when reading
+// starts; see apply_read_hints().
+constexpr const char READ_HINTS_PRAGMA[] = "read_hints";
+
+// Pseudo pragma enabling drop-behind of consumed data while reading; see
+// drop_behind_consumed_data().
+constexpr const char READ_DROP_BEHIND_PRAGMA[] = "read_drop_behind";
+
+// Granularity of the drop-behind advice; page cache behind the read cursor
+// is released in chunks of this size.
+constexpr const uint64_t DROP_BEHIND_CHUNK_SIZE = 8 * 1024 * 1024;
+
+// Upper bound on the per-topic cursors of a parallel filtered read; more
+// cursors than this would contend for the disk instead of overlapping page
+// decoding. See try_start_parallel_reading().
+constexpr const size_t MAX_PARALLEL_READ_CURSORS = 8;
+
+// Rows buffered per parallel cursor before its worker blocks, bounding the
+// memory a fast topic can run ahead of the merge point.
+constexpr const size_t PARALLEL_READ_QUEUE_DEPTH = 64;
+
+// Pseudo pragma selecting the durability policy ('normal' or 'async');
+// see run_durability_barrier().
+constexpr const char DURABILITY_PRAGMA[] = "durability";
+
+// Pseudo pragma overriding the period of the durability barrier under the
+// async policy, in seconds.
+constexpr const char DURABILITY_BARRIER_PERIOD_PRAGMA[] = "durability_barrier_period";
+
+// Pseudo pragma making the writing connection hold the sqlite file lock
+// for the whole recording; see the exclusive_locking_ member.
+constexpr const char EXCLUSIVE_LOCKING_PRAGMA[] = "exclusive_locking";
+
+// Pseudo pragma targeting a per-commit latency in milliseconds; see
+// maybe_split_transaction().
+constexpr const char COMMIT_LATENCY_BUDGET_PRAGMA[] = "commit_latency_budget";
+
+// Bounds of the adaptive transaction size. The lower bound also gates the
+// latency samples: commits far below it are dominated by the constant cost
+// of the commit itself and would talk the per-byte estimate up, shrinking
+// the target and causing even more small commits.
+constexpr const uint64_t MIN_ADAPTIVE_TRANSACTION_BYTES = 64 * 1024;
+constexpr const uint64_t MAX_ADAPTIVE_TRANSACTION_BYTES = 256 * 1024 * 1024;
+
+// Upper bound on how long a merged transaction may stay open waiting for
+// more data before it is committed regardless of its size.
+constexpr const std::chrono::seconds ADAPTIVE_COMMIT_MAX_HOLD {1};
+
+// True when the storage config file enables the exclusive_locking pseudo
+// pragma. Parsed ahead of apply_storage_config() because the locking mode
+// has to be set before the connection first touches the database; read
+// errors are left for apply_storage_config() to report.
+bool config_enables_exclusive_locking(const std::string & config_uri)
+{
+  std::ifstream config_file(config_uri);
+  std::string line;
+  while (std::getline(config_file, line)) {
+    if (line.find(EXCLUSIVE_LOCKING_PRAGMA) == std::string::npos) {
+      continue;
+    }
+    const auto assignment = line.find('=');
+    // 'PRAGMA exclusive_locking;' and any value other than 0 enable it.
+    return assignment == std::string::npos || std::stoll(line.substr(assignment + 1)) != 0;
+  }
+  return false;
+}
 }  // namespace
 
 namespace rosbag2_storage_plugins
 {
+struct SqliteStorage::ParallelTopicReader
+{
+  std::string query;
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable row_available;
+  std::condition_variable space_available;
+  std::deque<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> rows;
+  bool done {false};
+  bool stop {false};
+  // Set instead of throwing on the worker; rethrown at the merge point.
+  std::string error;
+  // Next message of this cursor, owned by the merging thread.
+  std::shared_ptr<rosbag2_storage::SerializedBagMessage> head;
+};
+
 SqliteStorage::~SqliteStorage()
 {
+#ifndef _WIN32
+  if (read_hints_fd_ >= 0) {
+    ::close(read_hints_fd_);
+  }
+#endif
+  stop_parallel_reading();
+  stop_checkpoint_thread();
   if (active_transaction_) {
-    commit_transaction();
+    commit_transaction();  // also persists the topic statistics
+  } else if (db_read_write_ && database_) {
+    try {
+      persist_topic_stats();
+    } catch (const SqliteException & e) {
+      ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_WARN_STREAM(
+        "Could not persist topic statistics on '" << relative_path_ <<
+          "'. Error: " << e.what());
+    }
+  }
+  if (db_read_write_ && database_) {
+    finalize_indices();
+    if (optimize_on_close_) {
+      optimize_for_archival();
+    }
+  }
+}
+
+void SqliteStorage::optimize_for_archival()
+{
+  // Pays once at close to speed every subsequent filtered read of a bag
+  // that is recorded once and replayed many times: ANALYZE gives the query
+  // planner real row distribution statistics for the freshly built indexes,
+  // PRAGMA optimize runs whatever maintenance sqlite itself recommends, and
+  // the TRUNCATE checkpoint folds the WAL back into the main file so
+  // readers never have to merge WAL frames again.
+  try {
+    database_->prepare_statement("ANALYZE;")->execute_and_reset();
+    database_->prepare_statement("PRAGMA optimize;")->execute_and_reset();
+    database_->prepare_statement("PRAGMA wal_checkpoint(TRUNCATE);")->execute_and_reset();
+  } catch (const SqliteException & e) {
+    // Not fatal: the bag stays readable, just without the tuned statistics.
+    ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_WARN_STREAM(
+      "Could not optimize '" << relative_path_ << "' for archival. Error: " << e.what());
+  }
+}
+
+void SqliteStorage::finalize_indices()
+{
+  // The composite index makes filtered reads walk only the rows of the
+  // selected topics instead of the full timestamp index. It is built once
+  // when the bagfile is closed so recording throughput is untouched; the
+  // query planner picks it up without changes to the read statements.
+  try {
+    database_->prepare_statement(
+      "CREATE INDEX IF NOT EXISTS topic_timestamp_idx "
+      "ON messages (topic_id, timestamp ASC);")->execute_and_reset();
+  } catch (const SqliteException & e) {
+    // Not fatal: reading falls back to timestamp_idx.
+    ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_WARN_STREAM(
+      "Could not build composite topic index on '" << relative_path_ <<
+        "'. Error: " << e.what());
+  }
+
+  // The sparse timestamp index samples every SPARSE_INDEX_STRIDE-th row
+  // into a small side table mapping timestamp to rowid. A seek translates
+  // its time target into a rowid bound with one lookup there (see
+  // sparse_rowid_lower_bound()), so the cursor lands within a stride of the
+  // target even in a multi-gigabyte split. Like the composite index it is
+  // built once when the split is sealed, leaving recording untouched.
+  try {
+    database_->prepare_statement(
+      "CREATE TABLE IF NOT EXISTS sparse_timestamp_idx("
+      "timestamp INTEGER NOT NULL, message_id INTEGER NOT NULL);")->execute_and_reset();
+    // Rebuild from scratch so reopening a bag in APPEND mode does not leave
+    // stale samples behind.
+    database_->prepare_statement("DELETE FROM sparse_timestamp_idx;")->execute_and_reset();
+    database_->prepare_statement(
+      "INSERT INTO sparse_timestamp_idx (timestamp, message_id) "
+      "SELECT timestamp, id FROM messages "
+      "WHERE (id % " + std::to_string(SPARSE_INDEX_STRIDE) + ") = 1;")->execute_and_reset();
+    database_->prepare_statement(
+      "CREATE INDEX IF NOT EXISTS sparse_timestamp_lookup "
+      "ON sparse_timestamp_idx (timestamp ASC);")->execute_and_reset();
+  } catch (const SqliteException & e) {
+    // Not fatal: seeks fall back to the plain time bound.
+    ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_WARN_STREAM(
+      "Could not build sparse timestamp index on '" << relative_path_ <<
+        "'. Error: " << e.what());
   }
 }
 
@@ -92,14 +293,25 @@ void SqliteStorage::open(
     }
   }
 
+  if (is_read_write(io_flag) && !storage_config_uri_.empty()) {
+    exclusive_locking_ = config_enables_exclusive_locking(storage_config_uri_);
+  }
+
   try {
-    database_ = std::make_unique<SqliteWrapper>(relative_path_, io_flag);
+    database_ = std::make_unique<SqliteWrapper>(relative_path_, io_flag, exclusive_locking_);
   } catch (const SqliteException & e) {
     throw std::runtime_error("Failed to setup storage. Error: " + std::string(e.what()));
   }
 
+  // Apply deployment specific pragmas (page_size, cache_size, mmap_size, ...)
+  // before the schema is created or any data is touched.
+  if (!storage_config_uri_.empty()) {
+    apply_storage_config();
+  }
+
   // initialize only for READ_WRITE since the DB is already initialized if in APPEND.
-  if (is_read_write(io_flag)) {
+  db_read_write_ = is_read_write(io_flag);
+  if (db_read_write_) {
     initialize();
   }
 
@@ -107,11 +319,152 @@ void SqliteStorage::open(
   // These will be reinitialized lazily on the first read or write.
   read_statement_ = nullptr;
   write_statement_ = nullptr;
+  batch_write_statement_ = nullptr;
+
+  // Seed the in-memory size estimate once; it is advanced per write so the
+  // bagfile split check does not stat the file (which is also inaccurate
+  // under WAL until a checkpoint ran).
+  const auto bag_path = rcpputils::fs::path{relative_path_};
+  estimated_bagfile_size_ =
+    bag_path.exists() ? std::max<uint64_t>(bag_path.file_size(), MIN_SPLIT_FILE_SIZE) :
+    MIN_SPLIT_FILE_SIZE;
+
+  if (db_read_write_) {
+    if (durability_async_ && exclusive_locking_) {
+      ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_WARN_STREAM(
+        "The async durability barrier needs its own connection, which "
+        "exclusive locking rules out; recording with 'PRAGMA durability = normal;'.");
+      durability_async_ = false;
+    }
+    if (durability_async_) {
+      // Async durability: the writing connection never fsyncs; the
+      // background thread periodically establishes a durable horizon via
+      // run_durability_barrier().
+      database_->prepare_statement("PRAGMA synchronous = OFF;")->execute_and_reset();
+    }
+    if (exclusive_locking_) {
+      // No second connection can checkpoint while this one holds the file
+      // lock, so sqlite's built-in auto checkpoint (every 1000 WAL pages)
+      // keeps the WAL bounded inline instead. With no readers to wait for,
+      // an inline checkpoint is a short sequential copy back into the
+      // database file, so write latency stays predictable.
+    } else {
+      start_checkpoint_thread();
+    }
+  }
 
   ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_INFO_STREAM(
     "Opened database '" << relative_path_ << "' for " << to_string(io_flag) << ".");
 }
 
+void SqliteStorage::start_checkpoint_thread()
+{
+  stop_checkpoint_thread_ = false;
+  checkpoint_thread_ = std::thread(&SqliteStorage::checkpoint_thread_loop, this);
+}
+
+void SqliteStorage::stop_checkpoint_thread()
+{
+  {
+    std::lock_guard<std::mutex> lock(checkpoint_mutex_);
+    stop_checkpoint_thread_ = true;
+  }
+  checkpoint_condition_.notify_all();
+  if (checkpoint_thread_.joinable()) {
+    checkpoint_thread_.join();
+  }
+}
+
+void SqliteStorage::checkpoint_thread_loop()
+{
+  // Checkpointing happens over its own connection: the writer's connection
+  // is opened without sqlite's mutexes and must not be shared across
+  // threads. Under WAL several connections to the same file are fine.
+  std::unique_ptr<SqliteWrapper> checkpoint_db;
+  try {
+    checkpoint_db = std::make_unique<SqliteWrapper>(
+      relative_path_, rosbag2_storage::storage_interfaces::IOFlag::READ_WRITE);
+  } catch (const SqliteException & e) {
+    ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_WARN_STREAM(
+      "Could not open connection for WAL checkpointing, the WAL will be "
+      "checkpointed inline on the writing thread. Error: " << e.what());
+    return;
+  }
+
+  const auto wal_path = rcpputils::fs::path{relative_path_ + "-wal"};
+  auto last_barrier = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(checkpoint_mutex_);
+  while (!stop_checkpoint_thread_) {
+    checkpoint_condition_.wait_for(lock, WAL_CHECKPOINT_POLL_INTERVAL);
+    if (stop_checkpoint_thread_) {
+      break;
+    }
+    // Under the async durability policy the periodic barrier is what makes
+    // the recording durable at all, so it runs on its period regardless of
+    // the WAL size; it includes the checkpoint the size trigger would run.
+    const bool barrier_due = durability_async_ &&
+      std::chrono::steady_clock::now() - last_barrier >= durability_barrier_period_;
+    const bool checkpoint_due = wal_path.exists() &&
+      wal_path.file_size() >= wal_checkpoint_threshold_;
+    if (!barrier_due && !checkpoint_due) {
+      continue;
+    }
+
+    lock.unlock();
+    if (barrier_due) {
+      run_durability_barrier(*checkpoint_db);
+      last_barrier = std::chrono::steady_clock::now();
+    } else {
+      try {
+        // TRUNCATE resets the WAL to zero length; when the writer holds the
+        // write lock the checkpoint simply comes back busy and the next poll
+        // tries again.
+        checkpoint_db->prepare_statement(
+          "PRAGMA wal_checkpoint(TRUNCATE);")->execute_and_reset();
+      } catch (const SqliteException & e) {
+        ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_WARN_STREAM(
+          "WAL checkpoint failed. Error: " << e.what());
+      }
+    }
+    lock.lock();
+  }
+}
+
+void SqliteStorage::run_durability_barrier(SqliteWrapper & barrier_db)
+{
+  try {
+    barrier_db.prepare_statement(
+      "CREATE TABLE IF NOT EXISTS durability_horizon("
+      "id INTEGER PRIMARY KEY CHECK (id = 1),"
+      "barrier_timestamp INTEGER NOT NULL);")->execute_and_reset();
+    // Record the newest message this connection can see. After the
+    // checkpoint and fsync below, every message up to this timestamp is in
+    // the fsynced database file, so recovery can treat the marker as the
+    // consistent horizon even when later unsynced WAL frames are lost or
+    // torn by a crash.
+    barrier_db.prepare_statement(
+      "INSERT OR REPLACE INTO durability_horizon (id, barrier_timestamp) "
+      "SELECT 1, COALESCE(MAX(timestamp), 0) FROM messages;")->execute_and_reset();
+    barrier_db.prepare_statement(
+      "PRAGMA wal_checkpoint(TRUNCATE);")->execute_and_reset();
+  } catch (const SqliteException & e) {
+    ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_WARN_STREAM(
+      "Durability barrier failed; retrying on the next period. Error: " << e.what());
+    return;
+  }
+#ifndef _WIN32
+  // The barrier connection runs with the default synchronous=NORMAL, which
+  // already syncs the database before resetting the WAL; the explicit
+  // fsync keeps the barrier meaningful even when a config file overrides
+  // the sync pragmas on all connections.
+  const int fd = ::open(relative_path_.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    ::fsync(fd);
+    ::close(fd);
+  }
+#endif
+}
+
 void SqliteStorage::activate_transaction()
 {
   if (active_transaction_) {
@@ -119,9 +472,12 @@ void SqliteStorage::activate_transaction()
   }
 
   ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_DEBUG_STREAM("begin transaction");
+  ROSBAG2_TRACEPOINT(storage_transaction_begin);
   database_->prepare_statement("BEGIN TRANSACTION;")->execute_and_reset();
 
   active_transaction_ = true;
+  transaction_begin_time_ = std::chrono::steady_clock::now();
+  bytes_at_transaction_begin_ = bytes_written_.load();
 }
 
 void SqliteStorage::commit_transaction()
@@ -131,25 +487,124 @@ void SqliteStorage::commit_transaction()
   }
 
   ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_DEBUG_STREAM("commit transaction");
+  // Commit points are the natural place to persist the per-topic
+  // aggregates: the summary lands in the same transaction as the data.
+  persist_topic_stats();
   database_->prepare_statement("COMMIT;")->execute_and_reset();
+  ROSBAG2_TRACEPOINT(storage_transaction_commit);
+  ++transactions_committed_;
 
   active_transaction_ = false;
 }
 
-void SqliteStorage::write(std::shared_ptr<const rosbag2_storage::SerializedBagMessage> message)
+void SqliteStorage::maybe_split_transaction()
 {
-  if (!write_statement_) {
-    prepare_for_writing();
+  if (commit_latency_budget_.count() <= 0 || !active_transaction_) {
+    return;
+  }
+  if (bytes_written_ - bytes_at_transaction_begin_ < adaptive_transaction_bytes_) {
+    return;
   }
-  auto topic_entry = topics_.find(message->topic_name);
+  commit_measured_transaction();
+  activate_transaction();
+}
+
+void SqliteStorage::commit_measured_transaction()
+{
+  const auto transaction_bytes = bytes_written_ - bytes_at_transaction_begin_;
+  const auto commit_start = std::chrono::steady_clock::now();
+  commit_transaction();
+  const auto commit_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - commit_start).count();
+  if (transaction_bytes < MIN_ADAPTIVE_TRANSACTION_BYTES || commit_ns <= 0) {
+    return;
+  }
+  // Commit latency is dominated by flushing the transaction's data to the
+  // WAL, so a per-byte cost tracks the message mix. Slow-moving mean, same
+  // smoothing as the other latency estimates in this codebase.
+  const auto ns_per_byte =
+    static_cast<double>(commit_ns) / static_cast<double>(transaction_bytes);
+  smoothed_commit_ns_per_byte_ = smoothed_commit_ns_per_byte_ == 0.0 ?
+    ns_per_byte :
+    smoothed_commit_ns_per_byte_ + (ns_per_byte - smoothed_commit_ns_per_byte_) / 8.0;
+  const auto budget_ns = static_cast<double>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(commit_latency_budget_).count());
+  const auto target = static_cast<uint64_t>(budget_ns / smoothed_commit_ns_per_byte_);
+  adaptive_transaction_bytes_ = std::min(
+    MAX_ADAPTIVE_TRANSACTION_BYTES, std::max(MIN_ADAPTIVE_TRANSACTION_BYTES, target));
+}
+
+void SqliteStorage::finish_batch_transaction()
+{
+  if (commit_latency_budget_.count() <= 0) {
+    commit_transaction();
+    return;
+  }
+  // Merging: a batch smaller than the current target leaves the transaction
+  // open so the next batch lands in the same commit, amortizing the commit
+  // overhead of small batches. Bounded in time so a quiet period cannot
+  // defer the commit indefinitely; close() commits whatever is left.
+  const auto pending = bytes_written_ - bytes_at_transaction_begin_;
+  if (pending >= adaptive_transaction_bytes_ ||
+    std::chrono::steady_clock::now() - transaction_begin_time_ > ADAPTIVE_COMMIT_MAX_HOLD)
+  {
+    commit_measured_transaction();
+  }
+}
+
+int SqliteStorage::get_topic_id(const std::string & topic_name) const
+{
+  auto topic_entry = topics_.find(topic_name);
   if (topic_entry == end(topics_)) {
     throw SqliteException(
-            "Topic '" + message->topic_name +
+            "Topic '" + topic_name +
             "' has not been created yet! Call 'create_topic' first.");
   }
+  return topic_entry->second;
+}
+
+int SqliteStorage::resolve_topic_id(
+  const rosbag2_storage::SerializedBagMessage & message) const
+{
+  const auto interned_id = message.topic_id;
+  if (interned_id != 0u && interned_id < db_topic_ids_by_interned_id_.size()) {
+    const auto db_topic_id = db_topic_ids_by_interned_id_[interned_id];
+    if (db_topic_id >= 0) {
+      return db_topic_id;
+    }
+  }
+  return get_topic_id(message.topic_name);
+}
 
-  write_statement_->bind(message->time_stamp, topic_entry->second, message->serialized_data);
+void SqliteStorage::write(std::shared_ptr<const rosbag2_storage::SerializedBagMessage> message)
+{
+  if (!write_statement_) {
+    prepare_for_writing();
+  }
+
+  write_statement_->bind(
+    message->time_stamp, resolve_topic_id(*message), message->serialized_data);
   write_statement_->execute_and_reset();
+
+  track_written_message(*message);
+}
+
+void SqliteStorage::track_written_message(const rosbag2_storage::SerializedBagMessage & message)
+{
+  estimated_bagfile_size_ +=
+    message.serialized_data->buffer_length + ESTIMATED_ROW_OVERHEAD;
+  bytes_written_ += message.serialized_data->buffer_length;
+  ++messages_written_;
+
+  auto & stats = topic_stats_[resolve_topic_id(message)];
+  if (stats.message_count == 0) {
+    stats.min_timestamp = message.time_stamp;
+    stats.max_timestamp = message.time_stamp;
+  } else {
+    stats.min_timestamp = std::min(stats.min_timestamp, message.time_stamp);
+    stats.max_timestamp = std::max(stats.max_timestamp, message.time_stamp);
+  }
+  ++stats.message_count;
 }
 
 void SqliteStorage::write(
@@ -161,37 +616,171 @@ void SqliteStorage::write(
 
   activate_transaction();
 
-  for (auto & message : messages) {
-    write(message);
+  // Insert full chunks through the multi-row VALUES statement so each chunk
+  // costs a single bind/step/reset cycle; the remainder goes through the
+  // single-row statement.
+  auto message_it = messages.begin();
+  auto remaining = messages.size();
+  while (remaining >= BATCH_INSERT_ROWS) {
+    try {
+      for (size_t row = 0; row < BATCH_INSERT_ROWS; ++row) {
+        const auto & message = *(message_it + row);
+        batch_write_statement_->bind(
+          message->time_stamp, resolve_topic_id(*message), message->serialized_data);
+      }
+    } catch (...) {
+      batch_write_statement_->reset();
+      throw;
+    }
+    batch_write_statement_->execute_and_reset();
+
+    for (size_t row = 0; row < BATCH_INSERT_ROWS; ++row, ++message_it) {
+      track_written_message(**message_it);
+    }
+    remaining -= BATCH_INSERT_ROWS;
+    maybe_split_transaction();
   }
 
-  commit_transaction();
+  for (; message_it != messages.end(); ++message_it) {
+    write(*message_it);
+    maybe_split_transaction();
+  }
+
+  finish_batch_transaction();
+}
+
+void SqliteStorage::write(const rosbag2_storage::SerializedBagMessageSpan & messages)
+{
+  if (!write_statement_) {
+    prepare_for_writing();
+  }
+
+  activate_transaction();
+
+  // Same chunking as the vector overload, but the blobs are bound through
+  // the non-owning raw pointer path: the span contract guarantees the
+  // messages outlive this call, so no per-message ownership reference is
+  // taken at bind time.
+  auto message_it = messages.begin();
+  auto remaining = messages.size;
+  while (remaining >= BATCH_INSERT_ROWS) {
+    try {
+      for (size_t row = 0; row < BATCH_INSERT_ROWS; ++row) {
+        const auto * message = *(message_it + row);
+        batch_write_statement_->bind(message->time_stamp, resolve_topic_id(*message));
+        batch_write_statement_->bind(message->serialized_data.get());
+      }
+    } catch (...) {
+      batch_write_statement_->reset();
+      throw;
+    }
+    batch_write_statement_->execute_and_reset();
+
+    for (size_t row = 0; row < BATCH_INSERT_ROWS; ++row, ++message_it) {
+      track_written_message(**message_it);
+    }
+    remaining -= BATCH_INSERT_ROWS;
+    maybe_split_transaction();
+  }
+
+  for (; message_it != messages.end(); ++message_it) {
+    const auto * message = *message_it;
+    write_statement_->bind(message->time_stamp, resolve_topic_id(*message));
+    write_statement_->bind(message->serialized_data.get());
+    write_statement_->execute_and_reset();
+    track_written_message(*message);
+    maybe_split_transaction();
+  }
+
+  finish_batch_transaction();
 }
 
 bool SqliteStorage::has_next()
 {
-  if (!read_statement_) {
+  if (!read_statement_ && !parallel_read_active_) {
     prepare_for_reading();
   }
+  if (parallel_read_active_) {
+    for (const auto & reader : parallel_readers_) {
+      if (reader->head) {
+        return true;
+      }
+    }
+    return false;
+  }
 
   return current_message_row_ != message_result_.end();
 }
 
 std::shared_ptr<rosbag2_storage::SerializedBagMessage> SqliteStorage::read_next()
 {
-  if (!read_statement_) {
+  if (!read_statement_ && !parallel_read_active_) {
     prepare_for_reading();
   }
+  if (parallel_read_active_) {
+    return next_merged_message();
+  }
 
   auto bag_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
-  bag_message->serialized_data = std::get<0>(*current_message_row_);
+  const auto borrowed_blob = std::get<0>(*current_message_row_);
+  bag_message->serialized_data =
+    rosbag2_storage::make_serialized_message(borrowed_blob.data, borrowed_blob.size);
   bag_message->time_stamp = std::get<1>(*current_message_row_);
-  bag_message->topic_name = std::get<2>(*current_message_row_);
+  bag_message->topic_name = topic_names_by_id_.at(std::get<2>(*current_message_row_));
+  bag_message->topic_id = static_cast<uint32_t>(std::get<2>(*current_message_row_));
 
+  bytes_read_ += borrowed_blob.size;
+  ++messages_read_;
   ++current_message_row_;
+  drop_behind_consumed_data();
   return bag_message;
 }
 
+std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> SqliteStorage::read_next_batch(
+  size_t max_batch_size)
+{
+  if (!read_statement_ && !parallel_read_active_) {
+    prepare_for_reading();
+  }
+
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> batch;
+  batch.reserve(max_batch_size);
+
+  if (parallel_read_active_) {
+    while (batch.size() < max_batch_size) {
+      auto message = next_merged_message();
+      if (!message) {
+        break;
+      }
+      batch.push_back(std::move(message));
+    }
+    return batch;
+  }
+
+  // Step the cursor directly instead of going through has_next()/read_next(),
+  // so a batch costs one statement check rather than two virtual calls and a
+  // statement check per row.
+  while (batch.size() < max_batch_size && current_message_row_ != message_result_.end()) {
+    auto bag_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+    // The blob is only valid until the cursor advances; copying it into a
+    // pooled buffer here makes the ownership hand-over explicit.
+    const auto borrowed_blob = std::get<0>(*current_message_row_);
+    bag_message->serialized_data =
+      rosbag2_storage::make_serialized_message(borrowed_blob.data, borrowed_blob.size);
+    bag_message->time_stamp = std::get<1>(*current_message_row_);
+    bag_message->topic_name = topic_names_by_id_.at(std::get<2>(*current_message_row_));
+    bag_message->topic_id = static_cast<uint32_t>(std::get<2>(*current_message_row_));
+
+    bytes_read_ += borrowed_blob.size;
+    ++messages_read_;
+    batch.push_back(std::move(bag_message));
+    ++current_message_row_;
+  }
+  drop_behind_consumed_data();
+
+  return batch;
+}
+
 std::vector<rosbag2_storage::TopicMetadata> SqliteStorage::get_all_topics_and_types()
 {
   if (all_topics_and_types_.empty()) {
@@ -203,11 +792,161 @@ std::vector<rosbag2_storage::TopicMetadata> SqliteStorage::get_all_topics_and_ty
 
 uint64_t SqliteStorage::get_bagfile_size() const
 {
+  if (estimated_bagfile_size_ > 0u) {
+    return estimated_bagfile_size_;
+  }
+
   const auto bag_path = rcpputils::fs::path{get_relative_file_path()};
 
   return bag_path.exists() ? bag_path.file_size() : 0u;
 }
 
+rosbag2_storage::IOStatistics SqliteStorage::get_io_statistics() const
+{
+  rosbag2_storage::IOStatistics statistics;
+  statistics.bytes_written = bytes_written_;
+  statistics.bytes_read = bytes_read_;
+  statistics.messages_written = messages_written_;
+  statistics.messages_read = messages_read_;
+  statistics.transactions_committed = transactions_committed_;
+
+  const auto wal_path = rcpputils::fs::path{relative_path_ + "-wal"};
+  if (wal_path.exists()) {
+    statistics.write_ahead_log_size = wal_path.file_size();
+  }
+
+  if (database_) {
+    statistics.page_cache_hits = database_->get_db_status(SQLITE_DBSTATUS_CACHE_HIT);
+    statistics.page_cache_misses = database_->get_db_status(SQLITE_DBSTATUS_CACHE_MISS);
+  }
+
+  return statistics;
+}
+
+void SqliteStorage::set_storage_config(const std::string & storage_config_uri)
+{
+  storage_config_uri_ = storage_config_uri;
+}
+
+void SqliteStorage::preallocate(uint64_t expected_file_size)
+{
+  // The size hint makes the VFS fallocate the expected file size in one
+  // piece, so split files do not fragment by growing page by page. sqlite
+  // itself keeps track of the logical database size, so no trim is needed
+  // for files which stay smaller than the hint.
+  database_->set_file_size_hint(expected_file_size);
+}
+
+void SqliteStorage::apply_storage_config()
+{
+  std::ifstream config_file(storage_config_uri_);
+  if (!config_file) {
+    throw std::runtime_error(
+            "Failed to read storage config file '" + storage_config_uri_ + "'.");
+  }
+
+  std::string line;
+  while (std::getline(config_file, line)) {
+    // Strip leading whitespace, skip blank lines and '#' comments.
+    const auto first_char = line.find_first_not_of(" \t\r");
+    if (first_char == std::string::npos || line[first_char] == '#') {
+      continue;
+    }
+    line = line.substr(first_char);
+
+    // Only pragmas are accepted; everything else would allow arbitrary
+    // schema manipulation through the config file.
+    if (line.compare(0, 6, "PRAGMA") != 0 && line.compare(0, 6, "pragma") != 0) {
+      throw std::runtime_error(
+              "Invalid line in storage config file '" + storage_config_uri_ +
+              "': only PRAGMA statements are allowed, got '" + line + "'.");
+    }
+
+    // Plugin settings piggyback on the pragma syntax; they are consumed
+    // here and never reach sqlite.
+    if (line.find(WAL_CHECKPOINT_THRESHOLD_PRAGMA) != std::string::npos) {
+      const auto assignment = line.find('=');
+      if (assignment == std::string::npos) {
+        throw std::runtime_error(
+                "Missing value for '" + std::string(WAL_CHECKPOINT_THRESHOLD_PRAGMA) +
+                "' in storage config file '" + storage_config_uri_ + "'.");
+      }
+      wal_checkpoint_threshold_ = std::stoull(line.substr(assignment + 1));
+      continue;
+    }
+    if (line.find(OPTIMIZE_ON_CLOSE_PRAGMA) != std::string::npos) {
+      const auto assignment = line.find('=');
+      // 'PRAGMA optimize_on_close;' and any value other than 0 enable it.
+      optimize_on_close_ = assignment == std::string::npos ||
+        std::stoll(line.substr(assignment + 1)) != 0;
+      continue;
+    }
+    if (line.find(DURABILITY_BARRIER_PERIOD_PRAGMA) != std::string::npos) {
+      const auto assignment = line.find('=');
+      if (assignment == std::string::npos) {
+        throw std::runtime_error(
+                "Missing value for '" + std::string(DURABILITY_BARRIER_PERIOD_PRAGMA) +
+                "' in storage config file '" + storage_config_uri_ + "'.");
+      }
+      durability_barrier_period_ = std::chrono::seconds(std::stoll(line.substr(assignment + 1)));
+      continue;
+    }
+    if (line.find(DURABILITY_PRAGMA) != std::string::npos) {
+      const auto assignment = line.find('=');
+      if (assignment == std::string::npos) {
+        throw std::runtime_error(
+                "Missing value for '" + std::string(DURABILITY_PRAGMA) +
+                "' in storage config file '" + storage_config_uri_ + "'.");
+      }
+      auto value = line.substr(assignment + 1);
+      value.erase(std::remove_if(
+          value.begin(), value.end(),
+          [](char c) {return c == ' ' || c == '\t' || c == ';' || c == '\r';}), value.end());
+      if (value == "async") {
+        durability_async_ = true;
+      } else if (value == "normal") {
+        durability_async_ = false;
+      } else {
+        throw std::runtime_error(
+                "Invalid value '" + value + "' for '" + std::string(DURABILITY_PRAGMA) +
+                "' in storage config file '" + storage_config_uri_ +
+                "': expected 'normal' or 'async'.");
+      }
+      continue;
+    }
+    if (line.find(EXCLUSIVE_LOCKING_PRAGMA) != std::string::npos) {
+      // Already parsed before the connection was opened; see open().
+      continue;
+    }
+    if (line.find(COMMIT_LATENCY_BUDGET_PRAGMA) != std::string::npos) {
+      const auto assignment = line.find('=');
+      if (assignment == std::string::npos) {
+        throw std::runtime_error(
+                "Missing value for '" + std::string(COMMIT_LATENCY_BUDGET_PRAGMA) +
+                "' in storage config file '" + storage_config_uri_ + "'.");
+      }
+      commit_latency_budget_ =
+        std::chrono::milliseconds(std::stoll(line.substr(assignment + 1)));
+      continue;
+    }
+    if (line.find(READ_DROP_BEHIND_PRAGMA) != std::string::npos) {
+      const auto assignment = line.find('=');
+      read_drop_behind_enabled_ = assignment == std::string::npos ||
+        std::stoll(line.substr(assignment + 1)) != 0;
+      continue;
+    }
+    if (line.find(READ_HINTS_PRAGMA) != std::string::npos) {
+      const auto assignment = line.find('=');
+      read_hints_enabled_ = assignment == std::string::npos ||
+        std::stoll(line.substr(assignment + 1)) != 0;
+      continue;
+    }
+
+    ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_DEBUG_STREAM("applying storage config: " << line);
+    database_->prepare_statement(line)->execute_and_reset();
+  }
+}
+
 void SqliteStorage::initialize()
 {
   std::string create_stmt = "CREATE TABLE topics(" \
@@ -225,6 +964,52 @@ void SqliteStorage::initialize()
   database_->prepare_statement(create_stmt)->execute_and_reset();
   create_stmt = "CREATE INDEX timestamp_idx ON messages (timestamp ASC);";
   database_->prepare_statement(create_stmt)->execute_and_reset();
+  create_stmt = "CREATE TABLE metadata_summary(" \
+    "topic_id INTEGER PRIMARY KEY," \
+    "message_count INTEGER NOT NULL," \
+    "min_timestamp INTEGER NOT NULL," \
+    "max_timestamp INTEGER NOT NULL);";
+  database_->prepare_statement(create_stmt)->execute_and_reset();
+}
+
+void SqliteStorage::persist_topic_stats()
+{
+  if (!db_read_write_ || topic_stats_.empty()) {
+    return;
+  }
+
+  auto statement = database_->prepare_statement(
+    "INSERT OR REPLACE INTO metadata_summary "
+    "(topic_id, message_count, min_timestamp, max_timestamp) VALUES (?, ?, ?, ?);");
+  for (const auto & entry : topic_stats_) {
+    statement->bind(
+      entry.first,
+      static_cast<rcutils_time_point_value_t>(entry.second.message_count),
+      entry.second.min_timestamp,
+      entry.second.max_timestamp);
+    statement->execute_and_reset();
+  }
+}
+
+bool SqliteStorage::read_topic_stats_from_summary()
+{
+  auto table_query = database_->prepare_statement(
+    "SELECT COUNT(*) FROM sqlite_master "
+    "WHERE type = 'table' AND name = 'metadata_summary';");
+  if (std::get<0>(table_query->execute_query<int>().get_single_line()) == 0) {
+    // Bag predates the summary table.
+    return false;
+  }
+
+  auto statement = database_->prepare_statement(
+    "SELECT topic_id, message_count, min_timestamp, max_timestamp FROM metadata_summary;");
+  auto query_results = statement->execute_query<
+    int, rcutils_time_point_value_t, rcutils_time_point_value_t, rcutils_time_point_value_t>();
+  for (auto result : query_results) {
+    topic_stats_[std::get<0>(result)] = {
+      static_cast<uint64_t>(std::get<1>(result)), std::get<2>(result), std::get<3>(result)};
+  }
+  return true;
 }
 
 void SqliteStorage::create_topic(const rosbag2_storage::TopicMetadata & topic)
@@ -237,7 +1022,14 @@ void SqliteStorage::create_topic(const rosbag2_storage::TopicMetadata & topic)
     insert_topic->bind(
       topic.name, topic.type, topic.serialization_format, topic.offered_qos_profiles);
     insert_topic->execute_and_reset();
-    topics_.emplace(topic.name, static_cast<int>(database_->get_last_insert_id()));
+    const auto db_topic_id = static_cast<int>(database_->get_last_insert_id());
+    topics_.emplace(topic.name, db_topic_id);
+    if (topic.topic_id != 0u) {
+      if (db_topic_ids_by_interned_id_.size() <= topic.topic_id) {
+        db_topic_ids_by_interned_id_.resize(topic.topic_id + 1, -1);
+      }
+      db_topic_ids_by_interned_id_[topic.topic_id] = db_topic_id;
+    }
   }
 }
 
@@ -250,6 +1042,9 @@ void SqliteStorage::remove_topic(const rosbag2_storage::TopicMetadata & topic)
     delete_topic->bind(topic.name, topic.type, topic.serialization_format);
     delete_topic->execute_and_reset();
     topics_.erase(topic.name);
+    if (topic.topic_id != 0u && topic.topic_id < db_topic_ids_by_interned_id_.size()) {
+      db_topic_ids_by_interned_id_[topic.topic_id] = -1;
+    }
   }
 }
 
@@ -257,45 +1052,447 @@ void SqliteStorage::prepare_for_writing()
 {
   write_statement_ = database_->prepare_statement(
     "INSERT INTO messages (timestamp, topic_id, data) VALUES (?, ?, ?);");
+
+  std::string batch_insert = "INSERT INTO messages (timestamp, topic_id, data) VALUES ";
+  for (size_t row = 0; row < BATCH_INSERT_ROWS; ++row) {
+    batch_insert += row == 0 ? "(?, ?, ?)" : ", (?, ?, ?)";
+  }
+  batch_insert += ";";
+  batch_write_statement_ = database_->prepare_statement(batch_insert);
+}
+
+void SqliteStorage::apply_read_hints()
+{
+#ifndef _WIN32
+  if (!read_hints_enabled_ || read_hints_fd_ >= 0) {
+    return;
+  }
+  read_hints_fd_ = ::open(relative_path_.c_str(), O_RDONLY);
+  if (read_hints_fd_ < 0) {
+    // Purely advisory; reading works without the hints.
+    return;
+  }
+  // The message query walks timestamp_idx, which closely follows the
+  // append order of the file, so tell the kernel up front that the whole
+  // file is about to be streamed instead of letting it detect the access
+  // pattern over the first megabytes.
+  posix_fadvise(read_hints_fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+  posix_fadvise(read_hints_fd_, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+}
+
+void SqliteStorage::drop_behind_consumed_data()
+{
+#ifndef _WIN32
+  if (!read_drop_behind_enabled_ || read_hints_fd_ < 0) {
+    return;
+  }
+  // bytes_read_ only counts message payload and therefore trails the file
+  // offset actually consumed, so whole chunks behind it are safe to
+  // release even though rows are not laid out strictly in read order.
+  const uint64_t consumed = bytes_read_;
+  if (consumed < drop_behind_offset_ + DROP_BEHIND_CHUNK_SIZE) {
+    return;
+  }
+  const uint64_t drop_end = consumed - consumed % DROP_BEHIND_CHUNK_SIZE;
+  posix_fadvise(
+    read_hints_fd_, static_cast<off_t>(drop_behind_offset_),
+    static_cast<off_t>(drop_end - drop_behind_offset_), POSIX_FADV_DONTNEED);
+  drop_behind_offset_ = drop_end;
+#endif
+}
+
+bool SqliteStorage::sparse_index_available()
+{
+  if (!sparse_index_checked_) {
+    auto table_query = database_->prepare_statement(
+      "SELECT COUNT(*) FROM sqlite_master "
+      "WHERE type = 'table' AND name = 'sparse_timestamp_idx';");
+    sparse_index_available_ =
+      std::get<0>(table_query->execute_query<int>().get_single_line()) != 0;
+    sparse_index_checked_ = true;
+  }
+  return sparse_index_available_;
+}
+
+uint64_t SqliteStorage::sparse_rowid_lower_bound(rcutils_time_point_value_t lower_time_bound)
+{
+  if (!sparse_index_available()) {
+    return 0;  // bag predates the sparse index, or the split was not sealed
+  }
+  auto statement = database_->prepare_statement(
+    "SELECT COALESCE(MAX(message_id), 0) FROM sparse_timestamp_idx "
+    "WHERE timestamp < " + std::to_string(lower_time_bound) + ";");
+  const auto sampled_row = static_cast<uint64_t>(
+    std::get<0>(statement->execute_query<rcutils_time_point_value_t>().get_single_line()));
+  // Step back one stride so timestamps recorded mildly out of order around
+  // the sample are not skipped; the time bounds in the WHERE clause stay
+  // authoritative for which rows are returned.
+  return sampled_row > SPARSE_INDEX_STRIDE ? sampled_row - SPARSE_INDEX_STRIDE : 0;
+}
+
+uint64_t SqliteStorage::sparse_rowid_upper_bound(rcutils_time_point_value_t upper_time_bound)
+{
+  if (!sparse_index_available()) {
+    return 0;
+  }
+  auto statement = database_->prepare_statement(
+    "SELECT COALESCE(MIN(message_id), 0) FROM sparse_timestamp_idx "
+    "WHERE timestamp > " + std::to_string(upper_time_bound) + ";");
+  const auto sampled_row = static_cast<uint64_t>(
+    std::get<0>(statement->execute_query<rcutils_time_point_value_t>().get_single_line()));
+  // One stride of slack, mirroring sparse_rowid_lower_bound().
+  return sampled_row > 0 ? sampled_row + SPARSE_INDEX_STRIDE : 0;
 }
 
 void SqliteStorage::prepare_for_reading()
 {
-  if (!storage_filter_.topics.empty()) {
-    // Construct string for selected topics
-    std::string topic_list{""};
-    for (auto & topic : storage_filter_.topics) {
-      topic_list += "'" + topic + "'";
-      if (&topic != &storage_filter_.topics.back()) {
-        topic_list += ",";
+  fill_topic_names_by_id();
+
+  std::vector<int> selected_topic_ids;
+  const bool has_topic_filter = resolve_topic_filter(selected_topic_ids);
+  const auto window_conditions = read_window_conditions();
+
+  // A filtered read over a handful of topics overlaps sqlite page decoding
+  // across one cursor per topic; see try_start_parallel_reading().
+  if (has_topic_filter && try_start_parallel_reading(selected_topic_ids, window_conditions)) {
+    return;
+  }
+
+  apply_read_hints();
+
+  std::vector<std::string> conditions;
+  if (has_topic_filter) {
+    std::string topic_id_list{""};
+    for (const auto topic_id : selected_topic_ids) {
+      if (!topic_id_list.empty()) {
+        topic_id_list += ",";
       }
+      topic_id_list += std::to_string(topic_id);
+    }
+    if (topic_id_list.empty()) {
+      topic_id_list = "-1";  // filter matches no recorded topic
     }
+    conditions.push_back("topic_id IN (" + topic_id_list + ")");
+  }
+  conditions.insert(conditions.end(), window_conditions.begin(), window_conditions.end());
 
-    read_statement_ = database_->prepare_statement(
-      "SELECT data, timestamp, topics.name "
-      "FROM messages JOIN topics ON messages.topic_id = topics.id "
-      "WHERE topics.name IN (" + topic_list + ")"
-      "ORDER BY messages.timestamp;");
-  } else {
-    read_statement_ = database_->prepare_statement(
-      "SELECT data, timestamp, topics.name "
-      "FROM messages JOIN topics ON messages.topic_id = topics.id "
-      "ORDER BY messages.timestamp;");
+  std::string where_clause{""};
+  for (const auto & condition : conditions) {
+    where_clause += where_clause.empty() ? "WHERE " : " AND ";
+    where_clause += condition;
   }
+
+  // Both directions walk timestamp_idx; the reverse cursor just walks it
+  // descending, so reading backwards costs the same as reading forward.
+  const std::string order_clause =
+    read_order_ == rosbag2_storage::ReadOrder::REVERSE ?
+    "ORDER BY messages.timestamp DESC;" : "ORDER BY messages.timestamp;";
+
+  read_statement_ = database_->prepare_statement(
+    "SELECT data, timestamp, topic_id "
+    "FROM messages " + where_clause + " " + order_clause);
   message_result_ = read_statement_->execute_query<
-    std::shared_ptr<rcutils_uint8_array_t>, rcutils_time_point_value_t, std::string>();
+    SqliteBorrowedBlob, rcutils_time_point_value_t, int>();
   current_message_row_ = message_result_.begin();
 }
 
+bool SqliteStorage::resolve_topic_filter(std::vector<int> & selected_topic_ids)
+{
+  const bool has_topic_filter = !storage_filter_.topics.empty() ||
+    !storage_filter_.topics_regex.empty() ||
+    !storage_filter_.topics_regex_to_exclude.empty();
+  if (!has_topic_filter) {
+    return false;
+  }
+  // Resolve the filter against the topics table once so the message
+  // query restricts on the integer column and does not need a JOIN or
+  // per-row pattern matching.
+  const std::regex include_regex{storage_filter_.topics_regex};
+  const std::regex exclude_regex{storage_filter_.topics_regex_to_exclude};
+  // With neither a topic list nor an include pattern, everything not
+  // excluded is selected.
+  const bool include_all =
+    storage_filter_.topics.empty() && storage_filter_.topics_regex.empty();
+
+  for (const auto & entry : topic_names_by_id_) {
+    bool selected = include_all ||
+      std::find(
+      storage_filter_.topics.begin(), storage_filter_.topics.end(),
+      entry.second) != storage_filter_.topics.end() ||
+      (!storage_filter_.topics_regex.empty() &&
+      std::regex_search(entry.second, include_regex));
+    if (selected && !storage_filter_.topics_regex_to_exclude.empty() &&
+      std::regex_search(entry.second, exclude_regex))
+    {
+      selected = false;
+    }
+    if (selected) {
+      selected_topic_ids.push_back(entry.first);
+    }
+  }
+  return true;
+}
+
+std::vector<std::string> SqliteStorage::read_window_conditions()
+{
+  std::vector<std::string> conditions;
+  // The time bounds are served by timestamp_idx, so a narrow window out of a
+  // large bag does not scan and discard everything before the window.
+  // A seek target tightens the bound the cursor starts from: the lower one
+  // when reading forward, the upper one when reading in reverse.
+  auto lower_time_bound = storage_filter_.start_time;
+  auto upper_time_bound = storage_filter_.end_time;
+  if (seek_time_ >= 0) {
+    if (read_order_ == rosbag2_storage::ReadOrder::FORWARD) {
+      lower_time_bound = std::max(lower_time_bound, seek_time_);
+    } else {
+      upper_time_bound =
+        upper_time_bound >= 0 ? std::min(upper_time_bound, seek_time_) : seek_time_;
+    }
+  }
+  if (lower_time_bound >= 0) {
+    conditions.push_back("timestamp >= " + std::to_string(lower_time_bound));
+  }
+  if (upper_time_bound >= 0) {
+    conditions.push_back("timestamp <= " + std::to_string(upper_time_bound));
+  }
+  // The sparse in-file index turns the bound the cursor starts from into a
+  // rowid bound with a single small lookup, so scrubbing within a large
+  // split starts within SPARSE_INDEX_STRIDE messages of the target instead
+  // of descending a large timestamp_idx range. Bags without the side table
+  // read exactly as before.
+  if (lower_time_bound >= 0) {
+    const auto start_row = sparse_rowid_lower_bound(lower_time_bound);
+    if (start_row > 0) {
+      conditions.push_back("id >= " + std::to_string(start_row));
+    }
+  }
+  if (upper_time_bound >= 0) {
+    const auto end_row = sparse_rowid_upper_bound(upper_time_bound);
+    if (end_row > 0) {
+      conditions.push_back("id <= " + std::to_string(end_row));
+    }
+  }
+  return conditions;
+}
+
+bool SqliteStorage::try_start_parallel_reading(
+  const std::vector<int> & selected_topic_ids,
+  const std::vector<std::string> & window_conditions)
+{
+  // One cursor per topic only pays off when there is per-cursor decoding
+  // work to overlap; a single topic gains nothing and beyond
+  // MAX_PARALLEL_READ_CURSORS the cursors would contend for the disk.
+  if (selected_topic_ids.size() < 2 ||
+    selected_topic_ids.size() > MAX_PARALLEL_READ_CURSORS)
+  {
+    return false;
+  }
+  // Without the composite index every per-topic cursor would scan and
+  // discard the other topics' rows, so the merged cursor stays cheaper.
+  auto index_query = database_->prepare_statement(
+    "SELECT COUNT(*) FROM sqlite_master "
+    "WHERE type = 'index' AND name = 'topic_timestamp_idx';");
+  if (std::get<0>(index_query->execute_query<int>().get_single_line()) == 0) {
+    return false;
+  }
+
+  const std::string order_clause =
+    read_order_ == rosbag2_storage::ReadOrder::REVERSE ?
+    "ORDER BY messages.timestamp DESC;" : "ORDER BY messages.timestamp;";
+
+  for (const auto topic_id : selected_topic_ids) {
+    std::string where_clause = "WHERE topic_id = " + std::to_string(topic_id);
+    for (const auto & condition : window_conditions) {
+      where_clause += " AND " + condition;
+    }
+    auto reader = std::make_unique<ParallelTopicReader>();
+    reader->query = "SELECT data, timestamp, topic_id "
+      "FROM messages " + where_clause + " " + order_clause;
+    parallel_readers_.push_back(std::move(reader));
+  }
+  for (auto & reader : parallel_readers_) {
+    reader->thread = std::thread(
+      &SqliteStorage::parallel_reader_loop, this, std::ref(*reader));
+  }
+  parallel_read_active_ = true;
+
+  // Fill every cursor's head so the merge can start; a failure here (e.g.
+  // the read-only side connections cannot open) falls back to the merged
+  // single cursor instead of failing the read.
+  try {
+    for (auto & reader : parallel_readers_) {
+      reader->head = take_from_reader(*reader);
+    }
+  } catch (const SqliteException & e) {
+    ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_WARN_STREAM(
+      "Could not start parallel filtered read, falling back to a single "
+      "cursor. Error: " << e.what());
+    stop_parallel_reading();
+    return false;
+  }
+  return true;
+}
+
+void SqliteStorage::parallel_reader_loop(ParallelTopicReader & reader)
+{
+  try {
+    // The database file is immutable while reading, so a private read-only
+    // connection per cursor is safe and lets sqlite decode pages for each
+    // topic concurrently.
+    SqliteWrapper connection{
+      relative_path_, rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY};
+    auto statement = connection.prepare_statement(reader.query);
+    auto result = statement->execute_query<
+      SqliteBorrowedBlob, rcutils_time_point_value_t, int>();
+    for (auto row = result.begin(); row != result.end(); ++row) {
+      // The blob is only lent out until the cursor advances, so it is
+      // copied into a pooled buffer before crossing the thread boundary.
+      auto bag_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+      const auto borrowed_blob = std::get<0>(*row);
+      bag_message->serialized_data =
+        rosbag2_storage::make_serialized_message(borrowed_blob.data, borrowed_blob.size);
+      bag_message->time_stamp = std::get<1>(*row);
+      bag_message->topic_name = topic_names_by_id_.at(std::get<2>(*row));
+      bag_message->topic_id = static_cast<uint32_t>(std::get<2>(*row));
+
+      std::unique_lock<std::mutex> lock(reader.mutex);
+      reader.space_available.wait(
+        lock,
+        [&reader] {return reader.rows.size() < PARALLEL_READ_QUEUE_DEPTH || reader.stop;});
+      if (reader.stop) {
+        break;
+      }
+      reader.rows.push_back(std::move(bag_message));
+      lock.unlock();
+      reader.row_available.notify_one();
+    }
+  } catch (const SqliteException & e) {
+    std::lock_guard<std::mutex> lock(reader.mutex);
+    reader.error = e.what();
+  }
+  {
+    std::lock_guard<std::mutex> lock(reader.mutex);
+    reader.done = true;
+  }
+  reader.row_available.notify_one();
+}
+
+std::shared_ptr<rosbag2_storage::SerializedBagMessage> SqliteStorage::take_from_reader(
+  ParallelTopicReader & reader)
+{
+  std::unique_lock<std::mutex> lock(reader.mutex);
+  reader.row_available.wait(lock, [&reader] {return !reader.rows.empty() || reader.done;});
+  if (reader.rows.empty()) {
+    if (!reader.error.empty()) {
+      throw SqliteException{reader.error};
+    }
+    return nullptr;
+  }
+  auto message = std::move(reader.rows.front());
+  reader.rows.pop_front();
+  lock.unlock();
+  reader.space_available.notify_one();
+  return message;
+}
+
+std::shared_ptr<rosbag2_storage::SerializedBagMessage> SqliteStorage::next_merged_message()
+{
+  // With at most MAX_PARALLEL_READ_CURSORS cursors, a linear scan over the
+  // heads costs the same as maintaining a heap would.
+  ParallelTopicReader * best = nullptr;
+  for (auto & reader : parallel_readers_) {
+    if (!reader->head) {
+      continue;
+    }
+    const bool precedes = best == nullptr ||
+      (read_order_ == rosbag2_storage::ReadOrder::REVERSE ?
+      reader->head->time_stamp > best->head->time_stamp :
+      reader->head->time_stamp < best->head->time_stamp);
+    if (precedes) {
+      best = reader.get();
+    }
+  }
+  if (best == nullptr) {
+    return nullptr;
+  }
+  auto message = std::move(best->head);
+  best->head = take_from_reader(*best);
+  bytes_read_ += message->serialized_data->buffer_length;
+  ++messages_read_;
+  return message;
+}
+
+void SqliteStorage::stop_parallel_reading()
+{
+  for (auto & reader : parallel_readers_) {
+    {
+      std::lock_guard<std::mutex> lock(reader->mutex);
+      reader->stop = true;
+    }
+    reader->space_available.notify_one();
+  }
+  for (auto & reader : parallel_readers_) {
+    if (reader->thread.joinable()) {
+      reader->thread.join();
+    }
+  }
+  parallel_readers_.clear();
+  parallel_read_active_ = false;
+}
+
+void SqliteStorage::seek(rcutils_time_point_value_t timestamp)
+{
+  // Drop the current cursor; the next read re-prepares the statement with
+  // the tightened time bound, which is an O(log n) lookup through
+  // timestamp_idx instead of a scan from the beginning.
+  seek_time_ = timestamp;
+  read_statement_ = nullptr;
+  stop_parallel_reading();
+}
+
+void SqliteStorage::set_read_order(rosbag2_storage::ReadOrder read_order)
+{
+  if (read_order == read_order_) {
+    return;
+  }
+  // Drop the current cursor; the next read re-prepares the statement with
+  // the flipped ORDER BY direction from the current seek position.
+  read_order_ = read_order;
+  read_statement_ = nullptr;
+  stop_parallel_reading();
+}
+
+void SqliteStorage::fill_topic_names_by_id()
+{
+  if (!topic_names_by_id_.empty()) {
+    return;
+  }
+
+  auto statement = database_->prepare_statement("SELECT id, name FROM topics;");
+  auto query_results = statement->execute_query<int, std::string>();
+
+  for (auto result : query_results) {
+    topic_names_by_id_.emplace(std::get<0>(result), std::get<1>(result));
+  }
+}
+
 void SqliteStorage::fill_topics_and_types()
 {
   auto statement = database_->prepare_statement(
-    "SELECT name, type, serialization_format FROM topics ORDER BY id;");
-  auto query_results = statement->execute_query<std::string, std::string, std::string>();
+    "SELECT id, name, type, serialization_format FROM topics ORDER BY id;");
+  auto query_results = statement->execute_query<int, std::string, std::string, std::string>();
 
   for (auto result : query_results) {
-    all_topics_and_types_.push_back(
-      {std::get<0>(result), std::get<1>(result), std::get<2>(result), ""});
+    rosbag2_storage::TopicMetadata topic_metadata;
+    topic_metadata.name = std::get<1>(result);
+    topic_metadata.type = std::get<2>(result);
+    topic_metadata.serialization_format = std::get<3>(result);
+    // Expose the database topic id; messages of the read path carry it, so
+    // consumers can build id-indexed structures from this listing.
+    topic_metadata.topic_id = static_cast<uint32_t>(std::get<0>(result));
+    all_topics_and_types_.push_back(topic_metadata);
   }
 }
 
@@ -323,27 +1520,56 @@ rosbag2_storage::BagMetadata SqliteStorage::get_metadata()
   metadata.message_count = 0;
   metadata.topics_with_message_count = {};
 
-  auto statement = database_->prepare_statement(
-    "SELECT name, type, serialization_format, COUNT(messages.id), MIN(messages.timestamp), "
-    "MAX(messages.timestamp), offered_qos_profiles "
-    "FROM messages JOIN topics on topics.id = messages.topic_id "
-    "GROUP BY topics.name;");
-  auto query_results = statement->execute_query<
-    std::string, std::string, std::string, int, rcutils_time_point_value_t,
-    rcutils_time_point_value_t, std::string>();
-
   rcutils_time_point_value_t min_time = INT64_MAX;
   rcutils_time_point_value_t max_time = 0;
-  for (auto result : query_results) {
-    metadata.topics_with_message_count.push_back(
-      {
-        {std::get<0>(result), std::get<1>(result), std::get<2>(result), std::get<6>(result)},
-        static_cast<size_t>(std::get<3>(result))
-      });
 
-    metadata.message_count += std::get<3>(result);
-    min_time = std::get<4>(result) < min_time ? std::get<4>(result) : min_time;
-    max_time = std::get<5>(result) > max_time ? std::get<5>(result) : max_time;
+  if (!topic_stats_.empty() || read_topic_stats_from_summary()) {
+    // The aggregates were maintained incrementally while writing (or read
+    // from the summary table), so only the small topics table is scanned.
+    auto statement = database_->prepare_statement(
+      "SELECT id, name, type, serialization_format, offered_qos_profiles "
+      "FROM topics ORDER BY name;");
+    auto query_results = statement->execute_query<
+      int, std::string, std::string, std::string, std::string>();
+
+    for (auto result : query_results) {
+      auto stats = topic_stats_.find(std::get<0>(result));
+      if (stats == topic_stats_.end()) {
+        continue;  // topic without messages, matching the aggregation below
+      }
+      metadata.topics_with_message_count.push_back(
+        {
+          {std::get<1>(result), std::get<2>(result), std::get<3>(result), std::get<4>(result)},
+          static_cast<size_t>(stats->second.message_count)
+        });
+
+      metadata.message_count += stats->second.message_count;
+      min_time = std::min(min_time, stats->second.min_timestamp);
+      max_time = std::max(max_time, stats->second.max_timestamp);
+    }
+  } else {
+    // Bags recorded before the summary table existed: aggregate over the
+    // full messages table.
+    auto statement = database_->prepare_statement(
+      "SELECT name, type, serialization_format, COUNT(messages.id), MIN(messages.timestamp), "
+      "MAX(messages.timestamp), offered_qos_profiles "
+      "FROM messages JOIN topics on topics.id = messages.topic_id "
+      "GROUP BY topics.name;");
+    auto query_results = statement->execute_query<
+      std::string, std::string, std::string, int, rcutils_time_point_value_t,
+      rcutils_time_point_value_t, std::string>();
+
+    for (auto result : query_results) {
+      metadata.topics_with_message_count.push_back(
+        {
+          {std::get<0>(result), std::get<1>(result), std::get<2>(result), std::get<6>(result)},
+          static_cast<size_t>(std::get<3>(result))
+        });
+
+      metadata.message_count += std::get<3>(result);
+      min_time = std::get<4>(result) < min_time ? std::get<4>(result) : min_time;
+      max_time = std::get<5>(result) > max_time ? std::get<5>(result) : max_time;
+    }
   }
 
   if (metadata.message_count == 0) {
@@ -359,6 +1585,35 @@ rosbag2_storage::BagMetadata SqliteStorage::get_metadata()
   return metadata;
 }
 
+std::vector<rosbag2_storage::TopicStatistics> SqliteStorage::get_topic_statistics()
+{
+  std::vector<rosbag2_storage::TopicStatistics> statistics;
+
+  // One aggregation pass inside sqlite instead of handing every message to
+  // the client. LENGTH() on a blob column is answered from the record
+  // header, so the payloads themselves are never loaded.
+  auto statement = database_->prepare_statement(
+    "SELECT topics.name, COUNT(messages.id), COALESCE(SUM(LENGTH(messages.data)), 0), "
+    "MIN(messages.timestamp), MAX(messages.timestamp) "
+    "FROM messages JOIN topics ON topics.id = messages.topic_id "
+    "GROUP BY topics.name ORDER BY topics.name;");
+  auto query_results = statement->execute_query<
+    std::string, rcutils_time_point_value_t, rcutils_time_point_value_t,
+    rcutils_time_point_value_t, rcutils_time_point_value_t>();
+
+  for (auto result : query_results) {
+    rosbag2_storage::TopicStatistics topic_statistics;
+    topic_statistics.topic_name = std::get<0>(result);
+    topic_statistics.message_count = static_cast<uint64_t>(std::get<1>(result));
+    topic_statistics.byte_count = static_cast<uint64_t>(std::get<2>(result));
+    topic_statistics.first_timestamp_ns = std::get<3>(result);
+    topic_statistics.last_timestamp_ns = std::get<4>(result);
+    statistics.push_back(topic_statistics);
+  }
+
+  return statistics;
+}
+
 void SqliteStorage::set_filter(
   const rosbag2_storage::StorageFilter & storage_filter)
 {
@@ -27,11 +27,19 @@
 
 #include "../logging.hpp"
 
+namespace
+{
+// Upper bound for compiled statements kept per connection; the working set
+// of the recorder and player is a handful of statements.
+constexpr const size_t MAX_CACHED_STATEMENTS = 16;
+}  // namespace
+
 namespace rosbag2_storage_plugins
 {
 
 SqliteWrapper::SqliteWrapper(
-  const std::string & uri, rosbag2_storage::storage_interfaces::IOFlag io_flag)
+  const std::string & uri, rosbag2_storage::storage_interfaces::IOFlag io_flag,
+  bool exclusive_locking)
 : db_ptr(nullptr)
 {
   if (io_flag == rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY) {
@@ -56,6 +64,14 @@ SqliteWrapper::SqliteWrapper(
         rc << "): " << sqlite3_errstr(rc);
       throw SqliteException{errmsg.str()};
     }
+    if (exclusive_locking) {
+      // Must come before the first database access: entering WAL mode with
+      // the file lock already held makes sqlite put the wal-index on the
+      // heap instead of in a shared-memory file, so no WAL locks have to be
+      // taken and released per statement. The lock itself is acquired by
+      // the first read or write and never given up.
+      prepare_statement("PRAGMA locking_mode = EXCLUSIVE;")->execute_and_reset();
+    }
     prepare_statement("PRAGMA journal_mode = WAL;")->execute_and_reset();
     prepare_statement("PRAGMA synchronous = NORMAL;")->execute_and_reset();
   }
@@ -68,6 +84,10 @@ SqliteWrapper::SqliteWrapper()
 
 SqliteWrapper::~SqliteWrapper()
 {
+  // Finalize cached statements before closing, otherwise close reports
+  // unfinalized statements as busy.
+  statement_cache_index_.clear();
+  statement_cache_.clear();
   const int rc = sqlite3_close(db_ptr);
   if (rc != SQLITE_OK) {
     ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_ERROR_STREAM(
@@ -78,7 +98,30 @@ SqliteWrapper::~SqliteWrapper()
 
 SqliteStatement SqliteWrapper::prepare_statement(const std::string & query)
 {
-  return std::make_shared<SqliteStatementWrapper>(db_ptr, query);
+  auto cache_entry = statement_cache_index_.find(query);
+  if (cache_entry != statement_cache_index_.end()) {
+    auto statement = cache_entry->second->second;
+    // The cached statement can only be handed out when its previous
+    // borrower has released it (use count: cache entry + local copy);
+    // otherwise compile a private copy so bindings cannot clash.
+    if (statement.use_count() == 2) {
+      statement_cache_.splice(
+        statement_cache_.begin(), statement_cache_, cache_entry->second);
+      return statement->reset();
+    }
+    return std::make_shared<SqliteStatementWrapper>(db_ptr, query);
+  }
+
+  auto statement = std::make_shared<SqliteStatementWrapper>(db_ptr, query);
+  statement_cache_.emplace_front(query, statement);
+  statement_cache_index_[query] = statement_cache_.begin();
+  if (statement_cache_.size() > MAX_CACHED_STATEMENTS) {
+    // Evict the least recently used entry; it is finalized once the last
+    // borrower lets go of it.
+    statement_cache_index_.erase(statement_cache_.back().first);
+    statement_cache_.pop_back();
+  }
+  return statement;
 }
 
 size_t SqliteWrapper::get_last_insert_id()
@@ -86,6 +129,28 @@ size_t SqliteWrapper::get_last_insert_id()
   return sqlite3_last_insert_rowid(db_ptr);
 }
 
+uint64_t SqliteWrapper::get_db_status(int op) const
+{
+  int current = 0;
+  int highwater = 0;
+  if (sqlite3_db_status(db_ptr, op, &current, &highwater, 0) != SQLITE_OK) {
+    return 0;
+  }
+  return static_cast<uint64_t>(current);
+}
+
+void SqliteWrapper::set_file_size_hint(uint64_t expected_file_size)
+{
+  sqlite3_int64 size_hint = static_cast<sqlite3_int64>(expected_file_size);
+  int rc = sqlite3_file_control(db_ptr, "main", SQLITE_FCNTL_SIZE_HINT, &size_hint);
+  // SQLITE_NOTFOUND just means the VFS does not implement the hint.
+  if (rc != SQLITE_OK && rc != SQLITE_NOTFOUND) {
+    ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_WARN_STREAM(
+      "Could not pass file size hint to the VFS. SQLite error (" <<
+        rc << "): " << sqlite3_errstr(rc));
+  }
+}
+
 SqliteWrapper::operator bool()
 {
   return db_ptr != nullptr;
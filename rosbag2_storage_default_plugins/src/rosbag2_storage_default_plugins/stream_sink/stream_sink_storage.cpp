@@ -0,0 +1,617 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_storage_default_plugins/stream_sink/stream_sink_storage.hpp"
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+
+#include "../logging.hpp"
+
+namespace
+{
+// Chunk and footer objects reuse the chunked plugin's record layout, so
+// downstream tooling can concatenate the objects back into a .cbag file.
+constexpr const char CHUNK_MAGIC[8] = {'R', 'B', '2', 'C', 'H', 'U', 'N', 'K'};
+constexpr const uint32_t FORMAT_VERSION = 1;
+
+constexpr const size_t RECORD_HEADER_SIZE =
+  sizeof(uint32_t) + sizeof(int64_t) + sizeof(uint32_t);
+
+constexpr const char SINK_ENDPOINT_PRAGMA[] = "sink_endpoint";
+constexpr const char SINK_CHUNK_SIZE_PRAGMA[] = "sink_chunk_size";
+constexpr const char SINK_MAX_IN_FLIGHT_PRAGMA[] = "sink_max_in_flight";
+constexpr const char SINK_SPILL_DIRECTORY_PRAGMA[] = "sink_spill_directory";
+
+// One retry per object before it is spilled; the external uploader working
+// the spool directory is the durable fallback, not endless retries here.
+constexpr const int UPLOAD_ATTEMPTS = 2;
+
+void append_raw(std::vector<uint8_t> & buffer, const void * data, size_t size)
+{
+  const auto * bytes = static_cast<const uint8_t *>(data);
+  buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+template<typename T>
+void append_value(std::vector<uint8_t> & buffer, T value)
+{
+  append_raw(buffer, &value, sizeof(T));
+}
+
+void append_string(std::vector<uint8_t> & buffer, const std::string & value)
+{
+  append_value<uint32_t>(buffer, static_cast<uint32_t>(value.size()));
+  append_raw(buffer, value.data(), value.size());
+}
+
+// Value of a 'PRAGMA key = value;' line, with whitespace, quotes and the
+// trailing semicolon stripped.
+std::string pragma_value(const std::string & line)
+{
+  const auto assignment = line.find('=');
+  if (assignment == std::string::npos) {
+    return "";
+  }
+  auto value = line.substr(assignment + 1);
+  const auto semicolon = value.find(';');
+  if (semicolon != std::string::npos) {
+    value = value.substr(0, semicolon);
+  }
+  const auto first = value.find_first_not_of(" \t'\"");
+  const auto last = value.find_last_not_of(" \t'\"\r");
+  if (first == std::string::npos) {
+    return "";
+  }
+  return value.substr(first, last - first + 1);
+}
+}  // namespace
+
+namespace rosbag2_storage_plugins
+{
+
+StreamSinkStorage::~StreamSinkStorage()
+{
+  if (!uploader_thread_.joinable()) {
+    return;
+  }
+  // Seal the partial chunk and queue the footer, then let the uploader
+  // drain everything still in flight before joining it.
+  try {
+    seal_chunk();
+    enqueue_object({object_prefix_ + "/footer", build_footer()});
+  } catch (const std::exception & e) {
+    ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_ERROR_STREAM(
+      "Failed to seal the recording for upload: " << e.what());
+  }
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stop_uploader_ = true;
+  }
+  queue_condition_.notify_all();
+  uploader_thread_.join();
+}
+
+void StreamSinkStorage::open(
+  const std::string & uri, rosbag2_storage::storage_interfaces::IOFlag io_flag)
+{
+#ifdef _WIN32
+  (void) uri;
+  (void) io_flag;
+  throw std::runtime_error("The stream_sink storage is not supported on Windows.");
+#else
+  if (io_flag != rosbag2_storage::storage_interfaces::IOFlag::READ_WRITE) {
+    throw std::runtime_error(
+            "The stream_sink storage is an upload-only sink and cannot read bags back. "
+            "Read the objects from the sink with the chunked plugin after reassembly.");
+  }
+
+  if (storage_config_uri_.empty()) {
+    throw std::runtime_error(
+            "The stream_sink storage needs a storage config file naming the sink endpoint "
+            "('PRAGMA sink_endpoint = http://host:port/path;').");
+  }
+  apply_storage_config();
+  if (endpoint_host_.empty()) {
+    throw std::runtime_error(
+            "The storage config file '" + storage_config_uri_ +
+            "' does not name a sink endpoint.");
+  }
+
+  relative_path_ = uri + ".stream";
+  // Objects of this bag are grouped under the uri's basename on the sink.
+  const auto last_separator = uri.find_last_of("/\\");
+  object_prefix_ = endpoint_base_path_ + "/" +
+    (last_separator == std::string::npos ? uri : uri.substr(last_separator + 1));
+  if (spill_directory_.empty()) {
+    spill_directory_ = uri + ".spill";
+  }
+
+  uploader_thread_ = std::thread(&StreamSinkStorage::uploader_loop, this);
+
+  ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_INFO_STREAM(
+    "Streaming bag to 'http://" << endpoint_host_ << ":" << endpoint_port_ <<
+      object_prefix_ << "', spilling to '" << spill_directory_ << "' on backpressure.");
+#endif
+}
+
+void StreamSinkStorage::create_topic(const rosbag2_storage::TopicMetadata & topic)
+{
+  if (topic_ids_by_name_.count(topic.name) != 0u) {
+    return;
+  }
+  const auto id = static_cast<uint32_t>(topics_.size());
+  topics_.push_back({id, topic, 0, 0, 0});
+  topic_ids_by_name_.emplace(topic.name, id);
+}
+
+void StreamSinkStorage::remove_topic(const rosbag2_storage::TopicMetadata & topic)
+{
+  const auto it = topic_ids_by_name_.find(topic.name);
+  if (it == topic_ids_by_name_.end()) {
+    return;
+  }
+  if (topics_[it->second].message_count != 0u) {
+    throw std::runtime_error(
+            "Cannot remove topic '" + topic.name + "': messages were already written.");
+  }
+  topics_[it->second].metadata.name.clear();
+  topic_ids_by_name_.erase(it);
+}
+
+void StreamSinkStorage::write_message(const rosbag2_storage::SerializedBagMessage & message)
+{
+  const auto it = topic_ids_by_name_.find(message.topic_name);
+  if (it == topic_ids_by_name_.end()) {
+    throw std::runtime_error(
+            "Topic '" + message.topic_name + "' has not been created yet!");
+  }
+
+  const auto payload_size = message.serialized_data->buffer_length;
+  chunk_buffer_.reserve(chunk_buffer_.size() + RECORD_HEADER_SIZE + payload_size);
+  append_value<uint32_t>(chunk_buffer_, it->second);
+  append_value<int64_t>(chunk_buffer_, message.time_stamp);
+  append_value<uint32_t>(chunk_buffer_, static_cast<uint32_t>(payload_size));
+  append_raw(chunk_buffer_, message.serialized_data->buffer, payload_size);
+
+  if (chunk_message_count_ == 0u) {
+    chunk_min_timestamp_ = message.time_stamp;
+    chunk_max_timestamp_ = message.time_stamp;
+  } else {
+    chunk_min_timestamp_ = std::min(chunk_min_timestamp_, message.time_stamp);
+    chunk_max_timestamp_ = std::max(chunk_max_timestamp_, message.time_stamp);
+  }
+  ++chunk_message_count_;
+
+  auto & topic = topics_[it->second];
+  if (topic.message_count == 0u) {
+    topic.min_timestamp = message.time_stamp;
+    topic.max_timestamp = message.time_stamp;
+  } else {
+    topic.min_timestamp = std::min(topic.min_timestamp, message.time_stamp);
+    topic.max_timestamp = std::max(topic.max_timestamp, message.time_stamp);
+  }
+  ++topic.message_count;
+
+  bytes_written_ += payload_size;
+  ++messages_written_;
+
+  if (chunk_buffer_.size() >= chunk_size_threshold_) {
+    seal_chunk();
+  }
+}
+
+void StreamSinkStorage::write(
+  std::shared_ptr<const rosbag2_storage::SerializedBagMessage> message)
+{
+  write_message(*message);
+}
+
+void StreamSinkStorage::write(
+  const std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> & messages)
+{
+  for (const auto & message : messages) {
+    write_message(*message);
+  }
+}
+
+void StreamSinkStorage::seal_chunk()
+{
+  if (chunk_message_count_ == 0u) {
+    return;
+  }
+
+  // A chunk object is self-describing: the chunked file header precedes the
+  // regular chunk header, so a single object is a valid one-chunk fragment.
+  std::vector<uint8_t> object_data;
+  object_data.reserve(
+    sizeof(CHUNK_MAGIC) + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t) +
+    2 * sizeof(int64_t) + chunk_buffer_.size());
+  append_raw(object_data, CHUNK_MAGIC, sizeof(CHUNK_MAGIC));
+  append_value<uint32_t>(object_data, FORMAT_VERSION);
+  append_value<uint64_t>(object_data, chunk_buffer_.size());
+  append_value<uint32_t>(object_data, chunk_message_count_);
+  append_value<int64_t>(object_data, chunk_min_timestamp_);
+  append_value<int64_t>(object_data, chunk_max_timestamp_);
+  append_raw(object_data, chunk_buffer_.data(), chunk_buffer_.size());
+
+  chunk_index_.push_back(
+    {sealed_chunks_, chunk_buffer_.size(), chunk_message_count_,
+      chunk_min_timestamp_, chunk_max_timestamp_});
+
+  enqueue_object(
+    {object_prefix_ + "/chunk_" + std::to_string(sealed_chunks_), std::move(object_data)});
+
+  ++sealed_chunks_;
+  chunk_buffer_.clear();
+  chunk_message_count_ = 0;
+}
+
+std::vector<uint8_t> StreamSinkStorage::build_footer() const
+{
+  std::vector<uint8_t> footer;
+
+  uint32_t topic_count = 0;
+  for (const auto & topic : topics_) {
+    if (!topic.metadata.name.empty()) {
+      ++topic_count;
+    }
+  }
+  append_value<uint32_t>(footer, topic_count);
+  for (const auto & topic : topics_) {
+    if (topic.metadata.name.empty()) {
+      continue;
+    }
+    append_value<uint32_t>(footer, topic.id);
+    append_string(footer, topic.metadata.name);
+    append_string(footer, topic.metadata.type);
+    append_string(footer, topic.metadata.serialization_format);
+    append_string(footer, topic.metadata.offered_qos_profiles);
+    append_value<uint64_t>(footer, topic.message_count);
+    append_value<int64_t>(footer, topic.min_timestamp);
+    append_value<int64_t>(footer, topic.max_timestamp);
+  }
+
+  // The chunk index references object sequence numbers instead of file
+  // offsets; reassembly restores the offsets when concatenating.
+  append_value<uint64_t>(footer, chunk_index_.size());
+  for (const auto & chunk : chunk_index_) {
+    append_value<uint64_t>(footer, chunk.sequence);
+    append_value<uint64_t>(footer, chunk.data_size);
+    append_value<uint32_t>(footer, chunk.message_count);
+    append_value<int64_t>(footer, chunk.min_timestamp);
+    append_value<int64_t>(footer, chunk.max_timestamp);
+  }
+  return footer;
+}
+
+void StreamSinkStorage::enqueue_object(PendingObject && object)
+{
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  if (upload_queue_.size() >= max_in_flight_chunks_) {
+    // The network fell behind the recording; spill instead of blocking the
+    // writing thread or growing the queue without bound.
+    lock.unlock();
+    spill_object(object);
+    return;
+  }
+  upload_queue_.push_back(std::move(object));
+  lock.unlock();
+  queue_condition_.notify_one();
+}
+
+void StreamSinkStorage::uploader_loop()
+{
+  while (true) {
+    PendingObject object;
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      queue_condition_.wait(
+        lock, [this]() {return !upload_queue_.empty() || stop_uploader_;});
+      if (upload_queue_.empty()) {
+        return;
+      }
+      object = std::move(upload_queue_.front());
+      upload_queue_.pop_front();
+    }
+
+    bool uploaded = false;
+    for (int attempt = 0; attempt < UPLOAD_ATTEMPTS && !uploaded; ++attempt) {
+      uploaded = upload_object(object);
+    }
+    if (uploaded) {
+      bytes_uploaded_ += object.data.size();
+      ++objects_uploaded_;
+    } else {
+      spill_object(object);
+    }
+  }
+}
+
+bool StreamSinkStorage::upload_object(const PendingObject & object)
+{
+#ifdef _WIN32
+  (void) object;
+  return false;
+#else
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo * addresses = nullptr;
+  if (getaddrinfo(endpoint_host_.c_str(), endpoint_port_.c_str(), &hints, &addresses) != 0) {
+    return false;
+  }
+
+  int fd = -1;
+  for (auto * address = addresses; address != nullptr; address = address->ai_next) {
+    fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (fd < 0) {
+      continue;
+    }
+    if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+      break;
+    }
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(addresses);
+  if (fd < 0) {
+    return false;
+  }
+
+  const std::string header =
+    "PUT " + object.name + " HTTP/1.1\r\n"
+    "Host: " + endpoint_host_ + "\r\n"
+    "Content-Type: application/octet-stream\r\n"
+    "Content-Length: " + std::to_string(object.data.size()) + "\r\n"
+    "Connection: close\r\n"
+    "\r\n";
+
+  bool ok = true;
+  auto send_all = [fd](const uint8_t * data, size_t size) {
+      size_t sent = 0;
+      while (sent < size) {
+        const auto result = send(fd, data + sent, size - sent, 0);
+        if (result <= 0) {
+          return false;
+        }
+        sent += static_cast<size_t>(result);
+      }
+      return true;
+    };
+  ok = send_all(reinterpret_cast<const uint8_t *>(header.data()), header.size()) &&
+    send_all(object.data.data(), object.data.size());
+
+  if (ok) {
+    // "HTTP/1.x NNN ..." — accept any 2xx status.
+    char response[16] = {0};
+    size_t received = 0;
+    while (received < sizeof(response) - 1) {
+      const auto result = recv(fd, response + received, sizeof(response) - 1 - received, 0);
+      if (result <= 0) {
+        break;
+      }
+      received += static_cast<size_t>(result);
+    }
+    ok = received >= 10 && std::strncmp(response, "HTTP/1.", 7) == 0 && response[9] == '2';
+  }
+  close(fd);
+  return ok;
+#endif
+}
+
+void StreamSinkStorage::spill_object(const PendingObject & object)
+{
+  {
+    // Both the writing thread (full queue) and the uploader thread (failed
+    // upload) can be the first to spill.
+    std::lock_guard<std::mutex> lock(spill_directory_mutex_);
+    if (!spill_directory_created_) {
+      rcpputils::fs::create_directories(rcpputils::fs::path(spill_directory_));
+      spill_directory_created_ = true;
+    }
+  }
+  const auto last_separator = object.name.find_last_of('/');
+  const auto file_path = spill_directory_ + "/" +
+    (last_separator == std::string::npos ? object.name : object.name.substr(last_separator + 1));
+  std::ofstream spill_file(file_path, std::ios::out | std::ios::binary);
+  spill_file.write(
+    reinterpret_cast<const char *>(object.data.data()),
+    static_cast<std::streamsize>(object.data.size()));
+  if (!spill_file) {
+    ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_ERROR_STREAM(
+      "Failed to spill '" << object.name << "' to '" << file_path << "'; the chunk is lost.");
+    return;
+  }
+  ++objects_spilled_;
+  ROSBAG2_STORAGE_DEFAULT_PLUGINS_LOG_WARN_STREAM(
+    "Sink is not keeping up; spilled '" << object.name << "' to '" << file_path << "'.");
+}
+
+bool StreamSinkStorage::has_next()
+{
+  return false;
+}
+
+std::shared_ptr<rosbag2_storage::SerializedBagMessage> StreamSinkStorage::read_next()
+{
+  throw std::runtime_error("The stream_sink storage cannot read bags back.");
+}
+
+std::vector<rosbag2_storage::TopicMetadata> StreamSinkStorage::get_all_topics_and_types()
+{
+  std::vector<rosbag2_storage::TopicMetadata> all_topics;
+  for (const auto & topic : topics_) {
+    if (!topic.metadata.name.empty()) {
+      all_topics.push_back(topic.metadata);
+    }
+  }
+  return all_topics;
+}
+
+rosbag2_storage::BagMetadata StreamSinkStorage::get_metadata()
+{
+  rosbag2_storage::BagMetadata metadata;
+  metadata.storage_identifier = get_storage_identifier();
+  metadata.relative_file_paths = {get_relative_file_path()};
+
+  metadata.message_count = 0;
+  metadata.topics_with_message_count = {};
+
+  rcutils_time_point_value_t min_time = INT64_MAX;
+  rcutils_time_point_value_t max_time = 0;
+
+  for (const auto & topic : topics_) {
+    if (topic.metadata.name.empty() || topic.message_count == 0u) {
+      continue;
+    }
+    metadata.topics_with_message_count.push_back(
+      {topic.metadata, static_cast<size_t>(topic.message_count), 0, 0});
+    metadata.message_count += topic.message_count;
+    min_time = std::min(min_time, topic.min_timestamp);
+    max_time = std::max(max_time, topic.max_timestamp);
+  }
+
+  if (metadata.message_count == 0) {
+    min_time = 0;
+    max_time = 0;
+  }
+
+  metadata.starting_time =
+    std::chrono::time_point<std::chrono::high_resolution_clock>(std::chrono::nanoseconds(min_time));
+  metadata.duration = std::chrono::nanoseconds(max_time) - std::chrono::nanoseconds(min_time);
+  metadata.bag_size = get_bagfile_size();
+
+  return metadata;
+}
+
+std::string StreamSinkStorage::get_relative_file_path() const
+{
+  return relative_path_;
+}
+
+uint64_t StreamSinkStorage::get_bagfile_size() const
+{
+  // The sink has no single backing file; report the bytes accepted so far
+  // (including the chunk still being filled) so size-based splitting works.
+  return bytes_written_ + chunk_buffer_.size();
+}
+
+std::string StreamSinkStorage::get_storage_identifier() const
+{
+  return "stream_sink";
+}
+
+uint64_t StreamSinkStorage::get_minimum_split_file_size() const
+{
+  return chunk_size_threshold_;
+}
+
+void StreamSinkStorage::set_filter(const rosbag2_storage::StorageFilter & storage_filter)
+{
+  (void) storage_filter;
+}
+
+void StreamSinkStorage::reset_filter()
+{
+}
+
+void StreamSinkStorage::set_storage_config(const std::string & storage_config_uri)
+{
+  storage_config_uri_ = storage_config_uri;
+}
+
+void StreamSinkStorage::apply_storage_config()
+{
+  std::ifstream config_file(storage_config_uri_);
+  if (!config_file) {
+    throw std::runtime_error(
+            "Failed to read storage config file '" + storage_config_uri_ + "'.");
+  }
+
+  std::string line;
+  while (std::getline(config_file, line)) {
+    const auto first_char = line.find_first_not_of(" \t\r");
+    if (first_char == std::string::npos || line[first_char] == '#') {
+      continue;
+    }
+    line = line.substr(first_char);
+
+    if (line.find(SINK_ENDPOINT_PRAGMA) != std::string::npos) {
+      auto endpoint = pragma_value(line);
+      const std::string scheme = "http://";
+      if (endpoint.compare(0, scheme.size(), scheme) != 0) {
+        throw std::runtime_error(
+                "Sink endpoint '" + endpoint + "' is not an http:// url.");
+      }
+      endpoint = endpoint.substr(scheme.size());
+      const auto path_start = endpoint.find('/');
+      if (path_start != std::string::npos) {
+        endpoint_base_path_ = endpoint.substr(path_start);
+        // A plain host keeps an empty base path; trailing slashes would
+        // produce double separators in the object names.
+        while (!endpoint_base_path_.empty() && endpoint_base_path_.back() == '/') {
+          endpoint_base_path_.pop_back();
+        }
+        endpoint = endpoint.substr(0, path_start);
+      }
+      const auto port_start = endpoint.find(':');
+      if (port_start != std::string::npos) {
+        endpoint_port_ = endpoint.substr(port_start + 1);
+        endpoint = endpoint.substr(0, port_start);
+      }
+      endpoint_host_ = endpoint;
+    } else if (line.find(SINK_CHUNK_SIZE_PRAGMA) != std::string::npos) {
+      chunk_size_threshold_ = static_cast<uint64_t>(std::stoll(pragma_value(line)));
+    } else if (line.find(SINK_MAX_IN_FLIGHT_PRAGMA) != std::string::npos) {
+      max_in_flight_chunks_ = static_cast<size_t>(std::stoll(pragma_value(line)));
+    } else if (line.find(SINK_SPILL_DIRECTORY_PRAGMA) != std::string::npos) {
+      spill_directory_ = pragma_value(line);
+    }
+  }
+}
+
+rosbag2_storage::IOStatistics StreamSinkStorage::get_io_statistics() const
+{
+  rosbag2_storage::IOStatistics statistics;
+  statistics.bytes_written = bytes_uploaded_;
+  statistics.messages_written = messages_written_;
+  // Each uploaded object is the sink-side equivalent of a commit; spilled
+  // objects show up as the gap between sealed and committed.
+  statistics.transactions_committed = objects_uploaded_;
+  return statistics;
+}
+
+}  // namespace rosbag2_storage_plugins
+
+#include "pluginlib/class_list_macros.hpp"  // NOLINT
+PLUGINLIB_EXPORT_CLASS(
+  rosbag2_storage_plugins::StreamSinkStorage,
+  rosbag2_storage::storage_interfaces::ReadWriteInterface)
@@ -0,0 +1,205 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+
+#include "rosbag2_storage/storage_filter.hpp"
+
+#include "rosbag2_storage_default_plugins/chunked/chunked_storage.hpp"
+
+#include "../sqlite/storage_test_fixture.hpp"
+
+using namespace ::testing;  // NOLINT
+
+class ChunkedStorageTestFixture : public StorageTestFixture
+{
+public:
+  std::string bag_path()
+  {
+    return (rcpputils::fs::path(temporary_dir_path_) / "rosbag").string();
+  }
+
+  void write_messages_to_chunked_storage(
+    const std::vector<std::tuple<std::string, int64_t, std::string>> & messages)
+  {
+    std::unique_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface> writable_storage =
+      std::make_unique<rosbag2_storage_plugins::ChunkedStorage>();
+    writable_storage->open(bag_path());
+
+    for (const auto & msg : messages) {
+      const auto & topic_name = std::get<2>(msg);
+      writable_storage->create_topic({topic_name, "string_type", "cdr", ""});
+      auto bag_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+      bag_message->serialized_data = make_serialized_message(std::get<0>(msg));
+      bag_message->time_stamp = std::get<1>(msg);
+      bag_message->topic_name = topic_name;
+      writable_storage->write(bag_message);
+    }
+  }
+
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface>
+  open_for_reading()
+  {
+    auto readable_storage = std::make_unique<rosbag2_storage_plugins::ChunkedStorage>();
+    readable_storage->open(
+      bag_path() + ".cbag", rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+    return readable_storage;
+  }
+
+  // Flips one payload byte of the first chunk, behind the 12-byte file
+  // header, the 28-byte chunk header and the 16-byte record header.
+  void corrupt_first_chunk()
+  {
+    const std::streamoff payload_offset = 12 + 28 + 16;
+    std::fstream file(
+      bag_path() + ".cbag", std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(payload_offset);
+    const auto byte = static_cast<char>(file.get());
+    file.seekp(payload_offset);
+    file.put(byte ^ 0x01);
+  }
+};
+
+TEST_F(ChunkedStorageTestFixture, messages_roundtrip_through_chunked_storage) {
+  std::vector<std::tuple<std::string, int64_t, std::string>> messages =
+  {std::make_tuple("first message", 1, "topic1"),
+    std::make_tuple("second message", 2, "topic2"),
+    std::make_tuple("third message", 3, "topic1")};
+
+  write_messages_to_chunked_storage(messages);
+  auto readable_storage = open_for_reading();
+
+  for (const auto & msg : messages) {
+    ASSERT_TRUE(readable_storage->has_next());
+    auto read_message = readable_storage->read_next();
+    EXPECT_THAT(deserialize_message(read_message->serialized_data), Eq(std::get<0>(msg)));
+    EXPECT_THAT(read_message->time_stamp, Eq(std::get<1>(msg)));
+    EXPECT_THAT(read_message->topic_name, Eq(std::get<2>(msg)));
+  }
+  EXPECT_FALSE(readable_storage->has_next());
+}
+
+TEST_F(ChunkedStorageTestFixture, corrupted_chunk_is_detected_when_it_is_loaded) {
+  write_messages_to_chunked_storage(
+    {std::make_tuple("first message", 1, "topic1"),
+      std::make_tuple("second message", 2, "topic1")});
+  corrupt_first_chunk();
+
+  auto readable_storage = open_for_reading();
+  EXPECT_THROW(readable_storage->has_next(), std::runtime_error);
+}
+
+TEST_F(ChunkedStorageTestFixture, verify_checksums_reports_corrupt_chunks) {
+  write_messages_to_chunked_storage(
+    {std::make_tuple("first message", 1, "topic1"),
+      std::make_tuple("second message", 2, "topic1")});
+  corrupt_first_chunk();
+
+  auto storage = std::make_unique<rosbag2_storage_plugins::ChunkedStorage>();
+  storage->open(
+    bag_path() + ".cbag", rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+  EXPECT_EQ(1u, storage->verify_checksums());
+}
+
+TEST_F(ChunkedStorageTestFixture, verify_checksums_passes_on_an_intact_bag) {
+  write_messages_to_chunked_storage(
+    {std::make_tuple("first message", 1, "topic1"),
+      std::make_tuple("second message", 2, "topic1")});
+
+  auto storage = std::make_unique<rosbag2_storage_plugins::ChunkedStorage>();
+  storage->open(
+    bag_path() + ".cbag", rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+  EXPECT_EQ(0u, storage->verify_checksums());
+}
+
+TEST_F(ChunkedStorageTestFixture, set_filter_restricts_topics_and_time_range) {
+  std::vector<std::tuple<std::string, int64_t, std::string>> messages =
+  {std::make_tuple("message 1", 1, "topic1"),
+    std::make_tuple("message 2", 2, "topic2"),
+    std::make_tuple("message 3", 3, "topic1"),
+    std::make_tuple("message 4", 4, "topic1")};
+
+  write_messages_to_chunked_storage(messages);
+  auto readable_storage = open_for_reading();
+
+  rosbag2_storage::StorageFilter storage_filter;
+  storage_filter.topics.push_back("topic1");
+  storage_filter.end_time = 3;
+  readable_storage->set_filter(storage_filter);
+
+  ASSERT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(1));
+  ASSERT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(3));
+  EXPECT_FALSE(readable_storage->has_next());
+}
+
+TEST_F(ChunkedStorageTestFixture, seek_repositions_via_chunk_index) {
+  std::vector<std::tuple<std::string, int64_t, std::string>> messages =
+  {std::make_tuple("message 1", 10, "topic1"),
+    std::make_tuple("message 2", 20, "topic1"),
+    std::make_tuple("message 3", 30, "topic1")};
+
+  write_messages_to_chunked_storage(messages);
+  auto readable_storage = open_for_reading();
+
+  readable_storage->seek(15);
+  ASSERT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(20));
+
+  readable_storage->seek(5);
+  ASSERT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(10));
+}
+
+TEST_F(ChunkedStorageTestFixture, get_metadata_aggregates_per_topic_counts) {
+  std::vector<std::tuple<std::string, int64_t, std::string>> messages =
+  {std::make_tuple("message 1", 1, "topic1"),
+    std::make_tuple("message 2", 5, "topic2"),
+    std::make_tuple("message 3", 9, "topic1")};
+
+  write_messages_to_chunked_storage(messages);
+  auto readable_storage = open_for_reading();
+
+  const auto metadata = readable_storage->get_metadata();
+  EXPECT_THAT(metadata.storage_identifier, Eq("chunked"));
+  EXPECT_THAT(metadata.message_count, Eq(3u));
+  EXPECT_THAT(metadata.topics_with_message_count, SizeIs(2u));
+  EXPECT_THAT(
+    metadata.starting_time.time_since_epoch(), Eq(std::chrono::nanoseconds(1)));
+  EXPECT_THAT(metadata.duration, Eq(std::chrono::nanoseconds(8)));
+}
+
+TEST_F(ChunkedStorageTestFixture, unsealed_bag_is_rejected_on_open) {
+  const auto bag_file = bag_path() + ".cbag";
+  {
+    std::ofstream truncated(bag_file, std::ios::binary);
+    truncated << "RB2CHUNK";  // header only, no footer
+  }
+
+  auto readable_storage = std::make_unique<rosbag2_storage_plugins::ChunkedStorage>();
+  EXPECT_THROW(
+    readable_storage->open(
+      bag_file, rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY),
+    std::runtime_error);
+}
@@ -0,0 +1,238 @@
+// Copyright 2020, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+# include <direct.h>
+# include <Windows.h>
+#else
+# include <unistd.h>
+# include <sys/types.h>
+# include <dirent.h>
+#endif
+
+#include "rosbag2_storage/ros_helper.hpp"
+#include "rosbag2_storage/serialized_bag_message.hpp"
+#include "rosbag2_storage/storage_factory.hpp"
+#include "rosbag2_storage/storage_interfaces/read_write_interface.hpp"
+#include "rosbag2_storage/topic_metadata.hpp"
+
+// Microbenchmarks for the shipped sqlite plugin, driven through the pluginlib
+// storage interface exactly as rosbag2_cpp drives it. Single writes commit
+// row by row while batch writes go through the plugin's transactional
+// multi-row path, so the two benchmark families compare the untransacted and
+// transacted code paths.
+
+namespace
+{
+
+constexpr const char kStorageId[] = "sqlite3";
+constexpr const char kTopicName[] = "benchmark_topic";
+
+std::string make_temporary_directory()
+{
+  char template_char[] = "tmp_benchmark_dir.XXXXXX";
+#ifdef _WIN32
+  char temp_path[255];
+  GetTempPathA(255, temp_path);
+  _mktemp_s(template_char, strnlen(template_char, 25) + 1);
+  std::string directory_path = std::string(temp_path) + std::string(template_char);
+  _mkdir(directory_path.c_str());
+  return directory_path;
+#else
+  return mkdtemp(template_char);
+#endif
+}
+
+void remove_directory_recursively(const std::string & directory_path)
+{
+#ifdef _WIN32
+  size_t length = strlen(directory_path.c_str());
+  TCHAR * temp_dir = new TCHAR[length + 2];
+  memcpy(temp_dir, directory_path.c_str(), length);
+  temp_dir[length] = 0;
+  temp_dir[length + 1] = 0;  // double null terminated
+
+  SHFILEOPSTRUCT file_options;
+  file_options.hwnd = nullptr;
+  file_options.wFunc = FO_DELETE;  // delete (recursively)
+  file_options.pFrom = temp_dir;
+  file_options.pTo = nullptr;
+  file_options.fFlags = FOF_NOCONFIRMATION | FOF_SILENT;  // do not prompt user
+  file_options.fAnyOperationsAborted = FALSE;
+  file_options.lpszProgressTitle = nullptr;
+  file_options.hNameMappings = nullptr;
+
+  SHFileOperation(&file_options);
+  delete[] temp_dir;
+#else
+  DIR * dir = opendir(directory_path.c_str());
+  if (!dir) {
+    return;
+  }
+  struct dirent * directory_entry;
+  while ((directory_entry = readdir(dir)) != nullptr) {
+    if (strcmp(directory_entry->d_name, ".") != 0 && strcmp(directory_entry->d_name, "..") != 0) {
+      if (directory_entry->d_type == DT_DIR) {
+        remove_directory_recursively(directory_path + "/" + directory_entry->d_name);
+      }
+      remove((directory_path + "/" + directory_entry->d_name).c_str());
+    }
+  }
+  closedir(dir);
+  remove(directory_path.c_str());
+#endif
+}
+
+std::shared_ptr<rosbag2_storage::SerializedBagMessage> make_message(
+  size_t message_size, rcutils_time_point_value_t time_stamp)
+{
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  std::string payload(message_size, 'x');
+  message->serialized_data =
+    rosbag2_storage::make_serialized_message(payload.c_str(), payload.size());
+  message->topic_name = kTopicName;
+  message->time_stamp = time_stamp;
+  return message;
+}
+
+/// Opens a fresh bag in a temporary directory through the storage factory
+/// and removes it again on destruction.
+class BenchmarkStorage
+{
+public:
+  BenchmarkStorage()
+  : directory_path_(make_temporary_directory())
+  {
+    storage_ = factory_.open_read_write(directory_path_ + "/bag", kStorageId);
+    rosbag2_storage::TopicMetadata topic{kTopicName, "std_msgs/msg/ByteMultiArray", "cdr", ""};
+    storage_->create_topic(topic);
+  }
+
+  ~BenchmarkStorage()
+  {
+    storage_.reset();
+    remove_directory_recursively(directory_path_);
+  }
+
+  rosbag2_storage::storage_interfaces::ReadWriteInterface * operator->()
+  {
+    return storage_.get();
+  }
+
+private:
+  rosbag2_storage::StorageFactory factory_;
+  std::string directory_path_;
+  std::shared_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface> storage_;
+};
+
+void write_single_messages(benchmark::State & state)
+{
+  BenchmarkStorage storage;
+  auto message_size = static_cast<size_t>(state.range(0));
+  auto message = make_message(message_size, 0);
+  for (auto _ : state) {
+    storage->write(message);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(message_size));
+}
+
+void write_message_batches(benchmark::State & state)
+{
+  BenchmarkStorage storage;
+  auto message_size = static_cast<size_t>(state.range(0));
+  auto batch_size = static_cast<size_t>(state.range(1));
+  std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> batch;
+  for (size_t i = 0; i < batch_size; ++i) {
+    batch.push_back(make_message(message_size, static_cast<rcutils_time_point_value_t>(i)));
+  }
+  for (auto _ : state) {
+    storage->write(batch);
+  }
+  state.SetBytesProcessed(
+    state.iterations() * static_cast<int64_t>(message_size * batch_size));
+}
+
+void read_single_messages(benchmark::State & state)
+{
+  BenchmarkStorage storage;
+  auto message_size = static_cast<size_t>(state.range(0));
+  constexpr size_t kMessageCount = 1000;
+  std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> batch;
+  for (size_t i = 0; i < kMessageCount; ++i) {
+    batch.push_back(make_message(message_size, static_cast<rcutils_time_point_value_t>(i)));
+  }
+  storage->write(batch);
+
+  for (auto _ : state) {
+    if (!storage->has_next()) {
+      state.PauseTiming();
+      storage->seek(0);
+      state.ResumeTiming();
+    }
+    auto message = storage->read_next();
+    benchmark::DoNotOptimize(message);
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(message_size));
+}
+
+void read_message_batches(benchmark::State & state)
+{
+  BenchmarkStorage storage;
+  auto message_size = static_cast<size_t>(state.range(0));
+  auto batch_size = static_cast<size_t>(state.range(1));
+  constexpr size_t kMessageCount = 1000;
+  std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> batch;
+  for (size_t i = 0; i < kMessageCount; ++i) {
+    batch.push_back(make_message(message_size, static_cast<rcutils_time_point_value_t>(i)));
+  }
+  storage->write(batch);
+
+  for (auto _ : state) {
+    if (!storage->has_next()) {
+      state.PauseTiming();
+      storage->seek(0);
+      state.ResumeTiming();
+    }
+    auto messages = storage->read_next_batch(batch_size);
+    benchmark::DoNotOptimize(messages);
+    state.SetItemsProcessed(state.items_processed() + messages.size());
+  }
+}
+
+BENCHMARK(write_single_messages)
+->Arg(1024)->Arg(100 * 1024)->Arg(1024 * 1024)
+->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(write_message_batches)
+->Args({1024, 100})->Args({100 * 1024, 100})->Args({1024 * 1024, 100})
+->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(read_single_messages)
+->Arg(1024)->Arg(100 * 1024)
+->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(read_message_batches)
+->Args({1024, 100})->Args({100 * 1024, 100})
+->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
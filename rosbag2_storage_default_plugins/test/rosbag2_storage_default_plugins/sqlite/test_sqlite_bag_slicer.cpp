@@ -0,0 +1,114 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+
+#include "rosbag2_storage/metadata_io.hpp"
+
+#include "rosbag2_storage_default_plugins/sqlite/sqlite_bag_slicer.hpp"
+#include "rosbag2_storage_default_plugins/sqlite/sqlite_storage.hpp"
+
+#include "storage_test_fixture.hpp"
+
+using namespace ::testing;  // NOLINT
+
+class SqliteBagSlicerTestFixture : public StorageTestFixture
+{
+public:
+  std::string source_database()
+  {
+    return (rcpputils::fs::path(temporary_dir_path_) / "rosbag.db3").string();
+  }
+
+  std::string destination_bag()
+  {
+    return (rcpputils::fs::path(temporary_dir_path_) / "slice").string();
+  }
+
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>>
+  read_slice()
+  {
+    rosbag2_storage::MetadataIo metadata_io;
+    const auto metadata = metadata_io.read_metadata(destination_bag());
+    auto readable_storage = std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+    readable_storage->open(
+      (rcpputils::fs::path(destination_bag()) / metadata.relative_file_paths.front()).string(),
+      rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+    std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages;
+    while (readable_storage->has_next()) {
+      messages.push_back(readable_storage->read_next());
+    }
+    return messages;
+  }
+};
+
+TEST_F(SqliteBagSlicerTestFixture, slices_time_window_and_topics_into_valid_bag) {
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>> messages =
+  {std::make_tuple("message 1", 10, "topic1", "type1", "rmw1"),
+    std::make_tuple("message 2", 20, "topic2", "type2", "rmw1"),
+    std::make_tuple("message 3", 30, "topic1", "type1", "rmw1"),
+    std::make_tuple("message 4", 40, "topic1", "type1", "rmw1")};
+  write_messages_to_sqlite(messages);
+
+  rosbag2_storage_plugins::SqliteBagSlicer::Options options;
+  options.source_uri = source_database();
+  options.destination_uri = destination_bag();
+  options.start_time = 15;
+  options.end_time = 35;
+  options.topics = {"topic1"};
+  rosbag2_storage_plugins::SqliteBagSlicer(options).run();
+
+  auto sliced_messages = read_slice();
+  ASSERT_THAT(sliced_messages, SizeIs(1u));
+  EXPECT_THAT(sliced_messages[0]->time_stamp, Eq(30));
+  EXPECT_THAT(sliced_messages[0]->topic_name, Eq("topic1"));
+
+  rosbag2_storage::MetadataIo metadata_io;
+  const auto metadata = metadata_io.read_metadata(destination_bag());
+  EXPECT_THAT(metadata.message_count, Eq(1u));
+  EXPECT_THAT(
+    metadata.starting_time.time_since_epoch(), Eq(std::chrono::nanoseconds(30)));
+}
+
+TEST_F(SqliteBagSlicerTestFixture, copies_whole_bag_without_predicates) {
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>> messages =
+  {std::make_tuple("message 1", 1, "topic1", "type1", "rmw1"),
+    std::make_tuple("message 2", 2, "topic2", "type2", "rmw1"),
+    std::make_tuple("message 3", 3, "topic1", "type1", "rmw1")};
+  write_messages_to_sqlite(messages);
+
+  rosbag2_storage_plugins::SqliteBagSlicer::Options options;
+  options.source_uri = source_database();
+  options.destination_uri = destination_bag();
+  rosbag2_storage_plugins::SqliteBagSlicer(options).run();
+
+  EXPECT_THAT(read_slice(), SizeIs(3u));
+}
+
+TEST_F(SqliteBagSlicerTestFixture, existing_destination_is_rejected) {
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>> messages =
+  {std::make_tuple("message 1", 1, "topic1", "type1", "rmw1")};
+  write_messages_to_sqlite(messages);
+
+  rosbag2_storage_plugins::SqliteBagSlicer::Options options;
+  options.source_uri = source_database();
+  options.destination_uri = temporary_dir_path_;
+  EXPECT_THROW(rosbag2_storage_plugins::SqliteBagSlicer(options).run(), std::runtime_error);
+}
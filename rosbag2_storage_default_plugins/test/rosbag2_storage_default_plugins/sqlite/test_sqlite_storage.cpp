@@ -14,6 +14,7 @@
 
 #include <gmock/gmock.h>
 
+#include <fstream>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -160,6 +161,217 @@ TEST_F(StorageTestFixture, read_next_returns_filtered_messages) {
   EXPECT_FALSE(readable_storage2->has_next());
 }
 
+TEST_F(StorageTestFixture, read_next_batch_merges_parallel_topic_cursors_in_timestamp_order) {
+  // A filtered read over several topics runs one cursor per topic merged by
+  // timestamp; the batches must come out in the same global order the
+  // single merged cursor would produce.
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>>
+  string_messages;
+  for (int64_t i = 0; i < 5; ++i) {
+    string_messages.push_back(std::make_tuple("topic1 message", 3 * i + 1, "topic1", "", ""));
+    string_messages.push_back(std::make_tuple("topic2 message", 3 * i + 2, "topic2", "", ""));
+    string_messages.push_back(std::make_tuple("topic3 message", 3 * i + 3, "topic3", "", ""));
+  }
+
+  write_messages_to_sqlite(string_messages);
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+
+  auto db_filename = (rcpputils::fs::path(temporary_dir_path_) / "rosbag.db3").string();
+  readable_storage->open(db_filename);
+
+  rosbag2_storage::StorageFilter storage_filter;
+  storage_filter.topics.push_back("topic1");
+  storage_filter.topics.push_back("topic3");
+  readable_storage->set_filter(storage_filter);
+
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages;
+  while (readable_storage->has_next()) {
+    auto batch = readable_storage->read_next_batch(4);
+    messages.insert(messages.end(), batch.begin(), batch.end());
+  }
+
+  ASSERT_THAT(messages, SizeIs(10u));
+  int64_t previous_timestamp = 0;
+  for (const auto & message : messages) {
+    EXPECT_THAT(message->topic_name, AnyOf(Eq("topic1"), Eq("topic3")));
+    EXPECT_GT(message->time_stamp, previous_timestamp);
+    previous_timestamp = message->time_stamp;
+  }
+}
+
+TEST_F(StorageTestFixture, read_next_honors_regex_and_exclusion_filters) {
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>>
+  string_messages =
+  {std::make_tuple("camera message", 1, "/sensors/camera/image", "", ""),
+    std::make_tuple("lidar message", 2, "/sensors/lidar/points", "", ""),
+    std::make_tuple("log message", 3, "/rosout", "", "")};
+
+  write_messages_to_sqlite(string_messages);
+  auto db_filename = (rcpputils::fs::path(temporary_dir_path_) / "rosbag.db3").string();
+
+  // Include by pattern.
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  readable_storage->open(db_filename);
+
+  rosbag2_storage::StorageFilter storage_filter;
+  storage_filter.topics_regex = "/sensors/.*";
+  readable_storage->set_filter(storage_filter);
+
+  EXPECT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(readable_storage->read_next()->topic_name, Eq("/sensors/camera/image"));
+  EXPECT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(readable_storage->read_next()->topic_name, Eq("/sensors/lidar/points"));
+  EXPECT_FALSE(readable_storage->has_next());
+
+  // Exclude by pattern; everything else is selected.
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage2 =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  readable_storage2->open(db_filename);
+
+  rosbag2_storage::StorageFilter exclusion_filter;
+  exclusion_filter.topics_regex_to_exclude = "camera";
+  readable_storage2->set_filter(exclusion_filter);
+
+  EXPECT_TRUE(readable_storage2->has_next());
+  EXPECT_THAT(readable_storage2->read_next()->topic_name, Eq("/sensors/lidar/points"));
+  EXPECT_TRUE(readable_storage2->has_next());
+  EXPECT_THAT(readable_storage2->read_next()->topic_name, Eq("/rosout"));
+  EXPECT_FALSE(readable_storage2->has_next());
+}
+
+TEST_F(StorageTestFixture, seek_repositions_to_first_message_at_or_after_timestamp) {
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>>
+  string_messages =
+  {std::make_tuple("first message", 1, "", "", ""),
+    std::make_tuple("second message", 4, "", "", ""),
+    std::make_tuple("third message", 9, "", "", "")};
+
+  write_messages_to_sqlite(string_messages);
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+
+  auto db_filename = (rcpputils::fs::path(temporary_dir_path_) / "rosbag.db3").string();
+  readable_storage->open(db_filename);
+
+  readable_storage->seek(3);
+  EXPECT_TRUE(readable_storage->has_next());
+  auto first_message = readable_storage->read_next();
+  EXPECT_THAT(first_message->time_stamp, Eq(4));
+
+  // Seeking backwards restarts reading before the current cursor.
+  readable_storage->seek(0);
+  EXPECT_TRUE(readable_storage->has_next());
+  auto second_message = readable_storage->read_next();
+  EXPECT_THAT(second_message->time_stamp, Eq(1));
+
+  readable_storage->seek(10);
+  EXPECT_FALSE(readable_storage->has_next());
+}
+
+TEST_F(StorageTestFixture, reverse_read_order_returns_messages_newest_first) {
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>>
+  string_messages =
+  {std::make_tuple("first message", 1, "", "", ""),
+    std::make_tuple("second message", 4, "", "", ""),
+    std::make_tuple("third message", 9, "", "", "")};
+
+  write_messages_to_sqlite(string_messages);
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+
+  auto db_filename = (rcpputils::fs::path(temporary_dir_path_) / "rosbag.db3").string();
+  readable_storage->open(db_filename);
+
+  readable_storage->set_read_order(rosbag2_storage::ReadOrder::REVERSE);
+  EXPECT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(9));
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(4));
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(1));
+  EXPECT_FALSE(readable_storage->has_next());
+
+  // In reverse order a seek target is the upper bound the cursor starts
+  // from, so stepping backwards from a position costs one indexed lookup.
+  readable_storage->seek(4);
+  EXPECT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(4));
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(1));
+  EXPECT_FALSE(readable_storage->has_next());
+}
+
+TEST_F(StorageTestFixture, composite_topic_index_is_built_when_bag_is_closed) {
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>>
+  string_messages =
+  {std::make_tuple("topic1 message", 1, "topic1", "", ""),
+    std::make_tuple("topic2 message", 2, "topic2", "", "")};
+
+  // write_messages_to_sqlite destroys the writable storage, which closes the
+  // bag and finalizes the index.
+  write_messages_to_sqlite(string_messages);
+
+  auto db_filename = (rcpputils::fs::path(temporary_dir_path_) / "rosbag.db3").string();
+  rosbag2_storage_plugins::SqliteWrapper database{
+    db_filename, rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY};
+  auto index_query = database.prepare_statement(
+    "SELECT COUNT(*) FROM sqlite_master "
+    "WHERE type = 'index' AND name = 'topic_timestamp_idx';");
+  auto query_results = index_query->execute_query<int>();
+  EXPECT_THAT(std::get<0>(*query_results.begin()), Eq(1));
+}
+
+TEST_F(StorageTestFixture, sparse_timestamp_index_is_built_when_bag_is_closed) {
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>>
+  string_messages =
+  {std::make_tuple("first message", 1, "topic1", "", ""),
+    std::make_tuple("second message", 2, "topic1", "", "")};
+
+  write_messages_to_sqlite(string_messages);
+
+  auto db_filename = (rcpputils::fs::path(temporary_dir_path_) / "rosbag.db3").string();
+  rosbag2_storage_plugins::SqliteWrapper database{
+    db_filename, rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY};
+  // The stride is 1000, so a small bag carries exactly one sample: row 1.
+  auto sample_query = database.prepare_statement(
+    "SELECT COUNT(*), COALESCE(MIN(message_id), 0) FROM sparse_timestamp_idx;");
+  auto query_results = sample_query->execute_query<int, int>();
+  auto result = *query_results.begin();
+  EXPECT_THAT(std::get<0>(result), Eq(1));
+  EXPECT_THAT(std::get<1>(result), Eq(1));
+}
+
+TEST_F(StorageTestFixture, seek_is_correct_across_sparse_index_strides) {
+  // More messages than the 1000-message index stride, so the seek actually
+  // translates its target into a rowid bound through the sparse index.
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>>
+  string_messages;
+  for (int64_t i = 1; i <= 2500; ++i) {
+    string_messages.emplace_back("message", i, "topic1", "", "");
+  }
+
+  write_messages_to_sqlite(string_messages);
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+
+  auto db_filename = (rcpputils::fs::path(temporary_dir_path_) / "rosbag.db3").string();
+  readable_storage->open(db_filename);
+
+  readable_storage->seek(2100);
+  EXPECT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(2100));
+
+  // Seeking backwards across a stride boundary restarts before the cursor.
+  readable_storage->seek(50);
+  EXPECT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(50));
+
+  // In reverse order the upper bound goes through the sparse index as well.
+  readable_storage->set_read_order(rosbag2_storage::ReadOrder::REVERSE);
+  readable_storage->seek(1500);
+  EXPECT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(readable_storage->read_next()->time_stamp, Eq(1500));
+}
+
 TEST_F(StorageTestFixture, get_all_topics_and_types_returns_the_correct_vector) {
   std::unique_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface> writable_storage =
     std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
@@ -225,6 +437,37 @@ TEST_F(StorageTestFixture, get_metadata_returns_correct_struct) {
   EXPECT_THAT(metadata.duration, Eq(std::chrono::seconds(2)));
 }
 
+TEST_F(StorageTestFixture, get_topic_statistics_aggregates_count_bytes_and_span) {
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>> messages =
+  {std::make_tuple(
+      "1234", static_cast<int64_t>(1e9), "topic1", "type1", "rmw_format"),
+    std::make_tuple(
+      "12345678", static_cast<int64_t>(3e9), "topic1", "type1", "rmw_format"),
+    std::make_tuple(
+      "12", static_cast<int64_t>(2e9), "topic2", "type2", "rmw_format")};
+
+  write_messages_to_sqlite(messages);
+
+  const auto readable_storage = std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  const auto db_filename = (rcpputils::fs::path(temporary_dir_path_) / "rosbag.db3").string();
+
+  readable_storage->open(db_filename, rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+  const auto statistics = readable_storage->get_topic_statistics();
+
+  ASSERT_THAT(statistics, SizeIs(2u));
+  EXPECT_THAT(statistics[0].topic_name, Eq("topic1"));
+  EXPECT_THAT(statistics[0].message_count, Eq(2u));
+  // The fixture serializes each string with a terminating null byte.
+  EXPECT_THAT(statistics[0].byte_count, Eq(14u));
+  EXPECT_THAT(statistics[0].first_timestamp_ns, Eq(static_cast<int64_t>(1e9)));
+  EXPECT_THAT(statistics[0].last_timestamp_ns, Eq(static_cast<int64_t>(3e9)));
+  EXPECT_THAT(statistics[1].topic_name, Eq("topic2"));
+  EXPECT_THAT(statistics[1].message_count, Eq(1u));
+  EXPECT_THAT(statistics[1].byte_count, Eq(3u));
+  EXPECT_THAT(statistics[1].first_timestamp_ns, Eq(static_cast<int64_t>(2e9)));
+  EXPECT_THAT(statistics[1].last_timestamp_ns, Eq(static_cast<int64_t>(2e9)));
+}
+
 TEST_F(StorageTestFixture, get_metadata_returns_correct_struct_if_no_messages) {
   write_messages_to_sqlite({});
 
@@ -271,6 +514,264 @@ TEST_F(StorageTestFixture, remove_topics_and_types_returns_the_empty_vector) {
   EXPECT_THAT(topics_and_types, IsEmpty());
 }
 
+TEST_F(StorageTestFixture, get_io_statistics_reflects_writes_and_reads) {
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>>
+  string_messages =
+  {std::make_tuple("first message", 1, "", "", ""),
+    std::make_tuple("second message", 2, "", "", "")};
+
+  write_messages_to_sqlite(string_messages);
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+
+  auto db_filename = (rcpputils::fs::path(temporary_dir_path_) / "rosbag.db3").string();
+  readable_storage->open(db_filename);
+
+  auto statistics = readable_storage->get_io_statistics();
+  EXPECT_EQ(statistics.messages_read, 0u);
+
+  while (readable_storage->has_next()) {
+    readable_storage->read_next();
+  }
+
+  statistics = readable_storage->get_io_statistics();
+  EXPECT_EQ(statistics.messages_read, 2u);
+  EXPECT_GT(statistics.bytes_read, 0u);
+}
+
+TEST_F(StorageTestFixture, span_batch_write_roundtrips_messages) {
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface> writable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  auto db_file = (rcpputils::fs::path(temporary_dir_path_) / "rosbag").string();
+  writable_storage->open(db_file);
+  writable_storage->create_topic({"topic1", "type1", "rmw1", ""});
+
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages;
+  std::vector<const rosbag2_storage::SerializedBagMessage *> message_view;
+  for (int64_t i = 1; i <= 3; ++i) {
+    auto bag_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+    bag_message->serialized_data = make_serialized_message("message " + std::to_string(i));
+    bag_message->time_stamp = i;
+    bag_message->topic_name = "topic1";
+    messages.push_back(bag_message);
+    message_view.push_back(bag_message.get());
+  }
+  writable_storage->write(
+    rosbag2_storage::SerializedBagMessageSpan{message_view.data(), message_view.size()});
+  writable_storage.reset();
+
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  readable_storage->open(
+    db_file + ".db3", rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+  for (int64_t i = 1; i <= 3; ++i) {
+    ASSERT_TRUE(readable_storage->has_next());
+    auto read_message = readable_storage->read_next();
+    EXPECT_THAT(read_message->time_stamp, Eq(i));
+    EXPECT_THAT(
+      deserialize_message(read_message->serialized_data),
+      Eq("message " + std::to_string(i)));
+  }
+  EXPECT_FALSE(readable_storage->has_next());
+}
+
+TEST_F(StorageTestFixture, read_hint_pragmas_are_consumed_and_reading_works) {
+  std::vector<std::tuple<std::string, int64_t, std::string, std::string, std::string>>
+  string_messages =
+  {std::make_tuple("first message", 1, "", "", ""),
+    std::make_tuple("second message", 2, "", "", "")};
+  write_messages_to_sqlite(string_messages);
+
+  // The readahead pseudo pragmas must be intercepted (sqlite would reject
+  // them) and reading must behave identically with drop-behind enabled.
+  const auto config_path = (rcpputils::fs::path(temporary_dir_path_) / "config.txt").string();
+  {
+    std::ofstream config_file{config_path};
+    config_file << "PRAGMA read_hints = 1;\n";
+    config_file << "PRAGMA read_drop_behind;\n";
+  }
+
+  auto readable_storage = std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  readable_storage->set_storage_config(config_path);
+  auto db_filename = (rcpputils::fs::path(temporary_dir_path_) / "rosbag.db3").string();
+  readable_storage->open(db_filename, rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+
+  EXPECT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(deserialize_message(readable_storage->read_next()->serialized_data),
+    Eq("first message"));
+  EXPECT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(deserialize_message(readable_storage->read_next()->serialized_data),
+    Eq("second message"));
+  EXPECT_FALSE(readable_storage->has_next());
+}
+
+TEST_F(StorageTestFixture, async_durability_pragmas_are_consumed_and_writing_works) {
+  // The durability pseudo pragmas must be intercepted (sqlite would reject
+  // them) and a recording under the async policy must read back intact.
+  const auto config_path = (rcpputils::fs::path(temporary_dir_path_) / "config.txt").string();
+  {
+    std::ofstream config_file{config_path};
+    config_file << "PRAGMA durability = async;\n";
+    config_file << "PRAGMA durability_barrier_period = 1;\n";
+  }
+
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface> writable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  writable_storage->set_storage_config(config_path);
+  auto db_file = (rcpputils::fs::path(temporary_dir_path_) / "rosbag").string();
+  writable_storage->open(db_file);
+
+  writable_storage->create_topic({"topic1", "type1", "rmw1", ""});
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->serialized_data = make_serialized_message("async message");
+  message->time_stamp = 1;
+  message->topic_name = "topic1";
+  writable_storage->write(message);
+  writable_storage.reset();
+
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  readable_storage->open(
+    db_file + ".db3", rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+
+  ASSERT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(deserialize_message(readable_storage->read_next()->serialized_data),
+    Eq("async message"));
+  EXPECT_FALSE(readable_storage->has_next());
+}
+
+TEST_F(StorageTestFixture, exclusive_locking_pragma_is_consumed_and_writing_works) {
+  // The exclusive_locking pseudo pragma must be intercepted, a recording
+  // made while the connection holds the file lock must read back intact,
+  // and the lock must be gone once the writing storage is closed.
+  const auto config_path = (rcpputils::fs::path(temporary_dir_path_) / "config.txt").string();
+  {
+    std::ofstream config_file{config_path};
+    config_file << "PRAGMA exclusive_locking;\n";
+  }
+
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface> writable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  writable_storage->set_storage_config(config_path);
+  auto db_file = (rcpputils::fs::path(temporary_dir_path_) / "rosbag").string();
+  writable_storage->open(db_file);
+
+  writable_storage->create_topic({"topic1", "type1", "rmw1", ""});
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->serialized_data = make_serialized_message("exclusive message");
+  message->time_stamp = 1;
+  message->topic_name = "topic1";
+  writable_storage->write(message);
+  writable_storage.reset();
+
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  readable_storage->open(
+    db_file + ".db3", rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+
+  ASSERT_TRUE(readable_storage->has_next());
+  EXPECT_THAT(deserialize_message(readable_storage->read_next()->serialized_data),
+    Eq("exclusive message"));
+  EXPECT_FALSE(readable_storage->has_next());
+}
+
+TEST_F(StorageTestFixture, commit_latency_budget_pragma_is_consumed_and_batches_roundtrip) {
+  // The commit_latency_budget pseudo pragma must be intercepted (sqlite
+  // would reject it) and batch writes under adaptive transaction sizing -
+  // including small batches merged into a held-open transaction, committed
+  // at close - must read back complete and in order.
+  const auto config_path = (rcpputils::fs::path(temporary_dir_path_) / "config.txt").string();
+  {
+    std::ofstream config_file{config_path};
+    config_file << "PRAGMA commit_latency_budget = 20;\n";
+  }
+
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface> writable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  writable_storage->set_storage_config(config_path);
+  auto db_file = (rcpputils::fs::path(temporary_dir_path_) / "rosbag").string();
+  writable_storage->open(db_file);
+
+  writable_storage->create_topic({"topic1", "type1", "rmw1", ""});
+  std::vector<std::shared_ptr<const rosbag2_storage::SerializedBagMessage>> batch;
+  for (int i = 0; i < 100; ++i) {
+    auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+    message->serialized_data = make_serialized_message("batched message " + std::to_string(i));
+    message->time_stamp = i;
+    message->topic_name = "topic1";
+    batch.push_back(message);
+  }
+  writable_storage->write(batch);
+  writable_storage.reset();
+
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  readable_storage->open(
+    db_file + ".db3", rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(readable_storage->has_next());
+    EXPECT_THAT(deserialize_message(readable_storage->read_next()->serialized_data),
+      Eq("batched message " + std::to_string(i)));
+  }
+  EXPECT_FALSE(readable_storage->has_next());
+}
+
+TEST_F(StorageTestFixture, interned_topic_ids_resolve_without_name_lookup) {
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface> writable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  auto db_file = (rcpputils::fs::path(temporary_dir_path_) / "rosbag").string();
+  writable_storage->open(db_file);
+
+  // The writer stamps its interned ids into the metadata on create_topic.
+  rosbag2_storage::TopicMetadata first_topic{"topic1", "type1", "rmw1", ""};
+  first_topic.topic_id = 7u;
+  rosbag2_storage::TopicMetadata second_topic{"topic2", "type2", "rmw1", ""};
+  second_topic.topic_id = 3u;
+  writable_storage->create_topic(first_topic);
+  writable_storage->create_topic(second_topic);
+
+  // Messages carrying an interned id must land on the right topic even when
+  // the stamped name is wrong, proving that the id path resolved them.
+  auto message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  message->serialized_data = make_serialized_message("first");
+  message->time_stamp = 1;
+  message->topic_name = "no_such_topic";
+  message->topic_id = 7u;
+  writable_storage->write(message);
+  // An unknown id must fall back to the name lookup.
+  auto fallback_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  fallback_message->serialized_data = make_serialized_message("second");
+  fallback_message->time_stamp = 2;
+  fallback_message->topic_name = "topic2";
+  fallback_message->topic_id = 100u;
+  writable_storage->write(fallback_message);
+  writable_storage.reset();
+
+  std::unique_ptr<rosbag2_storage::storage_interfaces::ReadOnlyInterface> readable_storage =
+    std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
+  readable_storage->open(
+    db_file + ".db3", rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY);
+
+  // The read path exposes the database topic ids, both per topic and
+  // stamped on every message.
+  const auto all_topics_and_types = readable_storage->get_all_topics_and_types();
+  ASSERT_THAT(all_topics_and_types, SizeIs(2u));
+  EXPECT_THAT(all_topics_and_types[0].name, Eq("topic1"));
+  EXPECT_THAT(all_topics_and_types[0].topic_id, Ne(0u));
+  EXPECT_THAT(all_topics_and_types[1].topic_id, Ne(0u));
+
+  ASSERT_TRUE(readable_storage->has_next());
+  auto first_read = readable_storage->read_next();
+  EXPECT_THAT(first_read->topic_name, Eq("topic1"));
+  EXPECT_THAT(first_read->topic_id, Eq(all_topics_and_types[0].topic_id));
+  ASSERT_TRUE(readable_storage->has_next());
+  auto second_read = readable_storage->read_next();
+  EXPECT_THAT(second_read->topic_name, Eq("topic2"));
+  EXPECT_THAT(second_read->topic_id, Eq(all_topics_and_types[1].topic_id));
+  EXPECT_FALSE(readable_storage->has_next());
+}
+
 TEST_F(StorageTestFixture, get_storage_identifier_returns_sqlite3) {
   const auto storage = std::make_unique<rosbag2_storage_plugins::SqliteStorage>();
 
@@ -0,0 +1,198 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+
+#ifndef _WIN32
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+
+#include "rosbag2_storage_default_plugins/stream_sink/stream_sink_storage.hpp"
+
+#include "../sqlite/storage_test_fixture.hpp"
+
+using namespace ::testing;  // NOLINT
+
+namespace
+{
+// Minimal HTTP server accepting PUTs on an ephemeral port, recording the
+// request target of every object it receives.
+class TestHttpSink
+{
+public:
+  TestHttpSink()
+  {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+      listen(listen_fd_, 8) != 0)
+    {
+      throw std::runtime_error("Failed to start the test http sink.");
+    }
+    socklen_t address_size = sizeof(address);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&address), &address_size);
+    port_ = ntohs(address.sin_port);
+    server_thread_ = std::thread([this]() {serve();});
+  }
+
+  ~TestHttpSink()
+  {
+    stop_.store(true);
+    shutdown(listen_fd_, SHUT_RDWR);
+    close(listen_fd_);
+    server_thread_.join();
+  }
+
+  uint16_t port() const {return port_;}
+
+  std::vector<std::string> received_targets()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return targets_;
+  }
+
+private:
+  void serve()
+  {
+    while (!stop_.load()) {
+      const int fd = accept(listen_fd_, nullptr, nullptr);
+      if (fd < 0) {
+        return;
+      }
+      // Read the headers, then exactly Content-Length body bytes; the
+      // client waits for the response before closing its side.
+      std::string request;
+      char buffer[4096];
+      ssize_t received;
+      size_t body_expected = std::string::npos;
+      while (true) {
+        const auto header_end = request.find("\r\n\r\n");
+        if (header_end != std::string::npos) {
+          if (body_expected == std::string::npos) {
+            const auto length_pos = request.find("Content-Length:");
+            body_expected = length_pos == std::string::npos ?
+              0 : static_cast<size_t>(std::stoll(request.substr(length_pos + 15)));
+          }
+          if (request.size() >= header_end + 4 + body_expected) {
+            break;
+          }
+        }
+        received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+          break;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+      }
+      const auto target_start = request.find(' ');
+      const auto target_end = request.find(' ', target_start + 1);
+      if (target_start != std::string::npos && target_end != std::string::npos) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        targets_.push_back(request.substr(target_start + 1, target_end - target_start - 1));
+      }
+      const char response[] = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+      send(fd, response, sizeof(response) - 1, 0);
+      close(fd);
+    }
+  }
+
+  int listen_fd_;
+  uint16_t port_;
+  std::thread server_thread_;
+  std::atomic<bool> stop_ {false};
+  std::mutex mutex_;
+  std::vector<std::string> targets_;
+};
+}  // namespace
+
+class StreamSinkStorageTestFixture : public StorageTestFixture
+{
+public:
+  std::string bag_path()
+  {
+    return (rcpputils::fs::path(temporary_dir_path_) / "rosbag").string();
+  }
+
+  std::string write_sink_config(const std::string & endpoint)
+  {
+    const auto config_path =
+      (rcpputils::fs::path(temporary_dir_path_) / "sink_config").string();
+    std::ofstream config_file(config_path);
+    config_file << "PRAGMA sink_endpoint = " << endpoint << ";\n";
+    return config_path;
+  }
+
+  void record_messages_through_sink(const std::string & config_path)
+  {
+    rosbag2_storage_plugins::StreamSinkStorage storage;
+    storage.set_storage_config(config_path);
+    storage.open(bag_path());
+    storage.create_topic({"topic1", "string_type", "cdr", ""});
+    for (int64_t timestamp = 1; timestamp <= 3; ++timestamp) {
+      auto bag_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+      bag_message->serialized_data = make_serialized_message("a message");
+      bag_message->time_stamp = timestamp;
+      bag_message->topic_name = "topic1";
+      storage.write(bag_message);
+    }
+    // The destructor seals the partial chunk, uploads the footer and drains
+    // the in-flight queue.
+  }
+};
+
+TEST_F(StreamSinkStorageTestFixture, uploads_sealed_chunks_and_footer_to_the_sink) {
+  TestHttpSink sink;
+  const auto config_path = write_sink_config(
+    "http://127.0.0.1:" + std::to_string(sink.port()) + "/bags");
+
+  record_messages_through_sink(config_path);
+
+  const auto targets = sink.received_targets();
+  EXPECT_THAT(targets, Contains("/bags/rosbag/chunk_0"));
+  EXPECT_THAT(targets, Contains("/bags/rosbag/footer"));
+}
+
+TEST_F(StreamSinkStorageTestFixture, spills_chunks_locally_when_the_sink_is_unreachable) {
+  // Port 1 on localhost refuses connections immediately.
+  const auto config_path = write_sink_config("http://127.0.0.1:1/bags");
+
+  record_messages_through_sink(config_path);
+
+  EXPECT_TRUE((rcpputils::fs::path(bag_path() + ".spill") / "chunk_0").exists());
+  EXPECT_TRUE((rcpputils::fs::path(bag_path() + ".spill") / "footer").exists());
+}
+
+TEST_F(StreamSinkStorageTestFixture, opening_read_only_is_rejected) {
+  rosbag2_storage_plugins::StreamSinkStorage storage;
+  EXPECT_THROW(
+    storage.open(bag_path(), rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY),
+    std::runtime_error);
+}
+
+#endif  // _WIN32
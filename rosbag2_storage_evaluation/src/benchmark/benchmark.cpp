@@ -18,6 +18,8 @@
 
 #include <fstream>
 
+#include "common/result_recorder.h"
+
 void ros2bag::write_csv_file(
   std::string const & file_name, Benchmark const & benchmark, bool with_header)
 {
@@ -29,3 +31,12 @@ void ros2bag::write_csv_file(
   benchmark.write_csv(file, with_header);
   file.close();
 }
+
+void ros2bag::write_json_file(
+  std::string const & file_name, std::string const & benchmark_name,
+  Benchmark const & benchmark)
+{
+  ResultRecorder recorder(benchmark_name);
+  benchmark.record_results(recorder);
+  recorder.append_json_line(file_name);
+}
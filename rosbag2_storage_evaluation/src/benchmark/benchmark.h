@@ -23,6 +23,8 @@
 namespace ros2bag
 {
 
+class ResultRecorder;
+
 class Benchmark
 {
 public:
@@ -34,11 +36,21 @@ public:
 
   virtual void write_csv(std::ostream & out_stream, bool with_header) const = 0;
 
+  /* Fill the recorder with the run configuration and all measured metrics
+   * for the machine-readable results file. */
+  virtual void record_results(ResultRecorder & recorder) const = 0;
+
 };
 
 void write_csv_file(
   std::string const & file_name, Benchmark const & benchmark, bool with_header);
 
+/* Append one JSON line with configuration, metrics and environment
+ * information (git describe, hardware) to the given file. */
+void write_json_file(
+  std::string const & file_name, std::string const & benchmark_name,
+  Benchmark const & benchmark);
+
 }
 
 #endif //ROS2_ROSBAG_EVALUATION_BENCHMARK_H
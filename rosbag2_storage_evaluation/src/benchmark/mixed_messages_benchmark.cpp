@@ -20,6 +20,10 @@
 #include "profiler/profiler.h"
 #include "writer/sqlite/one_table_sqlite_writer.h"
 
+#ifdef ROSBAG2_EVALUATION_HAS_STORAGE_PLUGIN
+#include "writer/plugin/storage_plugin_writer.h"
+#endif
+
 using namespace ros2bag;
 
 void run_benchmark(
@@ -69,6 +73,7 @@ void run_benchmark(
   std::remove(db_name.c_str());
 
   write_csv_file("mixed_messages_benchmark.csv", benchmark, with_header);
+  write_json_file("mixed_messages_benchmark.jsonl", "mixed_messages_benchmark", benchmark);
 }
 
 void run_benchmark_repeatedly(
@@ -172,6 +177,22 @@ int main(int argc, char ** argv)
     big_messages,
     big_message_blob_size, transaction_size, write_header);
 
+#ifdef ROSBAG2_EVALUATION_HAS_STORAGE_PLUGIN
+  // The real plugin manages its own schema, pragmas and transactions, so
+  // only the uri is configurable; transaction size 0 marks plugin-managed.
+  run_benchmark_repeatedly(3,
+    "SqliteStoragePlugin",
+    std::make_shared<StoragePluginWriter>("mixed_messages_plugin_benchmark"),
+    "mixed_messages_plugin_benchmark.db3",
+    loop_count,
+    small_messages,
+    small_message_blob_size,
+    medium_messages,
+    medium_message_blob_size,
+    big_messages,
+    big_message_blob_size, 0, write_header);
+#endif
+
   return EXIT_SUCCESS;
 }
 
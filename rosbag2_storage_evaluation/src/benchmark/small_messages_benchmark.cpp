@@ -21,6 +21,10 @@
 #include "profiler/profiler.h"
 #include "writer/sqlite/one_table_sqlite_writer.h"
 
+#ifdef ROSBAG2_EVALUATION_HAS_STORAGE_PLUGIN
+#include "writer/plugin/storage_plugin_writer.h"
+#endif
+
 using namespace ros2bag;
 
 void run_benchmark(
@@ -51,6 +55,7 @@ void run_benchmark(
   std::remove(db_name.c_str());
 
   write_csv_file("small_messages_benchmark.csv", benchmark, with_header);
+  write_json_file("small_messages_benchmark.jsonl", "small_messages_benchmark", benchmark);
 }
 
 void run_benchmark_repeatedly(
@@ -122,5 +127,17 @@ int main(int argc, char ** argv)
     msg_size_bytes,
     transaction_size);
 
+#ifdef ROSBAG2_EVALUATION_HAS_STORAGE_PLUGIN
+  // The real plugin manages its own schema, pragmas and transactions, so
+  // only the uri is configurable; transaction size 0 marks plugin-managed.
+  run_benchmark_repeatedly(5,
+    "SqliteStoragePlugin",
+    std::make_shared<StoragePluginWriter>("small_messages_plugin_benchmark"),
+    "small_messages_plugin_benchmark.db3",
+    msg_count,
+    msg_size_bytes,
+    0);
+#endif
+
   return EXIT_SUCCESS;
 }
@@ -16,8 +16,10 @@
 
 #include "benchmark/writer/sqlite/sqlite_writer_benchmark.h"
 
+#include <cstdlib>
 #include <fstream>
 
+#include "common/result_recorder.h"
 #include "writer/sqlite/one_table_sqlite_writer.h"
 
 using namespace ros2bag;
@@ -27,6 +29,16 @@ void SqliteWriterBenchmark::run() const
   generator_->reset();
   writer_->reset();
 
+  // Opt-in, so runs on machines without perf_event access are unaffected.
+  if (std::getenv("ROSBAG2_PROFILE_HW_COUNTERS")) {
+    profiler_->enable_hardware_counters();
+  }
+
+  // Opt-in: counting every heap allocation is cheap but not free.
+  if (std::getenv("ROSBAG2_PROFILE_ALLOCATIONS")) {
+    profiler_->enable_allocation_tracking();
+  }
+
   profiler_->take_time_for("start writing time");
 
   Profiler::TickProgress throughput_tick = profiler_->measure_progress(
@@ -56,3 +68,13 @@ void SqliteWriterBenchmark::write_csv(std::ostream & out_stream, bool with_heade
   }
   out_stream << profiler_->csv_entry() << std::endl;
 }
+
+void SqliteWriterBenchmark::record_results(ResultRecorder & recorder) const
+{
+  for (auto const & entry : profiler_->meta_data()) {
+    recorder.add_config(entry.first, entry.second);
+  }
+  for (auto const & measurement : profiler_->measurements()) {
+    recorder.add_metric(measurement.first, measurement.second);
+  }
+}
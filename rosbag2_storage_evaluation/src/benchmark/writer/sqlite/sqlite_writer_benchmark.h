@@ -43,6 +43,8 @@ public:
 
   void write_csv(std::ostream & out_stream, bool with_header) const override;
 
+  void record_results(ResultRecorder & recorder) const override;
+
 private:
   std::unique_ptr<MessageGenerator> generator_;
   std::shared_ptr<MessageWriter> writer_;
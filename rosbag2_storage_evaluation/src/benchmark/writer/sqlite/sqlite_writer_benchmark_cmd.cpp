@@ -44,6 +44,7 @@ int main(int argc, char ** argv)
   benchmark.run();
 
   write_csv_file("sqlite3_writer_benchmark.csv", benchmark, true);
+  write_json_file("sqlite3_writer_benchmark.jsonl", "sqlite3_writer_benchmark", benchmark);
 
   return EXIT_SUCCESS;
 }
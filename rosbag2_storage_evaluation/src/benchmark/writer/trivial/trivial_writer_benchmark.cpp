@@ -17,8 +17,10 @@
 #include "trivial_writer_benchmark.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <fstream>
 
+#include "common/result_recorder.h"
 #include "writer/stream/message_stream_writer.h"
 
 using namespace ros2bag;
@@ -28,6 +30,11 @@ void TrivialWriterBenchmark::run() const
   generator_->reset();
   writer_->reset();
 
+  // Opt-in, so runs on machines without perf_event access are unaffected.
+  if (std::getenv("ROSBAG2_PROFILE_HW_COUNTERS")) {
+    profiler_->enable_hardware_counters();
+  }
+
 
   Profiler::TickProgress throughput_tick = profiler_->measure_progress(
     "write_throughput", generator_->total_msg_count());
@@ -52,6 +59,16 @@ void TrivialWriterBenchmark::write_csv(std::ostream & out_stream, bool with_head
   out_stream << profiler_->csv_entry() << std::endl;
 }
 
+void TrivialWriterBenchmark::record_results(ResultRecorder & recorder) const
+{
+  for (auto const & entry : profiler_->meta_data()) {
+    recorder.add_config(entry.first, entry.second);
+  }
+  for (auto const & measurement : profiler_->measurements()) {
+    recorder.add_metric(measurement.first, measurement.second);
+  }
+}
+
 int main(int argc, char ** argv)
 {
   if (argc != 4) {
@@ -76,6 +93,7 @@ int main(int argc, char ** argv)
   benchmark.run();
 
   write_csv_file("trivial_writer_benchmark.csv", benchmark, true);
+  write_json_file("trivial_writer_benchmark.jsonl", "trivial_writer_benchmark", benchmark);
 
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2018,  Bosch Software Innovations GmbH.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "common/result_recorder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+using namespace ros2bag;
+
+namespace
+{
+
+std::string json_escape(std::string const & value)
+{
+  std::ostringstream escaped;
+  for (char const c : value) {
+    switch (c) {
+      case '"':
+        escaped << "\\\"";
+        break;
+      case '\\':
+        escaped << "\\\\";
+        break;
+      case '\n':
+        escaped << "\\n";
+        break;
+      case '\t':
+        escaped << "\\t";
+        break;
+      default:
+        escaped << c;
+    }
+  }
+  return escaped.str();
+}
+
+std::string current_timestamp()
+{
+  auto const now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  char buffer[sizeof "1970-01-01T00:00:00Z"];
+  tm utc_time;
+#ifdef _WIN32
+  gmtime_s(&utc_time, &now);
+#else
+  gmtime_r(&now, &utc_time);
+#endif
+  std::strftime(buffer, sizeof buffer, "%Y-%m-%dT%H:%M:%SZ", &utc_time);
+  return buffer;
+}
+
+std::string run_command(std::string const & command)
+{
+#ifdef _WIN32
+  return "";
+#else
+  FILE * pipe = popen(command.c_str(), "r");
+  if (!pipe) {
+    return "";
+  }
+  char buffer[256];
+  std::string output;
+  while (fgets(buffer, sizeof buffer, pipe)) {
+    output += buffer;
+  }
+  pclose(pipe);
+  while (!output.empty() && (output.back() == '\n' || output.back() == '\r')) {
+    output.pop_back();
+  }
+  return output;
+#endif
+}
+
+std::string current_hostname()
+{
+#ifdef _WIN32
+  return "";
+#else
+  char buffer[256] = {0};
+  gethostname(buffer, sizeof buffer - 1);
+  return buffer;
+#endif
+}
+
+std::string current_os()
+{
+#ifdef _WIN32
+  return "Windows";
+#else
+  utsname name;
+  if (uname(&name) != 0) {
+    return "";
+  }
+  return std::string(name.sysname) + " " + name.release;
+#endif
+}
+
+void write_object(
+  std::ostringstream & json,
+  std::vector<std::pair<std::string, std::string>> const & entries)
+{
+  json << "{";
+  bool first = true;
+  for (auto const & entry : entries) {
+    if (!first) {
+      json << ", ";
+    }
+    json << "\"" << json_escape(entry.first) << "\": \"" << json_escape(entry.second) << "\"";
+    first = false;
+  }
+  json << "}";
+}
+
+}
+
+ResultRecorder::ResultRecorder(std::string const & benchmark_name)
+  : benchmark_name_(benchmark_name),
+  timestamp_(current_timestamp()),
+  git_describe_(run_command("git describe --tags --always --dirty 2>/dev/null")),
+  hostname_(current_hostname()),
+  os_(current_os()),
+  cpu_count_(std::thread::hardware_concurrency())
+{}
+
+void ResultRecorder::add_config(std::string const & key, std::string const & value)
+{
+  config_.emplace_back(key, value);
+}
+
+void ResultRecorder::add_metric(std::string const & key, std::string const & value)
+{
+  metrics_.emplace_back(key, value);
+}
+
+void ResultRecorder::add_metric(std::string const & key, double value)
+{
+  std::ostringstream formatted;
+  formatted << value;
+  metrics_.emplace_back(key, formatted.str());
+}
+
+std::string ResultRecorder::to_json() const
+{
+  std::ostringstream json;
+  json << "{";
+  json << "\"benchmark\": \"" << json_escape(benchmark_name_) << "\", ";
+  json << "\"timestamp\": \"" << timestamp_ << "\", ";
+  json << "\"git_describe\": \"" << json_escape(git_describe_) << "\", ";
+  json << "\"hardware\": {";
+  json << "\"hostname\": \"" << json_escape(hostname_) << "\", ";
+  json << "\"os\": \"" << json_escape(os_) << "\", ";
+  json << "\"cpu_count\": " << cpu_count_ << "}, ";
+  json << "\"config\": ";
+  write_object(json, config_);
+  json << ", \"metrics\": ";
+  write_object(json, metrics_);
+  json << "}";
+  return json.str();
+}
+
+void ResultRecorder::append_json_line(std::string const & file_name) const
+{
+  std::ofstream file(file_name, std::ofstream::out | std::ofstream::app);
+  file << to_json() << std::endl;
+}
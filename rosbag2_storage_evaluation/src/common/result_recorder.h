@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2018,  Bosch Software Innovations GmbH.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef ROS2_ROSBAG_EVALUATION_RESULT_RECORDER_H
+#define ROS2_ROSBAG_EVALUATION_RESULT_RECORDER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ros2bag
+{
+
+/*
+ * Machine-readable benchmark results. Every record is one JSON object per
+ * line (JSON lines), carrying the run configuration, all metrics, and enough
+ * environment information (timestamp, git describe, hostname, OS, CPU count)
+ * to archive runs and diff performance release over release.
+ */
+class ResultRecorder
+{
+public:
+  explicit ResultRecorder(std::string const & benchmark_name);
+
+  void add_config(std::string const & key, std::string const & value);
+
+  void add_metric(std::string const & key, std::string const & value);
+
+  void add_metric(std::string const & key, double value);
+
+  std::string to_json() const;
+
+  void append_json_line(std::string const & file_name) const;
+
+private:
+  std::string benchmark_name_;
+  std::string timestamp_;
+  std::string git_describe_;
+  std::string hostname_;
+  std::string os_;
+  unsigned int cpu_count_;
+  std::vector<std::pair<std::string, std::string>> config_;
+  std::vector<std::pair<std::string, std::string>> metrics_;
+};
+
+}
+
+#endif //ROS2_ROSBAG_EVALUATION_RESULT_RECORDER_H
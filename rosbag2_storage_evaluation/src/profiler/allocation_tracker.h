@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2018,  Bosch Software Innovations GmbH.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef ROS2_ROSBAG_EVALUATION_ALLOCATION_TRACKER_H
+#define ROS2_ROSBAG_EVALUATION_ALLOCATION_TRACKER_H
+
+namespace ros2bag
+{
+
+/*
+ * Process-wide heap allocation counters, fed by operator new/delete
+ * interposition in allocation_tracker.cpp. Counting is opt-in: until
+ * enable() is called, every allocation pays only a relaxed atomic load.
+ * Thread safe; counters are cumulative, callers diff snapshots to get
+ * per-phase numbers.
+ */
+namespace allocation_tracker
+{
+
+constexpr int SIZE_CLASS_COUNT = 8;
+
+struct Snapshot
+{
+  unsigned long long allocations;
+  unsigned long long bytes;
+  unsigned long long size_classes[SIZE_CLASS_COUNT];
+};
+
+void enable();
+
+bool enabled();
+
+Snapshot sample();
+
+/* Human-readable upper bound of a size class, e.g. "<=1KiB". */
+char const * size_class_label(int index);
+
+}
+
+}
+
+#endif //ROS2_ROSBAG_EVALUATION_ALLOCATION_TRACKER_H
@@ -16,15 +16,108 @@
 
 #include "profiler/profiler.h"
 
+#include <cstring>
 #include <fstream>
+#include <iostream>
 #include <sstream>
 
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 using namespace ros2bag;
 using namespace std::literals::chrono_literals;
 
+namespace
+{
+
+#ifdef __linux__
+int open_perf_counter(unsigned int type, unsigned long long config)
+{
+  perf_event_attr attributes;
+  std::memset(&attributes, 0, sizeof attributes);
+  attributes.size = sizeof attributes;
+  attributes.type = type;
+  attributes.config = config;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  return static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+
+long long read_perf_counter(int fd)
+{
+  long long value = 0;
+  if (read(fd, &value, sizeof value) != sizeof value) {
+    return 0;
+  }
+  return value;
+}
+#endif
+
+}
+
+Profiler::~Profiler()
+{
+#ifdef __linux__
+  for (int const fd : counter_fds_) {
+    close(fd);
+  }
+#endif
+}
+
+void Profiler::enable_hardware_counters()
+{
+#ifdef __linux__
+  if (!counter_fds_.empty()) {
+    return;
+  }
+  int const instructions = open_perf_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  int const cache_misses = open_perf_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  int const branch_misses = open_perf_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+  if (instructions < 0 || cache_misses < 0 || branch_misses < 0) {
+    std::cerr << "Hardware counters unavailable "
+              << "(check /proc/sys/kernel/perf_event_paranoid), profiling wall time only"
+              << std::endl;
+    for (int const fd : {instructions, cache_misses, branch_misses}) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+    return;
+  }
+  counter_fds_ = {instructions, cache_misses, branch_misses};
+#endif
+}
+
+Profiler::CounterSample Profiler::read_counters() const
+{
+#ifdef __linux__
+  return CounterSample{
+    read_perf_counter(counter_fds_[0]),
+    read_perf_counter(counter_fds_[1]),
+    read_perf_counter(counter_fds_[2])};
+#else
+  return CounterSample{0, 0, 0};
+#endif
+}
+
+void Profiler::enable_allocation_tracking()
+{
+  allocation_tracker::enable();
+  allocation_tracking_ = true;
+}
+
 void Profiler::take_time_for(std::string const & task)
 {
   time_points_.emplace_back(task, std::chrono::system_clock::now());
+  if (!counter_fds_.empty()) {
+    counter_samples_.emplace_back(task, read_counters());
+  }
+  if (allocation_tracking_) {
+    allocation_samples_.emplace_back(task, allocation_tracker::sample());
+  }
 }
 
 void Profiler::track_disk_usage()
@@ -46,6 +139,25 @@ std::string Profiler::csv_header() const
     header << t.first << " (ms),";
   }
 
+  for (auto const & sample : counter_samples_) {
+    header << sample.first << " (instructions),";
+    header << sample.first << " (cache misses),";
+    header << sample.first << " (branch misses),";
+  }
+
+  for (auto const & sample : allocation_samples_) {
+    header << sample.first << " (allocations),";
+    header << sample.first << " (allocated bytes),";
+  }
+  if (!allocation_samples_.empty()) {
+    for (int size_class = 0;
+      size_class < allocation_tracker::SIZE_CLASS_COUNT; ++size_class)
+    {
+      header << "allocations " << allocation_tracker::size_class_label(size_class) << ",";
+    }
+    header << "allocations per message,";
+  }
+
   header << "disk usage (bytes)";
 
   return header.str();
@@ -67,16 +179,104 @@ std::string Profiler::csv_entry() const
     }
   }
 
+  /* Counter values are reported relative to the first sample, mirroring the
+   * time points which are milliseconds since the first one. */
+  if (!counter_samples_.empty()) {
+    auto const & start = counter_samples_.front().second;
+    for (auto const & sample : counter_samples_) {
+      entry << sample.second.instructions - start.instructions << ",";
+      entry << sample.second.cache_misses - start.cache_misses << ",";
+      entry << sample.second.branch_misses - start.branch_misses << ",";
+    }
+  }
+
+  /* Allocation values are also relative to the first sample, which is taken
+   * before the first message is written. */
+  if (!allocation_samples_.empty()) {
+    auto const & start = allocation_samples_.front().second;
+    for (auto const & sample : allocation_samples_) {
+      entry << sample.second.allocations - start.allocations << ",";
+      entry << sample.second.bytes - start.bytes << ",";
+    }
+    auto const & last = allocation_samples_.back().second;
+    for (int size_class = 0;
+      size_class < allocation_tracker::SIZE_CLASS_COUNT; ++size_class)
+    {
+      entry << last.size_classes[size_class] - start.size_classes[size_class] << ",";
+    }
+    auto const allocations = last.allocations - start.allocations;
+    entry << (progress_total_ ?
+      static_cast<double>(allocations) / progress_total_ : 0.0) << ",";
+  }
+
   entry << disk_usage_;
 
   return entry.str();
 }
 
+std::vector<std::pair<std::string, std::string>> Profiler::measurements() const
+{
+  std::vector<std::pair<std::string, std::string>> measurements;
+
+  if (!time_points_.empty()) {
+    auto const start = time_points_.front().second;
+    for (auto const & t : time_points_) {
+      auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(t.second - start);
+      measurements.emplace_back(t.first + " (ms)", std::to_string(timestamp.count()));
+    }
+  }
+
+  if (!counter_samples_.empty()) {
+    auto const & start = counter_samples_.front().second;
+    for (auto const & sample : counter_samples_) {
+      measurements.emplace_back(
+        sample.first + " (instructions)",
+        std::to_string(sample.second.instructions - start.instructions));
+      measurements.emplace_back(
+        sample.first + " (cache misses)",
+        std::to_string(sample.second.cache_misses - start.cache_misses));
+      measurements.emplace_back(
+        sample.first + " (branch misses)",
+        std::to_string(sample.second.branch_misses - start.branch_misses));
+    }
+  }
+
+  if (!allocation_samples_.empty()) {
+    auto const & start = allocation_samples_.front().second;
+    for (auto const & sample : allocation_samples_) {
+      measurements.emplace_back(
+        sample.first + " (allocations)",
+        std::to_string(sample.second.allocations - start.allocations));
+      measurements.emplace_back(
+        sample.first + " (allocated bytes)",
+        std::to_string(sample.second.bytes - start.bytes));
+    }
+    auto const & last = allocation_samples_.back().second;
+    for (int size_class = 0;
+      size_class < allocation_tracker::SIZE_CLASS_COUNT; ++size_class)
+    {
+      measurements.emplace_back(
+        std::string("allocations ") + allocation_tracker::size_class_label(size_class),
+        std::to_string(last.size_classes[size_class] - start.size_classes[size_class]));
+    }
+    auto const allocations = last.allocations - start.allocations;
+    measurements.emplace_back(
+      "allocations per message",
+      std::to_string(
+        progress_total_ ? static_cast<double>(allocations) / progress_total_ : 0.0));
+  }
+
+  measurements.emplace_back("disk usage (bytes)", std::to_string(disk_usage_));
+
+  return measurements;
+}
+
 Profiler::TickProgress Profiler::measure_progress(
   const std::string & subject,
   unsigned long const total,
   const unsigned long increment)
 {
+  progress_total_ = total;
   take_time_for(subject + "_0"/*%*/);
 
   return [this, next_level = 10, current = 0, subject, total, increment]() mutable {
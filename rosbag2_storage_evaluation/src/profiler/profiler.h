@@ -22,6 +22,7 @@
 #include <functional>
 
 #include "benchmark/benchmark.h"
+#include "profiler/allocation_tracker.h"
 
 namespace ros2bag
 {
@@ -35,7 +36,21 @@ public:
     : meta_data_(meta_data), file_name_(file_name)
   {}
 
-  ~Profiler() = default;
+  ~Profiler();
+
+  /* Try to open Linux perf_event hardware counters (instructions retired,
+   * cache misses, branch misses). When successful, every subsequent
+   * take_time_for() also samples the counters and the report grows one
+   * column per counter and time point. A no-op on other platforms or when
+   * the counters cannot be opened (e.g. perf_event_paranoid too strict). */
+  void enable_hardware_counters();
+
+  /* Turn on the process-wide heap allocation counters (see
+   * allocation_tracker.h). Every subsequent take_time_for() also samples
+   * allocation count and bytes, and the report grows per-phase allocation
+   * columns, a size-class breakdown over the whole run and an
+   * allocations-per-message figure. */
+  void enable_allocation_tracking();
 
   void take_time_for(std::string const & task);
 
@@ -45,6 +60,15 @@ public:
 
   std::string csv_entry() const;
 
+  std::vector<std::pair<std::string, std::string>> meta_data() const
+  {
+    return meta_data_;
+  }
+
+  /* The measured values as key/value pairs: every tracked time point as
+   * milliseconds since the first one, plus the disk usage in bytes. */
+  std::vector<std::pair<std::string, std::string>> measurements() const;
+
   using TickProgress = std::function<void()>;
 
   TickProgress measure_progress(
@@ -54,10 +78,28 @@ public:
   );
 
 private:
+  struct CounterSample
+  {
+    long long instructions;
+    long long cache_misses;
+    long long branch_misses;
+  };
+
+  CounterSample read_counters() const;
+
   std::string file_name_;
   long disk_usage_;
   std::vector<std::pair<std::string, std::string>> meta_data_;
   std::vector<std::pair<std::string, std::chrono::system_clock::time_point>> time_points_;
+  /* File descriptors of the opened perf_event counters, in the order
+   * instructions, cache misses, branch misses; empty when disabled. */
+  std::vector<int> counter_fds_;
+  std::vector<std::pair<std::string, CounterSample>> counter_samples_;
+  bool allocation_tracking_ = false;
+  std::vector<std::pair<std::string, allocation_tracker::Snapshot>> allocation_samples_;
+  /* Total units of the last measure_progress() call, i.e. the number of
+   * messages; used to report allocations per message. */
+  unsigned long progress_total_ = 0;
 };
 
 }
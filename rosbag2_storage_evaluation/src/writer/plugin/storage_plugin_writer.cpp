@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2018,  Bosch Software Innovations GmbH.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include "writer/plugin/storage_plugin_writer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+#include "rcutils/allocator.h"
+#include "rosbag2_storage/serialized_bag_message.hpp"
+#include "rosbag2_storage/topic_metadata.hpp"
+
+using namespace ros2bag;
+
+StoragePluginWriter::~StoragePluginWriter()
+{
+  StoragePluginWriter::close();
+}
+
+void StoragePluginWriter::open()
+{
+  storage_ = factory_.open_read_write(uri_, storage_id_);
+  if (!storage_) {
+    throw std::runtime_error("Could not open storage plugin '" + storage_id_ + "'");
+  }
+}
+
+void StoragePluginWriter::close()
+{
+  storage_.reset();
+}
+
+void StoragePluginWriter::write(MessagePtr message)
+{
+  if (known_topics_.insert(message->topic()).second) {
+    rosbag2_storage::TopicMetadata topic;
+    topic.name = message->topic();
+    topic.type = "benchmark_blob";
+    topic.serialization_format = "cdr";
+    storage_->create_topic(topic);
+  }
+
+  auto blob = message->blob();
+  auto serialized_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+  // Point the array at the generator-owned blob instead of copying it. The
+  // blob is captured by the deleter, which keeps it alive for as long as the
+  // plugin holds the message (e.g. in its write buffer).
+  serialized_message->serialized_data = std::shared_ptr<rcutils_uint8_array_t>(
+    new rcutils_uint8_array_t(),
+    [blob](rcutils_uint8_array_t * array) {delete array;});
+  auto & data = *serialized_message->serialized_data;
+  data.buffer = const_cast<unsigned char *>(blob->data());
+  data.buffer_length = blob->size();
+  data.buffer_capacity = blob->size();
+  data.allocator = rcutils_get_default_allocator();
+  serialized_message->time_stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    message->timestamp().time_since_epoch()).count();
+  serialized_message->topic_name = message->topic();
+
+  storage_->write(serialized_message);
+}
+
+void StoragePluginWriter::create_index()
+{
+  // The plugin creates its indices when opening the database.
+}
+
+void StoragePluginWriter::reset()
+{
+  close();
+  known_topics_.clear();
+  std::remove((uri_ + ".db3").c_str());
+}
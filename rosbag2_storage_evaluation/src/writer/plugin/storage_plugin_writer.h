@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2018,  Bosch Software Innovations GmbH.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef ROS2_ROSBAG_EVALUATION_STORAGE_PLUGIN_WRITER_H
+#define ROS2_ROSBAG_EVALUATION_STORAGE_PLUGIN_WRITER_H
+
+#include <memory>
+#include <set>
+#include <string>
+
+#include "rosbag2_storage/storage_factory.hpp"
+#include "rosbag2_storage/storage_interfaces/read_write_interface.hpp"
+
+#include "writer/message_writer.h"
+
+namespace ros2bag
+{
+
+/*
+ * Drives an actual rosbag2 storage plugin (sqlite3 by default) through the
+ * rosbag2_storage interface, so that the benchmarks measure the shipped
+ * SqliteStorage instead of the standalone writers in src/writer/sqlite,
+ * which have drifted from the plugin over time.
+ *
+ * The uri is passed to the plugin without file extension; the sqlite3
+ * plugin appends ".db3".
+ */
+class StoragePluginWriter : public MessageWriter
+{
+public:
+  explicit StoragePluginWriter(
+    std::string const & uri,
+    std::string const & storage_id = "sqlite3")
+    : uri_(uri), storage_id_(storage_id)
+  {}
+
+  ~StoragePluginWriter() override;
+
+  void open() final;
+
+  void close() final;
+
+  void write(MessagePtr message) final;
+
+  void create_index() final;
+
+  void reset() final;
+
+private:
+  std::string const uri_;
+  std::string const storage_id_;
+  rosbag2_storage::StorageFactory factory_;
+  std::shared_ptr<rosbag2_storage::storage_interfaces::ReadWriteInterface> storage_;
+  std::set<std::string> known_topics_;
+};
+
+}
+
+#endif //ROS2_ROSBAG_EVALUATION_STORAGE_PLUGIN_WRITER_H
@@ -0,0 +1,118 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "rclcpp/rclcpp.hpp"
+#include "rosbag2_test_common/process_execution_helpers.hpp"
+
+#include "record_fixture.hpp"
+
+// Capacity contract for the whole record pipeline, from rmw delivery
+// through the transport and writer down to sqlite. Unlike the functional
+// end-to-end tests this one publishes a sustained high-rate load and fails
+// when the achieved drop rate exceeds a budget, so it is only built on
+// demand with BUILD_ROSBAG2_BENCHMARKS. The load and the budget are
+// configurable through environment variables, so the same binary can
+// encode different contracts:
+//
+//   ROSBAG2_CAPACITY_RATE_HZ           publish rate (default 200)
+//   ROSBAG2_CAPACITY_MESSAGE_BYTES     approximate message size (default 100000)
+//   ROSBAG2_CAPACITY_MESSAGE_COUNT     messages to publish (default 2000)
+//   ROSBAG2_CAPACITY_MAX_DROP_PERCENT  allowed drop rate (default 1.0)
+
+namespace
+{
+
+unsigned int env_or(const char * name, unsigned int fallback)
+{
+  const char * value = std::getenv(name);
+  return value ? static_cast<unsigned int>(std::stoul(value)) : fallback;
+}
+
+double env_or_double(const char * name, double fallback)
+{
+  const char * value = std::getenv(name);
+  return value ? std::stod(value) : fallback;
+}
+
+std::shared_ptr<test_msgs::msg::Strings> create_string_message_of_size(
+  const std::string & base_message, const unsigned int message_size_bytes)
+{
+  std::stringstream message_str;
+  while (message_str.tellp() < static_cast<std::streampos>(message_size_bytes)) {
+    message_str << base_message;
+  }
+
+  auto message = get_messages_strings()[0];
+  message->string_value = message_str.str();
+  return message;
+}
+
+}  // namespace
+
+TEST_F(RecordFixture, record_pipeline_sustains_configured_load_within_drop_budget) {
+  const auto rate_hz = std::max(1u, std::min(1000u, env_or("ROSBAG2_CAPACITY_RATE_HZ", 200)));
+  const auto message_bytes = env_or("ROSBAG2_CAPACITY_MESSAGE_BYTES", 100000);
+  const auto message_count = env_or("ROSBAG2_CAPACITY_MESSAGE_COUNT", 2000);
+  const auto max_drop_percent = env_or_double("ROSBAG2_CAPACITY_MAX_DROP_PERCENT", 1.0);
+
+  constexpr const char topic_name[] = "/capacity_test_topic";
+  const auto message = create_string_message_of_size("capacity", message_bytes);
+
+  std::stringstream cmd;
+  cmd << "ros2 bag record --output " << root_bag_path_.string() << " " << topic_name;
+  auto process_handle = start_execution(cmd.str());
+  wait_for_db();
+
+  const auto publish_start = std::chrono::steady_clock::now();
+  pub_man_.run_scoped_publisher(
+    topic_name,
+    message,
+    std::chrono::milliseconds(1000 / rate_hz),
+    static_cast<int>(message_count));
+  const auto publish_seconds = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - publish_start).count();
+
+  // Let the recorder drain its cache before asking it to stop.
+  std::this_thread::sleep_for(1s);
+  stop_execution(process_handle);
+  wait_for_metadata();
+
+  rosbag2_storage_plugins::SqliteWrapper db{
+    get_bag_file_path(0).string(), rosbag2_storage::storage_interfaces::IOFlag::READ_ONLY};
+  const auto recorded = count_stored_messages(db, topic_name);
+
+  const auto dropped = message_count > recorded ? message_count - recorded : 0u;
+  const auto drop_percent = 100.0 * dropped / message_count;
+  const auto achieved_mbps =
+    static_cast<double>(recorded) * message_bytes / publish_seconds / (1024.0 * 1024.0);
+
+  std::cout << "Capacity run: " << message_count << " messages of ~" << message_bytes <<
+    " B at " << rate_hz << " Hz over " << publish_seconds << " s" << std::endl;
+  std::cout << "Recorded " << recorded << " (" << dropped << " dropped, " <<
+    drop_percent << " %), achieved throughput " << achieved_mbps << " MB/s" << std::endl;
+
+  EXPECT_LE(drop_percent, max_drop_percent) <<
+    "Record pipeline dropped more than the configured budget of " <<
+    max_drop_percent << " % at " << rate_hz << " Hz with " <<
+    message_bytes << " B messages";
+}
@@ -21,6 +21,9 @@
 #include <vector>
 
 #include "rclcpp/qos.hpp"
+#include "rcutils/time.h"
+
+#include "rosbag2_transport/thread_attributes.hpp"
 
 namespace rosbag2_transport
 {
@@ -29,6 +32,24 @@ struct PlayOptions
 {
 public:
   size_t read_ahead_queue_size;
+
+  // Budget the read-ahead queue in bytes of serialized message data instead
+  // of in messages. A message count holds 4 KB IMU samples or 8 MB images
+  // alike, so it either starves on big-message bags or balloons memory on
+  // mixed ones; a byte budget keeps replay memory predictable regardless of
+  // bag composition. When set, read_ahead_queue_size is ignored for the
+  // queue bound (it still applies when this is 0).
+  uint64_t read_ahead_byte_budget = 0;
+
+  // Target probability of the read-ahead queue draining empty before a
+  // refill completes. The loader measures how fast playback drains the
+  // queue and how long its refills take, and moves the refill low-water
+  // mark so this bound holds: fast storage refills later (less cache
+  // churn), slow compressed storage refills earlier (no starvation
+  // warnings), from the same configuration. Values outside (0, 1) disable
+  // the adaptation and keep the fixed-percentage low-water mark.
+  double read_ahead_starvation_probability = 0.01;
+
   std::string node_prefix = "";
   float rate = 1.0;
 
@@ -37,9 +58,103 @@ public:
   // If list is empty, the filter is ignored and all messages are played.
   std::vector<std::string> topics_to_filter = {};
 
+  // Regular expression of topic names to play back, in addition to the
+  // explicit topics_to_filter list. If both are empty, all topics play.
+  std::string topics_regex_to_filter = "";
+
+  // Regular expression of topic names to exclude from playback. Exclusion
+  // wins over topics_to_filter and topics_regex_to_filter.
+  std::string topics_regex_to_exclude = "";
+
+  // Per-topic every-Nth decimation: a topic mapped to N only plays every
+  // Nth of its messages (e.g. 4 turns a 60 Hz camera into 15 Hz for a
+  // visualization consumer that drops frames anyway). Applied in the
+  // storage loading thread before messages enter the read-ahead queue, so
+  // decimated messages are never queued or published. Topics not listed,
+  // and values of 0 or 1, play every message.
+  std::unordered_map<std::string, uint64_t> topic_sampling = {};
+
+  // Per-topic playback rate cap in Hz, based on the recorded timestamps:
+  // a message closer than 1/f seconds of bag time to the previously kept
+  // message of its topic is dropped. Unlike every-Nth sampling this gives
+  // a steady output rate on topics with an irregular recording rate.
+  // Applied in the same place as topic_sampling; both may be combined.
+  // Topics not listed, and values <= 0, play every message.
+  std::unordered_map<std::string, double> topic_max_frequencies = {};
+
+  // Time window to play back, in nanoseconds since epoch.
+  // Negative values disable the respective bound and the whole bag is played.
+  // The bounds are pushed down into the storage so messages outside the
+  // window are never read from disk.
+  rcutils_time_point_value_t start_time = -1;
+  rcutils_time_point_value_t end_time = -1;
+
+  // Start playback this far into the bag, in nanoseconds relative to the
+  // recording time of its first message. Resolved against the bag metadata
+  // and pushed down into the storage like start_time, so skipped messages
+  // are never read from disk. 0 plays from the beginning; when both are
+  // given, the later of start_time and the offset wins.
+  rcutils_time_point_value_t start_offset = 0;
+
+  // Play at most this long, in nanoseconds from the effective start of
+  // playback. Also pushed down into the storage. Negative values play to
+  // the end of the bag; when both are given, the earlier of end_time and
+  // the duration bound wins.
+  rcutils_time_point_value_t playback_duration = -1;
+
   std::unordered_map<std::string, rclcpp::QoS> topic_qos_profile_overrides = {};
   bool loop = false;
+
+  // When looping, retain up to this many bytes of already-decoded messages
+  // in memory during the first pass and replay later loops from that cache
+  // with rebased timestamps, without touching the storage again. Bags
+  // exceeding the budget rewind via a storage-level seek instead.
+  // A value of 0 disables the cache and always rewinds via seek.
+  uint64_t loop_cache_size = 0;
+
+  // Publish /clock from the replay timeline at this frequency in Hz, for
+  // downstream nodes running with use_sim_time. The published time is driven
+  // by the same playback clock as the messages, so it stays exactly
+  // consistent with the replayed timestamps across rate changes, pauses and
+  // seeks. A value of 0 disables the clock publisher.
+  double clock_publish_frequency = 0.0;
+
+  // Play the bag backwards: messages are published in descending timestamp
+  // order with their recorded spacing reversed. Backed by a reversed
+  // storage cursor, so stepping backwards through a bag (pause plus the
+  // step service) costs the same as stepping forward instead of re-reading
+  // from the beginning. Not supported for sharded bags.
+  bool reverse = false;
+
+  // Keep-up playback: when the machine cannot keep pace, a deadline in the
+  // past publishes late forever and replay drifts unboundedly. With a
+  // budget set, a message due longer ago than this many nanoseconds is
+  // skipped instead of published late, so the remaining replay stays
+  // time-faithful under load. Skips are counted per topic and reported
+  // when playback ends. Negative (the default) always publishes, however
+  // late.
+  rcutils_time_point_value_t lateness_budget = -1;
+
+  // Per-topic overrides of lateness_budget, in nanoseconds; a negative
+  // value exempts the topic from skipping. Lets e.g. a camera stream drop
+  // late frames aggressively while /tf keeps a generous budget. Only
+  // consulted when lateness_budget is set.
+  std::unordered_map<std::string, rcutils_time_point_value_t> topic_lateness_budgets = {};
+
+  // Ignore the recorded timeline and publish as fast as the middleware
+  // accepts, draining the read-ahead queue without any pacing sleeps. Meant
+  // for offline pipelines; a throughput report (messages/s, MB/s, per-topic
+  // counts) is logged when playback finishes. Overrides rate.
+  bool as_fast_as_possible = false;
   std::vector<std::string> topic_remapping_options = {};
+
+  // CPU affinity and scheduling priority per player thread role, applied
+  // when the thread starts. Known roles: "playback" (the pacing thread,
+  // the natural candidate for a SCHED_FIFO priority), "publish" (every
+  // publishing worker), "load" (the storage loading thread) and "clock"
+  // (the /clock publisher). Roles without an entry keep the default
+  // scheduling.
+  std::unordered_map<std::string, ThreadAttributes> thread_attributes = {};
 };
 
 }  // namespace rosbag2_transport
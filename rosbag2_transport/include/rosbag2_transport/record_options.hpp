@@ -22,6 +22,8 @@
 
 #include "rclcpp/rclcpp.hpp"
 
+#include "rosbag2_transport/thread_attributes.hpp"
+
 namespace rosbag2_transport
 {
 struct RecordOptions
@@ -37,6 +39,52 @@ public:
   std::string compression_format = "";
   std::unordered_map<std::string, rclcpp::QoS> topic_qos_profile_overrides{};
   bool include_hidden_topics = false;
+  // Topics matching this regular expression are never subscribed, whether
+  // they were requested explicitly or found by discovery. Applied when the
+  // topic list is assembled, so an excluded topic's messages are never
+  // delivered to the recorder at all. Empty excludes nothing.
+  std::string topics_regex_to_exclude = "";
+  // Per-topic every-Nth sampling: a topic mapped to N only records every
+  // Nth received message (e.g. 60 keeps 1 Hz of a 60 Hz debug camera).
+  // Enforced in the subscription callback before the message is wrapped,
+  // so sampled-out messages cost neither an allocation nor staging-queue
+  // and disk bandwidth. Topics not listed, and values of 0 or 1, record
+  // every message.
+  std::unordered_map<std::string, uint64_t> topic_sampling{};
+  // Subscriptions which received no message for this long are torn down,
+  // shrinking the waitset and executor wakeup costs on systems with many
+  // registered-but-silent topics. The topic stays in the bag metadata, and
+  // the discovery path resubscribes as soon as a new publisher appears on
+  // it. Zero (the default) disables pruning.
+  std::chrono::milliseconds subscription_idle_timeout {0};
+  // Topics whose messages are only recorded when the payload changed,
+  // meant for transient_local topics like /tf_static where discovery
+  // re-subscribes and publisher restarts re-deliver identical snapshots.
+  // The payload is hashed in the subscription callback and messages whose
+  // hash equals the previously recorded one are dropped.
+  std::vector<std::string> topic_deduplication{};
+  // Topics staged into a dedicated priority lane which the writer-drain
+  // thread empties before every bulk write. A burst of large bulk messages
+  // (e.g. camera frames) then cannot queue up ahead of small
+  // latency-critical messages like diagnostics used for cross-system
+  // correlation: their write latency stays bounded by a single bulk write
+  // regardless of load. Meant for a handful of small, low-rate topics; the
+  // bulk lane keeps its FIFO order and an empty list keeps the single-lane
+  // behavior.
+  std::vector<std::string> priority_topics{};
+  // Path of a topic manifest (topics, types, serialized QoS offers) saved
+  // by a previous recording session. When the file exists, subscriptions
+  // are created from it immediately at start, before the first graph query,
+  // so a fixed-configuration system records its first message without
+  // paying full discovery; live discovery then reconciles against it. The
+  // manifest is rewritten from the actually subscribed topics when the
+  // recording stops. Empty (the default) disables the warm start.
+  std::string topic_manifest_file = "";
+  // CPU affinity and scheduling priority per recorder thread role, applied
+  // when the thread starts. Known roles: "drain" (the thread flushing the
+  // staging queue into the writer) and "discovery" (the topic discovery
+  // poller). Roles without an entry keep the default scheduling.
+  std::unordered_map<std::string, ThreadAttributes> thread_attributes{};
 };
 
 }  // namespace rosbag2_transport
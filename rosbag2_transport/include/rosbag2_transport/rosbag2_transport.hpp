@@ -82,9 +82,13 @@ public:
    * Print the bag info contained in the metadata yaml file.
    *
    * \param uri path to the metadata yaml file.
+   * \param verbose additionally print per-topic rate and bandwidth
+   * statistics, aggregated inside the storage plugin instead of reading
+   * every message.
    */
   ROSBAG2_TRANSPORT_PUBLIC
-  void print_bag_info(const std::string & uri, const std::string & storage_id);
+  void print_bag_info(
+    const std::string & uri, const std::string & storage_id, bool verbose = false);
 
   /**
    * Reconstruct the metadata yaml file from the stored data in the bag.
@@ -0,0 +1,53 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_TRANSPORT__THREAD_ATTRIBUTES_HPP_
+#define ROSBAG2_TRANSPORT__THREAD_ATTRIBUTES_HPP_
+
+#include <string>
+#include <vector>
+
+#include "rosbag2_transport/visibility_control.hpp"
+
+namespace rosbag2_transport
+{
+
+/**
+ * CPU affinity and scheduling priority of one recorder or player thread
+ * role. On a shared NUMA box an unpinned writer thread migrates across
+ * sockets and its flush latency doubles; pinning the dedicated threads and
+ * raising the playback scheduler to a real-time priority keeps their
+ * latency independent of the co-located load.
+ */
+struct ThreadAttributes
+{
+  // CPUs the thread may run on. Empty leaves the kernel's placement.
+  std::vector<int> cpu_affinity = {};
+
+  // SCHED_FIFO priority of the thread; 0 (the default) keeps the regular
+  // scheduling class. Raising it needs CAP_SYS_NICE or an rtprio limit.
+  int realtime_priority = 0;
+
+  /**
+   * Apply the attributes to the calling thread. Failures (unsupported
+   * platform, missing privileges) are logged as warnings and do not stop
+   * the thread; the role names the thread in those logs.
+   */
+  ROSBAG2_TRANSPORT_PUBLIC
+  void apply_to_current_thread(const std::string & role) const;
+};
+
+}  // namespace rosbag2_transport
+
+#endif  // ROSBAG2_TRANSPORT__THREAD_ATTRIBUTES_HPP_
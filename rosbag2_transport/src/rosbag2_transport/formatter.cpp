@@ -140,6 +140,13 @@ void Formatter::format_topics_with_type(
       info_stream << "Topic: " << ti.topic_metadata.name << " | ";
       info_stream << "Type: " << ti.topic_metadata.type << " | ";
       info_stream << "Count: " << ti.message_count << " | ";
+      if (ti.message_size_max > 0u) {
+        // Only bags recorded with metadata version 9 or newer carry the
+        // size distribution summary.
+        info_stream << "Size p50/p90/p99/max: " << ti.message_size_p50 << "/" <<
+          ti.message_size_p90 << "/" << ti.message_size_p99 << "/" <<
+          ti.message_size_max << " B | ";
+      }
       info_stream << "Serialization Format: " << ti.topic_metadata.serialization_format;
       info_stream << std::endl;
     };
@@ -152,6 +159,44 @@ void Formatter::format_topics_with_type(
   }
 }
 
+void Formatter::format_topic_statistics(
+  const std::vector<rosbag2_storage::TopicStatistics> & statistics)
+{
+  std::stringstream info_stream;
+  int indentation_spaces = 19;  // Matches the layout of format_bag_meta_data().
+
+  info_stream << "Topic statistics:  ";
+  if (statistics.empty()) {
+    info_stream << std::endl;
+    std::cout << info_stream.str();
+    return;
+  }
+
+  bool first_line = true;
+  for (const auto & topic_statistics : statistics) {
+    if (!first_line) {
+      indent(info_stream, indentation_spaces);
+    }
+    first_line = false;
+    info_stream << "Topic: " << topic_statistics.topic_name << " | ";
+    const auto span_ns =
+      topic_statistics.last_timestamp_ns - topic_statistics.first_timestamp_ns;
+    if (topic_statistics.message_count > 1 && span_ns > 0) {
+      const double span_s = static_cast<double>(span_ns) / 1e9;
+      info_stream << "Rate: " << std::setprecision(1) << std::fixed <<
+        static_cast<double>(topic_statistics.message_count - 1) / span_s << " Hz | ";
+      info_stream << "Bandwidth: " << format_file_size(
+        static_cast<uint64_t>(static_cast<double>(topic_statistics.byte_count) / span_s)) <<
+        "/s | ";
+    }
+    info_stream << "Count: " << topic_statistics.message_count << " | ";
+    info_stream << "Total size: " << format_file_size(topic_statistics.byte_count);
+    info_stream << std::endl;
+  }
+
+  std::cout << info_stream.str();
+}
+
 void Formatter::indent(std::stringstream & info_stream, int number_of_spaces)
 {
   info_stream << std::string(number_of_spaces, ' ');
@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "rosbag2_storage/bag_metadata.hpp"
+#include "rosbag2_storage/topic_statistics.hpp"
 
 namespace rosbag2_transport
 {
@@ -48,6 +49,11 @@ public:
     std::stringstream & info_stream,
     int indentation_spaces);
 
+  // Prints the per-topic average rate and bandwidth derived from the
+  // storage-aggregated statistics (the verbose part of the info output).
+  static void format_topic_statistics(
+    const std::vector<rosbag2_storage::TopicStatistics> & statistics);
+
 private:
   static void indent(std::stringstream & info_stream, int number_of_spaces);
 };
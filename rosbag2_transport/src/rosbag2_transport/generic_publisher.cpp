@@ -17,6 +17,10 @@
 #include <memory>
 #include <string>
 
+#include "rmw/rmw.h"
+
+#include "rosbag2_transport/logging.hpp"
+
 namespace
 {
 rcl_publisher_options_t rosbag2_get_publisher_options(const rclcpp::QoS & qos)
@@ -35,11 +39,17 @@ GenericPublisher::GenericPublisher(
   const rosidl_message_type_support_t & type_support,
   const std::string & topic_name,
   const rclcpp::QoS & qos)
-: rclcpp::PublisherBase(node_base, topic_name, type_support, rosbag2_get_publisher_options(qos))
+: rclcpp::PublisherBase(node_base, topic_name, type_support, rosbag2_get_publisher_options(qos)),
+  type_support_(type_support),
+  use_loaned_messages_(can_loan_messages())
 {}
 
 void GenericPublisher::publish(std::shared_ptr<rmw_serialized_message_t> message)
 {
+  if (use_loaned_messages_ && publish_loaned(*message)) {
+    return;
+  }
+
   auto return_code = rcl_publish_serialized_message(
     get_publisher_handle().get(), message.get(), NULL);
 
@@ -48,4 +58,36 @@ void GenericPublisher::publish(std::shared_ptr<rmw_serialized_message_t> message
   }
 }
 
+bool GenericPublisher::publish_loaned(const rmw_serialized_message_t & message)
+{
+  void * loaned_message = nullptr;
+  auto return_code = rcl_borrow_loaned_message(
+    get_publisher_handle().get(), &type_support_, &loaned_message);
+  if (return_code != RCL_RET_OK) {
+    // The middleware claimed loan support but cannot deliver; stop asking.
+    use_loaned_messages_ = false;
+    ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+      "Could not borrow a loaned message for topic '" << get_topic_name() <<
+        "'; falling back to serialized publishing.");
+    return false;
+  }
+
+  // Deserializing straight into the loaned buffer is the only copy the
+  // payload makes: the serialized publish path would deserialize into a
+  // middleware-internal buffer anyway, plus one memcpy to get there.
+  const auto deserialize_result = rmw_deserialize(&message, &type_support_, loaned_message);
+  if (deserialize_result != RMW_RET_OK) {
+    rcl_return_loaned_message_from_publisher(get_publisher_handle().get(), loaned_message);
+    rclcpp::exceptions::throw_from_rcl_error(
+      RCL_RET_ERROR, "failed to deserialize message into loaned buffer");
+  }
+
+  return_code = rcl_publish_loaned_message(get_publisher_handle().get(), loaned_message, NULL);
+  if (return_code != RCL_RET_OK) {
+    rcl_return_loaned_message_from_publisher(get_publisher_handle().get(), loaned_message);
+    rclcpp::exceptions::throw_from_rcl_error(return_code, "failed to publish loaned message");
+  }
+  return true;
+}
+
 }  // namespace rosbag2_transport
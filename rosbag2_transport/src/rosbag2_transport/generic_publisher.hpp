@@ -34,7 +34,29 @@ public:
 
   virtual ~GenericPublisher() = default;
 
+  /**
+   * Publish a serialized message.
+   *
+   * On transports that support message loaning the payload is deserialized
+   * straight into a borrowed middleware buffer and published zero-copy;
+   * otherwise it goes through the regular serialized publish path.
+   */
   void publish(std::shared_ptr<rmw_serialized_message_t> message);
+
+private:
+  // Deserialize into a loaned middleware buffer and publish it. Returns
+  // false when the loan could not be taken, in which case the caller falls
+  // back to the serialized path.
+  bool publish_loaned(const rmw_serialized_message_t & message);
+
+  // The type support the publisher was created with, needed to borrow and
+  // fill loaned messages. The node caches the typesupport library for its
+  // own lifetime, so the handle stays valid.
+  const rosidl_message_type_support_t & type_support_;
+
+  // Queried once from the middleware; cleared when loaning fails at
+  // runtime so the publisher does not retry a broken path per message.
+  bool use_loaned_messages_;
 };
 
 }  // namespace rosbag2_transport
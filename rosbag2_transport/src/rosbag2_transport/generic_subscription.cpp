@@ -14,16 +14,35 @@
 
 #include "generic_subscription.hpp"
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
+
+#include "rcl/error_handling.h"
+#include "rcl/subscription.h"
 
 #include "rclcpp/any_subscription_callback.hpp"
+#include "rclcpp/qos_event.hpp"
 #include "rclcpp/subscription.hpp"
 
 #include "rosbag2_transport/logging.hpp"
 
 namespace
 {
+// Buffers return to the pool only after every reference is gone, so the pool
+// must cover the messages in flight through the recorder's write cache, not
+// just the one the executor holds. Returns beyond the capacity free their
+// buffer instead of retaining it.
+constexpr const size_t MESSAGE_POOL_CAPACITY = 32;
+
+// Upper bound on the messages drained per executor wakeup. Bursts up to
+// this length (think lidar packet trains) pay the executor's waitset
+// rebuild once; anything longer yields the thread and is picked up by the
+// next wakeup, keeping other subscriptions on the executor serviced.
+constexpr const size_t MAX_MESSAGES_PER_WAKEUP = 64;
+
 rcl_subscription_options_t rosbag2_get_subscription_options(const rclcpp::QoS & qos)
 {
   auto options = rcl_subscription_get_default_options();
@@ -40,7 +59,8 @@ GenericSubscription::GenericSubscription(
   const rosidl_message_type_support_t & ts,
   const std::string & topic_name,
   const rclcpp::QoS & qos,
-  std::function<void(std::shared_ptr<rclcpp::SerializedMessage>)> callback)
+  std::function<void(std::shared_ptr<rclcpp::SerializedMessage>,
+  const rclcpp::MessageInfo &)> callback)
 : SubscriptionBase(
     node_base,
     ts,
@@ -50,7 +70,40 @@ GenericSubscription::GenericSubscription(
   default_allocator_(rcutils_get_default_allocator()),
   callback_(callback),
   qos_(qos)
-{}
+{
+  // The middleware reports drops it performed itself (history overflow,
+  // reliability gaps) only through these events. Counting them separates
+  // "the publisher never sent it" from "the recorder lost it" when auditing
+  // a bag for completeness. Not every rmw implementation supports them.
+  try {
+    this->add_event_handler(
+      [this](rclcpp::QOSMessageLostInfo & info) {
+        messages_lost_count_->fetch_add(
+          static_cast<uint64_t>(info.total_count_change), std::memory_order_relaxed);
+        ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+          "The middleware lost " << info.total_count_change <<
+            " messages on topic '" << get_topic_name() << "'.");
+      },
+      RCL_SUBSCRIPTION_MESSAGE_LOST);
+  } catch (const rclcpp::UnsupportedEventTypeException & /* unused */) {
+    ROSBAG2_TRANSPORT_LOG_DEBUG_STREAM(
+      "Message-lost events are not supported for topic '" << get_topic_name() << "'.");
+  }
+  try {
+    this->add_event_handler(
+      [this](rclcpp::QOSRequestedIncompatibleQoSInfo & info) {
+        incompatible_qos_count_->fetch_add(
+          static_cast<uint64_t>(info.total_count_change), std::memory_order_relaxed);
+        ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+          "A publisher on topic '" << get_topic_name() <<
+            "' offers a QoS profile incompatible with this subscription.");
+      },
+      RCL_SUBSCRIPTION_REQUESTED_INCOMPATIBLE_QOS);
+  } catch (const rclcpp::UnsupportedEventTypeException & /* unused */) {
+    ROSBAG2_TRANSPORT_LOG_DEBUG_STREAM(
+      "Incompatible-QoS events are not supported for topic '" << get_topic_name() << "'.");
+  }
+}
 
 std::shared_ptr<void> GenericSubscription::create_message()
 {
@@ -65,14 +118,53 @@ std::shared_ptr<rclcpp::SerializedMessage> GenericSubscription::create_serialize
 void GenericSubscription::handle_message(
   std::shared_ptr<void> & message, const rclcpp::MessageInfo & message_info)
 {
-  (void) message_info;
   auto typed_message = std::static_pointer_cast<rclcpp::SerializedMessage>(message);
-  callback_(typed_message);
+  size_t message_size = typed_message->size();
+  if (message_size > next_buffer_capacity_.load(std::memory_order_relaxed)) {
+    next_buffer_capacity_.store(message_size, std::memory_order_relaxed);
+  }
+  callback_(typed_message, message_info);
+  drain_queued_messages();
+}
+
+void GenericSubscription::drain_queued_messages()
+{
+  // One executor wakeup dispatches exactly one message; everything that
+  // queued up behind it would cost another waitset rebuild each. Taking
+  // those samples here amortizes the executor overhead across the burst.
+  // An empty take is the regular exit, not an error.
+  for (size_t taken = 0; taken < MAX_MESSAGES_PER_WAKEUP; ++taken) {
+    auto message = borrow_serialized_message(0);
+    rclcpp::MessageInfo message_info;
+    const rcl_ret_t ret = rcl_take_serialized_message(
+      get_subscription_handle().get(),
+      &message->get_rcl_serialized_message(),
+      &message_info.get_rmw_message_info(),
+      nullptr);
+    if (ret == RCL_RET_SUBSCRIPTION_TAKE_FAILED) {
+      break;  // Queue drained.
+    }
+    if (ret != RCL_RET_OK) {
+      ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+        "Failed to drain queued messages on topic '" << get_topic_name() <<
+          "': " << rcl_get_error_string().str);
+      rcl_reset_error();
+      break;
+    }
+    size_t message_size = message->size();
+    if (message_size > next_buffer_capacity_.load(std::memory_order_relaxed)) {
+      next_buffer_capacity_.store(message_size, std::memory_order_relaxed);
+    }
+    callback_(message, message_info);
+  }
 }
 
 void GenericSubscription::handle_loaned_message(
   void * message, const rclcpp::MessageInfo & message_info)
 {
+  // The rmw layer only loans deserialized, typed messages, never the raw
+  // serialized buffers this subscription takes, so there is nothing to do
+  // here. Buffer reuse is handled by the pool in borrow_serialized_message().
   (void) message;
   (void) message_info;
 }
@@ -86,6 +178,8 @@ void GenericSubscription::return_message(std::shared_ptr<void> & message)
 void GenericSubscription::return_serialized_message(
   std::shared_ptr<rclcpp::SerializedMessage> & message)
 {
+  // The pooling deleter recycles the buffer once the last reference is
+  // gone; the recorder may still hold one until the write cache drained.
   message.reset();
 }
 
@@ -97,7 +191,40 @@ const rclcpp::QoS & GenericSubscription::qos_profile() const
 std::shared_ptr<rclcpp::SerializedMessage>
 GenericSubscription::borrow_serialized_message(size_t capacity)
 {
-  return std::make_shared<rclcpp::SerializedMessage>(capacity);
+  std::unique_ptr<rclcpp::SerializedMessage> message;
+  {
+    std::lock_guard<std::mutex> lock(message_pool_->mutex);
+    if (!message_pool_->messages.empty()) {
+      message = std::move(message_pool_->messages.back());
+      message_pool_->messages.pop_back();
+    }
+  }
+  if (message) {
+    message->get_rcl_serialized_message().buffer_length = 0;
+  } else {
+    // Size fresh buffers for the largest payload seen so far, so the rmw
+    // layer does not have to grow them incrementally while taking the
+    // message.
+    size_t initial_capacity =
+      std::max(capacity, next_buffer_capacity_.load(std::memory_order_relaxed));
+    message = std::make_unique<rclcpp::SerializedMessage>(initial_capacity);
+  }
+  // The deleter fires when the last reference is gone - possibly on the
+  // cache writer thread, long after the executor returned the message - and
+  // hands the buffer back for the next take.
+  std::weak_ptr<MessagePool> weak_pool = message_pool_;
+  return std::shared_ptr<rclcpp::SerializedMessage>(
+    message.release(),
+    [weak_pool](rclcpp::SerializedMessage * msg) {
+      if (auto pool = weak_pool.lock()) {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        if (pool->messages.size() < MESSAGE_POOL_CAPACITY) {
+          pool->messages.emplace_back(msg);
+          return;
+        }
+      }
+      delete msg;
+    });
 }
 
 }  // namespace rosbag2_transport
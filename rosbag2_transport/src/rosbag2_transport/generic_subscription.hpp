@@ -15,8 +15,11 @@
 #ifndef ROSBAG2_TRANSPORT__GENERIC_SUBSCRIPTION_HPP_
 #define ROSBAG2_TRANSPORT__GENERIC_SUBSCRIPTION_HPP_
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "rclcpp/any_subscription_callback.hpp"
 #include "rclcpp/macros.hpp"
@@ -45,20 +48,25 @@ public:
    * \param node_base NodeBaseInterface pointer used in parts of the setup.
    * \param ts Type support handle
    * \param topic_name Topic name
-   * \param callback Callback for new messages of serialized form
+   * \param callback Callback for new messages of serialized form, also handed the
+   *   rmw message info so e.g. the reception timestamp is available
    */
   GenericSubscription(
     rclcpp::node_interfaces::NodeBaseInterface * node_base,
     const rosidl_message_type_support_t & ts,
     const std::string & topic_name,
     const rclcpp::QoS & qos,
-    std::function<void(std::shared_ptr<rclcpp::SerializedMessage>)> callback);
+    std::function<void(std::shared_ptr<rclcpp::SerializedMessage>,
+    const rclcpp::MessageInfo &)> callback);
 
   // Same as create_serialized_message() as the subscription is to serialized_messages only
   std::shared_ptr<void> create_message() override;
 
   std::shared_ptr<rclcpp::SerializedMessage> create_serialized_message() override;
 
+  // Dispatches the message taken by the executor, then drains the samples
+  // still queued on the subscription in the same wakeup, so a burst pays
+  // the executor's waitset rebuild and dispatch overhead only once.
   void handle_message(
     std::shared_ptr<void> & message, const rclcpp::MessageInfo & message_info) override;
 
@@ -73,13 +81,57 @@ public:
   // Provide a const reference to the QoS Profile used to create this subscription.
   const rclcpp::QoS & qos_profile() const;
 
+  // Messages the middleware reported lost on this subscription. Shared so
+  // the count stays readable after the subscription was replaced.
+  std::shared_ptr<const std::atomic<uint64_t>> messages_lost_count() const
+  {
+    return messages_lost_count_;
+  }
+
+  // Incompatible-QoS events the middleware reported for this subscription.
+  std::shared_ptr<const std::atomic<uint64_t>> incompatible_qos_count() const
+  {
+    return incompatible_qos_count_;
+  }
+
 private:
   // cppcheck-suppress unknownMacro
   RCLCPP_DISABLE_COPY(GenericSubscription)
 
   std::shared_ptr<rclcpp::SerializedMessage> borrow_serialized_message(size_t capacity);
+
+  // Takes the samples queued behind the executor-delivered message straight
+  // from the rcl layer and feeds them to the callback, bounded per wakeup
+  // so one bursty topic cannot monopolize an executor thread.
+  void drain_queued_messages();
+
+  // Intake buffers recycled between takes. Borrowed messages carry a deleter
+  // which hands the buffer back here once the last reference is gone - which
+  // may be long after the executor returned the message, when the write
+  // cache drained a bag message aliasing the buffer. The pool is shared with
+  // those deleters through a weak_ptr, so messages still in flight when the
+  // subscription dies do not touch a destroyed pool.
+  struct MessagePool
+  {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<rclcpp::SerializedMessage>> messages;
+  };
+  std::shared_ptr<MessagePool> message_pool_ = std::make_shared<MessagePool>();
+
+  // Largest payload seen on this topic so far. Fresh buffers are allocated
+  // with this capacity up front, so the rmw layer does not have to grow
+  // them incrementally while taking a message.
+  std::atomic<size_t> next_buffer_capacity_{0u};
+
+  // Counters behind the accessors above, updated by the rmw event callbacks.
+  std::shared_ptr<std::atomic<uint64_t>> messages_lost_count_ =
+    std::make_shared<std::atomic<uint64_t>>(0);
+  std::shared_ptr<std::atomic<uint64_t>> incompatible_qos_count_ =
+    std::make_shared<std::atomic<uint64_t>>(0);
+
   rcutils_allocator_t default_allocator_;
-  std::function<void(std::shared_ptr<rclcpp::SerializedMessage>)> callback_;
+  std::function<void(std::shared_ptr<rclcpp::SerializedMessage>,
+    const rclcpp::MessageInfo &)> callback_;
   const rclcpp::QoS qos_;
 };
 
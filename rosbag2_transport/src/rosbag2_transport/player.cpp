@@ -14,9 +14,13 @@
 
 #include "player.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <functional>
 #include <memory>
 #include <queue>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -32,6 +36,7 @@
 #include "rosbag2_cpp/typesupport_helpers.hpp"
 
 #include "rosbag2_storage/storage_filter.hpp"
+#include "rosbag2_storage/tracepoints.hpp"
 
 #include "rosbag2_transport/logging.hpp"
 
@@ -41,6 +46,34 @@
 
 namespace
 {
+// Final stretch of each publishing wait that is busy-spun instead of slept:
+// the kernel may overshoot a sleep by tens to hundreds of microseconds, so
+// sleeping is stopped this far ahead of the deadline and the remainder is
+// spun against the absolute deadline.
+constexpr const std::chrono::microseconds kSpinWindow{150};
+
+// Messages whose publishing instants fall within this window of the current
+// one are published as one batch, without returning to sleep in between.
+constexpr const std::chrono::microseconds kBatchWindow{50};
+
+// While the publishing deadline is further away than this, the playback
+// thread waits in interruptible slices so pause and seek requests take
+// effect immediately instead of after the current sleep.
+constexpr const std::chrono::milliseconds kControlWaitSlice{100};
+
+// Size of the publishing worker pool the topics are sharded across.
+constexpr const size_t kPublishingWorkerCount = 4;
+
+// Slots in each worker's preallocated message ring; dispatching to a worker
+// this far behind blocks the pacing thread rather than buffering without
+// limit.
+constexpr const size_t kWorkerQueueCapacity = 256;
+
+// Batch size of one storage read while refilling against a byte budget. The
+// size of a message is only known after it was read, so the refill reads
+// batches of this many messages and re-checks the budget in between.
+constexpr const size_t kByteBudgetRefillBatchSize = 64;
+
 /**
  * Determine which QoS to offer for a topic.
  * The priority of the profile selected is:
@@ -64,10 +97,31 @@ rclcpp::QoS publisher_qos_for_topic(
     return Rosbag2QoS{};
   }
 
-  const auto profiles_yaml = YAML::Load(topic.offered_qos_profiles);
-  const auto offered_qos_profiles = profiles_yaml.as<std::vector<Rosbag2QoS>>();
+  // Decodes the compact encoding without yaml-cpp on the way; recorded YAML
+  // from older bags falls back to the parser inside.
+  const auto offered_qos_profiles =
+    rosbag2_transport::deserialize_qos_profiles(topic.offered_qos_profiles);
   return Rosbag2QoS::adapt_offer_to_recorded_offers(topic.name, offered_qos_profiles);
 }
+
+/**
+ * Upper bound, in microseconds, of the timing histogram bucket containing the
+ * given percentile: 2^i for bucket i. Percentile assertions read "the p99
+ * publish error was at most this much".
+ */
+uint64_t timing_percentile_us(
+  const uint64_t * buckets, size_t bucket_count, uint64_t sample_count, double percentile)
+{
+  const auto rank = static_cast<uint64_t>(percentile * static_cast<double>(sample_count) + 0.5);
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < bucket_count; ++i) {
+    cumulative += buckets[i];
+    if (cumulative >= rank) {
+      return 1ull << i;
+    }
+  }
+  return 1ull << (bucket_count - 1);
+}
 }  // namespace
 
 namespace rosbag2_transport
@@ -95,64 +149,831 @@ void Player::play(const PlayOptions & options)
 {
   topic_qos_profile_overrides_ = options.topic_qos_profile_overrides;
   prepare_publishers(options);
+  setup_control_services();
+
+  // Spin the node on a background thread so the control services stay
+  // responsive while this thread paces the playback.
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(rosbag2_transport_);
+  std::thread spin_thread([&executor]() {executor.spin();});
+
+  loop_cache_size_limit_ = options.loop_cache_size;
+  loop_cache_enabled_ = options.loop && options.loop_cache_size > 0;
+
+  read_ahead_byte_budget_ = options.read_ahead_byte_budget;
+  read_ahead_queue_size_ = options.read_ahead_queue_size;
+  queued_bytes_ = 0;
+
+  // Starting rate; the set_rate service can change it mid-replay.
+  playback_rate_ = options.rate > 0.0 ? options.rate : 1.0;
+  requested_rate_ = 0.0;
+
+  // Preallocate the read-ahead ring to its bound, so steady-state enqueues
+  // never grow the queue. With a byte budget the message count is unknown
+  // up front; the queue then grows once to its high-water mark during the
+  // first fill and stays allocation-free afterwards, since it never shrinks.
+  message_queue_ = moodycamel::ReaderWriterQueue<ReplayableMessage>(
+    options.read_ahead_queue_size + 1);
+
+  as_fast_as_possible_ = options.as_fast_as_possible;
+  reverse_playback_ = options.reverse;
+  if (reverse_playback_) {
+    // Messages then arrive in descending timestamp order; throws before any
+    // loading starts when the reader cannot serve a reversed cursor.
+    reader_->set_read_order(rosbag2_storage::ReadOrder::REVERSE);
+  }
+  played_message_count_ = 0;
+  played_byte_count_ = 0;
+  played_messages_per_topic_.clear();
+  playback_wall_start_ = std::chrono::steady_clock::now();
+
+  // The pacing runs on this thread, so its attributes (typically a
+  // SCHED_FIFO priority, to keep the deadline math off the mercy of
+  // co-located load) apply right here; the worker threads apply theirs
+  // when they start.
+  thread_attributes_ = options.thread_attributes;
+  apply_thread_attributes("playback");
+
+  topic_sampling_ = options.topic_sampling;
+  topic_min_intervals_ns_.clear();
+  for (const auto & entry : options.topic_max_frequencies) {
+    if (entry.second > 0.0) {
+      topic_min_intervals_ns_[entry.first] =
+        static_cast<rcutils_time_point_value_t>(1e9 / entry.second);
+    }
+  }
+  sampling_counters_.clear();
+  last_kept_time_per_topic_.clear();
+  decimation_enabled_ = !topic_sampling_.empty() || !topic_min_intervals_ns_.empty();
+
+  lateness_budget_ns_ = options.lateness_budget;
+  topic_lateness_budgets_ = options.topic_lateness_budgets;
+  skipped_late_message_count_ = 0;
+  skipped_late_messages_per_topic_.clear();
+
+  {
+    std::lock_guard<std::mutex> lock(timing_mutex_);
+    timing_error_histogram_.fill(0);
+    timing_sample_count_ = 0;
+    timing_error_max_ns_ = 0;
+    early_published_count_ = 0;
+    queue_starvation_count_ = 0;
+  }
+  if (!statistics_publisher_) {
+    statistics_publisher_ = rosbag2_transport_->create_publisher<std_msgs::msg::String>(
+      "/rosbag2_player/statistics", 10);
+    statistics_timer_ = rosbag2_transport_->create_wall_timer(
+      std::chrono::seconds(1), [this]() {publish_timing_statistics();});
+  }
+
+  start_publishing_workers();
+  start_clock_publishing(options);
+
+  bool play_from_storage = true;
+  do {
+    if (play_from_storage) {
+      storage_loading_future_ = std::async(
+        std::launch::async,
+        [this, options]() {load_storage_content(options);});
+
+      wait_for_filled_queue();
+
+      play_messages_from_queue(options);
+    } else {
+      replay_loop_cache();
+    }
+
+    if (!options.loop || !rclcpp::ok()) {
+      break;
+    }
+
+    if (loop_cache_enabled_) {
+      // The whole bag fit into the cache; later loops replay from memory.
+      play_from_storage = false;
+    } else {
+      // Rewind via a storage-level seek instead of re-opening and
+      // re-reading the bag from scratch.
+      try {
+        reader_->seek(first_message_time_ns_);
+      } catch (const std::exception & e) {
+        ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+          "Cannot rewind for loop playback, re-opening the bag instead: " << e.what());
+        break;  // The caller re-opens the reader and plays again.
+      }
+    }
+  } while (rclcpp::ok());
+
+  stop_clock_publishing();
+  stop_publishing_workers();
+  executor.cancel();
+  spin_thread.join();
+
+  if (as_fast_as_possible_) {
+    print_playback_statistics();
+  }
+  print_keep_up_report();
+  print_timing_report();
+}
+
+void Player::note_played_message(const ReplayableMessage & message)
+{
+  ++played_message_count_;
+  played_byte_count_ += message.message->serialized_data->buffer_length;
+  const auto topic_id = message.message->topic_id;
+  if (topic_id != 0u) {
+    if (played_count_by_topic_id_.size() <= topic_id) {
+      played_count_by_topic_id_.resize(topic_id + 1, 0u);
+      played_topic_names_by_id_.resize(topic_id + 1);
+    }
+    if (played_count_by_topic_id_[topic_id] == 0u) {
+      // Resolve the name once; later messages of the topic only bump the
+      // id-indexed counter.
+      played_topic_names_by_id_[topic_id] = message.message->topic_name;
+    }
+    ++played_count_by_topic_id_[topic_id];
+  } else {
+    ++played_messages_per_topic_[message.message->topic_name];
+  }
+  note_timing_error(message);
+}
+
+void Player::note_timing_error(const ReplayableMessage & message)
+{
+  if (as_fast_as_possible_) {
+    return;
+  }
+  const int64_t error_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now() - publishing_instant(message)).count();
+  const auto magnitude_us = static_cast<uint64_t>(error_ns < 0 ? -error_ns : error_ns) / 1000u;
+  size_t bucket = 0;
+  uint64_t upper_bound_us = 1;
+  while (magnitude_us >= upper_bound_us && bucket + 1 < timing_error_histogram_.size()) {
+    ++bucket;
+    upper_bound_us <<= 1;
+  }
+
+  std::lock_guard<std::mutex> lock(timing_mutex_);
+  ++timing_sample_count_;
+  ++timing_error_histogram_[bucket];
+  if (error_ns < 0) {
+    // Published ahead of its instant, at most by the batch window.
+    ++early_published_count_;
+  } else if (error_ns > timing_error_max_ns_) {
+    timing_error_max_ns_ = error_ns;
+  }
+}
+
+void Player::publish_timing_statistics()
+{
+  std::array<uint64_t, kTimingHistogramBucketCount> histogram;
+  uint64_t samples;
+  int64_t max_ns;
+  uint64_t early;
+  uint64_t starvations;
+  {
+    std::lock_guard<std::mutex> lock(timing_mutex_);
+    histogram = timing_error_histogram_;
+    samples = timing_sample_count_;
+    max_ns = timing_error_max_ns_;
+    early = early_published_count_;
+    starvations = queue_starvation_count_;
+  }
+
+  YAML::Node statistics;
+  YAML::Node timing;
+  timing["samples"] = samples;
+  if (samples > 0u) {
+    timing["p50_us"] = timing_percentile_us(histogram.data(), histogram.size(), samples, 0.5);
+    timing["p90_us"] = timing_percentile_us(histogram.data(), histogram.size(), samples, 0.9);
+    timing["p99_us"] = timing_percentile_us(histogram.data(), histogram.size(), samples, 0.99);
+    timing["max_us"] = static_cast<uint64_t>(max_ns) / 1000u;
+    timing["early"] = early;
+  }
+  statistics["publish_timing_error"] = timing;
+  statistics["queue_starvations"] = starvations;
+
+  std_msgs::msg::String message;
+  message.data = YAML::Dump(statistics);
+  statistics_publisher_->publish(message);
+}
+
+void Player::print_timing_report() const
+{
+  std::lock_guard<std::mutex> lock(timing_mutex_);
+  if (timing_sample_count_ == 0u) {
+    return;
+  }
+  std::ostringstream report;
+  report << "Replay timing: " << timing_sample_count_ <<
+    " paced message(s), publish error p50 <= " <<
+    timing_percentile_us(
+    timing_error_histogram_.data(), timing_error_histogram_.size(), timing_sample_count_, 0.5) <<
+    " us, p90 <= " <<
+    timing_percentile_us(
+    timing_error_histogram_.data(), timing_error_histogram_.size(), timing_sample_count_, 0.9) <<
+    " us, p99 <= " <<
+    timing_percentile_us(
+    timing_error_histogram_.data(), timing_error_histogram_.size(), timing_sample_count_, 0.99) <<
+    " us, max " << static_cast<uint64_t>(timing_error_max_ns_) / 1000u << " us";
+  if (early_published_count_ > 0u) {
+    report << "; " << early_published_count_ <<
+      " message(s) published early within the batch window";
+  }
+  if (queue_starvation_count_ > 0u) {
+    report << "; the read-ahead queue starved " << queue_starvation_count_ << " time(s)";
+  }
+  ROSBAG2_TRANSPORT_LOG_INFO_STREAM(report.str());
+}
+
+void Player::apply_thread_attributes(const std::string & role) const
+{
+  const auto attributes = thread_attributes_.find(role);
+  if (attributes != thread_attributes_.end()) {
+    attributes->second.apply_to_current_thread(role);
+  }
+}
+
+bool Player::should_skip_late_message(const ReplayableMessage & message)
+{
+  if (lateness_budget_ns_ < 0 || as_fast_as_possible_) {
+    return false;
+  }
+  rcutils_time_point_value_t budget_ns = lateness_budget_ns_;
+  const auto budget_override = topic_lateness_budgets_.find(message.message->topic_name);
+  if (budget_override != topic_lateness_budgets_.end()) {
+    budget_ns = budget_override->second;
+  }
+  if (budget_ns < 0) {
+    return false;  // The topic is exempt from skipping.
+  }
+  // Time spent paused shifts start_time_, so lateness only measures how far
+  // publishing genuinely fell behind the replay timeline.
+  const auto lateness = std::chrono::system_clock::now() - publishing_instant(message);
+  if (lateness <= std::chrono::nanoseconds(budget_ns)) {
+    return false;
+  }
+  ++skipped_late_message_count_;
+  ++skipped_late_messages_per_topic_[message.message->topic_name];
+  return true;
+}
+
+void Player::print_keep_up_report() const
+{
+  if (skipped_late_message_count_ == 0u) {
+    return;
+  }
+  std::ostringstream report;
+  report << "Keep-up mode skipped " << skipped_late_message_count_ <<
+    " message(s) that missed their deadline by more than the lateness budget:";
+  for (const auto & topic_count : skipped_late_messages_per_topic_) {
+    report << "\n  " << topic_count.first << ": " << topic_count.second << " messages";
+  }
+  ROSBAG2_TRANSPORT_LOG_WARN_STREAM(report.str());
+}
+
+void Player::print_playback_statistics() const
+{
+  const double elapsed = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - playback_wall_start_).count();
+  std::ostringstream report;
+  report << "Played " << played_message_count_ << " messages (" <<
+    played_byte_count_ / (1024.0 * 1024.0) << " MB) in " << elapsed << " s";
+  if (elapsed > 0.0) {
+    report << ": " << played_message_count_ / elapsed << " messages/s, " <<
+      played_byte_count_ / (1024.0 * 1024.0) / elapsed << " MB/s";
+  }
+  for (size_t topic_id = 0; topic_id < played_count_by_topic_id_.size(); ++topic_id) {
+    if (played_count_by_topic_id_[topic_id] > 0u) {
+      report << "\n  " << played_topic_names_by_id_[topic_id] << ": " <<
+        played_count_by_topic_id_[topic_id] << " messages";
+    }
+  }
+  for (const auto & topic_count : played_messages_per_topic_) {
+    report << "\n  " << topic_count.first << ": " << topic_count.second << " messages";
+  }
+  ROSBAG2_TRANSPORT_LOG_INFO_STREAM(report.str());
+}
+
+void Player::start_clock_publishing(const PlayOptions & options)
+{
+  if (options.clock_publish_frequency <= 0.0) {
+    return;
+  }
+  if (!clock_publisher_) {
+    clock_publisher_ = rosbag2_transport_->create_publisher<rosgraph_msgs::msg::Clock>(
+      "/clock", rclcpp::ClockQoS());
+  }
+  {
+    std::lock_guard<std::mutex> lock(clock_mutex_);
+    stop_clock_ = false;
+  }
+  clock_thread_ = std::thread(
+    &Player::clock_publisher_loop, this, options.clock_publish_frequency);
+}
+
+void Player::stop_clock_publishing()
+{
+  {
+    std::lock_guard<std::mutex> lock(clock_mutex_);
+    stop_clock_ = true;
+  }
+  clock_condition_.notify_all();
+  if (clock_thread_.joinable()) {
+    clock_thread_.join();
+  }
+}
+
+void Player::clock_publisher_loop(double frequency)
+{
+  apply_thread_attributes("clock");
+  const auto period = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::duration<double>(1.0 / frequency));
+  rosgraph_msgs::msg::Clock clock_message;
+  bool have_clock_value = false;
+  std::unique_lock<std::mutex> lock(clock_mutex_);
+  while (rclcpp::ok()) {
+    if (clock_condition_.wait_for(lock, period, [this] {return stop_clock_;})) {
+      break;
+    }
+    // Nothing to publish before the loader has seen the first message.
+    if (first_message_time_ns_ == 0) {
+      continue;
+    }
+    if (!paused_) {
+      // Same mapping the message scheduler uses: recording time of the first
+      // message plus the scaled wall time elapsed since playback started.
+      // While paused the last value is republished, so sim time stands still
+      // until the clock is rebased on resume.
+      std::chrono::system_clock::time_point start_time;
+      double rate = 1.0;
+      {
+        // The rate and the clock anchor change as a pair on a live rate
+        // change, so they are read together.
+        std::lock_guard<std::mutex> control_lock(control_mutex_);
+        start_time = start_time_;
+        rate = playback_rate_;
+      }
+      // The playback clock is only meaningful once the playback thread
+      // anchored it; before that the member still holds the epoch.
+      if (start_time == std::chrono::system_clock::time_point()) {
+        continue;
+      }
+      const auto elapsed = std::chrono::duration<double, std::nano>(
+        std::chrono::system_clock::now() - start_time) * rate;
+      // In reverse playback the bag time runs backwards from the latest
+      // message.
+      const int64_t bag_time_ns = reverse_playback_ ?
+        first_message_time_ns_ - static_cast<int64_t>(elapsed.count()) :
+        first_message_time_ns_ + static_cast<int64_t>(elapsed.count());
+      clock_message.clock.sec = static_cast<int32_t>(bag_time_ns / 1000000000LL);
+      clock_message.clock.nanosec = static_cast<uint32_t>(bag_time_ns % 1000000000LL);
+      have_clock_value = true;
+    }
+    if (have_clock_value) {
+      clock_publisher_->publish(clock_message);
+    }
+  }
+}
+
+void Player::start_publishing_workers()
+{
+  if (!publishing_workers_.empty()) {
+    return;
+  }
+  for (size_t i = 0; i < kPublishingWorkerCount; ++i) {
+    auto worker = std::make_unique<PublishingWorker>();
+    worker->slots.resize(kWorkerQueueCapacity);
+    publishing_workers_.push_back(std::move(worker));
+  }
+  for (size_t i = 0; i < publishing_workers_.size(); ++i) {
+    publishing_workers_[i]->thread =
+      std::thread(&Player::publishing_worker_loop, this, i);
+  }
+}
+
+void Player::stop_publishing_workers()
+{
+  for (auto & worker : publishing_workers_) {
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      worker->stop = true;
+    }
+    worker->condition.notify_all();
+    worker->drained_condition.notify_all();
+  }
+  for (auto & worker : publishing_workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+  publishing_workers_.clear();
+}
+
+void Player::publishing_worker_loop(size_t worker_index)
+{
+  apply_thread_attributes("publish");
+  auto & worker = *publishing_workers_[worker_index];
+  while (true) {
+    ReplayableMessage message;
+    {
+      std::unique_lock<std::mutex> lock(worker.mutex);
+      worker.condition.wait(lock, [&worker] {return worker.stop || worker.size != 0;});
+      if (worker.size == 0) {
+        break;  // Stop was requested and all pending messages are published.
+      }
+      // Moving out of the slot recycles it: the moved-from shared_ptr is
+      // null, so the drained slot holds no payload reference.
+      message = std::move(worker.slots[worker.head]);
+      worker.head = (worker.head + 1) % worker.slots.size();
+      --worker.size;
+    }
+    worker.drained_condition.notify_all();
+    ROSBAG2_TRACEPOINT1(player_publish, message.message->time_stamp);
+    // Resolve the publisher through the worker's id-indexed table; the
+    // by-name map is only consulted once per topic (or per message for
+    // messages without an interned id).
+    std::shared_ptr<GenericPublisher> publisher;
+    const auto topic_id = message.message->topic_id;
+    if (topic_id != 0u) {
+      if (worker.publisher_by_topic_id.size() <= topic_id) {
+        worker.publisher_by_topic_id.resize(topic_id + 1);
+      }
+      publisher = worker.publisher_by_topic_id[topic_id];
+      if (!publisher) {
+        publisher = publishers_.at(message.message->topic_name);
+        worker.publisher_by_topic_id[topic_id] = publisher;
+      }
+    } else {
+      publisher = publishers_.at(message.message->topic_name);
+    }
+    publisher->publish(message.message->serialized_data);
+  }
+}
+
+void Player::dispatch_to_worker(const ReplayableMessage & message)
+{
+  // Shard by the interned topic id when the message carries one, falling
+  // back to hashing the name. Either key is stable per topic, so the
+  // per-topic publish order is preserved.
+  const size_t worker_index = message.message->topic_id != 0u ?
+    message.message->topic_id % publishing_workers_.size() :
+    std::hash<std::string>{}(message.message->topic_name) % publishing_workers_.size();
+  auto & worker = *publishing_workers_[worker_index];
+  {
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    worker.drained_condition.wait(
+      lock, [&worker] {return worker.size < worker.slots.size() || worker.stop;});
+    worker.slots[(worker.head + worker.size) % worker.slots.size()] = message;
+    ++worker.size;
+  }
+  worker.condition.notify_one();
+}
+
+void Player::flush_worker_queues()
+{
+  for (auto & worker : publishing_workers_) {
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      // Drop the payload references of the still-filled slots; the slots
+      // themselves stay allocated for reuse.
+      for (size_t i = 0; i < worker->size; ++i) {
+        worker->slots[(worker->head + i) % worker->slots.size()].message.reset();
+      }
+      worker->head = 0;
+      worker->size = 0;
+    }
+    worker->drained_condition.notify_all();
+  }
+}
+
+void Player::setup_control_services()
+{
+  if (pause_service_) {
+    return;  // Looped playback reuses the services of the first round.
+  }
+
+  pause_service_ = rosbag2_transport_->create_service<std_srvs::srv::Trigger>(
+    "/rosbag2_player/pause",
+    [this](
+      const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+      std::shared_ptr<std_srvs::srv::Trigger::Response> response) {
+      (void) request;
+      paused_ = true;
+      control_condition_.notify_all();
+      response->success = true;
+    });
+
+  step_service_ = rosbag2_transport_->create_service<std_srvs::srv::Trigger>(
+    "/rosbag2_player/step",
+    [this](
+      const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+      std::shared_ptr<std_srvs::srv::Trigger::Response> response) {
+      (void) request;
+      // Releases exactly one message in the current read order, so with a
+      // reversed playback every step walks one message backwards.
+      if (!paused_) {
+        response->success = false;
+        response->message = "Stepping requires paused playback.";
+        return;
+      }
+      step_requested_ = true;
+      control_condition_.notify_all();
+      response->success = true;
+    });
 
-  storage_loading_future_ = std::async(
-    std::launch::async,
-    [this, options]() {load_storage_content(options);});
+  resume_service_ = rosbag2_transport_->create_service<std_srvs::srv::Trigger>(
+    "/rosbag2_player/resume",
+    [this](
+      const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+      std::shared_ptr<std_srvs::srv::Trigger::Response> response) {
+      (void) request;
+      paused_ = false;
+      control_condition_.notify_all();
+      response->success = true;
+    });
 
-  wait_for_filled_queue(options);
+  seek_service_ = rosbag2_transport_->create_service<rosbag2_interfaces::srv::Seek>(
+    "/rosbag2_player/seek",
+    [this](
+      const std::shared_ptr<rosbag2_interfaces::srv::Seek::Request> request,
+      std::shared_ptr<rosbag2_interfaces::srv::Seek::Response> response) {
+      seek_to_time_ns_ = static_cast<int64_t>(request->time.sec) * 1000000000LL +
+      request->time.nanosec;
+      seek_requested_ = true;
+      control_condition_.notify_all();
+      queue_state_condition_.notify_all();
+      response->success = true;
+    });
 
-  play_messages_from_queue(options);
+  set_rate_service_ = rosbag2_transport_->create_service<rosbag2_interfaces::srv::SetRate>(
+    "/rosbag2_player/set_rate",
+    [this](
+      const std::shared_ptr<rosbag2_interfaces::srv::SetRate::Request> request,
+      std::shared_ptr<rosbag2_interfaces::srv::SetRate::Response> response) {
+      if (!(request->rate > 0.0) || !std::isfinite(request->rate)) {
+        response->success = false;
+        return;
+      }
+      // Picked up by the playback thread at its next control point, which
+      // re-bases the clock around the current position; see
+      // apply_pending_rate_change().
+      requested_rate_ = request->rate;
+      control_condition_.notify_all();
+      response->success = true;
+    });
 }
 
-void Player::wait_for_filled_queue(const PlayOptions & options) const
+bool Player::read_ahead_queue_is_filled() const
 {
+  if (read_ahead_byte_budget_ > 0) {
+    return queued_bytes_.load() >= read_ahead_byte_budget_;
+  }
+  return message_queue_.size_approx() >= read_ahead_queue_size_;
+}
+
+void Player::wait_for_filled_queue() const
+{
+  std::unique_lock<std::mutex> lock(queue_state_mutex_);
   while (
-    message_queue_.size_approx() < options.read_ahead_queue_size &&
-    !is_storage_completely_loaded() && rclcpp::ok())
+    !read_ahead_queue_is_filled() &&
+    !is_storage_completely_loaded() && rclcpp::ok() && !seek_requested_)
   {
-    std::this_thread::sleep_for(queue_read_wait_period_);
+    // The loader signals every enqueued batch, so playback starts the moment
+    // the read-ahead target is met. The timeout only guards against a signal
+    // racing the fill-level check above.
+    queue_state_condition_.wait_for(lock, queue_read_wait_period_);
   }
 }
 
 void Player::load_storage_content(const PlayOptions & options)
 {
+  apply_thread_attributes("load");
   TimePoint time_first_message;
 
   ReplayableMessage message;
-  if (reader_->has_next()) {
-    message.message = reader_->read_next();
+  while (reader_->has_next()) {
+    auto bag_message = reader_->read_next();
+    // The first message per topic always survives decimation, so this loop
+    // normally runs once; it only advances when a counter survived a
+    // previous playback of the same player instance.
+    if (decimation_enabled_ && decimation_drops(*bag_message)) {
+      continue;
+    }
+    message.message = bag_message;
     message.time_since_start = std::chrono::nanoseconds(0);
     time_first_message = TimePoint(std::chrono::nanoseconds(message.message->time_stamp));
+    first_message_time_ns_ = message.message->time_stamp;
+    queued_bytes_ += message.message->serialized_data->buffer_length;
     message_queue_.enqueue(message);
+    break;
   }
 
   auto queue_lower_boundary =
     static_cast<size_t>(options.read_ahead_queue_size * read_ahead_lower_bound_percentage_);
   auto queue_upper_boundary = options.read_ahead_queue_size;
+  // With a byte budget the low-water mark is in bytes instead of messages.
+  // At least one byte, so an empty queue always triggers a refill even for
+  // budgets smaller than a single message.
+  const auto byte_lower_boundary = std::max<uint64_t>(
+    1u, static_cast<uint64_t>(read_ahead_byte_budget_ * read_ahead_lower_bound_percentage_));
+
+  // Adaptive low-water mark: a fixed fraction refills too eagerly on fast
+  // storage and too late on slow compressed storage. The loader instead
+  // measures how fast playback drains the queue and how long refills take,
+  // and keeps enough queued to cover a pessimistic refill. Cantelli's
+  // inequality bounds P(refill time > mean + k * deviation) by 1 / (1 + k^2)
+  // for any distribution, so k deviations of margin enforce the configured
+  // starvation probability without assuming refill times are Gaussian.
+  const auto starvation_probability = options.read_ahead_starvation_probability;
+  const bool adaptive_refill = starvation_probability > 0.0 && starvation_probability < 1.0;
+  const double deviation_margin = adaptive_refill ?
+    std::sqrt(1.0 / starvation_probability - 1.0) : 0.0;
+  // The unit of the fill level: bytes with a byte budget, messages without.
+  const auto queued_units = [this]() {
+      return read_ahead_byte_budget_ > 0 ?
+             static_cast<double>(queued_bytes_.load()) :
+             static_cast<double>(message_queue_.size_approx());
+    };
+  const double upper_boundary_units = static_cast<double>(
+    read_ahead_byte_budget_ > 0 ? read_ahead_byte_budget_ : queue_upper_boundary);
+  double adaptive_lower_boundary = static_cast<double>(
+    read_ahead_byte_budget_ > 0 ? byte_lower_boundary : queue_lower_boundary);
+  // TCP-RTO style smoothing: slow-moving mean, faster-moving deviation.
+  double smoothed_refill_seconds = 0.0;
+  double refill_deviation_seconds = 0.0;
+  double drain_units_per_second = 0.0;
+  auto last_refill_end = std::chrono::steady_clock::now();
+  double level_after_last_refill = -1.0;
+
+  const auto below_refill_mark =
+    [this, queue_lower_boundary, byte_lower_boundary, adaptive_refill,
+      &adaptive_lower_boundary, &queued_units]() {
+      if (adaptive_refill) {
+        return queued_units() < adaptive_lower_boundary;
+      }
+      return read_ahead_byte_budget_ > 0 ?
+             queued_bytes_.load() < byte_lower_boundary :
+             message_queue_.size_approx() < queue_lower_boundary;
+    };
+
+  while (rclcpp::ok()) {
+    if (seek_requested_) {
+      // Seek handshake: stop producing, let the playback thread flush the
+      // queue, then move the reader and refill from the new position.
+      std::unique_lock<std::mutex> lock(control_mutex_);
+      loader_paused_for_seek_ = true;
+      control_condition_.notify_all();
+      control_condition_.wait(
+        lock, [this] {return playback_flushed_for_seek_ || !rclcpp::ok();});
+      if (rclcpp::ok()) {
+        reader_->seek(seek_to_time_ns_);
+      }
+      loader_paused_for_seek_ = false;
+      playback_flushed_for_seek_ = false;
+      seek_requested_ = false;
+      control_condition_.notify_all();
+      continue;
+    }
+    if (!reader_->has_next()) {
+      break;
+    }
+    if (below_refill_mark()) {
+      const auto refill_start = std::chrono::steady_clock::now();
+      const auto level_before_refill = queued_units();
+      if (adaptive_refill && level_after_last_refill >= 0.0) {
+        // Only the playback side dequeues, so the level drop since the end
+        // of the previous refill is the amount played in that span.
+        const auto drained = level_after_last_refill - level_before_refill;
+        const auto elapsed =
+          std::chrono::duration<double>(refill_start - last_refill_end).count();
+        if (drained > 0.0 && elapsed > 0.001) {
+          const auto rate = drained / elapsed;
+          drain_units_per_second = drain_units_per_second == 0.0 ?
+            rate : drain_units_per_second + (rate - drain_units_per_second) / 8.0;
+        }
+      }
 
-  while (reader_->has_next() && rclcpp::ok()) {
-    if (message_queue_.size_approx() < queue_lower_boundary) {
       enqueue_up_to_boundary(time_first_message, queue_upper_boundary);
+      queue_state_condition_.notify_all();
+
+      if (adaptive_refill) {
+        const auto refill_end = std::chrono::steady_clock::now();
+        const auto refill_seconds =
+          std::chrono::duration<double>(refill_end - refill_start).count();
+        if (smoothed_refill_seconds == 0.0) {
+          smoothed_refill_seconds = refill_seconds;
+          refill_deviation_seconds = refill_seconds / 2.0;
+        } else {
+          refill_deviation_seconds +=
+            (std::abs(refill_seconds - smoothed_refill_seconds) -
+            refill_deviation_seconds) / 4.0;
+          smoothed_refill_seconds += (refill_seconds - smoothed_refill_seconds) / 8.0;
+        }
+        last_refill_end = refill_end;
+        level_after_last_refill = queued_units();
+        if (drain_units_per_second > 0.0) {
+          // Keep enough queued to cover a pessimistic refill at the
+          // observed drain rate; clamped so a storage stall can neither
+          // push the mark to zero nor past the fixed-percentage mark,
+          // which must stay below the queue bound for the refill to have
+          // room to work with.
+          const auto cover_units = drain_units_per_second *
+            (smoothed_refill_seconds + deviation_margin * refill_deviation_seconds);
+          adaptive_lower_boundary = std::min(
+            upper_boundary_units * read_ahead_lower_bound_percentage_,
+            std::max(1.0, cover_units));
+        }
+      }
     } else {
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      // Block until the playback thread drained the queue below the
+      // low-water mark; it signals every dequeued message. The timeout only
+      // guards against a signal racing the fill-level check.
+      std::unique_lock<std::mutex> lock(queue_state_mutex_);
+      queue_state_condition_.wait_for(
+        lock, queue_read_wait_period_,
+        [this, &below_refill_mark] {
+          return below_refill_mark() || seek_requested_ || !rclcpp::ok();
+        });
     }
   }
+  // Wake a playback thread still waiting for the read-ahead target; loading
+  // is finished, so the target will never be reached.
+  queue_state_condition_.notify_all();
 }
 
 void Player::enqueue_up_to_boundary(const TimePoint & time_first_message, uint64_t boundary)
+{
+  if (read_ahead_byte_budget_ > 0) {
+    // The size of a message is only known after it was read, so the refill
+    // reads fixed-size batches and re-checks the byte budget in between
+    // instead of sizing one batch up front.
+    while (queued_bytes_.load() < read_ahead_byte_budget_ &&
+      reader_->has_next() && !seek_requested_)
+    {
+      reader_->read_next_batch(kByteBudgetRefillBatchSize, read_batch_);
+      enqueue_read_batch(time_first_message);
+    }
+    return;
+  }
+
+  const auto queued = message_queue_.size_approx();
+  if (queued >= boundary || seek_requested_) {
+    return;
+  }
+
+  // One batched read replaces a virtual call chain through the facade, the
+  // reader and the storage per message. A seek requested while the batch is
+  // being read only over-fills the queue by one refill, which the playback
+  // thread flushes anyway.
+  reader_->read_next_batch(boundary - queued, read_batch_);
+  enqueue_read_batch(time_first_message);
+}
+
+void Player::enqueue_read_batch(const TimePoint & time_first_message)
 {
   ReplayableMessage message;
-  for (size_t i = message_queue_.size_approx(); i < boundary; i++) {
-    if (!reader_->has_next()) {
-      break;
+  for (auto & bag_message : read_batch_) {
+    // Decimated messages never enter the queue, count towards the byte
+    // budget or reach a publisher; the refill loop simply reads further.
+    if (decimation_enabled_ && decimation_drops(*bag_message)) {
+      continue;
     }
-    message.message = reader_->read_next();
-    message.time_since_start =
-      TimePoint(std::chrono::nanoseconds(message.message->time_stamp)) - time_first_message;
+    message.message = std::move(bag_message);
+    // In reverse playback the first message is the latest one and the
+    // recorded spacing is replayed backwards.
+    const auto message_time = TimePoint(std::chrono::nanoseconds(message.message->time_stamp));
+    message.time_since_start = reverse_playback_ ?
+      time_first_message - message_time : message_time - time_first_message;
 
+    queued_bytes_ += message.message->serialized_data->buffer_length;
     message_queue_.enqueue(message);
   }
+  read_batch_.clear();
+}
+
+bool Player::decimation_drops(const rosbag2_storage::SerializedBagMessage & message)
+{
+  const auto sampling = topic_sampling_.find(message.topic_name);
+  if (sampling != topic_sampling_.end() && sampling->second > 1) {
+    if (sampling_counters_[message.topic_name]++ % sampling->second != 0) {
+      return true;
+    }
+  }
+  const auto interval = topic_min_intervals_ns_.find(message.topic_name);
+  if (interval != topic_min_intervals_ns_.end()) {
+    const auto last_kept = last_kept_time_per_topic_.find(message.topic_name);
+    if (last_kept != last_kept_time_per_topic_.end()) {
+      // Spacing in recorded time; the absolute value keeps the cap working
+      // in reverse playback, where timestamps descend.
+      const auto spacing = message.time_stamp > last_kept->second ?
+        message.time_stamp - last_kept->second : last_kept->second - message.time_stamp;
+      if (spacing < interval->second) {
+        return true;
+      }
+    }
+    last_kept_time_per_topic_[message.topic_name] = message.time_stamp;
+  }
+  return false;
 }
 
 void Player::play_messages_from_queue(const PlayOptions & options)
@@ -161,30 +982,260 @@ void Player::play_messages_from_queue(const PlayOptions & options)
   do {
     play_messages_until_queue_empty(options);
     if (!is_storage_completely_loaded() && rclcpp::ok()) {
+      {
+        std::lock_guard<std::mutex> lock(timing_mutex_);
+        ++queue_starvation_count_;
+      }
       ROSBAG2_TRANSPORT_LOG_WARN(
+        read_ahead_byte_budget_ > 0 ?
+        "Message queue starved. Messages will be delayed. Consider "
+        "increasing the --read-ahead-byte-budget option." :
         "Message queue starved. Messages will be delayed. Consider "
         "increasing the --read-ahead-queue-size option.");
     }
   } while (!is_storage_completely_loaded() && rclcpp::ok());
 }
 
+std::chrono::system_clock::time_point Player::publishing_instant(
+  const ReplayableMessage & message) const
+{
+  return start_time_ + std::chrono::duration_cast<std::chrono::nanoseconds>(
+    1.0 / playback_rate_ * message.time_since_start);
+}
+
+void Player::wait_until_publishing_instant(
+  const std::chrono::system_clock::time_point & instant) const
+{
+  // Coarse sleep until shortly before the absolute deadline, then spin the
+  // final stretch for sub-50us accuracy.
+  const auto spin_start = instant - kSpinWindow;
+  if (std::chrono::system_clock::now() < spin_start) {
+    std::this_thread::sleep_until(spin_start);
+  }
+  while (std::chrono::system_clock::now() < instant) {
+    // Busy-spin against the deadline.
+  }
+}
+
+void Player::apply_pending_rate_change()
+{
+  const double requested = requested_rate_.exchange(0.0);
+  if (requested <= 0.0 || requested == playback_rate_) {
+    return;
+  }
+  // Re-base the clock so the bag position due right now keeps its deadline
+  // and only the timeline ahead stretches or compresses. Messages already
+  // queued stay valid, so no flush is needed.
+  const auto now = std::chrono::system_clock::now();
+  start_time_ = now - std::chrono::duration_cast<std::chrono::system_clock::duration>(
+    std::chrono::duration<double, std::nano>(now - start_time_) *
+    (playback_rate_ / requested));
+  playback_rate_ = requested;
+  ROSBAG2_TRANSPORT_LOG_INFO_STREAM("Playback rate changed to " << playback_rate_ << ".");
+}
+
+bool Player::wait_for_publishing_instant(const ReplayableMessage & message)
+{
+  if (as_fast_as_possible_) {
+    // No pacing at all; the recorded timeline is ignored.
+    return rclcpp::ok() && !seek_requested_;
+  }
+  std::unique_lock<std::mutex> lock(control_mutex_);
+  while (rclcpp::ok() && !seek_requested_) {
+    // A rate change requested while paused lands here right after the
+    // pause time was credited, so it re-bases against the resume position.
+    apply_pending_rate_change();
+    if (paused_) {
+      const auto pause_start = std::chrono::system_clock::now();
+      control_condition_.wait(
+        lock, [this] {
+          return !paused_ || seek_requested_ || step_requested_ || !rclcpp::ok();
+        });
+      // Shift the playback clock by the time spent paused so the remaining
+      // messages keep their relative spacing.
+      start_time_ += std::chrono::system_clock::now() - pause_start;
+      if (step_requested_.exchange(false)) {
+        // Publish exactly this message and stay paused.
+        return rclcpp::ok() && !seek_requested_;
+      }
+      continue;
+    }
+    const auto instant = publishing_instant(message);
+    if (instant - std::chrono::system_clock::now() > kControlWaitSlice) {
+      // Far from the deadline: wait interruptibly so pause and seek take
+      // effect immediately.
+      control_condition_.wait_for(lock, kControlWaitSlice);
+      continue;
+    }
+    lock.unlock();
+    wait_until_publishing_instant(instant);
+    return true;
+  }
+  return false;
+}
+
+void Player::coordinate_seek()
+{
+  std::unique_lock<std::mutex> lock(control_mutex_);
+  // The loader stops producing before the flush, so no stale message can be
+  // enqueued afterwards. A loader which already read the bag to the end
+  // cannot serve the seek anymore.
+  control_condition_.wait(
+    lock, [this] {
+      return loader_paused_for_seek_ || is_storage_completely_loaded() || !rclcpp::ok();
+    });
+  if (!loader_paused_for_seek_) {
+    seek_requested_ = false;
+    ROSBAG2_TRANSPORT_LOG_WARN("Cannot seek, the bag was already read to the end.");
+    return;
+  }
+
+  ReplayableMessage stale;
+  while (message_queue_.try_dequeue(stale)) {
+    queued_bytes_ -= stale.message->serialized_data->buffer_length;
+  }
+  // Messages already handed to the workers refer to the old position too.
+  flush_worker_queues();
+
+  // A seek leaves a gap in the first pass, so the loop cache would no
+  // longer cover the whole bag.
+  if (loop_cache_enabled_) {
+    loop_cache_enabled_ = false;
+    std::vector<ReplayableMessage>().swap(loop_cache_);
+    loop_cache_bytes_ = 0;
+  }
+
+  // Rebase the playback clock so the seek target is due immediately.
+  const int64_t seek_offset_ns = reverse_playback_ ?
+    first_message_time_ns_ - seek_to_time_ns_ : seek_to_time_ns_ - first_message_time_ns_;
+  start_time_ = std::chrono::system_clock::now() -
+    std::chrono::duration_cast<std::chrono::system_clock::duration>(
+    std::chrono::duration<double, std::nano>(
+      static_cast<double>(seek_offset_ns) / playback_rate_));
+
+  playback_flushed_for_seek_ = true;
+  control_condition_.notify_all();
+  control_condition_.wait(lock, [this] {return !seek_requested_ || !rclcpp::ok();});
+  lock.unlock();
+
+  // Give the loader a chance to refill before the dequeue loop decides the
+  // queue ran dry.
+  std::unique_lock<std::mutex> queue_lock(queue_state_mutex_);
+  while (message_queue_.size_approx() == 0 &&
+    !is_storage_completely_loaded() && rclcpp::ok() && !seek_requested_)
+  {
+    queue_state_condition_.wait_for(queue_lock, queue_read_wait_period_);
+  }
+}
+
 void Player::play_messages_until_queue_empty(const PlayOptions & options)
 {
   ReplayableMessage message;
 
-  float rate = 1.0;
-  // Use rate if in valid range
-  if (options.rate > 0.0) {
-    rate = options.rate;
+  while (rclcpp::ok()) {
+    if (seek_requested_) {
+      coordinate_seek();
+      continue;
+    }
+    if (!message_queue_.try_dequeue(message)) {
+      break;
+    }
+    queued_bytes_ -= message.message->serialized_data->buffer_length;
+    // Let the loader top the queue up again while this message waits for
+    // its publishing instant.
+    queue_state_condition_.notify_all();
+    if (!wait_for_publishing_instant(message)) {
+      // Interrupted by a seek or shutdown; the dequeued message goes away
+      // with the queue flush.
+      continue;
+    }
+    if (should_skip_late_message(message)) {
+      // The message missed its deadline beyond the budget; skipping it
+      // keeps the remaining replay time-faithful. It still reaches the
+      // loop cache, which mirrors bag content, not what was published.
+      maybe_cache_for_loop(message);
+      continue;
+    }
+    dispatch_to_worker(message);
+    note_played_message(message);
+    maybe_cache_for_loop(message);
+
+    // Publish every further message already due within the batch window in
+    // one group, without sleeping between them.
+    // While paused, batching is disabled so a step releases exactly one
+    // message.
+    ReplayableMessage * next = message_queue_.peek();
+    while (next != nullptr && rclcpp::ok() && !seek_requested_ && !paused_ &&
+      (as_fast_as_possible_ ||
+      publishing_instant(*next) <= std::chrono::system_clock::now() + kBatchWindow))
+    {
+      if (!should_skip_late_message(*next)) {
+        dispatch_to_worker(*next);
+        note_played_message(*next);
+      }
+      maybe_cache_for_loop(*next);
+      queued_bytes_ -= next->message->serialized_data->buffer_length;
+      message_queue_.pop();
+      queue_state_condition_.notify_all();
+      next = message_queue_.peek();
+    }
   }
+}
+
+void Player::maybe_cache_for_loop(const ReplayableMessage & message)
+{
+  if (!loop_cache_enabled_) {
+    return;
+  }
+  loop_cache_bytes_ += message.message->serialized_data->buffer_length;
+  if (loop_cache_bytes_ > loop_cache_size_limit_) {
+    // The bag does not fit into the budget; later loops rewind via seek.
+    loop_cache_enabled_ = false;
+    std::vector<ReplayableMessage>().swap(loop_cache_);
+    loop_cache_bytes_ = 0;
+    ROSBAG2_TRANSPORT_LOG_INFO(
+      "The bag exceeds the loop cache budget; loops will rewind via storage seek.");
+    return;
+  }
+  loop_cache_.push_back(message);
+}
 
-  while (message_queue_.try_dequeue(message) && rclcpp::ok()) {
-    std::this_thread::sleep_until(
-      start_time_ + std::chrono::duration_cast<std::chrono::nanoseconds>(
-        1.0 / rate * message.time_since_start));
-    if (rclcpp::ok()) {
-      publishers_[message.message->topic_name]->publish(message.message->serialized_data);
+void Player::replay_loop_cache()
+{
+  start_time_ = std::chrono::system_clock::now();
+  size_t index = 0;
+  while (index < loop_cache_.size() && rclcpp::ok()) {
+    if (seek_requested_) {
+      // A seek within the cache is just an index jump plus a clock rebase.
+      flush_worker_queues();
+      const int64_t target = seek_to_time_ns_;
+      const auto target_offset = std::chrono::nanoseconds(target - first_message_time_ns_);
+      index = 0;
+      while (index < loop_cache_.size() &&
+        loop_cache_[index].time_since_start < target_offset)
+      {
+        ++index;
+      }
+      start_time_ = std::chrono::system_clock::now() -
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::duration<double, std::nano>(
+          static_cast<double>(target - first_message_time_ns_) / playback_rate_));
+      seek_requested_ = false;
+      control_condition_.notify_all();
+      continue;
+    }
+
+    const auto & message = loop_cache_[index];
+    if (!wait_for_publishing_instant(message)) {
+      continue;  // Interrupted by a seek or shutdown.
     }
+    if (should_skip_late_message(message)) {
+      ++index;
+      continue;
+    }
+    dispatch_to_worker(message);
+    note_played_message(message);
+    ++index;
   }
 }
 
@@ -192,15 +1243,67 @@ void Player::prepare_publishers(const PlayOptions & options)
 {
   rosbag2_storage::StorageFilter storage_filter;
   storage_filter.topics = options.topics_to_filter;
+  storage_filter.topics_regex = options.topics_regex_to_filter;
+  storage_filter.topics_regex_to_exclude = options.topics_regex_to_exclude;
+
+  // Resolve the relative start-offset and duration bounds against the bag
+  // metadata and fold them into the absolute time window, so they profit
+  // from the same storage pushdown as start_time and end_time.
+  rcutils_time_point_value_t start_time = options.start_time;
+  rcutils_time_point_value_t end_time = options.end_time;
+  if (options.start_offset > 0 || options.playback_duration >= 0) {
+    const auto bag_starting_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      reader_->get_metadata().starting_time.time_since_epoch()).count();
+    if (options.start_offset > 0) {
+      start_time = std::max(start_time, bag_starting_time + options.start_offset);
+    }
+    if (options.playback_duration >= 0) {
+      const auto effective_start = start_time >= 0 ? start_time : bag_starting_time;
+      const auto duration_end = effective_start + options.playback_duration;
+      end_time = end_time >= 0 ? std::min(end_time, duration_end) : duration_end;
+    }
+  }
+  storage_filter.start_time = start_time;
+  storage_filter.end_time = end_time;
   reader_->set_filter(storage_filter);
 
   auto topics = reader_->get_all_topics_and_types();
-  for (const auto & topic : topics) {
-    auto topic_qos = publisher_qos_for_topic(topic, topic_qos_profile_overrides_);
+  if (topics.empty()) {
+    return;
+  }
+
+  // Resolving a QoS profile parses the recorded offered-profiles YAML and
+  // loading a typesupport library hits the dynamic linker; both are
+  // independent per topic and dominate play startup on bags with many
+  // topics, so they run on a thread pool. Creating the publishers
+  // registers them with the node and stays on this thread.
+  std::vector<rclcpp::QoS> topic_qos_profiles(topics.size(), rclcpp::QoS{10});
+  size_t worker_count = std::thread::hardware_concurrency();
+  if (worker_count == 0) {
+    worker_count = kPublishingWorkerCount;
+  }
+  worker_count = std::min(worker_count, topics.size());
+  std::atomic<size_t> next_topic{0};
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back(
+      [this, &topics, &topic_qos_profiles, &next_topic]() {
+        for (size_t index = next_topic++; index < topics.size(); index = next_topic++) {
+          topic_qos_profiles[index] =
+            publisher_qos_for_topic(topics[index], topic_qos_profile_overrides_);
+          rosbag2_transport_->get_typesupport_library_for_type(topics[index].type);
+        }
+      });
+  }
+  for (auto & worker : workers) {
+    worker.join();
+  }
+
+  for (size_t index = 0; index < topics.size(); ++index) {
     publishers_.insert(
       std::make_pair(
-        topic.name, rosbag2_transport_->create_generic_publisher(
-          topic.name, topic.type, topic_qos)));
+        topics[index].name, rosbag2_transport_->create_generic_publisher(
+          topics[index].name, topics[index].type, topic_qos_profiles[index])));
   }
 }
 
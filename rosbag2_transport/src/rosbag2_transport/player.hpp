@@ -15,16 +15,31 @@
 #ifndef ROSBAG2_TRANSPORT__PLAYER_HPP_
 #define ROSBAG2_TRANSPORT__PLAYER_HPP_
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "moodycamel/readerwriterqueue.h"
 
+#include "rclcpp/publisher.hpp"
 #include "rclcpp/qos.hpp"
+#include "rclcpp/service.hpp"
+#include "rclcpp/timer.hpp"
+
+#include "rosbag2_interfaces/srv/seek.hpp"
+#include "rosbag2_interfaces/srv/set_rate.hpp"
+#include "rosgraph_msgs/msg/clock.hpp"
+#include "std_msgs/msg/string.hpp"
+#include "std_srvs/srv/trigger.hpp"
 
 #include "rosbag2_transport/play_options.hpp"
 
@@ -56,20 +71,256 @@ private:
   void load_storage_content(const PlayOptions & options);
   bool is_storage_completely_loaded() const;
   void enqueue_up_to_boundary(const TimePoint & time_first_message, uint64_t boundary);
-  void wait_for_filled_queue(const PlayOptions & options) const;
+  // Enqueues one batched read, maintaining the byte accounting of the queue.
+  void enqueue_read_batch(const TimePoint & time_first_message);
+  // Whether the read-ahead queue reached its configured bound: the byte
+  // budget when one is set, the message count otherwise.
+  bool read_ahead_queue_is_filled() const;
+  void wait_for_filled_queue() const;
   void play_messages_from_queue(const PlayOptions & options);
   void play_messages_until_queue_empty(const PlayOptions & options);
+  // Absolute wall-clock instant at which the message is due, honoring the
+  // current playback rate.
+  std::chrono::system_clock::time_point publishing_instant(
+    const ReplayableMessage & message) const;
+  // Sleeps until shortly before the deadline and busy-spins the final
+  // stretch, avoiding the scheduling jitter of a plain sleep_until.
+  void wait_until_publishing_instant(
+    const std::chrono::system_clock::time_point & instant) const;
+  // Waits for the publishing instant of the message, staying responsive to
+  // pause, seek and shutdown. Returns false when the wait was interrupted by
+  // a seek request or shutdown and the message must not be published.
+  bool wait_for_publishing_instant(const ReplayableMessage & message);
+  // Applies a rate requested through the set_rate service. Runs on the
+  // playback thread with control_mutex_ held, at points where the pause
+  // accounting is settled: the clock is re-based so the current bag
+  // position stays put and only the timeline ahead stretches or
+  // compresses, keeping the deadline math O(1) per message with no queue
+  // flush.
+  void apply_pending_rate_change();
+  // Creates the playback control services (pause/resume/step/seek/
+  // set_rate) on the transport node. Only created once, even when playback
+  // is looped.
+  void setup_control_services();
+  // Playback side of a seek: flushes the queue once the loader stopped
+  // producing, rebases the playback clock onto the seek target and waits for
+  // the loader to refill the queue from the new position.
+  void coordinate_seek();
+  // Starts the publishing worker pool; messages are sharded across the
+  // workers by topic, preserving per-topic order.
+  void start_publishing_workers();
+  // Stops the publishing workers after draining their queues.
+  void stop_publishing_workers();
+  // Hands a due message to the worker owning its topic. Blocks only when
+  // that worker's own queue is full.
+  void dispatch_to_worker(const ReplayableMessage & message);
+  // Drops messages still queued on the workers, e.g. on a seek.
+  void flush_worker_queues();
+  // Body of a publishing worker thread.
+  void publishing_worker_loop(size_t worker_index);
+  // Starts the /clock publisher thread when the options ask for one. The
+  // published time is derived from the same playback clock that paces the
+  // messages, so it is exactly consistent with the replayed timestamps.
+  void start_clock_publishing(const PlayOptions & options);
+  // Stops and joins the /clock publisher thread.
+  void stop_clock_publishing();
+  // Body of the /clock publisher thread.
+  void clock_publisher_loop(double frequency);
+  // Counts a message towards the playback statistics.
+  void note_played_message(const ReplayableMessage & message);
+  // Whether keep-up mode must skip the message because it missed its
+  // deadline by more than its topic's lateness budget. Counts the skip.
+  bool should_skip_late_message(const ReplayableMessage & message);
+  // Logs how many messages keep-up mode skipped, per topic. Silent when
+  // nothing was skipped.
+  void print_keep_up_report() const;
+  // Applies the configured affinity and priority of the named thread role
+  // to the calling thread; a no-op for roles without an entry.
+  void apply_thread_attributes(const std::string & role) const;
+  // Logs the throughput report of an as-fast-as-possible run.
+  void print_playback_statistics() const;
+  // Records the scheduled-vs-actual publish error of a paced message into
+  // the timing histogram. An as-fast-as-possible run has no schedule to
+  // compare against and records nothing.
+  void note_timing_error(const ReplayableMessage & message);
+  // Publishes the replay-fidelity statistics (timing-error percentiles and
+  // queue-starvation count) as YAML on the statistics topic.
+  void publish_timing_statistics();
+  // Logs the end-of-run replay-fidelity summary. Silent when no paced
+  // message was published.
+  void print_timing_report() const;
+  // Whether per-topic decimation (every-Nth sampling or a max-frequency
+  // cap) drops the message. Updates the decimation counters, so it must be
+  // called exactly once per loaded message.
+  bool decimation_drops(const rosbag2_storage::SerializedBagMessage & message);
+  // Retains the message in the loop cache while the configured byte budget
+  // permits; drops the whole cache once the bag turns out not to fit.
+  void maybe_cache_for_loop(const ReplayableMessage & message);
+  // Replays one full loop from the retained cache with a rebased playback
+  // clock, without touching the storage. Seeks jump within the cache.
+  void replay_loop_cache();
   void prepare_publishers(const PlayOptions & options);
   static constexpr double read_ahead_lower_bound_percentage_ = 0.9;
   static const std::chrono::milliseconds queue_read_wait_period_;
 
   std::shared_ptr<rosbag2_cpp::Reader> reader_;
+  // Scratch buffer for batched reads, reused across queue refills so the
+  // loading thread does not allocate a fresh vector per batch. Only touched
+  // by the storage-loading thread.
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> read_batch_;
   moodycamel::ReaderWriterQueue<ReplayableMessage> message_queue_;
+  // Serialized bytes currently held in message_queue_, maintained by the
+  // loading thread on enqueue and the playback thread on dequeue. Drives
+  // the queue bound when a read-ahead byte budget is configured.
+  std::atomic<uint64_t> queued_bytes_{0};
+  // Byte budget for the read-ahead queue; 0 bounds the queue by message
+  // count (read_ahead_queue_size_) instead.
+  uint64_t read_ahead_byte_budget_{0};
+  // Message-count bound of the read-ahead queue, kept for compatibility.
+  size_t read_ahead_queue_size_{0};
+  // Signals fill-level changes of the queue between the storage-loading
+  // thread and the playback thread, so neither side needs to poll: playback
+  // starts the moment the read-ahead target is reached and the loader only
+  // sleeps while the queue is genuinely full.
+  mutable std::mutex queue_state_mutex_;
+  mutable std::condition_variable queue_state_condition_;
   std::chrono::time_point<std::chrono::system_clock> start_time_;
+  // Effective playback rate. Owned by the playback thread, which applies
+  // requested_rate_ at its control points; read by the clock thread under
+  // control_mutex_ together with start_time_, since both change as a pair.
+  double playback_rate_{1.0};
+  // Rate requested through the set_rate service, pending until the playback
+  // thread picks it up; 0 when no request is outstanding.
+  std::atomic<double> requested_rate_{0.0};
   mutable std::future<void> storage_loading_future_;
   std::shared_ptr<Rosbag2Node> rosbag2_transport_;
   std::unordered_map<std::string, std::shared_ptr<GenericPublisher>> publishers_;
   std::unordered_map<std::string, rclcpp::QoS> topic_qos_profile_overrides_;
+
+  // Runtime playback control, driven by the pause/resume/seek services and
+  // observed by the loading and playback threads.
+  std::atomic<bool> paused_{false};
+  // One-shot request of the step service: while paused, release exactly one
+  // message (in the current read order) without resuming.
+  std::atomic<bool> step_requested_{false};
+  // Whether this playback runs with a reversed read order; flips the sign
+  // of the recorded timeline wherever it is mapped to wall time.
+  bool reverse_playback_{false};
+  std::atomic<bool> seek_requested_{false};
+  std::atomic<int64_t> seek_to_time_ns_{0};
+  // Recording time of the first message; the reference for rebasing the
+  // playback clock after a seek.
+  std::atomic<int64_t> first_message_time_ns_{0};
+  // Seek handshake between the loader and the playback thread: the loader
+  // stops producing, the playback thread flushes the queue, the loader seeks
+  // the reader and refills. Guarded by control_mutex_.
+  bool loader_paused_for_seek_{false};
+  bool playback_flushed_for_seek_{false};
+  std::mutex control_mutex_;
+  std::condition_variable control_condition_;
+
+  // Publishing worker pool: the playback thread only paces the messages and
+  // hands each due message to the worker owning its topic, so one slow
+  // publish (e.g. a large image into a reliable QoS) cannot head-of-line
+  // block the other topics. Topic-to-worker assignment is a stable hash,
+  // which preserves per-topic publish order.
+  struct PublishingWorker
+  {
+    // Fixed ring of message slots, preallocated when the worker starts: the
+    // dispatcher fills the slot after the last occupied one, the worker
+    // drains from head and the slot is recycled in place. Pushing and
+    // popping then never allocate, unlike a deque shifting its backing
+    // blocks. A moved-out slot holds no payload reference, so a drained
+    // ring pins no message memory.
+    std::vector<ReplayableMessage> slots;
+    size_t head = 0;
+    size_t size = 0;
+    std::mutex mutex;
+    std::condition_variable condition;
+    // Signals the dispatching thread that a full worker queue has room again.
+    std::condition_variable drained_condition;
+    std::thread thread;
+    bool stop = false;
+    // Publisher per interned topic id, filled lazily from publishers_. The
+    // id-based sharding pins a topic to one worker, so only this worker's
+    // thread touches the table; messages without an id fall back to the
+    // by-name map.
+    std::vector<std::shared_ptr<GenericPublisher>> publisher_by_topic_id;
+  };
+  std::vector<std::unique_ptr<PublishingWorker>> publishing_workers_;
+
+  // Optional /clock publisher for sim-time consumers; holds the last
+  // published time while playback is paused.
+  rclcpp::Publisher<rosgraph_msgs::msg::Clock>::SharedPtr clock_publisher_;
+  std::thread clock_thread_;
+  std::mutex clock_mutex_;
+  std::condition_variable clock_condition_;
+  bool stop_clock_{false};
+
+  // Playback statistics, maintained by the pacing thread only and reported
+  // after an as-fast-as-possible run.
+  bool as_fast_as_possible_{false};
+  uint64_t played_message_count_{0};
+  uint64_t played_byte_count_{0};
+  // Per-topic counters, indexed by the interned topic id when the messages
+  // carry one (with the name kept aside for the final report) and keyed by
+  // name otherwise.
+  std::vector<uint64_t> played_count_by_topic_id_;
+  std::vector<std::string> played_topic_names_by_id_;
+  std::unordered_map<std::string, uint64_t> played_messages_per_topic_;
+  std::chrono::steady_clock::time_point playback_wall_start_;
+
+  // Per-role thread affinity and priority, applied to the pacing thread
+  // and when the publishing, loading and clock threads start.
+  std::unordered_map<std::string, ThreadAttributes> thread_attributes_;
+
+  // Keep-up mode: messages due longer ago than this many nanoseconds are
+  // skipped instead of published late; negative always publishes. The
+  // per-topic budgets win over the default. Skip counters are maintained
+  // by the pacing thread only.
+  rcutils_time_point_value_t lateness_budget_ns_{-1};
+  std::unordered_map<std::string, rcutils_time_point_value_t> topic_lateness_budgets_;
+  uint64_t skipped_late_message_count_{0};
+  std::unordered_map<std::string, uint64_t> skipped_late_messages_per_topic_;
+
+  // Replay-fidelity instrumentation: the scheduled-vs-actual publish error
+  // of every paced message goes into a log2-bucketed histogram (bucket i
+  // counts error magnitudes in [2^(i-1), 2^i) microseconds, bucket 0 those
+  // below 1 us), alongside counts of early publishes (batch window) and
+  // read-ahead queue starvations. Written by the pacing thread, read by the
+  // statistics timer; guarded by timing_mutex_.
+  static constexpr size_t kTimingHistogramBucketCount = 22;
+  mutable std::mutex timing_mutex_;
+  std::array<uint64_t, kTimingHistogramBucketCount> timing_error_histogram_{};
+  uint64_t timing_sample_count_{0};
+  int64_t timing_error_max_ns_{0};
+  uint64_t early_published_count_{0};
+  uint64_t queue_starvation_count_{0};
+  rclcpp::Publisher<std_msgs::msg::String>::SharedPtr statistics_publisher_;
+  rclcpp::TimerBase::SharedPtr statistics_timer_;
+
+  // Per-topic decimation, applied by the storage loading thread before a
+  // message enters the read-ahead queue; all of this state is only touched
+  // by that thread. topic_min_intervals_ns_ is the configured frequency
+  // cap converted to a minimum recorded-time spacing.
+  bool decimation_enabled_{false};
+  std::unordered_map<std::string, uint64_t> topic_sampling_;
+  std::unordered_map<std::string, uint64_t> sampling_counters_;
+  std::unordered_map<std::string, rcutils_time_point_value_t> topic_min_intervals_ns_;
+  std::unordered_map<std::string, rcutils_time_point_value_t> last_kept_time_per_topic_;
+
+  // Loop cache: decoded messages of the first pass, retained while looping
+  // so later loops cost no storage I/O. Only used by the playback thread.
+  std::vector<ReplayableMessage> loop_cache_;
+  uint64_t loop_cache_bytes_{0};
+  uint64_t loop_cache_size_limit_{0};
+  bool loop_cache_enabled_{false};
+
+  rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr pause_service_;
+  rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr step_service_;
+  rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr resume_service_;
+  rclcpp::Service<rosbag2_interfaces::srv::Seek>::SharedPtr seek_service_;
+  rclcpp::Service<rosbag2_interfaces::srv::SetRate>::SharedPtr set_rate_service_;
 };
 
 }  // namespace rosbag2_transport
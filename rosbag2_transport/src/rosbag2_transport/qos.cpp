@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -145,6 +146,55 @@ Rosbag2QoS Rosbag2QoS::adapt_request_to_offers(
   return request_qos;
 }
 
+Rosbag2QoS Rosbag2QoS::adapt_request_to_recorded_offers(
+  const std::string & topic_name, const std::vector<Rosbag2QoS> & profiles)
+{
+  if (profiles.empty()) {
+    return Rosbag2QoS{};
+  }
+  size_t num_profiles = profiles.size();
+  size_t reliability_reliable_profiles_count = 0;
+  size_t durability_transient_local_profiles_count = 0;
+  for (const auto & qos : profiles) {
+    const auto & profile = qos.get_rmw_qos_profile();
+    if (profile.reliability == RMW_QOS_POLICY_RELIABILITY_RELIABLE) {
+      reliability_reliable_profiles_count++;
+    }
+    if (profile.durability == RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL) {
+      durability_transient_local_profiles_count++;
+    }
+  }
+
+  // Same policy-by-policy reasoning as adapt_request_to_offers; only the
+  // source of the offers differs.
+  Rosbag2QoS request_qos{};
+  if (reliability_reliable_profiles_count == num_profiles) {
+    request_qos.reliable();
+  } else {
+    if (reliability_reliable_profiles_count > 0) {
+      ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+        "Some, but not all, saved offers for topic \"" << topic_name << "\" "
+          "use RMW_QOS_POLICY_RELIABILITY_RELIABLE. "
+          "Falling back to RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT "
+          "as it will connect to all publishers.");
+    }
+    request_qos.best_effort();
+  }
+  if (durability_transient_local_profiles_count == num_profiles) {
+    request_qos.transient_local();
+  } else {
+    if (durability_transient_local_profiles_count > 0) {
+      ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+        "Some, but not all, saved offers for topic \"" << topic_name << "\" "
+          "use RMW_QOS_POLICY_DURABILITY_TRANSIENT_LOCAL. "
+          "Falling back to RMW_QOS_POLICY_DURABILITY_VOLATILE "
+          "as it will connect to all publishers.");
+    }
+    request_qos.durability_volatile();
+  }
+  return request_qos;
+}
+
 namespace
 {
 bool operator==(const rmw_time_t & lhs, const rmw_time_t & rhs)
@@ -197,4 +247,119 @@ Rosbag2QoS Rosbag2QoS::adapt_offer_to_recorded_offers(
       "Falling back to the rosbag2_transport default publisher offer.");
   return Rosbag2QoS{};
 }
+
+namespace
+{
+// Prefix marking the compact encoding. YAML profile lists start with "- " or
+// "[", so the prefix cannot collide with a YAML-encoded string.
+constexpr const char kQosEncodingPrefix[] = "qos1:";
+constexpr const size_t kQosEncodingPrefixLength = sizeof(kQosEncodingPrefix) - 1;
+
+// Two hex characters per byte: five 1-byte enum/bool fields and seven
+// 8-byte fields (depth and the three sec/nsec duration pairs) per profile.
+constexpr const size_t kHexCharsPerProfile = 5 * 2 + 7 * 16;
+
+void append_hex(std::string & out, uint64_t value, size_t bytes)
+{
+  static const char digits[] = "0123456789abcdef";
+  for (size_t i = bytes; i > 0; --i) {
+    const auto byte = static_cast<uint8_t>(value >> ((i - 1) * 8));
+    out.push_back(digits[byte >> 4]);
+    out.push_back(digits[byte & 0x0Fu]);
+  }
+}
+
+uint64_t parse_hex(const char * in, size_t bytes)
+{
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes * 2; ++i) {
+    const char character = in[i];
+    value <<= 4;
+    if (character >= '0' && character <= '9') {
+      value |= static_cast<uint64_t>(character - '0');
+    } else if (character >= 'a' && character <= 'f') {
+      value |= static_cast<uint64_t>(character - 'a' + 10);
+    } else {
+      throw std::runtime_error{"Invalid character in encoded QoS profile list."};
+    }
+  }
+  return value;
+}
+}  // unnamed namespace
+
+std::string serialize_qos_profiles(const std::vector<Rosbag2QoS> & profiles)
+{
+  std::string out{kQosEncodingPrefix};
+  out.reserve(kQosEncodingPrefixLength + profiles.size() * kHexCharsPerProfile);
+  for (const auto & qos : profiles) {
+    const auto & p = qos.get_rmw_qos_profile();
+    append_hex(out, static_cast<uint64_t>(p.history), 1);
+    append_hex(out, static_cast<uint64_t>(p.depth), 8);
+    append_hex(out, static_cast<uint64_t>(p.reliability), 1);
+    append_hex(out, static_cast<uint64_t>(p.durability), 1);
+    append_hex(out, p.deadline.sec, 8);
+    append_hex(out, p.deadline.nsec, 8);
+    append_hex(out, p.lifespan.sec, 8);
+    append_hex(out, p.lifespan.nsec, 8);
+    append_hex(out, static_cast<uint64_t>(p.liveliness), 1);
+    append_hex(out, p.liveliness_lease_duration.sec, 8);
+    append_hex(out, p.liveliness_lease_duration.nsec, 8);
+    append_hex(out, p.avoid_ros_namespace_conventions ? 1u : 0u, 1);
+  }
+  return out;
+}
+
+std::vector<Rosbag2QoS> deserialize_qos_profiles(const std::string & serialized)
+{
+  if (serialized.empty()) {
+    return {};
+  }
+  if (serialized.compare(0, kQosEncodingPrefixLength, kQosEncodingPrefix) != 0) {
+    // YAML: written before the compact encoding existed, or hand-edited at
+    // an import boundary.
+    return YAML::Load(serialized).as<std::vector<Rosbag2QoS>>();
+  }
+  const size_t payload_length = serialized.size() - kQosEncodingPrefixLength;
+  if (payload_length % kHexCharsPerProfile != 0u) {
+    throw std::runtime_error{"Encoded QoS profile list has an invalid length."};
+  }
+
+  std::vector<Rosbag2QoS> profiles(payload_length / kHexCharsPerProfile);
+  const char * cursor = serialized.data() + kQosEncodingPrefixLength;
+  const auto read = [&cursor](size_t bytes) {
+      const auto value = parse_hex(cursor, bytes);
+      cursor += bytes * 2;
+      return value;
+    };
+  for (auto & qos : profiles) {
+    // Field order and decode sequence mirror the YAML converter above.
+    const auto history = static_cast<rmw_qos_history_policy_t>(read(1));
+    const auto depth = static_cast<size_t>(read(8));
+    const auto reliability = static_cast<rmw_qos_reliability_policy_t>(read(1));
+    const auto durability = static_cast<rmw_qos_durability_policy_t>(read(1));
+    rmw_time_t deadline;
+    deadline.sec = read(8);
+    deadline.nsec = read(8);
+    rmw_time_t lifespan;
+    lifespan.sec = read(8);
+    lifespan.nsec = read(8);
+    const auto liveliness = static_cast<rmw_qos_liveliness_policy_t>(read(1));
+    rmw_time_t lease_duration;
+    lease_duration.sec = read(8);
+    lease_duration.nsec = read(8);
+    const bool avoid_conventions = read(1) != 0u;
+
+    qos
+    .keep_last(depth)
+    .history(history)
+    .reliability(reliability)
+    .durability(durability)
+    .deadline(deadline)
+    .lifespan(lifespan)
+    .liveliness(liveliness)
+    .liveliness_lease_duration(lease_duration)
+    .avoid_ros_namespace_conventions(avoid_conventions);
+  }
+  return profiles;
+}
 }  // namespace rosbag2_transport
@@ -63,6 +63,17 @@ public:
     const std::string & topic_name,
     const std::vector<rclcpp::TopicEndpointInfo> & endpoints);
 
+  // Create an adaptive QoS profile to use for subscribing from saved offers.
+  /**
+    * Same adaptation rules as adapt_request_to_offers, applied to profiles
+    * saved in an earlier session (e.g. a topic manifest) instead of live
+    * graph endpoints. Used when subscribing before any publisher of the
+    * topic is visible in the graph.
+    */
+  static Rosbag2QoS adapt_request_to_recorded_offers(
+    const std::string & topic_name,
+    const std::vector<Rosbag2QoS> & profiles);
+
   // Create a QoS profile to offer for playback.
   /**
     * This logic exists because rosbag2 does not record on a per-publisher basis, so we try to
@@ -75,6 +86,29 @@ public:
     const std::string & topic_name,
     const std::vector<Rosbag2QoS> & profiles);
 };
+
+/// Compact encoding of the QoS profile list stored per topic.
+/**
+  * The offered profiles of a topic ride through the storage topics table and
+  * the metadata file as one string. Historically that string was YAML, which
+  * costs a yaml-cpp emit per discovery poll while recording and a parse per
+  * topic at play start. serialize_qos_profiles instead packs the rmw profile
+  * fields into a fixed-width hex encoding ("qos1:" followed by 122 hex
+  * characters per profile) - binary content hex-armored so the TEXT column
+  * and the YAML metadata file carry it unchanged.
+  */
+std::string serialize_qos_profiles(const std::vector<Rosbag2QoS> & profiles);
+
+/// Decodes a QoS profile list serialized by serialize_qos_profiles.
+/**
+  * Strings without the compact-encoding prefix are parsed as YAML, so bags
+  * written before the encoding existed and hand-edited YAML at import
+  * boundaries (e.g. a topic manifest) keep working. An empty string decodes
+  * to an empty list.
+  *
+  * \throws std::runtime_error when a prefixed string is malformed.
+  */
+std::vector<Rosbag2QoS> deserialize_qos_profiles(const std::string & serialized);
 }  // namespace rosbag2_transport
 
 namespace YAML
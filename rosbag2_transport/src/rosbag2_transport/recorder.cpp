@@ -15,15 +15,25 @@
 #include "recorder.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
 #include <future>
 #include <memory>
+#include <regex>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "rclcpp/executors/multi_threaded_executor.hpp"
+
 #include "rosbag2_cpp/writer.hpp"
+#include "rosbag2_cpp/writer_interfaces/base_writer_interface.hpp"
+
+#include "rosbag2_storage/tracepoints.hpp"
 
 #include "rosbag2_transport/logging.hpp"
 
@@ -46,37 +56,239 @@
 
 namespace rosbag2_transport
 {
+namespace
+{
+// Capacity of the staging queue between subscription callbacks and the
+// writer-drain thread. Sized to absorb storage latency spikes of a few
+// seconds at typical sensor rates; beyond that, messages are dropped
+// rather than blocking the callback threads.
+constexpr const size_t kMessageQueueCapacity = 8192;
+
+// Capacity of the priority staging lane. Priority topics are meant to be
+// small and low-rate, so the lane stays shallow; it only has to cover the
+// arrivals during a single bulk write.
+constexpr const size_t kPriorityQueueCapacity = 1024;
+
+// Writer latency is sampled on every Nth message to keep the steady-clock
+// reads off the per-message path; the ring holds enough samples for
+// meaningful percentiles over the last publishing periods.
+constexpr const uint64_t kLatencySampleInterval = 16;
+constexpr const size_t kLatencySampleCapacity = 1024;
+
+// History-depth auto-tuning: each subscription's rmw queue must hold the
+// messages arriving while the drain thread sits in the writer's worst flush
+// stall, or the rmw layer drops them silently. The stall estimate is the
+// largest sampled write latency, floored at kMinimumCoveredStall so queues
+// are not undersized before a stall was observed; kMaximumTunedDepth bounds
+// the rmw-side memory per topic.
+constexpr const std::chrono::milliseconds kMinimumCoveredStall{500};
+constexpr const size_t kMaximumTunedDepth = 1000;
+
+// FNV-1a over the serialized payload, used by per-topic deduplication.
+// Cryptographic strength is not needed; a collision merely drops one
+// changed message of a static topic.
+uint64_t fnv1a_hash(const uint8_t * data, size_t size)
+{
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+uint32_t percentile_us(std::vector<uint32_t> & samples, double fraction)
+{
+  const auto index = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1));
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return samples[index];
+}
+}  // namespace
+
 Recorder::Recorder(std::shared_ptr<rosbag2_cpp::Writer> writer, std::shared_ptr<Rosbag2Node> node)
-: writer_(std::move(writer)), node_(std::move(node)) {}
+: writer_(std::move(writer)), node_(std::move(node)), message_queue_(kMessageQueueCapacity),
+  priority_queue_(kPriorityQueueCapacity) {}
 
 void Recorder::record(const RecordOptions & record_options)
+{
+  start(record_options);
+  record_messages();
+  stop();
+}
+
+void Recorder::start(const RecordOptions & record_options)
 {
   topic_qos_profile_overrides_ = record_options.topic_qos_profile_overrides;
+  topic_manifest_file_ = record_options.topic_manifest_file;
+  topic_sampling_ = record_options.topic_sampling;
+  topics_regex_to_exclude_ = record_options.topics_regex_to_exclude;
+  subscription_idle_timeout_ = record_options.subscription_idle_timeout;
+  thread_attributes_ = record_options.thread_attributes;
+  topic_deduplication_ = std::unordered_set<std::string>{
+    record_options.topic_deduplication.begin(), record_options.topic_deduplication.end()};
+  priority_topics_ = std::unordered_set<std::string>{
+    record_options.priority_topics.begin(), record_options.priority_topics.end()};
   if (record_options.rmw_serialization_format.empty()) {
     throw std::runtime_error("No serialization format specified!");
   }
   serialization_format_ = record_options.rmw_serialization_format;
+
+  auto events_publisher = node_->create_publisher<std_msgs::msg::String>(
+    "/rosbag2_recorder/events", 10);
+  events_publisher_ = events_publisher;
+  // The callback outlives this Recorder: the writer seals its last file only
+  // when the bag is closed, after record() returned. It must therefore
+  // capture the publisher by value and nothing of this.
+  writer_->get_implementation_handle().set_sealed_file_callback(
+    [events_publisher](const rosbag2_cpp::SealedBagfileInfo & sealed_file) {
+      YAML::Node event;
+      event["event"] = "bagfile_sealed";
+      event["file"] = sealed_file.file_path;
+      event["size"] = sealed_file.file_size;
+      event["starting_time_ns"] = sealed_file.starting_time_ns;
+      event["ending_time_ns"] = sealed_file.ending_time_ns;
+      std_msgs::msg::String message;
+      message.data = YAML::Dump(event);
+      try {
+        events_publisher->publish(message);
+      } catch (const std::exception & e) {
+        ROSBAG2_TRANSPORT_LOG_WARN_STREAM("Could not publish bagfile event: " << e.what());
+      }
+    });
+
+  split_service_ = node_->create_service<std_srvs::srv::Trigger>(
+    "/rosbag2_recorder/split_bagfile",
+    [this](
+      const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+      std::shared_ptr<std_srvs::srv::Trigger::Response> response) {
+      (void) request;
+      try {
+        writer_->split_bagfile();
+        response->success = true;
+      } catch (const std::exception & e) {
+        response->success = false;
+        response->message = e.what();
+      }
+    });
+
+  rotate_service_ = node_->create_service<rosbag2_interfaces::srv::Rotate>(
+    "/rosbag2_recorder/rotate",
+    [this](
+      const std::shared_ptr<rosbag2_interfaces::srv::Rotate::Request> request,
+      std::shared_ptr<rosbag2_interfaces::srv::Rotate::Response> response) {
+      try {
+        writer_->rotate_bag(request->uri);
+        response->success = true;
+        response->message = "Recording continues in " + request->uri;
+      } catch (const std::exception & e) {
+        response->success = false;
+        response->message = e.what();
+      }
+    });
+
+  pause_service_ = node_->create_service<std_srvs::srv::Trigger>(
+    "/rosbag2_recorder/pause",
+    [this](
+      const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+      std::shared_ptr<std_srvs::srv::Trigger::Response> response) {
+      (void) request;
+      pause();
+      ROSBAG2_TRANSPORT_LOG_INFO("Recording paused.");
+      response->success = true;
+      response->message = "paused";
+    });
+
+  resume_service_ = node_->create_service<std_srvs::srv::Trigger>(
+    "/rosbag2_recorder/resume",
+    [this](
+      const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+      std::shared_ptr<std_srvs::srv::Trigger::Response> response) {
+      (void) request;
+      resume();
+      ROSBAG2_TRANSPORT_LOG_INFO("Recording resumed.");
+      response->success = true;
+      response->message = "recording";
+    });
+
   ROSBAG2_TRANSPORT_LOG_INFO("Listening for topics...");
-  subscribe_topics(
-    get_requested_or_available_topics(record_options.topics, record_options.include_hidden_topics));
+  paused_ = false;
+  stop_draining_ = false;
+  stop_discovery_ = false;
+  drain_thread_ = std::thread(&Recorder::drain_messages, this);
+
+  // Warm start: subscriptions from the manifest of a previous session are
+  // created before the first graph query, so the first message lands as
+  // soon as the middleware matches. Runs on this thread so the discovery
+  // round below never races it and simply skips the topics already
+  // subscribed.
+  subscribe_from_manifest(record_options);
 
-  std::future<void> discovery_future;
+  // The initial subscription round runs off this thread, so the executor
+  // spinning the node starts delivering right away: every subscription
+  // begins delivering as soon as it is created instead of after the whole
+  // round (graph query, per-topic QoS serialization, subscription setup)
+  // has finished. On incident-triggered recording starts that round used to
+  // cost the first seconds of data.
   if (!record_options.is_discovery_disabled) {
     auto discovery = std::bind(
       &Recorder::topics_discovery, this,
       record_options.topic_polling_interval,
       record_options.topics,
       record_options.include_hidden_topics);
-    discovery_future = std::async(std::launch::async, discovery);
+    discovery_future_ = std::async(std::launch::async, discovery);
+  } else {
+    const auto topics = record_options.topics;
+    const auto include_hidden = record_options.include_hidden_topics;
+    discovery_future_ = std::async(
+      std::launch::async, [this, topics, include_hidden]() {
+        apply_thread_attributes("discovery");
+        subscribe_topics(get_requested_or_available_topics(topics, include_hidden));
+      });
   }
 
-  record_messages();
+  statistics_publisher_ = node_->create_publisher<std_msgs::msg::String>(
+    "/rosbag2_recorder/statistics", 10);
+  statistics_timer_ = node_->create_wall_timer(
+    std::chrono::seconds(1), [this]() {publish_statistics();});
+}
+
+void Recorder::stop()
+{
+  // End the discovery loop first so no new subscriptions race the teardown.
+  stop_discovery_ = true;
+  if (discovery_future_.valid()) {
+    discovery_future_.wait();
+  }
 
-  if (discovery_future.valid()) {
-    discovery_future.wait();
+  statistics_timer_.reset();
+  statistics_publisher_.reset();
+  split_service_.reset();
+  rotate_service_.reset();
+  pause_service_.reset();
+  resume_service_.reset();
+  // The sealed-file callback keeps its own reference to the events publisher.
+  events_publisher_.reset();
+  stop_draining_ = true;
+  if (drain_thread_.joinable()) {
+    drain_thread_.join();
   }
 
+  // Hand the final middleware-loss totals to the writer while the bag is
+  // still open, so they end up in the metadata.
+  {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    for (const auto & entry : lost_message_counts_) {
+      const auto total = lost_messages_baseline_[entry.first] + entry.second->load();
+      if (total > 0) {
+        writer_->get_implementation_handle().set_topic_rmw_lost_count(entry.first, total);
+      }
+    }
+  }
+
+  save_topic_manifest();
+
   subscriptions_.clear();
+  subscription_tuning_.clear();
 }
 
 void Recorder::topics_discovery(
@@ -84,7 +296,30 @@ void Recorder::topics_discovery(
   const std::vector<std::string> & requested_topics,
   bool include_hidden_topics)
 {
-  while (rclcpp::ok()) {
+  apply_thread_attributes("discovery");
+  // Block on the graph-change event instead of polling, so the full graph
+  // query and the subscription diff only run when the graph actually
+  // changed. The timeout merely keeps the loop responsive to shutdown and
+  // to stop().
+  auto graph_event = node_->get_graph_event();
+  bool first_pass = true;
+  bool all_requested_subscribed = false;
+  while (rclcpp::ok() && !stop_discovery_) {
+    if (!first_pass) {
+      node_->wait_for_graph_change(graph_event, topic_polling_interval);
+      // Arrival rates are re-checked on every wakeup, whether or not the
+      // graph changed, so queue depths follow the measured topic rates.
+      retune_history_depths();
+      prune_idle_subscriptions();
+      if (all_requested_subscribed || !graph_event->check_and_clear()) {
+        continue;  // Timed out or the graph is unchanged; nothing to subscribe.
+      }
+    }
+    // The first pass is the initial subscription round: it runs
+    // unconditionally so topics present at startup are subscribed without
+    // waiting for a graph change.
+    first_pass = false;
+
     auto topics_to_subscribe =
       get_requested_or_available_topics(requested_topics, include_hidden_topics);
     for (const auto & topic_and_type : topics_to_subscribe) {
@@ -93,11 +328,16 @@ void Recorder::topics_discovery(
     auto missing_topics = get_missing_topics(topics_to_subscribe);
     subscribe_topics(missing_topics);
 
-    if (!requested_topics.empty() && subscriptions_.size() == requested_topics.size()) {
+    // With idle pruning active the subscription diff must keep running so
+    // pruned topics can come back; the early-out would freeze them out.
+    if (subscription_idle_timeout_.count() == 0 &&
+      !requested_topics.empty() && subscriptions_.size() == requested_topics.size())
+    {
+      // The loop keeps running to watch arrival rates; only the graph
+      // queries and the subscription diff stop.
       ROSBAG2_TRANSPORT_LOG_INFO("All requested topics are subscribed. Stopping discovery...");
-      return;
+      all_requested_subscribed = true;
     }
-    std::this_thread::sleep_for(topic_polling_interval);
   }
 }
 
@@ -106,9 +346,19 @@ Recorder::get_requested_or_available_topics(
   const std::vector<std::string> & requested_topics,
   bool include_hidden_topics)
 {
-  return requested_topics.empty() ?
-         node_->get_all_topics_with_types(include_hidden_topics) :
-         node_->get_topics_with_types(requested_topics);
+  auto topics = requested_topics.empty() ?
+    node_->get_all_topics_with_types(include_hidden_topics) :
+    node_->get_topics_with_types(requested_topics);
+  if (!topics_regex_to_exclude_.empty()) {
+    // Excluded topics are dropped before subscribing, so their messages are
+    // never delivered to the recorder in the first place and cost neither
+    // DDS nor queue bandwidth.
+    const std::regex exclude_regex{topics_regex_to_exclude_};
+    for (auto it = topics.begin(); it != topics.end(); ) {
+      it = std::regex_search(it->first, exclude_regex) ? topics.erase(it) : std::next(it);
+    }
+  }
+  return topics;
 }
 
 std::unordered_map<std::string, std::string>
@@ -116,13 +366,53 @@ Recorder::get_missing_topics(const std::unordered_map<std::string, std::string>
 {
   std::unordered_map<std::string, std::string> missing_topics;
   for (const auto & i : all_topics) {
-    if (subscriptions_.find(i.first) == subscriptions_.end()) {
-      missing_topics.emplace(i.first, i.second);
+    if (subscriptions_.find(i.first) != subscriptions_.end()) {
+      continue;
     }
+    const auto pruned = pruned_topics_.find(i.first);
+    if (pruned != pruned_topics_.end()) {
+      // An idle-pruned topic still has its silent endpoints in the graph;
+      // resubscribing on the mere graph entry would undo the pruning on the
+      // next pass. A publisher appearing since the pruning is the signal
+      // that the topic became active again.
+      if (node_->get_publishers_info_by_topic(i.first).size() <= pruned->second) {
+        continue;
+      }
+      pruned_topics_.erase(pruned);
+    }
+    missing_topics.emplace(i.first, i.second);
   }
   return missing_topics;
 }
 
+void Recorder::prune_idle_subscriptions()
+{
+  if (subscription_idle_timeout_.count() == 0) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  std::vector<std::string> idle_topics;
+  for (const auto & entry : subscription_tuning_) {
+    if (subscriptions_.find(entry.first) == subscriptions_.end()) {
+      continue;
+    }
+    if (now - entry.second.last_activity >= subscription_idle_timeout_) {
+      idle_topics.push_back(entry.first);
+    }
+  }
+  for (const auto & topic_name : idle_topics) {
+    // The topic stays in the bag metadata; only the subscription and its
+    // waitset slot are released. The publisher count taken here is the
+    // baseline get_missing_topics() compares against for resubscription.
+    pruned_topics_[topic_name] = node_->get_publishers_info_by_topic(topic_name).size();
+    subscriptions_.erase(topic_name);
+    subscription_tuning_.erase(topic_name);
+    ROSBAG2_TRANSPORT_LOG_INFO_STREAM(
+      "Pruned idle subscription on topic '" << topic_name <<
+        "'; it is resubscribed when a new publisher appears.");
+  }
+}
+
 
 void Recorder::subscribe_topics(
   const std::unordered_map<std::string, std::string> & topics_and_types)
@@ -139,16 +429,24 @@ void Recorder::subscribe_topics(
 }
 
 void Recorder::subscribe_topic(const rosbag2_storage::TopicMetadata & topic)
+{
+  subscribe_topic(topic, Rosbag2QoS{subscription_qos_for_topic(topic.name)});
+}
+
+void Recorder::subscribe_topic(
+  const rosbag2_storage::TopicMetadata & topic, const Rosbag2QoS & subscription_qos)
 {
   // Need to create topic in writer before we are trying to create subscription. Since in
   // callback for subscription we are calling writer_->write(bag_message); and it could happened
   // that callback called before we reached out the line: writer_->create_topic(topic)
   writer_->create_topic(topic);
 
-  Rosbag2QoS subscription_qos{subscription_qos_for_topic(topic.name)};
   auto subscription = create_subscription(topic.name, topic.type, subscription_qos);
   if (subscription) {
     subscriptions_.insert({topic.name, subscription});
+    if (!topic_manifest_file_.empty()) {
+      manifest_entries_[topic.name] = topic;
+    }
     ROSBAG2_TRANSPORT_LOG_INFO_STREAM("Subscribed to topic '" << topic.name << "'");
   } else {
     writer_->remove_topic(topic);
@@ -156,56 +454,452 @@ void Recorder::subscribe_topic(const rosbag2_storage::TopicMetadata & topic)
   }
 }
 
+void Recorder::subscribe_from_manifest(const RecordOptions & record_options)
+{
+  if (topic_manifest_file_.empty()) {
+    return;
+  }
+  YAML::Node manifest;
+  try {
+    manifest = YAML::LoadFile(topic_manifest_file_);
+  } catch (const YAML::Exception & e) {
+    // A missing manifest is the expected first-boot case; anything else in
+    // the file still only costs the warm start, discovery covers for it.
+    ROSBAG2_TRANSPORT_LOG_INFO_STREAM(
+      "No usable topic manifest at '" << topic_manifest_file_ <<
+        "', starting cold: " << e.what());
+    return;
+  }
+
+  const std::unordered_set<std::string> requested{
+    record_options.topics.begin(), record_options.topics.end()};
+  size_t subscribed_count = 0;
+  for (const auto & entry : manifest) {
+    rosbag2_storage::TopicMetadata topic;
+    try {
+      topic.name = entry["name"].as<std::string>();
+      topic.type = entry["type"].as<std::string>();
+      topic.serialization_format = entry["serialization_format"].as<std::string>();
+      topic.offered_qos_profiles = entry["offered_qos_profiles"].as<std::string>();
+    } catch (const YAML::Exception & e) {
+      ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+        "Skipping malformed topic manifest entry: " << e.what());
+      continue;
+    }
+    // The manifest is a cache, not a configuration: the filters of this
+    // session still decide what gets subscribed.
+    if (!requested.empty() && requested.count(topic.name) == 0u) {
+      continue;
+    }
+    if (!topics_regex_to_exclude_.empty() &&
+      std::regex_search(topic.name, std::regex{topics_regex_to_exclude_}))
+    {
+      continue;
+    }
+
+    // The subscription QoS comes from the saved offers: at this point the
+    // graph typically shows no publisher yet, which is exactly why the
+    // manifest exists.
+    Rosbag2QoS subscription_qos;
+    if (topic_qos_profile_overrides_.count(topic.name)) {
+      subscription_qos = Rosbag2QoS{topic_qos_profile_overrides_.at(topic.name)};
+    } else {
+      std::vector<Rosbag2QoS> offered_profiles;
+      try {
+        offered_profiles = deserialize_qos_profiles(topic.offered_qos_profiles);
+      } catch (const std::exception & e) {
+        ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+          "Could not parse saved QoS offers for topic '" << topic.name <<
+            "', using the default subscription profile: " << e.what());
+      }
+      subscription_qos = Rosbag2QoS::adapt_request_to_recorded_offers(
+        topic.name, offered_profiles);
+    }
+    subscribe_topic(topic, subscription_qos);
+    if (subscriptions_.count(topic.name) != 0u) {
+      ++subscribed_count;
+    }
+  }
+  if (subscribed_count > 0) {
+    ROSBAG2_TRANSPORT_LOG_INFO_STREAM(
+      "Warm-started " << subscribed_count << " subscription(s) from topic manifest '" <<
+        topic_manifest_file_ << "'");
+  }
+}
+
+void Recorder::save_topic_manifest()
+{
+  if (topic_manifest_file_.empty() || manifest_entries_.empty()) {
+    return;
+  }
+  YAML::Node manifest;
+  for (const auto & entry : manifest_entries_) {
+    YAML::Node topic;
+    topic["name"] = entry.second.name;
+    topic["type"] = entry.second.type;
+    topic["serialization_format"] = entry.second.serialization_format;
+    topic["offered_qos_profiles"] = entry.second.offered_qos_profiles;
+    manifest.push_back(topic);
+  }
+  std::ofstream out{topic_manifest_file_, std::ios::trunc};
+  if (!out) {
+    ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+      "Could not write topic manifest to '" << topic_manifest_file_ << "'");
+    return;
+  }
+  out << YAML::Dump(manifest) << "\n";
+}
+
 std::shared_ptr<GenericSubscription>
 Recorder::create_subscription(
   const std::string & topic_name, const std::string & topic_type, const rclcpp::QoS & qos)
 {
+  // Resolve the interned topic id once at subscription time; every recorded
+  // message carries it, sparing the writer and the storage a by-name topic
+  // lookup per message.
+  const auto topic_id = writer_->get_implementation_handle().get_topic_id(topic_name);
+
+  // Per-topic sampling state; only set up for sampled topics so the hot
+  // path of fully recorded topics is untouched.
+  uint64_t sample_every = 1;
+  const auto sampling = topic_sampling_.find(topic_name);
+  if (sampling != topic_sampling_.end() && sampling->second > 1) {
+    sample_every = sampling->second;
+  }
+  auto received_count = std::make_shared<std::atomic<uint64_t>>(0);
+  auto sampled_out = std::make_shared<std::atomic<uint64_t>>(0);
+
+  // Per-topic deduplication state; zero means no payload was seen yet.
+  const bool deduplicate = topic_deduplication_.count(topic_name) != 0u;
+  auto last_payload_hash = std::make_shared<std::atomic<uint64_t>>(0);
+  auto deduplicated = std::make_shared<std::atomic<uint64_t>>(0);
+
+  // Lane assignment is decided once per subscription, not per message.
+  const bool priority = priority_topics_.count(topic_name) != 0u;
+
+  {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    history_depths_[topic_name] = qos.get_rmw_qos_profile().depth;
+    if (sample_every > 1) {
+      sampled_out_counts_[topic_name] = sampled_out;
+    }
+    if (deduplicate) {
+      deduplicated_counts_[topic_name] = deduplicated;
+    }
+  }
+  const auto subscribed_at = std::chrono::steady_clock::now();
+  subscription_tuning_[topic_name] = SubscriptionTuning{
+    topic_type, received_count, subscribed_at, 0,
+    qos.get_rmw_qos_profile().depth, subscribed_at};
+
   auto subscription = node_->create_generic_subscription(
     topic_name,
     topic_type,
     qos,
-    [this, topic_name](std::shared_ptr<rclcpp::SerializedMessage> message) {
-      auto bag_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
-      // the serialized bag message takes ownership of the incoming rclcpp serialized message
-      // we therefore have to make sure to cleanup that memory in a custom deleter.
-      bag_message->serialized_data = std::shared_ptr<rcutils_uint8_array_t>(
-        new rcutils_uint8_array_t,
-        [](rcutils_uint8_array_t * msg) {
-          auto fini_return = rcutils_uint8_array_fini(msg);
-          delete msg;
-          if (fini_return != RCUTILS_RET_OK) {
-            ROSBAG2_TRANSPORT_LOG_ERROR_STREAM(
-              "Failed to destroy serialized message: " << rcutils_get_error_string().str);
-          }
-        });
-      *bag_message->serialized_data = message->release_rcl_serialized_message();
-      bag_message->topic_name = topic_name;
-      rcutils_time_point_value_t time_stamp;
-      int error = rcutils_system_time_now(&time_stamp);
-      if (error != RCUTILS_RET_OK) {
-        ROSBAG2_TRANSPORT_LOG_ERROR_STREAM(
-          "Error getting current time. Error:" << rcutils_get_error_string().str);
+    [this, topic_name, topic_id, sample_every, received_count, sampled_out,
+      deduplicate, last_payload_hash, deduplicated, priority](
+      std::shared_ptr<rclcpp::SerializedMessage> message,
+      const rclcpp::MessageInfo & message_info) {
+      // A paused recording costs exactly this relaxed load per message:
+      // nothing was timestamped, wrapped or allocated yet.
+      if (paused_.load(std::memory_order_relaxed)) {
+        return;
+      }
+      // Every arrival is counted: the rate feeds the history-depth tuning,
+      // and for sampled topics the pre-increment count keeps the first and
+      // then every Nth received message.
+      const auto received = received_count->fetch_add(1, std::memory_order_relaxed);
+      if (sample_every > 1 && received % sample_every != 0) {
+        sampled_out->fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      if (deduplicate) {
+        const auto & payload = message->get_rcl_serialized_message();
+        const auto hash = fnv1a_hash(payload.buffer, payload.buffer_length);
+        // exchange keeps check and update one operation; in the worst
+        // concurrency case a duplicate is recorded, never a change lost.
+        if (last_payload_hash->exchange(hash, std::memory_order_relaxed) == hash) {
+          deduplicated->fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
       }
-      bag_message->time_stamp = time_stamp;
+      ROSBAG2_TRACEPOINT1(recorder_callback, message->size());
+      rosbag2_storage::SerializedBagMessage bag_message;
+      // The bag message shares ownership of the incoming serialized message
+      // and aliases its underlying buffer, so the handover allocates
+      // nothing: no wrapper object and no control block. The buffer returns
+      // to the subscription's intake pool once the write cache is done with
+      // this message.
+      bag_message.serialized_data = std::shared_ptr<rcutils_uint8_array_t>(
+        message, &message->get_rcl_serialized_message());
+      bag_message.topic_name = topic_name;
+      bag_message.topic_id = topic_id;
+      // Use the reception timestamp recorded by the rmw layer: no clock
+      // syscall per message, and no jitter from executor scheduling. Not
+      // every rmw implementation populates it, so fall back to sampling the
+      // system clock when it is zero.
+      rcutils_time_point_value_t time_stamp =
+        message_info.get_rmw_message_info().received_timestamp;
+      if (time_stamp == 0) {
+        int error = rcutils_system_time_now(&time_stamp);
+        if (error != RCUTILS_RET_OK) {
+          ROSBAG2_TRANSPORT_LOG_ERROR_STREAM(
+            "Error getting current time. Error:" << rcutils_get_error_string().str);
+        }
+      }
+      bag_message.time_stamp = time_stamp;
 
-      writer_->write(bag_message);
+      // Stage the message for the drain thread; enqueueing never blocks, so
+      // the callback returns to the rmw layer immediately. try_enqueue fails
+      // when the queue is full, in which case the message is dropped rather
+      // than stalling message delivery.
+      auto & staging_lane = priority ? priority_queue_ : message_queue_;
+      if (!staging_lane.try_enqueue(std::move(bag_message))) {
+        ROSBAG2_TRACEPOINT(recorder_message_dropped);
+        const auto dropped = ++dropped_messages_;
+        if (dropped == 1 || dropped % 1000 == 0) {
+          ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+            "The writer cannot keep up; " << dropped << " messages were dropped so far.");
+        }
+      }
     });
+
+  if (subscription) {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    // Resubscribing (e.g. history-depth retuning) starts fresh counters;
+    // fold the replaced subscription's counts into the baseline so the
+    // reported totals keep accumulating.
+    const auto previous_lost = lost_message_counts_.find(topic_name);
+    if (previous_lost != lost_message_counts_.end()) {
+      lost_messages_baseline_[topic_name] += previous_lost->second->load();
+    }
+    const auto previous_incompatible = incompatible_qos_counts_.find(topic_name);
+    if (previous_incompatible != incompatible_qos_counts_.end()) {
+      incompatible_qos_baseline_[topic_name] += previous_incompatible->second->load();
+    }
+    lost_message_counts_[topic_name] = subscription->messages_lost_count();
+    incompatible_qos_counts_[topic_name] = subscription->incompatible_qos_count();
+  }
   return subscription;
 }
 
+void Recorder::apply_thread_attributes(const std::string & role) const
+{
+  const auto attributes = thread_attributes_.find(role);
+  if (attributes != thread_attributes_.end()) {
+    attributes->second.apply_to_current_thread(role);
+  }
+}
+
+void Recorder::drain_messages()
+{
+  apply_thread_attributes("drain");
+  // With priority topics configured the idle wait on the bulk lane is
+  // shortened: the slice bounds how long a priority message can sit staged
+  // while the bulk lane is empty, at the cost of a few hundred extra
+  // wakeups per second when nothing is arriving at all.
+  const auto wait_slice = priority_topics_.empty() ?
+    std::chrono::milliseconds(100) : std::chrono::milliseconds(2);
+  rosbag2_storage::SerializedBagMessage message;
+  while (!stop_draining_) {
+    // The priority lane is emptied before every bulk write, so a staged
+    // priority message waits for at most one bulk write plus one wait
+    // slice, regardless of how much bulk data is queued behind it.
+    while (priority_queue_.try_dequeue(message)) {
+      write_staged_message(std::move(message));
+    }
+    if (message_queue_.wait_dequeue_timed(message, wait_slice)) {
+      write_staged_message(std::move(message));
+    }
+  }
+  // Persist what is still staged after recording stopped.
+  while (priority_queue_.try_dequeue(message)) {
+    write_staged_message(std::move(message));
+  }
+  while (message_queue_.try_dequeue(message)) {
+    write_staged_message(std::move(message));
+  }
+}
+
+void Recorder::write_staged_message(rosbag2_storage::SerializedBagMessage && message)
+{
+  // Topic and size have to be taken before the writer consumes the message.
+  const auto topic_name = message.topic_name;
+  const auto bytes = message.serialized_data->buffer_length;
+  const bool sample_latency = written_messages_ % kLatencySampleInterval == 0;
+  const auto start = sample_latency ?
+    std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
+  try {
+    writer_->write(std::move(message));
+  } catch (const std::exception & e) {
+    ROSBAG2_TRANSPORT_LOG_ERROR_STREAM("Failed to record message: " << e.what());
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(statistics_mutex_);
+  ++written_messages_;
+  auto & topic_statistics = topic_statistics_[topic_name];
+  ++topic_statistics.messages;
+  topic_statistics.bytes += bytes;
+  if (sample_latency) {
+    const auto latency_us = static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    if (write_latency_samples_us_.size() < kLatencySampleCapacity) {
+      write_latency_samples_us_.push_back(latency_us);
+    } else {
+      write_latency_samples_us_[write_latency_next_++ % kLatencySampleCapacity] = latency_us;
+    }
+  }
+}
+
+void Recorder::publish_statistics()
+{
+  std::vector<uint32_t> latency_samples;
+  YAML::Node topics;
+  uint64_t written_messages = 0;
+  {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    latency_samples = write_latency_samples_us_;
+    written_messages = written_messages_;
+    for (const auto & entry : topic_statistics_) {
+      YAML::Node topic;
+      topic["messages"] = entry.second.messages;
+      topic["bytes"] = entry.second.bytes;
+      topics[entry.first] = topic;
+    }
+    for (const auto & entry : sampled_out_counts_) {
+      topics[entry.first]["sampled_out"] = entry.second->load();
+    }
+    for (const auto & entry : deduplicated_counts_) {
+      topics[entry.first]["deduplicated"] = entry.second->load();
+    }
+    for (const auto & entry : history_depths_) {
+      topics[entry.first]["history_depth"] = static_cast<uint64_t>(entry.second);
+    }
+    for (const auto & entry : lost_message_counts_) {
+      topics[entry.first]["rmw_lost"] =
+        lost_messages_baseline_[entry.first] + entry.second->load();
+    }
+    for (const auto & entry : incompatible_qos_counts_) {
+      topics[entry.first]["incompatible_qos"] =
+        incompatible_qos_baseline_[entry.first] + entry.second->load();
+    }
+  }
+
+  YAML::Node statistics;
+  statistics["paused"] = is_paused();
+  statistics["written_messages"] = written_messages;
+  statistics["dropped_messages"] = dropped_messages_.load();
+  statistics["queue_depth"] = static_cast<uint64_t>(
+    message_queue_.size_approx() + priority_queue_.size_approx());
+  statistics["cache_bytes"] = writer_->get_implementation_handle().get_cache_size();
+  if (!latency_samples.empty()) {
+    YAML::Node latency;
+    latency["p50_us"] = percentile_us(latency_samples, 0.5);
+    latency["p90_us"] = percentile_us(latency_samples, 0.9);
+    latency["p99_us"] = percentile_us(latency_samples, 0.99);
+    latency["samples"] = static_cast<uint64_t>(latency_samples.size());
+    statistics["write_latency"] = latency;
+  }
+  statistics["topics"] = topics;
+
+  std_msgs::msg::String message;
+  message.data = YAML::Dump(statistics);
+  statistics_publisher_->publish(message);
+  ROSBAG2_TRANSPORT_LOG_DEBUG_STREAM("Recorder statistics:\n" << message.data);
+}
+
+void Recorder::retune_history_depths()
+{
+  // Worst write stall observed so far, from the sampled writer latencies.
+  auto worst_stall = std::chrono::duration_cast<std::chrono::microseconds>(kMinimumCoveredStall);
+  {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    if (!write_latency_samples_us_.empty()) {
+      const auto worst_sample_us = *std::max_element(
+        write_latency_samples_us_.begin(), write_latency_samples_us_.end());
+      worst_stall = std::max(worst_stall, std::chrono::microseconds{worst_sample_us});
+    }
+  }
+  const auto covered_stall_seconds = std::chrono::duration<double>(worst_stall).count();
+
+  // Rate measurement and resubscription are separate passes because
+  // create_subscription() registers fresh tuning state for the topic, which
+  // must not happen while subscription_tuning_ is iterated.
+  std::vector<std::pair<std::string, size_t>> topics_to_deepen;
+  const auto now = std::chrono::steady_clock::now();
+  for (auto & entry : subscription_tuning_) {
+    auto & tuning = entry.second;
+    const auto elapsed = std::chrono::duration<double>(now - tuning.last_check).count();
+    if (elapsed <= 0.0) {
+      continue;
+    }
+    const auto received = tuning.received_count->load(std::memory_order_relaxed);
+    const auto rate = static_cast<double>(received - tuning.last_received) / elapsed;
+    if (received != tuning.last_received) {
+      tuning.last_activity = now;
+    }
+    tuning.last_check = now;
+    tuning.last_received = received;
+
+    const auto required_depth = static_cast<size_t>(
+      std::min<double>(
+        static_cast<double>(kMaximumTunedDepth),
+        std::ceil(rate * covered_stall_seconds)));
+    // Depths only ever grow: resubscribing is not free, and a topic that was
+    // fast once can burst again.
+    if (required_depth > tuning.depth) {
+      topics_to_deepen.emplace_back(entry.first, required_depth);
+    }
+  }
+
+  for (const auto & topic_and_depth : topics_to_deepen) {
+    const auto & topic_name = topic_and_depth.first;
+    const auto depth = topic_and_depth.second;
+    auto subscription = subscriptions_.find(topic_name);
+    if (subscription == subscriptions_.end()) {
+      continue;
+    }
+    Rosbag2QoS qos{subscription->second->qos_profile()};
+    qos.keep_last(depth);
+    // Make-before-break: the deeper subscription is created before the old
+    // one is dropped, so the swap cannot lose messages (a few may be
+    // recorded twice during the overlap instant).
+    const auto topic_type = subscription_tuning_[topic_name].topic_type;
+    auto retuned = create_subscription(topic_name, topic_type, qos);
+    if (!retuned) {
+      continue;
+    }
+    subscription->second = retuned;
+    ROSBAG2_TRANSPORT_LOG_INFO_STREAM(
+      "Increased history depth of topic '" << topic_name << "' to " << depth <<
+        " to cover " << covered_stall_seconds << "s of writer stall.");
+  }
+}
+
 void Recorder::record_messages() const
 {
-  spin(node_);
+  // Each subscription lives in its own reentrant callback group, so the
+  // multithreaded executor can handle messages of all topics concurrently;
+  // the writer front-end serializes the actual writes.
+  rclcpp::executors::MultiThreadedExecutor executor;
+  executor.add_node(node_);
+  executor.spin();
 }
 
 std::string Recorder::serialized_offered_qos_profiles_for_topic(const std::string & topic_name)
 {
-  YAML::Node offered_qos_profiles;
+  std::vector<Rosbag2QoS> offered_qos_profiles;
   auto endpoints = node_->get_publishers_info_by_topic(topic_name);
+  offered_qos_profiles.reserve(endpoints.size());
   for (const auto & info : endpoints) {
     offered_qos_profiles.push_back(Rosbag2QoS(info.qos_profile()));
   }
-  return YAML::Dump(offered_qos_profiles);
+  // The compact encoding keeps the repeated discovery polls free of yaml-cpp
+  // emit cost; see serialize_qos_profiles.
+  return serialize_qos_profiles(offered_qos_profiles);
 }
 
 rclcpp::QoS Recorder::subscription_qos_for_topic(const std::string & topic_name) const
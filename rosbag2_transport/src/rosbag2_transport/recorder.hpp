@@ -15,15 +15,30 @@
 #ifndef ROSBAG2_TRANSPORT__RECORDER_HPP_
 #define ROSBAG2_TRANSPORT__RECORDER_HPP_
 
+#include <atomic>
+#include <chrono>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "moodycamel/blockingconcurrentqueue.h"
+
+#include "rclcpp/publisher.hpp"
 #include "rclcpp/qos.hpp"
+#include "rclcpp/service.hpp"
+#include "rclcpp/timer.hpp"
+
+#include "std_msgs/msg/string.hpp"
+#include "rosbag2_interfaces/srv/rotate.hpp"
+#include "std_srvs/srv/trigger.hpp"
+
+#include "rosbag2_storage/serialized_bag_message.hpp"
 
 #include "rosbag2_cpp/writer.hpp"
 
@@ -41,6 +56,7 @@ namespace rosbag2_transport
 
 class GenericSubscription;
 class Rosbag2Node;
+class Rosbag2QoS;
 
 class Recorder
 {
@@ -49,6 +65,29 @@ public:
 
   void record(const RecordOptions & record_options);
 
+  /// Bring recording live without spinning an executor: creates the
+  /// services and publishers, starts the drain thread and kicks off the
+  /// (asynchronous) initial subscription round, then returns. Messages are
+  /// delivered by whichever executor spins the node, so this is the entry
+  /// point for a composed recorder sharing its container's executor.
+  void start(const RecordOptions & record_options);
+
+  /// Counterpart of start(): stops topic discovery, drains and joins the
+  /// writer thread and drops all subscriptions. Blocks until the staged
+  /// messages were handed to the writer.
+  void stop();
+
+  /// Pause the recording: incoming messages are dropped at the top of the
+  /// subscription callbacks (one relaxed atomic load, before timestamping or
+  /// any allocation) while subscriptions and the bag stay open, so resuming
+  /// is instant. Also reachable via the pause/resume services.
+  void pause() {paused_.store(true, std::memory_order_relaxed);}
+
+  /// Resume a paused recording.
+  void resume() {paused_.store(false, std::memory_order_relaxed);}
+
+  bool is_paused() const {return paused_.load(std::memory_order_relaxed);}
+
   const std::unordered_set<std::string> &
   topics_using_fallback_qos() const
   {
@@ -80,11 +119,56 @@ private:
 
   void subscribe_topic(const rosbag2_storage::TopicMetadata & topic);
 
+  // Variant with an explicit subscription QoS, used by the manifest warm
+  // start where the profile comes from the saved offers instead of the
+  // live graph.
+  void subscribe_topic(
+    const rosbag2_storage::TopicMetadata & topic, const Rosbag2QoS & subscription_qos);
+
+  // Creates subscriptions from the topic manifest of a previous session,
+  // before the first graph query. Runs synchronously in start(), so the
+  // discovery round only sees (and skips) the already subscribed topics.
+  // A missing or unreadable manifest is not an error; it merely means a
+  // cold start.
+  void subscribe_from_manifest(const RecordOptions & record_options);
+
+  // Rewrites the topic manifest from the topics actually subscribed in this
+  // session, so the next start warm-starts from a current snapshot. Runs in
+  // stop(), after the discovery thread was joined.
+  void save_topic_manifest();
+
   std::shared_ptr<GenericSubscription> create_subscription(
     const std::string & topic_name, const std::string & topic_type, const rclcpp::QoS & qos);
 
   void record_messages() const;
 
+  // Body of the writer-drain thread: dequeues messages staged by the
+  // subscription callbacks and hands them to the writer. Drains the
+  // remaining messages once recording stopped.
+  void drain_messages();
+
+  // Writes one staged message and updates the runtime statistics.
+  void write_staged_message(rosbag2_storage::SerializedBagMessage && message);
+
+  // Applies the configured affinity and priority of the named thread role
+  // to the calling thread; a no-op for roles without an entry.
+  void apply_thread_attributes(const std::string & role) const;
+
+  // Publishes (and logs) the runtime statistics gathered while recording.
+  // Runs periodically on the executor via statistics_timer_.
+  void publish_statistics();
+
+  // Re-sizes subscription history depths from the measured arrival rates, so
+  // each queue covers the messages arriving during the writer's worst flush
+  // stall. Runs on the discovery thread on every wakeup.
+  void retune_history_depths();
+
+  // Tears down subscriptions which received nothing for the configured idle
+  // window; the topic stays in the bag metadata and get_missing_topics()
+  // resubscribes it when a new publisher appears. Runs on the discovery
+  // thread on every wakeup; a no-op when the timeout is zero.
+  void prune_idle_subscriptions();
+
   /**
    * Find the QoS profile that should be used for subscribing.
    *
@@ -107,6 +191,123 @@ private:
   std::unordered_set<std::string> topics_warned_about_incompatibility_;
   std::string serialization_format_;
   std::unordered_map<std::string, rclcpp::QoS> topic_qos_profile_overrides_;
+  std::unordered_map<std::string, uint64_t> topic_sampling_;
+  std::unordered_set<std::string> topic_deduplication_;
+  // Topics staged into the priority lane instead of the bulk queue; see
+  // RecordOptions::priority_topics.
+  std::unordered_set<std::string> priority_topics_;
+  // Exclusion pattern applied to every topic list before subscribing; see
+  // RecordOptions::topics_regex_to_exclude.
+  std::string topics_regex_to_exclude_;
+  // Path of the topic manifest used for warm starts; empty disables it.
+  std::string topic_manifest_file_;
+  // Metadata of every topic subscribed in this session, keyed by name; the
+  // snapshot save_topic_manifest() writes back. Only filled when a manifest
+  // file is configured. Touched by start() and the discovery thread, never
+  // concurrently: start() subscribes from the manifest before launching
+  // discovery, and stop() saves after joining it.
+  std::unordered_map<std::string, rosbag2_storage::TopicMetadata> manifest_entries_;
+  // Per-role thread affinity and priority, applied when the drain and
+  // discovery threads start.
+  std::unordered_map<std::string, ThreadAttributes> thread_attributes_;
+  // Idle window after which a silent subscription is pruned; zero disables.
+  std::chrono::milliseconds subscription_idle_timeout_ {0};
+  // Publisher count per pruned topic at the time it was pruned; a topic is
+  // only resubscribed once its count grows past this.
+  std::unordered_map<std::string, size_t> pruned_topics_;
+  // Messages discarded by per-topic sampling, counted in the subscription
+  // callbacks and reported with the statistics. The map structure is
+  // guarded by statistics_mutex_; the counters themselves are atomic.
+  std::unordered_map<std::string, std::shared_ptr<std::atomic<uint64_t>>> sampled_out_counts_;
+  // Identical payloads dropped by per-topic deduplication, reported with
+  // the statistics like sampled_out_counts_.
+  std::unordered_map<std::string, std::shared_ptr<std::atomic<uint64_t>>> deduplicated_counts_;
+
+  // Per-topic rmw event counters (messages lost in the middleware and
+  // incompatible-QoS events), shared with the subscriptions, plus baselines
+  // carrying the totals of replaced subscriptions across resubscriptions.
+  // All guarded by statistics_mutex_.
+  std::unordered_map<std::string, std::shared_ptr<const std::atomic<uint64_t>>>
+  lost_message_counts_;
+  std::unordered_map<std::string, std::shared_ptr<const std::atomic<uint64_t>>>
+  incompatible_qos_counts_;
+  std::unordered_map<std::string, uint64_t> lost_messages_baseline_;
+  std::unordered_map<std::string, uint64_t> incompatible_qos_baseline_;
+
+  // Per-subscription state for history-depth auto-tuning: the arrival
+  // counter shared with the callback, the measurement window, and the topic
+  // type needed to resubscribe with a deeper queue. Only touched by the
+  // thread running subscription setup and discovery.
+  struct SubscriptionTuning
+  {
+    std::string topic_type;
+    std::shared_ptr<std::atomic<uint64_t>> received_count;
+    std::chrono::steady_clock::time_point last_check;
+    uint64_t last_received = 0;
+    size_t depth = 0;
+    // When a message was last received (subscription time until the first
+    // one arrives); drives idle-subscription pruning.
+    std::chrono::steady_clock::time_point last_activity;
+  };
+  std::unordered_map<std::string, SubscriptionTuning> subscription_tuning_;
+
+  // History depth currently in effect per topic, reported with the
+  // statistics. Guarded by statistics_mutex_.
+  std::unordered_map<std::string, size_t> history_depths_;
+
+  // Bounded staging queue between the subscription callbacks and the drain
+  // thread. Callbacks only enqueue and return to the rmw layer immediately,
+  // so storage latency never backs up into message delivery.
+  moodycamel::BlockingConcurrentQueue<rosbag2_storage::SerializedBagMessage> message_queue_;
+  // Second staging lane for the priority topics; the drain thread empties
+  // it before every bulk write, so priority messages overtake staged bulk
+  // data instead of queueing behind it.
+  moodycamel::BlockingConcurrentQueue<rosbag2_storage::SerializedBagMessage> priority_queue_;
+  std::thread drain_thread_;
+  std::atomic<bool> stop_draining_{false};
+  std::atomic<uint64_t> dropped_messages_{0};
+
+  // The initial subscription round, and with discovery enabled the whole
+  // discovery loop, runs on this future; stop() waits for it after raising
+  // stop_discovery_, which ends the loop without waiting for shutdown.
+  std::future<void> discovery_future_;
+  std::atomic<bool> stop_discovery_{false};
+
+  struct TopicStatistics
+  {
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+  };
+
+  // Runtime statistics, updated by the drain thread and read by the
+  // statistics timer. The mutex is uncontended outside of the publishing
+  // instant, so the per-message cost is a single cheap lock.
+  std::mutex statistics_mutex_;
+  std::unordered_map<std::string, TopicStatistics> topic_statistics_;
+  // Ring buffer of sampled writer latencies, in microseconds.
+  std::vector<uint32_t> write_latency_samples_us_;
+  size_t write_latency_next_{0};
+  uint64_t written_messages_{0};
+
+  rclcpp::Publisher<std_msgs::msg::String>::SharedPtr statistics_publisher_;
+  rclcpp::TimerBase::SharedPtr statistics_timer_;
+
+  // Whether the recording is paused; checked first thing in every
+  // subscription callback.
+  std::atomic<bool> paused_{false};
+
+  // Forwards on-demand split requests to the writer.
+  rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr split_service_;
+  // Seals the current bag and continues recording into a new base folder
+  // (e.g. the next hourly directory or a freshly mounted disk) without
+  // touching the subscriptions.
+  rclcpp::Service<rosbag2_interfaces::srv::Rotate>::SharedPtr rotate_service_;
+  // Toggle the paused state defined above.
+  rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr pause_service_;
+  rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr resume_service_;
+  // Announces every sealed bagfile, so post-processing or upload pipelines
+  // can pick up closed splits while the recording continues.
+  rclcpp::Publisher<std_msgs::msg::String>::SharedPtr events_publisher_;
 };
 
 }  // namespace rosbag2_transport
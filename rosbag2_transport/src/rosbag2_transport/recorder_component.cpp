@@ -0,0 +1,205 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "recorder_component.hpp"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rclcpp_components/register_node_macro.hpp"
+#include "rmw/rmw.h"
+
+#include "rosbag2_compression/compression_options.hpp"
+#include "rosbag2_compression/sequential_compression_writer.hpp"
+
+#include "rosbag2_cpp/writers/sequential_writer.hpp"
+#include "rosbag2_cpp/writers/sharded_sequential_writer.hpp"
+
+#include "rosbag2_transport/logging.hpp"
+
+namespace rosbag2_transport
+{
+
+RecorderComponent::RecorderComponent(const rclcpp::NodeOptions & options)
+: Rosbag2Node("rosbag2_recorder", options)
+{
+  // Storage options.
+  declare_parameter<std::string>("uri", "");
+  declare_parameter<std::string>("storage_id", "sqlite3");
+  declare_parameter<std::string>("storage_config_uri", "");
+  declare_parameter<int64_t>("max_bagfile_size", 0);
+  declare_parameter<int64_t>("max_bagfile_duration", 0);
+  declare_parameter<int64_t>("max_cache_size", 0);
+  declare_parameter<int64_t>("storage_shards", 1);
+  // Record options.
+  declare_parameter<bool>("all", true);
+  declare_parameter<std::vector<std::string>>("topics", std::vector<std::string>{});
+  declare_parameter<bool>("include_hidden_topics", false);
+  declare_parameter<std::string>("serialization_format", "");
+  declare_parameter<bool>("no_discovery", false);
+  declare_parameter<int64_t>("topic_polling_interval_ms", 100);
+  declare_parameter<std::string>("compression_mode", "");
+  declare_parameter<std::string>("compression_format", "");
+  declare_parameter<bool>("autostart", true);
+
+  start_service_ = create_service<std_srvs::srv::Trigger>(
+    "~/start_recording",
+    [this](
+      const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+      std::shared_ptr<std_srvs::srv::Trigger::Response> response) {
+      (void) request;
+      std::string error;
+      response->success = start_recording(error);
+      response->message = error;
+    });
+  stop_service_ = create_service<std_srvs::srv::Trigger>(
+    "~/stop_recording",
+    [this](
+      const std::shared_ptr<std_srvs::srv::Trigger::Request> request,
+      std::shared_ptr<std_srvs::srv::Trigger::Response> response) {
+      (void) request;
+      std::string error;
+      response->success = stop_recording(error);
+      response->message = error;
+    });
+
+  if (get_parameter("autostart").as_bool()) {
+    // The recorder needs a shared_ptr to this node, which only exists once
+    // construction finished; a zero-delay one-shot timer defers the start
+    // to the first turn of the container's executor.
+    autostart_timer_ = create_wall_timer(
+      std::chrono::milliseconds(0),
+      [this]() {
+        autostart_timer_->cancel();
+        std::string error;
+        if (!start_recording(error)) {
+          ROSBAG2_TRANSPORT_LOG_ERROR_STREAM("Could not start recording: " << error);
+        }
+      });
+  }
+}
+
+RecorderComponent::~RecorderComponent()
+{
+  std::string error;
+  stop_recording(error);
+}
+
+rosbag2_cpp::StorageOptions RecorderComponent::storage_options_from_parameters()
+{
+  rosbag2_cpp::StorageOptions storage_options;
+  storage_options.uri = get_parameter("uri").as_string();
+  storage_options.storage_id = get_parameter("storage_id").as_string();
+  storage_options.storage_config_uri = get_parameter("storage_config_uri").as_string();
+  storage_options.max_bagfile_size =
+    static_cast<uint64_t>(get_parameter("max_bagfile_size").as_int());
+  storage_options.max_bagfile_duration =
+    static_cast<uint64_t>(get_parameter("max_bagfile_duration").as_int());
+  storage_options.max_cache_size =
+    static_cast<uint64_t>(get_parameter("max_cache_size").as_int());
+  storage_options.storage_shard_count =
+    static_cast<uint64_t>(get_parameter("storage_shards").as_int());
+  return storage_options;
+}
+
+RecordOptions RecorderComponent::record_options_from_parameters()
+{
+  RecordOptions record_options;
+  record_options.all = get_parameter("all").as_bool();
+  record_options.topics = get_parameter("topics").as_string_array();
+  record_options.include_hidden_topics = get_parameter("include_hidden_topics").as_bool();
+  record_options.is_discovery_disabled = get_parameter("no_discovery").as_bool();
+  record_options.topic_polling_interval =
+    std::chrono::milliseconds(get_parameter("topic_polling_interval_ms").as_int());
+  record_options.compression_mode = get_parameter("compression_mode").as_string();
+  record_options.compression_format = get_parameter("compression_format").as_string();
+  const auto serialization_format = get_parameter("serialization_format").as_string();
+  record_options.rmw_serialization_format =
+    serialization_format.empty() ? rmw_get_serialization_format() : serialization_format;
+  return record_options;
+}
+
+bool RecorderComponent::start_recording(std::string & error)
+{
+  std::lock_guard<std::mutex> lock(recording_mutex_);
+  if (recorder_) {
+    error = "Recording is already running.";
+    return false;
+  }
+
+  const auto storage_options = storage_options_from_parameters();
+  const auto record_options = record_options_from_parameters();
+  if (storage_options.uri.empty()) {
+    error = "The 'uri' parameter must name the bag directory to record into.";
+    return false;
+  }
+
+  try {
+    // Same writer selection as the standalone record flow.
+    if (storage_options.storage_shard_count > 1) {
+      if (!record_options.compression_format.empty()) {
+        error = "Storage sharding cannot be combined with compression.";
+        return false;
+      }
+      writer_ = std::make_shared<rosbag2_cpp::Writer>(
+        std::make_unique<rosbag2_cpp::writers::ShardedSequentialWriter>());
+    } else if (!record_options.compression_format.empty()) {
+      rosbag2_compression::CompressionOptions compression_options{};
+      compression_options.compression_format = record_options.compression_format;
+      compression_options.compression_mode =
+        rosbag2_compression::compression_mode_from_string(record_options.compression_mode);
+      writer_ = std::make_shared<rosbag2_cpp::Writer>(
+        std::make_unique<rosbag2_compression::SequentialCompressionWriter>(compression_options));
+    } else {
+      writer_ = std::make_shared<rosbag2_cpp::Writer>(
+        std::make_unique<rosbag2_cpp::writers::SequentialWriter>());
+    }
+    writer_->open(
+      storage_options,
+      {rmw_get_serialization_format(), record_options.rmw_serialization_format});
+
+    recorder_ = std::make_shared<Recorder>(
+      writer_, std::static_pointer_cast<Rosbag2Node>(shared_from_this()));
+    recorder_->start(record_options);
+  } catch (const std::exception & e) {
+    recorder_.reset();
+    writer_.reset();
+    error = e.what();
+    return false;
+  }
+  ROSBAG2_TRANSPORT_LOG_INFO_STREAM("Recording into '" << storage_options.uri << "'.");
+  return true;
+}
+
+bool RecorderComponent::stop_recording(std::string & error)
+{
+  std::lock_guard<std::mutex> lock(recording_mutex_);
+  if (!recorder_) {
+    error = "No recording is running.";
+    return false;
+  }
+  recorder_->stop();
+  recorder_.reset();
+  // Closing the writer seals the bag and writes the final metadata.
+  writer_.reset();
+  ROSBAG2_TRANSPORT_LOG_INFO("Recording stopped.");
+  return true;
+}
+
+}  // namespace rosbag2_transport
+
+RCLCPP_COMPONENTS_REGISTER_NODE(rosbag2_transport::RecorderComponent)
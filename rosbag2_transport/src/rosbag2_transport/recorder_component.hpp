@@ -0,0 +1,86 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROSBAG2_TRANSPORT__RECORDER_COMPONENT_HPP_
+#define ROSBAG2_TRANSPORT__RECORDER_COMPONENT_HPP_
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "rclcpp/node_options.hpp"
+#include "rclcpp/service.hpp"
+#include "rclcpp/timer.hpp"
+#include "std_srvs/srv/trigger.hpp"
+
+#include "rosbag2_cpp/storage_options.hpp"
+#include "rosbag2_cpp/writer.hpp"
+
+#include "rosbag2_transport/record_options.hpp"
+
+#include "recorder.hpp"
+#include "rosbag2_node.hpp"
+
+namespace rosbag2_transport
+{
+
+/**
+ * A recorder packaged as an rclcpp component, so recording can be composed
+ * into the same process as the data producers and intra-process or
+ * shared-memory transports deliver serialized messages to the recorder
+ * without crossing the network loopback.
+ *
+ * The component never spins its own executor; its subscriptions are served
+ * by the container's executor. RecordOptions and StorageOptions are taken
+ * from node parameters (uri, storage_id, all, topics, ...), recording
+ * starts automatically unless the `autostart` parameter is false, and the
+ * `~/start_recording` / `~/stop_recording` services manage the recording
+ * lifecycle at runtime. Stopping closes and seals the bag; a subsequent
+ * start records into a fresh bag under the configured uri.
+ */
+class RecorderComponent : public Rosbag2Node
+{
+public:
+  explicit RecorderComponent(const rclcpp::NodeOptions & options);
+  ~RecorderComponent() override;
+
+private:
+  // Opens the writer from the current parameter values and brings the
+  // recorder live. Returns false with a reason when recording is already
+  // running or the parameters are unusable.
+  bool start_recording(std::string & error);
+  // Stops the recorder and closes the bag. Returns false when no recording
+  // is running.
+  bool stop_recording(std::string & error);
+
+  rosbag2_cpp::StorageOptions storage_options_from_parameters();
+  RecordOptions record_options_from_parameters();
+
+  // Guards the recording state against concurrent service calls.
+  std::mutex recording_mutex_;
+  std::shared_ptr<rosbag2_cpp::Writer> writer_;
+  // Holds a reference back to this node; reset on stop so the cycle does
+  // not keep a removed component alive.
+  std::shared_ptr<Recorder> recorder_;
+
+  rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr start_service_;
+  rclcpp::Service<std_srvs::srv::Trigger>::SharedPtr stop_service_;
+  // One-shot timer deferring the autostart until the node is held by a
+  // shared_ptr, which the recorder needs and a constructor cannot provide.
+  rclcpp::TimerBase::SharedPtr autostart_timer_;
+};
+
+}  // namespace rosbag2_transport
+
+#endif  // ROSBAG2_TRANSPORT__RECORDER_COMPONENT_HPP_
@@ -41,13 +41,19 @@ Rosbag2Node::Rosbag2Node(const std::string & node_name, const rclcpp::NodeOption
 : rclcpp::Node(node_name, options)
 {}
 
+std::shared_ptr<rcpputils::SharedLibrary> Rosbag2Node::get_typesupport_library_for_type(
+  const std::string & type)
+{
+  // Warm the process-wide typesupport registry, so publishers and
+  // subscriptions created later find the type's handle already resolved.
+  rosbag2_cpp::get_typesupport_handle(type, "rosidl_typesupport_cpp");
+  return rosbag2_cpp::get_typesupport_library(type, "rosidl_typesupport_cpp");
+}
+
 std::shared_ptr<GenericPublisher> Rosbag2Node::create_generic_publisher(
   const std::string & topic, const std::string & type, const rclcpp::QoS & qos)
 {
-  library_generic_publisher_ = rosbag2_cpp::get_typesupport_library(
-    type, "rosidl_typesupport_cpp");
-  auto type_support = rosbag2_cpp::get_typesupport_handle(
-    type, "rosidl_typesupport_cpp", library_generic_publisher_);
+  auto type_support = rosbag2_cpp::get_typesupport_handle(type, "rosidl_typesupport_cpp");
   return std::make_shared<GenericPublisher>(
     get_node_base_interface().get(), *type_support, topic, qos);
 }
@@ -56,12 +62,10 @@ std::shared_ptr<GenericSubscription> Rosbag2Node::create_generic_subscription(
   const std::string & topic,
   const std::string & type,
   const rclcpp::QoS & qos,
-  std::function<void(std::shared_ptr<rclcpp::SerializedMessage>)> callback)
+  std::function<void(std::shared_ptr<rclcpp::SerializedMessage>,
+  const rclcpp::MessageInfo &)> callback)
 {
-  library_generic_subscriptor_ = rosbag2_cpp::get_typesupport_library(
-    type, "rosidl_typesupport_cpp");
-  auto type_support = rosbag2_cpp::get_typesupport_handle(
-    type, "rosidl_typesupport_cpp", library_generic_subscriptor_);
+  auto type_support = rosbag2_cpp::get_typesupport_handle(type, "rosidl_typesupport_cpp");
   auto subscription = std::shared_ptr<GenericSubscription>();
 
   try {
@@ -72,7 +76,12 @@ std::shared_ptr<GenericSubscription> Rosbag2Node::create_generic_subscription(
       qos,
       callback);
 
-    get_node_topics_interface()->add_subscription(subscription, nullptr);
+    // Give every subscription its own reentrant callback group, so that a
+    // multithreaded executor may run callbacks of different subscriptions
+    // (and queued messages of the same subscription) concurrently.
+    auto callback_group = create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+    subscription_callback_groups_.push_back(callback_group);
+    get_node_topics_interface()->add_subscription(subscription, callback_group);
   } catch (const std::runtime_error & ex) {
     ROSBAG2_TRANSPORT_LOG_ERROR_STREAM(
       "Error subscribing to topic '" << topic << "'. Error: " << ex.what());
@@ -21,6 +21,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "rclcpp/message_info.hpp"
 #include "rclcpp/node.hpp"
 #include "rclcpp/serialized_message.hpp"
 #include "rclcpp/node_options.hpp"
@@ -51,7 +52,14 @@ public:
     const std::string & topic,
     const std::string & type,
     const rclcpp::QoS & qos,
-    std::function<void(std::shared_ptr<rclcpp::SerializedMessage>)> callback);
+    std::function<void(std::shared_ptr<rclcpp::SerializedMessage>,
+    const rclcpp::MessageInfo &)> callback);
+
+  /// Load the typesupport library for a message type and warm the
+  /// process-wide typesupport registry shared with readers and writers.
+  /// Thread-safe.
+  std::shared_ptr<rcpputils::SharedLibrary>
+  get_typesupport_library_for_type(const std::string & type);
 
   std::unordered_map<std::string, std::string>
   get_topics_with_types(const std::vector<std::string> & topic_names);
@@ -68,8 +76,9 @@ public:
     bool include_hidden_topics = false);
 
 private:
-  std::shared_ptr<rcpputils::SharedLibrary> library_generic_subscriptor_;
-  std::shared_ptr<rcpputils::SharedLibrary> library_generic_publisher_;
+  // The node base only holds weak references to callback groups, so the
+  // per-subscription groups must be kept alive here.
+  std::vector<rclcpp::CallbackGroup::SharedPtr> subscription_callback_groups_;
 };
 
 }  // namespace rosbag2_transport
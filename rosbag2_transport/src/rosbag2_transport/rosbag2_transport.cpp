@@ -15,6 +15,7 @@
 
 #include "rosbag2_transport/rosbag2_transport.hpp"
 
+#include <future>
 #include <memory>
 #include <queue>
 #include <string>
@@ -78,10 +79,20 @@ void Rosbag2Transport::record(
   const StorageOptions & storage_options, const RecordOptions & record_options)
 {
   try {
-    writer_->open(
-      storage_options, {rmw_get_serialization_format(), record_options.rmw_serialization_format});
+    // Opening the bag (storage plugin discovery, database creation,
+    // preallocation) and standing up the node (participant creation, start
+    // of peer discovery) are independent; overlapping them shortens the
+    // window between the record command and the first live subscription.
+    auto open_future = std::async(
+      std::launch::async, [this, &storage_options, &record_options]() {
+        writer_->open(
+          storage_options,
+          {rmw_get_serialization_format(), record_options.rmw_serialization_format});
+      });
 
     auto transport_node = setup_node(record_options.node_prefix);
+    // Subscribing needs the open writer; this rethrows open failures.
+    open_future.get();
 
     Recorder recorder(writer_, transport_node);
     recorder.record(record_options);
@@ -127,7 +138,8 @@ void Rosbag2Transport::reindex(
   }
 }
 
-void Rosbag2Transport::print_bag_info(const std::string & uri, const std::string & storage_id)
+void Rosbag2Transport::print_bag_info(
+  const std::string & uri, const std::string & storage_id, bool verbose)
 {
   rosbag2_storage::BagMetadata metadata;
   try {
@@ -142,6 +154,15 @@ void Rosbag2Transport::print_bag_info(const std::string & uri, const std::string
   }
 
   Formatter::format_bag_meta_data(metadata);
+
+  if (verbose) {
+    try {
+      Formatter::format_topic_statistics(info_->read_topic_statistics(uri, storage_id));
+    } catch (const std::runtime_error & e) {
+      ROSBAG2_TRANSPORT_LOG_ERROR_STREAM(
+        "Could not aggregate topic statistics for " << uri << ": " << e.what());
+    }
+  }
 }
 
 }  // namespace rosbag2_transport
@@ -26,11 +26,14 @@
 #include "rosbag2_compression/compression_options.hpp"
 #include "rosbag2_compression/sequential_compression_reader.hpp"
 #include "rosbag2_compression/sequential_compression_writer.hpp"
+#include "rosbag2_cpp/bag_converter.hpp"
 #include "rosbag2_cpp/info.hpp"
 #include "rosbag2_cpp/reader.hpp"
 #include "rosbag2_cpp/readers/sequential_reader.hpp"
 #include "rosbag2_cpp/writer.hpp"
 #include "rosbag2_cpp/writers/sequential_writer.hpp"
+#include "rosbag2_cpp/writers/sharded_sequential_writer.hpp"
+#include "rosbag2_cpp/writers/shm_relay_writer.hpp"
 #include "rosbag2_cpp/reindexer.hpp"
 #include "rosbag2_cpp/reindexers/sequential_reindexer.hpp"
 #include "rosbag2_storage/metadata_io.hpp"
@@ -105,6 +108,13 @@ rosbag2_transport_record(PyObject * Py_UNUSED(self), PyObject * args, PyObject *
     "topics",
     "include_hidden_topics",
     "qos_profile_overrides",
+    "storage_config_file",
+    "compression_level",
+    "compression_threads",
+    "storage_shards",
+    "split_writer_process",
+    "exclude_topics_regex",
+    "subscription_idle_timeout",
     nullptr};
 
   char * uri = nullptr;
@@ -122,9 +132,16 @@ rosbag2_transport_record(PyObject * Py_UNUSED(self), PyObject * args, PyObject *
   uint64_t max_cache_size = 0u;
   PyObject * topics = nullptr;
   bool include_hidden_topics = false;
+  char * storage_config_file = nullptr;
+  int compression_level = 1;
+  int compression_threads = -1;
+  unsigned long long storage_shards = 1;  // NOLINT
+  bool split_writer_process = false;
+  char * exclude_topics_regex = nullptr;
+  unsigned long long subscription_idle_timeout_ms = 0;  // NOLINT
   if (
     !PyArg_ParseTupleAndKeywords(
-      args, kwargs, "ssssss|bbKKKKObO", const_cast<char **>(kwlist),
+      args, kwargs, "ssssss|bbKKKKObOsiiKbsK", const_cast<char **>(kwlist),
       &uri,
       &storage_id,
       &serilization_format,
@@ -139,7 +156,14 @@ rosbag2_transport_record(PyObject * Py_UNUSED(self), PyObject * args, PyObject *
       &max_cache_size,
       &topics,
       &include_hidden_topics,
-      &qos_profile_overrides
+      &qos_profile_overrides,
+      &storage_config_file,
+      &compression_level,
+      &compression_threads,
+      &storage_shards,
+      &split_writer_process,
+      &exclude_topics_regex,
+      &subscription_idle_timeout_ms
   ))
   {
     return nullptr;
@@ -150,6 +174,10 @@ rosbag2_transport_record(PyObject * Py_UNUSED(self), PyObject * args, PyObject *
   storage_options.max_bagfile_size = (uint64_t) max_bagfile_size;
   storage_options.max_bagfile_duration = static_cast<uint64_t>(max_bagfile_duration);
   storage_options.max_cache_size = max_cache_size;
+  storage_options.storage_shard_count = static_cast<uint64_t>(storage_shards);
+  if (storage_config_file) {
+    storage_options.storage_config_uri = std::string(storage_config_file);
+  }
   record_options.all = all;
   record_options.is_discovery_disabled = no_discovery;
   record_options.topic_polling_interval = std::chrono::milliseconds(polling_interval_ms);
@@ -157,10 +185,17 @@ rosbag2_transport_record(PyObject * Py_UNUSED(self), PyObject * args, PyObject *
   record_options.compression_mode = std::string(compression_mode);
   record_options.compression_format = compression_format;
   record_options.include_hidden_topics = include_hidden_topics;
+  if (exclude_topics_regex) {
+    record_options.topics_regex_to_exclude = std::string(exclude_topics_regex);
+  }
+  record_options.subscription_idle_timeout =
+    std::chrono::milliseconds(subscription_idle_timeout_ms);
 
   rosbag2_compression::CompressionOptions compression_options{
     record_options.compression_format,
-    rosbag2_compression::compression_mode_from_string(record_options.compression_mode)
+    rosbag2_compression::compression_mode_from_string(record_options.compression_mode),
+    compression_level,
+    compression_threads
   };
 
   auto topic_qos_overrides = PyObject_AsTopicQoSMap(qos_profile_overrides);
@@ -190,7 +225,28 @@ rosbag2_transport_record(PyObject * Py_UNUSED(self), PyObject * args, PyObject *
     std::make_unique<rosbag2_cpp::reindexers::SequentialReindexer>());
   std::shared_ptr<rosbag2_cpp::Writer> writer;
   // Change writer based on recording options
-  if (record_options.compression_format == "zstd") {
+  if (split_writer_process) {
+    if (!record_options.compression_format.empty()) {
+      PyErr_SetString(
+        PyExc_ValueError, "The split writer process cannot be combined with compression.");
+      return nullptr;
+    }
+    if (storage_options.storage_shard_count > 1) {
+      PyErr_SetString(
+        PyExc_ValueError, "The split writer process cannot be combined with storage sharding.");
+      return nullptr;
+    }
+    writer = std::make_shared<rosbag2_cpp::Writer>(
+      std::make_unique<rosbag2_cpp::writers::ShmRelayWriter>());
+  } else if (storage_options.storage_shard_count > 1) {
+    if (!record_options.compression_format.empty()) {
+      PyErr_SetString(
+        PyExc_ValueError, "Storage sharding cannot be combined with compression.");
+      return nullptr;
+    }
+    writer = std::make_shared<rosbag2_cpp::Writer>(
+      std::make_unique<rosbag2_cpp::writers::ShardedSequentialWriter>());
+  } else if (!record_options.compression_format.empty()) {
     writer = std::make_shared<rosbag2_cpp::Writer>(
       std::make_unique<rosbag2_compression::SequentialCompressionWriter>(compression_options));
   } else {
@@ -241,6 +297,18 @@ rosbag2_transport_play(PyObject * Py_UNUSED(self), PyObject * args, PyObject * k
     "qos_profile_overrides",
     "loop",
     "topic_remapping",
+    "start_time",
+    "end_time",
+    "topics_regex",
+    "topics_regex_exclude",
+    "loop_cache_size",
+    "clock_publish_frequency",
+    "as_fast_as_possible",
+    "reverse",
+    "start_offset",
+    "playback_duration",
+    "decompress_to",
+    "read_ahead_byte_budget",
     nullptr
   };
 
@@ -253,8 +321,20 @@ rosbag2_transport_play(PyObject * Py_UNUSED(self), PyObject * args, PyObject * k
   PyObject * qos_profile_overrides{nullptr};
   bool loop = false;
   PyObject * topic_remapping = nullptr;
+  int64_t start_time = -1;
+  int64_t end_time = -1;
+  char * topics_regex = nullptr;
+  char * topics_regex_exclude = nullptr;
+  unsigned long long loop_cache_size = 0;  // NOLINT
+  double clock_publish_frequency = 0.0;
+  bool as_fast_as_possible = false;
+  bool reverse = false;
+  int64_t start_offset = 0;
+  int64_t playback_duration = -1;
+  char * decompress_to = nullptr;
+  unsigned long long read_ahead_byte_budget = 0;  // NOLINT
   if (!PyArg_ParseTupleAndKeywords(
-      args, kwargs, "sss|kfOObO", const_cast<char **>(kwlist),
+      args, kwargs, "sss|kfOObOLLssKdbbLLsK", const_cast<char **>(kwlist),
       &uri,
       &storage_id,
       &node_prefix,
@@ -263,18 +343,48 @@ rosbag2_transport_play(PyObject * Py_UNUSED(self), PyObject * args, PyObject * k
       &topics,
       &qos_profile_overrides,
       &loop,
-      &topic_remapping))
+      &topic_remapping,
+      &start_time,
+      &end_time,
+      &topics_regex,
+      &topics_regex_exclude,
+      &loop_cache_size,
+      &clock_publish_frequency,
+      &as_fast_as_possible,
+      &reverse,
+      &start_offset,
+      &playback_duration,
+      &decompress_to,
+      &read_ahead_byte_budget))
   {
     return nullptr;
   }
 
   storage_options.uri = std::string(uri);
   storage_options.storage_id = std::string(storage_id);
+  if (decompress_to) {
+    storage_options.decompression_scratch_directory = decompress_to;
+  }
 
   play_options.node_prefix = std::string(node_prefix);
   play_options.read_ahead_queue_size = read_ahead_queue_size;
+  play_options.read_ahead_byte_budget = read_ahead_byte_budget;
   play_options.rate = rate;
   play_options.loop = loop;
+  play_options.loop_cache_size = loop_cache_size;
+  play_options.clock_publish_frequency = clock_publish_frequency;
+  play_options.as_fast_as_possible = as_fast_as_possible;
+  play_options.reverse = reverse;
+  play_options.start_offset = start_offset;
+  play_options.playback_duration = playback_duration;
+  play_options.start_time = start_time;
+  play_options.end_time = end_time;
+  if (topics_regex) {
+    play_options.topics_regex_to_filter = topics_regex;
+  }
+  if (topics_regex_exclude) {
+    play_options.topics_regex_to_exclude = topics_regex_exclude;
+  }
 
   if (topics) {
     PyObject * topic_iterator = PyObject_GetIter(topics);
@@ -329,12 +439,13 @@ rosbag2_transport_play(PyObject * Py_UNUSED(self), PyObject * args, PyObject * k
 static PyObject *
 rosbag2_transport_info(PyObject * Py_UNUSED(self), PyObject * args, PyObject * kwargs)
 {
-  static const char * kwlist[] = {"uri", "storage_id", nullptr};
+  static const char * kwlist[] = {"uri", "storage_id", "verbose", nullptr};
 
   char * char_uri;
   char * char_storage_id;
+  int verbose = 0;
   if (!PyArg_ParseTupleAndKeywords(
-      args, kwargs, "ss", const_cast<char **>(kwlist), &char_uri, &char_storage_id))
+      args, kwargs, "ss|p", const_cast<char **>(kwlist), &char_uri, &char_storage_id, &verbose))
   {
     return nullptr;
   }
@@ -343,7 +454,7 @@ rosbag2_transport_info(PyObject * Py_UNUSED(self), PyObject * args, PyObject * k
   std::string storage_id = std::string(char_storage_id);
 
   rosbag2_transport::Rosbag2Transport transport;
-  transport.print_bag_info(uri, storage_id);
+  transport.print_bag_info(uri, storage_id, verbose != 0);
 
   Py_RETURN_NONE;
 }
@@ -404,6 +515,53 @@ rosbag2_transport_reindex(PyObject * Py_UNUSED(self), PyObject * args, PyObject
   Py_RETURN_NONE;
 }
 
+static PyObject *
+rosbag2_transport_convert(PyObject * Py_UNUSED(self), PyObject * args, PyObject * kwargs)
+{
+  static const char * kwlist[] = {
+    "in_uri",
+    "in_storage_id",
+    "out_uri",
+    "out_storage_id",
+    "serialization_format",
+    "workers",
+    nullptr
+  };
+
+  char * in_uri = nullptr;
+  char * in_storage_id = nullptr;
+  char * out_uri = nullptr;
+  char * out_storage_id = nullptr;
+  char * serialization_format = nullptr;
+  unsigned long long workers = 0;  // NOLINT
+  if (!PyArg_ParseTupleAndKeywords(
+      args, kwargs, "sssss|K", const_cast<char **>(kwlist),
+      &in_uri,
+      &in_storage_id,
+      &out_uri,
+      &out_storage_id,
+      &serialization_format,
+      &workers))
+  {
+    return nullptr;
+  }
+
+  rosbag2_cpp::BagConverter::Options options{};
+  options.input_storage_options.uri = std::string(in_uri);
+  options.input_storage_options.storage_id = std::string(in_storage_id);
+  options.output_storage_options.uri = std::string(out_uri);
+  options.output_storage_options.storage_id = std::string(out_storage_id);
+  options.output_serialization_format = std::string(serialization_format).empty() ?
+    rmw_get_serialization_format() :
+    serialization_format;
+  options.worker_count = workers;
+
+  rosbag2_cpp::BagConverter converter(options);
+  converter.run();
+
+  Py_RETURN_NONE;
+}
+
 /// Define the public methods of this module
 #if __GNUC__ >= 8
 # pragma GCC diagnostic push
@@ -428,6 +586,12 @@ static PyMethodDef rosbag2_transport_methods[] = {
     METH_VARARGS | METH_KEYWORDS,
     "Reindex bag"
   },
+  {
+    "convert",
+    reinterpret_cast<PyCFunction>(rosbag2_transport_convert),
+    METH_VARARGS | METH_KEYWORDS,
+    "Convert bag serialization format"
+  },
   {nullptr, nullptr, 0, nullptr}  /* sentinel */
 };
 #if __GNUC__ >= 8
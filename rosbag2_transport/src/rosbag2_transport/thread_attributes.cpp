@@ -0,0 +1,76 @@
+// Copyright 2018, Bosch Software Innovations GmbH.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rosbag2_transport/thread_attributes.hpp"
+
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
+#endif
+
+#include "rosbag2_transport/logging.hpp"
+
+namespace rosbag2_transport
+{
+
+#ifdef __linux__
+void ThreadAttributes::apply_to_current_thread(const std::string & role) const
+{
+  if (!cpu_affinity.empty()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (const int cpu : cpu_affinity) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &cpus);
+      } else {
+        ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+          "Ignoring out-of-range CPU " << cpu << " in the affinity of the '" <<
+            role << "' thread.");
+      }
+    }
+    const int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (result != 0) {
+      ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+        "Could not set the CPU affinity of the '" << role << "' thread: " <<
+          std::strerror(result));
+    }
+  }
+  if (realtime_priority > 0) {
+    sched_param param{};
+    param.sched_priority = realtime_priority;
+    const int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0) {
+      // The usual cause: the process lacks CAP_SYS_NICE and has no rtprio
+      // rlimit. The thread keeps running at regular priority.
+      ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+        "Could not set SCHED_FIFO priority " << realtime_priority << " on the '" <<
+          role << "' thread: " << std::strerror(result));
+    }
+  }
+}
+#else
+void ThreadAttributes::apply_to_current_thread(const std::string & role) const
+{
+  if (!cpu_affinity.empty() || realtime_priority > 0) {
+    ROSBAG2_TRANSPORT_LOG_WARN_STREAM(
+      "Thread affinity and priority are only supported on Linux; the '" <<
+        role << "' thread keeps the default scheduling.");
+  }
+}
+#endif
+
+}  // namespace rosbag2_transport
@@ -106,6 +106,87 @@ TEST_F(RosBag2PlayTestFixture, recorded_messages_are_played_for_all_topics)
           ElementsAre(40.0f, 2.0f, 0.0f)))));
 }
 
+TEST_F(RosBag2PlayTestFixture, all_messages_are_played_with_a_read_ahead_byte_budget)
+{
+  auto primitive_message1 = get_messages_basic_types()[0];
+  primitive_message1->int32_value = 42;
+
+  auto topic_types = std::vector<rosbag2_storage::TopicMetadata>{
+    {"topic1", "test_msgs/BasicTypes", "", ""},
+  };
+
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages =
+  {serialize_test_message("topic1", 500, primitive_message1),
+    serialize_test_message("topic1", 600, primitive_message1),
+    serialize_test_message("topic1", 700, primitive_message1),
+    serialize_test_message("topic1", 800, primitive_message1)};
+
+  auto prepared_mock_reader = std::make_unique<MockSequentialReader>();
+  prepared_mock_reader->prepare(messages, topic_types);
+  reader_ = std::make_unique<rosbag2_cpp::Reader>(std::move(prepared_mock_reader));
+
+  // A budget far below the size of the bag forces the loader through
+  // several byte-bounded refills; every message must still be played.
+  play_options_.read_ahead_byte_budget = 1;
+
+  sub_->add_subscription<test_msgs::msg::BasicTypes>("/topic1", 3);
+
+  auto await_received_messages = sub_->spin_subscriptions();
+
+  Rosbag2Transport rosbag2_transport(reader_, writer_, info_, reindexer_);
+  rosbag2_transport.play(storage_options_, play_options_);
+
+  await_received_messages.get();
+
+  auto replayed_test_primitives = sub_->get_received_messages<test_msgs::msg::BasicTypes>(
+    "/topic1");
+  EXPECT_THAT(replayed_test_primitives, SizeIs(Ge(3u)));
+  EXPECT_THAT(
+    replayed_test_primitives,
+    Each(Pointee(Field(&test_msgs::msg::BasicTypes::int32_value, 42))));
+}
+
+TEST_F(RosBag2PlayTestFixture, topic_sampling_plays_every_nth_message)
+{
+  auto topic_types = std::vector<rosbag2_storage::TopicMetadata>{
+    {"topic1", "test_msgs/BasicTypes", "", ""},
+  };
+
+  // Distinct values per message, so the assertion can tell which messages
+  // survived the decimation rather than just counting arrivals.
+  std::vector<std::shared_ptr<rosbag2_storage::SerializedBagMessage>> messages;
+  for (int32_t i = 1; i <= 6; ++i) {
+    auto primitive_message = get_messages_basic_types()[0];
+    primitive_message->int32_value = i;
+    messages.push_back(serialize_test_message("topic1", i * 100, primitive_message));
+  }
+
+  auto prepared_mock_reader = std::make_unique<MockSequentialReader>();
+  prepared_mock_reader->prepare(messages, topic_types);
+  reader_ = std::make_unique<rosbag2_cpp::Reader>(std::move(prepared_mock_reader));
+
+  play_options_.topic_sampling = {{"topic1", 2u}};
+
+  sub_->add_subscription<test_msgs::msg::BasicTypes>("/topic1", 3);
+
+  auto await_received_messages = sub_->spin_subscriptions();
+
+  Rosbag2Transport rosbag2_transport(reader_, writer_, info_, reindexer_);
+  rosbag2_transport.play(storage_options_, play_options_);
+
+  await_received_messages.get();
+
+  auto replayed_test_primitives = sub_->get_received_messages<test_msgs::msg::BasicTypes>(
+    "/topic1");
+  ASSERT_THAT(replayed_test_primitives, SizeIs(3u));
+  EXPECT_THAT(
+    replayed_test_primitives,
+    ElementsAre(
+      Pointee(Field(&test_msgs::msg::BasicTypes::int32_value, 1)),
+      Pointee(Field(&test_msgs::msg::BasicTypes::int32_value, 3)),
+      Pointee(Field(&test_msgs::msg::BasicTypes::int32_value, 5))));
+}
+
 TEST_F(RosBag2PlayTestFixture, recorded_messages_are_played_for_filtered_topics)
 {
   auto primitive_message1 = get_messages_basic_types()[0];
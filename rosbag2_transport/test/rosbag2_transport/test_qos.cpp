@@ -77,6 +77,53 @@ TEST(TestQoS, supports_version_4)
   EXPECT_EQ(actual_qos.durability, expected_qos.durability);
 }
 
+TEST(TestQoS, compact_encoding_roundtrip)
+{
+  rmw_time_t deadline{12, 34};
+  rosbag2_transport::Rosbag2QoS first{};
+  first.keep_last(42).reliable().transient_local().deadline(deadline);
+  rosbag2_transport::Rosbag2QoS second{};
+  second.best_effort().liveliness(RMW_QOS_POLICY_LIVELINESS_MANUAL_BY_TOPIC);
+
+  const auto serialized = rosbag2_transport::serialize_qos_profiles({first, second});
+  EXPECT_THAT(serialized, testing::StartsWith("qos1:"));
+
+  const auto decoded = rosbag2_transport::deserialize_qos_profiles(serialized);
+  ASSERT_EQ(decoded.size(), 2u);
+  EXPECT_EQ(decoded[0], first);
+  EXPECT_EQ(decoded[1], second);
+}
+
+TEST(TestQoS, deserialize_falls_back_to_yaml)
+{
+  // The offered_qos_profiles string of bags recorded before the compact
+  // encoding existed; it must keep decoding.
+  std::string serialized_profiles =
+    "- history: 1\n"
+    "  depth: 10\n"
+    "  reliability: 1\n"
+    "  durability: 2\n"
+    "  deadline:\n"
+    "    sec: 0\n"
+    "    nsec: 0\n"
+    "  lifespan:\n"
+    "    sec: 0\n"
+    "    nsec: 0\n"
+    "  liveliness: 0\n"
+    "  liveliness_lease_duration:\n"
+    "    sec: 0\n"
+    "    nsec: 0\n"
+    "  avoid_ros_namespace_conventions: false\n";
+
+  const auto profiles = rosbag2_transport::deserialize_qos_profiles(serialized_profiles);
+  ASSERT_EQ(profiles.size(), 1u);
+  const auto actual_qos = profiles[0].get_rmw_qos_profile();
+  EXPECT_EQ(actual_qos.reliability, RMW_QOS_POLICY_RELIABILITY_RELIABLE);
+  EXPECT_EQ(actual_qos.durability, RMW_QOS_POLICY_DURABILITY_VOLATILE);
+
+  EXPECT_TRUE(rosbag2_transport::deserialize_qos_profiles("").empty());
+}
+
 TEST(TestQoS, detect_new_qos_fields)
 {
   // By trying to construct a profile explicitly by fields, the build fails if policies are added
@@ -182,6 +229,37 @@ TEST_F(AdaptiveQoSTest, adapt_request_mixed_durability_offers_return_volatile)
   EXPECT_EQ(adapted_request.get_rmw_qos_profile().durability, RMW_QOS_POLICY_DURABILITY_VOLATILE);
 }
 
+TEST_F(AdaptiveQoSTest, adapt_request_to_recorded_empty_returns_default)
+{
+  auto adapted_request = Rosbag2QoS::adapt_request_to_recorded_offers(topic_name_, {});
+  EXPECT_EQ(default_request_, adapted_request);
+}
+
+TEST_F(AdaptiveQoSTest, adapt_request_to_recorded_single_offer_returns_same_values)
+{
+  auto nondefault_offer = Rosbag2QoS{Rosbag2QoS{}.best_effort().transient_local()};
+
+  auto adapted_request = Rosbag2QoS::adapt_request_to_recorded_offers(
+    topic_name_, {nondefault_offer});
+
+  auto expected = nondefault_offer.get_rmw_qos_profile();
+  auto actual = adapted_request.get_rmw_qos_profile();
+  EXPECT_EQ(expected.reliability, actual.reliability);
+  EXPECT_EQ(expected.durability, actual.durability);
+}
+
+TEST_F(AdaptiveQoSTest, adapt_request_to_recorded_mixed_offers_fall_back)
+{
+  std::vector<Rosbag2QoS> offers = {
+    Rosbag2QoS{Rosbag2QoS{}.best_effort().transient_local()},
+    Rosbag2QoS{Rosbag2QoS{}.reliable().durability_volatile()},
+  };
+  auto adapted_request = Rosbag2QoS::adapt_request_to_recorded_offers(topic_name_, offers);
+  EXPECT_EQ(
+    adapted_request.get_rmw_qos_profile().reliability, RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT);
+  EXPECT_EQ(adapted_request.get_rmw_qos_profile().durability, RMW_QOS_POLICY_DURABILITY_VOLATILE);
+}
+
 TEST_F(AdaptiveQoSTest, adapt_offer_empty_returns_default)
 {
   auto adapted_offer = Rosbag2QoS::adapt_offer_to_recorded_offers(topic_name_, {});
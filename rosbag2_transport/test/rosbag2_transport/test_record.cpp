@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -68,6 +69,108 @@ TEST_F(RecordIntegrationTestFixture, published_messages_from_multiple_topics_are
   EXPECT_THAT(array_messages[0]->float32_values, Eq(array_message->float32_values));
 }
 
+TEST_F(RecordIntegrationTestFixture, topic_sampling_discards_messages_between_samples)
+{
+  auto string_message = get_messages_strings()[1];
+  std::string topic = "/sampled_topic";
+
+  rosbag2_transport::RecordOptions record_options =
+  {false, false, {topic}, "rmw_format", 100ms};
+  // Keep only every 1000th message: after the first stored message,
+  // everything published below is deterministically sampled out.
+  record_options.topic_sampling[topic] = 1000;
+  start_recording(record_options);
+
+  pub_man_.add_publisher<test_msgs::msg::Strings>(topic, string_message, 1);
+  run_publishers();
+  pub_man_.run_scoped_publisher(topic, string_message, 50ms, 5);
+  stop_recording();
+
+  MockSequentialWriter & writer =
+    static_cast<MockSequentialWriter &>(writer_->get_implementation_handle());
+  auto recorded_messages = writer.get_messages();
+  auto sampled_messages = filter_messages<test_msgs::msg::Strings>(recorded_messages, topic);
+  EXPECT_THAT(sampled_messages, SizeIs(1));
+}
+
+TEST_F(RecordIntegrationTestFixture, topic_deduplication_drops_identical_payloads)
+{
+  auto string_message = get_messages_strings()[1];
+  std::string topic = "/latched_topic";
+
+  rosbag2_transport::RecordOptions record_options =
+  {false, false, {topic}, "rmw_format", 100ms};
+  record_options.topic_deduplication = {topic};
+  start_recording(record_options);
+
+  pub_man_.add_publisher<test_msgs::msg::Strings>(topic, string_message, 1);
+  run_publishers();
+  // Re-deliveries of the identical payload must not be recorded again.
+  pub_man_.run_scoped_publisher(topic, string_message, 50ms, 5);
+  stop_recording();
+
+  MockSequentialWriter & writer =
+    static_cast<MockSequentialWriter &>(writer_->get_implementation_handle());
+  auto recorded_messages = writer.get_messages();
+  auto deduplicated_messages = filter_messages<test_msgs::msg::Strings>(recorded_messages, topic);
+  EXPECT_THAT(deduplicated_messages, SizeIs(1));
+}
+
+TEST_F(RecordIntegrationTestFixture, pruned_idle_subscription_comes_back_with_a_new_publisher)
+{
+  auto string_message = get_messages_strings()[1];
+  std::string topic = "/occasionally_active_topic";
+
+  rosbag2_transport::RecordOptions record_options =
+  {false, false, {topic}, "rmw_format", 100ms};
+  record_options.subscription_idle_timeout = 500ms;
+  start_recording(record_options);
+
+  pub_man_.add_publisher<test_msgs::msg::Strings>(topic, string_message, 2);
+  run_publishers();
+
+  // Nothing is published for well over the idle window, so the discovery
+  // loop tears the subscription down.
+  std::this_thread::sleep_for(1500ms);
+
+  // A fresh publisher node is the resubscription signal; once the discovery
+  // loop reacted, its messages are recorded again.
+  pub_man_.run_scoped_publisher(topic, string_message, 50ms, 40);
+  stop_recording();
+
+  MockSequentialWriter & writer =
+    static_cast<MockSequentialWriter &>(writer_->get_implementation_handle());
+  auto recorded_messages =
+    filter_messages<test_msgs::msg::Strings>(writer.get_messages(), topic);
+  EXPECT_THAT(recorded_messages, SizeIs(Gt(2u)));
+}
+
+TEST_F(RecordIntegrationTestFixture, excluded_topics_are_never_subscribed)
+{
+  auto string_message = get_messages_strings()[1];
+  std::string recorded_topic = "/recorded_topic";
+  std::string excluded_topic = "/camera/image_raw";
+
+  rosbag2_transport::RecordOptions record_options =
+  {false, false, {recorded_topic, excluded_topic}, "rmw_format", 100ms};
+  record_options.topics_regex_to_exclude = "/camera/.*";
+  start_recording(record_options);
+
+  pub_man_.add_publisher<test_msgs::msg::Strings>(recorded_topic, string_message, 2);
+  // Expected count 0: messages on the excluded topic must never be stored.
+  pub_man_.add_publisher<test_msgs::msg::Strings>(excluded_topic, string_message, 0);
+  run_publishers();
+  stop_recording();
+
+  MockSequentialWriter & writer =
+    static_cast<MockSequentialWriter &>(writer_->get_implementation_handle());
+  auto recorded_messages = writer.get_messages();
+  auto recorded = filter_messages<test_msgs::msg::Strings>(recorded_messages, recorded_topic);
+  auto excluded = filter_messages<test_msgs::msg::Strings>(recorded_messages, excluded_topic);
+  EXPECT_THAT(recorded, SizeIs(2));
+  EXPECT_THAT(excluded, IsEmpty());
+}
+
 TEST_F(RecordIntegrationTestFixture, qos_is_stored_in_metadata)
 {
   auto string_message = get_messages_strings()[1];
@@ -81,28 +184,15 @@ TEST_F(RecordIntegrationTestFixture, qos_is_stored_in_metadata)
     static_cast<MockSequentialWriter &>(writer_->get_implementation_handle());
   auto recorded_topics = writer.get_topics();
   std::string serialized_profiles = recorded_topics.at(topic).offered_qos_profiles;
-  // Basic smoke test that the profile was serialized into the metadata as a string.
-  EXPECT_THAT(serialized_profiles, ContainsRegex("reliability: 1\n"));
-  EXPECT_THAT(serialized_profiles, ContainsRegex("durability: 2\n"));
-  EXPECT_THAT(
-    serialized_profiles, ContainsRegex(
-      "deadline:\n"
-      "    sec: .+\n"
-      "    nsec: .+\n"
-  ));
-  EXPECT_THAT(
-    serialized_profiles, ContainsRegex(
-      "lifespan:\n"
-      "    sec: .+\n"
-      "    nsec: .+\n"
-  ));
-  EXPECT_THAT(serialized_profiles, ContainsRegex("liveliness: 1\n"));
-  EXPECT_THAT(
-    serialized_profiles, ContainsRegex(
-      "liveliness_lease_duration:\n"
-      "    sec: .+\n"
-      "    nsec: .+\n"
-  ));
+  // The offers are stored in the compact encoding and must decode back to
+  // the publisher's profile.
+  EXPECT_THAT(serialized_profiles, StartsWith("qos1:"));
+  const auto profiles = rosbag2_transport::deserialize_qos_profiles(serialized_profiles);
+  ASSERT_THAT(profiles, SizeIs(1));
+  const auto & profile = profiles[0].get_rmw_qos_profile();
+  EXPECT_EQ(profile.reliability, RMW_QOS_POLICY_RELIABILITY_RELIABLE);
+  EXPECT_EQ(profile.durability, RMW_QOS_POLICY_DURABILITY_VOLATILE);
+  EXPECT_EQ(profile.liveliness, RMW_QOS_POLICY_LIVELINESS_AUTOMATIC);
 }
 
 TEST_F(RecordIntegrationTestFixture, records_sensor_data)